@@ -22,6 +22,7 @@ namespace test {
 void registerTestAliasPass();
 void registerTestAlignmentPass();
 void registerTestAllocationPass();
+void registerTestKernelStatsPass();
 void registerTestMembarPass();
 } // namespace test
 } // namespace mlir
@@ -34,6 +35,7 @@ inline void registerTritonDialects(mlir::DialectRegistry &registry) {
   mlir::test::registerTestAliasPass();
   mlir::test::registerTestAlignmentPass();
   mlir::test::registerTestAllocationPass();
+  mlir::test::registerTestKernelStatsPass();
   mlir::test::registerTestMembarPass();
   mlir::triton::registerConvertTritonToTritonGPUPass();
   mlir::triton::registerDecomposeUnsupportedConversionsPass();
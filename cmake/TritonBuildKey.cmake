@@ -0,0 +1,41 @@
+# Writes OUTPUT, a source file defining the key of the libtriton being built:
+# a hash of the sources compiled into it, the pinned versions of its
+# dependencies and EXTRA (the configuration of the build). The compilation
+# cache keys kernels by it, so it must change whenever the library does.
+#
+# Run in script mode at every build; OUTPUT is only rewritten when the key
+# changes, so unchanged trees don't relink.
+#
+#   cmake -DTRITON_SOURCE_DIR=... -DOUTPUT=... -DEXTRA=... -P TritonBuildKey.cmake
+
+cmake_policy(SET CMP0009 NEW)
+
+file(GLOB_RECURSE sources RELATIVE "${TRITON_SOURCE_DIR}"
+  "${TRITON_SOURCE_DIR}/CMakeLists.txt"
+  "${TRITON_SOURCE_DIR}/cmake/*"
+  "${TRITON_SOURCE_DIR}/include/*"
+  "${TRITON_SOURCE_DIR}/lib/*"
+  "${TRITON_SOURCE_DIR}/python/src/*"
+  "${TRITON_SOURCE_DIR}/third_party/*/CMakeLists.txt"
+  "${TRITON_SOURCE_DIR}/third_party/*/*.cc"
+  "${TRITON_SOURCE_DIR}/third_party/*/include/*"
+  "${TRITON_SOURCE_DIR}/third_party/*/lib/*")
+list(SORT sources)
+
+set(contents "${EXTRA}")
+foreach(source ${sources})
+  file(SHA256 "${TRITON_SOURCE_DIR}/${source}" source_hash)
+  string(APPEND contents "\n${source}:${source_hash}")
+endforeach()
+string(SHA256 key "${contents}")
+
+set(code "// Generated by cmake/TritonBuildKey.cmake, do not edit.\n")
+string(APPEND code "namespace triton {\n")
+string(APPEND code "const char *getBuildKey() { return \"${key}\"; }\n")
+string(APPEND code "} // namespace triton\n")
+if(EXISTS "${OUTPUT}")
+  file(READ "${OUTPUT}" old_code)
+endif()
+if(NOT "${code}" STREQUAL "${old_code}")
+  file(WRITE "${OUTPUT}" "${code}")
+endif()
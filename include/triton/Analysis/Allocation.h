@@ -18,9 +18,21 @@ namespace mlir {
 namespace triton {
 class AllocationAnalysis;
 
+/// XOR swizzle applied to the scratch buffer of a layout conversion instead
+/// of padding it: along the fastest dimension, the chunks of `vec` elements of
+/// row `r` are permuted as `chunk ^ (r % maxPhase)`. No swizzle if maxPhase is
+/// 1.
+struct CvtScratchSwizzle {
+  unsigned vec = 1;
+  unsigned maxPhase = 1;
+};
+
 SmallVector<unsigned>
 getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
                              unsigned &outVec);
+SmallVector<unsigned>
+getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
+                             unsigned &outVec, CvtScratchSwizzle &swizzle);
 SmallVector<unsigned> getRepShapeForCvtLayout(triton::gpu::ConvertLayoutOp op);
 
 } // namespace triton
@@ -135,6 +147,54 @@ public:
   /// Returns the size of total shared memory allocated
   size_t getSharedMemorySize() const { return sharedMemorySize; }
 
+  /// Returns the largest alignment of the buffers, 1 if there are none.
+  size_t getMaxAlignment() const {
+    size_t alignment = 1;
+    for (auto &bufferIter : bufferSet)
+      alignment = std::max(alignment, bufferIter.second.alignment);
+    return alignment;
+  }
+
+  /// Returns the ids of all the buffers, in increasing order.
+  SmallVector<BufferId> getAllBufferIds() const {
+    SmallVector<BufferId> bufferIds;
+    for (auto &bufferIter : bufferSet)
+      bufferIds.push_back(bufferIter.first);
+    return bufferIds;
+  }
+
+  /// Returns "explicit", "scratch" or "virtual" for the given buffer.
+  StringRef getBufferKindName(BufferId bufferId) const {
+    switch (bufferSet.at(bufferId).kind) {
+    case BufferT::BufferKind::Explicit:
+      return "explicit";
+    case BufferT::BufferKind::Scratch:
+      return "scratch";
+    case BufferT::BufferKind::Virtual:
+      return "virtual";
+    }
+    llvm_unreachable("unknown buffer kind");
+  }
+
+  /// Returns the operation the given buffer is allocated for: the operation
+  /// defining an explicit buffer, or the one using a scratch or virtual
+  /// buffer.
+  Operation *getBufferOwner(BufferId bufferId) const {
+    return bufferSet.at(bufferId).owner;
+  }
+
+  /// Returns the operation at which the most shared memory is live, or null
+  /// if no buffer is allocated.
+  Operation *getPeakLiveOperation() const { return peakLiveOperation; }
+
+  /// Returns the number of bytes live at the peak live operation.
+  size_t getPeakLiveSize() const { return peakLiveSize; }
+
+  /// Returns if the given buffer is live at the peak live operation.
+  bool isLiveAtPeak(BufferId bufferId) const {
+    return peakLiveBuffers.contains(bufferId);
+  }
+
 private:
   /// A class that represents a shared memory buffer
   struct BufferT {
@@ -151,6 +211,7 @@ private:
     size_t size;
     size_t alignment;
     size_t offset;
+    Operation *owner = nullptr;
 
     bool operator==(const BufferT &other) const { return id == other.id; }
     bool operator<(const BufferT &other) const { return id < other.id; }
@@ -175,6 +236,10 @@ private:
   template <BufferT::BufferKind Kind, typename KeyType, typename... Args>
   void addBuffer(KeyType &key, Args &&...args) {
     auto buffer = BufferT(Kind, std::forward<Args>(args)...);
+    if constexpr (Kind == BufferT::BufferKind::Explicit)
+      buffer.owner = key.getDefiningOp();
+    else
+      buffer.owner = key;
     bufferSet[buffer.id] = std::move(buffer);
     if constexpr (Kind == BufferT::BufferKind::Explicit) {
       valueBuffer[key] = &bufferSet[buffer.id];
@@ -197,6 +262,9 @@ private:
   AliasBufferMapT aliasBuffer;
   BufferSetT bufferSet;
   size_t sharedMemorySize = 0;
+  Operation *peakLiveOperation = nullptr;
+  size_t peakLiveSize = 0;
+  BufferIdSetT peakLiveBuffers;
 
   friend class triton::AllocationAnalysis;
 };
@@ -249,6 +317,15 @@ private:
   FuncOffsetMapT sharedMemoryValue;
 };
 
+/// Prints a JSON report of the shared memory used by the kernels of
+/// `moduleAllocation`: the buffers of every function, with the operation each
+/// one is allocated for and whether it is live where usage peaks, and the
+/// theoretical occupancy of a core with `sharedMemoryPerCore` bytes of shared
+/// memory that keeps at most `maxWarpsPerCore` warps resident.
+void printSharedMemoryReport(ModuleAllocation &moduleAllocation,
+                             size_t sharedMemoryPerCore,
+                             unsigned maxWarpsPerCore, raw_ostream &os);
+
 } // namespace mlir
 
 #endif // TRITON_ANALYSIS_ALLOCATION_H
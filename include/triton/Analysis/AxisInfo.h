@@ -316,9 +316,14 @@ public:
 /// calculate the axis info based on the axis info of all the callers.
 /// In the future, we can perform optimization using function cloning so that
 /// each call site will have unique axis info.
+/// It can be used as an MLIR analysis of the module (`getAnalysis<>()`), so
+/// passes that do not change the IR it depends on can preserve it for the
+/// next ones instead of solving it again.
 using AxisInfoMapT = DenseMap<Value, AxisInfo>;
 class ModuleAxisInfoAnalysis : public CallGraph<AxisInfoMapT> {
 public:
+  explicit ModuleAxisInfoAnalysis(Operation *op)
+      : ModuleAxisInfoAnalysis(cast<ModuleOp>(op)) {}
   explicit ModuleAxisInfoAnalysis(ModuleOp moduleOp)
       : CallGraph<AxisInfoMapT>(moduleOp) {
     SmallVector<FunctionOpInterface> funcs;
@@ -0,0 +1,18 @@
+#ifndef TRITON_ANALYSIS_KERNELSTATS_H
+#define TRITON_ANALYSIS_KERNELSTATS_H
+
+#include "mlir/IR/BuiltinOps.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir {
+
+/// Prints a JSON summary of the structure of the TritonGPU module `moduleOp`
+/// that drives its performance: the layout conversions by source and
+/// destination encoding, the shared memory it allocates, the barriers the
+/// membar analysis leaves in it, the vector width of its loads and stores and
+/// the shapes of its dots. `moduleOp` is not modified.
+void printKernelStats(ModuleOp moduleOp, raw_ostream &os);
+
+} // namespace mlir
+
+#endif // TRITON_ANALYSIS_KERNELSTATS_H
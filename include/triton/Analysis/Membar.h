@@ -4,6 +4,7 @@
 #include "Allocation.h"
 #include "llvm/ADT/SmallPtrSet.h"
 
+#include <algorithm>
 #include <set>
 
 namespace mlir {
@@ -52,12 +53,35 @@ struct BlockInfo {
   bool operator!=(const BlockInfo &other) const { return !(*this == other); }
 
 private:
+  /// Sweeps both sets in increasing start order, tracking the farthest end
+  /// of the intervals visited in each: an interval intersects one visited in
+  /// the other set iff it starts before that end. This is linear in the size
+  /// of the sets, and relies on the intervals not being empty, which the
+  /// intervals of allocated buffers never are.
   bool isIntersected(const IntervalSetT &lhsIntervalSet,
                      const IntervalSetT &rhsIntervalSet) const {
-    for (auto &lhs : lhsIntervalSet)
-      for (auto &rhs : rhsIntervalSet)
-        if (lhs.intersects(rhs))
+    auto lhsIt = lhsIntervalSet.begin();
+    auto rhsIt = rhsIntervalSet.begin();
+    size_t lhsMaxEnd = 0;
+    size_t rhsMaxEnd = 0;
+    while (lhsIt != lhsIntervalSet.end() && rhsIt != rhsIntervalSet.end()) {
+      if (lhsIt->start() <= rhsIt->start()) {
+        if (lhsIt->start() < rhsMaxEnd)
           return true;
+        lhsMaxEnd = std::max(lhsMaxEnd, lhsIt->end());
+        ++lhsIt;
+      } else {
+        if (rhsIt->start() < lhsMaxEnd)
+          return true;
+        rhsMaxEnd = std::max(rhsMaxEnd, rhsIt->end());
+        ++rhsIt;
+      }
+    }
+    // The remaining intervals start no earlier than the first of them.
+    if (lhsIt != lhsIntervalSet.end())
+      return lhsIt->start() < rhsMaxEnd;
+    if (rhsIt != rhsIntervalSet.end())
+      return rhsIt->start() < lhsMaxEnd;
     return false;
   }
 };
@@ -0,0 +1,107 @@
+#ifndef TRITON_ANALYSIS_RANGEANALYSIS_H
+#define TRITON_ANALYSIS_RANGEANALYSIS_H
+
+#include "mlir/Analysis/DataFlow/SparseAnalysis.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Interfaces/InferIntRangeInterface.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "mlir/Support/LLVM.h"
+
+#include <optional>
+
+namespace mlir {
+
+//===----------------------------------------------------------------------===//
+// RangeInfo
+//===----------------------------------------------------------------------===//
+
+/// This lattice value represents the range of the values of an integer scalar,
+/// or of all the elements of an integer tensor.
+class RangeInfo {
+public:
+  /// Default constructor: the uninitialized state
+  RangeInfo() = default;
+  /// Construct range info with a known range, or with no usable range for
+  /// values that are not integers
+  RangeInfo(std::optional<ConstantIntRanges> knownRange)
+      : range(knownRange), initialized(true) {}
+
+  bool isUninitialized() const { return !initialized; }
+
+  /// The range of the values, if known.
+  std::optional<ConstantIntRanges> getRange() const { return range; }
+
+  /// Whether all the values are known to fit in a signed integer of
+  /// `bitwidth` bits.
+  bool fitsSigned(unsigned bitwidth) const;
+
+  bool operator==(const RangeInfo &other) const {
+    return initialized == other.initialized && range == other.range;
+  }
+
+  /// The pessimistic state is the full range of the element type of integers,
+  /// and no range for other values.
+  static RangeInfo getPessimisticValueState(Value value);
+
+  /// The union of both ranges
+  static RangeInfo join(const RangeInfo &lhs, const RangeInfo &rhs);
+
+  void print(raw_ostream &os) const {
+    if (isUninitialized())
+      os << "<uninitialized>";
+    else if (!range)
+      os << "<none>";
+    else
+      os << *range;
+  }
+
+private:
+  std::optional<ConstantIntRanges> range;
+  bool initialized = false;
+};
+
+/// Range analysis of integer scalars and tensors. MLIR's IntegerRangeAnalysis
+/// only handles scalars, while the masks and offsets of Triton programs are
+/// tensors, built from `tt.make_range`, splats and broadcasts.
+///
+/// Values computed inside loops are widened to the full range as soon as their
+/// range changes after being first set, so that loop-carried values, which
+/// would otherwise grow one iteration at a time, converge.
+class RangeAnalysis : public dataflow::SparseForwardDataFlowAnalysis<
+                          dataflow::Lattice<RangeInfo>> {
+private:
+  void setToEntryState(dataflow::Lattice<RangeInfo> *lattice) override {
+    propagateIfChanged(
+        lattice,
+        lattice->join(RangeInfo::getPessimisticValueState(lattice->getPoint())));
+  }
+
+  void visitNonControlFlowArguments(
+      Operation *op, const RegionSuccessor &successor,
+      ArrayRef<dataflow::Lattice<RangeInfo> *> argLattices,
+      unsigned firstIndex) override {
+    if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+      visitForOpInductionVar(forOp, argLattices);
+    } else {
+      setAllToEntryStates(argLattices.take_front(firstIndex));
+      setAllToEntryStates(argLattices.drop_front(
+          firstIndex + successor.getSuccessorInputs().size()));
+    }
+  }
+
+public:
+  using dataflow::SparseForwardDataFlowAnalysis<
+      dataflow::Lattice<RangeInfo>>::SparseForwardDataFlowAnalysis;
+
+  void visitOperation(Operation *op,
+                      ArrayRef<const dataflow::Lattice<RangeInfo> *> operands,
+                      ArrayRef<dataflow::Lattice<RangeInfo> *> results) override;
+  void
+  visitForOpInductionVar(scf::ForOp op,
+                         ArrayRef<dataflow::Lattice<RangeInfo> *> argLattices);
+};
+
+} // namespace mlir
+
+#endif
@@ -124,6 +124,7 @@ public:
   // Stride between contiguous blocks along axis dim.
   unsigned getAxisBlockStride();
 
+  triton::ScanOp getOperation() { return scanOp; }
   Location getLoc() { return scanOp.getLoc(); }
   unsigned getAxis() { return scanOp.getAxis(); }
   triton::gpu::BlockedEncodingAttr getEncoding();
@@ -152,6 +153,16 @@ bool supportMMA(Value value, int version);
 
 bool supportDPAS(triton::DotOp op);
 
+// Whether a block pointer load can produce \p tensorTy, a DPAS dot operand,
+// directly with 2D block reads, without staging it in shared memory.
+bool supportDPASOperandBlockLoad(RankedTensorType tensorTy);
+
+// The unit attribute of the block pointer loads of DPAS B operands stored
+// transposed, i.e. through a column-major block pointer, which are read with
+// transposing 2D block reads.
+constexpr StringLiteral kTransposedBlockLoadAttrName =
+    "triton_gpu.transposed_block_load";
+
 bool isSingleValue(Value value);
 
 bool isMfmaToDotShortcut(RankedTensorType &srcTy, RankedTensorType &dstTy);
@@ -160,6 +171,33 @@ bool isMmaToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy);
 
 bool isMmaToMmaShortcut(RankedTensorType srcTy, RankedTensorType dstTy);
 
+// How a conversion between distributed layouts that never moves an element
+// across sub-groups is done with sub-group shuffles: register i of the result
+// is register srcRegs[i][laneId] of lane srcLanes[i][laneId] in the source.
+// Registers whose lanes all read the same source register take one shuffle,
+// the others one shuffle per distinct source register.
+struct SubGroupShuffleCvt {
+  SmallVector<SmallVector<unsigned>> srcRegs;
+  SmallVector<SmallVector<unsigned>> srcLanes;
+};
+
+// Returns the shuffles doing a blocked/DPAS <-> DPAS or a DPAS -> DPAS A
+// operand conversion without shared memory, or std::nullopt if some element
+// changes sub-group.
+std::optional<SubGroupShuffleCvt> getSubGroupShuffleCvt(RankedTensorType srcTy,
+                                                        RankedTensorType dstTy);
+
+// Whether every sub-group of a blocked/DPAS <-> blocked/DPAS conversion only
+// receives elements it holds in the source, so that the sub-groups going
+// through shared memory need not wait for each other.
+bool isSubGroupLocalCvt(RankedTensorType srcTy, RankedTensorType dstTy);
+
+// Whether each warp of a gather holds whole rows of the source along \p axis,
+// which then stays in registers and is read with shuffles. This needs the
+// source and the indices to share a blocked layout.
+bool isWarpLocalGather(RankedTensorType srcTy, RankedTensorType indicesTy,
+                       unsigned axis);
+
 // Return true if the src and dst layout match.
 bool matchMmaV3AndDotOperandLayout(RankedTensorType srcTy,
                                    RankedTensorType dstTy);
@@ -33,7 +33,14 @@ createAllocateSharedMemoryPass(const AllocateSharedMemoryOptions &options);
 std::unique_ptr<OperationPass<ModuleOp>> createConvertTritonGPUToLLVMPass();
 std::unique_ptr<OperationPass<ModuleOp>>
 createConvertTritonGPUToLLVMPass(int32_t computeCapability, Target target,
-                                 mlir::triton::gpu::TMAMetadataTy *tmaMetadata);
+                                 mlir::triton::gpu::TMAMetadataTy *tmaMetadata,
+                                 bool fastMath = false,
+                                 bool vectorTensors = false,
+                                 bool aggregateAtomics = false);
+
+std::unique_ptr<OperationPass<ModuleOp>> createPackKernelArgsPass();
+std::unique_ptr<OperationPass<ModuleOp>>
+createPackKernelArgsPass(const PackKernelArgsOptions &options);
 
 #define GEN_PASS_REGISTRATION
 #include "triton/Conversion/TritonGPUToLLVM/Passes.h.inc"
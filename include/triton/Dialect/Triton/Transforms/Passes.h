@@ -12,6 +12,22 @@ std::unique_ptr<Pass> createReorderBroadcastPass();
 std::unique_ptr<Pass>
 createRewriteTensorPointerPass(int computeCapability = 80);
 
+std::unique_ptr<Pass> createSplitKPass(int splitK = 1);
+
+std::unique_ptr<Pass> createLoopUnrollPass(int unrollFactor = 1);
+
+std::unique_ptr<Pass> createIntRangeOptimizePass();
+
+std::unique_ptr<Pass> createHoistPointerOffsetsPass();
+
+std::unique_ptr<Pass> createHoistInvariantLoadsPass();
+
+std::unique_ptr<Pass> createSpecializeCallsPass();
+
+std::unique_ptr<Pass> createOutlineColdCallsPass(int sizeThreshold = 64);
+
+std::unique_ptr<Pass> createFuseKernelsPass(std::string name = "fused");
+
 } // namespace triton
 
 #define GEN_PASS_REGISTRATION
@@ -10,9 +10,14 @@ namespace gpu {
 
 std::unique_ptr<Pass> createPipelinePass(int numStages = 3, int numWarps = 4,
                                          int numCTAs = 1,
-                                         int computeCapability = 80);
+                                         int computeCapability = 80,
+                                         bool usePrefetch = false,
+                                         int sharedMemorySize = 0);
 
-std::unique_ptr<Pass> createAccelerateMatmulPass(int computeCapability = 80);
+std::unique_ptr<Pass> createStreamPipelinePass();
+
+std::unique_ptr<Pass> createAccelerateMatmulPass(int computeCapability = 80,
+                                                 bool enableDPAS = false);
 
 std::unique_ptr<Pass> createPrefetchPass();
 
@@ -20,8 +25,14 @@ std::unique_ptr<Pass> createCanonicalizeLoopsPass();
 
 std::unique_ptr<Pass> createCoalescePass();
 
+std::unique_ptr<Pass> createCoalescePass(int maxVectorBits,
+                                         int cacheLineBytes);
+
 std::unique_ptr<Pass> createReorderInstructionsPass();
 
+std::unique_ptr<Pass> createReorderInstructionsPass(bool scheduleLoops,
+                                                    int maxRegisters);
+
 std::unique_ptr<Pass> createReduceDataDuplicationPass();
 
 std::unique_ptr<Pass> createRemoveLayoutConversionsPass();
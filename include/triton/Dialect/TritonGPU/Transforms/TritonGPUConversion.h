@@ -9,12 +9,18 @@
 
 #include "mlir/Transforms/DialectConversion.h"
 
+#include <map>
+
 namespace mlir {
 
 class TritonGPUTypeConverter : public TypeConverter {
 public:
+  // The order of the blocked encoding of tensors of each shape, where it is
+  // not the default row-major one.
+  using ShapeOrders = std::map<SmallVector<int64_t>, SmallVector<unsigned>>;
+
   TritonGPUTypeConverter(MLIRContext *context, int numWarps, int threadsPerWarp,
-                         int numCTAs);
+                         int numCTAs, ShapeOrders shapeOrders = {});
   int getNumWarps() const { return numWarps; }
   int getThreadsPerWarp() const { return threadsPerWarp; }
   int getNumCTAs() const { return numCTAs; }
@@ -24,6 +30,7 @@ private:
   int numWarps;
   int threadsPerWarp;
   int numCTAs;
+  ShapeOrders shapeOrders;
 };
 
 class TritonGPUConversionTarget : public ConversionTarget {
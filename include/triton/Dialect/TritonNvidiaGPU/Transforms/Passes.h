@@ -71,7 +71,8 @@ std::unique_ptr<Pass>
 createTritonNvidiaGPUFenceInsertionPass(int computeCapability = 90);
 
 std::unique_ptr<Pass>
-createTritonGPURewriteTensorPointerPass(int computeCapability = 80);
+createTritonGPURewriteTensorPointerPass(int computeCapability = 80,
+                                        bool keepBlockPointers = false);
 
 std::unique_ptr<Pass> createTritonNvidiaGPUWSFixupMissingAttrs();
 
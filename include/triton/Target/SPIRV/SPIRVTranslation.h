@@ -1,7 +1,9 @@
 #ifndef TRITON_TARGET_SPIRVTRANSLATION_H
 #define TRITON_TARGET_SPIRVTRANSLATION_H
 
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace llvm {
 class Module;
@@ -9,8 +11,22 @@ class Module;
 
 namespace triton {
 
+// Options controlling the SPIR-V produced for a given device.
+struct SPIRVTranslationOptions {
+  // Names of the SPIR-V extensions the translator may use, e.g.
+  // "SPV_INTEL_subgroups". All known extensions are enabled if unset.
+  std::optional<std::vector<std::string>> extensions;
+  // Prefixes of the intrinsics passed through to the driver unchanged.
+  std::vector<std::string> allowedIntrinsics = {"llvm.genx.GenISA."};
+  // Emit SPIR-V with LLVM's own SPIR-V code generator rather than with the
+  // SPIRV-LLVM-Translator. Requires LLVM to be built with the SPIRV target.
+  bool useLLVMBackend = false;
+};
+
 // Translate TritonGPU IR to SPIRV code.
-std::string translateLLVMIRToSPIRV(llvm::Module &module);
+std::string
+translateLLVMIRToSPIRV(llvm::Module &module,
+                       const SPIRVTranslationOptions &options = {});
 
 } // namespace triton
 
@@ -6,10 +6,14 @@
 #include "triton/Analysis/Alias.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MathExtras.h"
 
 #include <algorithm>
 #include <limits>
+#include <map>
 #include <numeric>
+#include <optional>
 
 using ::mlir::triton::gpu::BlockedEncodingAttr;
 using ::mlir::triton::gpu::DotOperandEncodingAttr;
@@ -79,6 +83,10 @@ SmallVector<unsigned> getRepShapeForCvtLayout(triton::gpu::ConvertLayoutOp op) {
     }
   }
 
+  // Conversions done with sub-group shuffles don't use shared mem either
+  if (getSubGroupShuffleCvt(srcTy, dstTy))
+    return {};
+
   assert(srcLayout && dstLayout && "Unexpected layout in getRepShape()");
 
   auto srcShapePerCTA = getShapePerCTA(srcTy);
@@ -96,9 +104,30 @@ SmallVector<unsigned> getRepShapeForCvtLayout(triton::gpu::ConvertLayoutOp op) {
   return repShape;
 }
 
+// Sub-groups of 16 lanes access Intel SLM, warps of 32 or 64 lanes access
+// NVIDIA or AMD shared memory.
+static bool isSubGroupSLM(Operation *op) {
+  auto mod = op->getParentOfType<ModuleOp>();
+  return mod && triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod) == 16;
+}
+
+// Bytes served by one access to all the banks of shared memory: 16 banks of 4
+// bytes for Intel SLM, 32 banks of 4 bytes otherwise.
+static unsigned getSharedMemoryBankRowBytes(Operation *op) {
+  return isSubGroupSLM(op) ? 16 * 4 : 32 * 4;
+}
+
 SmallVector<unsigned>
 getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
                              unsigned &outVec) {
+  CvtScratchSwizzle swizzle;
+  return getScratchConfigForCvtLayout(op, inVec, outVec, swizzle);
+}
+
+SmallVector<unsigned>
+getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
+                             unsigned &outVec, CvtScratchSwizzle &swizzle) {
+  swizzle = CvtScratchSwizzle();
   auto repShape = getRepShapeForCvtLayout(op);
   if (repShape.empty())
     return repShape;
@@ -145,6 +174,36 @@ getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
     paddedDim = dstBlockedLayout.getOrder()[0];
   }
   unsigned pad = std::max(inVec, outVec);
+
+  // Rows of scratch accessed at the same time conflict when their pitch maps
+  // them to the same banks.
+  auto elemTy = srcTy.getElementType();
+  unsigned elemBytes = elemTy.isa<triton::PointerType>()
+                           ? kPtrBitWidth / 8
+                           : std::max<int>(8, srcTy.getElementTypeBitWidth()) / 8;
+  unsigned bankRowBytes = getSharedMemoryBankRowBytes(op);
+  unsigned chunkBytes = pad * elemBytes;
+  unsigned rowElems = repShape[paddedDim];
+
+  // On Intel SLM, conversions between blocked layouts go through the generic
+  // store/load path, which swizzles 2D scratch instead of padding it.
+  if (isSubGroupSLM(op) && repShape.size() == 2 &&
+      srcLayout.isa<BlockedEncodingAttr>() &&
+      dstLayout.isa<BlockedEncodingAttr>() && chunkBytes < bankRowBytes &&
+      llvm::isPowerOf2_32(rowElems) && rowElems % pad == 0) {
+    unsigned maxPhase = std::min(bankRowBytes / chunkBytes, rowElems / pad);
+    if (maxPhase > 1) {
+      swizzle.vec = pad;
+      swizzle.maxPhase = maxPhase;
+      return repShape;
+    }
+  }
+
+  // Padding only helps if the rows do not already start on as many different
+  // banks as the padded pitch would make them.
+  unsigned rowBytes = rowElems * elemBytes;
+  if (std::gcd(rowBytes, bankRowBytes) <= chunkBytes)
+    return repShape;
   repShape[paddedDim] += pad;
   return repShape;
 }
@@ -196,6 +255,7 @@ private:
     getValuesAndSizes();
     resolveLiveness();
     computeOffsets();
+    computePeakLiveness();
   }
 
   /// Initializes explicitly defined shared memory values for a given operation.
@@ -252,27 +312,66 @@ private:
       allocation->addBuffer<T>(op, bytes);
   }
 
+  /// The alignment of a scratch buffer whose elements are accessed one at a
+  /// time: the size of its widest element type.
+  static size_t getElementAlignment(ArrayRef<Type> elemTys) {
+    size_t alignment = 1;
+    for (Type ty : elemTys)
+      alignment = std::max<size_t>(
+          alignment, ceil<unsigned>(ty.getIntOrFloatBitWidth(), 8));
+    return alignment;
+  }
+
   /// Initializes temporary shared memory for a given operation.
+  /// Scratch buffers are only aligned as much as the accesses the lowering
+  /// makes to them require, the liveness of a scratch buffer is its operation
+  /// so the ones of different operations already share the same space.
   void getScratchValueSize(Operation *op) {
-    const size_t scratchAlignment = 128;
+    // The widest vector access to shared memory is 128 bits.
+    const size_t scratchAlignment = 16;
     if (auto reduceOp = dyn_cast<triton::ReduceOp>(op)) {
       ReduceOpHelper helper(reduceOp);
       unsigned bytes = helper.getScratchSizeInBytes();
-      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
-                                                          scratchAlignment);
+      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(
+          op, bytes, getElementAlignment(reduceOp.getElementTypes()));
     } else if (auto scanOp = dyn_cast<triton::ScanOp>(op)) {
       ScanLoweringHelper helper(scanOp);
       unsigned bytes = helper.getScratchSizeInBytes();
-      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
-                                                          scratchAlignment);
+      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(
+          op, bytes, getElementAlignment(scanOp.getElementTypes()));
     } else if (auto histogram = dyn_cast<triton::HistogramOp>(op)) {
       auto dstTy = histogram.getResult().getType().cast<RankedTensorType>();
       int threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(
           op->getParentOfType<ModuleOp>());
       auto bytes = std::max<int>(dstTy.getNumElements(), threadsPerWarp) *
                    std::max<int>(8, dstTy.getElementTypeBitWidth()) / 8;
-      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
-                                                          scratchAlignment);
+      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(
+          op, bytes, std::max<int>(8, dstTy.getElementTypeBitWidth()) / 8);
+    } else if (auto sortOp = dyn_cast<triton::SortOp>(op)) {
+      // Only the compare-exchanges between warps go through shared memory,
+      // which then holds the whole tensor of the CTA.
+      auto srcTy = sortOp.getSrc().getType().cast<RankedTensorType>();
+      unsigned axis = sortOp.getAxis();
+      auto warpsPerCTA = triton::gpu::getWarpsPerCTAWithUniqueData(
+          srcTy.getEncoding(), srcTy.getShape());
+      if (warpsPerCTA[axis] > 1) {
+        auto elemBytes = std::max<int>(8, srcTy.getElementTypeBitWidth()) / 8;
+        auto bytes =
+            product<int64_t>(triton::gpu::getShapePerCTA(srcTy)) * elemBytes;
+        maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
+                                                            elemBytes);
+      }
+    } else if (auto gatherOp = dyn_cast<triton::GatherOp>(op)) {
+      // Gathers that can't shuffle read the source from shared memory.
+      auto srcTy = gatherOp.getSrc().getType().cast<RankedTensorType>();
+      auto indicesTy = gatherOp.getIndices().getType().cast<RankedTensorType>();
+      if (!isWarpLocalGather(srcTy, indicesTy, gatherOp.getAxis())) {
+        auto elemBytes = std::max<int>(8, srcTy.getElementTypeBitWidth()) / 8;
+        auto bytes =
+            product<int64_t>(triton::gpu::getShapePerCTA(srcTy)) * elemBytes;
+        maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
+                                                            elemBytes);
+      }
     } else if (auto cvtLayout = dyn_cast<triton::gpu::ConvertLayoutOp>(op)) {
       auto srcTy = cvtLayout.getSrc().getType().cast<RankedTensorType>();
       auto dstTy = cvtLayout.getResult().getType().cast<RankedTensorType>();
@@ -352,8 +451,11 @@ private:
       auto funcOp = dyn_cast<FunctionOpInterface>(callable);
       auto *funcAlloc = &(*funcAllocMap)[funcOp];
       auto bytes = funcAlloc->getSharedMemorySize();
+      // The callee aligns its buffers relative to the start of its frame.
+      auto alignment =
+          std::max<size_t>(scratchAlignment, funcAlloc->getMaxAlignment());
       maybeAddScratchBuffer<BufferT::BufferKind::Virtual>(op, bytes,
-                                                          scratchAlignment);
+                                                          alignment);
     }
   }
 
@@ -467,8 +569,10 @@ private:
     // otherwise %5 liveness range ends before the child operation's liveness
     // range ends.
     DenseMap<Operation *, size_t> operationId;
-    operation->walk<WalkOrder::PostOrder>(
-        [&](Operation *op) { operationId[op] = operationId.size(); });
+    operation->walk<WalkOrder::PostOrder>([&](Operation *op) {
+      operationId[op] = operationId.size();
+      operations.push_back(op);
+    });
 
     // Analyze liveness of explicit buffers
     Liveness liveness(operation);
@@ -525,6 +629,61 @@ private:
       allocate(buffers, interference, bufferStart);
       buildInterferenceGraph(buffers, bufferStart, interference);
     } while (!interference.empty());
+
+    // Coloring offsets every color by the end of the farthest neighbor, which
+    // can leave gaps. Keep the offsets of a best-fit packing instead when it
+    // needs less shared memory.
+    DenseMap<BufferT *, size_t> bestFitStart;
+    size_t bestFitSize = allocateBestFit(buffers, bestFitStart);
+    if (bestFitSize < allocation->sharedMemorySize) {
+      for (auto *buffer : buffers)
+        buffer->offset = bestFitStart.lookup(buffer);
+      allocation->sharedMemorySize = bestFitSize;
+    }
+  }
+
+  /// Places the buffers by decreasing size, each in the smallest gap left by
+  /// the buffers already placed whose liveness ranges overlap its own, or
+  /// after all of them if none fits. Returns the shared memory size used.
+  size_t allocateBestFit(const SmallVector<BufferT *> &buffers,
+                         DenseMap<BufferT *, size_t> &bufferStart) {
+    SmallVector<BufferT *> order = buffers;
+    llvm::stable_sort(order, [&](BufferT *x, BufferT *y) {
+      if (x->size != y->size)
+        return x->size > y->size;
+      return bufferRange.lookup(x).start() < bufferRange.lookup(y).start();
+    });
+    size_t totalSize = 0;
+    SmallVector<BufferT *> placed;
+    for (auto *x : order) {
+      auto xRange = bufferRange.lookup(x);
+      SmallVector<Interval<size_t>> busy;
+      for (auto *y : placed)
+        if (bufferRange.lookup(y).intersects(xRange))
+          busy.push_back({bufferStart.lookup(y),
+                          bufferStart.lookup(y) + y->size});
+      llvm::sort(busy);
+      auto alignUp = [&](size_t offset) {
+        return llvm::alignTo(offset, std::max<size_t>(x->alignment, 1));
+      };
+      std::optional<size_t> bestStart;
+      size_t bestSlack = std::numeric_limits<size_t>::max();
+      size_t gapStart = 0;
+      for (const auto &interval : busy) {
+        size_t start = alignUp(gapStart);
+        if (start + x->size <= interval.start() &&
+            interval.start() - start - x->size < bestSlack) {
+          bestStart = start;
+          bestSlack = interval.start() - start - x->size;
+        }
+        gapStart = std::max(gapStart, interval.end());
+      }
+      size_t start = bestStart.value_or(alignUp(gapStart));
+      bufferStart[x] = start;
+      totalSize = std::max(totalSize, start + x->size);
+      placed.push_back(x);
+    }
+    return totalSize;
   }
 
   /// Computes the initial shared memory offsets.
@@ -662,11 +821,40 @@ private:
     }
   }
 
+  /// Finds the operation at which the most bytes of shared memory are live,
+  /// sweeping the liveness ranges in operation id order.
+  void computePeakLiveness() {
+    std::map<size_t, int64_t> liveDelta;
+    for (auto [buffer, range] : bufferRange) {
+      liveDelta[range.start()] += buffer->size;
+      liveDelta[range.end()] -= buffer->size;
+    }
+    int64_t liveSize = 0;
+    int64_t peakSize = 0;
+    size_t peakId = 0;
+    for (auto [id, delta] : liveDelta) {
+      liveSize += delta;
+      if (liveSize > peakSize) {
+        peakSize = liveSize;
+        peakId = id;
+      }
+    }
+    if (peakSize == 0 || peakId >= operations.size())
+      return;
+    allocation->peakLiveOperation = operations[peakId];
+    allocation->peakLiveSize = peakSize;
+    for (auto [buffer, range] : bufferRange)
+      if (range.contains(peakId))
+        allocation->peakLiveBuffers.insert(buffer->id);
+  }
+
 private:
   Operation *operation;
   Allocation::FuncAllocMapT *funcAllocMap;
   Allocation *allocation;
   BufferRangeMapT bufferRange;
+  /// Operations indexed by their post-order id.
+  SmallVector<Operation *> operations;
 };
 
 } // namespace triton
@@ -675,4 +863,84 @@ void Allocation::run(FuncAllocMapT &funcAllocMap) {
   triton::AllocationAnalysis(getOperation(), &funcAllocMap, this);
 }
 
+static std::string getOperationName(Operation *op) {
+  std::string name;
+  llvm::raw_string_ostream os(name);
+  os << op->getName();
+  return os.str();
+}
+
+static std::string getOperationLoc(Operation *op) {
+  std::string loc;
+  llvm::raw_string_ostream os(loc);
+  op->getLoc().print(os);
+  return os.str();
+}
+
+void printSharedMemoryReport(ModuleAllocation &moduleAllocation,
+                             size_t sharedMemoryPerCore,
+                             unsigned maxWarpsPerCore, raw_ostream &os) {
+  ModuleOp moduleOp = moduleAllocation.getModuleOp();
+  unsigned numWarps = triton::gpu::TritonGPUDialect::getNumWarps(moduleOp);
+  size_t sharedMemorySize = moduleAllocation.getSharedMemorySize();
+
+  // Work-groups resident on one core, bounded by the warps a core keeps
+  // resident and by the shared memory each work-group allocates.
+  unsigned warpLimit = maxWarpsPerCore / std::max(numWarps, 1u);
+  unsigned workGroups = warpLimit;
+  StringRef limitedBy = "warps";
+  if (sharedMemorySize > 0 &&
+      sharedMemoryPerCore / sharedMemorySize < workGroups) {
+    workGroups = sharedMemoryPerCore / sharedMemorySize;
+    limitedBy = "shared";
+  }
+  double occupancy =
+      maxWarpsPerCore ? double(workGroups * numWarps) / maxWarpsPerCore : 0.0;
+
+  llvm::json::OStream json(os, /*IndentSize=*/2);
+  json.object([&] {
+    json.attribute("shared", int64_t(sharedMemorySize));
+    json.attribute("num_warps", int64_t(numWarps));
+    json.attribute("work_groups_per_core", int64_t(workGroups));
+    json.attribute("occupancy", occupancy);
+    json.attribute("limited_by", limitedBy);
+    json.attributeArray("functions", [&] {
+      moduleOp.walk([&](FunctionOpInterface funcOp) {
+        auto *allocation = moduleAllocation.getFuncData(funcOp);
+        if (!allocation)
+          return;
+        json.object([&] {
+          json.attribute("name",
+                         SymbolTable::getSymbolName(funcOp).getValue());
+          json.attribute("size", int64_t(allocation->getSharedMemorySize()));
+          json.attribute("peak_live_size",
+                         int64_t(allocation->getPeakLiveSize()));
+          if (Operation *peakOp = allocation->getPeakLiveOperation()) {
+            json.attribute("peak_live_op", getOperationName(peakOp));
+            json.attribute("peak_live_loc", getOperationLoc(peakOp));
+          }
+          json.attributeArray("buffers", [&] {
+            for (auto bufferId : allocation->getAllBufferIds()) {
+              json.object([&] {
+                json.attribute("kind",
+                               allocation->getBufferKindName(bufferId));
+                json.attribute("offset",
+                               int64_t(allocation->getOffset(bufferId)));
+                json.attribute(
+                    "size", int64_t(allocation->getAllocatedSize(bufferId)));
+                if (Operation *owner = allocation->getBufferOwner(bufferId)) {
+                  json.attribute("owner", getOperationName(owner));
+                  json.attribute("loc", getOperationLoc(owner));
+                }
+                json.attribute("live_at_peak",
+                               allocation->isLiveAtPeak(bufferId));
+              });
+            }
+          });
+        });
+      });
+    });
+  });
+}
+
 } // namespace mlir
@@ -985,11 +985,13 @@ AxisInfoAnalysis::AxisInfoAnalysis(DataFlowSolver &solver)
 void AxisInfoAnalysis::visitOperation(
     Operation *op, ArrayRef<const dataflow::Lattice<AxisInfo> *> operands,
     ArrayRef<dataflow::Lattice<AxisInfo> *> results) {
-  // TODO: For sure not the right way to do this
-  // but why is scf.if not initialized otherwise?
-  for (auto op : operands)
-    if (op->getValue().getRank() == 0)
-      setToEntryState((dataflow::Lattice<AxisInfo> *)op);
+  // The op is visited again once all its operands are known. Forcing them to
+  // the pessimistic state instead would lose the facts on loop-carried values
+  // reached before the loop entry is propagated, for good since the lattice
+  // only moves down.
+  for (auto operand : operands)
+    if (operand->getValue().getRank() == 0)
+      return;
   AxisInfo curr = visitors.apply(op, operands);
   if (curr.getRank() == 0)
     return setAllToEntryStates(results);
@@ -1041,6 +1043,9 @@ void AxisInfoAnalysis::visitForOpInductionVar(
     scf::ForOp op, ArrayRef<dataflow::Lattice<AxisInfo> *> argLattices) {
   auto lb = getLatticeElementFor(op, op.getLowerBound())->getValue();
   auto step = getLatticeElementFor(op, op.getStep())->getValue();
+  // The loop is visited again once its bounds are known.
+  if (lb.getRank() == 0 || step.getRank() == 0)
+    return;
 
   AxisInfo::DimVectorT knownContiguity(1, 1);
   AxisInfo::DimVectorT knownDivisibility(1, 1);
@@ -1048,7 +1053,7 @@ void AxisInfoAnalysis::visitForOpInductionVar(
   knownDivisibility[0] = gcd(lb.getDivisibility(0), step.getDivisibility(0));
   auto inductionVar =
       AxisInfo(knownContiguity, knownDivisibility, knownConstancy);
-  (void)argLattices[0]->join(inductionVar);
+  propagateIfChanged(argLattices[0], argLattices[0]->join(inductionVar));
 }
 
 unsigned ModuleAxisInfoAnalysis::getPtrAlignment(Value ptr) {
@@ -1089,6 +1094,9 @@ void ModuleAxisInfoAnalysis::initialize(FunctionOpInterface funcOp) {
   auto *axisInfoMap = getFuncData(funcOp);
   auto updateAxisInfoMap = [&](Value value) {
     auto axisInfo = analysis->getLatticeElement(value)->getValue();
+    // Values the analysis never reached, e.g. in dead code, know nothing.
+    if (axisInfo.getRank() == 0)
+      axisInfo = AxisInfo::getPessimisticValueState(value);
     AxisInfo curAxisInfo;
     if (axisInfoMap->count(value)) {
       curAxisInfo = AxisInfo::join(axisInfo, axisInfoMap->lookup(value));
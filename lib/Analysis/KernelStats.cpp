@@ -0,0 +1,132 @@
+#include "triton/Analysis/KernelStats.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "triton/Analysis/Allocation.h"
+#include "triton/Analysis/AxisInfo.h"
+#include "triton/Analysis/Membar.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "llvm/Support/JSON.h"
+#include <map>
+#include <tuple>
+
+namespace mlir {
+
+static std::string toString(Attribute attr) {
+  if (!attr)
+    return "none";
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  attr.print(os);
+  return os.str();
+}
+
+static std::string toString(Type type) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  type.print(os);
+  return os.str();
+}
+
+// Elements each thread accesses at once, as the lowering of loads and stores
+// vectorizes them: contiguous and aligned enough, masked uniformly, and at
+// most 128 bits.
+static unsigned getVectorSize(ModuleAxisInfoAnalysis &axisInfo, Value ptr,
+                              Value mask) {
+  auto tensorTy = ptr.getType().dyn_cast<RankedTensorType>();
+  if (!tensorTy)
+    return 1;
+  unsigned vec =
+      std::min<unsigned>(128 / triton::getPointeeBitWidth(tensorTy),
+                         axisInfo.getPtrContiguity(ptr));
+  if (mask)
+    vec = std::min(vec, axisInfo.getMaskAlignment(mask));
+  return vec;
+}
+
+static unsigned countBarriers(ModuleOp moduleOp) {
+  // The membar analysis inserts the barriers it needs, so it runs on a copy.
+  OwningOpRef<ModuleOp> copy = moduleOp.clone();
+  ModuleAllocation allocation(*copy);
+  ModuleMembarAnalysis membar(&allocation);
+  membar.run();
+  unsigned count = 0;
+  copy->walk([&](gpu::BarrierOp) { ++count; });
+  return count;
+}
+
+void printKernelStats(ModuleOp moduleOp, raw_ostream &os) {
+  ModuleAllocation allocation(moduleOp);
+  ModuleAxisInfoAnalysis axisInfo(moduleOp);
+
+  // (src, dst) -> count
+  std::map<std::pair<std::string, std::string>, int64_t> conversions;
+  // (kind, vec, element bits) -> count
+  std::map<std::tuple<std::string, unsigned, unsigned>, int64_t> accesses;
+  // (m, n, k, operand type, encoding) -> count
+  std::map<std::tuple<int64_t, int64_t, int64_t, std::string, std::string>,
+           int64_t>
+      dots;
+  moduleOp.walk([&](Operation *op) {
+    if (auto cvt = dyn_cast<triton::gpu::ConvertLayoutOp>(op)) {
+      auto srcTy = cvt.getSrc().getType().cast<RankedTensorType>();
+      auto dstTy = cvt.getType().cast<RankedTensorType>();
+      ++conversions[{toString(srcTy.getEncoding()),
+                     toString(dstTy.getEncoding())}];
+    } else if (auto load = dyn_cast<triton::LoadOp>(op)) {
+      if (!load.getPtr().getType().isa<RankedTensorType>())
+        return;
+      ++accesses[{"load",
+                  getVectorSize(axisInfo, load.getPtr(), load.getMask()),
+                  triton::getPointeeBitWidth(load.getPtr().getType())}];
+    } else if (auto store = dyn_cast<triton::StoreOp>(op)) {
+      if (!store.getPtr().getType().isa<RankedTensorType>())
+        return;
+      ++accesses[{"store",
+                  getVectorSize(axisInfo, store.getPtr(), store.getMask()),
+                  triton::getPointeeBitWidth(store.getPtr().getType())}];
+    } else if (auto dot = dyn_cast<triton::DotOp>(op)) {
+      auto aTy = dot.getA().getType().cast<RankedTensorType>();
+      auto dTy = dot.getType().cast<RankedTensorType>();
+      int64_t rank = dTy.getRank();
+      ++dots[{dTy.getShape()[rank - 2], dTy.getShape()[rank - 1],
+              aTy.getShape()[rank - 1], toString(aTy.getElementType()),
+              toString(dTy.getEncoding())}];
+    }
+  });
+
+  llvm::json::OStream json(os, /*IndentSize=*/2);
+  json.object([&] {
+    json.attribute("shared", int64_t(allocation.getSharedMemorySize()));
+    json.attribute("barriers", int64_t(countBarriers(moduleOp)));
+    json.attributeArray("convert_layouts", [&] {
+      for (auto &[key, count] : conversions)
+        json.object([&] {
+          json.attribute("src", key.first);
+          json.attribute("dst", key.second);
+          json.attribute("count", count);
+        });
+    });
+    json.attributeArray("accesses", [&] {
+      for (auto &[key, count] : accesses)
+        json.object([&] {
+          json.attribute("kind", std::get<0>(key));
+          json.attribute("vec", int64_t(std::get<1>(key)));
+          json.attribute("bits", int64_t(std::get<1>(key) * std::get<2>(key)));
+          json.attribute("count", count);
+        });
+    });
+    json.attributeArray("dots", [&] {
+      for (auto &[key, count] : dots)
+        json.object([&] {
+          json.attribute("m", std::get<0>(key));
+          json.attribute("n", std::get<1>(key));
+          json.attribute("k", std::get<2>(key));
+          json.attribute("operand", std::get<3>(key));
+          json.attribute("encoding", std::get<4>(key));
+          json.attribute("count", count);
+        });
+    });
+  });
+}
+
+} // namespace mlir
@@ -10,10 +10,101 @@
 
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include <deque>
 
 namespace mlir {
 
+namespace {
+
+// The indices [begin, end) of the outermost dimension of a shared memory
+// tensor of type `bufferTy` that an access covers.
+struct StageRange {
+  RankedTensorType bufferTy;
+  int64_t begin;
+  int64_t end;
+};
+
+// The stages of `bufferTy` a slice of it covers, if the slice is static and
+// takes whole rows of the inner dimensions.
+std::optional<StageRange> getSliceStages(RankedTensorType bufferTy,
+                                         ArrayRef<OpFoldResult> offsets,
+                                         ArrayRef<OpFoldResult> sizes,
+                                         ArrayRef<OpFoldResult> strides) {
+  ArrayRef<int64_t> shape = bufferTy.getShape();
+  if (offsets.size() != shape.size())
+    return std::nullopt;
+  for (size_t d = 0; d < shape.size(); ++d) {
+    if (getConstantIntValue(strides[d]) != 1)
+      return std::nullopt;
+    if (d > 0 && (getConstantIntValue(offsets[d]) != 0 ||
+                  getConstantIntValue(sizes[d]) != shape[d]))
+      return std::nullopt;
+  }
+  std::optional<int64_t> offset = getConstantIntValue(offsets[0]);
+  std::optional<int64_t> size = getConstantIntValue(sizes[0]);
+  if (!offset || !size)
+    return std::nullopt;
+  return StageRange{bufferTy, *offset, *offset + *size};
+}
+
+// The stages of the buffer `op` writes through its operand `value`, or reads
+// through the slice `value`, if they are known statically.
+std::optional<StageRange> getAccessedStages(Operation *op, Value value) {
+  if (auto insertOp = dyn_cast<triton::gpu::InsertSliceAsyncOp>(op)) {
+    std::optional<int64_t> index = getConstantIntValue(insertOp.getIndex());
+    if (value != insertOp.getDst() || insertOp.getAxis() != 0 || !index)
+      return std::nullopt;
+    return StageRange{insertOp.getDst().getType().cast<RankedTensorType>(),
+                      *index, *index + 1};
+  }
+  if (auto insertOp = dyn_cast<tensor::InsertSliceOp>(op)) {
+    if (value != insertOp.getDest())
+      return std::nullopt;
+    return getSliceStages(insertOp.getDestType(), insertOp.getMixedOffsets(),
+                          insertOp.getMixedSizes(),
+                          insertOp.getMixedStrides());
+  }
+  if (auto extractOp = value.getDefiningOp<triton::gpu::ExtractSliceOp>())
+    return getSliceStages(extractOp.getSource().getType(),
+                          extractOp.getMixedOffsets(),
+                          extractOp.getMixedSizes(),
+                          extractOp.getMixedStrides());
+  return std::nullopt;
+}
+
+// The part of buffer `bufferId` that `op` accesses through its operand
+// `value`. The stages of a multi-buffer are stored one after the other when
+// its outermost dimension is the slowest varying one, so an access to some of
+// them only touches their bytes.
+Interval<size_t> getAccessedInterval(Allocation *allocation, Operation *op,
+                                     Value value,
+                                     Allocation::BufferId bufferId) {
+  Interval<size_t> interval = allocation->getAllocatedInterval(bufferId);
+  std::optional<StageRange> stages = getAccessedStages(op, value);
+  if (!stages)
+    return interval;
+  auto layout = stages->bufferTy.getEncoding()
+                    .dyn_cast_or_null<triton::gpu::SharedEncodingAttr>();
+  ArrayRef<int64_t> shape = stages->bufferTy.getShape();
+  if (!layout || shape.size() < 2)
+    return interval;
+  // Pipelined buffers have the order of a single stage, the outermost
+  // dimension is then implicitly the slowest varying one.
+  ArrayRef<unsigned> order = layout.getOrder();
+  if (order.size() == shape.size() && order.back() != 0)
+    return interval;
+  int64_t numStages = shape[0];
+  if (stages->begin < 0 || stages->end > numStages ||
+      interval.size() % numStages != 0)
+    return interval;
+  size_t stageSize = interval.size() / numStages;
+  return Interval<size_t>(interval.start() + stages->begin * stageSize,
+                          interval.start() + stages->end * stageSize);
+}
+
+} // namespace
+
 void MembarAnalysis::run(FuncBlockInfoMapT &funcBlockInfoMap) {
   FunctionOpInterface funcOp =
       dyn_cast<FunctionOpInterface>(allocation->getOperation());
@@ -159,11 +250,11 @@ void MembarAnalysis::update(Operation *op, BlockInfo *blockInfo,
             // FIXME(Keren): insert_slice and insert_slice_async are always
             // alias for now
             curBlockInfo.syncWriteIntervals.insert(
-                allocation->getAllocatedInterval(bufferId));
+                getAccessedInterval(allocation, op, value, bufferId));
           } else {
             // ConvertLayoutOp: shared memory -> registers
             curBlockInfo.syncReadIntervals.insert(
-                allocation->getAllocatedInterval(bufferId));
+                getAccessedInterval(allocation, op, value, bufferId));
           }
         }
       }
@@ -0,0 +1,189 @@
+#include "mlir/Analysis/DataFlowFramework.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Interfaces/Utils/InferIntRangeCommon.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+#include "triton/Analysis/RangeAnalysis.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+namespace mlir {
+
+namespace {
+
+// The number of bits of the ranges of `type`, or 0 if it is not an integer
+// scalar or tensor.
+unsigned getRangeBitwidth(Type type) {
+  Type elemTy = getElementTypeOrSelf(type);
+  if (elemTy.isIndex())
+    return IndexType::kInternalStorageBitWidth;
+  if (auto intTy = elemTy.dyn_cast<IntegerType>())
+    return intTy.getWidth();
+  return 0;
+}
+
+// The range of the elements of an integer constant.
+std::optional<ConstantIntRanges> getConstantRange(Attribute attr) {
+  if (auto intAttr = attr.dyn_cast<IntegerAttr>())
+    return ConstantIntRanges::constant(intAttr.getValue());
+  auto denseAttr = attr.dyn_cast<DenseIntElementsAttr>();
+  if (!denseAttr || denseAttr.empty())
+    return std::nullopt;
+  if (denseAttr.isSplat())
+    return ConstantIntRanges::constant(denseAttr.getSplatValue<APInt>());
+  std::optional<ConstantIntRanges> range;
+  for (const APInt &value : denseAttr.getValues<APInt>()) {
+    auto valueRange = ConstantIntRanges::constant(value);
+    range = range ? range->rangeUnion(valueRange) : valueRange;
+  }
+  return range;
+}
+
+// The range of the single result of `op` given the ranges of its operands, if
+// `op` is understood.
+std::optional<ConstantIntRanges>
+inferRange(Operation *op, ArrayRef<ConstantIntRanges> args) {
+  using namespace intrange;
+  unsigned width = getRangeBitwidth(op->getResult(0).getType());
+  APInt maxInt32 = APInt::getSignedMaxValue(32);
+  return llvm::TypeSwitch<Operation *, std::optional<ConstantIntRanges>>(op)
+      .Case<arith::ConstantOp>(
+          [](auto op) { return getConstantRange(op.getValue()); })
+      .Case<triton::MakeRangeOp>([](auto op) {
+        return ConstantIntRanges::fromSigned(APInt(32, op.getStart(), true),
+                                             APInt(32, op.getEnd() - 1, true));
+      })
+      // Grid dimensions are positive 32-bit integers.
+      .Case<triton::GetProgramIdOp>([&](auto) {
+        return ConstantIntRanges::fromSigned(APInt::getZero(32), maxInt32);
+      })
+      .Case<triton::GetNumProgramsOp>([&](auto) {
+        return ConstantIntRanges::fromSigned(APInt(32, 1), maxInt32);
+      })
+      // Ops moving elements around keep the range of their operand.
+      .Case<triton::SplatOp, triton::BroadcastOp, triton::ExpandDimsOp,
+            triton::ReshapeOp, triton::TransOp, triton::gpu::ConvertLayoutOp>(
+          [&](auto) { return args[0]; })
+      .Case<arith::AddIOp>([&](auto) { return inferAdd(args); })
+      .Case<arith::SubIOp>([&](auto) { return inferSub(args); })
+      .Case<arith::MulIOp>([&](auto) { return inferMul(args); })
+      .Case<arith::DivSIOp>([&](auto) { return inferDivS(args); })
+      .Case<arith::DivUIOp>([&](auto) { return inferDivU(args); })
+      .Case<arith::CeilDivSIOp>([&](auto) { return inferCeilDivS(args); })
+      .Case<arith::CeilDivUIOp>([&](auto) { return inferCeilDivU(args); })
+      .Case<arith::FloorDivSIOp>([&](auto) { return inferFloorDivS(args); })
+      .Case<arith::RemSIOp>([&](auto) { return inferRemS(args); })
+      .Case<arith::RemUIOp>([&](auto) { return inferRemU(args); })
+      .Case<arith::MaxSIOp>([&](auto) { return inferMaxS(args); })
+      .Case<arith::MaxUIOp>([&](auto) { return inferMaxU(args); })
+      .Case<arith::MinSIOp>([&](auto) { return inferMinS(args); })
+      .Case<arith::MinUIOp>([&](auto) { return inferMinU(args); })
+      .Case<arith::AndIOp>([&](auto) { return inferAnd(args); })
+      .Case<arith::OrIOp>([&](auto) { return inferOr(args); })
+      .Case<arith::XOrIOp>([&](auto) { return inferXor(args); })
+      .Case<arith::ShLIOp>([&](auto) { return inferShl(args); })
+      .Case<arith::ShRSIOp>([&](auto) { return inferShrS(args); })
+      .Case<arith::ShRUIOp>([&](auto) { return inferShrU(args); })
+      .Case<arith::ExtSIOp>([&](auto) { return extSIRange(args[0], width); })
+      .Case<arith::ExtUIOp>([&](auto) { return extUIRange(args[0], width); })
+      .Case<arith::TruncIOp>([&](auto) { return truncRange(args[0], width); })
+      .Case<arith::SelectOp>(
+          [&](auto) { return args[1].rangeUnion(args[2]); })
+      .Case<arith::CmpIOp>([&](arith::CmpIOp op) {
+        std::optional<bool> result = evaluatePred(
+            static_cast<CmpPredicate>(op.getPredicate()), args[0], args[1]);
+        if (!result)
+          return ConstantIntRanges::maxRange(1);
+        return ConstantIntRanges::constant(APInt(1, *result));
+      })
+      .Default([](Operation *) { return std::nullopt; });
+}
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// RangeInfo
+//===----------------------------------------------------------------------===//
+
+bool RangeInfo::fitsSigned(unsigned bitwidth) const {
+  return range && range->smin().getSignificantBits() <= bitwidth &&
+         range->smax().getSignificantBits() <= bitwidth;
+}
+
+RangeInfo RangeInfo::getPessimisticValueState(Value value) {
+  unsigned width = getRangeBitwidth(value.getType());
+  if (width == 0)
+    return RangeInfo(std::nullopt);
+  return RangeInfo(ConstantIntRanges::maxRange(width));
+}
+
+RangeInfo RangeInfo::join(const RangeInfo &lhs, const RangeInfo &rhs) {
+  // If one argument is not initialized, return the other.
+  if (lhs.isUninitialized())
+    return rhs;
+  if (rhs.isUninitialized())
+    return lhs;
+  if (!lhs.range || !rhs.range)
+    return RangeInfo(std::nullopt);
+  return RangeInfo(lhs.range->rangeUnion(*rhs.range));
+}
+
+//===----------------------------------------------------------------------===//
+// RangeAnalysis
+//===----------------------------------------------------------------------===//
+
+void RangeAnalysis::visitOperation(
+    Operation *op, ArrayRef<const dataflow::Lattice<RangeInfo> *> operands,
+    ArrayRef<dataflow::Lattice<RangeInfo> *> results) {
+  if (op->getNumResults() != 1)
+    return setAllToEntryStates(results);
+  SmallVector<ConstantIntRanges> argRanges;
+  for (auto *operand : operands) {
+    // The op is visited again once all its operands are known.
+    if (operand->getValue().isUninitialized())
+      return;
+    std::optional<ConstantIntRanges> range = operand->getValue().getRange();
+    if (!range)
+      return setAllToEntryStates(results);
+    argRanges.push_back(*range);
+  }
+  std::optional<ConstantIntRanges> range = inferRange(op, argRanges);
+  if (!range || range->umin().getBitWidth() !=
+                    getRangeBitwidth(op->getResult(0).getType()))
+    return setAllToEntryStates(results);
+
+  dataflow::Lattice<RangeInfo> *result = results.front();
+  bool wasInitialized = !result->getValue().isUninitialized();
+  ChangeResult changed = result->join(RangeInfo(*range));
+  if (changed == ChangeResult::Change && wasInitialized &&
+      op->getParentOfType<LoopLikeOpInterface>())
+    changed |= result->join(
+        RangeInfo::getPessimisticValueState(op->getResult(0)));
+  propagateIfChanged(result, changed);
+}
+
+void RangeAnalysis::visitForOpInductionVar(
+    scf::ForOp op, ArrayRef<dataflow::Lattice<RangeInfo> *> argLattices) {
+  auto lb = getLatticeElementFor(op, op.getLowerBound())->getValue();
+  auto ub = getLatticeElementFor(op, op.getUpperBound())->getValue();
+  auto step = getLatticeElementFor(op, op.getStep())->getValue();
+  // The loop is visited again once its bounds are known.
+  if (lb.isUninitialized() || ub.isUninitialized() || step.isUninitialized())
+    return;
+
+  RangeInfo inductionVar =
+      RangeInfo::getPessimisticValueState(op.getInductionVar());
+  std::optional<ConstantIntRanges> lbRange = lb.getRange();
+  std::optional<ConstantIntRanges> ubRange = ub.getRange();
+  std::optional<ConstantIntRanges> stepRange = step.getRange();
+  // With a positive step, the induction variable is in [lb, ub).
+  if (lbRange && ubRange && stepRange &&
+      stepRange->smin().isStrictlyPositive() &&
+      lbRange->smin().slt(ubRange->smax()))
+    inductionVar = RangeInfo(
+        ConstantIntRanges::fromSigned(lbRange->smin(), ubRange->smax() - 1));
+  propagateIfChanged(argLattices[0], argLattices[0]->join(inductionVar));
+}
+
+} // namespace mlir
@@ -170,8 +170,14 @@ bool ReduceOpHelper::isWarpSynchronous() {
 SmallVector<unsigned> ReduceOpHelper::getScratchConfig() {
   SmallVector<unsigned> smemShape;
   // that case doesn't need inter-warp communication
-  if (isWarpSynchronous())
-    return {0, 0};
+  if (isWarpSynchronous()) {
+    if (isReduceWithinCTA())
+      return {0, 0};
+    // but the partial results are still exchanged between CTAs
+    smemShape = convertType<unsigned>(getSrcShape());
+    smemShape[axis] = 1;
+    return smemShape;
+  }
 
   smemShape = convertType<unsigned>(getSrcShape());
   smemShape[axis] = getInterWarpSizeWithUniqueData();
@@ -199,12 +205,9 @@ bool ReduceOpHelper::isReduceWithinCTA() {
 }
 
 bool ReduceOpHelper::isSupportedLayout() {
-  // Layout optimization passes such as PlanCTAPass and
-  // RemoveLayoutConversionPass should avoid cross-CTA reduction
-  if (!isReduceWithinCTA()) {
-    return false;
-  }
-
+  // Cross-CTA reductions are lowered by combining the partial results of the
+  // CTAs through distributed shared memory, layout optimization passes such
+  // as PlanCTAPass should still avoid them.
   auto srcLayout = getSrcLayout();
   if (srcLayout.isa<triton::gpu::BlockedEncodingAttr>()) {
     return true;
@@ -507,6 +510,15 @@ bool supportDPAS(triton::DotOp op) {
   Type AElemTy = ATy.getElementType(), BElemTy = BTy.getElementType(),
        CElemTy = CTy.getElementType(), DElemTy = DTy.getElementType();
 
+  // DPAS has no FP8 precision: FP8 operands are upcasted to f16 in registers
+  // by the accelerate-matmul pass and the dot is computed in f16.
+  auto isFP8 = [](Type ty) {
+    return ty.isFloat8E5M2() || ty.isFloat8E4M3FN() || ty.isFloat8E4M3FNUZ() ||
+           ty.isFloat8E5M2FNUZ() || ty.isFloat8E4M3B11FNUZ();
+  };
+  if (isFP8(AElemTy) && isFP8(BElemTy))
+    return CElemTy == DElemTy && (CElemTy.isF32() || CElemTy.isF16());
+
   if (AElemTy != BElemTy || CElemTy != DElemTy)
     return false;
 
@@ -514,27 +526,57 @@ bool supportDPAS(triton::DotOp op) {
       !AElemTy.isInteger(8))
     return false;
 
-  if (!CElemTy.isF32() && !CElemTy.isInteger(32))
+  if (!CElemTy.isF32() && !CElemTy.isF16() && !CElemTy.isInteger(32))
     return false;
 
   // Supported types element types combinations are:
   //   Operand  A     B     C    D
   //  -------------------------------
   //   elemTy   f16   f16   f32  f32
+  //   elemTy   f16   f16   f16  f16  Note: accumulated in half precision
   //   elemTy   bf16  bf16  f32  f32
   //   elemTy   i8    i8    i32  i32
   //   elemTy   tf32  tf32  f32  f32  Note: tf32 represented via f32
 
-  if ((AElemTy.isF16() || AElemTy.isBF16()) && !CElemTy.isF32())
+  if (AElemTy.isF16() && !CElemTy.isF32() && !CElemTy.isF16())
+    return false;
+  if (AElemTy.isBF16() && !CElemTy.isF32())
     return false;
   if (AElemTy.isInteger(8) && !CElemTy.isInteger(32))
     return false;
   if (AElemTy.isF32() && !CElemTy.isF32())
     return false;
+  // f32 operands are computed in TF32
+  if (AElemTy.isF32() && !op.getAllowTF32())
+    return false;
 
   return true;
 }
 
+bool supportDPASOperandBlockLoad(RankedTensorType tensorTy) {
+  auto dotOpEnc =
+      tensorTy.getEncoding().dyn_cast<triton::gpu::DotOperandEncodingAttr>();
+  if (!dotOpEnc || tensorTy.getRank() != 2)
+    return false;
+  auto dpasLayout =
+      dotOpEnc.getParent().dyn_cast<triton::gpu::DpasEncodingAttr>();
+  if (!dpasLayout ||
+      product<unsigned>(triton::gpu::getCTAsPerCGA(dpasLayout)) != 1)
+    return false;
+
+  // The block reads deliver the register layout of 16-bit operands, which
+  // are not converted after the load (kWidth matches the element type).
+  Type elemTy = tensorTy.getElementType();
+  if (elemTy.getIntOrFloatBitWidth() != 16 ||
+      dotOpEnc.getKWidth() != dpasLayout.getOpsPerChannel(elemTy))
+    return false;
+
+  // Every repetition must be a full block.
+  auto shape = tensorTy.getShape();
+  auto elemsPerInstr = dotOpEnc.getDPASElemsPerInstr(16);
+  return shape[0] % elemsPerInstr[0] == 0 && shape[1] % elemsPerInstr[1] == 0;
+}
+
 bool isMfmaToDotShortcut(RankedTensorType &srcTy, RankedTensorType &dstTy) {
   auto srcLayout = srcTy.getEncoding();
   auto dstLayout = dstTy.getEncoding();
@@ -598,6 +640,361 @@ bool isMmaToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy) {
 
 namespace {
 
+SmallVector<unsigned> delinearizeIndex(unsigned linearIndex,
+                                       ArrayRef<unsigned> shape,
+                                       ArrayRef<unsigned> order) {
+  SmallVector<unsigned> multiDimIndex(shape.size());
+  for (unsigned d : order) {
+    multiDimIndex[d] = linearIndex % shape[d];
+    linearIndex /= shape[d];
+  }
+  return multiDimIndex;
+}
+
+// Coordinates of the first element held by lane \p laneId of warp \p warpId,
+// mirroring emitBaseIndexForLayout.
+std::optional<SmallVector<unsigned>>
+getBaseCoordForCvt(Attribute layout, ArrayRef<int64_t> shape, unsigned warpId,
+                   unsigned laneId) {
+  unsigned rank = shape.size();
+  SmallVector<unsigned> base(rank);
+  if (auto blockedLayout = layout.dyn_cast<triton::gpu::BlockedEncodingAttr>()) {
+    auto sizePerThread = blockedLayout.getSizePerThread();
+    auto threadsPerWarp = blockedLayout.getThreadsPerWarp();
+    auto order = blockedLayout.getOrder();
+    SmallVector<unsigned> multiDimWarpId =
+        delinearizeIndex(warpId, blockedLayout.getWarpsPerCTA(), order);
+    SmallVector<unsigned> multiDimLaneId =
+        delinearizeIndex(laneId, threadsPerWarp, order);
+    for (unsigned d = 0; d < rank; ++d) {
+      unsigned maxWarps =
+          ceil<unsigned>(shape[d], sizePerThread[d] * threadsPerWarp[d]);
+      unsigned maxThreads = ceil<unsigned>(shape[d], sizePerThread[d]);
+      base[d] = sizePerThread[d] * (multiDimLaneId[d] % maxThreads +
+                                    (multiDimWarpId[d] % maxWarps) *
+                                        threadsPerWarp[d]);
+    }
+    return base;
+  }
+  if (auto dpasLayout = layout.dyn_cast<triton::gpu::DpasEncodingAttr>()) {
+    unsigned repeatCount = dpasLayout.getRepeatCount();
+    unsigned executionSize = dpasLayout.getExecutionSize();
+    if (shape[0] % repeatCount != 0 || shape[1] % executionSize != 0)
+      return std::nullopt;
+    SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
+    SmallVector<unsigned> threadsPerWarp = dpasLayout.getThreadsPerWarp();
+    SmallVector<unsigned> contigPerThread =
+        triton::gpu::getContigPerThread(dpasLayout);
+    unsigned rowWarpId =
+        (warpId % warpsPerCTA[0]) % (shape[0] / repeatCount);
+    unsigned colWarpId =
+        (warpId / warpsPerCTA[0]) % warpsPerCTA[1] % (shape[1] / executionSize);
+    base[0] = contigPerThread[0] * (laneId / threadsPerWarp[1]) +
+              rowWarpId * repeatCount;
+    base[1] = contigPerThread[1] * (laneId % threadsPerWarp[1]) +
+              colWarpId * executionSize;
+    return base;
+  }
+  return std::nullopt;
+}
+
+// Linearized coordinates of the elements of a DPAS A operand held by lane
+// \p laneId of warp \p warpId, in the order of the per-repetition vectors
+// loaded by SharedToDotOperandDPAS.
+std::optional<SmallVector<unsigned>>
+getDpasOperandACoordsForCvt(RankedTensorType type, unsigned warpId,
+                            unsigned laneId) {
+  auto dotOpLayout =
+      type.getEncoding().cast<triton::gpu::DotOperandEncodingAttr>();
+  auto dpasLayout =
+      dotOpLayout.getParent().cast<triton::gpu::DpasEncodingAttr>();
+  // With a single column of warps, the A operand of warp w is the rows of the
+  // accumulator of warp w, whatever the order of the warps.
+  SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
+  if (dotOpLayout.getOpIdx() != 0 || warpsPerCTA[1] != 1)
+    return std::nullopt;
+
+  ArrayRef<int64_t> shape = type.getShape();
+  Type elemTy = type.getElementType();
+  unsigned bitWidth = dotOpLayout.getDPASBitWidth(elemTy);
+  unsigned opsPerChannel = dpasLayout.getOpsPerChannel(bitWidth);
+  SmallVector<int64_t> instrShape = dotOpLayout.getDPASElemsPerInstr(bitWidth);
+  SmallVector<int64_t> numReps = dotOpLayout.getDPASRep(shape, elemTy);
+  unsigned repeatCount = dpasLayout.getRepeatCount();
+  unsigned systolicDepth = dpasLayout.getSystolicDepth();
+  unsigned threadsPerWarp =
+      product<unsigned>(triton::gpu::getThreadsPerWarp(dpasLayout));
+  unsigned rowsPerWarp = threadsPerWarp / systolicDepth;
+  if (!rowsPerWarp || repeatCount % rowsPerWarp != 0)
+    return std::nullopt;
+
+  unsigned rowTiles = ceil<unsigned>(shape[0], repeatCount);
+  unsigned warpsPerTile = std::min(warpsPerCTA[0], rowTiles);
+  unsigned outerWarp = warpId % rowTiles;
+  unsigned laneRow = laneId / systolicDepth;
+  unsigned laneCol = (laneId % systolicDepth) * opsPerChannel;
+
+  SmallVector<unsigned> coords;
+  for (unsigned m = 0; m < numReps[0]; ++m)
+    for (unsigned k = 0; k < numReps[1]; ++k)
+      for (unsigned rep = 0; rep < repeatCount / rowsPerWarp; ++rep)
+        for (unsigned opsIdx = 0; opsIdx < opsPerChannel; ++opsIdx) {
+          unsigned row = (m * warpsPerTile + outerWarp) * repeatCount +
+                         rep * rowsPerWarp + laneRow;
+          unsigned col = k * instrShape[1] + laneCol + opsIdx;
+          coords.push_back((row % shape[0]) * shape[1] + col % shape[1]);
+        }
+  return coords;
+}
+
+// Linearized coordinates of the elements held by lane \p laneId of warp
+// \p warpId, in register order (see processReplica in the layout conversion
+// lowering).
+std::optional<SmallVector<unsigned>>
+getRegCoordsForCvt(RankedTensorType type, unsigned warpId, unsigned laneId) {
+  Attribute layout = type.getEncoding();
+  ArrayRef<int64_t> shape = type.getShape();
+  if (layout.isa<triton::gpu::DotOperandEncodingAttr>())
+    return getDpasOperandACoordsForCvt(type, warpId, laneId);
+  auto base = getBaseCoordForCvt(layout, shape, warpId, laneId);
+  if (!base)
+    return std::nullopt;
+  unsigned rank = shape.size();
+  SmallVector<unsigned> sizePerThread = triton::gpu::getSizePerThread(layout);
+  SmallVector<unsigned> order = triton::gpu::getOrder(layout);
+  SmallVector<unsigned> shapePerCTATile =
+      triton::gpu::getShapePerCTATile(layout, shape);
+  SmallVector<unsigned> numCTATiles(rank);
+  for (unsigned d = 0; d < rank; ++d)
+    numCTATiles[d] = ceil<unsigned>(shape[d], shapePerCTATile[d]);
+
+  unsigned accumSizePerThread = product<unsigned>(sizePerThread);
+  unsigned elemsPerThread = triton::gpu::getTotalElemsPerThread(type);
+  SmallVector<unsigned> coords;
+  coords.reserve(elemsPerThread);
+  for (unsigned n = 0; n < elemsPerThread; ++n) {
+    SmallVector<unsigned> multiDimCTAId =
+        delinearizeIndex(n / accumSizePerThread, numCTATiles, order);
+    SmallVector<unsigned> multiDimElemId =
+        delinearizeIndex(n % accumSizePerThread, sizePerThread, order);
+    unsigned linear = 0;
+    for (unsigned d = 0; d < rank; ++d) {
+      unsigned coord = (*base)[d] + multiDimCTAId[d] * shapePerCTATile[d] +
+                       multiDimElemId[d];
+      // Layouts larger than the tensor wrap around, replicating elements.
+      coord %= shape[d];
+      linear = linear * shape[d] + coord;
+    }
+    coords.push_back(linear);
+  }
+  return coords;
+}
+
+} // namespace
+
+std::optional<SubGroupShuffleCvt> getSubGroupShuffleCvt(RankedTensorType srcTy,
+                                                        RankedTensorType dstTy) {
+  Attribute srcLayout = srcTy.getEncoding();
+  Attribute dstLayout = dstTy.getEncoding();
+  // The A operand of a dot chained to the one producing the source is
+  // distributed over the warps and lanes of the source layout.
+  Attribute dstParent = dstLayout;
+  if (auto dotOpLayout =
+          dstLayout.dyn_cast<triton::gpu::DotOperandEncodingAttr>()) {
+    if (dotOpLayout.getParent() != srcLayout)
+      return std::nullopt;
+    dstParent = srcLayout;
+  }
+  auto isSupported = [](Attribute layout) {
+    return layout.isa<triton::gpu::BlockedEncodingAttr,
+                      triton::gpu::DpasEncodingAttr>();
+  };
+  if (!isSupported(srcLayout) || !isSupported(dstParent) ||
+      !(srcLayout.isa<triton::gpu::DpasEncodingAttr>() ||
+        dstParent.isa<triton::gpu::DpasEncodingAttr>()))
+    return std::nullopt;
+  if (triton::gpu::getNumCTAs(srcLayout) != 1 ||
+      triton::gpu::getNumCTAs(dstParent) != 1)
+    return std::nullopt;
+  unsigned warpSize =
+      product<unsigned>(triton::gpu::getThreadsPerWarp(srcLayout));
+  unsigned numWarps = product<unsigned>(triton::gpu::getWarpsPerCTA(srcLayout));
+  if (warpSize !=
+          product<unsigned>(triton::gpu::getThreadsPerWarp(dstParent)) ||
+      numWarps != product<unsigned>(triton::gpu::getWarpsPerCTA(dstParent)))
+    return std::nullopt;
+
+  // Bound the compile time spent on the element maps below. Dot operands
+  // count their registers in vectors, so take the number of scalars from the
+  // coordinates instead.
+  unsigned srcElems = triton::gpu::getTotalElemsPerThread(srcTy);
+  std::optional<SmallVector<unsigned>> lane0Coords =
+      getRegCoordsForCvt(dstTy, 0, 0);
+  if (!lane0Coords)
+    return std::nullopt;
+  unsigned dstElems = lane0Coords->size();
+  constexpr unsigned kMaxMappedElems = 1 << 17;
+  if (numWarps * warpSize * (srcElems + dstElems) > kMaxMappedElems)
+    return std::nullopt;
+
+  // (warp, element) -> the (lane, register) pairs holding it in the source.
+  DenseMap<std::pair<unsigned, unsigned>,
+           SmallVector<std::pair<unsigned, unsigned>, 1>>
+      srcLocs;
+  SmallVector<SmallVector<unsigned>> dstCoords;
+  for (unsigned warpId = 0; warpId < numWarps; ++warpId) {
+    for (unsigned laneId = 0; laneId < warpSize; ++laneId) {
+      auto srcCoords = getRegCoordsForCvt(srcTy, warpId, laneId);
+      auto coords = getRegCoordsForCvt(dstTy, warpId, laneId);
+      if (!srcCoords || !coords)
+        return std::nullopt;
+      for (auto [reg, coord] : llvm::enumerate(*srcCoords))
+        srcLocs[{warpId, coord}].push_back({laneId, reg});
+      dstCoords.push_back(std::move(*coords));
+    }
+  }
+
+  // Lane of warp \p warpId holding \p coord in register \p reg, if any.
+  auto findSrcLane = [&](unsigned warpId, unsigned coord,
+                         unsigned reg) -> std::optional<unsigned> {
+    auto it = srcLocs.find({warpId, coord});
+    if (it == srcLocs.end())
+      return std::nullopt;
+    for (auto [laneId, srcReg] : it->second)
+      if (srcReg == reg)
+        return laneId;
+    return std::nullopt;
+  };
+
+  // Lane \p laneId reads \p coord of every warp from register \p srcReg of
+  // a lane that doesn't depend on the warp, returned if there is one.
+  auto findLaneForAllWarps = [&](unsigned laneId, unsigned reg,
+                                 unsigned srcReg) -> std::optional<unsigned> {
+    std::optional<unsigned> srcLane;
+    for (unsigned warpId = 0; warpId < numWarps; ++warpId) {
+      auto lane = findSrcLane(
+          warpId, dstCoords[warpId * warpSize + laneId][reg], srcReg);
+      if (!lane || (srcLane && *srcLane != *lane))
+        return std::nullopt;
+      srcLane = lane;
+    }
+    return srcLane;
+  };
+
+  // Prefer a single source register for all lanes of a result register, which
+  // takes one shuffle. Otherwise every lane picks its own source register.
+  SubGroupShuffleCvt cvt;
+  for (unsigned reg = 0; reg < dstElems; ++reg) {
+    SmallVector<unsigned> srcRegs, srcLanes;
+    auto it = srcLocs.find({0, dstCoords[0][reg]});
+    if (it == srcLocs.end())
+      return std::nullopt;
+    for (unsigned srcReg : llvm::make_second_range(it->second)) {
+      srcLanes.clear();
+      for (unsigned laneId = 0; laneId < warpSize; ++laneId) {
+        auto srcLane = findLaneForAllWarps(laneId, reg, srcReg);
+        if (!srcLane)
+          break;
+        srcLanes.push_back(*srcLane);
+      }
+      if (srcLanes.size() == warpSize) {
+        srcRegs.assign(warpSize, srcReg);
+        break;
+      }
+    }
+    if (srcRegs.empty()) {
+      srcLanes.clear();
+      for (unsigned laneId = 0; laneId < warpSize; ++laneId) {
+        auto it = srcLocs.find({0, dstCoords[laneId][reg]});
+        if (it == srcLocs.end())
+          return std::nullopt;
+        std::optional<unsigned> srcLane;
+        for (unsigned srcReg : llvm::make_second_range(it->second)) {
+          srcLane = findLaneForAllWarps(laneId, reg, srcReg);
+          if (srcLane) {
+            srcRegs.push_back(srcReg);
+            break;
+          }
+        }
+        if (!srcLane)
+          return std::nullopt;
+        srcLanes.push_back(*srcLane);
+      }
+    }
+    cvt.srcRegs.push_back(std::move(srcRegs));
+    cvt.srcLanes.push_back(std::move(srcLanes));
+  }
+  return cvt;
+}
+
+bool isSubGroupLocalCvt(RankedTensorType srcTy, RankedTensorType dstTy) {
+  Attribute srcLayout = srcTy.getEncoding();
+  Attribute dstLayout = dstTy.getEncoding();
+  auto isSupported = [&](Attribute layout) {
+    if (!layout.isa<triton::gpu::BlockedEncodingAttr,
+                    triton::gpu::DpasEncodingAttr>() ||
+        triton::gpu::getNumCTAs(layout) != 1)
+      return false;
+    // Layouts larger than the tensor wrap around, which the addresses of the
+    // scratch buffer don't.
+    SmallVector<unsigned> shapePerCTATile =
+        triton::gpu::getShapePerCTATile(layout, srcTy.getShape());
+    for (auto [tile, dim] : llvm::zip(shapePerCTATile, srcTy.getShape()))
+      if (static_cast<int64_t>(tile) > dim)
+        return false;
+    return true;
+  };
+  if (!isSupported(srcLayout) || !isSupported(dstLayout))
+    return false;
+  unsigned warpSize =
+      product<unsigned>(triton::gpu::getThreadsPerWarp(srcLayout));
+  unsigned numWarps = product<unsigned>(triton::gpu::getWarpsPerCTA(srcLayout));
+  if (warpSize !=
+          product<unsigned>(triton::gpu::getThreadsPerWarp(dstLayout)) ||
+      numWarps != product<unsigned>(triton::gpu::getWarpsPerCTA(dstLayout)))
+    return false;
+
+  // Bound the compile time spent on the element sets below.
+  unsigned elems = triton::gpu::getTotalElemsPerThread(srcTy) +
+                   triton::gpu::getTotalElemsPerThread(dstTy);
+  constexpr unsigned kMaxMappedElems = 1 << 17;
+  if (numWarps * warpSize * elems > kMaxMappedElems)
+    return false;
+
+  for (unsigned warpId = 0; warpId < numWarps; ++warpId) {
+    DenseSet<unsigned> srcCoords;
+    SmallVector<unsigned> dstCoords;
+    for (unsigned laneId = 0; laneId < warpSize; ++laneId) {
+      auto laneSrcCoords = getRegCoordsForCvt(srcTy, warpId, laneId);
+      auto laneDstCoords = getRegCoordsForCvt(dstTy, warpId, laneId);
+      if (!laneSrcCoords || !laneDstCoords)
+        return false;
+      srcCoords.insert(laneSrcCoords->begin(), laneSrcCoords->end());
+      dstCoords.append(*laneDstCoords);
+    }
+    if (llvm::any_of(dstCoords,
+                     [&](unsigned coord) { return !srcCoords.contains(coord); }))
+      return false;
+  }
+  return true;
+}
+
+bool isWarpLocalGather(RankedTensorType srcTy, RankedTensorType indicesTy,
+                       unsigned axis) {
+  auto layout =
+      srcTy.getEncoding().dyn_cast_or_null<triton::gpu::BlockedEncodingAttr>();
+  if (!layout || layout != indicesTy.getEncoding() ||
+      triton::gpu::getCTASplitNum(layout)[axis] != 1)
+    return false;
+  // Sources smaller than the registers of a thread wrap around within them.
+  if (srcTy.getDimSize(axis) < layout.getSizePerThread()[axis])
+    return false;
+  return triton::gpu::getWarpsPerCTAWithUniqueData(
+             layout, srcTy.getShape())[axis] == 1;
+}
+
+namespace {
+
 /// A data structure similar to SetVector but maintains
 /// a deque instead of a vector to allow for efficient
 /// push_back and pop_front operations.
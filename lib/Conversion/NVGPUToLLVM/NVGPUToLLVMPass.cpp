@@ -10,6 +10,8 @@
 
 #include "triton/Conversion/TritonGPUToLLVM/PTXAsmFormat.h"
 
+#include <functional>
+
 #include "../lib/Conversion/TritonGPUToLLVM/Utility.h"
 using namespace mlir;
 using namespace mlir::triton;
@@ -26,14 +28,8 @@ using OperandsAndConstraints = std::vector<std::pair<mlir::Value, std::string>>;
 typedef std::vector<std::string> Constraints;
 
 const std::string Reg_Alloc_Op = "setmaxnreg.inc.sync.aligned.u32 #regCount;";
-const std::string Wgmma_Fence_Op = "wgmma.fence.sync.aligned;";
-const std::string Cga_Barrier_Sync_op = "barrier.cluster.sync.aligned;";
-const std::string Wgmma_Commit_Group_Op = "wgmma.commit_group.sync.aligned;";
-const std::string Cluster_Wait_Op = "barrier.cluster.wait.aligned;";
 const std::string Fence_Mbarrier_Init_Op =
     "fence.mbarrier_init.release.cluster;";
-const std::string Cga_Barrier_Arrive_Op = "barrier.cluster.arrive;";
-const std::string Cga_Barrier_Wait_Op = "barrier.cluster.wait;";
 const std::string Reg_Dealloc_Op = "setmaxnreg.dec.sync.aligned.u32 #regCount;";
 
 const std::string Mbarrier_Init_Op =
@@ -60,23 +56,6 @@ const std::string Cluster_Cta_Id_Op = "{\n"
                                       "mad.lo.u32 a1, a2, a4, a1;     \n"
                                       "mad.lo.u32 $0, a1, a3, a0;     \n"
                                       "}";
-const std::string Canonical_Warp_Id_Op =
-    "{\n"
-    ".reg .u32 a<5>;              \n"
-    "mov.u32 a0, %tid.x;          \n" // x
-    "mov.u32 a1, %tid.y;          \n" // y
-    "mov.u32 a2, %tid.z;          \n" // z
-    "mov.u32 a3, %ntid.x;         \n" // nx
-    "mov.u32 a4, %ntid.y;         \n" // ny
-    "mad.lo.u32 a1, a2, a4, a1;   \n"
-    "mad.lo.u32 a0, a1, a3, a0;   \n"
-    "shr.u32 a0, a0, 5;           \n"
-    ".reg .b32         %tmp<3>;   \n"
-    "mov.u32   %tmp0, -1;         \n"
-    "mov.u32   %tmp1, 31;         \n"
-    "mov.u32   %tmp2, 0;          \n"
-    "shfl.sync.idx.b32         $0, a0, %tmp2, %tmp1, %tmp0;           \n"
-    "}";
 
 bool isNumber(const std::string &s) {
   return !s.empty() && std::find_if(s.begin(), s.end(), [](unsigned char c) {
@@ -320,21 +299,47 @@ public:
   }
 };
 
-class ClusterArriveOpPattern
-    : public NVGPUOpPatternBase<ttn::ClusterArriveOp, ClusterArriveOpPattern> {
+// Lowers an NVGPU op to the NVVM ops doing the same. Unlike inline PTX, they
+// translate to LLVM intrinsics, which the NVPTX backend schedules around and
+// CSEs.
+template <typename SourceOp>
+class NVGPUToNVVMPattern : public OpRewritePattern<SourceOp> {
 public:
-  using Base = NVGPUOpPatternBase<ttn::ClusterArriveOp, ClusterArriveOpPattern>;
-  using Base::Base;
+  using BuildFn =
+      std::function<Value(SourceOp, Location, mlir::PatternRewriter &)>;
 
-  std::string getPtxAsm(ttn::ClusterArriveOp op) const {
-    auto relaxed = op.getRelaxed();
-    if (relaxed)
-      return "barrier.cluster.arrive.relaxed.aligned;";
+  NVGPUToNVVMPattern(mlir::MLIRContext *context, BuildFn build)
+      : OpRewritePattern<SourceOp>(context), build(build) {}
+
+  LogicalResult matchAndRewrite(SourceOp op,
+                                PatternRewriter &rewriter) const override {
+    Value result = build(op, op->getLoc(), rewriter);
+    if (result)
+      rewriter.replaceOp(op, result);
     else
-      return "barrier.cluster.arrive.aligned;";
+      rewriter.eraseOp(op);
+    return success();
   }
+
+private:
+  BuildFn build;
 };
 
+// The warp id of the thread, which is uniform across the warp: it is
+// broadcast from lane 0 so that the backend knows it.
+Value createCanonicalWarpId(Location loc, mlir::PatternRewriter &rewriter) {
+  Value tidX = rewriter.create<NVVM::ThreadIdXOp>(loc, i32_ty);
+  Value tidY = rewriter.create<NVVM::ThreadIdYOp>(loc, i32_ty);
+  Value tidZ = rewriter.create<NVVM::ThreadIdZOp>(loc, i32_ty);
+  Value ntidX = rewriter.create<NVVM::BlockDimXOp>(loc, i32_ty);
+  Value ntidY = rewriter.create<NVVM::BlockDimYOp>(loc, i32_ty);
+  Value tid = add(mul(add(mul(tidZ, ntidY), tidY), ntidX), tidX);
+  Value warpId = lshr(tid, i32_val(5));
+  return rewriter.create<NVVM::ShflOp>(loc, i32_ty, i32_val(-1), warpId,
+                                       i32_val(0), i32_val(31),
+                                       NVVM::ShflKind::idx, UnitAttr());
+}
+
 class StoreMatrixOpPattern
     : public NVGPUOpPatternBase<ttn::StoreMatrixOp, StoreMatrixOpPattern> {
 public:
@@ -1083,15 +1088,63 @@ public:
   patterns.add<NVGPUOpGenericPattern<SRC_OP>>(context, ASM, Constraints(),     \
                                               Constraints());
     POPULATE_NVGPU_OP(ttn::RegAllocOp, Reg_Alloc_Op)
-    POPULATE_NVGPU_OP(ttn::WGMMAFenceOp, Wgmma_Fence_Op)
-    POPULATE_NVGPU_OP(ttn::CGABarrierSyncOp, Cga_Barrier_Sync_op)
-    POPULATE_NVGPU_OP(ttn::WGMMACommitGroupOp, Wgmma_Commit_Group_Op)
-    POPULATE_NVGPU_OP(ttn::ClusterWaitOp, Cluster_Wait_Op)
     POPULATE_NVGPU_OP(ttn::FenceMBarrierInitOp, Fence_Mbarrier_Init_Op)
-    POPULATE_NVGPU_OP(ttn::CGABarrierArriveOp, Cga_Barrier_Arrive_Op)
-    POPULATE_NVGPU_OP(ttn::CGABarrierWaitOp, Cga_Barrier_Wait_Op)
     POPULATE_NVGPU_OP(ttn::RegDeallocOp, Reg_Dealloc_Op)
 #undef POPULATE_NVGPU_OP
+
+    patterns.add<NVGPUToNVVMPattern<ttn::WGMMAFenceOp>>(
+        context, [](ttn::WGMMAFenceOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          rewriter.create<NVVM::WgmmaFenceAlignedOp>(loc);
+          return {};
+        });
+    patterns.add<NVGPUToNVVMPattern<ttn::WGMMACommitGroupOp>>(
+        context, [](ttn::WGMMACommitGroupOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          rewriter.create<NVVM::WgmmaGroupSyncAlignedOp>(loc);
+          return {};
+        });
+    patterns.add<NVGPUToNVVMPattern<ttn::CGABarrierSyncOp>>(
+        context, [](ttn::CGABarrierSyncOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          rewriter.create<NVVM::ClusterArriveOp>(loc, rewriter.getUnitAttr());
+          rewriter.create<NVVM::ClusterWaitOp>(loc, rewriter.getUnitAttr());
+          return {};
+        });
+    patterns.add<NVGPUToNVVMPattern<ttn::ClusterArriveOp>>(
+        context, [](ttn::ClusterArriveOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          if (op.getRelaxed())
+            rewriter.create<NVVM::ClusterArriveRelaxedOp>(
+                loc, rewriter.getUnitAttr());
+          else
+            rewriter.create<NVVM::ClusterArriveOp>(loc, rewriter.getUnitAttr());
+          return {};
+        });
+    patterns.add<NVGPUToNVVMPattern<ttn::ClusterWaitOp>>(
+        context, [](ttn::ClusterWaitOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          rewriter.create<NVVM::ClusterWaitOp>(loc, rewriter.getUnitAttr());
+          return {};
+        });
+    // Not .aligned: the threads of a warp may arrive and wait apart.
+    patterns.add<NVGPUToNVVMPattern<ttn::CGABarrierArriveOp>>(
+        context, [](ttn::CGABarrierArriveOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          rewriter.create<NVVM::ClusterArriveOp>(loc, UnitAttr());
+          return {};
+        });
+    patterns.add<NVGPUToNVVMPattern<ttn::CGABarrierWaitOp>>(
+        context, [](ttn::CGABarrierWaitOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          rewriter.create<NVVM::ClusterWaitOp>(loc, UnitAttr());
+          return {};
+        });
+    patterns.add<NVGPUToNVVMPattern<ttn::CanonicalWarpIdOp>>(
+        context, [](ttn::CanonicalWarpIdOp op, Location loc,
+                    PatternRewriter &rewriter) -> Value {
+          return createCanonicalWarpId(loc, rewriter);
+        });
     patterns.add<NVGPUOpGenericPattern<ttn::MBarrierInitOp>>(
         context, Mbarrier_Init_Op, Constraints(), Constraints({"r", "b"}));
     patterns.add<NVGPUOpGenericPattern<ttn::MBarrierWaitOp>>(
@@ -1105,12 +1158,10 @@ public:
         context, Sts64_Op, Constraints(), Constraints({"r", "r", "r"}));
     patterns.add<NVGPUOpGenericPattern<ttn::ClusterCTAIdOp>>(
         context, Cluster_Cta_Id_Op, Constraints({"=r"}), Constraints());
-    patterns.add<NVGPUOpGenericPattern<ttn::CanonicalWarpIdOp>>(
-        context, Canonical_Warp_Id_Op, Constraints({"=r"}), Constraints());
 
     patterns.add<FenceAsyncSharedOpPattern, StoreMatrixOpPattern,
                  OffsetOfStmatrixV4OpPattern, MBarrierArriveOpPattern,
-                 ClusterArriveOpPattern, TMALoadTiledOpPattern,
+                 TMALoadTiledOpPattern,
                  TMAStoreTiledOpPattern, LoadDSmemOpPattern, WGMMAOpPattern,
                  WGMMAWaitGroupOpPattern, StoreDSmemOpPattern,
                  OffsetOfSts64OpPattern>(context);
@@ -5,6 +5,7 @@
 #include "triton/Conversion/TritonGPUToLLVM/Passes.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "llvm/Support/MathExtras.h"
 
 using namespace mlir;
 using namespace mlir::triton;
@@ -29,6 +30,39 @@ struct AllocateSharedMemory
     MLIRContext *ctx = &getContext();
     ModuleAllocation allocation(mod);
 
+    // Global scratch buffers are laid out one after the other in a buffer
+    // the launcher passes after the arguments of the kernel.
+    int64_t globalScratchSize = 0;
+    int64_t globalScratchAlignment = 1;
+    WalkResult scratchResult = mod.walk([&](FunctionOpInterface funcOp) {
+      SmallVector<GlobalScratchAllocOp> allocs;
+      funcOp.walk([&](GlobalScratchAllocOp op) { allocs.push_back(op); });
+      if (allocs.empty())
+        return WalkResult::advance();
+      // kernels are the public functions
+      if (funcOp.getVisibility() != SymbolTable::Visibility::Public) {
+        allocs.front().emitError(
+            "global scratch memory is only supported in kernels");
+        return WalkResult::interrupt();
+      }
+      for (GlobalScratchAllocOp op : allocs) {
+        int64_t alignment = std::max<int64_t>(op.getAlignment(), 1);
+        globalScratchSize = llvm::alignTo(globalScratchSize, alignment);
+        op->setAttr("allocation.offset",
+                    IntegerAttr::get(IntegerType::get(ctx, 32),
+                                     globalScratchSize));
+        globalScratchSize += op.getNbytes();
+        globalScratchAlignment = std::max(globalScratchAlignment, alignment);
+      }
+      // before the shared local memory argument of GENX kernels
+      funcOp.insertArgument(funcOp.getNumArguments(),
+                            LLVM::LLVMPointerType::get(ctx, 1), {},
+                            funcOp.getLoc());
+      return WalkResult::advance();
+    });
+    if (scratchResult.wasInterrupted())
+      return signalPassFailure();
+
     mod.walk([&](FunctionOpInterface funcOp) {
       if (target == Target::GENX && allocation.isRoot(funcOp) &&
           allocation.getSharedMemorySize()) {
@@ -58,6 +92,14 @@ struct AllocateSharedMemory
     mod->setAttr("triton_gpu.shared",
                  mlir::IntegerAttr::get(mlir::IntegerType::get(ctx, 32),
                                         allocation.getSharedMemorySize()));
+    if (globalScratchSize > 0) {
+      mod->setAttr("triton_gpu.global_scratch_memory_size",
+                   mlir::IntegerAttr::get(mlir::IntegerType::get(ctx, 32),
+                                          globalScratchSize));
+      mod->setAttr("triton_gpu.global_scratch_memory_alignment",
+                   mlir::IntegerAttr::get(mlir::IntegerType::get(ctx, 32),
+                                          globalScratchAlignment));
+    }
   }
 };
 
@@ -38,11 +38,9 @@ struct BarrierOpConversion
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op->getLoc();
     if (op->hasAttr("bar_id")) {
-      // llvm.nvvm.barrier0 doesn't support bar_id and num_threads attributes,
-      // so we have to lower it to ptx manually.
       auto barId = op->getAttrOfType<IntegerAttr>("bar_id").getInt();
       auto numThreads = op->getAttrOfType<IntegerAttr>("num_threads").getInt();
-      barSync(rewriter, op, barId, numThreads);
+      getTargetInfo(target).namedBarrier(rewriter, loc, op, barId, numThreads);
       rewriter.eraseOp(op);
       return success();
     }
@@ -92,8 +90,11 @@ struct AllocMBarrierOpConversion : public ConvertTritonGPUOpToLLVMPattern<
       if (i > 0) {
         smem = gep(elemPtrTy, llvmElemTy, smem, i32_val(i));
       }
-      rewriter.create<triton::nvgpu::MBarrierInitOp>(loc, smem, pred,
-                                                     op.getCount());
+      if (target == Target::GENX)
+        initGENXMBarrier(loc, rewriter, smem, pred, op.getCount());
+      else
+        rewriter.create<triton::nvgpu::MBarrierInitOp>(loc, smem, pred,
+                                                       op.getCount());
     }
     if (resultTensorTy) {
       auto llvmElemTy =
@@ -107,6 +108,26 @@ struct AllocMBarrierOpConversion : public ConvertTritonGPUOpToLLVMPattern<
     }
     return success();
   }
+
+private:
+  // GENX has no mbarrier: it is emulated by an i64 in shared memory holding
+  // the expected arrival count in its high half and the number of arrivals
+  // so far in its low half. The current phase is the parity of
+  // arrivals / count.
+  static void initGENXMBarrier(Location loc,
+                               ConversionPatternRewriter &rewriter, Value smem,
+                               Value pred, uint32_t count) {
+    Block *currentBlock = rewriter.getInsertionBlock();
+    Block *afterInit =
+        rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+    Block *initBlock = rewriter.createBlock(afterInit);
+    rewriter.setInsertionPointToEnd(currentBlock);
+    rewriter.create<LLVM::CondBrOp>(loc, pred, initBlock, afterInit);
+    rewriter.setInsertionPointToStart(initBlock);
+    store(i64_val(static_cast<uint64_t>(count) << 32), smem);
+    rewriter.create<LLVM::BrOp>(loc, afterInit);
+    rewriter.setInsertionPointToStart(afterInit);
+  }
 };
 
 struct MBarrierArriveOpConversion : public ConvertTritonGPUOpToLLVMPattern<
@@ -136,6 +157,18 @@ struct MBarrierArriveOpConversion : public ConvertTritonGPUOpToLLVMPattern<
     if (pred == nullptr) {
       pred = int_val(/*width*/ 1, 1);
     }
+    if (target == Target::GENX) {
+      // Only plain arrivals can be emulated; transaction counts track TMA
+      // copies and remote arrivals need clusters, neither exists on GENX.
+      if (type != triton::nvgpu::MBarriveType::normal)
+        return failure();
+      // See AllocMBarrierOpConversion for the layout of the emulated barrier.
+      Value inc = select(pred, i64_val(1), i64_val(0));
+      rewriter.create<LLVM::AtomicRMWOp>(loc, LLVM::AtomicBinOp::add, mbarrier,
+                                         inc, LLVM::AtomicOrdering::acq_rel);
+      rewriter.eraseOp(op);
+      return success();
+    }
     rewriter.replaceOpWithNewOp<triton::nvgpu::MBarrierArriveOp>(
         op, mbarrier, pred, remoteCtaId, type, txCount);
     return success();
@@ -151,6 +184,28 @@ struct MBarrierWaitOpConversion : public ConvertTritonGPUOpToLLVMPattern<
   matchAndRewrite(triton::nvidia_gpu::MBarrierWaitOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op->getLoc();
+    if (target == Target::GENX) {
+      // Spin until the phase differs from the one being waited on. See
+      // AllocMBarrierOpConversion for the layout of the emulated barrier.
+      Block *currentBlock = rewriter.getInsertionBlock();
+      Block *afterWait =
+          rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+      Block *spinBlock = rewriter.createBlock(afterWait);
+      rewriter.setInsertionPointToEnd(currentBlock);
+      rewriter.create<LLVM::BrOp>(loc, spinBlock);
+      rewriter.setInsertionPointToStart(spinBlock);
+      Value state = rewriter.create<LLVM::AtomicRMWOp>(
+          loc, LLVM::AtomicBinOp::add, adaptor.getMbarrier(), i64_val(0),
+          LLVM::AtomicOrdering::acquire);
+      Value count = trunc(i32_ty, lshr(state, i64_val(32)));
+      Value arrivals = trunc(i32_ty, state);
+      Value phase = trunc(i1_ty, udiv(arrivals, count));
+      Value pending = icmp_eq(phase, adaptor.getPhase());
+      rewriter.create<LLVM::CondBrOp>(loc, pending, spinBlock, afterWait);
+      rewriter.setInsertionPointToStart(afterWait);
+      rewriter.eraseOp(op);
+      return success();
+    }
     rewriter.replaceOpWithNewOp<triton::nvgpu::MBarrierWaitOp>(
         op, adaptor.getMbarrier(), adaptor.getPhase());
     return success();
@@ -193,6 +248,12 @@ struct NamedBarrierArriveOpConversion
                   OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op->getLoc();
+    if (target == Target::GENX) {
+      LLVM::createGENXNamedBarrierSignal(loc, rewriter, op, adaptor.getBar(),
+                                         adaptor.getNumThreads());
+      rewriter.eraseOp(op);
+      return success();
+    }
     rewriter.replaceOpWithNewOp<triton::nvgpu::NamedBarrierArriveOp>(
         op, adaptor.getBar(), adaptor.getNumThreads());
     return success();
@@ -209,6 +270,14 @@ struct NamedBarrierWaitOpConversion
   matchAndRewrite(triton::nvidia_gpu::NamedBarrierWaitOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op->getLoc();
+    if (target == Target::GENX) {
+      // bar.sync semantics: the waiting threads take part in the barrier.
+      LLVM::createGENXNamedBarrierSignal(loc, rewriter, op, adaptor.getBar(),
+                                         adaptor.getNumThreads());
+      LLVM::createGENXNamedBarrierWait(loc, rewriter, op, adaptor.getBar());
+      rewriter.eraseOp(op);
+      return success();
+    }
     rewriter.replaceOpWithNewOp<triton::nvgpu::NamedBarrierWaitOp>(
         op, adaptor.getBar(), adaptor.getNumThreads());
     return success();
@@ -7,6 +7,8 @@
 using ::mlir::LLVM::getSharedMemoryObjectFromStruct;
 using ::mlir::LLVM::getStridesFromShapeAndOrder;
 using ::mlir::LLVM::linearize;
+using ::mlir::LLVM::shflIdxSync;
+using ::mlir::LLVM::shflSync;
 
 using ::mlir::LLVM::getSharedMemoryObjectFromStruct;
 using ::mlir::LLVM::getStridesFromShapeAndOrder;
@@ -101,6 +103,12 @@ public:
         dstLayout.isa<DotOperandEncodingAttr>()) {
       return lowerMmaToDotOperand(op, adaptor, rewriter);
     }
+    // dpas -> the A operand of a chained dot, within each sub-group
+    if (srcLayout.isa<DpasEncodingAttr>() &&
+        dstLayout.isa<DotOperandEncodingAttr>()) {
+      if (auto shuffleCvt = getSubGroupShuffleCvt(srcTy, dstTy))
+        return lowerDistToDistWithShuffle(op, adaptor, rewriter, *shuffleCvt);
+    }
     if (srcLayout.isa<SharedEncodingAttr>() &&
         isaDistributedLayout(dstLayout)) {
       return lowerSharedToDistributed(op, adaptor, rewriter);
@@ -277,7 +285,8 @@ private:
     return multiDimOffsetWrapped;
   }
 
-  // shared memory rd/st for blocked or mma layout with data padding
+  // shared memory rd/st for blocked or mma layout with data padding or an XOR
+  // swizzle
   void processReplica(Location loc, ConversionPatternRewriter &rewriter,
                       bool stNotRd, RankedTensorType type,
                       ArrayRef<unsigned> numCTAsEachRep,
@@ -285,7 +294,8 @@ private:
                       ArrayRef<unsigned> paddedRepShape,
                       ArrayRef<unsigned> origRepShape,
                       ArrayRef<unsigned> outOrd, SmallVector<Value> &vals,
-                      Value smemBase) const {
+                      Value smemBase,
+                      CvtScratchSwizzle swizzle = CvtScratchSwizzle()) const {
     auto accumNumCTAsEachRep = product<unsigned>(numCTAsEachRep);
     auto layout = type.getEncoding();
     auto rank = type.getRank();
@@ -330,6 +340,16 @@ private:
         SmallVector<Value> multiDimOffsetWrapped = getWrappedMultiDimOffset(
             rewriter, loc, multiDimOffset, origRepShape, shapePerCTATile,
             shapePerCTA);
+        if (swizzle.maxPhase > 1) {
+          // `vec` divides swizzle.vec, so the access stays within one chunk.
+          Value col = multiDimOffsetWrapped[outOrd[0]];
+          Value row = multiDimOffsetWrapped[outOrd[1]];
+          Value chunkVec = i32_val(swizzle.vec);
+          Value chunk = xor_(udiv(col, chunkVec),
+                             urem(row, i32_val(swizzle.maxPhase)));
+          multiDimOffsetWrapped[outOrd[0]] =
+              add(mul(chunk, chunkVec), urem(col, chunkVec));
+        }
         Value offset = linearize(rewriter, loc, multiDimOffsetWrapped,
                                  paddedRepShape, outOrd);
         auto elemPtrTy = ptr_ty(rewriter.getContext(), 3);
@@ -550,6 +570,115 @@ private:
     return success();
   }
 
+  // Conversion whose elements all stay within their sub-group: each result
+  // register is a shuffle of the source registers it reads from, so no shared
+  // memory or barrier is needed.
+  LogicalResult
+  lowerDistToDistWithShuffle(triton::gpu::ConvertLayoutOp op,
+                             OpAdaptor adaptor,
+                             ConversionPatternRewriter &rewriter,
+                             const SubGroupShuffleCvt &shuffleCvt) const {
+    auto loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto dstTy = op.getResult().getType().cast<RankedTensorType>();
+    auto vals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    unsigned warpSize =
+        product<unsigned>(triton::gpu::getThreadsPerWarp(srcTy.getEncoding()));
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(warpSize));
+
+    Type elemTy = getTypeConverter()->convertType(srcTy.getElementType());
+    bool isInt1 = elemTy.isInteger(1);
+    bool isPtr = elemTy.isa<LLVM::LLVMPointerType>();
+    // Per-lane constants, shared by the registers using the same table.
+    std::map<SmallVector<unsigned>, Value> laneTables;
+    auto getLaneTable = [&](ArrayRef<unsigned> table) {
+      SmallVector<unsigned> key(table.begin(), table.end());
+      Value &entry = laneTables[key];
+      if (!entry) {
+        if (llvm::all_equal(table)) {
+          entry = i32_val(table[0]);
+        } else {
+          auto tableTy = vec_ty(i32_ty, warpSize);
+          SmallVector<int32_t> tableVec(table.begin(), table.end());
+          Value tableVal = rewriter.create<LLVM::ConstantOp>(
+              loc, tableTy, rewriter.getI32VectorAttr(tableVec));
+          entry = extract_element(i32_ty, tableVal, laneId);
+        }
+      }
+      return entry;
+    };
+    auto shuffle = [&](Value val, ArrayRef<unsigned> srcLanes) -> Value {
+      bool isIdentity = llvm::all_of(llvm::enumerate(srcLanes), [](auto it) {
+        return it.value() == it.index();
+      });
+      if (isIdentity)
+        return val;
+      if (isInt1)
+        val = zext(i32_ty, val);
+      else if (isPtr)
+        val = ptrtoint(i64_ty, val);
+      unsigned xorMask = srcLanes[0];
+      bool isButterfly =
+          llvm::all_of(llvm::enumerate(srcLanes), [&](auto it) {
+            return it.value() == (it.index() ^ xorMask);
+          });
+      if (isButterfly)
+        val = shflSync(loc, rewriter, val, xorMask, target);
+      else
+        val = shflIdxSync(loc, rewriter, val, getLaneTable(srcLanes), target);
+      if (isInt1)
+        val = icmp_ne(val, i32_val(0));
+      else if (isPtr)
+        val = inttoptr(elemTy, val);
+      return val;
+    };
+
+    SmallVector<Value> outVals;
+    for (auto [srcRegs, srcLanes] :
+         llvm::zip(shuffleCvt.srcRegs, shuffleCvt.srcLanes)) {
+      if (llvm::all_equal(srcRegs)) {
+        outVals.push_back(shuffle(vals[srcRegs[0]], srcLanes));
+        continue;
+      }
+      // Lanes reading different source registers: shuffle each of them and
+      // keep the one of the lane.
+      Value regIdx = getLaneTable(srcRegs);
+      SmallVector<unsigned> distinctRegs(srcRegs.begin(), srcRegs.end());
+      llvm::sort(distinctRegs);
+      distinctRegs.erase(std::unique(distinctRegs.begin(), distinctRegs.end()),
+                         distinctRegs.end());
+      Value val;
+      for (unsigned srcReg : distinctRegs) {
+        Value shuffled = shuffle(vals[srcReg], srcLanes);
+        val = val ? select(icmp_eq(regIdx, i32_val(srcReg)), shuffled, val)
+                  : shuffled;
+      }
+      outVals.push_back(val);
+    }
+
+    // Dot operands hold one vector per repetition.
+    if (dstTy.getEncoding().isa<DotOperandEncodingAttr>()) {
+      auto structTy =
+          getTypeConverter()->convertType(dstTy).cast<LLVM::LLVMStructType>();
+      auto vecTy = structTy.getBody()[0].cast<VectorType>();
+      unsigned vecSize = vecTy.getNumElements();
+      assert(outVals.size() % vecSize == 0 && "unexpected dot operand size");
+      SmallVector<Value> vecVals;
+      for (unsigned i = 0; i < outVals.size(); i += vecSize) {
+        Value vec = undef(vecTy);
+        for (unsigned j = 0; j < vecSize; ++j)
+          vec = insert_element(vecTy, vec, outVals[i + j], i32_val(j));
+        vecVals.push_back(vec);
+      }
+      outVals = std::move(vecVals);
+    }
+    Value result =
+        getTypeConverter()->packLLElements(loc, outVals, rewriter, dstTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
   // blocked/mma -> blocked/mma.
   // Data padding in shared memory to avoid bank conflict.
   LogicalResult
@@ -566,6 +695,8 @@ private:
 
     if (shouldUseDistSmem(srcLayout, dstLayout))
       return lowerDistToDistWithDistSmem(op, adaptor, rewriter);
+    if (auto shuffleCvt = getSubGroupShuffleCvt(srcTy, dstTy))
+      return lowerDistToDistWithShuffle(op, adaptor, rewriter, *shuffleCvt);
     Value smemBase =
         LLVM::getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
     auto elemPtrTy = ptr_ty(rewriter.getContext(), 3);
@@ -620,7 +751,9 @@ private:
     unsigned inVec = 0;
     unsigned outVec = 0;
     auto origRepShape = getRepShapeForCvtLayout(op);
-    auto paddedRepShape = getScratchConfigForCvtLayout(op, inVec, outVec);
+    CvtScratchSwizzle swizzle;
+    auto paddedRepShape =
+        getScratchConfigForCvtLayout(op, inVec, outVec, swizzle);
     if (getElementTypeOrSelf(op.getType())
             .isa<mlir::Float8E4M3B11FNUZType, mlir::Float8E4M3FNType>()) {
       assert(inVec % 4 == 0 && "conversion not supported for FP8E4M3B15");
@@ -631,6 +764,12 @@ private:
     auto outOrd = getOrder(dstLayout);
     SmallVector<Value> outVals(outElems);
 
+    // When every sub-group loads back only elements it stored itself, the
+    // sub-groups need not wait for each other between the store and the load.
+    // Replicas reuse the scratch buffer, so they still do between replicas.
+    bool subGroupLocal = target == Target::GENX && accumNumReplicates == 1 &&
+                         !getWSAgentId(op) && isSubGroupLocalCvt(srcTy, dstTy);
+
     for (unsigned repId = 0; repId < accumNumReplicates; ++repId) {
       auto multiDimRepId =
           getMultiDimIndex<unsigned>(repId, numReplicates, outOrd);
@@ -670,7 +809,7 @@ private:
         } else
           processReplica(loc, rewriter, /*stNotRd*/ true, srcTy,
                          inNumCTAsEachRep, multiDimRepId, inVec, paddedRepShape,
-                         origRepShape, outOrd, vals, smemBase);
+                         origRepShape, outOrd, vals, smemBase, swizzle);
       } else {
         llvm::report_fatal_error(
             "ConvertLayout with input layout not implemented");
@@ -691,6 +830,8 @@ private:
             loc, i32_ty, rewriter.getI32IntegerAttr(128));
         rewriter.create<triton::nvgpu::NamedBarrierWaitOp>(loc, bar,
                                                            kNumThreads);
+      } else if (subGroupLocal) {
+        LLVM::createGENXSubGroupBarrier(loc, rewriter, op);
       } else {
         barrier();
       }
@@ -706,7 +847,7 @@ private:
           processReplica(loc, rewriter, /*stNotRd*/ false, dstTy,
                          outNumCTAsEachRep, multiDimRepId, outVec,
                          paddedRepShape, origRepShape, outOrd, outVals,
-                         smemBase);
+                         smemBase, swizzle);
       } else {
         llvm::report_fatal_error(
             "ConvertLayout with output layout not implemented");
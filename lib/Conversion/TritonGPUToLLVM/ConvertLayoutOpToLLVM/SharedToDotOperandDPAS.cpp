@@ -12,11 +12,13 @@ namespace {
 template <unsigned opIdx> class DpasMatmulLoader {
 public:
   DpasMatmulLoader(DpasEncodingAttr dpasLayout, RankedTensorType tensorTy,
-                   unsigned warpsPerTile, ArrayRef<Value> smemStrides,
+                   unsigned opsPerChannel, unsigned warpsPerTile,
+                   ArrayRef<Value> smemStrides,
                    SmallVector<int64_t> instrShape,
                    ConversionPatternRewriter &rewriter,
                    TritonGPUToLLVMTypeConverter *typeConverter, Location loc)
-      : dpasLayout(dpasLayout), tensorTy(tensorTy), smemStrides(smemStrides),
+      : dpasLayout(dpasLayout), tensorTy(tensorTy),
+        opsPerChannel(opsPerChannel), smemStrides(smemStrides),
         rewriter(rewriter), loc(loc) {
     static_assert(opIdx == 0 || opIdx == 1);
 
@@ -26,8 +28,6 @@ public:
                            smemStrides[kDim ^ 1]);
     warpMatStride = mul(i32_val(instrShape[kDim ^ 1]), smemStrides[kDim ^ 1]);
 
-    unsigned opsPerChannel =
-        dpasLayout.getOpsPerChannel(tensorTy.getElementType());
     unsigned threadsPerWarp = getThreadsPerWarp();
 
     int rowsPerWarp =
@@ -58,6 +58,9 @@ private:
 
   DpasEncodingAttr dpasLayout;
   RankedTensorType tensorTy;
+  // Elements per DPAS channel in the layout of the dot operand; may be larger
+  // than the one of the (narrower) element type held in shared memory.
+  unsigned opsPerChannel;
 
   SmallVector<Value> smemStrides;
   Value repNonKDimStride;
@@ -80,8 +83,6 @@ DpasMatmulLoader<opIdx>::computeLdsMatOffs(Value warpId, Value laneId,
   unsigned systolicDepth = dpasLayout.getSystolicDepth();
   unsigned repeatCount = dpasLayout.getRepeatCount();
   unsigned executionSize = dpasLayout.getExecutionSize();
-  unsigned opsPerChannel =
-      dpasLayout.getOpsPerChannel(tensorTy.getElementType());
   unsigned threadsPerWarp = getThreadsPerWarp();
 
   Value laneRowIndex, laneColIndex;
@@ -184,16 +185,21 @@ Value composeValuesToDotOperandLayoutStruct(
     const ValueTable &vals, int n0, int n1,
     TritonGPUToLLVMTypeConverter *typeConverter, Location loc,
     ConversionPatternRewriter &rewriter) {
+  // Each DPAS operand is held in one vector per repetition, see
+  // TritonGPUToLLVMTypeConverter::getElementTypeForStruct.
   std::vector<Value> elems;
   for (int m = 0; m < n0; ++m) {
     for (int k = 0; k < n1; ++k) {
       Value matVal = vals.at({m, k});
       auto matType = matVal.getType().cast<LLVM::LLVMStructType>();
       Type valTy = matType.getBody()[0];
+      auto vecTy = vec_ty(valTy, matType.getBody().size());
+      Value vec = undef(vecTy);
       for (int i = 0; i < matType.getBody().size(); ++i) {
         auto val = extract_val(valTy, matVal, i);
-        elems.push_back(val);
+        vec = insert_element(vecTy, vec, val, i32_val(i));
       }
+      elems.push_back(vec);
     }
   }
   assert(!elems.empty() && "Expecting non-empty vector");
@@ -217,13 +223,13 @@ Type getSharedMemTy(Type argType) {
   else if (argType.getIntOrFloatBitWidth() == 8)
     return type::i8Ty(ctx);
   else
-    llvm::report_fatal_error("mma16816 data type not supported");
+    llvm::report_fatal_error("DPAS operand data type not supported");
 }
 
 template <unsigned opIdx>
 std::function<void(int, int)>
 getLoadMatrixFn(Value tensor, const SharedMemoryObject &smemObj,
-                DpasEncodingAttr dpasLayout, unsigned warpsPerTile,
+                DotOperandEncodingAttr encoding, unsigned warpsPerTile,
                 SmallVector<int64_t> instrShape, Value warpId,
                 Value outerWarpDim, Value laneId, ValueTable &vals,
                 TritonGPUToLLVMTypeConverter *typeConverter,
@@ -232,18 +238,29 @@ getLoadMatrixFn(Value tensor, const SharedMemoryObject &smemObj,
 
   auto tensorTy = tensor.getType().cast<RankedTensorType>();
   Type eltTy = tensorTy.getElementType();
+  auto dpasLayout = encoding.getParent().cast<DpasEncodingAttr>();
+  // Narrow elements (e.g. int8/fp8 weights of an f16 dot) are loaded in the
+  // layout of the type the dot is computed in and converted in registers.
+  unsigned opsPerChannel =
+      dpasLayout.getOpsPerChannel(encoding.getDPASBitWidth(eltTy));
 
   auto sharedLayout = tensorTy.getEncoding().cast<SharedEncodingAttr>();
   ArrayRef<unsigned> order = sharedLayout.getOrder();
 
   // (a, b) is the coordinate.
   auto load = [=, &rewriter, &vals](int a, int b) {
-    DpasMatmulLoader<opIdx> loader(dpasLayout, tensorTy, warpsPerTile,
-                                   smemObj.strides, instrShape, rewriter,
-                                   typeConverter, loc);
+    DpasMatmulLoader<opIdx> loader(dpasLayout, tensorTy, opsPerChannel,
+                                   warpsPerTile, smemObj.strides, instrShape,
+                                   rewriter, typeConverter, loc);
 
     // Offset of a slice within the original tensor in shared memory.
     Value cSwizzleOffset = smemObj.getCSwizzleOffset(order[0]);
+    // When K is the swizzled (inner) dimension of A, the K repetitions move
+    // along the swizzled columns and are folded into the swizzle instead of
+    // being added as a linear offset.
+    bool swizzleKRep = opIdx == 0 && order[0] == 1;
+    if (swizzleKRep)
+      cSwizzleOffset = add(cSwizzleOffset, i32_val(b * instrShape[1]));
     SmallVector<Value> offs =
         loader.computeOffsets(outerWarpDim, laneId, cSwizzleOffset);
 
@@ -262,9 +279,11 @@ getLoadMatrixFn(Value tensor, const SharedMemoryObject &smemObj,
     unsigned threadsPerWarp = product<unsigned>(getThreadsPerWarp(dpasLayout));
     auto matTy = LLVM::LLVMStructType::getLiteral(
         eltTy.getContext(),
-        SmallVector<Type>(totalElem / threadsPerWarp, eltTy));
+        SmallVector<Type>(totalElem / threadsPerWarp,
+                          typeConverter->convertType(eltTy)));
 
-    vals[{a, b}] = loader.loadMatrix(a, b, ptrs, matTy, smemTy, cSwizzleOffset);
+    vals[{a, b}] = loader.loadMatrix(a, swizzleKRep ? 0 : b, ptrs, matTy,
+                                     smemTy, cSwizzleOffset);
   };
 
   return load;
@@ -287,7 +306,7 @@ Value loadOperand(ConversionPatternRewriter &rewriter, Location loc,
 
   Type elemTy = tensorTy.getElementType();
   SmallVector<int64_t> elemsPerInstr =
-      encoding.getDPASElemsPerInstr(elemTy.getIntOrFloatBitWidth());
+      encoding.getDPASElemsPerInstr(encoding.getDPASBitWidth(elemTy));
   SmallVector<int64_t> numReps = encoding.getDPASRep(tensorShape, elemTy);
 
   Value warpSize = i32_val(triton::gpu::getWarpSize(dpasLayout));
@@ -305,7 +324,7 @@ Value loadOperand(ConversionPatternRewriter &rewriter, Location loc,
   // Get the function to use to load the operand.
   ValueTable vals;
   std::function<void(int, int)> loadFn = getLoadMatrixFn<opIdx>(
-      tensor, smemObj, dpasLayout, warpsPerTile, elemsPerInstr, warpId,
+      tensor, smemObj, encoding, warpsPerTile, elemsPerInstr, warpId,
       outerWarpDim, laneId, vals, typeConverter, rewriter, loc);
 
   // Load the operand.
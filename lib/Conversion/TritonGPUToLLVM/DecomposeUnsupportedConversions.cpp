@@ -117,22 +117,27 @@ struct DecomposeUnsupportedConversions
     });
     /* -------------------------------- */
     // Replace `blocked -> dot_op` with `blocked -> shared -> dot_op`
-    // because the codegen doesn't handle `blocked -> dot_op` directly
+    // because the codegen doesn't handle `blocked -> dot_op` directly.
+    // Same for `dpas -> dot_op`, unless it is done with sub-group shuffles.
     /* -------------------------------- */
     mod.walk([&](triton::gpu::ConvertLayoutOp cvtOp) -> void {
       OpBuilder builder(cvtOp);
       auto srcType = cvtOp.getOperand().getType().cast<RankedTensorType>();
       auto dstType = cvtOp.getType().cast<RankedTensorType>();
-      auto srcBlocked =
-          srcType.getEncoding().dyn_cast<triton::gpu::BlockedEncodingAttr>();
+      Attribute srcLayout = srcType.getEncoding();
+      bool isSrcSupported =
+          srcLayout.isa<triton::gpu::BlockedEncodingAttr>() ||
+          (srcLayout.isa<triton::gpu::DpasEncodingAttr>() &&
+           !getSubGroupShuffleCvt(srcType, dstType));
       auto dstDotOp =
           dstType.getEncoding().dyn_cast<triton::gpu::DotOperandEncodingAttr>();
-      if (srcBlocked && dstDotOp) {
+      if (isSrcSupported && dstDotOp) {
         auto tmpType = RankedTensorType::get(
             dstType.getShape(), dstType.getElementType(),
             triton::gpu::SharedEncodingAttr::get(
                 mod.getContext(), dstDotOp, srcType.getShape(),
-                srcBlocked.getOrder(), srcBlocked.getCTALayout(),
+                triton::gpu::getOrder(srcLayout),
+                triton::gpu::getCTALayout(srcLayout),
                 srcType.getElementType()));
         auto tmp = builder.create<triton::gpu::ConvertLayoutOp>(
             cvtOp.getLoc(), tmpType, cvtOp.getOperand());
@@ -71,21 +71,68 @@ public:
     unsigned cNumElems = RC;
     auto CTy = vec_ty(resElemTy, cNumElems);
 
+    auto getAccIdx = [&](unsigned m, unsigned n, unsigned v) {
+      return m * repN * cNumElems + n * cNumElems + v;
+    };
+
+    SmallVector<Value> acc(repM * repN);
     for (unsigned m = 0; m < repM; ++m) {
       for (unsigned n = 0; n < repN; ++n) {
         Value C = undef(CTy);
         for (unsigned v = 0; v < cNumElems; ++v)
-          C = insert_element(
-              CTy, C, fc[m * repN * cNumElems + n * cNumElems + v], i32_val(v));
+          C = insert_element(CTy, C, fc[getAccIdx(m, n, v)], i32_val(v));
+        acc[m * repN + n] = C;
+      }
+    }
 
-        for (size_t k = 0; k < repK; k++) {
+    // An f16 dot into f32 with a non-zero maxNumImpreciseAcc accumulates
+    // every maxNumImpreciseAcc elements of K in f16, which is then added to
+    // the f32 accumulator.
+    unsigned kPerInstr =
+        AEncoding.getDPASElemsPerInstr(
+            AEncoding.getDPASBitWidth(ATensorTy.getElementType()))[1];
+    uint32_t maxNumImpreciseAcc = op.getMaxNumImpreciseAcc();
+    bool needsPartialAccumulator = APrecision == GENX::PrecisionType::FP16 &&
+                                   resElemTy.isF32() && maxNumImpreciseAcc > 0;
+    Value partialZero;
+    if (needsPartialAccumulator) {
+      auto partialTy = vec_ty(f16_ty, cNumElems);
+      partialZero = rewriter.create<LLVM::ConstantOp>(
+          loc, partialTy, rewriter.getZeroAttr(partialTy));
+    }
+    SmallVector<Value> partialAcc(repM * repN, partialZero);
+    uint32_t numLowPrecisionAcc = 0;
+
+    // Iterate K in the outer loop so that the repM * repN accumulator chains
+    // are independent within one K step: consecutive DPAS instructions do not
+    // depend on each other and the systolic pipeline latency is hidden.
+    for (size_t k = 0; k < repK; k++) {
+      numLowPrecisionAcc += kPerInstr;
+      bool requireAddAccumulator =
+          needsPartialAccumulator &&
+          (numLowPrecisionAcc >= maxNumImpreciseAcc || k == repK - 1);
+      for (unsigned m = 0; m < repM; ++m) {
+        for (unsigned n = 0; n < repN; ++n) {
           Value A = ha[{m, k}], B = hb[{n, k}];
-          C = generateDPASOp(C, A, B, RC, APrecision, BPrecision);
+          Value &mmaAcc = needsPartialAccumulator ? partialAcc[m * repN + n]
+                                                  : acc[m * repN + n];
+          mmaAcc = generateDPASOp(mmaAcc, A, B, RC, APrecision, BPrecision);
+          if (requireAddAccumulator) {
+            acc[m * repN + n] =
+                fadd(acc[m * repN + n], fpext(CTy, partialAcc[m * repN + n]));
+            partialAcc[m * repN + n] = partialZero;
+          }
         }
+      }
+      if (requireAddAccumulator)
+        numLowPrecisionAcc = 0;
+    }
 
+    for (unsigned m = 0; m < repM; ++m) {
+      for (unsigned n = 0; n < repN; ++n) {
         for (unsigned v = 0; v < cNumElems; ++v)
-          fc[m * repN * cNumElems + n * cNumElems + v] =
-              extract_element(resElemTy, C, i32_val(v));
+          fc[getAccIdx(m, n, v)] =
+              extract_element(resElemTy, acc[m * repN + n], i32_val(v));
       }
     }
 
@@ -123,7 +170,7 @@ private:
 
   /// Generate the GENX dialect dpas operation. Rules (for PVC):
   ///  - SD = 8
-  ///  - M = RC = 1,2,4,8 (we use 8)
+  ///  - M = RC = 1,2,4,8 (given by the dpas layout)
   ///  - N = exec_size = SIMD_width = 16
   ///  - Size of A, B element type = {32,16,8}, for {tf32,bf16/f16,u8/i8}
   ///  - K=SD * num_packed_elems_in_Dword = {8,16,32}, for {tf32,bf16/f16,u8/i8}
@@ -142,7 +189,8 @@ private:
   Value generateDPASOp(Value C, Value A, Value B, unsigned RepeatCount,
                        GENX::PrecisionType APrecision,
                        GENX::PrecisionType BPrecision) const {
-    assert(RepeatCount == 8 && "RepeatCount should be 8");
+    assert(llvm::isPowerOf2_32(RepeatCount) && RepeatCount <= 8 &&
+           "RepeatCount should be 1, 2, 4 or 8");
     assert(APrecision == BPrecision &&
            "A and B precision enumerators do not match");
 
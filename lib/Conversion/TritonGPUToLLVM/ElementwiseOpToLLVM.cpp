@@ -1113,6 +1113,16 @@ inline SmallVector<Value> unpackI32(const SmallVector<Value> &inValues,
   if (!tensorTy)
     return inValues;
   auto encoding = tensorTy.getEncoding().dyn_cast<DotOperandEncodingAttr>();
+  if (encoding && encoding.getParent().isa<DpasEncodingAttr>()) {
+    // DPAS operands are held in one vector per repetition.
+    SmallVector<Value> outValues;
+    for (auto v : inValues) {
+      auto vecTy = v.getType().cast<VectorType>();
+      for (int i = 0; i < vecTy.getNumElements(); i++)
+        outValues.push_back(extract_element(v, i32_val(i)));
+    }
+    return outValues;
+  }
   if (!(encoding && encoding.getParent().isa<NvidiaMmaEncodingAttr>()))
     return inValues;
   SmallVector<Value> outValues;
@@ -1136,6 +1146,21 @@ inline SmallVector<Value> packI32(const SmallVector<Value> &inValues,
   if (!tensorTy)
     return inValues;
   auto encoding = tensorTy.getEncoding().dyn_cast<DotOperandEncodingAttr>();
+  if (encoding && encoding.getParent().isa<DpasEncodingAttr>()) {
+    // Regroup the elements in one vector per DPAS repetition.
+    SmallVector<Value> outValues;
+    auto eltType = typeConverter->convertType(tensorTy.getElementType());
+    unsigned numVecs = triton::gpu::getTotalElemsPerThread(tensorTy);
+    unsigned vecWidth = inValues.size() / numVecs;
+    auto vecType = vec_ty(eltType, vecWidth);
+    for (unsigned i = 0; i < inValues.size(); i += vecWidth) {
+      Value vec = undef(vecType);
+      for (unsigned j = 0; j < vecWidth; j++)
+        vec = insert_element(vec, inValues[i + j], i32_val(j));
+      outValues.push_back(vec);
+    }
+    return outValues;
+  }
   if (!(encoding && encoding.getParent().isa<NvidiaMmaEncodingAttr>()))
     return inValues;
   SmallVector<Value> outValues;
@@ -1437,7 +1462,8 @@ struct ElementwiseOpConversion
   }
 };
 
-// Attempts to use vectorized conversions via inline PTX when possible.
+// Attempts to use vectorized conversions via inline PTX (NVVM) or packed
+// vector conversions (GENX) when possible.
 struct FpToFpOpConversion
     : public ElementwiseOpConversionBase<triton::FpToFpOp, FpToFpOpConversion> {
   using ElementwiseOpConversionBase<
@@ -1586,6 +1612,31 @@ struct FpToFpOpConversion
     }
   }
 
+  // Converts a group of f16 <-> f32 values with one vector fpext/fptrunc
+  // (round-to-nearest-even) so that IGC emits packed SIMD conversions instead
+  // of one GENX conversion per element.
+  static SmallVector<Value> convertPackedGENX(Location loc,
+                                              ConversionPatternRewriter &rewriter,
+                                              ArrayRef<Value> vals,
+                                              Type dstTy) {
+    Type srcTy = vals.front().getType();
+    unsigned numElements = vals.size();
+    auto srcVecTy = vec_ty(srcTy, numElements);
+    auto dstVecTy = vec_ty(dstTy, numElements);
+    Value packed = undef(srcVecTy);
+    for (auto [i, v] : llvm::enumerate(vals))
+      packed = insert_element(srcVecTy, packed, v, i32_val(i));
+    Value cvt;
+    if (srcTy.getIntOrFloatBitWidth() < dstTy.getIntOrFloatBitWidth())
+      cvt = fpext(dstVecTy, packed);
+    else
+      cvt = rewriter.create<LLVM::FPTruncOp>(loc, dstVecTy, packed);
+    SmallVector<Value> ret;
+    for (unsigned i = 0; i < numElements; ++i)
+      ret.push_back(extract_element(dstTy, cvt, i32_val(i)));
+    return ret;
+  }
+
   std::pair<ConverterT, size_t>
   getConversionFunc(Type srcTy, Type dstTy,
                     std::optional<RoundingMode> roundingMode,
@@ -1723,6 +1774,13 @@ struct FpToFpOpConversion
     if (srcElementType.isF32() && dstElementType.isF16()) {
       assert(roundingMode.has_value() &&
              "rounding mode must be specified for fp32->fp16 conversion");
+      if (target == mlir::triton::Target::GENX &&
+          roundingMode.value() == RoundingMode::RTNE) {
+        SmallVector<Value> inVals;
+        for (unsigned i = 0; i < std::min<size_t>(4, operands.size()); i++)
+          inVals.push_back(operands[i][0]);
+        return convertPackedGENX(loc, rewriter, inVals, f16_ty);
+      }
       SmallVector<Value> outVals;
       for (Value v : operands[0]) {
         outVals.push_back(
@@ -1763,7 +1821,9 @@ struct FpToFpOpConversion
     SmallVector<Value> outVals = cvtFunc(loc, rewriter, inVals);
     assert(outVals.size() == inVals.size());
     outVals.resize(std::min(numElements, operands.size()));
-    if (isDstFP32)
+    if (isDstFP32 && target == mlir::triton::Target::GENX)
+      outVals = convertPackedGENX(loc, rewriter, outVals, f32_ty);
+    else if (isDstFP32)
       for (Value &v : outVals)
         v = convertFp16ToFp32(loc, rewriter, v, target);
     // Pack values
@@ -1789,6 +1849,53 @@ Value EmitDualBF16ElementwiseOp(Location loc,
                                                undefRounding, target);
 }
 
+// Applies OP to the two next f16 elements at once as <2 x half> vectors, which
+// both backends select packed instructions for. Returns an empty vector when
+// fewer than two elements are left.
+template <typename OP>
+SmallVector<Value>
+EmitPackedFp16ElementwiseOp(Location loc, ConversionPatternRewriter &rewriter,
+                            MultipleOperandsRange operands) {
+  if (operands.size() < 2)
+    return {};
+  auto vecTy = vec_ty(f16_ty, 2);
+  Value lhs = undef(vecTy);
+  Value rhs = undef(vecTy);
+  for (int i = 0; i < 2; ++i) {
+    lhs = insert_element(vecTy, lhs, operands[i][0], i32_val(i));
+    rhs = insert_element(vecTy, rhs, operands[i][1], i32_val(i));
+  }
+  Value result = rewriter.create<OP>(loc, vecTy, lhs, rhs);
+  return {extract_element(f16_ty, result, i32_val(0)),
+          extract_element(f16_ty, result, i32_val(1))};
+}
+
+// Applies the bf16x2 fma `ptxAsm` to the two next bf16 elements packed in a
+// b32 register. Returns an empty vector when fewer than two elements are left.
+SmallVector<Value> EmitPackedBF16FmaPTX(Location loc,
+                                        ConversionPatternRewriter &rewriter,
+                                        MultipleOperandsRange operands,
+                                        StringRef ptxAsm) {
+  if (operands.size() < 2)
+    return {};
+  auto vecTy = vec_ty(i16_ty, 2);
+  Value lhs = undef(vecTy);
+  Value rhs = undef(vecTy);
+  for (int i = 0; i < 2; ++i) {
+    lhs = insert_element(vecTy, lhs, operands[i][0], i32_val(i));
+    rhs = insert_element(vecTy, rhs, operands[i][1], i32_val(i));
+  }
+  PTXBuilder builder;
+  auto &fma = *builder.create<PTXInstr>(ptxAsm.str());
+  auto res = builder.newOperand("=r");
+  auto lhsOpr = builder.newOperand(bitcast(lhs, i32_ty), "r");
+  auto rhsOpr = builder.newOperand(bitcast(rhs, i32_ty), "r");
+  fma({res, lhsOpr, rhsOpr}, /*onlyAttachMLIRArgs=*/true);
+  Value result = bitcast(builder.launch(rewriter, loc, i32_ty, false), vecTy);
+  return {extract_element(i16_ty, result, i32_val(0)),
+          extract_element(i16_ty, result, i32_val(1))};
+}
+
 struct CmpIOpConversion
     : public ElementwiseOpConversionBase<arith::CmpIOp, CmpIOpConversion> {
   using Base = ElementwiseOpConversionBase<arith::CmpIOp, CmpIOpConversion>;
@@ -1969,6 +2076,82 @@ struct ElementwiseInlineAsmOpConversion
     return packedOperands;
   }
 
+  // On GENX, the asm string is either inline vISA or, when it starts with
+  // '@', the (mangled) name of a SPIR-V builtin or device function to call.
+  // vISA registers are typed, so rather than being packed into 32-bit
+  // registers the op.getPackedElement() elements of an operand or result go
+  // in a vector of that many elements.
+  SmallVector<SmallVector<Value>>
+  createGENXDestOps(ElementwiseInlineAsmOp op,
+                    ConversionPatternRewriter &rewriter,
+                    MultipleOperandsRange operands, Location loc) const {
+    auto ctx = op->getContext();
+    unsigned numPackedElements = op.getPackedElement();
+    auto getPackedType = [&](Type elemTy) -> Type {
+      Type ty = getTypeConverter()->convertType(elemTy);
+      return numPackedElements > 1 ? vec_ty(ty, numPackedElements) : ty;
+    };
+
+    SmallVector<Value> packedOperands;
+    for (int i = 0, e = op.getNumOperands(); i < e; i++) {
+      if (numPackedElements == 1) {
+        packedOperands.push_back(operands[0][i]);
+        continue;
+      }
+      Value packed = undef(getPackedType(getElementType(op.getOperand(i))));
+      for (unsigned j = 0; j < numPackedElements; j++)
+        packed = insert_element(packed, operands[j][i], i32_val(j));
+      packedOperands.push_back(packed);
+    }
+
+    SmallVector<Type> retTypes;
+    for (auto result : op.getResult())
+      retTypes.push_back(getPackedType(getElementType(result)));
+    Type retType = retTypes.size() > 1 ? struct_ty(retTypes) : retTypes[0];
+
+    Value results;
+    StringRef asmString = op.getAsmString();
+    if (asmString.consume_front("@")) {
+      if (retTypes.size() > 1)
+        llvm::report_fatal_error(
+            "Inline asm calling a function must have a single result.");
+      SmallVector<Type> argTypes;
+      for (Value operand : packedOperands)
+        argTypes.push_back(operand.getType());
+      auto funcOp = LLVM::getOrInsertSPIRFunction(
+          rewriter, op, asmString.trim(), retType, argTypes);
+      auto callOp = call(funcOp, ValueRange(packedOperands));
+      callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+      results = callOp.getResult();
+    } else {
+      results = rewriter
+                    .create<LLVM::InlineAsmOp>(
+                        loc, retType,
+                        /*operands=*/packedOperands,
+                        /*asm_string=*/asmString,
+                        /*constraints=*/op.getConstraints(),
+                        /*has_side_effects=*/!op.getPure(),
+                        /*is_align_stack=*/false,
+                        /*asm_dialect=*/
+                        LLVM::AsmDialectAttr::get(rewriter.getContext(),
+                                                  LLVM::AsmDialect::AD_ATT),
+                        /*operand_attrs=*/ArrayAttr())
+                    ->getResult(0);
+    }
+
+    SmallVector<SmallVector<Value>> ret(op->getNumResults());
+    for (int i = 0; i < op->getNumResults(); i++) {
+      Value val = retTypes.size() > 1 ? extract_val(results, i) : results;
+      if (numPackedElements == 1) {
+        ret[i].push_back(val);
+        continue;
+      }
+      for (unsigned j = 0; j < numPackedElements; j++)
+        ret[i].push_back(extract_element(val, i32_val(j)));
+    }
+    return ret;
+  }
+
   SmallVector<SmallVector<Value>>
   createDestOps(ElementwiseInlineAsmOp op, OpAdaptor adaptor,
                 ConversionPatternRewriter &rewriter,
@@ -1979,6 +2162,9 @@ struct ElementwiseInlineAsmOpConversion
       llvm::report_fatal_error("Inline asm op has more packed elements than "
                                "number of elements per thread.");
 
+    if (target == Target::GENX)
+      return createGENXDestOps(op, rewriter, operands, loc);
+
     // Pack elems smaller than 32 bits into 32-bit registers.
     SmallVector<Value> packedOperands =
         packOperands(op, operands, rewriter, loc);
@@ -2191,6 +2377,12 @@ struct FMulOpConversion
     if (lhsAndRhsAreBF16) {
       switch (target) {
       case mlir::triton::Target::NVVM: {
+        auto packedAsm = " { .reg .b32 c;            \n"
+                         "    mov.b32 c, 0x80008000U; \n"
+                         "    fma.rn.bf16x2 $0, $1, $2, c; } \n";
+        auto packed = EmitPackedBF16FmaPTX(loc, rewriter, operands, packedAsm);
+        if (!packed.empty())
+          return packed;
         PTXBuilder builder;
         auto ptxAsm = " { .reg .b16 c;        \n"
                       "    mov.b16 c, 0x8000U; \n" // 0.0
@@ -2207,6 +2399,12 @@ struct FMulOpConversion
                                                         target)};
       }
     }
+    if (elemTy.isF16()) {
+      auto packed =
+          EmitPackedFp16ElementwiseOp<LLVM::FMulOp>(loc, rewriter, operands);
+      if (!packed.empty())
+        return packed;
+    }
 
     return {rewriter.create<LLVM::FMulOp>(loc, elemTy, operands[0][0],
                                           operands[0][1])};
@@ -2231,6 +2429,12 @@ struct FAddOpConversion
     if (lhsAndRhsAreBF16) {
       switch (target) {
       case mlir::triton::Target::NVVM: {
+        auto packedAsm = "{ .reg .b32 c;             \n"
+                         "   mov.b32 c, 0x3f803f80U; \n"
+                         "   fma.rn.bf16x2 $0, $1, c, $2; } \n";
+        auto packed = EmitPackedBF16FmaPTX(loc, rewriter, operands, packedAsm);
+        if (!packed.empty())
+          return packed;
         PTXBuilder builder;
         auto ptxAsm = "{ .reg .b16 c;         \n"
                       "   mov.b16 c, 0x3f80U; \n" // 1.0
@@ -2247,6 +2451,12 @@ struct FAddOpConversion
                                                         target)};
       }
     }
+    if (elemTy.isF16()) {
+      auto packed =
+          EmitPackedFp16ElementwiseOp<LLVM::FAddOp>(loc, rewriter, operands);
+      if (!packed.empty())
+        return packed;
+    }
 
     return {rewriter.create<LLVM::FAddOp>(loc, elemTy, operands[0][0],
                                           operands[0][1])};
@@ -2271,6 +2481,12 @@ struct FSubOpConversion
     if (lhsAndRhsAreBF16) {
       switch (target) {
       case mlir::triton::Target::NVVM: {
+        auto packedAsm = " { .reg .b32 c;             \n"
+                         "    mov.b32 c, 0xbf80bf80U; \n"
+                         "    fma.rn.bf16x2 $0, $2, c, $1;} \n";
+        auto packed = EmitPackedBF16FmaPTX(loc, rewriter, operands, packedAsm);
+        if (!packed.empty())
+          return packed;
         PTXBuilder builder;
         auto ptxAsm = " { .reg .b16 c;         \n"
                       "    mov.b16 c, 0xbf80U; \n" // -1.0
@@ -2287,6 +2503,12 @@ struct FSubOpConversion
                                                         target)};
       }
     }
+    if (elemTy.isF16()) {
+      auto packed =
+          EmitPackedFp16ElementwiseOp<LLVM::FSubOp>(loc, rewriter, operands);
+      if (!packed.empty())
+        return packed;
+    }
     return {rewriter.create<LLVM::FSubOp>(loc, elemTy, operands[0][0],
                                           operands[0][1])};
   }
@@ -2440,6 +2662,46 @@ struct ExpOpConversionApprox
   }
 };
 
+// Lowers an f32 transcendental to the SPIR-V OpenCL native_* built-in, which
+// IGC maps to the approximate hardware math unit. Only used in fast-math mode;
+// other element types fall back to the precise lowering.
+template <typename SourceOp>
+struct GENXNativeMathOpConversion
+    : ElementwiseOpConversionBase<SourceOp,
+                                  GENXNativeMathOpConversion<SourceOp>> {
+  using Base =
+      ElementwiseOpConversionBase<SourceOp,
+                                  GENXNativeMathOpConversion<SourceOp>>;
+  using Base::Base;
+  using Adaptor = typename Base::OpAdaptor;
+
+  explicit GENXNativeMathOpConversion(
+      TritonGPUToLLVMTypeConverter &typeConverter,
+      ModuleAxisInfoAnalysis &axisAnalysisPass, StringRef builtin,
+      Target target, PatternBenefit benefit = 1)
+      : Base::ElementwiseOpConversionBase(typeConverter, axisAnalysisPass,
+                                          target, benefit),
+        builtin(builtin) {}
+
+  SmallVector<Value> createDestOps(SourceOp op, Adaptor adaptor,
+                                   ConversionPatternRewriter &rewriter,
+                                   Type elemTy, MultipleOperandsRange operands,
+                                   Location loc) const {
+    if (!elemTy.isF32())
+      return {};
+    std::string mangledName =
+        "_Z" + std::to_string(builtin.size()) + builtin.str() + "f";
+    auto funcOp = LLVM::getOrInsertSPIRFunction(rewriter, op, mangledName,
+                                                f32_ty, {f32_ty});
+    auto callOp = call(funcOp, ValueRange{operands[0][0]});
+    callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+    return {callOp.getResult()};
+  }
+
+private:
+  StringRef builtin;
+};
+
 struct AbsIOpConversion
     : ElementwiseOpConversionBase<mlir::math::AbsIOp, AbsIOpConversion> {
   using Base =
@@ -2515,6 +2777,19 @@ struct MinMaxFOpConversion
                                    ConversionPatternRewriter &rewriter,
                                    Type elemTy, MultipleOperandsRange operands,
                                    Location loc) const {
+    if (Base::target == mlir::triton::Target::GENX) {
+      // SPIR-V fmin/fmax (and therefore llvm.minnum/maxnum) return the non-NaN
+      // operand. A single unordered compare flags a NaN in either operand, so
+      // the NaN-propagating form costs one cmp + sel on top of the native
+      // min/max instead of the generic two compares and an or.
+      auto lhs = operands[0][0];
+      auto rhs = operands[0][1];
+      auto isNan = rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::uno,
+                                                 lhs, rhs);
+      auto nonNanRes = rewriter.create<DestOpNoNanProp>(loc, elemTy, lhs, rhs);
+      auto nan = LLVM::createNaNConstant(loc, rewriter, elemTy);
+      return {rewriter.create<LLVM::SelectOp>(loc, isNan, nan, nonNanRes)};
+    }
     if (computeCapability >= 80) {
       return {rewriter.create<DestOpNanProp>(loc, elemTy, operands[0][0],
                                              operands[0][1])};
@@ -2819,18 +3094,32 @@ void mlir::triton::populateElementwiseOpToLLVMPatterns(
                                       benefit);
   patterns.add<ClampFOpConversion>(typeConverter, axisInfoAnalysis,
                                    computeCapability, target, benefit);
-  PatternBenefit benefitForPropNan = benefit;
-  if (target == mlir::triton::Target::GENX) {
-    // TODO(FIXME): spirv's OpenCL extension (fmin/fmax) does not support
-    // nan propagation. Set these conversion benefit to the max benefit:
-    // PatternBenefit::ImpossibleToMatchSentinel - 1 to make sure the
-    // correctness
-    benefitForPropNan = 65534;
-  }
   patterns.add<MinMaxFOpConversion<arith::MinimumFOp>>(
-      typeConverter, axisInfoAnalysis, computeCapability, target,
-      benefitForPropNan);
+      typeConverter, axisInfoAnalysis, computeCapability, target, benefit);
   patterns.add<MinMaxFOpConversion<arith::MaximumFOp>>(
-      typeConverter, axisInfoAnalysis, computeCapability, target,
-      benefitForPropNan);
+      typeConverter, axisInfoAnalysis, computeCapability, target, benefit);
+}
+
+void mlir::triton::populateGENXFastMathOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit) {
+  patterns.add<GENXNativeMathOpConversion<math::ExpOp>>(
+      typeConverter, axisInfoAnalysis, "__spirv_ocl_native_exp", target,
+      benefit);
+  patterns.add<GENXNativeMathOpConversion<math::Exp2Op>>(
+      typeConverter, axisInfoAnalysis, "__spirv_ocl_native_exp2", target,
+      benefit);
+  patterns.add<GENXNativeMathOpConversion<math::Log2Op>>(
+      typeConverter, axisInfoAnalysis, "__spirv_ocl_native_log2", target,
+      benefit);
+  patterns.add<GENXNativeMathOpConversion<math::RsqrtOp>>(
+      typeConverter, axisInfoAnalysis, "__spirv_ocl_native_rsqrt", target,
+      benefit);
+  patterns.add<GENXNativeMathOpConversion<math::SinOp>>(
+      typeConverter, axisInfoAnalysis, "__spirv_ocl_native_sin", target,
+      benefit);
+  patterns.add<GENXNativeMathOpConversion<math::CosOp>>(
+      typeConverter, axisInfoAnalysis, "__spirv_ocl_native_cos", target,
+      benefit);
 }
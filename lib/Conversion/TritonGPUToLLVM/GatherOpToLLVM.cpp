@@ -0,0 +1,191 @@
+#include "PatternTritonGPUOpToLLVM.h"
+#include "Utility.h"
+#include "triton/Analysis/Utility.h"
+
+#include <map>
+
+using namespace mlir;
+using namespace mlir::triton;
+
+using ::mlir::LLVM::shflIdxSync;
+using ::mlir::triton::gpu::BlockedEncodingAttr;
+using ::mlir::triton::gpu::getOrder;
+using ::mlir::triton::gpu::getShapePerCTA;
+
+namespace {
+struct GatherOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::GatherOp> {
+public:
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::GatherOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::GatherOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto indicesTy = op.getIndices().getType().cast<RankedTensorType>();
+    unsigned axis = op.getAxis();
+    // Gathering across CTAs would need distributed shared memory.
+    if (triton::gpu::getCTASplitNum(srcTy.getEncoding())[axis] != 1)
+      return failure();
+
+    SmallVector<Value> srcVals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    SmallVector<Value> indices = getTypeConverter()->unpackLLElements(
+        loc, adaptor.getIndices(), rewriter);
+    for (Value &index : indices) {
+      unsigned bits = index.getType().getIntOrFloatBitWidth();
+      if (bits > 32)
+        index = trunc(i32_ty, index);
+      else if (bits < 32)
+        index = sext(i32_ty, index);
+    }
+
+    SmallVector<Value> results;
+    if (isWarpLocalGather(srcTy, indicesTy, axis))
+      results = gatherInWarp(op, srcVals, indices, rewriter);
+    else
+      results = gatherFromSharedMemory(op, srcVals, indices, rewriter);
+    Value result = getTypeConverter()->packLLElements(loc, results, rewriter,
+                                                      op.getType());
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+private:
+  // Each warp holds whole rows of the source, so the element gathered for a
+  // register of the indices is in a register of another lane of the warp.
+  // Its lane is read from the index, and the register of the source to
+  // shuffle is selected among those of the same row.
+  SmallVector<Value> gatherInWarp(triton::GatherOp op,
+                                  ArrayRef<Value> srcVals,
+                                  ArrayRef<Value> indices,
+                                  ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto indicesTy = op.getIndices().getType().cast<RankedTensorType>();
+    auto layout = srcTy.getEncoding().cast<BlockedEncodingAttr>();
+    unsigned axis = op.getAxis();
+    unsigned sizePerThread = layout.getSizePerThread()[axis];
+    unsigned threadsPerWarp = layout.getThreadsPerWarp()[axis];
+    unsigned warpsPerCTA = layout.getWarpsPerCTA()[axis];
+
+    // Group the registers of the source by their offsets along the other
+    // axes, which the registers of the indices share.
+    auto srcOffsets = emitOffsetForLayout(layout, srcTy);
+    auto indicesOffsets = emitOffsetForLayout(layout, indicesTy);
+    std::map<SmallVector<unsigned>, SmallVector<unsigned>> rowRegs;
+    for (unsigned reg = 0; reg < srcOffsets.size(); ++reg) {
+      SmallVector<unsigned> key = srcOffsets[reg];
+      key[axis] = 0;
+      rowRegs[key].push_back(reg);
+    }
+
+    // The lanes along the axis are strided by the lanes of the dimensions
+    // that are faster in the layout order.
+    unsigned laneStride = 1;
+    for (unsigned d : getOrder(layout)) {
+      if (d == axis)
+        break;
+      laneStride *= layout.getThreadsPerWarp()[d];
+    }
+    Value laneId =
+        urem(getThreadId(rewriter, loc), getModuleWarpSize(rewriter, loc));
+    Value laneIdAxis =
+        urem(udiv(laneId, i32_val(laneStride)), i32_val(threadsPerWarp));
+    Value laneBase = sub(laneId, mul(laneIdAxis, i32_val(laneStride)));
+
+    SmallVector<Value> results;
+    for (unsigned reg = 0; reg < indices.size(); ++reg) {
+      Value index = indices[reg];
+      Value srcLaneAxis = urem(udiv(index, i32_val(sizePerThread)),
+                               i32_val(threadsPerWarp));
+      Value srcLane = add(laneBase, mul(srcLaneAxis, i32_val(laneStride)));
+      // The offset along the axis of the source register, in lane 0.
+      unsigned tile = sizePerThread * threadsPerWarp;
+      Value srcOffset =
+          add(mul(udiv(index, i32_val(tile)), i32_val(tile * warpsPerCTA)),
+              urem(index, i32_val(sizePerThread)));
+
+      SmallVector<unsigned> key = indicesOffsets[reg];
+      key[axis] = 0;
+      Value result;
+      for (unsigned srcReg : rowRegs.at(key)) {
+        Value val = srcVals[srcReg];
+        if (threadsPerWarp > 1)
+          val = shflIdxSync(loc, rewriter, val, srcLane, target);
+        if (!result) {
+          result = val;
+          continue;
+        }
+        Value isSrcReg = icmp_eq(srcOffset, i32_val(srcOffsets[srcReg][axis]));
+        result = select(isSrcReg, val, result);
+      }
+      results.push_back(result);
+    }
+    return results;
+  }
+
+  // Every thread stores its elements of the source to shared memory, where
+  // the tensor is row major, and loads the gathered ones.
+  SmallVector<Value>
+  gatherFromSharedMemory(triton::GatherOp op, ArrayRef<Value> srcVals,
+                         ArrayRef<Value> indices,
+                         ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto indicesTy = op.getIndices().getType().cast<RankedTensorType>();
+    unsigned axis = op.getAxis();
+    Type elemTy = getTypeConverter()->convertType(srcTy.getElementType());
+    auto shapePerCTA = getShapePerCTA(srcTy);
+    Value smemBase =
+        LLVM::getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
+
+    // Layouts larger than the tensor wrap around.
+    auto linearize = [&](ArrayRef<Value> multiDimIdx) {
+      Value offset = i32_val(0);
+      unsigned stride = 1;
+      for (int d = shapePerCTA.size() - 1; d >= 0; --d) {
+        Value idx = d == static_cast<int>(axis)
+                        ? multiDimIdx[d]
+                        : and_(multiDimIdx[d], i32_val(shapePerCTA[d] - 1));
+        offset = add(offset, mul(idx, i32_val(stride)));
+        stride *= shapePerCTA[d];
+      }
+      return offset;
+    };
+
+    auto srcIndices =
+        emitIndices(loc, rewriter, srcTy.getEncoding(), srcTy, false);
+    for (unsigned reg = 0; reg < srcVals.size(); ++reg) {
+      SmallVector<Value> multiDimIdx = srcIndices[reg];
+      multiDimIdx[axis] =
+          and_(multiDimIdx[axis], i32_val(shapePerCTA[axis] - 1));
+      Value ptr =
+          gep(smemBase.getType(), elemTy, smemBase, linearize(multiDimIdx));
+      store(srcVals[reg], ptr);
+    }
+    barrier();
+
+    auto dstIndices =
+        emitIndices(loc, rewriter, indicesTy.getEncoding(), indicesTy, false);
+    SmallVector<Value> results;
+    for (unsigned reg = 0; reg < indices.size(); ++reg) {
+      SmallVector<Value> multiDimIdx = dstIndices[reg];
+      multiDimIdx[axis] = indices[reg];
+      Value ptr =
+          gep(smemBase.getType(), elemTy, smemBase, linearize(multiDimIdx));
+      results.push_back(load(elemTy, ptr));
+    }
+    return results;
+  }
+};
+} // namespace
+
+void mlir::triton::populateGatherOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit) {
+  patterns.add<GatherOpConversion>(typeConverter, target, benefit);
+}
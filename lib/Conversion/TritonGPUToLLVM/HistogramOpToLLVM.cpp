@@ -1,6 +1,5 @@
 #include "PatternTritonGPUOpToLLVM.h"
 #include "Utility.h"
-#include "mlir/Dialect/LLVMIR/NVVMDialect.h"
 #include "triton/Analysis/Utility.h"
 
 using namespace mlir;
@@ -8,30 +7,6 @@ using namespace mlir::triton;
 
 static int log2Int(int64_t num) { return (num > 1) ? 1 + log2Int(num / 2) : 0; }
 
-static Value generateVoteBallot(Location loc, Value bit, int threadMask,
-                                Value threadId, int numThreadPerWarp,
-                                ConversionPatternRewriter &rewriter,
-                                Target target) {
-  if (target == Target::NVVM) {
-    return rewriter.create<NVVM::VoteBallotOp>(loc, i32_ty, i32_val(threadMask),
-                                               bit);
-  }
-
-  assert(target == Target::GENX && "unsupported target");
-  assert(threadMask == -1 && "unsupported thread mask for GENX target");
-
-  // Emulate vote.ballot.sync behavior using shift, shuffle, and or.
-  // TODO: check for more efficient solution.
-  int offs = 1;
-  Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
-  Value reduced_val = shl(select(bit, i32_val(1), i32_val(0)), laneId);
-  for (int offs = 1; offs < numThreadPerWarp; offs = offs << 1) {
-    Value other_val = LLVM::shflSync(loc, rewriter, reduced_val, offs, target);
-    reduced_val = or_(reduced_val, other_val);
-  }
-  return reduced_val;
-}
-
 // Compute a histogram within a warp. This uses an algorithm by @apgoucher
 // that does the following:
 // Create a ballot for each bit of the bin index (there
@@ -60,8 +35,8 @@ computeWarpLevelHistogram(Location loc, RankedTensorType srcType,
     SmallVector<Value> ballotBits;
     for (int j = 0; j < numBits; ++j) {
       Value bitSet = and_(value, i32_val(1 << j));
-      Value bit = generateVoteBallot(loc, icmp_ne(bitSet, zero), -1, threadId,
-                                     numThreadPerWarp, rewriter, target);
+      Value bit = getTargetInfo(target).ballot(
+          rewriter, loc, icmp_ne(bitSet, zero), -1, numThreadPerWarp);
       ballotBits.push_back(bit);
     }
     Value fullMask = i32_val(0xFFFFFFFF);
@@ -98,17 +73,12 @@ static void atomicAdd(Value ptr, Value val, Location loc,
                                      LLVM::AtomicOrdering::monotonic);
 }
 
-static SmallVector<Value> computeCrossWarpHistogram(
-    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
-    Value baseSharedMemPtr, const SmallVector<Value> &warpLevelHistogram,
-    int numBins, int numThreadPerWarp, const SmallVector<Value> &indices,
-    Value threadId, int numWarps) {
-  SmallVector<Value> histogramValues;
-  unsigned numWarpsWithUniqueData =
-      mlir::triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
-                                                      srcType.getShape())[0];
-  Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
-  // Initialize the shared memory with zeros.
+// Initialize the shared memory histogram with zeros.
+static void zeroSharedMemHistogram(Location loc,
+                                   ConversionPatternRewriter &rewriter,
+                                   Value baseSharedMemPtr, int numBins,
+                                   int numThreadPerWarp, Value threadId,
+                                   int numWarps) {
   int64_t numElementPerThread =
       ceil<int64_t>(numBins, numThreadPerWarp * numWarps);
   for (int i = 0; i < numElementPerThread; ++i) {
@@ -119,6 +89,35 @@ static SmallVector<Value> computeCrossWarpHistogram(
     store(i32_val(0), sharedMemPtr);
   }
   barrier();
+}
+
+// Load the shared memory histogram to registers with the right layout.
+static SmallVector<Value>
+loadSharedMemHistogram(Location loc, ConversionPatternRewriter &rewriter,
+                       Value baseSharedMemPtr,
+                       const SmallVector<Value> &indices) {
+  barrier();
+  SmallVector<Value> histogramValues;
+  for (Value index : indices) {
+    Value sharedMemPtr =
+        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, index);
+    Value val = load(i32_ty, sharedMemPtr);
+    histogramValues.push_back(val);
+  }
+  return histogramValues;
+}
+
+static SmallVector<Value> computeCrossWarpHistogram(
+    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
+    Value baseSharedMemPtr, const SmallVector<Value> &warpLevelHistogram,
+    int numBins, int numThreadPerWarp, const SmallVector<Value> &indices,
+    Value threadId, int numWarps) {
+  unsigned numWarpsWithUniqueData =
+      mlir::triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
+                                                      srcType.getShape())[0];
+  Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
+  zeroSharedMemHistogram(loc, rewriter, baseSharedMemPtr, numBins,
+                         numThreadPerWarp, threadId, numWarps);
   Block *afterAtomics = nullptr;
   // If some warps have replicated data we need to skip those warps when
   // accumulating.
@@ -146,15 +145,42 @@ static SmallVector<Value> computeCrossWarpHistogram(
     rewriter.create<LLVM::BrOp>(loc, afterAtomics);
     rewriter.setInsertionPointToStart(afterAtomics);
   }
-  barrier();
-  // load the histogram to register with the right layout.
-  for (Value index : indices) {
-    Value sharedMemPtr =
-        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, index);
-    Value val = load(i32_ty, sharedMemPtr);
-    histogramValues.push_back(val);
-  }
-  return histogramValues;
+  return loadSharedMemHistogram(loc, rewriter, baseSharedMemPtr, indices);
+}
+
+// Compute the histogram with one shared memory atomic per element. The ballot
+// based algorithm costs a popcount per element for each bin owned by a
+// thread, so this is cheaper for large bin counts.
+static SmallVector<Value> computeSharedMemHistogram(
+    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
+    Value baseSharedMemPtr, const SmallVector<Value> &srcValues, int numBins,
+    int numThreadPerWarp, const SmallVector<Value> &indices, Value threadId,
+    int numWarps) {
+  unsigned numThreadWithUniqueData =
+      triton::gpu::getThreadsPerWarpWithUniqueData(srcType.getEncoding(),
+                                                   srcType.getShape())[0];
+  unsigned numWarpsWithUniqueData =
+      triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
+                                                srcType.getShape())[0];
+  Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
+  zeroSharedMemHistogram(loc, rewriter, baseSharedMemPtr, numBins,
+                         numThreadPerWarp, threadId, numWarps);
+  // Skip the threads holding replicated data.
+  Value hasUniqueData =
+      and_(icmp_ult(laneId, i32_val(numThreadWithUniqueData)),
+           icmp_ult(threadId,
+                    i32_val(numWarpsWithUniqueData * numThreadPerWarp)));
+  LLVM::createPredicatedBlock(rewriter, loc, hasUniqueData, [&] {
+    // Like the ballots, only the low log2(numBins) bits select the bin.
+    for (Value value : srcValues) {
+      Value bin = and_(value, i32_val(numBins - 1));
+      Value sharedMemPtr =
+          gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, bin);
+      atomicAdd(sharedMemPtr, i32_val(1), loc, rewriter);
+    }
+    return ArrayRef<Value>();
+  });
+  return loadSharedMemHistogram(loc, rewriter, baseSharedMemPtr, indices);
 }
 
 namespace {
@@ -164,6 +190,10 @@ public:
   using ConvertTritonGPUOpToLLVMPattern<
       triton::HistogramOp>::ConvertTritonGPUOpToLLVMPattern;
 
+  // Bin count from which GENX accumulates each element with a shared memory
+  // atomic instead of ballots.
+  static constexpr int sharedMemAtomicsMinBins = 512;
+
   LogicalResult
   matchAndRewrite(triton::HistogramOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -173,25 +203,17 @@ public:
         getTypeConverter()->unpackLLElements(loc, input, rewriter);
     int numBins =
         op.getResult().getType().cast<RankedTensorType>().getDimSize(0);
-    int numThreadsPerWarp = 32;
+    auto mod = op->getParentOfType<ModuleOp>();
+    int numThreadsPerWarp =
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
     // Pad out the bins so that we have at least one bin per thread within a
     // warp.
     numBins = std::max(numBins, numThreadsPerWarp);
     Value threadId = getThreadId(rewriter, loc);
     auto srcType = op.getInput().getType().cast<RankedTensorType>();
-    // First compute a warp local histogram based on values owned by each warps.
-    SmallVector<Value> warpLevelHistogram = computeWarpLevelHistogram(
-        loc, srcType, srcValues, numBins, numThreadsPerWarp, threadId, rewriter,
-        target);
-
-    // Then use atomic to update the histogram in shared memory.
-    // TODO: we could skip this for cases with num_warps=1 as long as we can
-    // generate the right layout. Currently the warp level histogram generates
-    // data in the default blocked layout.
     Value baseSharedMemPtr =
         LLVM::getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
     auto dstType = op.getResult().getType().cast<RankedTensorType>();
-    auto mod = op->getParentOfType<ModuleOp>();
     int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
     Attribute dstEncoding = dstType.getEncoding();
     auto indices =
@@ -199,9 +221,27 @@ public:
     SmallVector<Value> innerDimIndices;
     for (int i = 0; i < indices.size(); ++i)
       innerDimIndices.push_back(indices[i][0]);
-    SmallVector<Value> histogramValue = computeCrossWarpHistogram(
-        loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram, numBins,
-        numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+
+    SmallVector<Value> histogramValue;
+    if (target == Target::GENX && numBins >= sharedMemAtomicsMinBins) {
+      histogramValue = computeSharedMemHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, srcValues, numBins,
+          numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    } else {
+      // First compute a warp local histogram based on values owned by each
+      // warps.
+      SmallVector<Value> warpLevelHistogram = computeWarpLevelHistogram(
+          loc, srcType, srcValues, numBins, numThreadsPerWarp, threadId,
+          rewriter, target);
+
+      // Then use atomic to update the histogram in shared memory.
+      // TODO: we could skip this for cases with num_warps=1 as long as we can
+      // generate the right layout. Currently the warp level histogram
+      // generates data in the default blocked layout.
+      histogramValue = computeCrossWarpHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram,
+          numBins, numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    }
 
     Value results = getTypeConverter()->packLLElements(
         loc, histogramValue, rewriter, op.getResult().getType());
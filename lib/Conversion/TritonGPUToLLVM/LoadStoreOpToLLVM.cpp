@@ -13,12 +13,17 @@
 #include "triton/Dialect/TritonNvidiaGPU/Transforms/Utility.h"
 #include "triton/Target/PTX/TmaMetadata.h"
 
+#include <map>
 #include <numeric>
+#include <optional>
+#include <string>
 
 using namespace mlir;
 using namespace mlir::triton;
 
 using ::mlir::LLVM::delinearize;
+using ::mlir::LLVM::getOrInsertFunction;
+using ::mlir::LLVM::getOrInsertSPIRFunction;
 using ::mlir::LLVM::getSharedMemoryObjectFromStruct;
 using ::mlir::LLVM::linearize;
 using ::mlir::triton::gpu::getCTALayout;
@@ -42,6 +47,195 @@ static CUtensorMapDataType getCUtensorMapDataType(Type ty) {
 }
 
 namespace {
+// L1 and L3 policies of an SPV_INTEL_cache_controls decoration.
+struct CacheControls {
+  enum Decoration : unsigned {
+    CacheControlLoadINTEL = 6442,
+    CacheControlStoreINTEL = 6443
+  };
+  enum Load : unsigned { Uncached = 0, Cached = 1, Streaming = 2 };
+  enum Store : unsigned {
+    StoreUncached = 0,
+    WriteThrough = 1,
+    WriteBack = 2,
+    StoreStreaming = 3
+  };
+
+  Decoration decoration;
+  unsigned l1, l3;
+};
+
+// Maps the cache modifier and eviction policy of a load to cache controls, or
+// std::nullopt to leave the default policy.
+std::optional<CacheControls> getCacheControls(triton::LoadOp op) {
+  CacheControls controls{CacheControls::CacheControlLoadINTEL,
+                         CacheControls::Cached, CacheControls::Cached};
+  if (op.getIsVolatile())
+    controls.l1 = controls.l3 = CacheControls::Uncached;
+  else if (op.getCache() == triton::CacheModifier::CG)
+    controls.l1 = CacheControls::Uncached;
+  else if (op.getCache() == triton::CacheModifier::CS)
+    controls.l1 = controls.l3 = CacheControls::Streaming;
+  else if (op.getCache() != triton::CacheModifier::CA &&
+           op.getEvict() == triton::EvictionPolicy::NORMAL)
+    return std::nullopt;
+  // Data read once should not displace reused data in L1.
+  if (op.getEvict() == triton::EvictionPolicy::EVICT_FIRST &&
+      controls.l1 == CacheControls::Cached)
+    controls.l1 = CacheControls::Streaming;
+  return controls;
+}
+
+// Maps the cache modifier and eviction policy of a store to cache controls, or
+// std::nullopt to leave the default policy.
+std::optional<CacheControls> getCacheControls(triton::StoreOp op) {
+  CacheControls controls{CacheControls::CacheControlStoreINTEL,
+                         CacheControls::WriteBack, CacheControls::WriteBack};
+  switch (op.getCache()) {
+  case triton::CacheModifier::WT:
+    controls.l1 = controls.l3 = CacheControls::WriteThrough;
+    break;
+  case triton::CacheModifier::CG:
+    controls.l1 = CacheControls::StoreUncached;
+    break;
+  case triton::CacheModifier::CS:
+    controls.l1 = controls.l3 = CacheControls::StoreStreaming;
+    break;
+  case triton::CacheModifier::WB:
+  case triton::CacheModifier::CA:
+    break;
+  default:
+    if (op.getEvict() == triton::EvictionPolicy::NORMAL)
+      return std::nullopt;
+    break;
+  }
+  if (op.getEvict() == triton::EvictionPolicy::EVICT_FIRST &&
+      controls.l1 == CacheControls::WriteBack)
+    controls.l1 = CacheControls::StoreStreaming;
+  return controls;
+}
+
+// The prefetches of the pipeliner fill both L1 and L3.
+std::optional<CacheControls> getCacheControls(triton::gpu::PrefetchTensorOp) {
+  return CacheControls{CacheControls::CacheControlLoadINTEL,
+                       CacheControls::Cached, CacheControls::Cached};
+}
+
+// Maps the cache level of a prefetch to cache controls. The L2 of Triton is
+// the last level cache, which is L3 on Intel GPUs.
+std::optional<CacheControls> getCacheControls(triton::PrefetchOp op) {
+  CacheControls controls{CacheControls::CacheControlLoadINTEL,
+                         CacheControls::Cached, CacheControls::Cached};
+  if (op.getCacheLevel() == triton::CacheLevel::L2)
+    controls.l1 = CacheControls::Uncached;
+  return controls;
+}
+
+// Returns the LSC_L1_L3_CC operand of the GenISA block IO intrinsics closest
+// to \p controls (0 is the default policy).
+unsigned getLSCCacheControl(std::optional<CacheControls> controls) {
+  if (!controls)
+    return 0;
+  if (controls->decoration == CacheControls::CacheControlLoadINTEL) {
+    switch (controls->l1) {
+    case CacheControls::Uncached:
+      return controls->l3 == CacheControls::Uncached ? 1 : 2;
+    case CacheControls::Streaming:
+      return controls->l3 == CacheControls::Cached ? 6 : 5;
+    default:
+      return controls->l3 == CacheControls::Cached ? 4 : 3;
+    }
+  }
+  switch (controls->l1) {
+  case CacheControls::StoreUncached:
+    return 2;
+  case CacheControls::WriteThrough:
+    return 4;
+  case CacheControls::StoreStreaming:
+    return controls->l3 == CacheControls::WriteBack ? 6 : 5;
+  default:
+    return 7;
+  }
+}
+
+// Annotates \p ptr with \p controls through `llvm.ptr.annotation`, which the
+// SPIR-V translator turns into cache control decorations of the pointer.
+Value annotateCacheControls(Location loc, ConversionPatternRewriter &rewriter,
+                            Operation *op, Value ptr,
+                            std::optional<CacheControls> controls) {
+  if (!controls)
+    return ptr;
+  MLIRContext *ctx = rewriter.getContext();
+  auto moduleOp = op->getParentOfType<ModuleOp>();
+  unsigned addrSpace = GENX::GENXMemorySpace::kCrossWorkgroup;
+  std::string decoration = std::to_string(controls->decoration);
+  std::string annotation = "{" + decoration + ":\"0," +
+                           std::to_string(controls->l1) + "\"}{" +
+                           decoration + ":\"1," +
+                           std::to_string(controls->l3) + "\"}";
+  std::string name = "cache_controls_" + decoration + "_" +
+                     std::to_string(controls->l1) + "_" +
+                     std::to_string(controls->l3);
+  auto global = moduleOp.lookupSymbol<LLVM::GlobalOp>(name);
+  if (!global) {
+    ConversionPatternRewriter::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(moduleOp.getBody());
+    annotation.push_back('\0');
+    global = rewriter.create<LLVM::GlobalOp>(
+        UnknownLoc::get(ctx), array_ty(i8_ty, annotation.size()),
+        /*isConstant=*/true, LLVM::Linkage::Internal, name,
+        rewriter.getStringAttr(annotation), /*alignment=*/0, addrSpace);
+  }
+
+  Type strTy = ptr_ty(ctx, addrSpace);
+  Value str = address_of(strTy, global.getSymName());
+  Value nullStr = null(strTy);
+  std::string funcName = "llvm.ptr.annotation.p" +
+                         std::to_string(ptr.getType()
+                                            .cast<LLVM::LLVMPointerType>()
+                                            .getAddressSpace()) +
+                         ".p" + std::to_string(addrSpace);
+  auto funcOp = getOrInsertFunction(
+      rewriter, op, funcName, ptr.getType(),
+      {ptr.getType(), strTy, strTy, i32_ty, strTy});
+  return call(funcOp, ValueRange{ptr, str, nullStr, i32_val(0), nullStr})
+      .getResult();
+}
+
+// Returns true in every lane iff \p pred is true in every lane of the
+// sub-group.
+Value subgroupAll(Location loc, ConversionPatternRewriter &rewriter,
+                  Value pred, unsigned warpSize, triton::Target target) {
+  Value acc = zext(i32_ty, pred);
+  for (unsigned i = warpSize / 2; i > 0; i /= 2)
+    acc = and_(acc, shflSync(loc, rewriter, acc, i, target));
+  return icmp_ne(acc, i32_val(0));
+}
+
+// Emits a sub-group block read of one \p unitTy per lane from \p base, or a
+// block write of \p value to it. Lane `i` accesses the `i`-th unit of the
+// chunk starting at the sub-group-uniform address \p base.
+Value emitSubgroupBlockIO(Location loc, ConversionPatternRewriter &rewriter,
+                          Operation *op, Value base, Type unitTy,
+                          Value value = {}) {
+  MLIRContext *ctx = rewriter.getContext();
+  std::string unitName = "i" + std::to_string(unitTy.getIntOrFloatBitWidth());
+  if (value) {
+    auto funcOp = getOrInsertSPIRFunction(
+        rewriter, op, "llvm.genx.GenISA.simdBlockWrite.p1." + unitName,
+        void_ty(ctx), {base.getType(), unitTy});
+    auto callOp = call(funcOp, ValueRange{base, value});
+    callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+    return Value();
+  }
+  auto funcOp = getOrInsertSPIRFunction(
+      rewriter, op, "llvm.genx.GenISA.simdBlockRead." + unitName + ".p1",
+      unitTy, {base.getType()});
+  auto callOp = call(funcOp, ValueRange{base});
+  callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return callOp.getResult();
+}
+
 // Contains some helper functions for both Load and Store conversions.
 struct LoadStoreConversionBase {
   explicit LoadStoreConversionBase(ModuleAxisInfoAnalysis &axisAnalysisPass)
@@ -68,6 +262,81 @@ struct LoadStoreConversionBase {
     return axisAnalysisPass.getMaskAlignment(mask);
   }
 
+  // Returns true if \p mask is known to be true everywhere, so that it can be
+  // dropped.
+  bool isMaskAllTrue(Value mask) const {
+    AxisInfo *axisInfo = axisAnalysisPass.getAxisInfo(mask);
+    return axisInfo && axisInfo->getConstantValue() == 1;
+  }
+
+  // Replaces every element of \p maskElems with the first element of this
+  // lane that AxisInfo proves equal to it. Elements in one constancy block
+  // then share a single predicate, and the compares of the others fold away.
+  SmallVector<Value> dedupMaskElems(Value mask,
+                                    ArrayRef<Value> maskElems) const {
+    SmallVector<Value> elems(maskElems.begin(), maskElems.end());
+    auto tensorTy = mask.getType().dyn_cast<RankedTensorType>();
+    AxisInfo *axisInfo = axisAnalysisPass.getAxisInfo(mask);
+    if (!tensorTy || !axisInfo || elems.empty())
+      return elems;
+    ArrayRef<int64_t> shape = tensorTy.getShape();
+    unsigned group = 1;
+    if (llvm::all_of(llvm::seq<size_t>(0, shape.size()), [&](size_t d) {
+          return axisInfo->getConstancy(d) >= shape[d];
+        })) {
+      group = elems.size();
+    } else if (auto blocked =
+                   tensorTy.getEncoding().dyn_cast<BlockedEncodingAttr>()) {
+      // The elements of a lane run along the fastest dimension in chunks of
+      // aligned, contiguous elements.
+      unsigned dim = triton::gpu::getOrder(blocked)[0];
+      group = std::gcd<unsigned>(axisInfo->getConstancy(dim),
+                                 triton::gpu::getContigPerThread(blocked)[dim]);
+    }
+    for (size_t i = 0; i < elems.size(); ++i)
+      elems[i] = elems[i - i % group];
+    return elems;
+  }
+
+  // Returns the number of elements each lane contributes to a sub-group block
+  // read/write through \p ptr, or 0 if block IO does not apply. It applies
+  // when the lanes of a warp own consecutive 16/32/64-bit slices along the
+  // fastest dimension and each warp's chunk is contiguous and 16-byte
+  // aligned. \p mask, if any, must be constant over each lane's slice.
+  unsigned getSubgroupBlockIOVectorSize(Value ptr, Value mask,
+                                        unsigned warpSize) const {
+    auto tensorTy = ptr.getType().dyn_cast<RankedTensorType>();
+    if (!tensorTy)
+      return 0;
+    // Lane `i` of a DPAS tile owns column `i` of each of its rows, as in a
+    // blocked layout with `sizePerThread = [RC, 1]`.
+    Attribute layout = tensorTy.getEncoding();
+    if (!layout || !layout.isa<BlockedEncodingAttr, DpasEncodingAttr>())
+      return 0;
+    Type pointeeTy = tensorTy.getElementType()
+                         .cast<triton::PointerType>()
+                         .getPointeeType();
+    if (!pointeeTy.isIntOrFloat() || pointeeTy.getIntOrFloatBitWidth() < 8)
+      return 0;
+    unsigned dim = triton::gpu::getOrder(layout)[0];
+    unsigned vec = triton::gpu::getContigPerThread(layout)[dim];
+    unsigned unitBits = vec * pointeeTy.getIntOrFloatBitWidth();
+    if (triton::gpu::getThreadsPerWarp(layout)[dim] != warpSize ||
+        (unitBits != 16 && unitBits != 32 && unitBits != 64))
+      return 0;
+    // The lanes of a warp must not wrap around the tensor.
+    unsigned chunk = warpSize * vec;
+    if (tensorTy.getShape()[dim] % chunk != 0)
+      return 0;
+    AxisInfo *axisInfo = axisAnalysisPass.getAxisInfo(ptr);
+    if (!axisInfo || axisInfo->getContiguity(dim) % chunk != 0 ||
+        axisInfo->getDivisibility(dim) < 16)
+      return 0;
+    if (mask && getMaskAlignment(mask) % vec != 0)
+      return 0;
+    return vec;
+  }
+
 protected:
   ModuleAxisInfoAnalysis &axisAnalysisPass;
 };
@@ -103,6 +372,10 @@ struct LoadOpConversion
     Value llPtr = adaptor.getPtr();
     Value llMask = adaptor.getMask();
     Value llOther = adaptor.getOther();
+    if (mask && isMaskAllTrue(mask)) {
+      mask = Value();
+      llMask = Value();
+    }
 
     // Determine the vectorization size
     Type valueTy = op.getResult().getType();
@@ -122,6 +395,7 @@ struct LoadOpConversion
     if (llMask) {
       maskElems = getTypeConverter()->unpackLLElements(loc, llMask, rewriter);
       assert(maskElems.size() == numElems);
+      maskElems = dedupMaskElems(mask, maskElems);
     }
 
     // Get the LLVM values for `other`
@@ -141,6 +415,22 @@ struct LoadOpConversion
       otherElems = getTypeConverter()->unpackLLElements(loc, llOther, rewriter);
     }
 
+    if (target == triton::Target::GENX && !op.getIsVolatile()) {
+      auto mod = op->getParentOfType<ModuleOp>();
+      int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+      if (unsigned blockVec =
+              getSubgroupBlockIOVectorSize(ptr, mask, warpSize)) {
+        SmallVector<Value> loadedVals =
+            emitSubgroupBlockLoads(loc, rewriter, op, ptrElems, maskElems,
+                                   otherElems, valueElemTy, blockVec, warpSize);
+        Type llvmResultStructTy = getTypeConverter()->convertType(valueTy);
+        Value resultStruct = getTypeConverter()->packLLElements(
+            loc, loadedVals, rewriter, llvmResultStructTy);
+        rewriter.replaceOp(op, {resultStruct});
+        return success();
+      }
+    }
+
     // vectorized iteration through all the pointer/mask/other elements
     const int valueElemNBits =
         std::max(8u, valueElemTy.getIntOrFloatBitWidth());
@@ -203,6 +493,8 @@ struct LoadOpConversion
             rewriter, loc, pred, SmallVector<Value, 1>{other_}, [&]() {
               Value addrElem =
                   bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
+              addrElem = annotateCacheControls(loc, rewriter, op, addrElem,
+                                               getCacheControls(op));
               Value ret = load(retTy, addrElem);
               return SmallVector<Value, 1>{ret};
             });
@@ -351,6 +643,70 @@ struct LoadOpConversion
     rewriter.replaceOp(op, {resultStruct});
     return success();
   }
+
+private:
+  // Loads each lane's `vec`-element slices with one sub-group block read per
+  // layout repetition. Block reads cannot be masked per lane, so a masked
+  // chunk is block read only when every lane is enabled, and loaded with
+  // predicated per-lane loads otherwise.
+  SmallVector<Value>
+  emitSubgroupBlockLoads(Location loc, ConversionPatternRewriter &rewriter,
+                         triton::LoadOp op, ArrayRef<Value> ptrElems,
+                         ArrayRef<Value> maskElems, ArrayRef<Value> otherElems,
+                         Type valueElemTy, unsigned vec,
+                         unsigned warpSize) const {
+    Type unitTy = int_ty(vec * valueElemTy.getIntOrFloatBitWidth());
+    Type vecTy = vec_ty(valueElemTy, vec);
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(warpSize));
+    Value toFirstLane = sub(i32_val(0), mul(laneId, i32_val(vec)));
+    std::optional<CacheControls> cacheControls = getCacheControls(op);
+
+    // Splits a lane's slice into its elements.
+    auto unpackSlice = [&](Value slice) {
+      slice = bitcast(slice, vecTy);
+      SmallVector<Value> elems;
+      for (unsigned i = 0; i < vec; ++i)
+        elems.push_back(extract_element(valueElemTy, slice, i32_val(i)));
+      return elems;
+    };
+
+    SmallVector<Value> loadedVals;
+    for (size_t start = 0; start < ptrElems.size(); start += vec) {
+      Value chunk = gep(ptrElems[start].getType(), valueElemTy,
+                        ptrElems[start], toFirstLane);
+      chunk = annotateCacheControls(loc, rewriter, op, chunk, cacheControls);
+      auto blockRead = [&] {
+        return unpackSlice(
+            emitSubgroupBlockIO(loc, rewriter, op, chunk, unitTy));
+      };
+      if (maskElems.empty()) {
+        llvm::append_range(loadedVals, blockRead());
+        continue;
+      }
+
+      Value pred = maskElems[start];
+      SmallVector<Value> others;
+      for (unsigned i = 0; i < vec; ++i)
+        others.push_back(otherElems.empty() ? undef(valueElemTy)
+                                            : otherElems[start + i]);
+      Block &endBlock = LLVM::createIfElseBlock(
+          rewriter, loc, subgroupAll(loc, rewriter, pred, warpSize, target),
+          blockRead, [&] {
+            Block &predBlock =
+                LLVM::createPredicatedBlock(rewriter, loc, pred, others, [&] {
+                  Value addr = bitcast(ptrElems[start],
+                                       ptr_ty(rewriter.getContext(), 1));
+                  addr = annotateCacheControls(loc, rewriter, op, addr,
+                                               cacheControls);
+                  return unpackSlice(load(vecTy, addr));
+                });
+            return SmallVector<Value>(predBlock.args_begin(),
+                                      predBlock.args_end());
+          });
+      loadedVals.append(endBlock.args_begin(), endBlock.args_end());
+    }
+    return loadedVals;
+  }
 };
 
 struct StoreOpConversion
@@ -393,16 +749,33 @@ struct StoreOpConversion
 
     // Determine the vectorization size
     SmallVector<Value> maskElems;
+    if (llMask && isMaskAllTrue(op.getMask()))
+      llMask = Value();
     if (llMask) {
       Value mask = op.getMask();
       maskElems = getTypeConverter()->unpackLLElements(loc, llMask, rewriter);
       assert(valueElems.size() == maskElems.size());
+      maskElems = dedupMaskElems(mask, maskElems);
 
       unsigned maskAlign = getMaskAlignment(mask);
       vec = std::min(vec, maskAlign);
     }
 
     Value mask = getMask(valueTy, rewriter, loc);
+
+    if (target == triton::Target::GENX) {
+      auto mod = op->getParentOfType<ModuleOp>();
+      int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+      if (unsigned blockVec = getSubgroupBlockIOVectorSize(
+              ptr, llMask ? op.getMask() : Value(), warpSize)) {
+        emitSubgroupBlockStores(loc, rewriter, op, ptrElems, maskElems,
+                                valueElems, mask, valueElemTy, blockVec,
+                                warpSize);
+        rewriter.eraseOp(op);
+        return success();
+      }
+    }
+
     const size_t dtsize =
         std::max<int>(1, valueElemTy.getIntOrFloatBitWidth() / 8);
     const size_t valueElemNBits = dtsize * 8;
@@ -460,6 +833,8 @@ struct StoreOpConversion
         mlir::LLVM::createPredicatedBlock(rewriter, loc, maskVal, [&] {
           Value addrElem =
               bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
+          addrElem = annotateCacheControls(loc, rewriter, op, addrElem,
+                                           getCacheControls(op));
           store(vecWord, addrElem);
           return ArrayRef<Value>();
         });
@@ -499,6 +874,64 @@ struct StoreOpConversion
     rewriter.eraseOp(op);
     return success();
   }
+
+private:
+  // Stores each lane's `vec`-element slices with one sub-group block write per
+  // layout repetition. \p mask only disables whole warps holding replicated
+  // data; a chunk with a user mask is block written only when every lane is
+  // enabled, and stored with predicated per-lane stores otherwise.
+  void emitSubgroupBlockStores(Location loc,
+                               ConversionPatternRewriter &rewriter,
+                               triton::StoreOp op, ArrayRef<Value> ptrElems,
+                               ArrayRef<Value> maskElems,
+                               ArrayRef<Value> valueElems, Value mask,
+                               Type valueElemTy, unsigned vec,
+                               unsigned warpSize) const {
+    Type unitTy = int_ty(vec * valueElemTy.getIntOrFloatBitWidth());
+    Type vecTy = vec_ty(valueElemTy, vec);
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(warpSize));
+    Value toFirstLane = sub(i32_val(0), mul(laneId, i32_val(vec)));
+    std::optional<CacheControls> cacheControls = getCacheControls(op);
+
+    for (size_t start = 0; start < ptrElems.size(); start += vec) {
+      Value slice = undef(vecTy);
+      for (unsigned i = 0; i < vec; ++i)
+        slice = insert_element(vecTy, slice,
+                               bitcast(valueElems[start + i], valueElemTy),
+                               i32_val(i));
+      Value chunk = gep(ptrElems[start].getType(), valueElemTy,
+                        ptrElems[start], toFirstLane);
+      chunk = annotateCacheControls(loc, rewriter, op, chunk, cacheControls);
+      if (maskElems.empty()) {
+        LLVM::createPredicatedBlock(rewriter, loc, mask, [&] {
+          emitSubgroupBlockIO(loc, rewriter, op, chunk, unitTy,
+                              bitcast(slice, unitTy));
+          return ArrayRef<Value>();
+        });
+        continue;
+      }
+
+      Value pred = and_(mask, maskElems[start]);
+      LLVM::createIfElseBlock(
+          rewriter, loc, subgroupAll(loc, rewriter, pred, warpSize, target),
+          [&] {
+            emitSubgroupBlockIO(loc, rewriter, op, chunk, unitTy,
+                                bitcast(slice, unitTy));
+            return SmallVector<Value>();
+          },
+          [&] {
+            LLVM::createPredicatedBlock(rewriter, loc, pred, [&] {
+              Value addr =
+                  bitcast(ptrElems[start], ptr_ty(rewriter.getContext(), 1));
+              addr = annotateCacheControls(loc, rewriter, op, addr,
+                                           cacheControls);
+              store(slice, addr);
+              return ArrayRef<Value>();
+            });
+            return SmallVector<Value>();
+          });
+    }
+  }
 };
 // TODO: refactor to save common logic with insertsliceasyncv2
 struct StoreAsyncTMAOpConversion : public ConvertTritonGPUOpToLLVMPattern<
@@ -1209,10 +1642,80 @@ struct AtomicRMWOpConversion
 
   AtomicRMWOpConversion(TritonGPUToLLVMTypeConverter &converter,
                         ModuleAxisInfoAnalysis &axisAnalysisPass,
-                        triton::Target target, PatternBenefit benefit)
+                        triton::Target target, bool aggregate,
+                        PatternBenefit benefit)
       : ConvertTritonGPUOpToLLVMPattern<triton::AtomicRMWOp>(converter, target,
                                                              benefit),
-        LoadStoreConversionBase(axisAnalysisPass) {}
+        LoadStoreConversionBase(axisAnalysisPass), aggregate(aggregate) {}
+
+  // Whether the updates of the lanes of a sub-group to the same address can
+  // be combined before the atomic: the operation is associative and
+  // commutative, and no lane needs the value it replaced.
+  static bool isAggregatable(triton::AtomicRMWOp op) {
+    switch (op.getAtomicRmwOp()) {
+    case RMWOp::XCHG:
+      return false;
+    default:
+      return op.getResult().use_empty();
+    }
+  }
+
+  Value combine(ConversionPatternRewriter &rewriter, Location loc, RMWOp rmwOp,
+                Value lhs, Value rhs) const {
+    switch (rmwOp) {
+    case RMWOp::AND:
+      return and_(lhs, rhs);
+    case RMWOp::OR:
+      return or_(lhs, rhs);
+    case RMWOp::XOR:
+      return xor_(lhs, rhs);
+    case RMWOp::ADD:
+      return add(lhs, rhs);
+    case RMWOp::FADD:
+      return fadd(lhs, rhs);
+    case RMWOp::MAX:
+      return smax(lhs, rhs);
+    case RMWOp::MIN:
+      return smin(lhs, rhs);
+    case RMWOp::UMAX:
+      return umax(lhs, rhs);
+    case RMWOp::UMIN:
+      return umin(lhs, rhs);
+    case RMWOp::FMAX:
+      return fmax(lhs, rhs);
+    case RMWOp::FMIN:
+      return fmin(lhs, rhs);
+    default:
+      llvm_unreachable("not an aggregatable atomic");
+    }
+  }
+
+  // Combines \p val with the values of the other lanes of the sub-group
+  // updating the same address as this one. Only the first of these lanes
+  // keeps its predicate, so one atomic is issued per distinct address.
+  // Returns the combined value and the new predicate.
+  std::pair<Value, Value> aggregateLanes(ConversionPatternRewriter &rewriter,
+                                         Location loc, RMWOp rmwOp, Value ptr,
+                                         Value val, Value pred,
+                                         int warpSize) const {
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(warpSize));
+    Value addr = ptrtoint(i64_ty, ptr);
+    Value active = zext(i32_ty, pred);
+    Value combined = val;
+    Value first = pred;
+    for (int k = 0; k < warpSize; ++k) {
+      Value kAddr = shflIdxSync(loc, rewriter, addr, k, target);
+      Value kVal = shflIdxSync(loc, rewriter, val, k, target);
+      Value kActive = shflIdxSync(loc, rewriter, active, k, target);
+      Value same = and_(icmp_ne(kActive, i32_val(0)), icmp_eq(kAddr, addr));
+      Value other = and_(same, icmp_ne(laneId, i32_val(k)));
+      Value withK = combine(rewriter, loc, rmwOp, combined, kVal);
+      combined = select(other, withK, combined);
+      Value earlier = and_(same, icmp_ult(i32_val(k), laneId));
+      first = and_(first, xor_(earlier, int_val(1, 1)));
+    }
+    return {combined, first};
+  }
 
   LogicalResult
   matchAndRewrite(triton::AtomicRMWOp op, OpAdaptor adaptor,
@@ -1256,14 +1759,27 @@ struct AtomicRMWOpConversion
     if (tensorTy) {
       auto valTy = val.getType().cast<RankedTensorType>();
       vec = std::min<unsigned>(vec, valTy.getElementType().isF16() ? 2 : 1);
+      // SPIR-V has no packed atomics; GENX issues one native atomic per
+      // element.
+      if (target == triton::Target::GENX)
+        vec = 1;
       // mask
       numElems = tensorTy.getNumElements();
     }
     Value mask = getMask(valueTy, rewriter, loc);
+    bool aggregateUpdates =
+        aggregate && tensorTy && vec == 1 && isAggregatable(op);
+    int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(moduleOp);
 
     auto vecTy = vec_ty(valueElemTy, vec);
     SmallVector<Value> resultVals(elemsPerThread);
     for (size_t i = 0; i < elemsPerThread; i += vec) {
+      Value rmwMask = llMask ? and_(mask, maskElements[i]) : mask;
+      if (aggregateUpdates)
+        std::tie(valElements[i], rmwMask) =
+            aggregateLanes(rewriter, loc, atomicRmwAttr, ptrElements[i],
+                           valElements[i], rmwMask, warpSize);
+
       Value rmwVal = undef(vecTy);
       for (int ii = 0; ii < vec; ++ii) {
         Value iiVal = createIndexAttrConstant(
@@ -1272,7 +1788,6 @@ struct AtomicRMWOpConversion
       }
 
       Value rmwPtr = ptrElements[i];
-      Value rmwMask = llMask ? and_(mask, maskElements[i]) : mask;
 
       switch (target) {
       case triton::Target::ROCDL:
@@ -1414,6 +1929,12 @@ struct AtomicRMWOpConversion
               case RMWOp::XCHG:
                 rmwKind = LLVM::AtomicBinOp::xchg;
                 break;
+              case RMWOp::FMAX:
+                rmwKind = LLVM::AtomicBinOp::fmax;
+                break;
+              case RMWOp::FMIN:
+                rmwKind = LLVM::AtomicBinOp::fmin;
+                break;
               }
 
               rmwVal = bitcast(rmwVal, valueElemTy);
@@ -1432,6 +1953,11 @@ struct AtomicRMWOpConversion
                 vec == 1 ? ret : extract_element(valueElemTy, ret, i32_val(ii));
           }
         } else {
+          // Only broadcast the old value when someone reads it.
+          if (op->use_empty()) {
+            rewriter.replaceOp(op, {ret});
+            return success();
+          }
           Value atomPtr = LLVM::getSharedMemoryBase(loc, rewriter,
                                                     op.getOperation(), target);
           atomPtr = bitcast(atomPtr, ptr_ty(ctx, 3));
@@ -1456,6 +1982,9 @@ struct AtomicRMWOpConversion
     }
     return success();
   }
+
+private:
+  bool aggregate;
 };
 
 struct InsertSliceOpConversion
@@ -2056,13 +2585,877 @@ private:
   const TensorPtrMapT *tensorPtrMap;
   mlir::triton::gpu::TMAMetadataTy *tmaMetadata;
 };
+
+// Loads and stores through block pointers (`tt.make_tensor_ptr`). These only
+// reach the LLVM lowering on GENX, where RewriteTensorPointer keeps the block
+// pointers of 2D tensors with contiguous rows. They are lowered to 2D block
+// reads/writes when the layout gives each lane of a sub-group one column of
+// the block, and to per-element accesses otherwise.
+template <typename SourceOp>
+struct BlockPointerConversionBase
+    : public ConvertTritonGPUOpToLLVMPattern<SourceOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      SourceOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  // The unpacked `{offsets, shape, strides, base}` struct of a tensor pointer.
+  struct BlockPointer {
+    SmallVector<Value> offsets; // i32
+    SmallVector<Value> shape;   // i64
+    SmallVector<Value> strides; // i64
+    Value base;
+  };
+
+  BlockPointer unpackBlockPointer(Location loc, Value llPtr, unsigned rank,
+                                  ConversionPatternRewriter &rewriter) const {
+    auto elems =
+        this->getTypeConverter()->unpackLLElements(loc, llPtr, rewriter);
+    assert(elems.size() == 3 * rank + 1 && "unexpected tensor pointer struct");
+    BlockPointer ptr;
+    ptr.offsets.assign(elems.begin(), elems.begin() + rank);
+    ptr.shape.assign(elems.begin() + rank, elems.begin() + 2 * rank);
+    ptr.strides.assign(elems.begin() + 2 * rank, elems.begin() + 3 * rank);
+    ptr.base = elems.back();
+    return ptr;
+  }
+
+  // Computes the address of every element owned by the thread, and whether it
+  // lies inside the tensor along the dimensions listed in \p boundaryCheck.
+  void emitElementAddresses(Location loc, ConversionPatternRewriter &rewriter,
+                            const BlockPointer &ptr, RankedTensorType tensorTy,
+                            ArrayRef<int32_t> boundaryCheck,
+                            SmallVectorImpl<Value> &ptrElems,
+                            SmallVectorImpl<Value> &maskElems) const {
+    Type llElemTy =
+        this->getTypeConverter()->convertType(tensorTy.getElementType());
+    auto indices = this->emitIndices(loc, rewriter, tensorTy.getEncoding(),
+                                     tensorTy, /*withCTAOffset=*/true);
+    for (const auto &index : indices) {
+      Value offset = i64_val(0);
+      Value mask = int_val(1, 1);
+      for (unsigned k = 0; k < index.size(); ++k) {
+        Value idx = sext(i64_ty, add(ptr.offsets[k], index[k]));
+        offset = add(offset, mul(idx, ptr.strides[k]));
+        // The unsigned comparison also rejects negative indices.
+        if (llvm::is_contained(boundaryCheck, static_cast<int32_t>(k)))
+          mask = and_(mask, icmp_ult(idx, ptr.shape[k]));
+      }
+      ptrElems.push_back(gep(ptr.base.getType(), llElemTy, ptr.base, offset));
+      maskElems.push_back(mask);
+    }
+  }
+
+  // Returns the number of rows a lane reads/writes per 2D block, or 0 if the
+  // layout of \p tensorTy does not map the lanes of a sub-group to consecutive
+  // columns of a block, i.e. when it is not `sizePerThread = [n, 1]`,
+  // `threadsPerWarp = [1, 16]` tiling the tensor exactly. DPAS tiles of
+  // `RC x 16` elements are such blocks.
+  unsigned getBlockIOHeight(RankedTensorType tensorTy, unsigned maxHeight,
+                            ConversionPatternRewriter &rewriter) const {
+    Attribute layout = tensorTy.getEncoding();
+    if (!layout || !layout.isa<BlockedEncodingAttr, DpasEncodingAttr>() ||
+        tensorTy.getRank() != 2)
+      return 0;
+    unsigned bitWidth = tensorTy.getElementTypeBitWidth();
+    if (bitWidth != 16 && bitWidth != 32)
+      return 0;
+    auto mod = rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
+    if (triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod) != 16 ||
+        product<unsigned>(triton::gpu::getCTAsPerCGA(layout)) != 1)
+      return 0;
+    auto sizePerThread = triton::gpu::getSizePerThread(layout);
+    auto threadsPerWarp = triton::gpu::getThreadsPerWarp(layout);
+    if (sizePerThread[1] != 1 || threadsPerWarp[0] != 1 ||
+        threadsPerWarp[1] != 16)
+      return 0;
+    if (auto dpasLayout = layout.dyn_cast<DpasEncodingAttr>())
+      if (dpasLayout.getExecutionSize() != 16 ||
+          sizePerThread[0] > maxHeight)
+        return 0;
+    unsigned height = std::min(sizePerThread[0], maxHeight);
+    if (sizePerThread[0] % height != 0)
+      return 0;
+    auto shape = tensorTy.getShape();
+    auto shapePerCTATile = triton::gpu::getShapePerCTATile(layout, shape);
+    for (unsigned k = 0; k < 2; ++k)
+      if (shape[k] % shapePerCTATile[k] != 0)
+        return 0;
+    return height;
+  }
+
+  // Describes the 2D surface of a block pointer for block reads/writes. The
+  // hardware wants a 64-byte aligned base, so the base is aligned down and the
+  // misalignment is folded into the width and the x offset. \p cond tells
+  // whether the surface satisfies the remaining constraints of the
+  // instructions. The rows of the surface are those of dimension 0, or of
+  // dimension 1 for the \p transposed, column-major, block pointers.
+  struct BlockSurface {
+    Value base;   // i64
+    Value width;  // i32, in bytes minus one
+    Value height; // i32, in rows minus one
+    Value pitch;  // i32, in bytes minus one
+    Value x, y;   // i32, in elements, of the sub-group's first block
+    Value cond;   // i1
+  };
+
+  BlockSurface getBlockSurface(Location loc,
+                               ConversionPatternRewriter &rewriter,
+                               const BlockPointer &ptr,
+                               RankedTensorType tensorTy,
+                               bool transposed = false) const {
+    unsigned colDim = transposed ? 0 : 1, rowDim = 1 - colDim;
+    unsigned elemBytes = tensorTy.getElementTypeBitWidth() / 8;
+    Value baseInt = ptrtoint(i64_ty, ptr.base);
+    Value misalignment = and_(baseInt, i64_val(63));
+    Value width =
+        add(mul(ptr.shape[colDim], i64_val(elemBytes)), misalignment);
+    Value pitch = mul(ptr.strides[rowDim], i64_val(elemBytes));
+    Value maxDim = i64_val(1 << 24);
+
+    BlockSurface surface;
+    surface.base = sub(baseInt, misalignment);
+    surface.width = trunc(i32_ty, sub(width, i64_val(1)));
+    surface.height = trunc(i32_ty, sub(ptr.shape[rowDim], i64_val(1)));
+    surface.pitch = trunc(i32_ty, sub(pitch, i64_val(1)));
+
+    Value xShift = trunc(i32_ty, udiv(misalignment, i64_val(elemBytes)));
+    Value x = add(ptr.offsets[colDim], xShift);
+    surface.x = x;
+    surface.y = ptr.offsets[rowDim];
+    // For blocked layouts, each warp starts at row
+    // `warpId[0] * sizePerThread[0]` and column `warpId[1] * 16`; lane `i`
+    // owns column `x + i` of each block. DPAS tiles are placed the same way,
+    // with warps numbered along M first. Other layouts place their warps
+    // themselves.
+    Attribute encoding = tensorTy.getEncoding();
+    if (encoding && encoding.isa<BlockedEncodingAttr, DpasEncodingAttr>()) {
+      Value warpId = udiv(this->getThreadId(rewriter, loc), i32_val(16));
+      auto warpsPerCTA = triton::gpu::getWarpsPerCTA(encoding);
+      SmallVector<Value> multiDimWarpId;
+      if (encoding.isa<DpasEncodingAttr>())
+        multiDimWarpId = {urem(warpId, i32_val(warpsPerCTA[0])),
+                          urem(udiv(warpId, i32_val(warpsPerCTA[0])),
+                               i32_val(warpsPerCTA[1]))};
+      else
+        multiDimWarpId = delinearize(rewriter, loc, warpId, warpsPerCTA,
+                                     triton::gpu::getOrder(encoding));
+      surface.x = add(x, mul(multiDimWarpId[1], i32_val(16)));
+      unsigned rowsPerThread = triton::gpu::getSizePerThread(encoding)[0];
+      surface.y = add(ptr.offsets[0],
+                      mul(multiDimWarpId[0], i32_val(rowsPerThread)));
+    }
+
+    Value cond = icmp_eq(ptr.strides[colDim], i64_val(1));
+    cond = and_(cond, icmp_uge(width, i64_val(64)));
+    cond = and_(cond, icmp_ule(width, pitch));
+    cond = and_(cond, icmp_ule(pitch, maxDim));
+    // The pitch must be a multiple of 16 bytes and the width of 4 bytes.
+    cond = and_(cond, icmp_eq(and_(pitch, i64_val(15)), i64_val(0)));
+    cond = and_(cond, icmp_eq(and_(width, i64_val(3)), i64_val(0)));
+    cond = and_(cond, icmp_sge(ptr.shape[rowDim], i64_val(1)));
+    cond = and_(cond, icmp_ule(ptr.shape[rowDim], maxDim));
+    // With a misaligned base, the columns left of the tensor are inside the
+    // surface and would not be zero-filled.
+    cond = and_(cond, or_(icmp_eq(misalignment, i64_val(0)),
+                          icmp_sge(ptr.offsets[colDim], i32_val(0))));
+    // The x offset of each block must be dword aligned.
+    Value xBytes = mul(x, i32_val(elemBytes));
+    surface.cond = and_(cond, icmp_eq(and_(xBytes, i32_val(3)), i32_val(0)));
+    return surface;
+  }
+
+  static Type getBlockType(Type elemTy, unsigned blockHeight,
+                           ConversionPatternRewriter &rewriter) {
+    return blockHeight == 1 ? elemTy : vec_ty(elemTy, blockHeight);
+  }
+
+  // Emits one `LSC2DBlockRead`/`LSC2DBlockWrite` of a `16 x blockHeight`
+  // block at element (\p x, \p y) of \p surface. Each lane holds a vector of
+  // `blockHeight` elements, or a scalar for single-row blocks. \p value is the
+  // data to write, or null for a read. \p cacheControl is the LSC L1/L3 cache
+  // policy of the access. \p vnniTransform makes a read pack the elements of
+  // consecutive rows into dwords, as the DPAS B operand expects. \p transpose
+  // makes a read of 32-bit elements deliver an `8 x blockHeight` block
+  // transposed instead: lane `i` holds the 8 elements of row `y + i`.
+  Value emitBlockIO(Location loc, ConversionPatternRewriter &rewriter,
+                    Operation *op, const BlockSurface &surface, Value x,
+                    Value y, unsigned bitWidth, unsigned blockHeight,
+                    unsigned cacheControl, Value value = {},
+                    bool vnniTransform = false, bool transpose = false) const {
+    MLIRContext *ctx = rewriter.getContext();
+    unsigned blockWidth = transpose ? 8 : 16;
+    Type vecTy = getBlockType(int_ty(bitWidth), blockHeight, rewriter);
+    if (transpose)
+      vecTy = vec_ty(i32_ty, blockWidth);
+    else if (vnniTransform)
+      vecTy = getBlockType(i32_ty, blockHeight * bitWidth / 32, rewriter);
+    SmallVector<Value> args{surface.base,
+                            surface.width,
+                            surface.height,
+                            surface.pitch,
+                            x,
+                            y,
+                            i32_val(bitWidth),
+                            i32_val(blockWidth),
+                            i32_val(blockHeight),
+                            i32_val(1),
+                            int_val(1, transpose),
+                            int_val(1, vnniTransform),
+                            i32_val(cacheControl)};
+    std::string suffix = "i" + std::to_string(bitWidth);
+    if (transpose)
+      suffix = "v" + std::to_string(blockWidth) + "i32";
+    else if (vnniTransform)
+      suffix = "v" + std::to_string(blockHeight * bitWidth / 32) + "i32";
+    else if (blockHeight > 1)
+      suffix = "v" + std::to_string(blockHeight) + suffix;
+    std::string name = "llvm.genx.GenISA.LSC2DBlock";
+    Type resultTy = vecTy;
+    if (value) {
+      name += "Write." + suffix;
+      resultTy = void_ty(ctx);
+      args.push_back(value);
+    } else {
+      name += "Read." + suffix;
+    }
+    SmallVector<Type> argTys;
+    for (Value arg : args)
+      argTys.push_back(arg.getType());
+    auto funcOp =
+        getOrInsertSPIRFunction(rewriter, op, name, resultTy, argTys);
+    auto callOp = call(funcOp, args);
+    callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+    return value ? Value() : callOp.getResult();
+  }
+
+  // Emits one `LSC2DBlockPrefetch` of a `16 x blockHeight` block at element
+  // (\p x, \p y) of \p surface into the caches selected by \p cacheControl.
+  void emitBlockPrefetch(Location loc, ConversionPatternRewriter &rewriter,
+                         Operation *op, const BlockSurface &surface, Value x,
+                         Value y, unsigned bitWidth, unsigned blockHeight,
+                         unsigned cacheControl) const {
+    SmallVector<Value> args{surface.base,
+                            surface.width,
+                            surface.height,
+                            surface.pitch,
+                            x,
+                            y,
+                            i32_val(bitWidth),
+                            i32_val(16),
+                            i32_val(blockHeight),
+                            i32_val(1),
+                            int_val(1, 0),
+                            int_val(1, 0),
+                            i32_val(cacheControl)};
+    SmallVector<Type> argTys;
+    for (Value arg : args)
+      argTys.push_back(arg.getType());
+    auto funcOp = getOrInsertSPIRFunction(
+        rewriter, op, "llvm.genx.GenISA.LSC2DBlockPrefetch.isVoid",
+        void_ty(rewriter.getContext()), argTys);
+    auto callOp = call(funcOp, args);
+    callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  }
+};
+
+struct BlockPointerLoadOpConversion
+    : public BlockPointerConversionBase<triton::LoadOp> {
+  using BlockPointerConversionBase<triton::LoadOp>::BlockPointerConversionBase;
+
+  // Block reads return at most 32 rows per lane.
+  static constexpr unsigned maxBlockHeight = 32;
+
+  LogicalResult
+  matchAndRewrite(triton::LoadOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isTensorPointerType(op.getPtr().getType()))
+      return failure();
+
+    auto loc = op->getLoc();
+    auto tensorTy = op.getResult().getType().cast<RankedTensorType>();
+    BlockPointer ptr = unpackBlockPointer(loc, adaptor.getPtr(),
+                                          tensorTy.getRank(), rewriter);
+    ArrayRef<int32_t> boundaryCheck =
+        op.getBoundaryCheck().value_or(ArrayRef<int32_t>());
+    bool padNaN = op.getPadding() == triton::PaddingOption::PAD_NAN;
+
+    SmallVector<Value> loadedVals;
+    if (auto dotOpEnc =
+            tensorTy.getEncoding().dyn_cast<DotOperandEncodingAttr>()) {
+      // Operands of a DPAS dot are read straight into the registers of the
+      // instruction; see OptimizeDotOperands.
+      assert(supportDPASOperandBlockLoad(tensorTy) &&
+             "unsupported DPAS operand load");
+      bool transposed = op->hasAttr(kTransposedBlockLoadAttrName);
+      assert((!transposed || dotOpEnc.getOpIdx() == 1) &&
+             "only B operands are read transposed");
+      BlockSurface surface =
+          getBlockSurface(loc, rewriter, ptr, tensorTy, transposed);
+      if (padNaN && !boundaryCheck.empty())
+        surface.cond = int_val(1, 0);
+      Block &endBlock = LLVM::createIfElseBlock(
+          rewriter, loc, surface.cond,
+          [&] {
+            if (transposed)
+              return emitTransposedDPASOperandReads(loc, rewriter, op,
+                                                    surface, tensorTy);
+            return emitDPASOperandReads(loc, rewriter, op, surface, tensorTy);
+          },
+          [&] {
+            return emitDPASOperandLoads(loc, rewriter, op, ptr, tensorTy,
+                                        boundaryCheck, padNaN);
+          });
+      loadedVals.append(endBlock.args_begin(), endBlock.args_end());
+      Type llvmResultStructTy = getTypeConverter()->convertType(tensorTy);
+      Value resultStruct = getTypeConverter()->packLLElements(
+          loc, loadedVals, rewriter, llvmResultStructTy);
+      rewriter.replaceOp(op, {resultStruct});
+      return success();
+    }
+
+    // Block reads fill out-of-bounds elements with zeros.
+    unsigned blockHeight = 0;
+    if (!padNaN || boundaryCheck.empty())
+      blockHeight = getBlockIOHeight(tensorTy, maxBlockHeight, rewriter);
+    if (blockHeight) {
+      BlockSurface surface = getBlockSurface(loc, rewriter, ptr, tensorTy);
+      Block &endBlock = LLVM::createIfElseBlock(
+          rewriter, loc, surface.cond,
+          [&] {
+            return emitBlockReads(loc, rewriter, op, surface, tensorTy,
+                                  blockHeight);
+          },
+          [&] {
+            return emitElementLoads(loc, rewriter, op, ptr, tensorTy,
+                                    boundaryCheck, padNaN);
+          });
+      loadedVals.append(endBlock.args_begin(), endBlock.args_end());
+    } else {
+      loadedVals = emitElementLoads(loc, rewriter, op, ptr, tensorTy,
+                                    boundaryCheck, padNaN);
+    }
+
+    Type llvmResultStructTy = getTypeConverter()->convertType(tensorTy);
+    Value resultStruct = getTypeConverter()->packLLElements(
+        loc, loadedVals, rewriter, llvmResultStructTy);
+    rewriter.replaceOp(op, {resultStruct});
+    return success();
+  }
+
+private:
+  // The 2D coordinates, relative to the block pointer offsets, of the first
+  // element of each DPAS repetition of the thread's warp, in the order of the
+  // operand's LLVM struct (M/N-major, then K).
+  SmallVector<std::pair<Value, Value>>
+  getDPASOperandRepOrigins(Location loc, ConversionPatternRewriter &rewriter,
+                           RankedTensorType tensorTy) const {
+    auto dotOpEnc = tensorTy.getEncoding().cast<DotOperandEncodingAttr>();
+    auto dpasLayout = dotOpEnc.getParent().cast<DpasEncodingAttr>();
+    unsigned opIdx = dotOpEnc.getOpIdx();
+    auto shape = tensorTy.getShape();
+    auto warpsPerCTA = dpasLayout.getWarpsPerCTA();
+    auto elemsPerInstr = dotOpEnc.getDPASElemsPerInstr(
+        dotOpEnc.getDPASBitWidth(tensorTy.getElementType()));
+    auto reps = dotOpEnc.getDPASRep(shape, tensorTy.getElementType());
+
+    // Warps are placed as in the DPAS result layout: along M for A and along
+    // N for B, wrapping around when the operand is smaller than the tile.
+    Value warpId = udiv(this->getThreadId(rewriter, loc), i32_val(16));
+    unsigned nonKDim = opIdx == 0 ? 0 : 1;
+    Value nonKWarpId =
+        opIdx == 0 ? urem(warpId, i32_val(warpsPerCTA[0]))
+                   : urem(udiv(warpId, i32_val(warpsPerCTA[0])),
+                          i32_val(warpsPerCTA[1]));
+    nonKWarpId = urem(nonKWarpId,
+                      i32_val(std::max<int64_t>(
+                          1, shape[nonKDim] / elemsPerInstr[nonKDim])));
+    Value warpOffset = mul(nonKWarpId, i32_val(elemsPerInstr[nonKDim]));
+
+    unsigned numRepOuter = reps[nonKDim], numRepK = reps[nonKDim ^ 1];
+    SmallVector<std::pair<Value, Value>> origins;
+    for (unsigned outer = 0; outer < numRepOuter; ++outer) {
+      Value outerOffset = add(
+          warpOffset, i32_val(outer * elemsPerInstr[nonKDim] *
+                              warpsPerCTA[nonKDim]));
+      for (unsigned k = 0; k < numRepK; ++k) {
+        Value kOffset = i32_val(k * elemsPerInstr[nonKDim ^ 1]);
+        origins.push_back(opIdx == 0 ? std::make_pair(outerOffset, kOffset)
+                                     : std::make_pair(kOffset, outerOffset));
+      }
+    }
+    return origins;
+  }
+
+  // Reads each DPAS repetition with one 2D block read: `16 x RC` for A, and a
+  // VNNI-transformed `16 x 16` for B, which are the register layouts of the
+  // DPAS instruction for 16-bit operands.
+  SmallVector<Value> emitDPASOperandReads(Location loc,
+                                          ConversionPatternRewriter &rewriter,
+                                          triton::LoadOp op,
+                                          const BlockSurface &surface,
+                                          RankedTensorType tensorTy) const {
+    auto dotOpEnc = tensorTy.getEncoding().cast<DotOperandEncodingAttr>();
+    auto dpasLayout = dotOpEnc.getParent().cast<DpasEncodingAttr>();
+    bool isB = dotOpEnc.getOpIdx() == 1;
+    Type llElemTy =
+        getTypeConverter()->convertType(tensorTy.getElementType());
+    unsigned bitWidth = tensorTy.getElementTypeBitWidth();
+    unsigned cacheControl = getLSCCacheControl(getCacheControls(op));
+    unsigned blockHeight = isB ? 16 : dpasLayout.getRepeatCount();
+
+    SmallVector<Value> loadedVals;
+    for (auto [row, col] : getDPASOperandRepOrigins(loc, rewriter, tensorTy)) {
+      Value block = emitBlockIO(loc, rewriter, op, surface,
+                                add(surface.x, col), add(surface.y, row),
+                                bitWidth, blockHeight, cacheControl,
+                                /*value=*/{}, /*vnniTransform=*/isB);
+      loadedVals.push_back(bitcast(block, vec_ty(llElemTy, blockHeight)));
+    }
+    return loadedVals;
+  }
+
+  // Reads each DPAS repetition of a B operand stored transposed, i.e. N rows
+  // of K contiguous elements, with one transposing 2D block read of `8 x 16`
+  // dwords: lane `i` gets the 16 elements of K of column `i`, with those of
+  // consecutive rows of K in the same dword as a VNNI-transformed read packs
+  // them.
+  SmallVector<Value>
+  emitTransposedDPASOperandReads(Location loc,
+                                 ConversionPatternRewriter &rewriter,
+                                 triton::LoadOp op, const BlockSurface &surface,
+                                 RankedTensorType tensorTy) const {
+    Type llElemTy =
+        getTypeConverter()->convertType(tensorTy.getElementType());
+    unsigned elemsPerDword = 32 / tensorTy.getElementTypeBitWidth();
+    unsigned cacheControl = getLSCCacheControl(getCacheControls(op));
+
+    SmallVector<Value> loadedVals;
+    for (auto [row, col] : getDPASOperandRepOrigins(loc, rewriter, tensorTy)) {
+      // The columns of the surface are along K, in dwords for the read.
+      Value x = udiv(add(surface.x, row), i32_val(elemsPerDword));
+      Value block = emitBlockIO(loc, rewriter, op, surface, x,
+                                add(surface.y, col), /*bitWidth=*/32,
+                                /*blockHeight=*/16, cacheControl,
+                                /*value=*/{}, /*vnniTransform=*/false,
+                                /*transpose=*/true);
+      loadedVals.push_back(bitcast(block, vec_ty(llElemTy, 16)));
+    }
+    return loadedVals;
+  }
+
+  // Per-element fallback of emitDPASOperandReads producing the same register
+  // layout. Element `e` of lane `i` is at row `e` and column `i` of a B
+  // repetition, and at row `2 * (e / 2) + i / 8` and column
+  // `2 * (i % 8) + e % 2` of an A repetition.
+  SmallVector<Value> emitDPASOperandLoads(Location loc,
+                                          ConversionPatternRewriter &rewriter,
+                                          triton::LoadOp op,
+                                          const BlockPointer &ptr,
+                                          RankedTensorType tensorTy,
+                                          ArrayRef<int32_t> boundaryCheck,
+                                          bool padNaN) const {
+    auto dotOpEnc = tensorTy.getEncoding().cast<DotOperandEncodingAttr>();
+    auto dpasLayout = dotOpEnc.getParent().cast<DpasEncodingAttr>();
+    bool isB = dotOpEnc.getOpIdx() == 1;
+    Type elemTy = tensorTy.getElementType();
+    Type llElemTy = getTypeConverter()->convertType(elemTy);
+    unsigned numElems = isB ? 16 : dpasLayout.getRepeatCount();
+    Value other;
+    if (padNaN && elemTy.isa<FloatType>())
+      other = bitcast(LLVM::createNaNConstant(loc, rewriter, elemTy), llElemTy);
+    else
+      other = rewriter.create<LLVM::ConstantOp>(loc, llElemTy,
+                                                rewriter.getZeroAttr(llElemTy));
+
+    Value laneId = urem(this->getThreadId(rewriter, loc), i32_val(16));
+    std::optional<CacheControls> cacheControls = getCacheControls(op);
+    Type vecTy = vec_ty(llElemTy, numElems);
+    SmallVector<Value> loadedVals;
+    for (auto [row, col] : getDPASOperandRepOrigins(loc, rewriter, tensorTy)) {
+      Value vec = undef(vecTy);
+      for (unsigned e = 0; e < numElems; ++e) {
+        Value elemRow, elemCol;
+        if (isB) {
+          elemRow = add(row, i32_val(e));
+          elemCol = add(col, laneId);
+        } else {
+          elemRow = add(row, add(i32_val(2 * (e / 2)),
+                                 udiv(laneId, i32_val(8))));
+          elemCol = add(col, add(mul(urem(laneId, i32_val(8)), i32_val(2)),
+                                 i32_val(e % 2)));
+        }
+        SmallVector<Value> index{elemRow, elemCol};
+        Value offset = i64_val(0);
+        Value mask = int_val(1, 1);
+        for (unsigned k = 0; k < 2; ++k) {
+          Value idx = sext(i64_ty, add(ptr.offsets[k], index[k]));
+          offset = add(offset, mul(idx, ptr.strides[k]));
+          if (llvm::is_contained(boundaryCheck, static_cast<int32_t>(k)))
+            mask = and_(mask, icmp_ult(idx, ptr.shape[k]));
+        }
+        Value ptrElem = gep(ptr.base.getType(), llElemTy, ptr.base, offset);
+        Block &endBlock = LLVM::createPredicatedBlock(
+            rewriter, loc, mask, SmallVector<Value, 1>{other}, [&]() {
+              Value addr = annotateCacheControls(loc, rewriter, op, ptrElem,
+                                                 cacheControls);
+              return SmallVector<Value, 1>{load(llElemTy, addr)};
+            });
+        vec = insert_element(vecTy, vec, *endBlock.args_begin(), i32_val(e));
+      }
+      loadedVals.push_back(vec);
+    }
+    return loadedVals;
+  }
+
+  SmallVector<Value> emitBlockReads(Location loc,
+                                    ConversionPatternRewriter &rewriter,
+                                    triton::LoadOp op,
+                                    const BlockSurface &surface,
+                                    RankedTensorType tensorTy,
+                                    unsigned blockHeight) const {
+    Type llElemTy =
+        getTypeConverter()->convertType(tensorTy.getElementType());
+    unsigned bitWidth = tensorTy.getElementTypeBitWidth();
+    unsigned cacheControl = getLSCCacheControl(getCacheControls(op));
+    auto offsets = emitOffsetForLayout(tensorTy.getEncoding(), tensorTy);
+    // One block per distinct (first row, column) of the thread's elements.
+    std::map<std::pair<unsigned, unsigned>, Value> blocks;
+    SmallVector<Value> loadedVals;
+    for (const auto &offset : offsets) {
+      unsigned row = offset[0] % blockHeight;
+      auto key = std::make_pair(offset[0] - row, offset[1]);
+      Value &block = blocks[key];
+      if (!block) {
+        Value x = add(surface.x, i32_val(key.second));
+        Value y = add(surface.y, i32_val(key.first));
+        block = emitBlockIO(loc, rewriter, op, surface, x, y, bitWidth,
+                            blockHeight, cacheControl);
+        block = bitcast(block, getBlockType(llElemTy, blockHeight, rewriter));
+      }
+      loadedVals.push_back(blockHeight == 1 ? block
+                                            : extract_element(llElemTy, block,
+                                                              i32_val(row)));
+    }
+    return loadedVals;
+  }
+
+  SmallVector<Value> emitElementLoads(Location loc,
+                                      ConversionPatternRewriter &rewriter,
+                                      triton::LoadOp op,
+                                      const BlockPointer &ptr,
+                                      RankedTensorType tensorTy,
+                                      ArrayRef<int32_t> boundaryCheck,
+                                      bool padNaN) const {
+    Type elemTy = tensorTy.getElementType();
+    Type llElemTy = getTypeConverter()->convertType(elemTy);
+    Value other;
+    if (padNaN && elemTy.isa<FloatType>())
+      other = bitcast(LLVM::createNaNConstant(loc, rewriter, elemTy), llElemTy);
+    else
+      other = rewriter.create<LLVM::ConstantOp>(loc, llElemTy,
+                                                rewriter.getZeroAttr(llElemTy));
+
+    SmallVector<Value> ptrElems, maskElems;
+    emitElementAddresses(loc, rewriter, ptr, tensorTy, boundaryCheck,
+                         ptrElems, maskElems);
+    std::optional<CacheControls> cacheControls = getCacheControls(op);
+    SmallVector<Value> loadedVals;
+    for (auto [ptrElem, maskElem] : llvm::zip(ptrElems, maskElems)) {
+      Block &endBlock = LLVM::createPredicatedBlock(
+          rewriter, loc, maskElem, SmallVector<Value, 1>{other}, [&]() {
+            Value addr = annotateCacheControls(loc, rewriter, op, ptrElem,
+                                               cacheControls);
+            Value ret = load(llElemTy, addr);
+            return SmallVector<Value, 1>{ret};
+          });
+      loadedVals.push_back(*endBlock.args_begin());
+    }
+    return loadedVals;
+  }
+};
+
+struct BlockPointerStoreOpConversion
+    : public BlockPointerConversionBase<triton::StoreOp> {
+  using BlockPointerConversionBase<
+      triton::StoreOp>::BlockPointerConversionBase;
+
+  // Block writes store at most 8 rows per lane.
+  static constexpr unsigned maxBlockHeight = 8;
+
+  LogicalResult
+  matchAndRewrite(triton::StoreOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isTensorPointerType(op.getPtr().getType()))
+      return failure();
+
+    auto loc = op->getLoc();
+    auto tensorTy = op.getValue().getType().cast<RankedTensorType>();
+    BlockPointer ptr = unpackBlockPointer(loc, adaptor.getPtr(),
+                                          tensorTy.getRank(), rewriter);
+    ArrayRef<int32_t> boundaryCheck =
+        op.getBoundaryCheck().value_or(ArrayRef<int32_t>());
+    auto valueElems =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getValue(), rewriter);
+
+    // Block writes drop out-of-bounds elements.
+    if (unsigned blockHeight =
+            getBlockIOHeight(tensorTy, maxBlockHeight, rewriter)) {
+      BlockSurface surface = getBlockSurface(loc, rewriter, ptr, tensorTy);
+      LLVM::createIfElseBlock(
+          rewriter, loc, surface.cond,
+          [&] {
+            emitBlockWrites(loc, rewriter, op, surface, tensorTy, blockHeight,
+                            valueElems);
+            return SmallVector<Value>();
+          },
+          [&] {
+            emitElementStores(loc, rewriter, op, ptr, tensorTy, boundaryCheck,
+                              valueElems);
+            return SmallVector<Value>();
+          });
+    } else {
+      emitElementStores(loc, rewriter, op, ptr, tensorTy, boundaryCheck,
+                        valueElems);
+    }
+    rewriter.eraseOp(op);
+    return success();
+  }
+
+private:
+  void emitBlockWrites(Location loc, ConversionPatternRewriter &rewriter,
+                       triton::StoreOp op, const BlockSurface &surface,
+                       RankedTensorType tensorTy, unsigned blockHeight,
+                       ArrayRef<Value> valueElems) const {
+    Type llElemTy =
+        getTypeConverter()->convertType(tensorTy.getElementType());
+    unsigned bitWidth = tensorTy.getElementTypeBitWidth();
+    unsigned cacheControl = getLSCCacheControl(getCacheControls(op));
+    Type blockTy = getBlockType(llElemTy, blockHeight, rewriter);
+    auto offsets = emitOffsetForLayout(tensorTy.getEncoding(), tensorTy);
+    // Gather the thread's elements into one vector per block.
+    std::map<std::pair<unsigned, unsigned>, Value> blocks;
+    for (auto [offset, elem] : llvm::zip(offsets, valueElems)) {
+      unsigned row = offset[0] % blockHeight;
+      auto key = std::make_pair(offset[0] - row, offset[1]);
+      Value &block = blocks[key];
+      if (blockHeight == 1)
+        block = elem;
+      else
+        block = insert_element(blockTy, block ? block : undef(blockTy), elem,
+                               i32_val(row));
+    }
+    for (auto &[key, block] : blocks) {
+      Value x = add(surface.x, i32_val(key.second));
+      Value y = add(surface.y, i32_val(key.first));
+      Value data =
+          bitcast(block, getBlockType(int_ty(bitWidth), blockHeight, rewriter));
+      emitBlockIO(loc, rewriter, op, surface, x, y, bitWidth, blockHeight,
+                  cacheControl, data);
+    }
+  }
+
+  void emitElementStores(Location loc, ConversionPatternRewriter &rewriter,
+                         triton::StoreOp op, const BlockPointer &ptr,
+                         RankedTensorType tensorTy,
+                         ArrayRef<int32_t> boundaryCheck,
+                         ArrayRef<Value> valueElems) const {
+    SmallVector<Value> ptrElems, maskElems;
+    emitElementAddresses(loc, rewriter, ptr, tensorTy, boundaryCheck,
+                         ptrElems, maskElems);
+    Value mask = getMask(tensorTy, rewriter, loc);
+    std::optional<CacheControls> cacheControls = getCacheControls(op);
+    for (auto [ptrElem, maskElem, valueElem] :
+         llvm::zip(ptrElems, maskElems, valueElems)) {
+      LLVM::createPredicatedBlock(rewriter, loc, and_(mask, maskElem), [&] {
+        store(valueElem, annotateCacheControls(loc, rewriter, op, ptrElem,
+                                               cacheControls));
+        return ArrayRef<Value>();
+      });
+    }
+  }
+};
+// Prefetches the block of a tensor pointer with 2D block prefetches, split
+// between the warps of the CTA regardless of the layout the block is later
+// loaded in. Prefetching is only a hint, so blocks that can't be prefetched
+// are skipped.
+template <typename SourceOp>
+struct BlockPointerPrefetchConversion
+    : public BlockPointerConversionBase<SourceOp> {
+  using Base = BlockPointerConversionBase<SourceOp>;
+  using Base::Base;
+  using typename Base::BlockPointer;
+  using typename Base::BlockSurface;
+  using OpAdaptor = typename SourceOp::Adaptor;
+
+  static constexpr unsigned maxBlockHeight = 32;
+
+  LogicalResult
+  matchAndRewrite(SourceOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isTensorPointerType(op.getPtr().getType()))
+      return failure();
+    auto loc = op->getLoc();
+    auto tensorTy = op.getPtr()
+                        .getType()
+                        .cast<triton::PointerType>()
+                        .getPointeeType()
+                        .cast<RankedTensorType>();
+    unsigned bitWidth = tensorTy.getElementTypeBitWidth();
+    auto mod = op->getParentOfType<ModuleOp>();
+    unsigned warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    if (tensorTy.getRank() != 2 || (bitWidth != 16 && bitWidth != 32) ||
+        warpSize != 16) {
+      rewriter.eraseOp(op);
+      return success();
+    }
+
+    auto shape = tensorTy.getShape();
+    BlockPointer ptr =
+        this->unpackBlockPointer(loc, adaptor.getPtr(), /*rank=*/2, rewriter);
+    // Without a layout, the surface starts at the block origin for all warps.
+    BlockSurface surface = this->getBlockSurface(
+        loc, rewriter, ptr,
+        RankedTensorType::get(shape, tensorTy.getElementType()));
+    unsigned blockHeight = std::min<int64_t>(shape[0], maxBlockHeight);
+    unsigned numBlocksX = ceil<int64_t>(shape[1], 16);
+    unsigned numBlocks = numBlocksX * ceil<int64_t>(shape[0], blockHeight);
+    unsigned numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
+    Value warpId = udiv(this->getThreadId(rewriter, loc), i32_val(warpSize));
+    unsigned cacheControl = getLSCCacheControl(getCacheControls(op));
+    LLVM::createPredicatedBlock(rewriter, loc, surface.cond, [&] {
+      for (unsigned i = 0; i < ceil(numBlocks, numWarps); ++i) {
+        Value blockId = add(warpId, i32_val(i * numWarps));
+        // Warps past the last block prefetch it again rather than branch.
+        if ((i + 1) * numWarps > numBlocks)
+          blockId = select(icmp_ult(blockId, i32_val(numBlocks)), blockId,
+                           i32_val(numBlocks - 1));
+        Value x = add(surface.x,
+                      mul(urem(blockId, i32_val(numBlocksX)), i32_val(16)));
+        Value y = add(surface.y, mul(udiv(blockId, i32_val(numBlocksX)),
+                                     i32_val(blockHeight)));
+        this->emitBlockPrefetch(loc, rewriter, op, surface, x, y, bitWidth,
+                                blockHeight, cacheControl);
+      }
+      return ArrayRef<Value>();
+    });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+// Prefetches a tensor of pointers, one prefetch per contiguous chunk of the
+// elements of each thread. Only NVIDIA and Intel GPUs have a lowering, the hint
+// is dropped elsewhere.
+struct PrefetchOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::PrefetchOp>,
+      public LoadStoreConversionBase {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::PrefetchOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  PrefetchOpConversion(TritonGPUToLLVMTypeConverter &converter,
+                       ModuleAxisInfoAnalysis &axisAnalysisPass,
+                       triton::Target target, PatternBenefit benefit)
+      : ConvertTritonGPUOpToLLVMPattern<triton::PrefetchOp>(converter, target,
+                                                            benefit),
+        LoadStoreConversionBase(axisAnalysisPass) {}
+
+  LogicalResult
+  matchAndRewrite(triton::PrefetchOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Value ptr = op.getPtr();
+    // Tensor pointers left by RewriteTensorPointer are only prefetched by
+    // BlockPointerPrefetchConversion on GENX.
+    if (target == triton::Target::ROCDL || isTensorPointerType(ptr.getType())) {
+      rewriter.eraseOp(op);
+      return success();
+    }
+
+    auto loc = op->getLoc();
+    unsigned vec = getVectorSize(ptr);
+    auto ptrElems =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getPtr(), rewriter);
+    Value llMask = adaptor.getMask();
+    if (llMask && isMaskAllTrue(op.getMask()))
+      llMask = Value();
+    SmallVector<Value> maskElems;
+    if (llMask) {
+      maskElems = getTypeConverter()->unpackLLElements(loc, llMask, rewriter);
+      assert(ptrElems.size() == maskElems.size());
+      maskElems = dedupMaskElems(op.getMask(), maskElems);
+      vec = std::min(vec, getMaskAlignment(op.getMask()));
+    }
+
+    Value mask = getMask(ptr.getType(), rewriter, loc);
+    unsigned elemBytes =
+        std::max<unsigned>(1, triton::getPointeeBitWidth(ptr.getType()) / 8);
+    for (size_t vecStart = 0; vecStart < ptrElems.size(); vecStart += vec) {
+      Value pred = llMask ? and_(mask, maskElems[vecStart]) : mask;
+      if (target == triton::Target::GENX)
+        emitGENXPrefetch(loc, rewriter, op, ptrElems[vecStart],
+                         vec * elemBytes, pred);
+      else
+        emitPTXPrefetch(loc, rewriter, op, ptrElems[vecStart], pred);
+    }
+    rewriter.eraseOp(op);
+    return success();
+  }
+
+private:
+  // Prefetches \p numBytes bytes at \p ptr with the OpenCL prefetch, whose
+  // caches are selected by a cache control decoration of the pointer.
+  void emitGENXPrefetch(Location loc, ConversionPatternRewriter &rewriter,
+                        triton::PrefetchOp op, Value ptr, unsigned numBytes,
+                        Value pred) const {
+    MLIRContext *ctx = rewriter.getContext();
+    LLVM::createPredicatedBlock(rewriter, loc, pred, [&] {
+      Value addr = bitcast(ptr, ptr_ty(ctx, 1 /*global*/));
+      addr = annotateCacheControls(loc, rewriter, op, addr,
+                                   getCacheControls(op));
+      SmallVector<Value> args{addr, i64_val(numBytes)};
+      SmallVector<Type> argTys{addr.getType(), i64_ty};
+      // void __spirv_ocl_prefetch(const __global char *p, size_t num_elements)
+      auto funcOp = getOrInsertSPIRFunction(
+          rewriter, op, "_Z20__spirv_ocl_prefetchPU3AS1Kcm", void_ty(ctx),
+          argTys);
+      auto callOp = call(funcOp, args);
+      callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+      return ArrayRef<Value>();
+    });
+  }
+
+  void emitPTXPrefetch(Location loc, ConversionPatternRewriter &rewriter,
+                       triton::PrefetchOp op, Value ptr, Value pred) const {
+    PTXBuilder ptxBuilder;
+    auto &prefetch =
+        ptxBuilder.create<>("prefetch")
+            ->global()
+            .o("L1", op.getCacheLevel() == triton::CacheLevel::L1)
+            .o("L2", op.getCacheLevel() == triton::CacheLevel::L2);
+    prefetch(ptxBuilder.newAddrOperand(ptr, "l")).predicate(pred, "b");
+    ptxBuilder.launch(rewriter, loc, void_ty(rewriter.getContext()));
+  }
+};
 } // namespace
 
 void mlir::triton::populateLoadStoreOpToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
     int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis,
     mlir::triton::gpu::TMAMetadataTy *tmaMetadata,
-    const TensorPtrMapT *tensorPtrMap, Target target, PatternBenefit benefit) {
+    const TensorPtrMapT *tensorPtrMap, Target target, PatternBenefit benefit,
+    bool aggregateAtomics) {
+  if (target == triton::Target::GENX) {
+    // Take precedence over LoadOpConversion/StoreOpConversion, which do not
+    // accept tensor pointers.
+    PatternBenefit blockPtrBenefit(benefit.getBenefit() + 1);
+    patterns.add<BlockPointerLoadOpConversion>(typeConverter, target,
+                                               blockPtrBenefit);
+    patterns.add<BlockPointerStoreOpConversion>(typeConverter, target,
+                                                blockPtrBenefit);
+    patterns.add<BlockPointerPrefetchConversion<triton::gpu::PrefetchTensorOp>>(
+        typeConverter, target, benefit);
+    patterns.add<BlockPointerPrefetchConversion<triton::PrefetchOp>>(
+        typeConverter, target, blockPtrBenefit);
+  }
+  patterns.add<PrefetchOpConversion>(typeConverter, axisInfoAnalysis, target,
+                                     benefit);
   patterns.add<LoadOpConversion>(typeConverter, axisInfoAnalysis, target,
                                  benefit);
   patterns.add<StoreOpConversion>(typeConverter, axisInfoAnalysis, target,
@@ -2070,7 +3463,7 @@ void mlir::triton::populateLoadStoreOpToLLVMPatterns(
   patterns.add<AtomicCASOpConversion>(typeConverter, axisInfoAnalysis, target,
                                       benefit);
   patterns.add<AtomicRMWOpConversion>(typeConverter, axisInfoAnalysis, target,
-                                      benefit);
+                                      aggregateAtomics, benefit);
   patterns.add<InsertSliceOpConversion>(typeConverter, target, benefit);
   patterns.add<InsertSliceAsyncOpConversion>(typeConverter, axisInfoAnalysis,
                                              target, benefit);
@@ -0,0 +1,100 @@
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Conversion/TritonGPUToLLVM/Passes.h"
+#include "llvm/ADT/BitVector.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+namespace mlir {
+namespace triton {
+#define GEN_PASS_DEF_PACKKERNELARGS
+#include "triton/Conversion/TritonGPUToLLVM/Passes.h.inc"
+} // namespace triton
+} // namespace mlir
+
+namespace {
+
+// The scalar types the launchers pass with the C type of the same size.
+bool isPackable(Type type) {
+  return type.isInteger(32) || type.isInteger(64) || type.isF32() ||
+         type.isF64();
+}
+
+struct PackKernelArgs
+    : public mlir::triton::impl::PackKernelArgsBase<PackKernelArgs> {
+  using PackKernelArgsBase<PackKernelArgs>::PackKernelArgsBase;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    MLIRContext *ctx = &getContext();
+    // the attribute of the module describes the arguments of one kernel
+    SmallVector<LLVM::LLVMFuncOp> kernels;
+    for (auto func : mod.getOps<LLVM::LLVMFuncOp>())
+      if (func.isPublic() && !func.isExternal())
+        kernels.push_back(func);
+    if (threshold <= 0 || kernels.size() != 1)
+      return;
+    LLVM::LLVMFuncOp kernel = kernels.front();
+
+    SmallVector<int32_t> packed;
+    for (auto [i, type] : llvm::enumerate(kernel.getArgumentTypes()))
+      if (isPackable(type))
+        packed.push_back(i);
+    if (packed.size() < static_cast<size_t>(std::max<int32_t>(threshold, 2)))
+      return;
+    auto bitWidth = [&](int32_t i) {
+      return kernel.getArgument(i).getType().getIntOrFloatBitWidth();
+    };
+    llvm::stable_sort(packed, [&](int32_t lhs, int32_t rhs) {
+      return bitWidth(lhs) > bitWidth(rhs);
+    });
+
+    SmallVector<Type> fieldTypes;
+    for (int32_t i : packed)
+      fieldTypes.push_back(kernel.getArgument(i).getType());
+    auto structTy = LLVM::LLVMStructType::getLiteral(ctx, fieldTypes);
+    auto ptrTy = LLVM::LLVMPointerType::get(ctx);
+    OpBuilder builder(ctx);
+    NamedAttrList argAttrs;
+    argAttrs.append(LLVM::LLVMDialect::getByValAttrName(),
+                    TypeAttr::get(structTy));
+    argAttrs.append(LLVM::LLVMDialect::getAlignAttrName(),
+                    builder.getI64IntegerAttr(bitWidth(packed.front()) / 8));
+    Location loc = kernel.getLoc();
+    kernel.insertArgument(0, ptrTy, argAttrs.getDictionary(ctx), loc);
+
+    builder.setInsertionPointToStart(&kernel.getBody().front());
+    Value base = kernel.getArgument(0);
+    llvm::BitVector erased(kernel.getNumArguments());
+    for (auto [field, i] : llvm::enumerate(packed)) {
+      BlockArgument arg = kernel.getArgument(i + 1);
+      SmallVector<LLVM::GEPArg> indices = {0, static_cast<int32_t>(field)};
+      Value addr =
+          builder.create<LLVM::GEPOp>(loc, ptrTy, structTy, base, indices);
+      arg.replaceAllUsesWith(
+          builder.create<LLVM::LoadOp>(loc, arg.getType(), addr));
+      erased.set(i + 1);
+    }
+    kernel.eraseArguments(erased);
+    mod->setAttr("triton_gpu.packed_args",
+                 builder.getDenseI32ArrayAttr(packed));
+  }
+};
+
+} // namespace
+
+namespace mlir {
+namespace triton {
+
+std::unique_ptr<OperationPass<ModuleOp>> createPackKernelArgsPass() {
+  return std::make_unique<PackKernelArgs>();
+}
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createPackKernelArgsPass(const PackKernelArgsOptions &options) {
+  return std::make_unique<PackKernelArgs>(options);
+}
+
+} // namespace triton
+} // namespace mlir
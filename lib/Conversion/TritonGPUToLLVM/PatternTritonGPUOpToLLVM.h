@@ -32,6 +32,18 @@ void populateElementwiseOpToLLVMPatterns(
     int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis,
     int computeCapability, Target target, PatternBenefit benefit);
 
+// Approximate native lowering of f32 transcendentals, registered on top of
+// populateElementwiseOpToLLVMPatterns when fast math is enabled on GENX.
+void populateGENXFastMathOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit);
+
+void populateGatherOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit);
+
 void populateHistogramOpToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
     int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
@@ -41,7 +53,8 @@ void populateLoadStoreOpToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
     int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis,
     mlir::triton::gpu::TMAMetadataTy *tmaMetadata,
-    const TensorPtrMapT *tensorPtrMap, Target target, PatternBenefit benefit);
+    const TensorPtrMapT *tensorPtrMap, Target target, PatternBenefit benefit,
+    bool aggregateAtomics = false);
 
 void populateReduceOpToLLVMPatterns(TritonGPUToLLVMTypeConverter &typeConverter,
                                     RewritePatternSet &patterns, int numWarps,
@@ -59,6 +72,11 @@ void populateScanOpToLLVMPatterns(TritonGPUToLLVMTypeConverter &typeConverter,
                                   ModuleAxisInfoAnalysis &axisInfoAnalysis,
                                   Target target, PatternBenefit benefit);
 
+void populateSortOpToLLVMPatterns(TritonGPUToLLVMTypeConverter &typeConverter,
+                                  RewritePatternSet &patterns, int numWarps,
+                                  ModuleAxisInfoAnalysis &axisInfoAnalysis,
+                                  Target target, PatternBenefit benefit);
+
 void populateTensorPtrOpsToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
     int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
@@ -74,6 +92,11 @@ void populateViewOpToLLVMPatterns(TritonGPUToLLVMTypeConverter &typeConverter,
                                   ModuleAxisInfoAnalysis &axisInfoAnalysis,
                                   Target target, PatternBenefit benefit);
 
+void populateWarpOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit);
+
 } // namespace triton
 } // namespace mlir
 
@@ -33,6 +33,11 @@ public:
     assert(helper.isSupportedLayout() &&
            "Unexpected srcLayout in ReduceOpConversion");
     Location loc = op->getLoc();
+    // Reductions whose axis is split across the CTAs of a cluster combine
+    // their partial results through distributed shared memory.
+    if (!helper.isReduceWithinCTA() && target != Target::NVVM)
+      return emitOptionalError(
+          loc, "cross-CTA reductions require thread block clusters");
 
     auto srcValues = unpackInputs(loc, op, adaptor, rewriter);
     std::map<SmallVector<unsigned>, SmallVector<Value>> accs;
@@ -138,7 +143,14 @@ private:
     // TODO[shuhaoj]: change hard code style of numThreads. Hide async_agent
     // attr.
     if (getWSAgentId(op)) {
-      barSync(rewriter, op, getAgentIds(op).front(), 128);
+      if (target == Target::GENX) {
+        Value barId = i32_val(getAgentIds(op).front());
+        LLVM::createGENXNamedBarrierSignal(loc, rewriter, op, barId,
+                                           i32_val(128));
+        LLVM::createGENXNamedBarrierWait(loc, rewriter, op, barId);
+      } else {
+        barSync(rewriter, op, getAgentIds(op).front(), 128);
+      }
     } else {
       barrier();
     }
@@ -181,6 +193,30 @@ private:
     return std::nullopt;
   }
 
+  // Reduce across \p numLaneToReduce contiguous lanes with a sub-group
+  // reduction built-in, clustered if fewer than all the lanes of the
+  // sub-group take part. Return false if the reduction does not match one.
+  bool emitSubgroupReduce(ConversionPatternRewriter &rewriter, Location loc,
+                          SmallVector<Value> &acc, triton::ReduceOp op,
+                          unsigned numLaneToReduce,
+                          unsigned interleave) const {
+    if (op.getNumOperands() != 1 || interleave != 1 || numLaneToReduce < 2)
+      return false;
+    auto kind = LLVM::matchSPIRVGroupOp(op.getCombineOp(), acc[0].getType());
+    if (!kind)
+      return false;
+    auto mod = op->getParentOfType<ModuleOp>();
+    unsigned warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    if (numLaneToReduce < warpSize)
+      acc[0] = LLVM::createSPIRVGroupOp(
+          loc, rewriter, op, *kind, spirv::GroupOperation::ClusteredReduce,
+          acc[0], numLaneToReduce);
+    else
+      acc[0] = LLVM::createSPIRVGroupOp(loc, rewriter, op, *kind,
+                                        spirv::GroupOperation::Reduce, acc[0]);
+    return true;
+  }
+
   // Reduce along op axis for elements that are in the same thread. The
   // accumulated value is stored in accs.
   void reduceWithinThreads(
@@ -208,12 +244,13 @@ private:
     }
   }
 
-  // Apply warp reduction across the given number of contiguous lanes using op
-  // region and the accumulator values as source.
-  void warpReduce(ConversionPatternRewriter &rewriter, Location loc,
-                  SmallVector<Value> &acc, triton::ReduceOp op,
-                  unsigned numLaneToReduce, unsigned interleave,
-                  Target target) const {
+  // Reduce across \p numLaneToReduce contiguous lanes with a redux op or a
+  // sub-group reduction built-in. Return false if the reduction does not match
+  // one.
+  bool emitNativeWarpReduce(ConversionPatternRewriter &rewriter, Location loc,
+                            SmallVector<Value> &acc, triton::ReduceOp op,
+                            unsigned numLaneToReduce, unsigned interleave,
+                            Target target) const {
     if (target != Target::GENX) {
       if (auto kind = matchReduxKind(op)) {
         // Based on benchmarking on A100 redux op gives a speed up only when
@@ -248,20 +285,97 @@ private:
             if (bitwidth < 32)
               acc[i] = trunc(int_ty(bitwidth), acc[i]);
           }
-          return;
+          return true;
         }
       }
+      return false;
+    }
+    return emitSubgroupReduce(rewriter, loc, acc, op, numLaneToReduce,
+                              interleave);
+  }
+
+  // Exchange \p values with the lanes \p offset away. Pairs of 16-bit values
+  // share one 32-bit shuffle.
+  SmallVector<Value> shuffleXor(ConversionPatternRewriter &rewriter,
+                                Location loc, ArrayRef<Value> values,
+                                unsigned offset, Target target) const {
+    SmallVector<Value> results(values.size());
+    auto is16Bit = [](Value v) {
+      Type ty = v.getType();
+      return ty.isIntOrFloat() && ty.getIntOrFloatBitWidth() == 16;
+    };
+    auto toI16 = [&](Value v) {
+      return v.getType() == i16_ty ? v : bitcast(v, i16_ty);
+    };
+    auto fromI16 = [&](Value v, Type ty) {
+      return ty == i16_ty ? v : bitcast(v, ty);
+    };
+    std::optional<unsigned> unpaired;
+    for (unsigned i = 0; i < values.size(); ++i) {
+      if (!is16Bit(values[i])) {
+        results[i] = shflSync(loc, rewriter, values[i], offset, target);
+        continue;
+      }
+      if (!unpaired) {
+        unpaired = i;
+        continue;
+      }
+      unsigned j = *unpaired;
+      unpaired.reset();
+      auto vecTy = vec_ty(i16_ty, 2);
+      Value packed = undef(vecTy);
+      packed = insert_element(vecTy, packed, toI16(values[j]), i32_val(0));
+      packed = insert_element(vecTy, packed, toI16(values[i]), i32_val(1));
+      Value shuffled =
+          shflSync(loc, rewriter, bitcast(packed, i32_ty), offset, target);
+      shuffled = bitcast(shuffled, vecTy);
+      results[j] = fromI16(extract_element(i16_ty, shuffled, i32_val(0)),
+                           values[j].getType());
+      results[i] = fromI16(extract_element(i16_ty, shuffled, i32_val(1)),
+                           values[i].getType());
     }
+    if (unpaired)
+      results[*unpaired] =
+          shflSync(loc, rewriter, values[*unpaired], offset, target);
+    return results;
+  }
 
+  // Butterfly reduction of the accumulators of independent rows across
+  // \p numLaneToReduce contiguous lanes. Each step issues the shuffles of all
+  // the rows before combining any of them, so that their latencies overlap
+  // instead of adding up.
+  void butterflyReduce(ConversionPatternRewriter &rewriter, Location loc,
+                       ArrayRef<SmallVector<Value> *> accs, triton::ReduceOp op,
+                       unsigned numLaneToReduce, unsigned interleave,
+                       Target target) const {
     for (unsigned N = numLaneToReduce / 2; N > 0; N >>= 1) {
-      SmallVector<Value> shfl(acc.size());
-      for (unsigned i = 0; i < acc.size(); ++i) {
-        shfl[i] = shflSync(loc, rewriter, acc[i], N * interleave, target);
+      SmallVector<Value> values;
+      for (SmallVector<Value> *acc : accs)
+        values.append(acc->begin(), acc->end());
+      SmallVector<Value> shfl =
+          shuffleXor(rewriter, loc, values, N * interleave, target);
+      auto cur = shfl.begin();
+      for (SmallVector<Value> *acc : accs) {
+        SmallVector<Value> accShfl(cur, cur + acc->size());
+        cur += acc->size();
+        accumulate(rewriter, op.getCombineOp(), *acc, accShfl, false);
       }
-      accumulate(rewriter, op.getCombineOp(), acc, shfl, false);
     }
   }
 
+  // Apply warp reduction across the given number of contiguous lanes using op
+  // region and the accumulator values as source.
+  void warpReduce(ConversionPatternRewriter &rewriter, Location loc,
+                  SmallVector<Value> &acc, triton::ReduceOp op,
+                  unsigned numLaneToReduce, unsigned interleave,
+                  Target target) const {
+    if (emitNativeWarpReduce(rewriter, loc, acc, op, numLaneToReduce,
+                             interleave, target))
+      return;
+    butterflyReduce(rewriter, loc, {&acc}, op, numLaneToReduce, interleave,
+                    target);
+  }
+
   // Reduce across threads within each warp.
   void
   reduceWithinWarps(ReduceOpHelper &helper,
@@ -271,12 +385,16 @@ private:
     unsigned sizeIntraWarps = helper.getIntraWarpSizeWithUniqueData();
     unsigned threadOffsetOnReductionAxis =
         helper.getThreadOffsetOnReductionAxis();
-    for (auto it : accs) {
-      const SmallVector<unsigned> &key = it.first;
-      SmallVector<Value> &acc = accs[key];
-      warpReduce(rewriter, op.getLoc(), acc, op, sizeIntraWarps,
-                 threadOffsetOnReductionAxis, target);
+    // The rows are reduced together so that their shuffles interleave.
+    SmallVector<SmallVector<Value> *> rows;
+    for (auto &it : accs) {
+      SmallVector<Value> &acc = it.second;
+      if (!emitNativeWarpReduce(rewriter, op.getLoc(), acc, op, sizeIntraWarps,
+                                threadOffsetOnReductionAxis, target))
+        rows.push_back(&acc);
     }
+    butterflyReduce(rewriter, op.getLoc(), rows, op, sizeIntraWarps,
+                    threadOffsetOnReductionAxis, target);
   }
 
   // Pack the accumulator values and replace the reduce op with the result.
@@ -284,9 +402,8 @@ private:
                    std::map<SmallVector<unsigned>, SmallVector<Value>> &accs,
                    ConversionPatternRewriter &rewriter) const {
     triton::ReduceOp op = helper.getOperation();
-    Location loc = op.getLoc();
     unsigned axis = op.getAxis();
-    SmallVector<Value> results(op.getNumOperands());
+    SmallVector<SmallVector<Value>> resultVals(op.getNumOperands());
     for (unsigned i = 0; i < op.getNumOperands(); ++i) {
       if (auto resultTy =
               op.getResult()[i].getType().dyn_cast<RankedTensorType>()) {
@@ -294,20 +411,112 @@ private:
         unsigned resultElems = getTotalElemsPerThread(resultTy);
         SmallVector<SmallVector<unsigned>> resultOffset =
             emitOffsetForLayout(resultLayout, resultTy);
-        SmallVector<Value> resultVals;
         for (int j = 0; j < resultElems; j++) {
           auto key = resultOffset[j];
           key.insert(key.begin() + axis, 0);
-          resultVals.push_back(accs[key][i]);
+          resultVals[i].push_back(accs[key][i]);
         }
-        results[i] = getTypeConverter()->packLLElements(loc, resultVals,
-                                                        rewriter, resultTy);
       } else
-        results[i] = accs.begin()->second[i];
+        resultVals[i].push_back(accs.begin()->second[i]);
+    }
+    replaceWithResults(helper, resultVals, rewriter);
+  }
+
+  // Replace the reduce op with the per-thread result values, after combining
+  // the partial results of the CTAs the reduction axis is split across.
+  void replaceWithResults(ReduceOpHelper &helper,
+                          SmallVector<SmallVector<Value>> &resultVals,
+                          ConversionPatternRewriter &rewriter) const {
+    triton::ReduceOp op = helper.getOperation();
+    Location loc = op.getLoc();
+    if (!helper.isReduceWithinCTA())
+      reduceAcrossCTAs(helper, resultVals, rewriter);
+    SmallVector<Value> results(op.getNumOperands());
+    for (unsigned i = 0; i < op.getNumOperands(); ++i) {
+      if (auto resultTy =
+              op.getResult()[i].getType().dyn_cast<RankedTensorType>())
+        results[i] = getTypeConverter()->packLLElements(loc, resultVals[i],
+                                                        rewriter, resultTy);
+      else
+        results[i] = resultVals[i][0];
     }
     rewriter.replaceOp(op, results);
   }
 
+  // Every CTA stores the partial results of its slice of the reduction axis
+  // to its scratch buffer. After a cluster barrier, each of them accumulates
+  // the buffers of all the CTAs along the axis through distributed shared
+  // memory, in the same order, so that they all end up with the same result.
+  void reduceAcrossCTAs(ReduceOpHelper &helper,
+                        SmallVector<SmallVector<Value>> &resultVals,
+                        ConversionPatternRewriter &rewriter) const {
+    triton::ReduceOp op = helper.getOperation();
+    Location loc = op.getLoc();
+    unsigned axis = op.getAxis();
+    auto srcLayout = helper.getSrcLayout();
+    auto CTASplitNum = triton::gpu::getCTASplitNum(srcLayout);
+    auto CTAsPerCGA = triton::gpu::getCTAsPerCGA(srcLayout);
+    auto CTAOrder = triton::gpu::getCTAOrder(srcLayout);
+
+    // Offsets of the result values in the scratch buffer of each CTA.
+    SmallVector<Value> offsets;
+    unsigned elems = 1;
+    if (auto resultTy =
+            op.getResult()[0].getType().dyn_cast<RankedTensorType>()) {
+      auto shapePerCTA =
+          convertType<unsigned, int64_t>(triton::gpu::getShapePerCTA(resultTy));
+      elems = product<unsigned>(shapePerCTA);
+      auto resultIndices = emitIndices(loc, rewriter, resultTy.getEncoding(),
+                                       resultTy, /*withCTAOffset*/ false);
+      for (const auto &index : resultIndices)
+        offsets.push_back(linearize(rewriter, loc, index, shapePerCTA));
+    } else {
+      offsets.push_back(i32_val(0));
+    }
+
+    // The scratch buffer may still be read by other threads of this CTA.
+    sync(rewriter, loc, op);
+    SmallVector<Value> smemBases = getSmemBases(op, elems, rewriter, target);
+    for (unsigned i = 0; i < op.getNumOperands(); ++i) {
+      auto elemTy = getElementType(op, i);
+      for (unsigned j = 0; j < offsets.size(); ++j) {
+        Value ptr = gep(ptr_ty(rewriter.getContext(), 3), elemTy, smemBases[i],
+                        offsets[j]);
+        store(resultVals[i][j], ptr);
+      }
+    }
+
+    rewriter.create<triton::nvidia_gpu::ClusterArriveOp>(loc, false);
+    rewriter.create<triton::nvidia_gpu::ClusterWaitOp>(loc);
+
+    // The partial results of the j-th slice of the axis are held by the CTA
+    // with the same coordinates as this one, except for the axis.
+    SmallVector<Value> multiDimCTAId = delinearize(
+        rewriter, loc, getClusterCTAId(rewriter, loc), CTAsPerCGA, CTAOrder);
+    for (unsigned j = 0; j < offsets.size(); ++j) {
+      SmallVector<Value> acc(op.getNumOperands());
+      for (unsigned c = 0; c < CTASplitNum[axis]; ++c) {
+        multiDimCTAId[axis] = i32_val(c);
+        Value remoteCTAId =
+            linearize(rewriter, loc, multiDimCTAId, CTAsPerCGA, CTAOrder);
+        SmallVector<Value> cur(op.getNumOperands());
+        for (unsigned i = 0; i < op.getNumOperands(); ++i) {
+          auto elemTy = getElementType(op, i);
+          Value ptr = gep(ptr_ty(rewriter.getContext(), 3), elemTy,
+                          smemBases[i], offsets[j]);
+          cur[i] = load_dsmem(ptr, remoteCTAId, elemTy);
+        }
+        accumulate(rewriter, op.getCombineOp(), acc, cur, c == 0);
+      }
+      for (unsigned i = 0; i < op.getNumOperands(); ++i)
+        resultVals[i][j] = acc[i];
+    }
+
+    // Keep the scratch buffers alive until all the CTAs have read them.
+    rewriter.create<triton::nvidia_gpu::ClusterArriveOp>(loc, false);
+    rewriter.create<triton::nvidia_gpu::ClusterWaitOp>(loc);
+  }
+
   SmallVector<Value>
   getMultiDimWarpId(ReduceOpHelper &helper, Value &warpId, Location &loc,
                     ConversionPatternRewriter &rewriter) const {
@@ -453,7 +662,7 @@ private:
     auto srcLayout = helper.getSrcLayout();
     auto axis = op.getAxis();
     auto smemOrder = helper.getOrderWithAxisAtBeginning();
-    SmallVector<Value> results(op.getNumOperands());
+    SmallVector<SmallVector<Value>> resultVals(op.getNumOperands());
     for (unsigned i = 0; i < op.getNumOperands(); ++i) {
       auto elemTy = getElementType(op, i);
       if (auto resultTy =
@@ -465,7 +674,7 @@ private:
             emitIndices(loc, rewriter, resultLayout, resultTy, true);
         assert(resultIndices.size() == resultElems);
 
-        SmallVector<Value> resultVals(resultElems);
+        resultVals[i].resize(resultElems);
         for (size_t j = 0; j < resultElems; ++j) {
           SmallVector<Value> readIdx = resultIndices[j];
           readIdx.insert(readIdx.begin() + op.getAxis(), i32_val(0));
@@ -473,17 +682,14 @@ private:
               linearize(rewriter, loc, readIdx, smemShape, smemOrder);
           Value readPtr = gep(ptr_ty(rewriter.getContext(), 3), elemTy,
                               smemBases[i], readOffset);
-          resultVals[j] = load(elemTy, readPtr);
+          resultVals[i][j] = load(elemTy, readPtr);
         }
-
-        results[i] = getTypeConverter()->packLLElements(loc, resultVals,
-                                                        rewriter, resultTy);
       } else {
         // 0d-tensor -> scalar
-        results[i] = load(elemTy, smemBases[i]);
+        resultVals[i].push_back(load(elemTy, smemBases[i]));
       }
     }
-    rewriter.replaceOp(op, results);
+    replaceWithResults(helper, resultVals, rewriter);
   }
 };
 } // namespace
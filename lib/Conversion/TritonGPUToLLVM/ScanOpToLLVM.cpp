@@ -78,11 +78,25 @@ static void warpScan(SmallVector<SmallVector<Value>> &srcValues,
   unsigned elementStride = helper.getAxisElementStride();
   unsigned threadStride = helper.getAxisThreadStride();
   unsigned scanDim = helper.getAxisNumThreadsPerWarpWithUniqueData();
+  // On GENX a scan over the whole sub-group is a single built-in.
+  std::optional<LLVM::SPIRVGroupOpKind> groupOp;
+  unsigned warpSize =
+      product<unsigned>(triton::gpu::getThreadsPerWarp(helper.getEncoding()));
+  if (target == Target::GENX && helper.getNumOperands() == 1 &&
+      threadStride == 1 && scanDim == warpSize)
+    groupOp = LLVM::matchSPIRVGroupOp(helper.getCombineOp(),
+                                      srcValues[0][0].getType());
   for (unsigned srcIndex = 0; srcIndex < srcValues.size(); srcIndex++) {
     unsigned elementIdx = (srcIndex / elementStride) % scanElementsPerThreads;
     // Only consider the last element of each contiguous chunk of elements.
     if (elementIdx != scanElementsPerThreads - 1)
       continue;
+    if (groupOp) {
+      srcValues[srcIndex][0] = LLVM::createSPIRVGroupOp(
+          loc, rewriter, helper.getOperation(), *groupOp,
+          spirv::GroupOperation::InclusiveScan, srcValues[srcIndex][0]);
+      continue;
+    }
     // Reduce within warps.
     SmallVector<Value> acc = srcValues[srcIndex];
     for (unsigned i = 1; i <= scanDim / 2; i <<= 1) {
@@ -0,0 +1,183 @@
+#include "PatternTritonGPUOpToLLVM.h"
+#include "Utility.h"
+
+#include <map>
+
+using namespace mlir;
+using namespace mlir::triton;
+
+using ::mlir::LLVM::shflSync;
+using ::mlir::triton::gpu::BlockedEncodingAttr;
+using ::mlir::triton::gpu::getOrder;
+using ::mlir::triton::gpu::getShapePerCTA;
+
+namespace {
+// Lowers tt.sort to a bitonic sorting network over the elements of the axis.
+// Each compare-exchange step pairs the elements whose index along the axis
+// differs by one bit, and the layout decides where the partner lives: steps
+// on the bits held by a thread are compare-exchanges between registers, the
+// ones on the bits spread over the lanes of a warp are shuffles, and only the
+// ones on the bits spread over the warps go through shared memory.
+struct SortOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::SortOp> {
+public:
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::SortOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  enum class BitKind { Register, Lane, Warp };
+
+  LogicalResult
+  matchAndRewrite(triton::SortOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto layout = srcTy.getEncoding().dyn_cast<BlockedEncodingAttr>();
+    unsigned axis = op.getAxis();
+    // Exchanges between CTAs would need distributed shared memory.
+    if (!layout || triton::gpu::getCTASplitNum(layout)[axis] != 1)
+      return failure();
+    Type elemTy = getTypeConverter()->convertType(srcTy.getElementType());
+    // Floats stored as integers, e.g. fp8, would not compare as floats.
+    if (srcTy.getElementType().isa<FloatType>() != elemTy.isa<FloatType>())
+      return failure();
+
+    SmallVector<Value> vals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    auto shapePerCTA = getShapePerCTA(srcTy);
+    unsigned axisSize = shapePerCTA[axis];
+    unsigned sizePerThread = layout.getSizePerThread()[axis];
+    unsigned threadsPerWarp = layout.getThreadsPerWarp()[axis];
+    unsigned warpsPerCTA = layout.getWarpsPerCTA()[axis];
+
+    auto kindOf = [&](unsigned bit) {
+      if (bit < sizePerThread ||
+          bit >= sizePerThread * threadsPerWarp * warpsPerCTA)
+        return BitKind::Register;
+      if (bit < sizePerThread * threadsPerWarp)
+        return BitKind::Lane;
+      return BitKind::Warp;
+    };
+
+    // The lanes along the axis are strided by the lanes of the dimensions
+    // that are faster in the layout order.
+    unsigned laneStride = 1;
+    for (unsigned d : getOrder(layout)) {
+      if (d == axis)
+        break;
+      laneStride *= layout.getThreadsPerWarp()[d];
+    }
+
+    // The offsets of the registers only differ on the register bits, so the
+    // partner of a register along such a bit is looked up from its offsets.
+    auto offsets = emitOffsetForLayout(layout, srcTy);
+    std::map<SmallVector<unsigned>, unsigned> regOfOffset;
+    for (unsigned reg = 0; reg < offsets.size(); ++reg) {
+      SmallVector<unsigned> key = offsets[reg];
+      key[axis] %= axisSize;
+      regOfOffset.emplace(key, reg);
+    }
+    auto partnerReg = [&](unsigned reg, unsigned bit) {
+      SmallVector<unsigned> key = offsets[reg];
+      key[axis] = (key[axis] % axisSize) ^ bit;
+      return regOfOffset.at(key);
+    };
+
+    auto indices = emitIndices(loc, rewriter, layout, srcTy, false);
+    // Whether the index of the element in \p reg along the axis has \p bit
+    // set, known at compile time for the register bits.
+    auto hasBit = [&](unsigned reg, unsigned bit) -> Value {
+      if (kindOf(bit) == BitKind::Register)
+        return int_val(1, (offsets[reg][axis] & bit) != 0);
+      return icmp_ne(and_(indices[reg][axis], i32_val(bit)), i32_val(0));
+    };
+
+    // Offsets of the elements in the shared memory, where the tensor is
+    // stored row major.
+    SmallVector<Value> smemOffsets;
+    unsigned axisStride = 1;
+    Value smemBase;
+    if (triton::gpu::getWarpsPerCTAWithUniqueData(
+            layout, srcTy.getShape())[axis] > 1) {
+      smemBase =
+          LLVM::getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
+      for (unsigned d = axis + 1; d < shapePerCTA.size(); ++d)
+        axisStride *= shapePerCTA[d];
+      for (unsigned reg = 0; reg < vals.size(); ++reg) {
+        Value offset = i32_val(0);
+        unsigned stride = 1;
+        for (int d = shapePerCTA.size() - 1; d >= 0; --d) {
+          Value idx = and_(indices[reg][d], i32_val(shapePerCTA[d] - 1));
+          offset = add(offset, mul(idx, i32_val(stride)));
+          stride *= shapePerCTA[d];
+        }
+        smemOffsets.push_back(offset);
+      }
+    }
+
+    Value descending = int_val(1, op.getDescending());
+    bool smemInUse = false;
+    for (unsigned k = 2; k <= axisSize; k *= 2) {
+      for (unsigned j = k / 2; j > 0; j /= 2) {
+        SmallVector<Value> partners(vals.size());
+        switch (kindOf(j)) {
+        case BitKind::Register:
+          for (unsigned reg = 0; reg < vals.size(); ++reg)
+            partners[reg] = vals[partnerReg(reg, j)];
+          break;
+        case BitKind::Lane:
+          for (unsigned reg = 0; reg < vals.size(); ++reg)
+            partners[reg] = shflSync(loc, rewriter, vals[reg],
+                                     (j / sizePerThread) * laneStride, target);
+          break;
+        case BitKind::Warp:
+          // Wait for the loads of the previous exchange before overwriting.
+          if (smemInUse)
+            barrier();
+          for (unsigned reg = 0; reg < vals.size(); ++reg) {
+            Value ptr =
+                gep(smemBase.getType(), elemTy, smemBase, smemOffsets[reg]);
+            store(vals[reg], ptr);
+          }
+          barrier();
+          for (unsigned reg = 0; reg < vals.size(); ++reg) {
+            Value offset = xor_(smemOffsets[reg], i32_val(j * axisStride));
+            Value ptr = gep(smemBase.getType(), elemTy, smemBase, offset);
+            partners[reg] = load(elemTy, ptr);
+          }
+          smemInUse = true;
+          break;
+        }
+
+        for (unsigned reg = 0; reg < vals.size(); ++reg) {
+          // The blocks of k elements are sorted in alternating directions,
+          // except in the last merge which gives the requested order.
+          Value desc = k == axisSize ? descending : hasBit(reg, k);
+          // Both elements of a pair compare them in the same order so that
+          // they agree on whether to swap.
+          Value isUpper = hasBit(reg, j);
+          Value lo = select(isUpper, partners[reg], vals[reg]);
+          Value hi = select(isUpper, vals[reg], partners[reg]);
+          Value greater;
+          if (elemTy.isa<FloatType>())
+            greater = fcmp_ogt(lo, hi);
+          else
+            greater = icmp_sgt(lo, hi);
+          vals[reg] = select(xor_(greater, desc), partners[reg], vals[reg]);
+        }
+      }
+    }
+
+    Value result =
+        getTypeConverter()->packLLElements(loc, vals, rewriter, srcTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+} // namespace
+
+void mlir::triton::populateSortOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit) {
+  patterns.add<SortOpConversion>(typeConverter, target, benefit);
+}
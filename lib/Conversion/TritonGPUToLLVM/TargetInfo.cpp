@@ -0,0 +1,187 @@
+#include "TargetInfo.h"
+#include "Utility.h"
+#include "mlir/Dialect/LLVMIR/GENXDialect.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+namespace {
+
+// NVVM, also used for ROCDL until its forked lowering moves to these hooks.
+class NVVMTargetInfo : public TargetInfoBase {
+public:
+  Value getStackPointer(PatternRewriter &rewriter,
+                        FunctionOpInterface funcOp) const override {
+    auto mod = funcOp->getParentOfType<ModuleOp>();
+    LLVM::GlobalOp globalBase = nullptr;
+    mod.walk([&](LLVM::GlobalOp op) {
+      if (op.getSymName() == "global_smem")
+        globalBase = op;
+    });
+    assert(globalBase);
+    if (LLVM::isKernel(funcOp))
+      return rewriter.create<LLVM::AddressOfOp>(funcOp.getLoc(), globalBase);
+    return funcOp.getArgument(funcOp.getNumArguments() - 1);
+  }
+
+  void storeShared(ConversionPatternRewriter &rewriter, Location loc,
+                   Value ptr, Value val, Value pred) const override {
+    MLIRContext *ctx = rewriter.getContext();
+    unsigned bits = std::max(8u, val.getType().getIntOrFloatBitWidth());
+    const char *c = bits == 64 ? "l" : (bits == 16 ? "h" : "r");
+
+    PTXBuilder builder;
+    auto *ptrOpr = builder.newAddrOperand(ptr, "r");
+    auto *valOpr = builder.newOperand(val, c);
+    auto &st = builder.create<>("st")->shared().b(bits);
+    st(ptrOpr, valOpr).predicate(pred, "b");
+    builder.launch(rewriter, loc, void_ty(ctx));
+  }
+
+  Value loadShared(ConversionPatternRewriter &rewriter, Location loc,
+                   Value ptr, Type elemTy, Value pred) const override {
+    auto ptrTy = ptr.getType().cast<LLVM::LLVMPointerType>();
+    assert(ptrTy.getAddressSpace() == 3 && "Invalid addr space for loadShared");
+    unsigned bitwidth = std::max(8u, elemTy.getIntOrFloatBitWidth());
+
+    const char *c = bitwidth == 64 ? "=l" : (bitwidth == 16 ? "=h" : "=r");
+
+    PTXBuilder builder;
+    auto *dOpr = builder.newOperand(c);
+    auto *ptrOpr = builder.newAddrOperand(ptr, "r");
+    auto &ld = builder.create<>("ld")->shared().b(bitwidth);
+    ld(dOpr, ptrOpr).predicate(pred, "b");
+    return builder.launch(rewriter, loc, elemTy);
+  }
+
+  Value shuffle(ConversionPatternRewriter &rewriter, Location loc, Value val,
+                Value i, NVVM::ShflKind mode, Value clamp) const override {
+    Type type = val.getType();
+    unsigned bits = type.getIntOrFloatBitWidth();
+    if (type != i32_ty) {
+      val = bitcast(val, int_ty(bits));
+      if (bits < 32)
+        val = zext(i32_ty, val);
+    }
+    Value mask = i32_val(0xFFFFFFFF);
+    Value result = rewriter.create<NVVM::ShflOp>(loc, i32_ty, mask, val, i,
+                                                 clamp, mode, UnitAttr());
+    if (type != i32_ty) {
+      if (bits < 32)
+        result = trunc(int_ty(bits), result);
+      result = bitcast(result, type);
+    }
+    return result;
+  }
+
+  Value ballot(ConversionPatternRewriter &rewriter, Location loc, Value pred,
+               int threadMask, int numThreadsPerWarp) const override {
+    return rewriter.create<NVVM::VoteBallotOp>(loc, i32_ty,
+                                               i32_val(threadMask), pred);
+  }
+
+  void namedBarrier(ConversionPatternRewriter &rewriter, Location loc,
+                    Operation *op, unsigned barId,
+                    unsigned numThreads) const override {
+    // llvm.nvvm.barrier0 doesn't support bar_id and num_threads attributes,
+    // so we have to lower it to ptx manually.
+    barSync(rewriter, op, barId, numThreads);
+  }
+};
+
+class GENXTargetInfo : public TargetInfoBase {
+public:
+  Value getStackPointer(PatternRewriter &rewriter,
+                        FunctionOpInterface funcOp) const override {
+    auto mod = funcOp->getParentOfType<ModuleOp>();
+    LLVM::LLVMPointerType ptrTy =
+        ptr_ty(rewriter.getContext(), GENX::GENXMemorySpace::kWorkgroup);
+    if (mod->getAttrOfType<IntegerAttr>("triton_gpu.shared").getInt() == 0)
+      return rewriter.create<LLVM::UndefOp>(funcOp.getLoc(), ptrTy);
+    return funcOp.getArgument(funcOp.getNumArguments() - 1);
+  }
+
+  void storeShared(ConversionPatternRewriter &rewriter, Location loc,
+                   Value ptr, Value val, Value pred) const override {
+    LLVM::createPredicatedBlock(rewriter, loc, pred, [&] {
+      store(val, ptr);
+      return ArrayRef<Value>();
+    });
+  }
+
+  Value loadShared(ConversionPatternRewriter &rewriter, Location loc,
+                   Value ptr, Type elemTy, Value pred) const override {
+    assert(ptr.getType().cast<LLVM::LLVMPointerType>().getAddressSpace() ==
+               3 &&
+           "Invalid addr space for loadShared");
+    Value undef = undef(elemTy);
+    Block &endBlock = LLVM::createPredicatedBlock(
+        rewriter, loc, pred, SmallVector<Value, 1>{undef}, [&] {
+          Value ret = load(elemTy, ptr);
+          return SmallVector<Value, 1>{ret};
+        });
+    return *endBlock.args_begin();
+  }
+
+  Value shuffle(ConversionPatternRewriter &rewriter, Location loc, Value val,
+                Value i, NVVM::ShflKind mode, Value clamp) const override {
+    return rewriter.create<GENX::SubGroupShuffleOp>(loc, val.getType(), val, i,
+                                                    toGenXShuffleMode(mode));
+  }
+
+  Value ballot(ConversionPatternRewriter &rewriter, Location loc, Value pred,
+               int threadMask, int numThreadsPerWarp) const override {
+    assert(threadMask == -1 && "unsupported thread mask for GENX target");
+    assert(numThreadsPerWarp <= 32 && "ballot must fit in 32 bits");
+
+    // OpGroupNonUniformBallot returns the ballot of the sub-group as a
+    // 128-bit vector; with at most 32 lanes only the first component is set.
+    std::string name = "__spirv_GroupNonUniformBallot";
+    std::string mangledName = "_Z" + std::to_string(name.size()) + name + "ib";
+    Type ballotTy = vec_ty(i32_ty, 4);
+    Operation *op = rewriter.getInsertionBlock()->getParentOp();
+    auto funcOp = LLVM::getOrInsertSPIRFunction(rewriter, op, mangledName,
+                                                ballotTy, {i32_ty, i1_ty});
+    auto callOp = call(funcOp, ValueRange{i32_val(3 /*Subgroup*/), pred});
+    callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+    return extract_element(i32_ty, callOp.getResult(), i32_val(0));
+  }
+
+  void namedBarrier(ConversionPatternRewriter &rewriter, Location loc,
+                    Operation *op, unsigned barId,
+                    unsigned numThreads) const override {
+    LLVM::createGENXNamedBarrierSignal(loc, rewriter, op, i32_val(barId),
+                                       i32_val(numThreads));
+    LLVM::createGENXNamedBarrierWait(loc, rewriter, op, i32_val(barId));
+  }
+
+private:
+  static GENX::ShflKind toGenXShuffleMode(NVVM::ShflKind mode) {
+    switch (mode) {
+    case NVVM::ShflKind::bfly:
+      return GENX::ShflKind::XOR;
+    case NVVM::ShflKind::up:
+      return GENX::ShflKind::UP;
+    case NVVM::ShflKind::down:
+      return GENX::ShflKind::DOWN;
+    case NVVM::ShflKind::idx:
+      return GENX::ShflKind::IDX;
+    }
+    llvm_unreachable("unsupported NVVM::ShflKind");
+  }
+};
+
+} // namespace
+
+const TargetInfoBase &mlir::triton::getTargetInfo(Target target) {
+  static const NVVMTargetInfo nvvmTargetInfo;
+  static const GENXTargetInfo genxTargetInfo;
+  switch (target) {
+  case Target::ROCDL:
+  case Target::NVVM:
+    return nvvmTargetInfo;
+  case Target::GENX:
+    return genxTargetInfo;
+  }
+  llvm_unreachable("unsupported triton::Target");
+}
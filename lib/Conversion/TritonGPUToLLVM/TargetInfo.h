@@ -0,0 +1,55 @@
+#ifndef TRITON_CONVERSION_TRITONGPU_TO_LLVM_TARGETINFO_H
+#define TRITON_CONVERSION_TRITONGPU_TO_LLVM_TARGETINFO_H
+
+#include "mlir/Dialect/LLVMIR/NVVMDialect.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "triton/Conversion/TritonGPUToLLVM/Passes.h"
+
+namespace mlir::triton {
+
+// The target-specific primitives the TritonGPU to LLVM lowering is built on.
+// Lowerings should use these hooks rather than branch on the target, so that
+// improvements to them apply to every backend.
+class TargetInfoBase {
+public:
+  virtual ~TargetInfoBase() = default;
+
+  // Returns the base of the shared memory of \p funcOp, i.e. the global
+  // shared memory buffer in kernels and the trailing pointer argument of the
+  // other functions.
+  virtual Value getStackPointer(PatternRewriter &rewriter,
+                                FunctionOpInterface funcOp) const = 0;
+
+  // Stores \p val to, or loads a value of type \p elemTy from, the shared
+  // memory at \p ptr if \p pred holds. A load yields an undefined value
+  // otherwise.
+  virtual void storeShared(ConversionPatternRewriter &rewriter, Location loc,
+                           Value ptr, Value val, Value pred) const = 0;
+  virtual Value loadShared(ConversionPatternRewriter &rewriter, Location loc,
+                           Value ptr, Type elemTy, Value pred) const = 0;
+
+  // Reads \p val from the lane selected by \p mode and \p i. \p val has at
+  // most 32 bits; \p clamp is the segment mask of NVVM shuffles.
+  virtual Value shuffle(ConversionPatternRewriter &rewriter, Location loc,
+                        Value val, Value i, NVVM::ShflKind mode,
+                        Value clamp) const = 0;
+
+  // Returns the i32 mask of the lanes of the warp for which \p pred holds,
+  // restricted to the lanes of \p threadMask.
+  virtual Value ballot(ConversionPatternRewriter &rewriter, Location loc,
+                       Value pred, int threadMask,
+                       int numThreadsPerWarp) const = 0;
+
+  // Waits until \p numThreads threads of the CTA reach the named barrier
+  // \p barId.
+  virtual void namedBarrier(ConversionPatternRewriter &rewriter, Location loc,
+                            Operation *op, unsigned barId,
+                            unsigned numThreads) const = 0;
+};
+
+const TargetInfoBase &getTargetInfo(Target target);
+
+} // namespace mlir::triton
+
+#endif
@@ -678,6 +678,28 @@ struct GetNumProgramsOpConversion
                                                   mlir::gpu::Dimension::z};
 };
 
+struct GlobalScratchAllocOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::GlobalScratchAllocOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::GlobalScratchAllocOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::GlobalScratchAllocOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    // offsets are assigned by AllocateSharedMemory
+    if (!op->hasAttr("allocation.offset"))
+      return failure();
+    Location loc = op->getLoc();
+    auto ptrTy = getTypeConverter()->convertType(op.getType());
+    Value base = LLVM::getGlobalScratchBase(loc, rewriter, op, target);
+    rewriter.replaceOp(op, gep(ptrTy, i8_ty, base,
+                               i32_val(op->getAttrOfType<IntegerAttr>(
+                                             "allocation.offset")
+                                           .getInt())));
+    return success();
+  }
+};
+
 // TODO[goostavz]: GetThreadIdOp/GetClusterCTAIdOp is a temporary solution
 // before async dialect is done. These concepts should appear in ttgpu
 // level, and they are planned to be deprecated along with ttgpu.mbarrier_xxx
@@ -981,6 +1003,7 @@ void mlir::triton::populateTritonGPUToLLVMPatterns(
   patterns.add<ExtractSliceOpConversion>(typeConverter, target, benefit);
   patterns.add<GetProgramIdOpConversion>(typeConverter, target, benefit);
   patterns.add<GetNumProgramsOpConversion>(typeConverter, target, benefit);
+  patterns.add<GlobalScratchAllocOpConversion>(typeConverter, target, benefit);
   patterns.add<GetThreadIdOpConversion>(typeConverter, target, benefit);
   patterns.add<GetCanonicalWarpIdConversion>(typeConverter, target, benefit);
   patterns.add<GetClusterCTAIdOpConversion>(typeConverter, target, benefit);
@@ -185,8 +185,13 @@ public:
     Value tid = getThreadIdInCTA(rewriter, loc);
     auto mod = rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
     if (ttng::TritonNvidiaGPUDialect::getWSSupportedAttr(mod)) {
-      Value _128 = rewriter.create<arith::ConstantIntOp>(loc, 128, 32);
-      tid = rewriter.create<arith::RemSIOp>(loc, tid, _128);
+      // Each agent has the module's num-warps warps.
+      int threadsPerAgent =
+          triton::gpu::TritonGPUDialect::getNumWarps(mod) *
+          triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+      Value threadsPerAgentValue =
+          rewriter.create<arith::ConstantIntOp>(loc, threadsPerAgent, 32);
+      tid = rewriter.create<arith::RemSIOp>(loc, tid, threadsPerAgentValue);
     }
     return tid;
   }
@@ -711,6 +716,31 @@ public:
   emitIndices(Location loc, ConversionPatternRewriter &rewriter,
               Attribute layout, RankedTensorType type,
               bool withCTAOffset) const {
+    // The indices only depend on the thread, so each set is emitted once at
+    // the entry of the function and reused by all the ops that need it.
+    Region *region = rewriter.getInsertionBlock()->getParent();
+    auto func = region ? region->getParentOfType<LLVM::LLVMFuncOp>() : nullptr;
+    if (!func)
+      return emitIndicesImpl(loc, rewriter, layout, type, withCTAOffset);
+    auto &indexCache = getTypeConverter()->getIndexCache();
+    TritonGPUToLLVMTypeConverter::IndexCacheKey key{func, layout, type,
+                                                    withCTAOffset};
+    auto it = indexCache.find(key);
+    if (it != indexCache.end())
+      return it->second;
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(&func.getBody().front());
+    auto multiDimIdx =
+        emitIndicesImpl(loc, rewriter, layout, type, withCTAOffset);
+    indexCache[key] = multiDimIdx;
+    return multiDimIdx;
+  }
+
+private:
+  SmallVector<SmallVector<Value>>
+  emitIndicesImpl(Location loc, ConversionPatternRewriter &rewriter,
+                  Attribute layout, RankedTensorType type,
+                  bool withCTAOffset) const {
     // step 1, delinearize threadId to get the base index
     auto multiDimBase =
         emitBaseIndexForLayout(loc, rewriter, layout, type, withCTAOffset);
@@ -730,18 +760,6 @@ public:
     return multiDimIdx;
   }
 
-private:
-  void restoreInsertionPointIfSet(OpBuilder::InsertPoint *insertPt,
-                                  ConversionPatternRewriter &rewriter) const {
-    if (insertPt->isSet()) {
-      rewriter.restoreInsertionPoint(*insertPt);
-    } else {
-      auto func =
-          rewriter.getInsertionPoint()->getParentOfType<LLVM::LLVMFuncOp>();
-      rewriter.setInsertionPointToStart(&func.getBody().front());
-    }
-  }
-
   // -----------------------------------------------------------------------
   // Blocked layout indices
   // -----------------------------------------------------------------------
@@ -984,7 +1002,8 @@ private:
 
     // Compute the 2-dim coordinates of the warp containing the tensor element
     // operated on by this thread.
-    SmallVector<unsigned> warpShape = {8, 16};
+    SmallVector<unsigned> warpShape = {dpasLayout.getRepeatCount(),
+                                       dpasLayout.getExecutionSize()};
     Value rowWarpId =
         urem(urem(warpId, warpsPerCTA[0]), i32_val(shape[0] / warpShape[0]));
     Value colWarpId = urem(urem(udiv(warpId, warpsPerCTA[0]), warpsPerCTA[1]),
@@ -1071,7 +1090,8 @@ private:
 
     for (unsigned i = 0; i < shape[0]; i += shapePerCTA[0]) {
       for (unsigned j = 0; j < shape[1]; j += shapePerCTA[1]) {
-        emitDpasOffsetForCTA(dpasLayout, offsets, i, j);
+        emitDpasOffsetForCTA(dpasLayout, offsets, i / shapePerCTA[0],
+                             j / shapePerCTA[1]);
       }
     }
 
@@ -211,6 +211,7 @@ struct FuncOpConversion : public FuncOpConversionBase {
       attrs.append(GENX::GENXDialect::getReqdSubGroupSizeAttrName(),
                    rewriter.getI32ArrayAttr(threadsPerWarp));
       newFuncOp->setDialectAttrs(attrs);
+      addPointerArgAttrs(newFuncOp, rewriter);
       break;
     }
     if (!LLVM::isKernel(funcOp)) {
@@ -227,6 +228,29 @@ struct FuncOpConversion : public FuncOpConversionBase {
     return success();
   }
 
+  // Turn the facts the JIT specialized pointer arguments on into LLVM
+  // parameter attributes, which the SPIR-V translator emits as Alignment
+  // decorations and NoAlias parameter attributes: `tt.divisibility` into
+  // `llvm.align` and `tt.restrict` (`tl.restrict` arguments) into
+  // `llvm.noalias`.
+  static void addPointerArgAttrs(LLVM::LLVMFuncOp funcOp,
+                                 ConversionPatternRewriter &rewriter) {
+    for (unsigned i = 0, e = funcOp.getNumArguments(); i < e; ++i) {
+      if (!funcOp.getArgument(i).getType().isa<LLVM::LLVMPointerType>())
+        continue;
+      if (auto divisibility =
+              funcOp.getArgAttrOfType<IntegerAttr>(i, "tt.divisibility")) {
+        int64_t align = divisibility.getInt();
+        if (align > 1 && llvm::isPowerOf2_64(align))
+          funcOp.setArgAttr(i, LLVM::LLVMDialect::getAlignAttrName(),
+                            rewriter.getI64IntegerAttr(align));
+      }
+      if (funcOp.getArgAttr(i, "tt.restrict"))
+        funcOp.setArgAttr(i, LLVM::LLVMDialect::getNoAliasAttrName(),
+                          rewriter.getUnitAttr());
+    }
+  }
+
 private:
   int numWarps{0};
   triton::Target target;
@@ -352,8 +376,11 @@ struct ConvertTritonGPUToLLVM
   }
 
   ConvertTritonGPUToLLVM(int32_t computeCapability, Target target,
-                         mlir::triton::gpu::TMAMetadataTy *tmaMetadata)
-      : ConvertTritonGPUToLLVMBase({computeCapability, target}),
+                         mlir::triton::gpu::TMAMetadataTy *tmaMetadata,
+                         bool fastMath, bool vectorTensors,
+                         bool aggregateAtomics)
+      : ConvertTritonGPUToLLVMBase({computeCapability, target, fastMath,
+                                    vectorTensors, aggregateAtomics}),
         tmaMetadata(tmaMetadata) {}
 
   void runOnOperation() override {
@@ -362,7 +389,7 @@ struct ConvertTritonGPUToLLVM
 
     mlir::LowerToLLVMOptions option(context);
     option.overrideIndexBitwidth(32);
-    TritonGPUToLLVMTypeConverter typeConverter(context, option);
+    TritonGPUToLLVMTypeConverter typeConverter(context, option, vectorTensors);
     TritonLLVMConversionTarget convTarget(*context, target);
     int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
     int numCTAs = triton::gpu::TritonGPUDialect::getNumCTAs(mod);
@@ -420,7 +447,8 @@ struct ConvertTritonGPUToLLVM
     // Lower functions
     {
       mlir::LowerToLLVMOptions option(context);
-      TritonGPUToLLVMTypeConverter typeConverter(context, option);
+      TritonGPUToLLVMTypeConverter typeConverter(context, option,
+                                                 vectorTensors);
       TritonLLVMFunctionConversionTarget funcTarget(*context, target);
       RewritePatternSet funcPatterns(context);
       funcPatterns.add<FuncOpConversion>(typeConverter, numWarps, target,
@@ -440,7 +468,8 @@ struct ConvertTritonGPUToLLVM
     // Convert call and ret ops
     {
       mlir::LowerToLLVMOptions option(context);
-      TritonGPUToLLVMTypeConverter typeConverter(context, option);
+      TritonGPUToLLVMTypeConverter typeConverter(context, option,
+                                                 vectorTensors);
       TritonLLVMFunctionConversionTarget funcTarget(*context, target);
       RewritePatternSet funcPatterns(context);
       funcPatterns.add<CallOpConversion>(typeConverter, numWarps, 1, target);
@@ -459,7 +488,6 @@ struct ConvertTritonGPUToLLVM
     // other values will be DCEed if not used hereafter.
     bool isWarpSpecialization =
         ttng::TritonNvidiaGPUDialect::getWSSupportedAttr(mod);
-    OpBuilder::InsertPoint indexInsertPoint;
 
     // tmaMetadata is absent in a triton-opt unit test, in this case, create a
     // local one and dump it after this pass is done.
@@ -482,7 +510,7 @@ struct ConvertTritonGPUToLLVM
     auto populatePatterns3 = [&](auto populateFunc) {
       populateFunc(typeConverter, patterns, numWarps, axisInfoAnalysis,
                    tmaMetadata, &tensorPtrMap, target,
-                   /*benefit*/ 10);
+                   /*benefit*/ 10, aggregateAtomics);
     };
 
     auto populatePatterns4 = [&](auto populateFunc) {
@@ -495,15 +523,22 @@ struct ConvertTritonGPUToLLVM
     populatePatterns1(populateConvertLayoutOpToLLVMPatterns);
     populatePatterns2(populateDotOpToLLVMPatterns);
     populatePatterns4(populateElementwiseOpToLLVMPatterns);
+    if (fastMath && target == Target::GENX)
+      populateGENXFastMathOpToLLVMPatterns(typeConverter, patterns,
+                                           axisInfoAnalysis, target,
+                                           /*benefit*/ 11);
     populatePatterns3(populateLoadStoreOpToLLVMPatterns);
     populatePatterns4(populateReduceOpToLLVMPatterns);
     populatePatterns1(populateScanOpToLLVMPatterns);
+    populatePatterns1(populateSortOpToLLVMPatterns);
+    populatePatterns1(populateGatherOpToLLVMPatterns);
     populatePatterns2(populateViewOpToLLVMPatterns);
     populatePatterns2(populateBarrierOpToLLVMPatterns);
     populatePatterns2(populateTensorPtrOpsToLLVMPatterns);
     populatePatterns2(populateClusterOpsToLLVMPatterns);
     populatePatterns2(populateRegReallocOpToLLVMPatterns);
     populatePatterns1(populateHistogramOpToLLVMPatterns);
+    populatePatterns1(populateWarpOpToLLVMPatterns);
 
     // TODO(thomas): this should probably be done in a separate step to not
     // interfere with our own lowering of arith ops. Add arith/math's patterns
@@ -697,9 +732,12 @@ std::unique_ptr<OperationPass<ModuleOp>> createConvertTritonGPUToLLVMPass() {
 }
 std::unique_ptr<OperationPass<ModuleOp>> createConvertTritonGPUToLLVMPass(
     int32_t computeCapability, Target target,
-    mlir::triton::gpu::TMAMetadataTy *tmaMetadata) {
+    mlir::triton::gpu::TMAMetadataTy *tmaMetadata, bool fastMath,
+    bool vectorTensors, bool aggregateAtomics) {
   return std::make_unique<ConvertTritonGPUToLLVM>(computeCapability, target,
-                                                  tmaMetadata);
+                                                  tmaMetadata, fastMath,
+                                                  vectorTensors,
+                                                  aggregateAtomics);
 }
 
 } // namespace triton
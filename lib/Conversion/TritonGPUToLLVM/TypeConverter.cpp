@@ -1,6 +1,7 @@
 #include "TypeConverter.h"
 #include "Utility.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/IR/Matchers.h"
 #include "triton/Conversion/MLIRTypes.h"
 
 using namespace mlir;
@@ -15,9 +16,9 @@ using ::mlir::triton::gpu::SharedEncodingAttr;
 using ::mlir::triton::gpu::SliceEncodingAttr;
 
 TritonGPUToLLVMTypeConverter::TritonGPUToLLVMTypeConverter(
-    MLIRContext *ctx, LowerToLLVMOptions &option,
+    MLIRContext *ctx, LowerToLLVMOptions &option, bool vectorTensors,
     const DataLayoutAnalysis *analysis)
-    : LLVMTypeConverter(ctx, option, analysis) {
+    : LLVMTypeConverter(ctx, option, analysis), vectorTensors(vectorTensors) {
   addConversion([&](triton::PointerType type) -> std::optional<Type> {
     return convertTritonPointerType(type);
   });
@@ -71,6 +72,14 @@ Type TritonGPUToLLVMTypeConverter::convertTritonPointerType(
 Value TritonGPUToLLVMTypeConverter::packLLElements(
     Location loc, ValueRange resultVals, ConversionPatternRewriter &rewriter,
     Type type) {
+  if (auto vecType = this->convertType(type).dyn_cast<VectorType>()) {
+    assert(vecType.getNumElements() == resultVals.size() &&
+           "size mismatch when packing elements for LLVM vector");
+    Value vec = rewriter.create<LLVM::UndefOp>(loc, vecType);
+    for (const auto &v : llvm::enumerate(resultVals))
+      vec = insert_element(vecType, vec, v.value(), i32_val(v.index()));
+    return vec;
+  }
   auto structType = this->convertType(type).dyn_cast<LLVM::LLVMStructType>();
   if (!structType) {
     assert(resultVals.size() == 1);
@@ -107,12 +116,42 @@ SmallVector<Value> TritonGPUToLLVMTypeConverter::unpackLLElements(
       llvmStruct.getType().isa<triton::PointerType>() ||
       llvmStruct.getType().isa<LLVM::LLVMPointerType>())
     return {llvmStruct};
+  if (auto vecType = llvmStruct.getType().dyn_cast<VectorType>()) {
+    // Vectors packed by another pattern are read through their insertions,
+    // like structs below.
+    SmallVector<Value> results(vecType.getNumElements());
+    Value container = llvmStruct;
+    while (auto insert = container.getDefiningOp<LLVM::InsertElementOp>()) {
+      APInt position;
+      if (matchPattern(insert.getPosition(), m_ConstantInt(&position)) &&
+          position.ult(results.size()) && !results[position.getZExtValue()])
+        results[position.getZExtValue()] = insert.getValue();
+      container = insert.getVector();
+    }
+    for (unsigned i = 0; i < results.size(); ++i) {
+      if (!results[i])
+        results[i] =
+            extract_element(vecType.getElementType(), llvmStruct, i32_val(i));
+    }
+    return results;
+  }
   ArrayRef<Type> types =
       llvmStruct.getType().cast<LLVM::LLVMStructType>().getBody();
   SmallVector<Value> results(types.size());
+  // Structs packed by another pattern are read through their insertions in a
+  // single walk, so that large per-thread tensors do not add an extraction per
+  // element and use, nor a fold of each of them that walks the whole chain.
+  Value container = llvmStruct;
+  while (auto insert = container.getDefiningOp<LLVM::InsertValueOp>()) {
+    ArrayRef<int64_t> position = insert.getPosition();
+    if (position.size() == 1 && !results[position[0]])
+      results[position[0]] = insert.getValue();
+    container = insert.getContainer();
+  }
   for (unsigned i = 0; i < types.size(); ++i) {
     Type type = types[i];
-    results[i] = extract_val(type, llvmStruct, i);
+    if (!results[i])
+      results[i] = extract_val(type, llvmStruct, i);
   }
   return results;
 }
@@ -128,7 +167,7 @@ Type TritonGPUToLLVMTypeConverter::getElementTypeForStruct(
 
   if (auto dpasParent = dotOpLayout.getParent().dyn_cast<DpasEncodingAttr>()) {
     unsigned RC = dpasParent.getRepeatCount();
-    unsigned bitWidth = elemTy.getIntOrFloatBitWidth();
+    unsigned bitWidth = dotOpLayout.getDPASBitWidth(elemTy);
 
     if (dotOpLayout.getOpIdx() == 0) {
       //  Elem. Type | vector size
@@ -143,8 +182,10 @@ Type TritonGPUToLLVMTypeConverter::getElementTypeForStruct(
       //  f16/bf16   | vector<16xf16/bf16>
       //     i8      | vector<32xi8>
       //     tf32    | vector<8xf32>
+      // The B operand spans the systolic depth and does not depend on RC.
       assert(dotOpLayout.getOpIdx() == 1);
-      return vec_ty(elemTy, RC * ((8 * sizeof(int32_t)) / bitWidth));
+      unsigned SD = dpasParent.getSystolicDepth();
+      return vec_ty(elemTy, SD * ((8 * sizeof(int32_t)) / bitWidth));
     }
   }
 
@@ -178,6 +219,18 @@ Type TritonGPUToLLVMTypeConverter::convertTritonTensorType(
   }
 
   unsigned numElementsPerThread = getTotalElemsPerThread(type);
+  // Vectors keep the values of blocked tensors in a form LLVM and the SPIR-V
+  // translator operate on as a whole; the sizes are the ones SPIR-V vectors
+  // can have.
+  if (vectorTensors && VectorType::isValidElementType(eltType) &&
+      eltType.isIntOrFloat() &&
+      llvm::is_contained({2u, 3u, 4u, 8u, 16u}, numElementsPerThread)) {
+    Attribute baseLayout = layout;
+    while (auto sliceLayout = baseLayout.dyn_cast<SliceEncodingAttr>())
+      baseLayout = sliceLayout.getParent();
+    if (baseLayout.isa<BlockedEncodingAttr>())
+      return VectorType::get(numElementsPerThread, eltType);
+  }
   SmallVector<Type, 4> types(numElementsPerThread, eltType);
   return LLVM::LLVMStructType::getLiteral(ctx, types);
 }
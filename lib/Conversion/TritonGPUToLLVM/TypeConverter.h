@@ -4,6 +4,9 @@
 #include "mlir/Conversion/LLVMCommon/TypeConverter.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "triton/Conversion/MLIRTypes.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include <tuple>
 
 using namespace mlir;
 using namespace mlir::triton;
@@ -12,7 +15,10 @@ class TritonGPUToLLVMTypeConverter : public LLVMTypeConverter {
 public:
   using TypeConverter::convertType;
 
+  // `vectorTensors` represents the values each thread holds of blocked tensors
+  // as an LLVM vector instead of a struct, where they form a valid vector.
   TritonGPUToLLVMTypeConverter(MLIRContext *ctx, LowerToLLVMOptions &option,
+                               bool vectorTensors = false,
                                const DataLayoutAnalysis *analysis = nullptr);
 
   Type getElementTypeForStruct(RankedTensorType type);
@@ -25,6 +31,16 @@ public:
                                       ConversionPatternRewriter &rewriter);
 
   Type convertTritonTensorType(RankedTensorType type);
+
+  // The indices of the elements of a tensor held by each thread, emitted once
+  // per function, layout, tensor type and whether they include the CTA offset.
+  using IndexCacheKey = std::tuple<Operation *, Attribute, Type, unsigned>;
+  using IndexCache = DenseMap<IndexCacheKey, SmallVector<SmallVector<Value>>>;
+  IndexCache &getIndexCache() { return indexCache; }
+
+private:
+  bool vectorTensors;
+  IndexCache indexCache;
 };
 
 #endif
@@ -1,8 +1,11 @@
 #include "Utility.h"
+#include "TargetInfo.h"
 #include "TypeConverter.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/LLVMIR/GENXDialect.h"
 #include "mlir/Dialect/LLVMIR/NVVMDialect.h"
 #include "triton/Dialect/NVGPU/IR/Dialect.h"
+#include "llvm/ADT/TypeSwitch.h"
 namespace mlir {
 
 namespace LLVM {
@@ -259,79 +262,14 @@ Value linearize(ConversionPatternRewriter &rewriter, Location loc,
   return linear;
 }
 
-Value storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
-                  Value val, Value pred, triton::Target target) {
-  switch (target) {
-  case triton::Target::ROCDL:
-  case triton::Target::NVVM: {
-    MLIRContext *ctx = rewriter.getContext();
-    unsigned bits = std::max(8u, val.getType().getIntOrFloatBitWidth());
-    const char *c = bits == 64 ? "l" : (bits == 16 ? "h" : "r");
-
-    PTXBuilder builder;
-    auto *ptrOpr = builder.newAddrOperand(ptr, "r");
-    auto *valOpr = builder.newOperand(val, c);
-    auto &st = builder.create<>("st")->shared().b(bits);
-    st(ptrOpr, valOpr).predicate(pred, "b");
-    return builder.launch(rewriter, loc, void_ty(ctx));
-  } break;
-  case triton::Target::GENX: {
-    createPredicatedBlock(rewriter, loc, pred, [&] {
-      store(val, ptr);
-      return ArrayRef<Value>();
-    });
-    return Value();
-  } break;
-  }
-  llvm_unreachable("unsupported triton::Target");
+void storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
+                 Value val, Value pred, triton::Target target) {
+  getTargetInfo(target).storeShared(rewriter, loc, ptr, val, pred);
 }
 
 Value loadShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
                  Type elemTy, Value pred, triton::Target target) {
-  switch (target) {
-  case triton::Target::ROCDL:
-  case triton::Target::NVVM: {
-    MLIRContext *ctx = rewriter.getContext();
-    auto ptrTy = ptr.getType().cast<LLVMPointerType>();
-    assert(ptrTy.getAddressSpace() == 3 && "Invalid addr space for loadShared");
-    unsigned bitwidth = std::max(8u, elemTy.getIntOrFloatBitWidth());
-
-    const char *c = bitwidth == 64 ? "=l" : (bitwidth == 16 ? "=h" : "=r");
-
-    PTXBuilder builder;
-    auto *dOpr = builder.newOperand(c);
-    auto *ptrOpr = builder.newAddrOperand(ptr, "r");
-    auto &ld = builder.create<>("ld")->shared().b(bitwidth);
-    ld(dOpr, ptrOpr).predicate(pred, "b");
-    return builder.launch(rewriter, loc, elemTy);
-  } break;
-  case triton::Target::GENX: {
-    assert(ptr.getType().cast<LLVMPointerType>().getAddressSpace() == 3 &&
-           "Invalid addr space for loadShared");
-    Value undef = undef(elemTy);
-    Block &endBlock = createPredicatedBlock(rewriter, loc, pred,
-                                            SmallVector<Value, 1>{undef}, [&] {
-                                              Value ret = load(elemTy, ptr);
-                                              return SmallVector<Value, 1>{ret};
-                                            });
-    return *endBlock.args_begin();
-  } break;
-  }
-  llvm_unreachable("unsupported triton::Target");
-}
-
-static GENX::ShflKind toGenXShuffleMode(NVVM::ShflKind mode) {
-  switch (mode) {
-  case NVVM::ShflKind::bfly:
-    return GENX::ShflKind::XOR;
-  case NVVM::ShflKind::up:
-    return GENX::ShflKind::UP;
-  case NVVM::ShflKind::down:
-    return GENX::ShflKind::DOWN;
-  case NVVM::ShflKind::idx:
-    return GENX::ShflKind::IDX;
-  }
-  llvm_unreachable("unsupported NVVM::ShflKind");
+  return getTargetInfo(target).loadShared(rewriter, loc, ptr, elemTy, pred);
 }
 
 static Value commonShflSync(Location loc, ConversionPatternRewriter &rewriter,
@@ -351,33 +289,7 @@ static Value commonShflSync(Location loc, ConversionPatternRewriter &rewriter,
     vec = insert_element(vecTy, vec, val1, i32_val(1));
     return bitcast(vec, val.getType());
   }
-  Type type = val.getType();
-
-  switch (target) {
-  case triton::Target::ROCDL:
-  case triton::Target::NVVM: {
-    if (type != i32_ty) {
-      val = bitcast(val, int_ty(bits));
-      if (bits < 32)
-        val = zext(i32_ty, val);
-    }
-    Value mask = i32_val(0xFFFFFFFF);
-    Value result = rewriter.create<NVVM::ShflOp>(loc, i32_ty, mask, val, i,
-                                                 clamp, mode, UnitAttr());
-    if (type != i32_ty) {
-      if (bits < 32)
-        result = trunc(int_ty(bits), result);
-      result = bitcast(result, type);
-    }
-
-    return result;
-  }
-  case triton::Target::GENX: {
-    return rewriter.create<GENX::SubGroupShuffleOp>(loc, type, val, i,
-                                                    toGenXShuffleMode(mode));
-  }
-  }
-  llvm_unreachable("Invalid target");
+  return getTargetInfo(target).shuffle(rewriter, loc, val, i, mode, clamp);
 }
 
 Value shflSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
@@ -450,5 +362,154 @@ Value addStringToModule(Location loc, ConversionPatternRewriter &rewriter,
   return stringStart;
 }
 
+LLVMFuncOp getOrInsertFunction(ConversionPatternRewriter &rewriter,
+                               Operation *op, StringRef name, Type resultType,
+                               ArrayRef<Type> argTypes) {
+  auto funcAttr = StringAttr::get(op->getContext(), name);
+  if (Operation *funcOp = SymbolTable::lookupNearestSymbolFrom(op, funcAttr))
+    return cast<LLVMFuncOp>(funcOp);
+
+  auto parent = op->getParentOfType<LLVMFuncOp>();
+  OpBuilder b(parent);
+  auto funcType = LLVMFunctionType::get(resultType, argTypes);
+  return b.create<LLVMFuncOp>(op->getLoc(), name, funcType);
+}
+
+LLVMFuncOp getOrInsertSPIRFunction(ConversionPatternRewriter &rewriter,
+                                   Operation *op, StringRef name,
+                                   Type resultType, ArrayRef<Type> argTypes) {
+  auto ret = getOrInsertFunction(rewriter, op, name, resultType, argTypes);
+  ret.setCConv(cconv::CConv::SPIR_FUNC);
+  return ret;
+}
+
+std::optional<SPIRVGroupOpKind> matchSPIRVGroupOp(Region &combineOp,
+                                                  Type llvmTy) {
+  Block *block = &combineOp.front();
+  if (block->getNumArguments() != 2)
+    return std::nullopt;
+  Operation *yield = block->getTerminator();
+  Operation *reduceOp = yield->getOperand(0).getDefiningOp();
+  if (!reduceOp || reduceOp->getNumOperands() != 2 ||
+      reduceOp->getNumResults() != 1)
+    return std::nullopt;
+  if (reduceOp->getOperand(0) != block->getArgument(0) ||
+      reduceOp->getOperand(1) != block->getArgument(1))
+    return std::nullopt;
+  // The converted type must still be the combine type (bf16 is carried as
+  // i16).
+  Type ty = reduceOp->getResultTypes()[0];
+  if (ty != llvmTy)
+    return std::nullopt;
+
+  if (auto intTy = ty.dyn_cast<IntegerType>()) {
+    unsigned width = intTy.getWidth();
+    if (width != 16 && width != 32 && width != 64)
+      return std::nullopt;
+    StringRef s = width == 16 ? "s" : width == 32 ? "i" : "l";
+    StringRef u = width == 16 ? "t" : width == 32 ? "j" : "m";
+    return llvm::TypeSwitch<Operation *, std::optional<SPIRVGroupOpKind>>(
+               reduceOp)
+        .Case<arith::AddIOp>([&](auto) { return SPIRVGroupOpKind{"IAdd", s}; })
+        .Case<arith::MulIOp>([&](auto) { return SPIRVGroupOpKind{"IMul", s}; })
+        .Case<arith::AndIOp>(
+            [&](auto) { return SPIRVGroupOpKind{"BitwiseAnd", s}; })
+        .Case<arith::OrIOp>(
+            [&](auto) { return SPIRVGroupOpKind{"BitwiseOr", s}; })
+        .Case<arith::XOrIOp>(
+            [&](auto) { return SPIRVGroupOpKind{"BitwiseXor", s}; })
+        .Case<arith::MinSIOp>([&](auto) { return SPIRVGroupOpKind{"SMin", s}; })
+        .Case<arith::MaxSIOp>([&](auto) { return SPIRVGroupOpKind{"SMax", s}; })
+        .Case<arith::MinUIOp>([&](auto) { return SPIRVGroupOpKind{"UMin", u}; })
+        .Case<arith::MaxUIOp>([&](auto) { return SPIRVGroupOpKind{"UMax", u}; })
+        .Default([](auto) { return std::nullopt; });
+  }
+
+  StringRef f;
+  if (ty.isF16())
+    f = "Dh";
+  else if (ty.isF32())
+    f = "f";
+  else if (ty.isF64())
+    f = "d";
+  else
+    return std::nullopt;
+  return llvm::TypeSwitch<Operation *, std::optional<SPIRVGroupOpKind>>(
+             reduceOp)
+      .Case<arith::AddFOp>([&](auto) { return SPIRVGroupOpKind{"FAdd", f}; })
+      .Case<arith::MulFOp>([&](auto) { return SPIRVGroupOpKind{"FMul", f}; })
+      .Case<arith::MinNumFOp>([&](auto) { return SPIRVGroupOpKind{"FMin", f}; })
+      .Case<arith::MaxNumFOp>([&](auto) { return SPIRVGroupOpKind{"FMax", f}; })
+      .Default([](auto) { return std::nullopt; });
+}
+
+Value createSPIRVGroupOp(Location loc, ConversionPatternRewriter &rewriter,
+                         Operation *op, SPIRVGroupOpKind kind,
+                         spirv::GroupOperation groupOp, Value val,
+                         unsigned clusterSize) {
+  bool clustered = groupOp == spirv::GroupOperation::ClusteredReduce;
+  assert(clustered == (clusterSize != 0) && "cluster size mismatch");
+  std::string name = ("__spirv_GroupNonUniform" + kind.op).str();
+  std::string mangledName = "_Z" + std::to_string(name.size()) + name + "ii" +
+                            kind.mangledType.str() + (clustered ? "j" : "");
+  SmallVector<Value> args{
+      i32_val(static_cast<uint32_t>(spirv::Scope::Subgroup)),
+      i32_val(static_cast<uint32_t>(groupOp)), val};
+  if (clustered)
+    args.push_back(i32_val(clusterSize));
+  SmallVector<Type> argTys;
+  for (Value arg : args)
+    argTys.push_back(arg.getType());
+  auto funcOp =
+      getOrInsertSPIRFunction(rewriter, op, mangledName, val.getType(), argTys);
+  auto callOp = call(funcOp, args);
+  callOp.setCConv(cconv::CConv::SPIR_FUNC);
+  return callOp.getResult();
+}
+
+void createGENXNamedBarrierSignal(Location loc,
+                                  ConversionPatternRewriter &rewriter,
+                                  Operation *op, Value barId,
+                                  Value numThreads) {
+  // The hardware counts participating threads, i.e. sub-groups.
+  auto mod = op->getParentOfType<ModuleOp>();
+  unsigned threadsPerWarp =
+      triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+  Value numSubGroups = udiv(numThreads, i32_val(threadsPerWarp));
+  auto funcOp = getOrInsertSPIRFunction(
+      rewriter, op, "llvm.genx.GenISA.threadgroupnamedbarriers.signal",
+      void_ty(rewriter.getContext()), {i32_ty, i32_ty});
+  auto callOp = call(funcOp, ValueRange{barId, numSubGroups});
+  callOp.setCConv(cconv::CConv::SPIR_FUNC);
+}
+
+void createGENXNamedBarrierWait(Location loc,
+                                ConversionPatternRewriter &rewriter,
+                                Operation *op, Value barId) {
+  auto funcOp = getOrInsertSPIRFunction(
+      rewriter, op, "llvm.genx.GenISA.threadgroupnamedbarriers.wait",
+      void_ty(rewriter.getContext()), {i32_ty});
+  auto callOp = call(funcOp, ValueRange{barId});
+  callOp.setCConv(cconv::CConv::SPIR_FUNC);
+}
+
+void createGENXSubGroupBarrier(Location loc,
+                               ConversionPatternRewriter &rewriter,
+                               Operation *op) {
+  // __spirv_ControlBarrier(Subgroup, Workgroup,
+  //                        AcquireRelease | WorkgroupMemory)
+  auto semantics = spirv::MemorySemantics::AcquireRelease |
+                   spirv::MemorySemantics::WorkgroupMemory;
+  auto funcOp = getOrInsertSPIRFunction(
+      rewriter, op, "_Z22__spirv_ControlBarrieriii",
+      void_ty(rewriter.getContext()), {i32_ty, i32_ty, i32_ty});
+  auto callOp = call(
+      funcOp,
+      ValueRange{i32_val(static_cast<uint32_t>(spirv::Scope::Subgroup)),
+                 i32_val(static_cast<uint32_t>(spirv::Scope::Workgroup)),
+                 i32_val(static_cast<uint32_t>(semantics))});
+  callOp.setCConv(cconv::CConv::SPIR_FUNC);
+}
+
 } // namespace LLVM
 } // namespace mlir
@@ -5,11 +5,14 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/LLVMIR/GENXDialect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/SPIRV/IR/SPIRVEnums.h"
 #include "triton/Analysis/Utility.h"
 #include "triton/Conversion/MLIRTypes.h"
 #include "triton/Conversion/TritonGPUToLLVM/PTXAsmFormat.h"
 #include "triton/Conversion/TritonGPUToLLVM/Passes.h"
 
+#include "TargetInfo.h"
+
 // Shortcuts for some commonly used LLVM ops to keep code simple and intuitive
 // Operators
 #define inttoptr(...) rewriter.create<LLVM::IntToPtrOp>(loc, __VA_ARGS__)
@@ -253,6 +256,47 @@ Block &createPredicatedBlock(ConversionPatternRewriter &rewriter, Location loc,
   return createPredicatedBlock(rewriter, loc, cond, {}, thenOpsFn);
 }
 
+/// Create an if-then-else diamond, using \p cond as the condition, \p thenOpsFn
+/// to inject operations in the 'then' branch and \p elseOpsFn to inject
+/// operations in the 'else' branch. Both branches must yield values of the
+/// same types, which become the arguments of the returned block:
+///   cf.cond_br %cond, ^br1, ^br2
+///   ^br1:
+///     %then_ops = `thenOpsFn()`
+///     cf.br ^br3(%then_ops)
+///   ^br2:
+///     %else_ops = `elseOpsFn()`
+///     cf.br ^br3(%else_ops)
+///   ^br3(%block_ops):
+template <typename ThenOpsFn, typename ElseOpsFn>
+Block &createIfElseBlock(ConversionPatternRewriter &rewriter, Location loc,
+                         Value cond, ThenOpsFn &&thenOpsFn,
+                         ElseOpsFn &&elseOpsFn) {
+  Block *insertionBlock = rewriter.getInsertionBlock();
+  Block *thenBlock =
+      rewriter.splitBlock(insertionBlock, rewriter.getInsertionPoint());
+  Block *elseBlock = rewriter.splitBlock(thenBlock, thenBlock->begin());
+  Block *endBlock = rewriter.splitBlock(elseBlock, elseBlock->begin());
+
+  rewriter.setInsertionPointToEnd(insertionBlock);
+  rewriter.create<cf::CondBranchOp>(loc, cond, thenBlock, elseBlock);
+
+  rewriter.setInsertionPointToStart(thenBlock);
+  auto thenOps = thenOpsFn();
+  rewriter.create<cf::BranchOp>(loc, endBlock, thenOps);
+
+  rewriter.setInsertionPointToStart(elseBlock);
+  auto elseOps = elseOpsFn();
+  assert(thenOps.size() == elseOps.size() && "Inconsistent size");
+  rewriter.create<cf::BranchOp>(loc, endBlock, elseOps);
+
+  for (Value op : thenOps)
+    endBlock->addArgument(op.getType(), op.getLoc());
+
+  rewriter.setInsertionPointToStart(endBlock);
+  return *endBlock;
+}
+
 /// Create a 32-bit integer constant.
 Value createConstantI32(Location loc, OpBuilder &rewriter, int32_t v);
 
@@ -397,8 +441,8 @@ Value linearize(ConversionPatternRewriter &rewriter, Location loc,
 Value linearize(ConversionPatternRewriter &rewriter, Location loc,
                 ArrayRef<Value> multiDim, ArrayRef<unsigned> shape);
 
-Value storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
-                  Value val, Value pred, triton::Target target);
+void storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
+                 Value val, Value pred, triton::Target target);
 
 Value loadShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
                  Type elemTy, Value pred, triton::Target target);
@@ -417,30 +461,65 @@ Value addStringToModule(Location loc, ConversionPatternRewriter &rewriter,
                         StringRef key, StringRef content,
                         unsigned addressSpace);
 
+// Declares (once per module) the external function \p name next to the
+// function enclosing \p op.
+LLVMFuncOp getOrInsertFunction(ConversionPatternRewriter &rewriter,
+                               Operation *op, StringRef name, Type resultType,
+                               ArrayRef<Type> argTypes);
+
+// Same as getOrInsertFunction, for functions called with the SPIR_FUNC
+// calling convention such as GenISA intrinsics and SPIR-V built-ins.
+LLVMFuncOp getOrInsertSPIRFunction(ConversionPatternRewriter &rewriter,
+                                   Operation *op, StringRef name,
+                                   Type resultType, ArrayRef<Type> argTypes);
+
+// A SPIR-V non-uniform group arithmetic operation (e.g. "IAdd") and the
+// Itanium mangling of its operand type.
+struct SPIRVGroupOpKind {
+  StringRef op;
+  StringRef mangledType;
+};
+
+// Matches a reduce or scan \p combineOp over a single operand of converted
+// type \p llvmTy to a SPIR-V group operation. Float min/max only match the
+// NaN-ignoring variants.
+std::optional<SPIRVGroupOpKind> matchSPIRVGroupOp(Region &combineOp,
+                                                  Type llvmTy);
+
+// Emits the __spirv_GroupNonUniform<Op> built-in over the sub-group.
+// \p clusterSize is the cluster size of a ClusteredReduce.
+Value createSPIRVGroupOp(Location loc, ConversionPatternRewriter &rewriter,
+                         Operation *op, SPIRVGroupOpKind kind,
+                         spirv::GroupOperation groupOp, Value val,
+                         unsigned clusterSize = 0);
+
+// Signals the GENX named barrier \p barId on behalf of the calling sub-group.
+// The barrier completes once \p numThreads work-items (a multiple of the
+// sub-group size) have signalled it; signalling alone does not block, so it
+// is the arrive half of a split barrier.
+void createGENXNamedBarrierSignal(Location loc,
+                                  ConversionPatternRewriter &rewriter,
+                                  Operation *op, Value barId,
+                                  Value numThreads);
+
+// Blocks until the GENX named barrier \p barId completes.
+void createGENXNamedBarrierWait(Location loc,
+                                ConversionPatternRewriter &rewriter,
+                                Operation *op, Value barId);
+
+// Waits for the work-items of the calling sub-group only, ordering their
+// accesses to shared local memory.
+void createGENXSubGroupBarrier(Location loc,
+                               ConversionPatternRewriter &rewriter,
+                               Operation *op);
+
 static bool isKernel(FunctionOpInterface funcOp) {
   return funcOp.getVisibility() == SymbolTable::Visibility::Public;
 }
 
 static Value getStackPointer(PatternRewriter &rewriter,
                              FunctionOpInterface funcOp, Target target) {
-  auto mod = funcOp->getParentOfType<ModuleOp>();
-  if (target == Target::GENX) {
-    LLVM::LLVMPointerType ptrTy =
-        ptr_ty(rewriter.getContext(), GENX::GENXMemorySpace::kWorkgroup);
-    if (mod->getAttrOfType<IntegerAttr>("triton_gpu.shared").getInt() == 0)
-      return rewriter.create<LLVM::UndefOp>(funcOp.getLoc(), ptrTy);
-    return funcOp.getArgument(funcOp.getNumArguments() - 1);
-  }
-  LLVM::GlobalOp globalBase = nullptr;
-  mod.walk([&](LLVM::GlobalOp op) {
-    if (op.getSymName() == "global_smem")
-      globalBase = op;
-  });
-  assert(globalBase);
-  if (isKernel(funcOp))
-    return rewriter.create<LLVM::AddressOfOp>(funcOp.getLoc(), globalBase);
-  else
-    return funcOp.getArgument(funcOp.getNumArguments() - 1);
+  return triton::getTargetInfo(target).getStackPointer(rewriter, funcOp);
 }
 
 static Value getSharedMemoryBase(Location loc,
@@ -460,6 +539,22 @@ static Value getSharedMemoryBase(Location loc,
   return base;
 }
 
+// Returns the base of the global scratch memory of the kernel of \p op, its
+// argument after the arguments of the kernel and before the shared local
+// memory of GENX kernels.
+static Value getGlobalScratchBase(Location loc,
+                                  ConversionPatternRewriter &rewriter,
+                                  Operation *op, Target target) {
+  FunctionOpInterface func =
+      op->template getParentOfType<FunctionOpInterface>();
+  auto mod = op->template getParentOfType<ModuleOp>();
+  unsigned index = func.getNumArguments() - 1;
+  if (target == Target::GENX &&
+      mod->getAttrOfType<IntegerAttr>("triton_gpu.shared").getInt() != 0)
+    --index;
+  return func.getArgument(index);
+}
+
 } // namespace LLVM
 } // namespace mlir
 
@@ -1,4 +1,5 @@
 #include "PatternTritonGPUOpToLLVM.h"
+#include "mlir/Dialect/LLVMIR/NVVMDialect.h"
 #include "triton/Dialect/TritonGPU/IR/TritonGPUAttrDefs.cpp.inc"
 
 using namespace mlir;
@@ -29,6 +30,8 @@ struct SplatOpConversion
     auto srcType = typeConverter->convertType(tensorTy);
     if (auto structTy = dyn_cast<LLVM::LLVMStructType>(srcType))
       srcType = structTy.getBody()[0];
+    else if (auto vecTy = dyn_cast<VectorType>(srcType))
+      srcType = vecTy.getElementType();
     // If the type sizes don't match we need to pack constants.
     if (srcType.isIntOrFloat() && constVal.getType().getIntOrFloatBitWidth() !=
                                       srcType.getIntOrFloatBitWidth()) {
@@ -102,6 +105,125 @@ struct ArithConstantSplatOpConversion
   }
 };
 
+// Converts arith::ConstantOp with a non-splat DenseElementsAttr, e.g. the
+// lookup tables of dequantization kernels. The value of an element depends on
+// its index, which is only known at runtime, so each thread reads its elements
+// from a table: a vector constant for tables of at most
+// `kMaxRegisterTableBytes`, and otherwise a global in the constant address
+// space, so that large tables are neither splatted into registers nor
+// rebuilt by every thread.
+struct ArithConstantDenseOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<arith::ConstantOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      arith::ConstantOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  static constexpr int64_t kMaxRegisterTableBytes = 64;
+
+  LogicalResult
+  matchAndRewrite(arith::ConstantOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto values = op.getValue().dyn_cast<DenseIntOrFPElementsAttr>();
+    auto tensorTy = op.getType().dyn_cast<RankedTensorType>();
+    if (!values || values.isSplat() || !tensorTy || !tensorTy.getEncoding())
+      return failure();
+
+    Location loc = op->getLoc();
+    Type elemTy = getTypeConverter()->convertType(tensorTy.getElementType());
+    // the table holds the bits of the elements, in bytes for i1
+    unsigned bitWidth = elemTy.getIntOrFloatBitWidth();
+    Type storageTy = int_ty(std::max(bitWidth, 8u));
+    int64_t numElems = tensorTy.getNumElements();
+    auto tableTy = RankedTensorType::get({numElems}, storageTy);
+    auto flat = values.reshape(
+        RankedTensorType::get({numElems}, tensorTy.getElementType()));
+    DenseElementsAttr table =
+        bitWidth < 8 ? flat.mapValues(storageTy,
+                                      [](const APInt &v) { return v.zext(8); })
+                     : flat.bitcast(storageTy);
+
+    // Layouts larger than the tensor wrap around.
+    auto shape = tensorTy.getShape();
+    auto linearize = [&](ArrayRef<Value> multiDimIdx) {
+      Value offset = i32_val(0);
+      int64_t stride = 1;
+      for (int d = shape.size() - 1; d >= 0; --d) {
+        Value idx = urem(multiDimIdx[d], i32_val(shape[d]));
+        offset = add(offset, mul(idx, i32_val(stride)));
+        stride *= shape[d];
+      }
+      return offset;
+    };
+
+    bool inRegisters = numElems * storageTy.getIntOrFloatBitWidth() / 8 <=
+                       kMaxRegisterTableBytes;
+    Value tableVal, tablePtr;
+    if (inRegisters) {
+      auto vecTy = vec_ty(storageTy, numElems);
+      tableVal =
+          rewriter.create<LLVM::ConstantOp>(loc, vecTy, table.reshape(vecTy));
+    } else {
+      tablePtr = getOrCreateTable(loc, rewriter, table, tableTy);
+    }
+
+    auto indices = emitIndices(loc, rewriter, tensorTy.getEncoding(), tensorTy,
+                               /*withCTAOffset*/ true);
+    SmallVector<Value> elems;
+    for (const SmallVector<Value> &multiDimIdx : indices) {
+      Value offset = linearize(multiDimIdx);
+      Value elem;
+      if (inRegisters)
+        elem = extract_element(storageTy, tableVal, offset);
+      else
+        elem = load(storageTy,
+                    gep(tablePtr.getType(), storageTy, tablePtr, offset));
+      if (bitWidth < 8)
+        elem = trunc(elemTy, elem);
+      elems.push_back(bitcast(elem, elemTy));
+    }
+    Value result =
+        getTypeConverter()->packLLElements(loc, elems, rewriter, tensorTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+private:
+  // Returns the address of a constant global holding `table`, shared by the
+  // constants of the module with the same value.
+  Value getOrCreateTable(Location loc, ConversionPatternRewriter &rewriter,
+                         DenseElementsAttr table,
+                         RankedTensorType tableTy) const {
+    auto moduleOp =
+        rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
+    MLIRContext *ctx = moduleOp.getContext();
+    unsigned addressSpace = NVVM::NVVMMemorySpace::kConstantMemorySpace;
+    if (target == Target::GENX)
+      addressSpace = GENX::GENXMemorySpace::kUniformConstant;
+
+    LLVM::GlobalOp global;
+    for (auto candidate : moduleOp.getOps<LLVM::GlobalOp>())
+      if (candidate.getConstant() && candidate.getValueAttr() == table &&
+          candidate.getAddrSpace() == addressSpace)
+        global = candidate;
+    if (!global) {
+      unsigned tableNumber = 0;
+      SmallString<16> name;
+      do {
+        name.clear();
+        ("constantTable_" + Twine(tableNumber++)).toStringRef(name);
+      } while (moduleOp.lookupSymbol(name));
+      Type elemTy = tableTy.getElementType();
+      ConversionPatternRewriter::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPointToStart(moduleOp.getBody());
+      global = rewriter.create<LLVM::GlobalOp>(
+          UnknownLoc::get(ctx),
+          LLVM::LLVMArrayType::get(elemTy, tableTy.getNumElements()),
+          /*isConstant=*/true, LLVM::Linkage::Internal, name, table,
+          /*alignment=*/elemTy.getIntOrFloatBitWidth() / 8, addressSpace);
+    }
+    return address_of(ptr_ty(ctx, addressSpace), global.getSymName());
+  }
+};
+
 struct CatOpConversion : public ConvertTritonGPUOpToLLVMPattern<CatOp> {
   using OpAdaptor = typename CatOp::Adaptor;
 
@@ -322,6 +444,7 @@ void mlir::triton::populateViewOpToLLVMPatterns(
   patterns.add<ExpandDimsOpConversion>(typeConverter, target, benefit);
   patterns.add<SplatOpConversion>(typeConverter, target, benefit);
   patterns.add<ArithConstantSplatOpConversion>(typeConverter, target, benefit);
+  patterns.add<ArithConstantDenseOpConversion>(typeConverter, target, benefit);
   patterns.add<CatOpConversion>(typeConverter, target, benefit);
   patterns.add<InterleaveOpConversion>(typeConverter, target, benefit);
   patterns.add<TransOpConversion>(typeConverter, target, benefit);
@@ -0,0 +1,220 @@
+#include "PatternTritonGPUOpToLLVM.h"
+#include "Utility.h"
+#include "mlir/IR/Matchers.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+using ::mlir::LLVM::shflIdxSync;
+using ::mlir::LLVM::shflSync;
+using ::mlir::LLVM::shflUpSync;
+
+namespace {
+// Sub-group shuffles don't take booleans, which are exchanged as bytes.
+Value shuffleXor(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                 int mask, Target target) {
+  if (!val.getType().isInteger(1))
+    return shflSync(loc, rewriter, val, mask, target);
+  return trunc(i1_ty, shflSync(loc, rewriter, zext(i8_ty, val), mask, target));
+}
+
+Value shuffleUp(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                int delta, Target target) {
+  if (!val.getType().isInteger(1))
+    return shflUpSync(loc, rewriter, val, delta, target);
+  return trunc(i1_ty,
+               shflUpSync(loc, rewriter, zext(i8_ty, val), delta, target));
+}
+
+Value shuffleIdx(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                 Value lane, Target target) {
+  if (!val.getType().isInteger(1))
+    return shflIdxSync(loc, rewriter, val, lane, target);
+  return trunc(i1_ty,
+               shflIdxSync(loc, rewriter, zext(i8_ty, val), lane, target));
+}
+
+// Inlines \p combineOp applied to \p acc and \p cur.
+Value combine(ConversionPatternRewriter &rewriter, Region &combineOp,
+              Value acc, Value cur) {
+  Block *currentBlock = rewriter.getBlock();
+  Region &parent = *currentBlock->getParent();
+  rewriter.cloneRegionBefore(combineOp, &parent.front());
+  Block &newCombine = parent.front();
+  Operation *returnOp = newCombine.getTerminator();
+  rewriter.inlineBlockBefore(&newCombine, &*rewriter.getInsertionPoint(),
+                             {acc, cur});
+  Value result = returnOp->getOperand(0);
+  rewriter.eraseOp(returnOp);
+  return result;
+}
+
+struct WarpShuffleOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::WarpShuffleOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::WarpShuffleOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::WarpShuffleOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto mod = op->getParentOfType<ModuleOp>();
+    int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    SmallVector<Value> srcVals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    SmallVector<Value> lanes =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getLane(), rewriter);
+
+    // Butterflies within the warp map to the native xor shuffle.
+    DenseElementsAttr laneAttr;
+    if (op.getKind() == triton::ShuffleKind::XOR &&
+        matchPattern(op.getLane(), m_Constant(&laneAttr)) &&
+        laneAttr.isSplat()) {
+      int64_t mask = laneAttr.getSplatValue<APInt>().getSExtValue();
+      if (mask >= 0 && mask < warpSize) {
+        for (Value &val : srcVals)
+          val = shuffleXor(loc, rewriter, val, mask, target);
+        rewriter.replaceOp(op, getTypeConverter()->packLLElements(
+                                   loc, srcVals, rewriter, op.getType()));
+        return success();
+      }
+    }
+
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(warpSize));
+    SmallVector<Value> results;
+    for (auto [val, lane] : llvm::zip(srcVals, lanes)) {
+      Value srcLane;
+      switch (op.getKind()) {
+      case triton::ShuffleKind::IDX:
+        srcLane = and_(lane, i32_val(warpSize - 1));
+        break;
+      case triton::ShuffleKind::XOR:
+        srcLane = xor_(laneId, lane);
+        break;
+      case triton::ShuffleKind::UP:
+        srcLane = sub(laneId, lane);
+        break;
+      case triton::ShuffleKind::DOWN:
+        srcLane = add(laneId, lane);
+        break;
+      }
+      // Lanes reading out of the warp keep their value.
+      Value inWarp = icmp_ult(srcLane, i32_val(warpSize));
+      Value shuffled = shuffleIdx(loc, rewriter, val,
+                                  and_(srcLane, i32_val(warpSize - 1)), target);
+      results.push_back(select(inWarp, shuffled, val));
+    }
+    rewriter.replaceOp(op, getTypeConverter()->packLLElements(
+                               loc, results, rewriter, op.getType()));
+    return success();
+  }
+};
+
+struct WarpBallotOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::WarpBallotOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::WarpBallotOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::WarpBallotOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto mod = op->getParentOfType<ModuleOp>();
+    int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    SmallVector<Value> preds =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getPred(), rewriter);
+    SmallVector<Value> results;
+    for (Value pred : preds)
+      results.push_back(getTargetInfo(target).ballot(rewriter, loc, pred,
+                                                     /*threadMask=*/-1,
+                                                     warpSize));
+    rewriter.replaceOp(op, getTypeConverter()->packLLElements(
+                               loc, results, rewriter, op.getType()));
+    return success();
+  }
+};
+
+// Sub-group reductions built into SPIR-V take single instructions on GENX;
+// other combinations and targets go through a butterfly of xor shuffles.
+struct WarpReduceOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::WarpReduceOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::WarpReduceOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::WarpReduceOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto mod = op->getParentOfType<ModuleOp>();
+    int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    SmallVector<Value> vals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    std::optional<LLVM::SPIRVGroupOpKind> groupOp;
+    if (target == triton::Target::GENX && !vals.empty())
+      groupOp = LLVM::matchSPIRVGroupOp(op.getCombineOp(), vals[0].getType());
+    for (Value &val : vals) {
+      if (groupOp) {
+        val = LLVM::createSPIRVGroupOp(loc, rewriter, op, *groupOp,
+                                       spirv::GroupOperation::Reduce, val);
+        continue;
+      }
+      for (int mask = warpSize / 2; mask > 0; mask /= 2)
+        val = combine(rewriter, op.getCombineOp(), val,
+                      shuffleXor(loc, rewriter, val, mask, target));
+    }
+    rewriter.replaceOp(op, getTypeConverter()->packLLElements(
+                               loc, vals, rewriter, op.getType()));
+    return success();
+  }
+};
+
+// As reductions, with shuffles up for the scans that are not built into
+// SPIR-V.
+struct WarpScanOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::WarpScanOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::WarpScanOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::WarpScanOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto mod = op->getParentOfType<ModuleOp>();
+    int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    SmallVector<Value> vals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    std::optional<LLVM::SPIRVGroupOpKind> groupOp;
+    if (target == triton::Target::GENX && !vals.empty())
+      groupOp = LLVM::matchSPIRVGroupOp(op.getCombineOp(), vals[0].getType());
+    Value laneId;
+    if (!groupOp)
+      laneId = urem(getThreadId(rewriter, loc), i32_val(warpSize));
+    for (Value &val : vals) {
+      if (groupOp) {
+        val = LLVM::createSPIRVGroupOp(
+            loc, rewriter, op, *groupOp, spirv::GroupOperation::InclusiveScan,
+            val);
+        continue;
+      }
+      for (int delta = 1; delta < warpSize; delta *= 2) {
+        Value prev = shuffleUp(loc, rewriter, val, delta, target);
+        Value acc = combine(rewriter, op.getCombineOp(), prev, val);
+        val = select(icmp_uge(laneId, i32_val(delta)), acc, val);
+      }
+    }
+    rewriter.replaceOp(op, getTypeConverter()->packLLElements(
+                               loc, vals, rewriter, op.getType()));
+    return success();
+  }
+};
+} // namespace
+
+void mlir::triton::populateWarpOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit) {
+  patterns.add<WarpShuffleOpConversion>(typeConverter, target, benefit);
+  patterns.add<WarpBallotOpConversion>(typeConverter, target, benefit);
+  patterns.add<WarpReduceOpConversion>(typeConverter, target, benefit);
+  patterns.add<WarpScanOpConversion>(typeConverter, target, benefit);
+}
@@ -14,9 +14,10 @@ using namespace mlir::triton::gpu;
 //
 TritonGPUTypeConverter::TritonGPUTypeConverter(MLIRContext *context,
                                                int numWarps, int threadsPerWarp,
-                                               int numCTAs)
+                                               int numCTAs,
+                                               ShapeOrders shapeOrders)
     : context(context), numWarps(numWarps), threadsPerWarp(threadsPerWarp),
-      numCTAs(numCTAs) {
+      numCTAs(numCTAs), shapeOrders(std::move(shapeOrders)) {
   addConversion([](Type type) { return type; });
 
   // Add encoding for tensor
@@ -29,6 +30,11 @@ TritonGPUTypeConverter::TritonGPUTypeConverter(MLIRContext *context,
     triton::gpu::BlockedEncodingAttr encoding =
         getDefaultBlockedEncoding(this->context, shape, this->numWarps,
                                   this->threadsPerWarp, this->numCTAs);
+    auto it = this->shapeOrders.find(SmallVector<int64_t>(shape));
+    if (it != this->shapeOrders.end())
+      encoding = triton::gpu::BlockedEncodingAttr::get(
+          this->context, shape, encoding.getSizePerThread(), it->second,
+          this->numWarps, this->threadsPerWarp, this->numCTAs);
     return RankedTensorType::get(shape, tensorType.getElementType(), encoding);
   });
 
@@ -6,6 +6,7 @@
 #include "mlir/Dialect/Index/IR/IndexDialect.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "triton/Analysis/AxisInfo.h"
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
@@ -13,6 +14,7 @@
 #include "triton/Target/PTX/TmaMetadata.h"
 #include "llvm/ADT/APSInt.h"
 #include <numeric>
+#include <set>
 
 #define GEN_PASS_CLASSES
 #include "triton/Conversion/TritonToTritonGPU/Passes.h.inc"
@@ -458,6 +460,53 @@ struct TritonScanPattern : public OpConversionPattern<triton::ScanOp> {
   }
 };
 
+template <typename OpT>
+struct TritonWarpCombinePattern : public OpConversionPattern<OpT> {
+  using OpConversionPattern<OpT>::OpConversionPattern;
+  using OpAdaptor = typename OpT::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(OpT op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto newOp = rewriter.create<OpT>(op.getLoc(), adaptor.getSrc().getType(),
+                                      adaptor.getSrc());
+    addNamedAttrs(newOp, adaptor.getAttributes());
+
+    auto &newCombineOp = newOp.getCombineOp();
+    rewriter.cloneRegionBefore(op.getCombineOp(), newCombineOp,
+                               newCombineOp.end());
+    rewriter.replaceOp(op, newOp.getResult());
+    return success();
+  }
+};
+
+struct TritonGatherPattern : public OpConversionPattern<triton::GatherOp> {
+  using OpConversionPattern<triton::GatherOp>::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::GatherOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto indicesType = adaptor.getIndices().getType().cast<RankedTensorType>();
+    auto srcType = adaptor.getSrc().getType().cast<RankedTensorType>();
+    Value src = adaptor.getSrc();
+    // Give the source the layout of the indices when that keeps the gather
+    // within the warps.
+    auto sharedSrcType =
+        RankedTensorType::get(srcType.getShape(), srcType.getElementType(),
+                              indicesType.getEncoding());
+    if (isWarpLocalGather(sharedSrcType, indicesType, op.getAxis()))
+      src = rewriter.create<triton::gpu::ConvertLayoutOp>(op.getLoc(),
+                                                          sharedSrcType, src);
+    auto retType = RankedTensorType::get(indicesType.getShape(),
+                                         srcType.getElementType(),
+                                         indicesType.getEncoding());
+    addNamedAttrs(rewriter.replaceOpWithNewOp<triton::GatherOp>(
+                      op, retType, src, adaptor.getIndices(), op.getAxis()),
+                  adaptor.getAttributes());
+    return success();
+  }
+};
+
 class TritonFuncOpPattern : public OpConversionPattern<triton::FuncOp> {
 public:
   using OpConversionPattern<triton::FuncOp>::OpConversionPattern;
@@ -520,10 +569,15 @@ void populateTritonPatterns(TritonGPUTypeConverter &typeConverter,
       GenericOpPattern<triton::ElementwiseInlineAsmOp>, TritonReducePattern,
       GenericOpPattern<triton::ReduceReturnOp>, TritonScanPattern,
       GenericOpPattern<triton::ScanReturnOp>,
+      GenericOpPattern<triton::WarpShuffleOp>,
+      GenericOpPattern<triton::WarpBallotOp>,
+      TritonWarpCombinePattern<triton::WarpReduceOp>,
+      TritonWarpCombinePattern<triton::WarpScanOp>,
       GenericOpPattern<triton::MakeRangeOp>, TritonExpandDimsPattern,
       TritonTransPattern, TritonDotPattern, GenericOpPattern<triton::LoadOp>,
-      GenericOpPattern<triton::StoreOp>, GenericOpPattern<triton::HistogramOp>,
-      GenericOpPattern<triton::ExternElementwiseOp>,
+      GenericOpPattern<triton::StoreOp>, GenericOpPattern<triton::PrefetchOp>,
+      GenericOpPattern<triton::HistogramOp>, GenericOpPattern<triton::SortOp>,
+      TritonGatherPattern, GenericOpPattern<triton::ExternElementwiseOp>,
       GenericOpPattern<triton::PrintOp>, GenericOpPattern<triton::AssertOp>,
       GenericOpPattern<triton::AtomicCASOp>,
       GenericOpPattern<triton::AtomicRMWOp>, GenericOpPattern<ReturnOp>,
@@ -719,6 +773,80 @@ void populateCFPatterns(TritonGPUTypeConverter &typeConverter,
 }
 //
 
+// The order of the dimensions of each tensor shape that most loads and stores
+// of that shape access contiguously, where it is not the default row-major one.
+// Tensors of those shapes start with the order the coalescing pass gives their
+// memory accesses, so that fewer layout conversions are inserted and removed.
+// Shapes reshaped without reordering keep the default encoding, the only one
+// their lowering supports.
+TritonGPUTypeConverter::ShapeOrders getPreferredOrders(ModuleOp mod) {
+  ModuleAxisInfoAnalysis axisInfoAnalysis(mod);
+  std::map<SmallVector<int64_t>, std::map<SmallVector<unsigned>, int>> votes;
+  std::set<SmallVector<int64_t>> defaultShapes;
+  mod.walk([&](Operation *op) {
+    if (auto reshape = dyn_cast<triton::ReshapeOp>(op)) {
+      if (!reshape.getAllowReorder()) {
+        defaultShapes.insert(SmallVector<int64_t>(
+            reshape.getSrc().getType().cast<RankedTensorType>().getShape()));
+        defaultShapes.insert(
+            SmallVector<int64_t>(reshape.getType().getShape()));
+      }
+      return;
+    }
+    Value ptr;
+    if (auto load = dyn_cast<triton::LoadOp>(op))
+      ptr = load.getPtr();
+    else if (auto store = dyn_cast<triton::StoreOp>(op))
+      ptr = store.getPtr();
+    else
+      return;
+    RankedTensorType tensorTy;
+    SmallVector<unsigned> order;
+    if (auto ptrTy = ptr.getType().dyn_cast<triton::PointerType>()) {
+      tensorTy = ptrTy.getPointeeType().dyn_cast<RankedTensorType>();
+      if (!tensorTy)
+        return;
+      auto makeTensorPtr = getMakeTensorPtrOp(ptr);
+      order.append(makeTensorPtr.getOrder().begin(),
+                   makeTensorPtr.getOrder().end());
+    } else if ((tensorTy = ptr.getType().dyn_cast<RankedTensorType>())) {
+      auto contiguity = axisInfoAnalysis.getAxisInfo(ptr)->getContiguity();
+      // Accesses without contiguous elements do not prefer any order.
+      if (*std::max_element(contiguity.begin(), contiguity.end()) <= 1)
+        return;
+      order.resize(contiguity.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](unsigned x, unsigned y) {
+        return contiguity[x] > contiguity[y];
+      });
+    } else {
+      return;
+    }
+    if (tensorTy.getRank() > 1)
+      ++votes[SmallVector<int64_t>(tensorTy.getShape())][order];
+  });
+
+  TritonGPUTypeConverter::ShapeOrders orders;
+  for (auto &[shape, orderVotes] : votes) {
+    if (defaultShapes.count(shape))
+      continue;
+    SmallVector<unsigned> defaultOrder(shape.size());
+    std::iota(defaultOrder.rbegin(), defaultOrder.rend(), 0);
+    // The default order wins ties.
+    SmallVector<unsigned> best = defaultOrder;
+    int bestVotes = orderVotes[defaultOrder];
+    for (auto &[order, count] : orderVotes) {
+      if (count > bestVotes) {
+        best = order;
+        bestVotes = count;
+      }
+    }
+    if (best != defaultOrder)
+      orders[shape] = best;
+  }
+  return orders;
+}
+
 class ConvertTritonToTritonGPU
     : public ConvertTritonToTritonGPUBase<ConvertTritonToTritonGPU> {
 public:
@@ -737,7 +865,7 @@ public:
     ModuleOp mod = getOperation();
     // type converter
     TritonGPUTypeConverter typeConverter(context, numWarps, threadsPerWarp,
-                                         numCTAs);
+                                         numCTAs, getPreferredOrders(mod));
     TritonGPUConversionTarget target(*context, typeConverter);
     // rewrite patterns
     RewritePatternSet patterns(context);
@@ -359,6 +359,18 @@ void triton::StoreOp::getCanonicalizationPatterns(RewritePatternSet &results,
   results.add<CanonicalizeMaskedStorePattern>(context);
 }
 
+//-- PrefetchOp --
+mlir::LogicalResult mlir::triton::PrefetchOp::verify() {
+  if (!getMask())
+    return success();
+  if (isTensorPointerType(getPtr().getType()))
+    return emitOpError("tensor pointers are masked by their boundaries and "
+                       "can't take a mask");
+  if (getMask().getType() != getI1SameShape(getPtr().getType()))
+    return emitOpError("mask must have the shape of the pointers");
+  return success();
+}
+
 //-- TransOp --
 OpFoldResult mlir::triton::TransOp::fold(FoldAdaptor adaptor) {
   // transpose(x, order=[0, 1, ...]) -> x
@@ -457,6 +469,21 @@ LogicalResult mlir::triton::DotOp::verify() {
         "element types of operands A and B must have same bit width");
   auto aEncoding = aTy.getEncoding();
   auto bEncoding = bTy.getEncoding();
+  if (aTy.getRank() == 3) {
+    // batched dots are decomposed before layouts are assigned
+    auto cTy = getC().getType().cast<RankedTensorType>();
+    if (bTy.getRank() != 3 || cTy.getRank() != 3)
+      return emitError("operands must all be three dimensional");
+    if (aTy.getShape()[0] != bTy.getShape()[0] ||
+        cTy.getShape()[0] != aTy.getShape()[0] ||
+        aTy.getShape()[2] != bTy.getShape()[1] ||
+        cTy.getShape()[1] != aTy.getShape()[1] ||
+        cTy.getShape()[2] != bTy.getShape()[2])
+      return emitError("operand shapes are not compatible for batched matmul");
+    if (aEncoding || bEncoding)
+      return emitError("batched dot operands cannot have an encoding");
+    return mlir::success();
+  }
   if (!aEncoding && !bEncoding)
     return mlir::success();
   // Verify that the encodings are valid.
@@ -468,6 +495,33 @@ LogicalResult mlir::triton::DotOp::verify() {
                                                      bEncoding);
 }
 
+//-- DotScaledOp --
+LogicalResult mlir::triton::DotScaledOp::verify() {
+  auto aTy = getA().getType().cast<RankedTensorType>();
+  auto bTy = getB().getType().cast<RankedTensorType>();
+  auto cTy = getC().getType().cast<RankedTensorType>();
+  auto aScaleTy = getAScale().getType().cast<RankedTensorType>();
+  auto bScaleTy = getBScale().getType().cast<RankedTensorType>();
+  if (aTy.getRank() != 2 || bTy.getRank() != 2 || cTy.getRank() != 2)
+    return emitError("operands must be two dimensional");
+  if (aTy.getShape()[1] != bTy.getShape()[0] ||
+      cTy.getShape()[0] != aTy.getShape()[0] ||
+      cTy.getShape()[1] != bTy.getShape()[1])
+    return emitError("operand shapes are not compatible for matmul");
+  if (aTy.getElementType().getIntOrFloatBitWidth() !=
+      bTy.getElementType().getIntOrFloatBitWidth())
+    return emitError(
+        "element types of operands A and B must have same bit width");
+  if (aScaleTy.getShape() != ArrayRef<int64_t>{aTy.getShape()[0]} ||
+      bScaleTy.getShape() != ArrayRef<int64_t>{bTy.getShape()[1]})
+    return emitError("scales must have one element per row of A and per "
+                     "column of B");
+  if (aScaleTy.getElementType() != cTy.getElementType() ||
+      bScaleTy.getElementType() != cTy.getElementType())
+    return emitError("scales must have the element type of the accumulator");
+  return mlir::success();
+}
+
 //-- MakeRangeOp --
 OpFoldResult MakeRangeOp::fold(FoldAdaptor adaptor) {
   // make_range(start, start + 1) -> constant(start)
@@ -705,6 +759,60 @@ llvm::SmallVector<Type> ScanOp::getElementTypes() {
 
 unsigned ScanOp::getNumOperands() { return this->getOperands().size(); }
 
+//-- GatherOp --
+mlir::LogicalResult mlir::triton::GatherOp::verify() {
+  auto srcTy = getSrc().getType().cast<RankedTensorType>();
+  auto indicesTy = getIndices().getType().cast<RankedTensorType>();
+  auto resultTy = getResult().getType().cast<RankedTensorType>();
+  int axis = getAxis();
+  if (indicesTy.getRank() != srcTy.getRank())
+    return emitOpError("indices and source must have the same rank");
+  if (axis < 0 || axis >= srcTy.getRank())
+    return emitOpError() << "axis " << axis << " is out of range";
+  for (int d = 0; d < srcTy.getRank(); ++d) {
+    if (d != axis && indicesTy.getDimSize(d) != srcTy.getDimSize(d))
+      return emitOpError() << "indices and source sizes differ along axis "
+                           << d;
+  }
+  if (resultTy.getShape() != indicesTy.getShape() ||
+      resultTy.getElementType() != srcTy.getElementType())
+    return emitOpError("result must have the shape of the indices and the "
+                       "element type of the source");
+  return success();
+}
+
+//-- SortOp --
+mlir::LogicalResult mlir::triton::SortOp::verify() {
+  auto srcTy = getSrc().getType().cast<RankedTensorType>();
+  int axis = getAxis();
+  if (axis < 0 || axis >= srcTy.getRank())
+    return emitOpError() << "axis " << axis << " is out of range";
+  int64_t axisSize = srcTy.getDimSize(axis);
+  if (!llvm::isPowerOf2_64(axisSize))
+    return emitOpError() << "the size of the sorted axis must be a power of "
+                            "two, got "
+                         << axisSize;
+  return success();
+}
+
+//-- WarpReduceOp --
+mlir::LogicalResult mlir::triton::WarpReduceOp::verifyRegions() {
+  return verifyRegionsImpl<mlir::triton::ReduceReturnOp>(*this);
+}
+
+llvm::SmallVector<Type> WarpReduceOp::getElementTypes() {
+  return getElementTypesImpl(this->getOperands());
+}
+
+//-- WarpScanOp --
+mlir::LogicalResult mlir::triton::WarpScanOp::verifyRegions() {
+  return verifyRegionsImpl<mlir::triton::ScanReturnOp>(*this);
+}
+
+llvm::SmallVector<Type> WarpScanOp::getElementTypes() {
+  return getElementTypesImpl(this->getOperands());
+}
+
 //-- SplatOp --
 OpFoldResult SplatOp::fold(FoldAdaptor adaptor) {
   auto value = adaptor.getSrc();
@@ -101,6 +101,10 @@ public:
 
 // sum(x[:, :, None] * y[None, :, :], 1)
 // -> dot(x, y)
+// Products of at least 16x16 may use TF32, as tl.dot does by default. Skinny
+// ones (M, N or K below 16, e.g. GEMV) are only combined for f32 operands and
+// stay exact, which keeps them off tensor cores and DPAS that need full tiles:
+// the FMA lowering of the dot still avoids materializing the M x K x N product.
 class CombineBroadcastMulReducePattern : public mlir::RewritePattern {
 private:
   static bool isAddF32(const Operation *op) {
@@ -109,13 +113,15 @@ private:
     return false;
   }
 
-  static SmallVector<int> getEqualIndices(ArrayRef<int64_t> x,
-                                          ArrayRef<int64_t> y) {
-    SmallVector<int> res;
-    for (int i = 0; i < x.size(); ++i)
-      if (x[i] == y[i])
-        res.push_back(i);
-    return res;
+  // `x` if `value` is broadcast(expand_dims(x, axis)), or expand_dims(x, axis)
+  // when the broadcast dimension is 1.
+  static Value getExpandedOperand(Value value, int axis) {
+    if (auto broadcastOp = value.getDefiningOp<triton::BroadcastOp>())
+      value = broadcastOp.getSrc();
+    auto expandOp = value.getDefiningOp<triton::ExpandDimsOp>();
+    if (!expandOp || expandOp.getAxis() != axis)
+      return {};
+    return expandOp.getSrc();
   }
 
 public:
@@ -126,7 +132,8 @@ public:
   mlir::LogicalResult matchAndRewrite(mlir::Operation *op,
                                       mlir::PatternRewriter &rewriter) const {
     auto reduceOp = llvm::dyn_cast<triton::ReduceOp>(op);
-    if (!reduceOp)
+    if (!reduceOp || reduceOp.getNumOperands() != 1 ||
+        reduceOp.getAxis() != 1)
       return mlir::failure();
     // only support reduce with simple addition
     Region &combineOp = reduceOp.getCombineOp();
@@ -140,49 +147,137 @@ public:
         reduceOp.getOperand(0).getDefiningOp());
     if (!mulOp)
       return mlir::failure();
-    // mul operand has to be broadcast
-    auto broadcastLhsOp = llvm::dyn_cast_or_null<triton::BroadcastOp>(
-        mulOp.getOperand(0).getDefiningOp());
-    if (!broadcastLhsOp)
+    // mul operands have to be broadcast expand dims, in either order
+    Value lhs = getExpandedOperand(mulOp.getLhs(), 2);
+    Value rhs = getExpandedOperand(mulOp.getRhs(), 0);
+    if (!lhs || !rhs) {
+      lhs = getExpandedOperand(mulOp.getRhs(), 2);
+      rhs = getExpandedOperand(mulOp.getLhs(), 0);
+    }
+    if (!lhs || !rhs)
       return mlir::failure();
-    auto broadcastRhsOp = llvm::dyn_cast_or_null<triton::BroadcastOp>(
-        mulOp.getOperand(1).getDefiningOp());
-    if (!broadcastRhsOp)
+    auto lhsTy = lhs.getType().cast<RankedTensorType>();
+    auto rhsTy = rhs.getType().cast<RankedTensorType>();
+    // both operands span the reduced dimension
+    if (lhsTy.getRank() != 2 || rhsTy.getRank() != 2 ||
+        lhsTy.getShape()[1] != rhsTy.getShape()[0] ||
+        lhsTy.getElementType() != rhsTy.getElementType())
       return mlir::failure();
-    // broadcast operand is expand dims
-    auto expandLhsOp = llvm::dyn_cast_or_null<triton::ExpandDimsOp>(
-        broadcastLhsOp.getOperand().getDefiningOp());
-    if (!expandLhsOp)
+    bool isSkinny = lhsTy.getShape()[0] < 16 || lhsTy.getShape()[1] < 16 ||
+                    rhsTy.getShape()[1] < 16;
+    if (isSkinny && !lhsTy.getElementType().isF32())
       return mlir::failure();
-    auto expandRhsOp = llvm::dyn_cast_or_null<triton::ExpandDimsOp>(
-        broadcastRhsOp.getOperand().getDefiningOp());
-    if (!expandRhsOp)
-      return mlir::failure();
-    // get not-broadcast dimensions
-    int expandLhsAxis = expandLhsOp.getAxis();
-    int expandRhsAxis = expandRhsOp.getAxis();
-    if (expandLhsAxis != 2 || expandRhsAxis != 0)
-      return mlir::failure();
-    auto broadcastLhsShape =
-        broadcastLhsOp.getType().cast<ShapedType>().getShape();
-    auto broadcastRhsShape =
-        broadcastLhsOp.getType().cast<ShapedType>().getShape();
-    if (broadcastLhsShape[2] < 16 || broadcastRhsShape[0] < 16)
-      return mlir::failure();
-    Type newAccType =
-        RankedTensorType::get({broadcastLhsShape[0], broadcastRhsShape[2]},
-                              broadcastLhsOp.getOperand()
-                                  .getType()
-                                  .cast<ShapedType>()
-                                  .getElementType());
+    // the accumulator has the type of the sum
+    auto accType = reduceOp.getResult()[0].getType().cast<RankedTensorType>();
     rewriter.setInsertionPoint(op);
-    auto newAcc = rewriter.create<triton::SplatOp>(
-        op->getLoc(), newAccType,
-        rewriter.create<arith::ConstantOp>(op->getLoc(),
-                                           rewriter.getF32FloatAttr(0)));
-    rewriter.replaceOpWithNewOp<triton::DotOp>(op, expandLhsOp.getOperand(),
-                                               expandRhsOp.getOperand(), newAcc,
-                                               true, 0);
+    auto newAcc = rewriter.create<arith::ConstantOp>(
+        op->getLoc(), accType, rewriter.getZeroAttr(accType));
+    rewriter.replaceOpWithNewOp<triton::DotOp>(op, lhs, rhs, newAcc,
+                                               /*allowTF32=*/!isSkinny, 0);
+    return mlir::success();
+  }
+};
+
+// dot_scaled(a, sa, b, sb, c)
+// -> dot(a, b, 0) * (sa[:, None] * sb[None, :]) + c
+// The scaling then happens on the dot result in the layout of the
+// accumulator, so it is folded into the accumulation of each K block by the
+// MMA lowerings instead of requiring a pass over the product in memory.
+class DecomposeDotScaledPattern
+    : public mlir::OpRewritePattern<triton::DotScaledOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+
+  mlir::LogicalResult
+  matchAndRewrite(triton::DotScaledOp op,
+                  mlir::PatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto accType = op.getType().cast<RankedTensorType>();
+    auto zero = rewriter.create<arith::ConstantOp>(
+        loc, accType, rewriter.getZeroAttr(accType));
+    Value product =
+        rewriter.create<triton::DotOp>(loc, op.getA(), op.getB(), zero,
+                                       op.getAllowTF32(),
+                                       op.getMaxNumImpreciseAcc());
+    auto broadcastScale = [&](Value scale, int axis) -> Value {
+      Value expanded = rewriter.create<triton::ExpandDimsOp>(loc, scale, axis);
+      return rewriter.create<triton::BroadcastOp>(loc, accType, expanded);
+    };
+    Value scale = rewriter.create<arith::MulFOp>(
+        loc, broadcastScale(op.getAScale(), 1),
+        broadcastScale(op.getBScale(), 0));
+    Value scaled = rewriter.create<arith::MulFOp>(loc, product, scale);
+    rewriter.replaceOpWithNewOp<arith::AddFOp>(op, scaled, op.getC());
+    return mlir::success();
+  }
+};
+
+// dot(a[B, M, K], b[B, K, N], c)
+// -> reduce(a[:, :, :, None] * b[:, None, :, :], axis=2) + c
+// The MMA lowerings are two dimensional, so batched dots are computed with
+// FMAs on a layout that spreads the batch over the warps, which suits the
+// small per-batch matrices this is used for.
+class DecomposeBatchedDotPattern
+    : public mlir::OpRewritePattern<triton::DotOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+
+  mlir::LogicalResult
+  matchAndRewrite(triton::DotOp op,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto accType = op.getType().cast<RankedTensorType>();
+    if (accType.getRank() != 3)
+      return mlir::failure();
+    Location loc = op.getLoc();
+    Type elemType = accType.getElementType();
+    auto shape = accType.getShape();
+    int64_t K = op.getA().getType().cast<RankedTensorType>().getShape()[2];
+    auto prodType =
+        RankedTensorType::get({shape[0], shape[1], K, shape[2]}, elemType);
+    // operands are promoted to the accumulator type, then expanded to
+    // [B, M, K, N]
+    auto expandOperand = [&](Value operand, int axis) -> Value {
+      auto type = operand.getType().cast<RankedTensorType>();
+      if (type.getElementType() != elemType) {
+        auto promotedType = type.cloneWith(std::nullopt, elemType);
+        if (elemType.isa<FloatType>())
+          operand =
+              rewriter.create<triton::FpToFpOp>(loc, promotedType, operand);
+        else
+          operand =
+              rewriter.create<arith::ExtSIOp>(loc, promotedType, operand);
+      }
+      Value expanded =
+          rewriter.create<triton::ExpandDimsOp>(loc, operand, axis);
+      return rewriter.create<triton::BroadcastOp>(loc, prodType, expanded);
+    };
+    Value a = expandOperand(op.getA(), 3);
+    Value b = expandOperand(op.getB(), 1);
+    bool isFloat = elemType.isa<FloatType>();
+    Value prod =
+        isFloat ? rewriter.create<arith::MulFOp>(loc, a, b).getResult()
+                : rewriter.create<arith::MulIOp>(loc, a, b).getResult();
+
+    auto reduce =
+        rewriter.create<triton::ReduceOp>(loc, ValueRange{prod}, /*axis=*/2);
+    {
+      OpBuilder::InsertionGuard guard(rewriter);
+      Block *combine = rewriter.createBlock(&reduce.getCombineOp(), {},
+                                            {elemType, elemType}, {loc, loc});
+      Value lhs = combine->getArgument(0);
+      Value rhs = combine->getArgument(1);
+      Value sum =
+          isFloat ? rewriter.create<arith::AddFOp>(loc, lhs, rhs).getResult()
+                  : rewriter.create<arith::AddIOp>(loc, lhs, rhs).getResult();
+      rewriter.create<triton::ReduceReturnOp>(loc, sum);
+    }
+    Value dot = reduce.getResult()[0];
+    if (isZero(op.getC()))
+      rewriter.replaceOp(op, dot);
+    else if (isFloat)
+      rewriter.replaceOpWithNewOp<arith::AddFOp>(op, dot, op.getC());
+    else
+      rewriter.replaceOpWithNewOp<arith::AddIOp>(op, dot, op.getC());
     return mlir::success();
   }
 };
@@ -207,6 +302,8 @@ public:
     // patterns.add<CombineAddPtrPattern>(context);
     patterns.add<CombineBroadcastConstantPattern>(context);
     patterns.add<CombineBroadcastMulReducePattern>(context);
+    patterns.add<DecomposeDotScaledPattern>(context);
+    patterns.add<DecomposeBatchedDotPattern>(context);
 
     if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed())
       signalPassFailure();
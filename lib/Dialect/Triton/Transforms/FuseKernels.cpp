@@ -0,0 +1,145 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Pass/Pass.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include <array>
+#include <memory>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+constexpr StringLiteral kGridAttr = "tt.fusion_grid";
+
+struct FusedKernel {
+  tt::FuncOp func;
+  std::array<int32_t, 3> grid;
+  unsigned firstArg;
+};
+
+Value i32Constant(OpBuilder &builder, Location loc, int64_t value) {
+  return builder.create<arith::ConstantIntOp>(loc, value, /*width=*/32);
+}
+
+// Clones the body of `kernel` at the insertion point of `builder`, with the
+// program ids and counts it reads those of its own grid, in which it is
+// program `local` of the fused kernel.
+void cloneKernelBody(OpBuilder &builder, const FusedKernel &kernel,
+                     tt::FuncOp fused, Value local) {
+  Location loc = kernel.func.getLoc();
+  auto [gx, gy, gz] = kernel.grid;
+  Value cx = i32Constant(builder, loc, gx);
+  Value x = builder.create<arith::RemSIOp>(loc, local, cx);
+  Value yz = builder.create<arith::DivSIOp>(loc, local, cx);
+  Value cy = i32Constant(builder, loc, gy);
+  Value y = builder.create<arith::RemSIOp>(loc, yz, cy);
+  Value z = builder.create<arith::DivSIOp>(loc, yz, cy);
+  std::array<Value, 3> pids = {x, y, z};
+  std::array<int32_t, 3> nums = {gx, gy, gz};
+
+  IRMapping mapping;
+  Block &body = kernel.func.getBody().front();
+  for (BlockArgument arg : body.getArguments())
+    mapping.map(arg, fused.getArgument(kernel.firstArg + arg.getArgNumber()));
+  for (Operation &op : body.without_terminator()) {
+    Operation *clone = builder.clone(op, mapping);
+    clone->walk([&](Operation *nested) {
+      OpBuilder replacer(nested);
+      Value replacement;
+      if (auto pid = dyn_cast<tt::GetProgramIdOp>(nested))
+        replacement = pids[pid.getAxisAsInt()];
+      else if (auto num = dyn_cast<tt::GetNumProgramsOp>(nested))
+        replacement =
+            i32Constant(replacer, nested->getLoc(), nums[num.getAxis()]);
+      if (!replacement)
+        return;
+      nested->getResult(0).replaceAllUsesWith(replacement);
+      nested->erase();
+    });
+  }
+}
+
+class FuseKernelsPass : public TritonFuseKernelsBase<FuseKernelsPass> {
+public:
+  FuseKernelsPass() = default;
+  FuseKernelsPass(const std::string &name) { this->name = name; }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    SmallVector<FusedKernel> kernels;
+    SmallVector<Type> argTypes;
+    SmallVector<DictionaryAttr> argAttrs;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      auto gridAttr = func->getAttrOfType<DenseI32ArrayAttr>(kGridAttr);
+      if (!gridAttr)
+        continue;
+      if (gridAttr.size() != 3 || !func.getBody().hasOneBlock() ||
+          func.getNumResults() != 0) {
+        func.emitError("cannot be fused: kernels must have one block, no "
+                       "results and a 3D grid");
+        return signalPassFailure();
+      }
+      FusedKernel kernel{func, {gridAttr[0], gridAttr[1], gridAttr[2]},
+                         static_cast<unsigned>(argTypes.size())};
+      kernels.push_back(kernel);
+      for (unsigned i = 0; i < func.getNumArguments(); ++i) {
+        argTypes.push_back(func.getArgument(i).getType());
+        argAttrs.push_back(func.getArgAttrDict(i));
+      }
+    }
+    if (kernels.empty())
+      return;
+
+    // first, as the kernel of a module is the first function of its text
+    auto builder = OpBuilder::atBlockBegin(mod.getBody());
+    Location loc = kernels.front().func.getLoc();
+    auto fused = builder.create<tt::FuncOp>(
+        loc, name, builder.getFunctionType(argTypes, {}));
+    for (auto [i, attrs] : llvm::enumerate(argAttrs))
+      if (attrs)
+        fused.setArgAttrs(i, attrs);
+    builder.setInsertionPointToStart(fused.addEntryBlock());
+
+    // Kernel `k` runs the programs [start, start + its grid size) of the
+    // fused kernel, whose grid is one dimensional.
+    Value pid = builder.create<tt::GetProgramIdOp>(
+        loc, builder.getI32Type(),
+        tt::ProgramIDDimAttr::get(builder.getContext(), tt::ProgramIDDim::X));
+    int64_t start = 0;
+    for (auto [k, kernel] : llvm::enumerate(kernels)) {
+      int64_t size = int64_t(kernel.grid[0]) * kernel.grid[1] * kernel.grid[2];
+      Value local = builder.create<arith::SubIOp>(
+          loc, pid, i32Constant(builder, loc, start));
+      start += size;
+      if (k + 1 == kernels.size()) {
+        cloneKernelBody(builder, kernel, fused, local);
+        break;
+      }
+      Value end = i32Constant(builder, loc, start);
+      Value inRange = builder.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::slt, pid, end);
+      auto ifOp = builder.create<scf::IfOp>(loc, inRange, /*withElse=*/true);
+      OpBuilder thenBuilder = ifOp.getThenBodyBuilder();
+      cloneKernelBody(thenBuilder, kernel, fused, local);
+      builder = ifOp.getElseBodyBuilder();
+    }
+    OpBuilder::atBlockEnd(&fused.getBody().front()).create<tt::ReturnOp>(loc);
+
+    for (FusedKernel &kernel : kernels)
+      kernel.func.erase();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::triton::createFuseKernelsPass(std::string name) {
+  return std::make_unique<FuseKernelsPass>(name);
+}
@@ -0,0 +1,197 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/LoopInvariantCodeMotionUtils.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include "llvm/ADT/SmallPtrSet.h"
+
+#include <memory>
+#include <optional>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+// Collects the function arguments and global scratch allocations the pointers
+// of `ptr` are derived from. Returns false if some of them have another
+// origin, e.g. a pointer loaded from memory or converted from an integer.
+bool collectRoots(Value ptr, SmallPtrSetImpl<Value> &roots) {
+  SmallVector<Value> worklist = {ptr};
+  DenseSet<Value> visited;
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    if (!visited.insert(value).second)
+      continue;
+    if (auto arg = value.dyn_cast<BlockArgument>()) {
+      Operation *parent = arg.getOwner()->getParentOp();
+      if (isa<FunctionOpInterface>(parent) && arg.getOwner()->isEntryBlock()) {
+        roots.insert(arg);
+        continue;
+      }
+      auto forOp = dyn_cast<scf::ForOp>(parent);
+      if (!forOp || arg == forOp.getInductionVar())
+        return false;
+      unsigned idx = arg.getArgNumber() - forOp.getNumInductionVars();
+      worklist.push_back(forOp.getInitArgs()[idx]);
+      worklist.push_back(forOp.getBody()->getTerminator()->getOperand(idx));
+      continue;
+    }
+    Operation *def = value.getDefiningOp();
+    if (isa<tt::GlobalScratchAllocOp>(def)) {
+      roots.insert(value);
+    } else if (auto addPtr = dyn_cast<tt::AddPtrOp>(def)) {
+      worklist.push_back(addPtr.getPtr());
+    } else if (auto advance = dyn_cast<tt::AdvanceOp>(def)) {
+      worklist.push_back(advance.getPtr());
+    } else if (auto makeTensorPtr = dyn_cast<tt::MakeTensorPtrOp>(def)) {
+      worklist.push_back(makeTensorPtr.getBase());
+    } else if (isa<tt::SplatOp, tt::BroadcastOp, tt::ExpandDimsOp,
+                   tt::ReshapeOp, tt::TransOp, tt::BitcastOp>(def)) {
+      worklist.push_back(def->getOperand(0));
+    } else if (auto select = dyn_cast<arith::SelectOp>(def)) {
+      worklist.push_back(select.getTrueValue());
+      worklist.push_back(select.getFalseValue());
+    } else if (auto forOp = dyn_cast<scf::ForOp>(def)) {
+      unsigned idx = value.cast<OpResult>().getResultNumber();
+      worklist.push_back(forOp.getInitArgs()[idx]);
+      worklist.push_back(forOp.getBody()->getTerminator()->getOperand(idx));
+    } else if (auto ifOp = dyn_cast<scf::IfOp>(def)) {
+      unsigned idx = value.cast<OpResult>().getResultNumber();
+      worklist.push_back(ifOp.thenYield().getOperand(idx));
+      worklist.push_back(ifOp.elseYield().getOperand(idx));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool isRestrict(Value root) {
+  auto arg = root.dyn_cast<BlockArgument>();
+  if (!arg)
+    return false;
+  auto funcOp = cast<FunctionOpInterface>(arg.getOwner()->getParentOp());
+  return funcOp.getArgAttr(arg.getArgNumber(), "tt.restrict") != nullptr;
+}
+
+bool mayAlias(const SmallPtrSetImpl<Value> &lhs,
+              const SmallPtrSetImpl<Value> &rhs) {
+  for (Value a : lhs) {
+    for (Value b : rhs) {
+      if (a == b)
+        return true;
+      // distinct scratch allocations and arguments never overlap
+      if (a.getDefiningOp<tt::GlobalScratchAllocOp>() ||
+          b.getDefiningOp<tt::GlobalScratchAllocOp>())
+        continue;
+      if (!isRestrict(a) && !isRestrict(b))
+        return true;
+    }
+  }
+  return false;
+}
+
+// The memory a loop may write, as the roots of the pointers it stores to.
+// Returns false if the loop writes memory in another way.
+bool collectStoredRoots(scf::ForOp forOp, SmallPtrSetImpl<Value> &roots) {
+  WalkResult result = forOp.getBody()->walk([&](Operation *op) {
+    if (auto store = dyn_cast<tt::StoreOp>(op))
+      return collectRoots(store.getPtr(), roots) ? WalkResult::advance()
+                                                 : WalkResult::interrupt();
+    // debugging output does not go to memory the kernel reads
+    if (isa<tt::PrintOp, tt::AssertOp>(op))
+      return WalkResult::advance();
+    if (op->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+      return WalkResult::advance();
+    auto memInterface = dyn_cast<MemoryEffectOpInterface>(op);
+    if (!memInterface)
+      return WalkResult::interrupt();
+    return memInterface.hasEffect<MemoryEffects::Write>()
+               ? WalkResult::interrupt()
+               : WalkResult::advance();
+  });
+  return !result.wasInterrupted();
+}
+
+bool isHoistableLoad(tt::LoadOp load, const SmallPtrSetImpl<Value> &stored) {
+  if (load.getIsVolatile() || tt::isTensorPointerType(load.getPtr().getType()))
+    return false;
+  SmallPtrSet<Value, 4> roots;
+  return collectRoots(load.getPtr(), roots) && !mayAlias(roots, stored);
+}
+
+bool hasConstantTrips(scf::ForOp forOp) {
+  std::optional<int64_t> lb = getConstantIntValue(forOp.getLowerBound());
+  std::optional<int64_t> ub = getConstantIntValue(forOp.getUpperBound());
+  return lb && ub && *lb < *ub;
+}
+
+// Masks `load` by whether `forOp` runs, so that once hoisted it does not read
+// memory the loop would not have.
+void maskByTripCondition(tt::LoadOp load, scf::ForOp forOp, Value &cond) {
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  if (!cond)
+    cond = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt,
+                                         forOp.getLowerBound(),
+                                         forOp.getUpperBound());
+  Value mask = cond;
+  if (auto tensorTy = load.getType().dyn_cast<RankedTensorType>()) {
+    auto maskTy = RankedTensorType::get(
+        tensorTy.getShape(), builder.getI1Type(), tensorTy.getEncoding());
+    mask = builder.create<tt::SplatOp>(loc, maskTy, cond);
+  }
+  if (Value loadMask = load.getMask())
+    mask = builder.create<arith::AndIOp>(loc, loadMask, mask);
+  load.getMaskMutable().assign(mask);
+}
+
+void hoistInvariantLoads(scf::ForOp forOp) {
+  SmallPtrSet<Value, 4> stored;
+  bool knownStores = collectStoredRoots(forOp, stored);
+  bool runs = hasConstantTrips(forOp);
+  Value cond;
+  moveLoopInvariantCode(
+      forOp->getRegions(),
+      [&](Value value, Region *) { return forOp.isDefinedOutsideOfLoop(value); },
+      [&](Operation *op, Region *) {
+        if (auto load = dyn_cast<tt::LoadOp>(op))
+          return knownStores && isHoistableLoad(load, stored);
+        return isMemoryEffectFree(op) && isSpeculatable(op);
+      },
+      [&](Operation *op, Region *) {
+        auto load = dyn_cast<tt::LoadOp>(op);
+        if (load && !runs)
+          maskByTripCondition(load, forOp, cond);
+        forOp.moveOutOfLoop(op);
+      });
+}
+
+class HoistInvariantLoadsPass
+    : public TritonHoistInvariantLoadsBase<HoistInvariantLoadsPass> {
+public:
+  void runOnOperation() override {
+    // Inner loops first, so the loads they hoist are candidates of the loops
+    // containing them.
+    SmallVector<scf::ForOp> loops;
+    getOperation().walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+    for (scf::ForOp forOp : loops)
+      hoistInvariantLoads(forOp);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::triton::createHoistInvariantLoadsPass() {
+  return std::make_unique<HoistInvariantLoadsPass>();
+}
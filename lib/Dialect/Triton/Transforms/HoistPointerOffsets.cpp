@@ -0,0 +1,192 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/LogicalResult.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include "llvm/ADT/MapVector.h"
+
+#include <memory>
+#include <optional>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+// An iteration argument holding `addptr(splat(base), offsets)`, only moved by
+// uniform amounts in the loop. `steps` are the moves of the pointers derived
+// from it, in program order.
+struct HoistCandidate {
+  unsigned idx;
+  Value base;
+  Value offsets;
+  tt::SplatOp splat;
+  SmallVector<tt::AddPtrOp> steps;
+};
+
+// Whether every element of `offset` is equal: the splat of a scalar or a splat
+// constant.
+bool isUniformOffset(Value offset) {
+  if (offset.getDefiningOp<tt::SplatOp>())
+    return true;
+  DenseElementsAttr attr;
+  return matchPattern(offset, m_Constant(&attr)) && attr.isSplat();
+}
+
+// The scalar every element of the uniform `offset` is equal to, created before
+// `op` if it is a constant.
+Value getUniformOffset(Value offset, Operation *op) {
+  assert(isUniformOffset(offset) && "offset is not uniform");
+  if (auto splat = offset.getDefiningOp<tt::SplatOp>())
+    return splat.getSrc();
+  DenseElementsAttr attr;
+  matchPattern(offset, m_Constant(&attr));
+  OpBuilder builder(op);
+  return builder.create<arith::ConstantOp>(
+      op->getLoc(), attr.getSplatValue<Attribute>().cast<TypedAttr>());
+}
+
+std::optional<HoistCandidate> findCandidate(scf::ForOp forOp, unsigned idx) {
+  Value arg = forOp.getRegionIterArg(idx);
+  auto tensorTy = arg.getType().dyn_cast<RankedTensorType>();
+  if (!tensorTy || !tensorTy.getElementType().isa<tt::PointerType>())
+    return std::nullopt;
+  auto init = forOp.getInitArgs()[idx].getDefiningOp<tt::AddPtrOp>();
+  if (!init)
+    return std::nullopt;
+  auto splat = init.getPtr().getDefiningOp<tt::SplatOp>();
+  if (!splat)
+    return std::nullopt;
+
+  HoistCandidate candidate{idx, splat.getSrc(), init.getOffset(), splat, {}};
+  // Pointers moved by uniform amounts stay the splat of a scalar plus the
+  // invariant offsets; their other uses read them as they are.
+  SmallVector<Value> worklist = {arg};
+  DenseSet<Value> derived = {arg};
+  while (!worklist.empty()) {
+    Value ptr = worklist.pop_back_val();
+    for (Operation *user : ptr.getUsers()) {
+      auto addPtr = dyn_cast<tt::AddPtrOp>(user);
+      if (!addPtr || addPtr.getPtr() != ptr || derived.contains(addPtr))
+        continue;
+      if (!isUniformOffset(addPtr.getOffset()))
+        continue;
+      derived.insert(addPtr);
+      worklist.push_back(addPtr);
+    }
+  }
+  // Only loops moving the pointers gain anything.
+  Value next = forOp.getBody()->getTerminator()->getOperand(idx);
+  if (next == arg || !derived.contains(next))
+    return std::nullopt;
+  // Derived pointers are defined in the body, so walking it visits each one
+  // after the pointers it is derived from.
+  forOp.getBody()->walk([&](tt::AddPtrOp addPtr) {
+    if (derived.contains(addPtr))
+      candidate.steps.push_back(addPtr);
+  });
+  return candidate;
+}
+
+// Rewrites the iteration argument of `candidate` to the scalar base of its
+// pointers, so each iteration moves one scalar, and recomputes the tensors of
+// pointers the loop reads from the loop-invariant offsets.
+void hoistOffsets(scf::ForOp forOp, HoistCandidate &candidate) {
+  Value arg = forOp.getRegionIterArg(candidate.idx);
+  Type tensorTy = arg.getType();
+  Type ptrTy = candidate.base.getType();
+  OpBuilder builder(forOp);
+  auto materialize = [&](Value scalar, Location loc) {
+    Value ptrs =
+        builder.create<tt::SplatOp>(loc, candidate.splat.getType(), scalar);
+    return builder.create<tt::AddPtrOp>(loc, tensorTy, ptrs, candidate.offsets);
+  };
+
+  // Scalar equivalents of the tensors of pointers, created next to them. The
+  // argument itself only changes type at the end.
+  llvm::MapVector<Value, Value> scalars;
+  DenseSet<Operation *> scalarSteps;
+  scalars[arg] = arg;
+  for (tt::AddPtrOp addPtr : candidate.steps) {
+    Value step = getUniformOffset(addPtr.getOffset(), addPtr);
+    builder.setInsertionPoint(addPtr);
+    auto scalar = builder.create<tt::AddPtrOp>(
+        addPtr.getLoc(), ptrTy, scalars.lookup(addPtr.getPtr()), step);
+    scalars[addPtr] = scalar;
+    scalarSteps.insert(scalar);
+  }
+
+  // Other users of each tensor read it recomputed from its scalar.
+  for (auto [ptrs, scalar] : scalars) {
+    SmallVector<OpOperand *> uses;
+    for (OpOperand &use : ptrs.getUses()) {
+      auto addPtr = dyn_cast<tt::AddPtrOp>(use.getOwner());
+      bool isStep = addPtr && addPtr.getPtr() == ptrs &&
+                    (scalars.count(addPtr) || scalarSteps.contains(addPtr));
+      bool isNext = isa<scf::YieldOp>(use.getOwner()) &&
+                    use.getOwner()->getParentOp() == forOp &&
+                    use.getOperandNumber() == candidate.idx;
+      if (!isStep && !isNext)
+        uses.push_back(&use);
+    }
+    if (uses.empty())
+      continue;
+    if (ptrs == arg)
+      builder.setInsertionPointToStart(forOp.getBody());
+    else
+      builder.setInsertionPointAfterValue(scalar);
+    Value recomputed = materialize(scalar, ptrs.getLoc());
+    for (OpOperand *use : uses)
+      use->set(recomputed);
+  }
+
+  // The loop carries the scalar instead of the tensor.
+  Operation *yield = forOp.getBody()->getTerminator();
+  Value next = yield->getOperand(candidate.idx);
+  yield->setOperand(candidate.idx, scalars.lookup(next));
+  forOp.getInitArgsMutable()[candidate.idx].assign(candidate.base);
+  arg.setType(ptrTy);
+  Value result = forOp.getResult(candidate.idx);
+  result.setType(ptrTy);
+  if (!result.use_empty()) {
+    builder.setInsertionPointAfter(forOp);
+    tt::AddPtrOp recomputed = materialize(result, forOp.getLoc());
+    result.replaceAllUsesExcept(recomputed,
+                                recomputed.getPtr().getDefiningOp());
+  }
+  for (tt::AddPtrOp addPtr : llvm::reverse(candidate.steps))
+    addPtr.erase();
+}
+
+class HoistPointerOffsetsPass
+    : public TritonHoistPointerOffsetsBase<HoistPointerOffsetsPass> {
+public:
+  void runOnOperation() override {
+    // Outer loops first, so the pointers they recompute become candidates of
+    // the loops they contain.
+    SmallVector<scf::ForOp> loops;
+    getOperation().walk<WalkOrder::PreOrder>(
+        [&](scf::ForOp forOp) { loops.push_back(forOp); });
+    for (scf::ForOp forOp : loops) {
+      for (unsigned idx = 0; idx < forOp.getNumRegionIterArgs(); ++idx) {
+        if (std::optional<HoistCandidate> candidate =
+                findCandidate(forOp, idx))
+          hoistOffsets(forOp, *candidate);
+      }
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::triton::createHoistPointerOffsetsPass() {
+  return std::make_unique<HoistPointerOffsetsPass>();
+}
@@ -0,0 +1,188 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Interfaces/Utils/InferIntRangeCommon.h"
+#include "mlir/Pass/Pass.h"
+#include "llvm/ADT/SetVector.h"
+
+#include "triton/Analysis/RangeAnalysis.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+#include <memory>
+#include <optional>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+const RangeInfo *getRangeInfo(DataFlowSolver &solver, Value value) {
+  auto *lattice = solver.lookupState<dataflow::Lattice<RangeInfo>>(value);
+  if (!lattice || lattice->getValue().isUninitialized())
+    return nullptr;
+  return &lattice->getValue();
+}
+
+std::optional<ConstantIntRanges> getRange(DataFlowSolver &solver,
+                                          Value value) {
+  if (const RangeInfo *info = getRangeInfo(solver, value))
+    return info->getRange();
+  return std::nullopt;
+}
+
+Type getI32Type(Type type) {
+  auto i32Ty = IntegerType::get(type.getContext(), 32);
+  if (auto tensorTy = type.dyn_cast<RankedTensorType>())
+    return RankedTensorType::get(tensorTy.getShape(), i32Ty,
+                                 tensorTy.getEncoding());
+  return i32Ty;
+}
+
+// Rewrites i64 scalars and tensors whose elements fit in i32 into i32 ones.
+// The ops computing them are cloned in i32 as long as their i64 operands fit
+// in i32 too, since wrapping arithmetic then gives the exact result.
+class OffsetNarrower {
+public:
+  explicit OffsetNarrower(DataFlowSolver &solver) : solver(solver) {}
+
+  bool fitsI32(Value value) const {
+    const RangeInfo *info = getRangeInfo(solver, value);
+    return info && info->fitsSigned(32);
+  }
+
+  Value narrow(Value value) {
+    if (Value known = narrowed.lookup(value))
+      return known;
+    Type i32Ty = getI32Type(value.getType());
+    Operation *def = value.getDefiningOp();
+    OpBuilder builder(value.getContext());
+    if (def)
+      builder.setInsertionPointAfter(def);
+    else
+      builder.setInsertionPointToStart(value.getParentBlock());
+
+    Value result;
+    auto cstOp = dyn_cast_or_null<arith::ConstantOp>(def);
+    auto extOp = dyn_cast_or_null<arith::ExtSIOp>(def);
+    if (extOp && extOp.getIn().getType() == i32Ty) {
+      result = extOp.getIn();
+    } else if (cstOp && cstOp.getValue().isa<IntegerAttr>()) {
+      APInt cst = cstOp.getValue().cast<IntegerAttr>().getValue();
+      result = builder.create<arith::ConstantOp>(
+          cstOp.getLoc(), IntegerAttr::get(i32Ty, cst.trunc(32)));
+    } else if (cstOp && cstOp.getValue().isa<DenseIntElementsAttr>()) {
+      auto attr = cstOp.getValue().cast<DenseIntElementsAttr>().mapValues(
+          getElementTypeOrSelf(i32Ty),
+          [](const APInt &cst) { return cst.trunc(32); });
+      result = builder.create<arith::ConstantOp>(cstOp.getLoc(), attr);
+    } else if (isNarrowable(def)) {
+      IRMapping mapping;
+      for (Value operand : def->getOperands())
+        if (getElementTypeOrSelf(operand.getType()).isInteger(64))
+          mapping.map(operand, narrow(operand));
+      Operation *newOp = builder.clone(*def, mapping);
+      newOp->getResult(0).setType(i32Ty);
+      result = newOp->getResult(0);
+    } else {
+      result = builder.create<arith::TruncIOp>(value.getLoc(), i32Ty, value);
+    }
+    return narrowed[value] = result;
+  }
+
+private:
+  bool isNarrowable(Operation *op) const {
+    if (!op || !isa<arith::AddIOp, arith::SubIOp, arith::MulIOp,
+                    arith::DivSIOp, arith::RemSIOp, arith::MaxSIOp,
+                    arith::MinSIOp, arith::SelectOp, tt::SplatOp,
+                    tt::BroadcastOp, tt::ExpandDimsOp, tt::ReshapeOp,
+                    tt::TransOp, tt::gpu::ConvertLayoutOp>(op))
+      return false;
+    return llvm::all_of(op->getOperands(), [&](Value operand) {
+      return !getElementTypeOrSelf(operand.getType()).isInteger(64) ||
+             fitsI32(operand);
+    });
+  }
+
+  DataFlowSolver &solver;
+  DenseMap<Value, Value> narrowed;
+};
+
+// Erases the ops of `worklist` that are unused, then the ops only they used.
+void eraseDeadOps(llvm::SetVector<Operation *> &worklist) {
+  while (!worklist.empty()) {
+    Operation *op = worklist.pop_back_val();
+    if (!isOpTriviallyDead(op))
+      continue;
+    for (Value operand : op->getOperands())
+      if (Operation *def = operand.getDefiningOp())
+        worklist.insert(def);
+    op->erase();
+  }
+}
+
+class IntRangeOptimizePass
+    : public TritonIntRangeOptimizeBase<IntRangeOptimizePass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    std::unique_ptr<DataFlowSolver> solver = createDataFlowSolver();
+    solver->load<RangeAnalysis>();
+    if (failed(solver->initializeAndRun(mod)))
+      return signalPassFailure();
+
+    // Every range is looked up before the IR changes.
+    SmallVector<std::pair<arith::CmpIOp, bool>> knownCmps;
+    mod.walk([&](arith::CmpIOp cmpOp) {
+      std::optional<ConstantIntRanges> lhs = getRange(*solver, cmpOp.getLhs());
+      std::optional<ConstantIntRanges> rhs = getRange(*solver, cmpOp.getRhs());
+      if (!lhs || !rhs)
+        return;
+      if (std::optional<bool> result = intrange::evaluatePred(
+              static_cast<intrange::CmpPredicate>(cmpOp.getPredicate()), *lhs,
+              *rhs))
+        knownCmps.push_back({cmpOp, *result});
+    });
+
+    OffsetNarrower narrower(*solver);
+    SmallVector<tt::AddPtrOp> wideAddPtrs;
+    mod.walk([&](tt::AddPtrOp addPtrOp) {
+      Value offset = addPtrOp.getOffset();
+      if (getElementTypeOrSelf(offset.getType()).isInteger(64) &&
+          narrower.fitsI32(offset))
+        wideAddPtrs.push_back(addPtrOp);
+    });
+
+    llvm::SetVector<Operation *> deadOps;
+    for (tt::AddPtrOp addPtrOp : wideAddPtrs) {
+      Value offset = addPtrOp.getOffset();
+      Value narrowOffset = narrower.narrow(offset);
+      addPtrOp.getOffsetMutable().assign(narrowOffset);
+      if (Operation *def = offset.getDefiningOp())
+        deadOps.insert(def);
+    }
+
+    for (auto [cmpOp, result] : knownCmps) {
+      OpBuilder builder(cmpOp);
+      Type type = cmpOp.getType();
+      TypedAttr attr = builder.getBoolAttr(result);
+      if (auto tensorTy = type.dyn_cast<RankedTensorType>())
+        attr = DenseElementsAttr::get(tensorTy, result);
+      Value cst = builder.create<arith::ConstantOp>(cmpOp.getLoc(), attr);
+      cmpOp.getResult().replaceAllUsesWith(cst);
+      deadOps.insert(cmpOp);
+    }
+    eraseDeadOps(deadOps);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::triton::createIntRangeOptimizePass() {
+  return std::make_unique<IntRangeOptimizePass>();
+}
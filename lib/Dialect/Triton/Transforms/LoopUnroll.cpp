@@ -0,0 +1,84 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Utils/Utils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/LogicalResult.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include <memory>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+constexpr const char *kUnrollAttrName = "tt.unroll";
+
+// Innermost loops accumulating a dot or a reduction: the short K loops whose
+// per-iteration overhead unrolling removes.
+bool isReductionLoop(scf::ForOp forOp) {
+  bool hasNestedLoop = false;
+  bool hasReduction = false;
+  forOp.getBody()->walk([&](Operation *op) {
+    if (isa<LoopLikeOpInterface>(op))
+      hasNestedLoop = true;
+    else if (isa<tt::DotOp, tt::ReduceOp>(op))
+      hasReduction = true;
+  });
+  return hasReduction && !hasNestedLoop;
+}
+
+// The factor `forOp` is unrolled by: its `tt.unroll` attribute if it has one,
+// `defaultFactor` for reduction loops otherwise.
+int64_t getUnrollFactor(scf::ForOp forOp, int64_t defaultFactor) {
+  if (auto attr = forOp->getAttrOfType<IntegerAttr>(kUnrollAttrName))
+    return attr.getInt();
+  return isReductionLoop(forOp) ? defaultFactor : 1;
+}
+
+class LoopUnrollPass : public TritonLoopUnrollBase<LoopUnrollPass> {
+public:
+  explicit LoopUnrollPass(int unrollFactor) {
+    this->unrollFactor = unrollFactor;
+  }
+
+  void runOnOperation() override {
+    // Collect first: unrolling creates new loops for the remainder.
+    SmallVector<std::pair<scf::ForOp, int64_t>> loops;
+    getOperation().walk([&](scf::ForOp forOp) {
+      int64_t factor = getUnrollFactor(forOp, unrollFactor);
+      forOp->removeAttr(kUnrollAttrName);
+      if (factor > 1)
+        loops.push_back({forOp, factor});
+    });
+    for (auto [forOp, factor] : loops) {
+      // Loops already known to run fewer iterations are unrolled fully.
+      if (std::optional<int64_t> tripCount = getConstantTripCount(forOp))
+        factor = std::min(factor, *tripCount);
+      if (factor > 1 && failed(loopUnrollByFactor(forOp, factor)))
+        forOp.emitRemark("cannot unroll loop by ") << factor;
+    }
+  }
+
+private:
+  static std::optional<int64_t> getConstantTripCount(scf::ForOp forOp) {
+    std::optional<int64_t> lb = getConstantIntValue(forOp.getLowerBound());
+    std::optional<int64_t> ub = getConstantIntValue(forOp.getUpperBound());
+    std::optional<int64_t> step = getConstantIntValue(forOp.getStep());
+    if (!lb || !ub || !step || *step <= 0)
+      return std::nullopt;
+    return *ub > *lb ? llvm::divideCeil(*ub - *lb, *step) : 0;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::triton::createLoopUnrollPass(int unrollFactor) {
+  return std::make_unique<LoopUnrollPass>(unrollFactor);
+}
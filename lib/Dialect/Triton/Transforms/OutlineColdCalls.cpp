@@ -0,0 +1,84 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include <memory>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+// Calls of functions taking and returning only scalars lower to plain calls,
+// while tensors would have to agree on a layout across the call.
+bool hasScalarSignature(tt::FuncOp funcOp) {
+  auto isScalar = [](Type type) {
+    if (auto ptrTy = type.dyn_cast<tt::PointerType>())
+      return !ptrTy.getPointeeType().isa<RankedTensorType>();
+    return type.isIntOrIndexOrFloat();
+  };
+  return llvm::all_of(funcOp.getArgumentTypes(), isScalar) &&
+         llvm::all_of(funcOp.getResultTypes(), isScalar);
+}
+
+// Calls under an `scf.if` only run on one side of a branch, which in kernels
+// is the slow or error path.
+bool isConditional(tt::CallOp callOp) {
+  return callOp->getParentOfType<scf::IfOp>() != nullptr;
+}
+
+// Functions reporting errors are outlined whatever their size, as inlining
+// them copies the message strings and the print lowering into each caller.
+bool isCold(tt::FuncOp funcOp, unsigned sizeThreshold) {
+  unsigned numOps = 0;
+  bool reportsErrors = false;
+  funcOp.walk([&](Operation *op) {
+    ++numOps;
+    reportsErrors |= isa<tt::AssertOp, tt::PrintOp>(op);
+  });
+  return reportsErrors || numOps >= sizeThreshold;
+}
+
+class OutlineColdCallsPass
+    : public TritonOutlineColdCallsBase<OutlineColdCallsPass> {
+public:
+  OutlineColdCallsPass() = default;
+  OutlineColdCallsPass(int sizeThreshold) {
+    this->sizeThreshold = sizeThreshold;
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    SymbolTable symbolTable(mod);
+    DenseMap<tt::FuncOp, SmallVector<tt::CallOp>> callSites;
+    mod.walk([&](tt::CallOp callOp) {
+      if (auto callee = symbolTable.lookup<tt::FuncOp>(callOp.getCallee()))
+        callSites[callee].push_back(callOp);
+    });
+
+    for (auto funcOp : mod.getOps<tt::FuncOp>()) {
+      auto noinline = funcOp->getAttrOfType<BoolAttr>("noinline");
+      if ((noinline && noinline.getValue()) || funcOp.isExternal() ||
+          !funcOp.isPrivate())
+        continue;
+      ArrayRef<tt::CallOp> calls = callSites.lookup(funcOp);
+      if (calls.empty() || !llvm::all_of(calls, isConditional) ||
+          !hasScalarSignature(funcOp) || !isCold(funcOp, sizeThreshold))
+        continue;
+      funcOp->setAttr("noinline", BoolAttr::get(&getContext(), true));
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass>
+mlir::triton::createOutlineColdCallsPass(int sizeThreshold) {
+  return std::make_unique<OutlineColdCallsPass>(sizeThreshold);
+}
@@ -100,61 +100,78 @@ struct MoveSplatAfterElementwisePattern
   }
 };
 
-// elementwise(broadcast(a)) => broadcast(elementwise(a))
-// This also generalizes to multiple arguments when the rest are splat-like
-// Not handled: multiple broadcasted arguments
-struct MoveBroadcastAfterElementwisePattern
+// Shape ops elementwise ops commute with. Reshapes allowed to reorder the
+// elements may do so differently for each operand.
+bool isMovableShapeOp(Operation *op) { return true; }
+bool isMovableShapeOp(triton::ReshapeOp op) {
+  return !op.getAllowReorder();
+}
+
+// elementwise(shape_op(a)) => shape_op(elementwise(a))
+// for the shape-only ops broadcast, expand_dims, trans and reshape, so that
+// elementwise ops run on the smallest shape their operands have. This also
+// generalizes to multiple arguments when the rest are splat-like, or the same
+// shape op of sources of the same shape.
+template <typename OpTy>
+struct MoveShapeOpAfterElementwisePattern
     : public mlir::OpTraitRewritePattern<mlir::OpTrait::Elementwise> {
 
-  MoveBroadcastAfterElementwisePattern(mlir::MLIRContext *context)
+  MoveShapeOpAfterElementwisePattern(mlir::MLIRContext *context)
       : OpTraitRewritePattern(context) {}
 
+  static RankedTensorType getSrcType(OpTy shapeOp) {
+    return shapeOp->getOperand(0).getType().template cast<RankedTensorType>();
+  }
+
   mlir::LogicalResult match(Operation *op) const override {
     if (!isMemoryEffectFree(op)) {
       return mlir::failure();
     }
 
-    auto operands = op->getOperands();
-    bool seenBroadcast = false;
-    ArrayRef<int64_t> srcShape;
-    for (auto operand : operands) {
+    OpTy seenShapeOp;
+    for (auto operand : op->getOperands()) {
       auto definingOp = operand.getDefiningOp();
       if (!definingOp) {
         return mlir::failure();
       }
-      auto getSrcShape = [](triton::BroadcastOp b) {
-        return b.getSrc().getType().cast<RankedTensorType>().getShape();
-      };
-      if (auto broadcastOp = llvm::dyn_cast<triton::BroadcastOp>(definingOp)) {
-        if (!seenBroadcast) {
-          seenBroadcast = true;
-          srcShape = getSrcShape(broadcastOp);
-        } else if (srcShape != getSrcShape(broadcastOp)) {
-          // If the broadcast have different types we cannot re-order.
+      if (auto shapeOp = llvm::dyn_cast<OpTy>(definingOp)) {
+        if (!isMovableShapeOp(shapeOp)) {
+          return mlir::failure();
+        }
+        if (!seenShapeOp) {
+          seenShapeOp = shapeOp;
+          continue;
+        }
+        // If they do not reshape the same way we cannot re-order.
+        auto srcTy = getSrcType(shapeOp);
+        auto seenSrcTy = getSrcType(seenShapeOp);
+        if (srcTy.getShape() != seenSrcTy.getShape() ||
+            srcTy.getEncoding() != seenSrcTy.getEncoding() ||
+            shapeOp->getAttrDictionary() != seenShapeOp->getAttrDictionary()) {
           return mlir::failure();
         }
       } else if (!isSplat(definingOp)) {
-        // Not splat or broadcast
+        // Not splat or the shape op
         return mlir::failure();
       }
     }
-    return mlir::success(seenBroadcast);
+    return mlir::success(static_cast<bool>(seenShapeOp));
   }
 
   void rewrite(Operation *op, mlir::PatternRewriter &rewriter) const override {
     auto loc = op->getLoc();
 
-    // Find broadcast op
+    // Find the shape op
     auto operands = op->getOperands();
-    triton::BroadcastOp broadcastOp;
+    OpTy shapeOp;
     for (auto operand : operands) {
-      broadcastOp = operand.getDefiningOp<triton::BroadcastOp>();
-      if (broadcastOp) {
+      shapeOp = operand.getDefiningOp<OpTy>();
+      if (shapeOp) {
         break;
       }
     }
 
-    auto srcTy = broadcastOp.getSrc().getType().dyn_cast<RankedTensorType>();
+    auto srcTy = getSrcType(shapeOp);
     auto srcShape = srcTy.getShape();
     auto srcEncoding = srcTy.getEncoding();
 
@@ -162,9 +179,8 @@ struct MoveBroadcastAfterElementwisePattern
     llvm::SmallVector<Value, 4> newOperands;
     for (auto operand : operands) {
       auto definingOp = operand.getDefiningOp();
-      if (auto broadcastSrcOp =
-              llvm::dyn_cast<triton::BroadcastOp>(definingOp)) {
-        newOperands.push_back(broadcastSrcOp.getSrc());
+      if (auto shapeSrcOp = llvm::dyn_cast<OpTy>(definingOp)) {
+        newOperands.push_back(shapeSrcOp->getOperand(0));
         continue;
       }
       auto elemTy =
@@ -186,7 +202,7 @@ struct MoveBroadcastAfterElementwisePattern
         newOperands.push_back(newConstant);
         continue;
       }
-      llvm_unreachable("Expected broadcast or splat");
+      llvm_unreachable("Expected the shape op or splat");
     }
 
     // Reshape results to match srcShape
@@ -198,13 +214,13 @@ struct MoveBroadcastAfterElementwisePattern
           RankedTensorType::get(srcShape, elemTy, srcEncoding));
     }
 
-    // Create new op and broadcast results
+    // Create new op and apply the shape op to its results
     auto newOp = cloneWithNewArgsAndResultTypes(rewriter, op, newOperands,
                                                 newResultTypes);
     for (unsigned iRes = 0; iRes < newResultTypes.size(); ++iRes) {
-      auto newResult = rewriter.create<triton::BroadcastOp>(
-          loc, resultTypes[iRes], newOp->getResult(iRes));
-      rewriter.replaceAllUsesWith(op->getResult(iRes), newResult);
+      auto newResult = cloneWithNewArgsAndResultTypes(
+          rewriter, shapeOp, newOp->getResult(iRes), resultTypes[iRes]);
+      rewriter.replaceAllUsesWith(op->getResult(iRes), newResult->getResult(0));
     }
   }
 };
@@ -231,8 +247,12 @@ public:
 
     patterns.add<CanonicalizePattern<triton::BroadcastOp>>(context);
     patterns.add<CanonicalizePattern<triton::ExpandDimsOp>>(context);
-    // elementwise(broadcast(a)) => broadcast(elementwise(a))
-    patterns.add<MoveBroadcastAfterElementwisePattern>(context);
+    // elementwise(shape_op(a)) => shape_op(elementwise(a))
+    patterns.add<MoveShapeOpAfterElementwisePattern<triton::BroadcastOp>,
+                 MoveShapeOpAfterElementwisePattern<triton::ExpandDimsOp>,
+                 MoveShapeOpAfterElementwisePattern<triton::TransOp>,
+                 MoveShapeOpAfterElementwisePattern<triton::ReshapeOp>>(
+        context);
     // elementwise(splat(a), splat(b), ...) => splat(elementwise(a, b, ...))
     patterns.add<MoveSplatAfterElementwisePattern>(context);
 
@@ -274,7 +274,7 @@ public:
 
   Operation *rewriteLoadStoreOp(OpBuilder &builder, Operation *op,
                                 std::stack<Operation *> &eraser) {
-    assert(isa<triton::LoadOp>(op) || isa<triton::StoreOp>(op));
+    assert(isa<triton::LoadOp, triton::StoreOp, triton::PrefetchOp>(op));
 
     // We only have to rewrite load/stores with tensor pointers
     auto ptr = op->getOperand(0);
@@ -297,6 +297,12 @@ public:
       assert(!storeOp.getMask());
       boundaryCheck = storeOp.getBoundaryCheck();
     }
+    // Prefetches never reach out of the bounds of the tensor pointer
+    SmallVector<int32_t> allDims;
+    if (isa<triton::PrefetchOp>(op)) {
+      allDims = llvm::to_vector(llvm::seq<int32_t>(0, info.length()));
+      boundaryCheck = allDims;
+    }
 
     // Generate new `ptr`, `mask` and `other`
     auto newPtr = info.generatePtr(builder, op->getLoc());
@@ -315,6 +321,9 @@ public:
       builder.create<triton::StoreOp>(storeOp.getLoc(), newPtr,
                                       storeOp.getValue(), newMask,
                                       storeOp.getCache(), storeOp.getEvict());
+    } else if (auto prefetchOp = dyn_cast<triton::PrefetchOp>(op)) {
+      builder.create<triton::PrefetchOp>(prefetchOp.getLoc(), newPtr, newMask,
+                                         prefetchOp.getCacheLevel());
     }
 
     // Erase the original operation
@@ -429,7 +438,7 @@ public:
       return rewriteMakeTensorPtrOp(builder, makeTensorPtrOp, eraser);
     } else if (auto advanceOp = dyn_cast<triton::AdvanceOp>(op)) {
       return rewriteAdvanceOp(builder, advanceOp, eraser);
-    } else if (isa<triton::LoadOp>(op) || isa<triton::StoreOp>(op)) {
+    } else if (isa<triton::LoadOp, triton::StoreOp, triton::PrefetchOp>(op)) {
       return rewriteLoadStoreOp(builder, op, eraser);
     } else if (op->getDialect()->getNamespace() == "scf" ||
                op->getDialect()->getNamespace() == "cf") {
@@ -485,7 +494,7 @@ public:
     // operations and make a canonicalization pass to optimize, which is much
     // So here we recursively build the IR, to be specific, we have to rewrite
     // `tt.make_tensor_ptr`, `tt.advance`, `tt.load`, `tt.store`,
-    // `scf.for` (tensor pointer usages may be in a loop fashion)
+    // `tt.prefetch`, `scf.for` (tensor pointer usages may be in a loop fashion)
     std::stack<Operation *> eraser;
     visitOperation(getOperation(), eraser);
 
@@ -0,0 +1,154 @@
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+#include "llvm/ADT/SetVector.h"
+
+#include "triton/Analysis/AxisInfo.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include <memory>
+#include <numeric>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+// The contiguity, divisibility and constancy known for each argument of a
+// call at its call site.
+using ArgInfo = SmallVector<AxisInfo>;
+
+struct CallSite {
+  tt::CallOp callOp;
+  ArgInfo argInfo;
+};
+
+// The call sites of a function sharing the same argument facts.
+struct CallSiteGroup {
+  ArgInfo argInfo;
+  SmallVector<tt::CallOp> callOps;
+};
+
+// The callers of every function come before it.
+SmallVector<tt::FuncOp> getCallersFirstOrder(ModuleOp mod) {
+  CallGraph<int> callGraph(mod);
+  SmallVector<FunctionOpInterface> funcs;
+  callGraph.walk<WalkOrder::PreOrder, WalkOrder::PostOrder>(
+      [](CallOpInterface callOp, FunctionOpInterface funcOp) {},
+      [&](FunctionOpInterface funcOp) { funcs.push_back(funcOp); });
+  SetVector<FunctionOpInterface> sortedFuncs(funcs.begin(), funcs.end());
+  SmallVector<tt::FuncOp> order;
+  for (FunctionOpInterface funcOp : llvm::reverse(sortedFuncs))
+    if (auto ttFuncOp = dyn_cast<tt::FuncOp>(funcOp.getOperation()))
+      order.push_back(ttFuncOp);
+  return order;
+}
+
+// Records the argument facts of the calls in `funcOp`, given the facts on its
+// own arguments its attributes hold.
+void recordCallSites(
+    tt::FuncOp funcOp, SymbolTable &symbolTable,
+    DenseMap<tt::FuncOp, SmallVector<CallSite>> &callSites) {
+  std::unique_ptr<DataFlowSolver> solver = createDataFlowSolver();
+  AxisInfoAnalysis *analysis = solver->load<AxisInfoAnalysis>();
+  if (failed(solver->initializeAndRun(funcOp)))
+    return;
+  funcOp.walk([&](tt::CallOp callOp) {
+    auto callee = symbolTable.lookup<tt::FuncOp>(callOp.getCallee());
+    if (!callee)
+      return;
+    ArgInfo argInfo;
+    for (Value operand : callOp.getOperands()) {
+      AxisInfo info = analysis->getLatticeElement(operand)->getValue();
+      if (info.getRank() == 0)
+        info = AxisInfo::getPessimisticValueState(operand);
+      // Known constants are not specialized on beyond their divisibility.
+      argInfo.push_back(AxisInfo(info.getContiguity(), info.getDivisibility(),
+                                 info.getConstancy()));
+    }
+    callSites[callee].push_back({callOp, std::move(argInfo)});
+  });
+}
+
+// Sets the facts on the scalar arguments of `funcOp` in the attributes the
+// analysis reads, keeping the facts the attributes already state.
+void setArgAttrs(tt::FuncOp funcOp, const ArgInfo &argInfo) {
+  for (auto [index, info] : llvm::enumerate(argInfo)) {
+    if (info.getRank() != 1)
+      continue;
+    auto setAttr = [&](StringRef attrName, int64_t value) {
+      if (auto attr = funcOp.getArgAttrOfType<IntegerAttr>(index, attrName))
+        value = std::gcd(value, attr.getInt());
+      funcOp.setArgAttr(
+          index, attrName,
+          IntegerAttr::get(IntegerType::get(funcOp.getContext(), 64), value));
+    };
+    setAttr("tt.contiguity", info.getContiguity(0));
+    setAttr("tt.divisibility", info.getDivisibility(0));
+    setAttr("tt.constancy", info.getConstancy(0));
+  }
+}
+
+// Clones `funcOp` for each distinct set of argument facts its call sites
+// have, and returns the versions of it.
+SmallVector<tt::FuncOp> specialize(tt::FuncOp funcOp,
+                                   ArrayRef<CallSite> callSites,
+                                   SymbolTable &symbolTable) {
+  // Functions whose calls are not all in the module are left alone.
+  if (callSites.empty() || funcOp.isExternal() || !funcOp.isPrivate())
+    return {funcOp};
+
+  SmallVector<CallSiteGroup> groups;
+  for (const CallSite &callSite : callSites) {
+    auto it = llvm::find_if(groups, [&](const CallSiteGroup &group) {
+      return group.argInfo == callSite.argInfo;
+    });
+    if (it == groups.end()) {
+      groups.push_back({callSite.argInfo, {}});
+      it = std::prev(groups.end());
+    }
+    it->callOps.push_back(callSite.callOp);
+  }
+
+  SmallVector<tt::FuncOp> versions;
+  for (auto [index, group] : llvm::enumerate(groups)) {
+    tt::FuncOp version = funcOp;
+    if (index > 0) {
+      version = funcOp.clone();
+      // Inserting renames the clone to a unique symbol.
+      symbolTable.insert(version, std::next(funcOp->getIterator()));
+      for (tt::CallOp callOp : group.callOps)
+        callOp.setCalleeAttr(FlatSymbolRefAttr::get(version));
+    }
+    setArgAttrs(version, group.argInfo);
+    versions.push_back(version);
+  }
+  return versions;
+}
+
+class SpecializeCallsPass
+    : public TritonSpecializeCallsBase<SpecializeCallsPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    SymbolTable symbolTable(mod);
+    // A function is specialized once all its callers, and so all its call
+    // sites, have been.
+    DenseMap<tt::FuncOp, SmallVector<CallSite>> callSites;
+    for (tt::FuncOp funcOp : getCallersFirstOrder(mod)) {
+      for (tt::FuncOp version :
+           specialize(funcOp, callSites.lookup(funcOp), symbolTable))
+        recordCallSites(version, symbolTable, callSites);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::triton::createSpecializeCallsPass() {
+  return std::make_unique<SpecializeCallsPass>();
+}
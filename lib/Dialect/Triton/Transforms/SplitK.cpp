@@ -0,0 +1,216 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/LogicalResult.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include <memory>
+#include <optional>
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+// A K loop of a GEMM: a top level scf.for accumulating one tt.dot into an
+// iteration argument, with every other iteration argument a pointer advanced
+// by a loop-invariant amount. `store` writes the accumulator, possibly cast to
+// the output element type, once the loop is done.
+struct SplitKCandidate {
+  scf::ForOp forOp;
+  unsigned accIdx;
+  tt::StoreOp store;
+};
+
+bool isDefinedOutside(Value v, scf::ForOp forOp) {
+  return !forOp->isAncestor(v.getParentRegion()->getParentOp());
+}
+
+// Returns whether iteration argument `idx` is a pointer moved by the same
+// distance on every iteration.
+bool isInvariantPointerStep(scf::ForOp forOp, unsigned idx) {
+  Value arg = forOp.getRegionIterArg(idx);
+  Value next = forOp.getBody()->getTerminator()->getOperand(idx);
+  if (auto addPtr = next.getDefiningOp<tt::AddPtrOp>())
+    return addPtr.getPtr() == arg &&
+           isDefinedOutside(addPtr.getOffset(), forOp);
+  if (auto advance = next.getDefiningOp<tt::AdvanceOp>())
+    return advance.getPtr() == arg &&
+           llvm::all_of(advance.getOffsets(), [&](Value offset) {
+             return isDefinedOutside(offset, forOp);
+           });
+  return false;
+}
+
+std::optional<SplitKCandidate> findCandidate(tt::FuncOp func) {
+  // Programs of the split are enumerated along the third grid dimension, and
+  // the kernel must not already update memory atomically.
+  bool unsupported = false;
+  SmallVector<tt::StoreOp> stores;
+  func.walk([&](Operation *op) {
+    if (auto pid = dyn_cast<tt::GetProgramIdOp>(op))
+      unsupported |= pid.getAxis() == tt::ProgramIDDim::Z;
+    else if (auto num = dyn_cast<tt::GetNumProgramsOp>(op))
+      unsupported |= num.getAxis() == 2;
+    else if (isa<tt::AtomicRMWOp, tt::AtomicCASOp>(op))
+      unsupported = true;
+    else if (auto store = dyn_cast<tt::StoreOp>(op))
+      stores.push_back(store);
+  });
+  if (unsupported || stores.size() != 1)
+    return std::nullopt;
+
+  // The stored value must be the accumulator, at most cast to the output type,
+  // written through a tensor of pointers.
+  tt::StoreOp store = stores.front();
+  if (!store.getPtr().getType().isa<RankedTensorType>())
+    return std::nullopt;
+  Type elemTy = getElementTypeOrSelf(store.getValue().getType());
+  if (!elemTy.isF32() && !elemTy.isF16())
+    return std::nullopt;
+  Value acc = store.getValue();
+  if (auto cast = acc.getDefiningOp())
+    if (isa<arith::TruncFOp, tt::FpToFpOp>(cast))
+      acc = cast->getOperand(0);
+  auto forOp = acc.getDefiningOp<scf::ForOp>();
+  if (!forOp || forOp->getParentOp() != func.getOperation() ||
+      !forOp.getInductionVar().getType().isInteger(32))
+    return std::nullopt;
+
+  unsigned accIdx = acc.cast<OpResult>().getResultNumber();
+  auto dot = forOp.getBody()
+                 ->getTerminator()
+                 ->getOperand(accIdx)
+                 .getDefiningOp<tt::DotOp>();
+  if (!dot || dot.getC() != forOp.getRegionIterArg(accIdx) ||
+      !acc.hasOneUse())
+    return std::nullopt;
+  for (unsigned i = 0; i < forOp.getNumResults(); ++i) {
+    if (i == accIdx)
+      continue;
+    if (!forOp.getResult(i).use_empty() || !isInvariantPointerStep(forOp, i))
+      return std::nullopt;
+  }
+  return SplitKCandidate{forOp, accIdx, store};
+}
+
+// Moves `init` forward by `iters` steps of the pointer update in the loop.
+Value skipIterations(OpBuilder &builder, Location loc, Value init,
+                     Operation *step, Value iters) {
+  if (auto addPtr = dyn_cast<tt::AddPtrOp>(step)) {
+    Value offset = addPtr.getOffset();
+    Type offsetTy = offset.getType();
+    Type offsetElemTy = getElementTypeOrSelf(offsetTy);
+    Value scale = iters;
+    if (!offsetElemTy.isInteger(32))
+      scale = builder.create<arith::ExtSIOp>(loc, offsetElemTy, scale);
+    if (offsetTy.isa<RankedTensorType>())
+      scale = builder.create<tt::SplatOp>(loc, offsetTy, scale);
+    Value distance = builder.create<arith::MulIOp>(loc, offset, scale);
+    return builder.create<tt::AddPtrOp>(loc, init.getType(), init, distance);
+  }
+  auto advance = cast<tt::AdvanceOp>(step);
+  SmallVector<Value> offsets;
+  for (Value offset : advance.getOffsets())
+    offsets.push_back(builder.create<arith::MulIOp>(loc, offset, iters));
+  return builder.create<tt::AdvanceOp>(loc, init.getType(), init, offsets);
+}
+
+void applySplitK(const SplitKCandidate &candidate, int splitK) {
+  scf::ForOp forOp = candidate.forOp;
+  Location loc = forOp.getLoc();
+  OpBuilder builder(forOp);
+
+  // Program `pid` runs iterations [pid * perSplit, (pid + 1) * perSplit) of
+  // the original loop.
+  Value pid = builder.create<tt::GetProgramIdOp>(
+      loc, builder.getI32Type(),
+      tt::ProgramIDDimAttr::get(builder.getContext(), tt::ProgramIDDim::Z));
+  Value lb = forOp.getLowerBound();
+  Value ub = forOp.getUpperBound();
+  Value step = forOp.getStep();
+  Value numIters = builder.create<arith::CeilDivSIOp>(
+      loc, builder.create<arith::SubIOp>(loc, ub, lb), step);
+  Value perSplit = builder.create<arith::CeilDivSIOp>(
+      loc, numIters,
+      builder.create<arith::ConstantIntOp>(loc, splitK, /*width=*/32));
+  Value skipped = builder.create<arith::MulIOp>(loc, pid, perSplit);
+  Value newLb = builder.create<arith::AddIOp>(
+      loc, lb, builder.create<arith::MulIOp>(loc, skipped, step));
+  Value newUb = builder.create<arith::MinSIOp>(
+      loc, ub,
+      builder.create<arith::AddIOp>(
+          loc, newLb, builder.create<arith::MulIOp>(loc, perSplit, step)));
+  forOp.getLowerBoundMutable().assign(newLb);
+  forOp.getUpperBoundMutable().assign(newUb);
+
+  // Only the first program adds the initial value of the accumulator.
+  Operation *yield = forOp.getBody()->getTerminator();
+  for (unsigned i = 0; i < forOp.getNumResults(); ++i) {
+    Value init = forOp.getInitArgs()[i];
+    Value newInit;
+    if (i == candidate.accIdx) {
+      auto accTy = init.getType().cast<RankedTensorType>();
+      Value zero = builder.create<arith::ConstantOp>(
+          loc, accTy, builder.getZeroAttr(accTy));
+      Value zeroPid = builder.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, pid,
+          builder.create<arith::ConstantIntOp>(loc, 0, /*width=*/32));
+      newInit = builder.create<arith::SelectOp>(loc, zeroPid, init, zero);
+    } else {
+      newInit = skipIterations(builder, loc, init,
+                               yield->getOperand(i).getDefiningOp(), skipped);
+    }
+    forOp.getInitArgsMutable()[i].assign(newInit);
+  }
+
+  // The partial products of all programs are summed in the output.
+  tt::StoreOp store = candidate.store;
+  builder.setInsertionPoint(store);
+  builder.create<tt::AtomicRMWOp>(
+      store.getLoc(), store.getValue().getType(), tt::RMWOp::FADD,
+      store.getPtr(), store.getValue(), store.getMask(),
+      tt::MemSemantic::RELAXED, tt::MemSyncScope::GPU);
+  store.erase();
+}
+
+class SplitKPass : public TritonSplitKBase<SplitKPass> {
+public:
+  explicit SplitKPass(int splitK) { this->splitK = splitK; }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    if (splitK <= 1)
+      return;
+    // The grid is multiplied for the whole module, so every kernel in it must
+    // be split.
+    SmallVector<SplitKCandidate> candidates;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (!func.isPublic())
+        continue;
+      std::optional<SplitKCandidate> candidate = findCandidate(func);
+      if (!candidate)
+        return;
+      candidates.push_back(*candidate);
+    }
+    if (candidates.empty())
+      return;
+    for (const SplitKCandidate &candidate : candidates)
+      applySplitK(candidate, splitK);
+    mod->setAttr("tt.split-k",
+                 IntegerAttr::get(IntegerType::get(mod.getContext(), 32),
+                                  splitK.getValue()));
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::triton::createSplitKPass(int splitK) {
+  return std::make_unique<SplitKPass>(splitK);
+}
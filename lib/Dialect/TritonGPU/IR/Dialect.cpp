@@ -165,7 +165,7 @@ SmallVector<unsigned> getContigPerThread(Attribute layout) {
   } else if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>()) {
     auto parentLayout = sliceLayout.getParent();
     return getContigPerThread(parentLayout);
-  } else if (layout.isa<DpasEncodingAttr>()) {
+  } else if (auto dpasLayout = layout.dyn_cast<DpasEncodingAttr>()) {
     // From the DPAS layout:
     //                   warp 0
     //    ----------------/\-----------------
@@ -174,8 +174,9 @@ SmallVector<unsigned> getContigPerThread(Attribute layout) {
     //    ....
     //    [ 0   1   2   3   ......  14  15 ]
     //      ^
-    // Each thread operates on 1 element per row and 8 elements per column.
-    return {8, 1};
+    // Each thread operates on 1 element per row and repeatCount elements per
+    // column.
+    return {dpasLayout.getRepeatCount(), 1};
   } else {
     return getSizePerThread(layout);
   }
@@ -918,13 +919,14 @@ SmallVector<unsigned> DpasEncodingAttr::getSizePerThread() const {
   //    [ 0   1   2   3   ......  14  15 ]
   //    ....
   //    [ 0   1   2   3   ......  14  15 ]
-  // Each thread operates on a column, each column has 8 elements.
-  return {8, 1};
+  // Each thread operates on a column, each column has repeatCount elements.
+  return {getRepeatCount(), 1};
 }
 SmallVector<unsigned>
 DpasEncodingAttr::getShapePerCTATile(ArrayRef<int64_t> tensorShape) const {
-  // Given by threadsPerWarp ([1,16]) * warpsPerCTA ([8,1]) * warpsPerCTA.
-  return {8 * getWarpsPerCTA()[0], 16 * getWarpsPerCTA()[1]};
+  // Given by sizePerThread ([RC,1]) * threadsPerWarp ([1,16]) * warpsPerCTA.
+  return {getRepeatCount() * getWarpsPerCTA()[0],
+          getExecutionSize() * getWarpsPerCTA()[1]};
 }
 
 SmallVector<unsigned>
@@ -933,10 +935,10 @@ DpasEncodingAttr::getElemsPerThread(ArrayRef<int64_t> shape, Type eltTy) const {
   assert(rank == 2 && "Unexpected rank of dpas layout");
 
   SmallVector<unsigned> elemsPerThread(rank);
-  constexpr unsigned elemsPerThreadPerTile = 8;
+  SmallVector<unsigned> shapePerCTATile = getShapePerCTATile(shape);
   unsigned elemsRow =
-      ceil<unsigned>(shape[0], 8 * getWarpsPerCTA()[0]) * elemsPerThreadPerTile;
-  unsigned elemsCol = ceil<unsigned>(shape[1], 16 * getWarpsPerCTA()[1]);
+      ceil<unsigned>(shape[0], shapePerCTATile[0]) * getRepeatCount();
+  unsigned elemsCol = ceil<unsigned>(shape[1], shapePerCTATile[1]);
   elemsPerThread[0] = elemsRow;
   elemsPerThread[1] = elemsCol;
   return elemsPerThread;
@@ -947,6 +949,14 @@ unsigned DpasEncodingAttr::getTotalElemsPerThread(ArrayRef<int64_t> shape,
   return product<unsigned>(getElemsPerThread(shape, eltTy));
 }
 
+unsigned DotOperandEncodingAttr::getDPASBitWidth(Type elemType) const {
+  // A non-zero kWidth is the number of elements per DPAS channel of the type
+  // the dot is computed in, which may be wider than the element type.
+  if (unsigned kWidth = getKWidth())
+    return 32u / kWidth;
+  return elemType.getIntOrFloatBitWidth();
+}
+
 SmallVector<int64_t>
 DotOperandEncodingAttr::getDPASElemsPerInstr(unsigned bitWidth) const {
   // Constraints on PVC for D[M,N] = A[M,K] * B[K,M] + C[M,N]
@@ -954,10 +964,11 @@ DotOperandEncodingAttr::getDPASElemsPerInstr(unsigned bitWidth) const {
   // N = exec_size = SIMD_width = 16
   // SD = 8
   // K = SD * number of packed operands in each Dword (OpsPerChannel)
-  unsigned RC = 8u;
-  unsigned execSize = 16u;
-  unsigned SD = 8u;
-  unsigned OpsPerChannel = std::max(1u, std::min(32u / bitWidth, 8u));
+  auto dpasLayout = getParent().cast<DpasEncodingAttr>();
+  unsigned RC = dpasLayout.getRepeatCount();
+  unsigned execSize = dpasLayout.getExecutionSize();
+  unsigned SD = dpasLayout.getSystolicDepth();
+  unsigned OpsPerChannel = dpasLayout.getOpsPerChannel(bitWidth);
   unsigned K = SD * OpsPerChannel;
 
   if (getOpIdx() == 0)
@@ -972,7 +983,7 @@ SmallVector<int64_t>
 DotOperandEncodingAttr::getDPASRep(ArrayRef<int64_t> operandShape,
                                    Type elemType) const {
   SmallVector<int64_t> operandTileShape =
-      getDPASElemsPerInstr(elemType.getIntOrFloatBitWidth());
+      getDPASElemsPerInstr(getDPASBitWidth(elemType));
   auto warpsPerCTA = getParent().cast<DpasEncodingAttr>().getWarpsPerCTA();
   if (getOpIdx() == 0)
     return {std::max<int64_t>(1, operandShape[0] /
@@ -1897,9 +1908,10 @@ Attribute DotOperandEncodingAttr::parse(AsmParser &parser, Type type) {
   unsigned kWidth = 0;
   Attribute _kWidth = attrs.get("kWidth");
   if (_kWidth) {
-    if (!mmaParent || mmaParent.isVolta()) {
+    if ((!mmaParent || mmaParent.isVolta()) &&
+        !parent.isa<DpasEncodingAttr>()) {
       auto loc = parser.getNameLoc();
-      parser.emitError(loc, "kWidth only supported for MMAv2+ parent");
+      parser.emitError(loc, "kWidth only supported for MMAv2+ or DPAS parent");
       return Attribute();
     }
     kWidth = _kWidth.cast<IntegerAttr>().getInt();
@@ -1912,7 +1924,8 @@ void DotOperandEncodingAttr::print(mlir::AsmPrinter &printer) const {
   auto mmaParent = getParent().dyn_cast<NvidiaMmaEncodingAttr>();
   printer << "<{"
           << "opIdx = " << getOpIdx() << ", parent = " << getParent();
-  if (mmaParent && mmaParent.isAmpere())
+  if ((mmaParent && mmaParent.isAmpere()) ||
+      (getParent().isa<DpasEncodingAttr>() && getKWidth() != 0))
     printer << ", kWidth = " << getKWidth();
   printer << "}>";
 }
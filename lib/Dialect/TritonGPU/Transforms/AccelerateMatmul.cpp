@@ -8,6 +8,7 @@
 #include "triton/Tools/Sys/GetEnv.hpp"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
+#include <limits>
 #include <memory>
 
 using namespace mlir;
@@ -334,6 +335,152 @@ public:
     return success();
   }
 };
+
+class BlockedToDPAS : public mlir::RewritePattern {
+public:
+  BlockedToDPAS(mlir::MLIRContext *context)
+      : mlir::RewritePattern(tt::DotOp::getOperationName(), 2, context) {}
+
+  // Pick the largest repeat count (the M dimension of one DPAS instruction)
+  // that tiles the result rows. A single DPAS loads half of the A rows per
+  // lane group, so the smallest repeat count selected is 2.
+  static unsigned getRepeatCount(ArrayRef<int64_t> shape) {
+    for (unsigned repeatCount : {8u, 4u, 2u})
+      if (shape[0] % repeatCount == 0)
+        return repeatCount;
+    return 0;
+  }
+
+  // Distribute the warps over the result tile so that the operands are
+  // reloaded as little as possible. With a wm x wn warp grid, every warp loads
+  // its M / wm rows of A and N / wn columns of B for each step along K, so the
+  // global traffic per step is proportional to wn * M + wm * N: the operand
+  // along the split dimension is loaded once per warp of the other one. Warps
+  // left without a whole instruction tile replicate the work of others, so
+  // grids using more warps are preferred first. On ties the grid with fewer
+  // rows wins, which keeps skinny (decode) GEMMs from reloading B.
+  //
+  // This is a simplification of a roofline model. The pass only sees the
+  // target's DPAS tile shape (\p shapePerWarp), not the EU count, clocks or
+  // memory bandwidth the driver reports, so device throughput does not weigh
+  // in. For a fixed block shape and warp count it would scale every grid's
+  // cost alike, leaving the traffic term to decide.
+  //
+  // Chained dots keep every warp on whole rows, and share the warps of the
+  // chain already converted, so that the result of the first dot becomes the
+  // A operand of the second one with sub-group shuffles only.
+  static SmallVector<unsigned, 2>
+  getWarpsPerTile(tt::DotOp dotOp, ArrayRef<int64_t> shape, int numWarps,
+                  ArrayRef<int64_t> shapePerWarp) {
+    auto filter = [&dotOp](Operation *op) {
+      return op->getParentRegion() == dotOp->getParentRegion() &&
+             !isa<tt::TransOp>(op);
+    };
+    auto slices = multiRootGetSlice(dotOp, {filter}, {filter});
+    bool hasChainedDot = false;
+    for (Operation *op : slices) {
+      if (!isa<tt::DotOp>(op) || op == dotOp)
+        continue;
+      if (auto dpasEncoding = op->getResult(0)
+                                  .getType()
+                                  .cast<RankedTensorType>()
+                                  .getEncoding()
+                                  .dyn_cast<DpasEncodingAttr>()) {
+        auto warpsPerCTA = dpasEncoding.getWarpsPerCTA();
+        return {warpsPerCTA.begin(), warpsPerCTA.end()};
+      }
+      hasChainedDot = true;
+    }
+    if (hasChainedDot)
+      return {(unsigned)numWarps, 1};
+
+    int64_t maxWarpsM = std::max<int64_t>(1, shape[0] / shapePerWarp[0]);
+    int64_t maxWarpsN = std::max<int64_t>(1, shape[1] / shapePerWarp[1]);
+    SmallVector<unsigned, 2> ret = {1, (unsigned)numWarps};
+    int64_t bestUsedWarps = 0;
+    int64_t bestTraffic = std::numeric_limits<int64_t>::max();
+    for (unsigned wm = 1; wm <= (unsigned)numWarps; wm *= 2) {
+      unsigned wn = numWarps / wm;
+      int64_t usedWarps =
+          std::min<int64_t>(wm, maxWarpsM) * std::min<int64_t>(wn, maxWarpsN);
+      int64_t traffic = wn * shape[0] + wm * shape[1];
+      if (usedWarps > bestUsedWarps ||
+          (usedWarps == bestUsedWarps && traffic < bestTraffic)) {
+        ret = {wm, wn};
+        bestUsedWarps = usedWarps;
+        bestTraffic = traffic;
+      }
+    }
+    return ret;
+  }
+
+  mlir::LogicalResult
+  matchAndRewrite(mlir::Operation *op,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto dotOp = cast<tt::DotOp>(op);
+    auto oldRetType = dotOp.getResult().getType().cast<RankedTensorType>();
+    if (!oldRetType.getEncoding() ||
+        !oldRetType.getEncoding().isa<BlockedEncodingAttr>())
+      return failure();
+
+    // The DPAS layout maps one row of 16 lanes to the execution size.
+    auto mod = op->getParentOfType<mlir::ModuleOp>();
+    if (ttg::TritonGPUDialect::getThreadsPerWarp(mod) != 16)
+      return failure();
+    if (!supportDPAS(dotOp))
+      return failure();
+
+    auto retShapePerCTA = ttg::getShapePerCTA(oldRetType);
+    unsigned repeatCount = getRepeatCount(retShapePerCTA);
+    if (!repeatCount || retShapePerCTA[1] % 16 != 0)
+      return failure();
+
+    int numWarps = ttg::TritonGPUDialect::getNumWarps(mod);
+    auto warpsPerTile = getWarpsPerTile(dotOp, retShapePerCTA, numWarps,
+                                        {repeatCount, 16});
+    auto CTALayout = ttg::getCTALayout(oldRetType.getEncoding());
+    auto dpasEnc = DpasEncodingAttr::get(oldRetType.getContext(), repeatCount,
+                                         warpsPerTile, CTALayout);
+    auto newRetType = RankedTensorType::get(
+        oldRetType.getShape(), oldRetType.getElementType(), dpasEnc);
+
+    // convert accumulator
+    auto oldAcc = dotOp.getOperand(2);
+    auto newAcc = rewriter.create<ttg::ConvertLayoutOp>(oldAcc.getLoc(),
+                                                        newRetType, oldAcc);
+    // convert operands
+    Value a = dotOp.getA();
+    Value b = dotOp.getB();
+    auto oldAType = a.getType().cast<RankedTensorType>();
+    auto oldBType = b.getType().cast<RankedTensorType>();
+    // The operands are laid out for the type the DPAS instruction computes in
+    // (FP8 dots are upcasted to f16 by decomposeMixedModeDotOp), so that any
+    // narrower producer of the operands can later be converted in registers.
+    Type dpasElemTy = oldAType.getElementType();
+    if (dpasElemTy.isa<FloatType>() && dpasElemTy.getIntOrFloatBitWidth() == 8)
+      dpasElemTy = rewriter.getF16Type();
+    unsigned kWidth = dpasEnc.getOpsPerChannel(dpasElemTy);
+    auto newAEncoding = ttg::DotOperandEncodingAttr::get(
+        oldAType.getContext(), 0, dpasEnc, kWidth);
+    auto newAType = RankedTensorType::get(
+        oldAType.getShape(), oldAType.getElementType(), newAEncoding);
+    a = rewriter.create<ttg::ConvertLayoutOp>(a.getLoc(), newAType, a);
+    auto newBEncoding = ttg::DotOperandEncodingAttr::get(
+        oldBType.getContext(), 1, dpasEnc, kWidth);
+    auto newBType = RankedTensorType::get(
+        oldBType.getShape(), oldBType.getElementType(), newBEncoding);
+    b = rewriter.create<ttg::ConvertLayoutOp>(b.getLoc(), newBType, b);
+
+    // convert dot instruction
+    auto newDot = rewriter.create<tt::DotOp>(dotOp.getLoc(), newRetType, a, b,
+                                             newAcc, dotOp.getAllowTF32(),
+                                             dotOp.getMaxNumImpreciseAcc());
+
+    rewriter.replaceOpWithNewOp<ttg::ConvertLayoutOp>(op, oldRetType,
+                                                      newDot.getResult());
+    return success();
+  }
+};
 } // namespace
 
 static Value promoteOperand(OpBuilder &builder, Location loc, Value operand,
@@ -385,13 +532,10 @@ static void decomposeMixedModeDotOp(ModuleOp mod) {
                                      .cast<RankedTensorType>()
                                      .getEncoding()
                                      .dyn_cast<DpasEncodingAttr>()) {
-      Type BElType =
-          dotOp.getB().getType().cast<RankedTensorType>().getElementType();
-
-      auto maxBitWidth = std::max(AElType.getIntOrFloatBitWidth(),
-                                  BElType.getIntOrFloatBitWidth());
-
-      return;
+      // DPAS has no FP8 precision, compute FP8 dots in f16.
+      if (!AElType.isa<FloatType>() || AElType.getIntOrFloatBitWidth() != 8)
+        return;
+      promoteType = builder.getF16Type();
     } else {
       // FMA case.
       Type AElType =
@@ -416,15 +560,19 @@ class TritonGPUAccelerateMatmulPass
     : public TritonGPUAccelerateMatmulBase<TritonGPUAccelerateMatmulPass> {
 public:
   TritonGPUAccelerateMatmulPass() = default;
-  TritonGPUAccelerateMatmulPass(int computeCapability) {
+  TritonGPUAccelerateMatmulPass(int computeCapability, bool enableDPAS) {
     this->computeCapability = computeCapability;
+    this->enableDPAS = enableDPAS;
   }
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     ModuleOp m = getOperation();
 
     mlir::RewritePatternSet patterns(context);
-    patterns.add<::BlockedToMMA>(context, computeCapability);
+    if (enableDPAS)
+      patterns.add<::BlockedToDPAS>(context);
+    else
+      patterns.add<::BlockedToMMA>(context, computeCapability);
     if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed()) {
       signalPassFailure();
     }
@@ -435,6 +583,8 @@ public:
 };
 
 std::unique_ptr<Pass>
-mlir::triton::gpu::createAccelerateMatmulPass(int computeCapability) {
-  return std::make_unique<TritonGPUAccelerateMatmulPass>(computeCapability);
+mlir::triton::gpu::createAccelerateMatmulPass(int computeCapability,
+                                              bool enableDPAS) {
+  return std::make_unique<TritonGPUAccelerateMatmulPass>(computeCapability,
+                                                         enableDPAS);
 }
@@ -81,6 +81,12 @@ static AxisInfo getAxisInfoForTensorPointer(const Value &val) {
 }
 
 struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
+  CoalescePass() = default;
+  CoalescePass(int maxVectorBits, int cacheLineBytes) {
+    this->maxVectorBits = maxVectorBits;
+    this->cacheLineBytes = cacheLineBytes;
+  }
+
   void
   setCoalescedEncoding(ModuleAxisInfoAnalysis &axisInfoAnalysis, Operation *op,
                        int numWarps, int threadsPerWarp,
@@ -181,7 +187,8 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
       unsigned maxContig =
           std::min(valInfo.getContiguity(order[0]), shapePerCTA[order[0]]);
       unsigned alignment = std::min(maxMultiple, maxContig);
-      unsigned currPerThread = std::min(alignment, 128 / elemNumBits);
+      unsigned currPerThread =
+          std::min(alignment, std::max(maxVectorBits / elemNumBits, 1u));
       return currPerThread;
     };
     unsigned perThread = getNumElementPerThread(op);
@@ -197,6 +204,21 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
     perThread = std::min<int>(perThread, numElemsPerThread);
     LDBG("perThread: " << perThread);
 
+    if (cacheLineBytes > 0) {
+      // Targets with sub-group block I/O (GENX) read a row chunk of
+      // `threadsPerWarp * perThread` elements with a single message, but only
+      // when all the lanes of the sub-group sit along the contiguous
+      // dimension. Trade vector width for lanes as long as the sub-group
+      // still covers whole cache lines.
+      unsigned elemNumBytes = std::max(getElementBitWidth(ptr) / 8, 1u);
+      unsigned rowElems = shapePerCTA[order[0]];
+      while (perThread > 1 && perThread * threadsPerWarp > rowElems &&
+             (perThread / 2) * threadsPerWarp * elemNumBytes >=
+                 static_cast<unsigned>(cacheLineBytes))
+        perThread /= 2;
+      LDBG("perThread for sub-group access: " << perThread);
+    }
+
     if (!dyn_cast<triton::LoadOp>(op)) {
       // For ops that can result in a global memory write, we should enforce
       // that each thread handles at most 128 bits, which is the widest
@@ -268,7 +290,8 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
   void runOnOperation() override {
     // Run axis info analysis
     ModuleOp moduleOp = getOperation();
-    ModuleAxisInfoAnalysis axisInfoAnalysis(moduleOp);
+    ModuleAxisInfoAnalysis &axisInfoAnalysis =
+        getAnalysis<ModuleAxisInfoAnalysis>();
 
     // For each i/o operation, we determine what layout
     // the pointers should have for best memory coalescing
@@ -309,3 +332,8 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
 std::unique_ptr<Pass> mlir::triton::gpu::createCoalescePass() {
   return std::make_unique<CoalescePass>();
 }
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::createCoalescePass(int maxVectorBits, int cacheLineBytes) {
+  return std::make_unique<CoalescePass>(maxVectorBits, cacheLineBytes);
+}
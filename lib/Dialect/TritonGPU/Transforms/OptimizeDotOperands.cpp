@@ -1,4 +1,6 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
@@ -105,13 +107,22 @@ public:
 // So we try to check that this will be beneficial before making any changes.
 class HoistLayoutConversion : public OpRewritePattern<ConvertLayoutOp> {
 public:
-  using OpRewritePattern::OpRewritePattern;
+  HoistLayoutConversion(MLIRContext *context, int computeCapability)
+      : OpRewritePattern(context), computeCapability(computeCapability) {}
 
   LogicalResult matchAndRewrite(ConvertLayoutOp cvt,
                                 PatternRewriter &rewriter) const override {
     // Only consider conversions to dot operand.
     auto cvtTy = cvt.getType().cast<RankedTensorType>();
-    if (!cvtTy.getEncoding().isa<DotOperandEncodingAttr>())
+    auto dotOpEnc = cvtTy.getEncoding().dyn_cast<DotOperandEncodingAttr>();
+    if (!dotOpEnc)
+      return failure();
+
+    // Converting in registers after the shared -> dot_operand load is
+    // supported by MMAv2 (sm80+) and by DPAS operands laid out for the type
+    // the dot is computed in (non-zero kWidth).
+    auto dpasParent = dotOpEnc.getParent().dyn_cast<DpasEncodingAttr>();
+    if (dpasParent ? dotOpEnc.getKWidth() == 0 : computeCapability < 80)
       return failure();
 
     auto src = cvt.getSrc().getDefiningOp();
@@ -194,6 +205,237 @@ public:
     rewriter.replaceOp(cvt, newRet->getResults());
     return success();
   }
+
+private:
+  int computeCapability;
+};
+
+// Rewrite
+//
+//   convert(load(block_ptr) #blocked) #dot_operand ->
+//   load(block_ptr) #dot_operand
+//
+// if the dot operand is one of a DPAS dot that 2D block reads can deliver
+// (see supportDPASOperandBlockLoad). The operand is then read from global
+// memory straight into the registers of the DPAS instruction instead of
+// going through shared memory, which also removes the barrier of the shared
+// memory round trip in the K loop.
+class FuseBlockPointerLoadDPASOperand
+    : public OpRewritePattern<ConvertLayoutOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(ConvertLayoutOp cvt,
+                                PatternRewriter &rewriter) const override {
+    auto cvtTy = cvt.getType().cast<RankedTensorType>();
+    if (!supportDPASOperandBlockLoad(cvtTy))
+      return failure();
+
+    auto load = cvt.getSrc().getDefiningOp<LoadOp>();
+    if (!load || !isTensorPointerType(load.getPtr().getType()) ||
+        !load->hasOneUse())
+      return failure();
+
+    rewriter.setInsertionPoint(load);
+    auto newLoad = cast<LoadOp>(rewriter.clone(*load));
+    newLoad.getResult().setType(cvtTy);
+    rewriter.replaceOp(cvt, newLoad.getResult());
+    rewriter.eraseOp(load);
+    return success();
+  }
+};
+
+// Whether the 2D block pointer `ptr` is computed by a row-major
+// make_tensor_ptr, advances, and loops carrying it, which
+// transposeBlockPointer can then transpose.
+bool canTransposeBlockPointer(Value ptr, DenseSet<Value> &visited) {
+  if (!visited.insert(ptr).second)
+    return true;
+  if (auto makePtr = ptr.getDefiningOp<MakeTensorPtrOp>())
+    return makePtr.getOrder() == ArrayRef<int32_t>{1, 0};
+  if (auto advance = ptr.getDefiningOp<AdvanceOp>())
+    return canTransposeBlockPointer(advance.getPtr(), visited);
+  auto arg = ptr.dyn_cast<BlockArgument>();
+  if (!arg)
+    return false;
+  auto forOp = dyn_cast<scf::ForOp>(arg.getOwner()->getParentOp());
+  if (!forOp || arg.getArgNumber() < forOp.getNumInductionVars())
+    return false;
+  unsigned iterArg = arg.getArgNumber() - forOp.getNumInductionVars();
+  Value yielded = forOp.getBody()->getTerminator()->getOperand(iterArg);
+  return canTransposeBlockPointer(forOp.getTiedLoopInit(arg)->get(),
+                                  visited) &&
+         canTransposeBlockPointer(yielded, visited);
+}
+
+// Returns the block pointer `ptr` with its dimensions swapped, of type
+// `ptrTy`: a column-major make_tensor_ptr next to the one of `ptr`, advanced
+// by the swapped offsets and carried by the loops carrying `ptr`, which get a
+// new iteration argument for it.
+Value transposeBlockPointer(OpBuilder &builder, Value ptr, Type ptrTy,
+                            DenseMap<Value, Value> &transposed) {
+  if (Value value = transposed.lookup(ptr))
+    return value;
+  OpBuilder::InsertionGuard guard(builder);
+  auto swap = [](ValueRange values) {
+    return SmallVector<Value>{values[1], values[0]};
+  };
+  if (auto makePtr = ptr.getDefiningOp<MakeTensorPtrOp>()) {
+    builder.setInsertionPointAfter(makePtr);
+    Value value = builder.create<MakeTensorPtrOp>(
+        makePtr.getLoc(), ptrTy, makePtr.getBase(), swap(makePtr.getShape()),
+        swap(makePtr.getStrides()), swap(makePtr.getOffsets()),
+        builder.getDenseI32ArrayAttr({0, 1}));
+    return transposed[ptr] = value;
+  }
+  if (auto advance = ptr.getDefiningOp<AdvanceOp>()) {
+    Value src = transposeBlockPointer(builder, advance.getPtr(), ptrTy,
+                                      transposed);
+    builder.setInsertionPointAfter(advance);
+    Value value = builder.create<AdvanceOp>(advance.getLoc(), ptrTy, src,
+                                            swap(advance.getOffsets()));
+    return transposed[ptr] = value;
+  }
+
+  auto arg = ptr.cast<BlockArgument>();
+  auto forOp = cast<scf::ForOp>(arg.getOwner()->getParentOp());
+  Value init = transposeBlockPointer(
+      builder, forOp.getTiedLoopInit(arg)->get(), ptrTy, transposed);
+  scf::ForOp newForOp = replaceForOpWithNewSignature(builder, forOp, init);
+  forOp.erase();
+  Block *body = newForOp.getBody();
+  // Mapped before its yielded value, which is usually computed from it.
+  Value value = transposed[ptr] = body->getArguments().back();
+  Operation *yield = body->getTerminator();
+  unsigned iterArg = arg.getArgNumber() - newForOp.getNumInductionVars();
+  Value yielded = transposeBlockPointer(builder, yield->getOperand(iterArg),
+                                        ptrTy, transposed);
+  yield->insertOperands(yield->getNumOperands(), yielded);
+  return value;
+}
+
+// Rewrite
+//
+//   convert(trans(load(block_ptr) #blocked)) #dot_operand ->
+//   convert(load(transposed_block_ptr) #blocked1) #dot_operand
+//
+// for the B operands of DPAS dots, where `transposed_block_ptr` is the
+// column-major block pointer of the same memory with the dimensions swapped.
+// FuseBlockPointerLoadDPASOperand then folds the convert into the load,
+// which transposing 2D block reads deliver in the registers of the DPAS
+// instruction. The transposes of attention (`K^T`, `V^T`, ...) are otherwise
+// staged in shared memory, with a barrier, on every iteration of the K loop.
+//
+// Loops carrying the block pointer get a new iteration argument, so this is
+// not a rewrite pattern.
+void fuseTransposedBlockPointerLoads(ModuleOp m) {
+  SmallVector<TransOp> transOps;
+  m.walk([&](TransOp trans) {
+    if (trans.getOrder() != ArrayRef<int32_t>{1, 0} || !trans->hasOneUse())
+      return;
+    auto load = trans.getSrc().getDefiningOp<LoadOp>();
+    if (!load || !isTensorPointerType(load.getPtr().getType()) ||
+        !load->hasOneUse())
+      return;
+    auto cvt = dyn_cast<ConvertLayoutOp>(*trans->getUsers().begin());
+    if (!cvt)
+      return;
+    auto cvtTy = cvt.getType().cast<RankedTensorType>();
+    if (!supportDPASOperandBlockLoad(cvtTy) ||
+        cvtTy.getEncoding().cast<DotOperandEncodingAttr>().getOpIdx() != 1)
+      return;
+    transOps.push_back(trans);
+  });
+
+  OpBuilder builder(m.getContext());
+  DenseMap<Value, Value> transposed;
+  for (TransOp trans : transOps) {
+    auto load = trans.getSrc().getDefiningOp<LoadOp>();
+    DenseSet<Value> visited;
+    if (!canTransposeBlockPointer(load.getPtr(), visited))
+      continue;
+    auto ptrTy = triton::PointerType::get(
+        trans.getType(),
+        load.getPtr().getType().cast<triton::PointerType>().getAddressSpace());
+    Value ptr =
+        transposeBlockPointer(builder, load.getPtr(), ptrTy, transposed);
+
+    SmallVector<int32_t> boundaryCheck;
+    for (int32_t dim : load.getBoundaryCheck().value_or(ArrayRef<int32_t>()))
+      boundaryCheck.push_back(1 - dim);
+    llvm::sort(boundaryCheck);
+    builder.setInsertionPoint(load);
+    auto newLoad = builder.create<LoadOp>(
+        load.getLoc(), ptr, boundaryCheck, load.getPadding(), load.getCache(),
+        load.getEvict(), load.getIsVolatile());
+    newLoad->setAttr(kTransposedBlockLoadAttrName, builder.getUnitAttr());
+    trans.replaceAllUsesWith(newLoad.getResult());
+    trans.erase();
+    load.erase();
+  }
+}
+
+// Move a conversion to a DPAS dot operand out of the loop, together with the
+// ops it depends on in the loop body, when none of them depends on the
+// iteration:
+//
+//   scf.for {
+//     %b = convert(elementwise(%x)) #dot_operand
+//     dot(%a, %b)
+//   }
+//   ->
+//   %b = convert(elementwise(%x)) #dot_operand
+//   scf.for {
+//     dot(%a, %b)
+//   }
+//
+// The dot operand conversions are created next to the dot, after LICM ran on
+// the TTIR, so an operand reused across the K loop (an attention query, a
+// dequantized weight tile, ...) is otherwise converted to the DPAS register
+// layout on every iteration. Once outside the loop, HoistLayoutConversion can
+// also move the conversion up to the load.
+class HoistLoopInvariantDPASOperand : public OpRewritePattern<ConvertLayoutOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(ConvertLayoutOp cvt,
+                                PatternRewriter &rewriter) const override {
+    auto cvtTy = cvt.getType().cast<RankedTensorType>();
+    auto dotOpEnc = cvtTy.getEncoding().dyn_cast<DotOperandEncodingAttr>();
+    if (!dotOpEnc || !dotOpEnc.getParent().isa<DpasEncodingAttr>())
+      return failure();
+
+    auto forOp = dyn_cast<scf::ForOp>(cvt->getParentOp());
+    if (!forOp)
+      return failure();
+
+    SetVector<Operation *> slice;
+    BackwardSliceOptions opt;
+    opt.omitBlockArguments = true;
+    opt.filter = [&](Operation *op) {
+      return op->getParentRegion() == cvt->getParentRegion();
+    };
+    getBackwardSlice(cvt.getOperation(), &slice, opt);
+    slice.insert(cvt);
+
+    // Every op must be free to execute once before the loop, and every value
+    // it uses must either come from outside the loop or be hoisted with it.
+    for (Operation *op : slice) {
+      if (op->getNumRegions() != 0 || !isPure(op))
+        return failure();
+      for (Value operand : op->getOperands()) {
+        Operation *def = operand.getDefiningOp();
+        if (!forOp.isDefinedOutsideOfLoop(operand) &&
+            !(def && slice.contains(def)))
+          return failure();
+      }
+    }
+
+    // The slice is topologically sorted.
+    for (Operation *op : slice)
+      rewriter.modifyOpInPlace(op, [&]() { op->moveBefore(forOp); });
+    return success();
+  }
 };
 
 // Rewrite
@@ -333,11 +575,15 @@ public:
     pm.addPass(mlir::createCanonicalizerPass());
     auto ret = pm.run(m);
 
+    fuseTransposedBlockPointerLoads(m);
+
     mlir::RewritePatternSet patterns(context);
     patterns.add<SwizzleShmemConvert>(context);
-    if (triton::gpu::TritonGPUDialect::getComputeCapability(m) >= 80)
-      patterns.add<HoistLayoutConversion>(context);
+    patterns.add<HoistLayoutConversion>(
+        context, triton::gpu::TritonGPUDialect::getComputeCapability(m));
     patterns.add<FuseTransHopper>(context);
+    patterns.add<FuseBlockPointerLoadDPASOperand>(context);
+    patterns.add<HoistLoopInvariantDPASOperand>(context);
     patterns.add<MMAV3UseRegOperand>(context);
     if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed())
       signalPassFailure();
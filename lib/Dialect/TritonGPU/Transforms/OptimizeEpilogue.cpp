@@ -21,13 +21,16 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Support/LogicalResult.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/Passes.h"
+#include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
@@ -44,6 +47,15 @@ namespace {
 // tt.store(ptr, val, mask, ...) : mma
 //
 // Store with mma layout directly
+//
+// For DPAS accumulators, elementwise ops between the conversion and the store
+// (bias, activation, cast to the output type, ...) are moved into the DPAS
+// layout as well; their other operands are converted instead, which later
+// layout conversion removal folds into the bias loads. The epilogue may use
+// the accumulator more than once, e.g. the compares and selects saturating a
+// requantized int8 result, as long as nothing outside of it does. Stores through tensor
+// pointers only need the value converted; see BlockPointerStoreOpConversion
+// for the 2D block writes of DPAS tiles.
 class BypassEpilogueSMEM : public mlir::RewritePattern {
 
 public:
@@ -59,50 +71,138 @@ public:
     Value ptr = stOp.getPtr();
     Value val = stOp.getValue();
     Value mask = stOp.getMask();
+    bool isTensorPtr = triton::isTensorPointerType(ptr.getType());
     auto ptrType = ptr.getType().dyn_cast<RankedTensorType>();
     auto valType = val.getType().dyn_cast<RankedTensorType>();
-    if (!ptrType || !valType ||
-        !ptrType.getEncoding().isa<triton::gpu::BlockedEncodingAttr>() ||
+    if (!valType ||
         !valType.getEncoding().isa<triton::gpu::BlockedEncodingAttr>())
       return mlir::failure();
-
-    auto cvtOp = dyn_cast<triton::gpu::ConvertLayoutOp>(val.getDefiningOp());
-    if (!cvtOp)
-      return mlir::failure();
-
-    if (!cvtOp.getSrc()
-             .getType()
-             .cast<RankedTensorType>()
-             .getEncoding()
-             .isa<triton::gpu::NvidiaMmaEncodingAttr>())
+    if (!isTensorPtr &&
+        (!ptrType ||
+         !ptrType.getEncoding().isa<triton::gpu::BlockedEncodingAttr>()))
       return mlir::failure();
 
-    if (!cvtOp.getResult().hasOneUse())
+    // The epilogue ops in program order.
+    SetVector<Operation *> epilogue;
+    auto cvtOp = getAccumulatorConversion(stOp, val, epilogue);
+    if (!cvtOp)
       return mlir::failure();
 
     auto newEncoding =
         cvtOp.getOperand().getType().cast<RankedTensorType>().getEncoding();
+    bool isDpas = newEncoding.isa<triton::gpu::DpasEncodingAttr>();
+    // Only DPAS epilogues are moved, and only DPAS tiles are lowered to block
+    // writes through tensor pointers.
+    if (!isDpas && (!epilogue.empty() || isTensorPtr))
+      return mlir::failure();
+
+    auto convertTo = [&](Value v) -> Value {
+      auto type = v.getType().cast<RankedTensorType>();
+      auto newType = RankedTensorType::get(type.getShape(),
+                                           type.getElementType(), newEncoding);
+      return rewriter.create<triton::gpu::ConvertLayoutOp>(v.getLoc(), newType,
+                                                           v);
+    };
+
+    // Replay the epilogue on the accumulator, first op first.
+    IRMapping accMapping;
+    accMapping.map(cvtOp.getResult(), cvtOp.getSrc());
+    for (Operation *epilogueOp : epilogue) {
+      rewriter.setInsertionPoint(epilogueOp);
+      IRMapping mapping;
+      for (Value operand : epilogueOp->getOperands()) {
+        Value newOperand = accMapping.lookupOrNull(operand);
+        mapping.map(operand, newOperand ? newOperand : convertTo(operand));
+      }
+      Operation *newOp = rewriter.clone(*epilogueOp, mapping);
+      auto resType =
+          epilogueOp->getResult(0).getType().cast<RankedTensorType>();
+      newOp->getResult(0).setType(RankedTensorType::get(
+          resType.getShape(), resType.getElementType(), newEncoding));
+      accMapping.map(epilogueOp->getResult(0), newOp->getResult(0));
+    }
+    Value newVal = accMapping.lookup(val);
+    rewriter.setInsertionPoint(stOp);
 
-    auto newVal = cvtOp.getOperand();
+    if (isTensorPtr) {
+      rewriter.modifyOpInPlace(
+          stOp, [&]() { stOp.getValueMutable().assign(newVal); });
+      return mlir::success();
+    }
 
-    auto newPtrType = RankedTensorType::get(
-        ptrType.getShape(), ptrType.getElementType(), newEncoding);
-    Value newPtr = rewriter.create<triton::gpu::ConvertLayoutOp>(
-        ptr.getLoc(), newPtrType, ptr);
+    Value newPtr = convertTo(ptr);
 
     Value newMask = mask;
-    if (mask) {
-      auto maskType = mask.getType().dyn_cast<RankedTensorType>();
-      auto newMaskType = RankedTensorType::get(
-          maskType.getShape(), maskType.getElementType(), newEncoding);
-      newMask = rewriter.create<triton::gpu::ConvertLayoutOp>(
-          mask.getLoc(), newMaskType, mask);
-    }
+    if (mask)
+      newMask = convertTo(mask);
 
     rewriter.replaceOpWithNewOp<triton::StoreOp>(
         stOp, newPtr, newVal, newMask, stOp.getCache(), stOp.getEvict());
     return mlir::success();
   }
+
+private:
+  static bool isEpilogueOp(Operation *op) {
+    return op->getNumResults() == 1 &&
+           op->hasTrait<OpTrait::Elementwise>() && isMemoryEffectFree(op) &&
+           llvm::all_of(op->getOperandTypes(),
+                        [](Type ty) { return ty.isa<RankedTensorType>(); });
+  }
+
+  // Returns the mma -> blocked conversion \p val is computed from through
+  // elementwise ops, collected in \p epilogue in program order. The
+  // conversion and the epilogue ops may only be used by each other and
+  // \p store.
+  static triton::gpu::ConvertLayoutOp
+  getAccumulatorConversion(Operation *store, Value val,
+                           SetVector<Operation *> &epilogue) {
+    // The elementwise ops \p val is computed with, and the accumulator they
+    // start from.
+    SetVector<Operation *> slice;
+    triton::gpu::ConvertLayoutOp cvtOp;
+    SmallVector<Value> worklist = {val};
+    while (!worklist.empty()) {
+      Operation *defOp = worklist.pop_back_val().getDefiningOp();
+      if (!defOp)
+        continue;
+      if (auto cvt = dyn_cast<triton::gpu::ConvertLayoutOp>(defOp)) {
+        auto srcEncoding =
+            cvt.getSrc().getType().cast<RankedTensorType>().getEncoding();
+        if (!srcEncoding.isa<triton::gpu::NvidiaMmaEncodingAttr,
+                             triton::gpu::DpasEncodingAttr>())
+          continue;
+        if (cvtOp && cvtOp != cvt)
+          return nullptr;
+        cvtOp = cvt;
+        continue;
+      }
+      if (isEpilogueOp(defOp) && slice.insert(defOp))
+        worklist.append(defOp->operand_begin(), defOp->operand_end());
+    }
+    if (!cvtOp)
+      return nullptr;
+
+    // The ops of the slice computed from the accumulator; the others only
+    // provide operands.
+    DenseSet<Value> fromAcc = {cvtOp.getResult()};
+    for (Operation *op : multiRootTopologicalSort(slice)) {
+      if (llvm::any_of(op->getOperands(),
+                       [&](Value v) { return fromAcc.contains(v); })) {
+        epilogue.insert(op);
+        fromAcc.insert(op->getResult(0));
+      }
+    }
+    if (!fromAcc.contains(val))
+      return nullptr;
+
+    auto isEpilogueUser = [&](Operation *user) {
+      return user == store || epilogue.contains(user);
+    };
+    for (Value v : fromAcc)
+      if (!llvm::all_of(v.getUsers(), isEpilogueUser))
+        return nullptr;
+    return cvtOp;
+  }
 };
 
 } // namespace
@@ -112,11 +112,10 @@ class TritonGPUOptimizeThreadLocalityPass
               reductionOp.value()))
         return;
       // TODO: relax this restriction
-      if (!(srcEncoding.isa<triton::gpu::BlockedEncodingAttr>() && rank > 1))
+      if (!srcEncoding.isa<triton::gpu::BlockedEncodingAttr>())
         return;
       for (auto operand : reduce->getOperands()) {
-        auto def = operand.getDefiningOp();
-        if (!isa<triton::LoadOp>(def))
+        if (!isLoadedInLoop(operand))
           return;
       }
       auto elemsPerThread =
@@ -142,7 +141,8 @@ class TritonGPUOptimizeThreadLocalityPass
         return;
       auto argNum = yieldOpOperand.getOperandNumber();
       auto oldAccum = forOp.getInitArgs()[argNum];
-      auto cstOp = dyn_cast<arith::ConstantOp>(oldAccum.getDefiningOp());
+      auto cstOp =
+          dyn_cast_or_null<arith::ConstantOp>(oldAccum.getDefiningOp());
       if (!cstOp)
         return;
       reduceOps.insert(reduce);
@@ -207,9 +207,12 @@ class TritonGPUOptimizeThreadLocalityPass
       // create post loop reduction on the original reduce axis
       auto newReduce2 = createPostLoopReduce(builder, newLoop, reduce);
       // add convert_layout to get back to original layout, the result layout
-      // should now match the layout of the old accumulator (%cst)
+      // should now match the layout of the old accumulator (%cst). Full
+      // reductions of 1D tensors produce a scalar that needs no conversion.
       Type destType = loopResult.getType();
-      auto cvtLayout = createConvertLayout(builder, destType, newReduce2);
+      Operation *cvtLayout = newReduce2;
+      if (destType.isa<RankedTensorType>())
+        cvtLayout = createConvertLayout(builder, destType, newReduce2);
       // incorporate the original accumulator value into the final result
       auto finalOp = incorporateOriginalAccumulatorValue(builder, oldUpdate,
                                                          cvtLayout, oldAccum);
@@ -223,6 +226,29 @@ class TritonGPUOptimizeThreadLocalityPass
   };
 
 private:
+  // Returns true if `v` is loaded in the loop body, possibly through a chain
+  // of elementwise ops (e.g. squaring the elements of a norm), so that the
+  // reshape introduced for the thread-local stage can be folded into the
+  // layout of the loads.
+  bool isLoadedInLoop(Value v) const {
+    Operation *def = v.getDefiningOp();
+    if (!def)
+      return false;
+    if (isa<triton::LoadOp>(def))
+      return true;
+    if (def->getNumResults() != 1 || !def->hasTrait<OpTrait::Elementwise>())
+      return false;
+    bool hasLoadedOperand = false;
+    for (Value operand : def->getOperands()) {
+      if (!operand.getType().isa<RankedTensorType>())
+        continue;
+      if (!isLoadedInLoop(operand))
+        return false;
+      hasLoadedOperand = true;
+    }
+    return hasLoadedOperand;
+  }
+
   std::optional<Operation *> getReductionOp(triton::ReduceOp reduce) const {
     auto numRegions = reduce->getNumRegions();
     if (numRegions != 1)
@@ -293,6 +319,9 @@ private:
     mapping.map(oldUpdate->getOperand(0), newArg);
     mapping.map(oldUpdate->getOperand(1), newReduce->getResult(0));
     auto newUpdate = cloneWithInferType(builder, oldUpdate, mapping);
+    // The update of a scalar accumulator is not re-inferred by
+    // cloneWithInferType; it now accumulates the thread-local partials.
+    newUpdate->getResult(0).setType(newArg.getType());
     return newUpdate;
   }
 
@@ -355,8 +384,7 @@ private:
                          Attribute &slice2d) const {
     // Drop the last dimension (thread locality dimension)
     SmallVector<int64_t> accumShape(shape.begin(), shape.end() - 1);
-    auto elemType =
-        oldAccum.getType().cast<RankedTensorType>().getElementType();
+    auto elemType = getElementTypeOrSelf(oldAccum.getType());
     // Create tensor type for the new accumulator
     auto accumType = RankedTensorType::get(accumShape, elemType, slice2d);
     // Create new accumulator
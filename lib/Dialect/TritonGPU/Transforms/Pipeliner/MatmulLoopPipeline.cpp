@@ -1,6 +1,7 @@
 #include "PipelineExpander.h"
 #include "PipeliningUtility.h"
 #include "Schedule.h"
+#include "mlir/Analysis/SliceAnalysis.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/TypeUtilities.h"
@@ -10,6 +11,7 @@
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "triton/Tools/Sys/GetEnv.hpp"
 #include "llvm/Support/Debug.h"
 
 #define int_attr(num) builder.getI64IntegerAttr(num)
@@ -147,12 +149,15 @@ namespace {
 struct LoadDotOperand {
   LoadDotOperand(tt::LoadOp load,
                  ttg::DotOperandEncodingAttr dotOperandEncoding,
-                 bool needTrans = false)
+                 bool needTrans = false, bool feedsDot = true)
       : load(load), dotOperandEncoding(dotOperandEncoding),
-        needTrans(needTrans) {}
+        needTrans(needTrans), feedsDot(feedsDot) {}
   tt::LoadOp load;
   ttg::DotOperandEncodingAttr dotOperandEncoding;
   bool needTrans;
+  // False for streaming loads whose result is not a dot operand (bias, scale
+  // or mask tiles); they are staged in plain shared memory.
+  bool feedsDot;
 };
 } // namespace
 
@@ -230,21 +235,27 @@ static std::optional<LoadDotOperand> loadDotOperand(tt::LoadOp loadOp,
   return LoadDotOperand(loadOp, attr, needTrans);
 }
 
+// Return true if the result of the load is used to compute another load.
+static bool feedsLoad(tt::LoadOp loadOp) {
+  SetVector<Operation *> slice;
+  getForwardSlice(loadOp.getResult(), &slice);
+  return llvm::any_of(slice, [](Operation *op) { return isa<tt::LoadOp>(op); });
+}
+
 /// Collect loads to pipeline. Return success if we can pipeline this loop
 static void collectOpsToPipeline(scf::ForOp forOp,
                                  SmallVectorImpl<LoadDotOperand> &ops,
-                                 bool &hasMMAV3) {
-  ModuleOp moduleOp = forOp->getParentOfType<ModuleOp>();
-  ModuleAxisInfoAnalysis axisInfoAnalysis(moduleOp);
-
+                                 bool &hasMMAV3,
+                                 ModuleAxisInfoAnalysis &axisInfoAnalysis) {
   // We cannot use forOp.walk(...) here because we only want to visit the
   // operations in the loop body block. Nested blocks are handled separately.
   for (Operation &op : forOp) {
     if (auto loadOp = dyn_cast<tt::LoadOp>(&op)) {
       bool candidate = false;
       if (isLoadFromTensorPtr(loadOp)) {
-        // Map to TMA load.
-        candidate = true;
+        // Map to TMA load. Block pointers that survive without TMA (Intel 2D
+        // block IO) are lowered directly and are not pipelined here.
+        candidate = ::triton::tools::getBoolEnv("ENABLE_TMA");
       } else {
         auto ptr = loadOp.getPtr();
         unsigned vec = axisInfoAnalysis.getPtrContiguity(ptr);
@@ -270,9 +281,19 @@ static void collectOpsToPipeline(scf::ForOp forOp,
         continue;
       std::optional<LoadDotOperand> loadWithDotOperand =
           loadDotOperand(loadOp, hasMMAV3);
-      if (!loadWithDotOperand.has_value())
+      if (loadWithDotOperand.has_value()) {
+        ops.push_back(loadWithDotOperand.value());
         continue;
-      ops.push_back(loadWithDotOperand.value());
+      }
+      // Pipeline the other loads streaming through the loop as well. Loads of
+      // a loop invariant address are left alone, they hit in the cache after
+      // the first iteration, and so are the loads computing the address of
+      // another load as they would have to be issued in an earlier stage.
+      if (!isLoadFromTensorPtr(loadOp) &&
+          !forOp.isDefinedOutsideOfLoop(loadOp.getPtr()) &&
+          !feedsLoad(loadOp))
+        ops.push_back(LoadDotOperand(loadOp, nullptr, /*needTrans=*/false,
+                                     /*feedsDot=*/false));
     }
   }
 }
@@ -280,12 +301,17 @@ static void collectOpsToPipeline(scf::ForOp forOp,
 // Create an allocation that can old distance number of loadOp shapes.
 static Value createAlloc(scf::ForOp &forOp, tt::LoadOp loadOp,
                          ttg::DotOperandEncodingAttr dotOpEnc,
-                         unsigned distance, bool needTrans) {
+                         unsigned distance, bool needTrans, bool feedsDot) {
   OpBuilder builder(forOp);
   auto ty = loadOp.getType().cast<RankedTensorType>();
   Attribute sharedEnc;
   auto CTALayout = ttg::getCTALayout(ty.getEncoding());
-  if (dotOpEnc) {
+  if (!feedsDot) {
+    // Read back in the layout it was loaded in, no swizzling needed.
+    sharedEnc = ttg::SharedEncodingAttr::get(ty.getContext(), 1, 1, 1,
+                                             ttg::getOrder(ty.getEncoding()),
+                                             CTALayout, false);
+  } else if (dotOpEnc) {
     unsigned bitWidth = ty.getElementType().getIntOrFloatBitWidth();
     // set needTrans to avoid unnecessary conversion between shared encodings.
     sharedEnc = ttg::SharedEncodingAttr::get(
@@ -306,6 +332,39 @@ static Value createAlloc(scf::ForOp &forOp, tt::LoadOp loadOp,
   return alloc;
 }
 
+// Return the number of buffers createAsynOps allocates for each load.
+static int getNumBuffers(int numStages, bool hasMMAV3) {
+  int numBuffers = numStages - 1;
+  // For MMAv3 we need an extra buffer as this is assumed in the wgmma
+  // pipelining post-processing.
+  // TODO: Improve modeling of wgmma pipelining.
+  if (hasMMAV3)
+    numBuffers++;
+  return numBuffers;
+}
+
+int64_t mlir::triton::getPipelineSharedMemorySize(
+    scf::ForOp forOp, int numStages, ModuleAxisInfoAnalysis &axisInfoAnalysis) {
+  if (numStages <= 1)
+    return 0;
+  SmallVector<LoadDotOperand> loads;
+  bool hasMMAV3 = false;
+  collectOpsToPipeline(forOp, loads, hasMMAV3, axisInfoAnalysis);
+  int numBuffers = getNumBuffers(numStages, hasMMAV3);
+  int64_t size = 0;
+  for (LoadDotOperand &load : loads) {
+    auto ty = load.load.getType().cast<RankedTensorType>();
+    unsigned bitWidth = ty.getElementType().isIntOrFloat()
+                            ? ty.getElementType().getIntOrFloatBitWidth()
+                            : 64;
+    size += numBuffers * ty.getNumElements() * bitWidth / 8;
+    // TMA loads also allocate one 64-bit mbarrier per buffer.
+    if (isLoadFromTensorPtr(load.load))
+      size += numBuffers * 8;
+  }
+  return size;
+}
+
 // Convert load ops into their asyn version and apply multi-buffering based on
 // the number of stages.
 static SmallVector<Value> createAsynOps(scf::ForOp &forOp,
@@ -316,12 +375,7 @@ static SmallVector<Value> createAsynOps(scf::ForOp &forOp,
     tt::LoadOp loadOp;
     Value alloc;
   };
-  int numBuffers = numStages - 1;
-  // For MMAv3 we need an extra buffer as this is assumed in the wgmma
-  // pipelining post-processing.
-  // TODO: Improve modeling of wgmma pipelining.
-  if (hasMMAV3)
-    numBuffers++;
+  int numBuffers = getNumBuffers(numStages, hasMMAV3);
   SmallVector<AsyncLoad> asyncLoads;
   SmallVector<Value> allocs;
   SmallVector<Value> newOperands;
@@ -330,7 +384,8 @@ static SmallVector<Value> createAsynOps(scf::ForOp &forOp,
   for (const LoadDotOperand &loadOperand : loads) {
     tt::LoadOp loadOp = loadOperand.load;
     Value alloc = createAlloc(forOp, loadOp, loadOperand.dotOperandEncoding,
-                              numBuffers, loadOperand.needTrans);
+                              numBuffers, loadOperand.needTrans,
+                              loadOperand.feedsDot);
     assert(alloc && "Failed to create alloc for the async load.");
     newOperands.push_back(alloc);
     allocs.push_back(alloc);
@@ -418,7 +473,8 @@ createSchedule(scf::ForOp forOp, int numStages, bool prefetchExtract) {
   // `numStages - 2`. All the other operations will go in stage `numStages - 1`.
   for (Operation &op : forOp.getBody()->without_terminator()) {
     if (isa<ttg::InsertSliceAsyncOp, ttg::AsyncCommitGroupOp,
-            ttng::MBarrierArriveOp, ttng::InsertSliceTMAOp>(op))
+            ttng::MBarrierArriveOp, ttng::InsertSliceTMAOp,
+            ttg::PrefetchTensorOp>(op))
       insertOps.emplace_back(&op);
     if (prefetchExtract) {
       if (isa<ttg::ExtractSliceOp, ttg::AsyncWaitOp>(op))
@@ -491,12 +547,13 @@ createSchedule(scf::ForOp forOp, int numStages, bool prefetchExtract) {
 constexpr static char kNeedWaitAttrName[] = "triton.pipeline.needs_wait";
 
 bool mlir::triton::preProcessLoopAndGetSchedule(
-    scf::ForOp &forOp, int numStages, mlir::triton::PipeliningOption &options) {
+    scf::ForOp &forOp, int numStages, mlir::triton::PipeliningOption &options,
+    ModuleAxisInfoAnalysis &axisInfoAnalysis) {
   // 1. First collect "interesting" operations with a stage where to schedule
   // them. This gives a coarse scheduling for the loop.
   SmallVector<LoadDotOperand> loads;
   bool hasMMAV3 = false;
-  collectOpsToPipeline(forOp, loads, hasMMAV3);
+  collectOpsToPipeline(forOp, loads, hasMMAV3, axisInfoAnalysis);
   if (loads.empty())
     return false;
   bool hasAsynCp = llvm::any_of(loads, [](LoadDotOperand &load) {
@@ -540,6 +597,49 @@ bool mlir::triton::preProcessLoopAndGetSchedule(
   return true;
 }
 
+bool mlir::triton::preProcessLoopAndGetPrefetchSchedule(
+    scf::ForOp &forOp, int numStages, mlir::triton::PipeliningOption &options) {
+  // 1. Collect the block pointer loads whose result ends up in a dot operand,
+  // either directly (2D block reads into DPAS registers) or through layout
+  // conversions.
+  SmallVector<tt::LoadOp> loads;
+  for (Operation &op : forOp) {
+    auto loadOp = dyn_cast<tt::LoadOp>(&op);
+    if (!loadOp || !isLoadFromTensorPtr(loadOp))
+      continue;
+    auto ty = loadOp.getType().cast<RankedTensorType>();
+    bool hasMMAV3 = false;
+    if (ty.getEncoding().isa<ttg::DotOperandEncodingAttr>() ||
+        loadDotOperand(loadOp, hasMMAV3))
+      loads.push_back(loadOp);
+  }
+  if (loads.empty())
+    return false;
+
+  // 2. Prefetch the block of each load. The prefetches go in stage 0 and the
+  // loads stay in the last stage, so the blocks are in the caches by the time
+  // they are loaded.
+  for (tt::LoadOp loadOp : loads) {
+    OpBuilder builder(loadOp);
+    builder.create<ttg::PrefetchTensorOp>(loadOp.getLoc(), loadOp.getPtr());
+  }
+
+  // 3. Create the final schedule for the kernel loop.
+  std::vector<std::pair<Operation *, unsigned>> schedule =
+      createSchedule(forOp, numStages, /*prefetchExtract=*/false);
+
+  // 4. Fill out the pipeline options.
+  options.getScheduleFn =
+      [schedule](scf::ForOp forOp,
+                 std::vector<std::pair<Operation *, unsigned>> &s) {
+        s = std::move(schedule);
+      };
+  options.peelEpilogue = false;
+  options.predicateFn = tt::predicateOp;
+  options.supportDynamicLoops = true;
+  return true;
+}
+
 /// Find the minimum number of async_commit_group ops between the extract
 /// and the insert. Wait number is the number of commits-1.
 static std::optional<int>
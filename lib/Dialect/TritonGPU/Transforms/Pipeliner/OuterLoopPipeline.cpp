@@ -7,13 +7,22 @@ using namespace mlir;
 namespace tt = mlir::triton;
 namespace ttg = mlir::triton::gpu;
 
+// Return true for the ops issuing the loads of the inner loop prologue: the
+// async copies on NVIDIA and the 2D block prefetches on Intel GPUs. These are
+// moved to the previous iteration of the outer loop to overlap with its
+// epilogue.
+static bool isPrologueLoadOp(Operation &op) {
+  return isa<ttg::InsertSliceAsyncOp, ttg::AsyncCommitGroupOp,
+             ttg::PrefetchTensorOp>(op);
+}
+
 // create the schedule for a matmul loop. This is ad hoc based on how we know
 // matmul loops should be pipelined and is not a generic scheduler.
 static std::vector<std::pair<Operation *, unsigned>>
 createSchedule(scf::ForOp forOp, int numStages) {
   SmallVector<Operation *> insertOps;
   for (Operation &op : forOp.getBody()->without_terminator()) {
-    if (isa<ttg::InsertSliceAsyncOp, ttg::AsyncCommitGroupOp>(op))
+    if (isPrologueLoadOp(op))
       insertOps.emplace_back(&op);
   }
   DenseSet<Operation *> insertAndDeps;
@@ -77,7 +86,7 @@ static bool preCondition(scf::ForOp forOp) {
   SmallVector<Operation *> insertOps;
   int numForOps = 0;
   for (Operation &op : forOp.getBody()->without_terminator()) {
-    if (isa<ttg::InsertSliceAsyncOp, ttg::AsyncCommitGroupOp>(op))
+    if (isPrologueLoadOp(op))
       insertOps.emplace_back(&op);
     if (isa<scf::ForOp>(op))
       numForOps++;
@@ -36,6 +36,9 @@ Operation *mlir::triton::predicateOp(RewriterBase &rewriter, Operation *op,
     return op;
   if (isa<ttg::AsyncWaitOp>(op))
     return op;
+  // Prefetching past the end of the loop only costs bandwidth.
+  if (isa<ttg::PrefetchTensorOp>(op))
+    return op;
   if (auto insertOp = dyn_cast<ttg::InsertSliceAsyncOp>(op)) {
     rewriter.setInsertionPoint(insertOp);
     Value mask = getPredMask(rewriter, insertOp.getSrc().getType(),
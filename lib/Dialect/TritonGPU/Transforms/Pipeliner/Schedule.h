@@ -4,6 +4,7 @@
 #include "PipelineExpander.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Support/LLVM.h"
+#include "triton/Analysis/AxisInfo.h"
 #include "llvm/ADT/ArrayRef.h"
 #include <vector>
 
@@ -14,7 +15,21 @@ namespace triton {
 /// for wait ops. This also does pre-processing by converting some of the
 /// loads into async loads so that the IR is ready to be pipelined.
 bool preProcessLoopAndGetSchedule(scf::ForOp &forOp, int numStages,
-                                  mlir::triton::PipeliningOption &options);
+                                  mlir::triton::PipeliningOption &options,
+                                  ModuleAxisInfoAnalysis &axisInfoAnalysis);
+
+/// Same as preProcessLoopAndGetSchedule for targets without asynchronous
+/// copies (Intel GPUs): the block pointer loads feeding dots stay synchronous
+/// loads and their blocks are prefetched into the caches `numStages - 1`
+/// iterations ahead.
+bool preProcessLoopAndGetPrefetchSchedule(
+    scf::ForOp &forOp, int numStages, mlir::triton::PipeliningOption &options);
+
+/// Return the number of bytes of shared memory taken by the multi-buffered
+/// allocations preProcessLoopAndGetSchedule would create for `forOp` with
+/// `numStages` stages.
+int64_t getPipelineSharedMemorySize(scf::ForOp forOp, int numStages,
+                                    ModuleAxisInfoAnalysis &axisInfoAnalysis);
 
 /// Fills out pipelining options for an outer loop pipelining case. This
 /// schedules async copies to overlap with the epilogue of a loop.
@@ -30,6 +30,9 @@ using namespace mlir;
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
 
 static const char *kNumStagesAttrName = "tt.num_stages";
+// Largest number of stages picked for a loop of the module when the number of
+// stages is bounded by the shared memory size.
+static const char *kModuleNumStagesAttrName = "triton_gpu.num-stages";
 
 // Return true if the preconditions for pipelining the loop are met.
 static bool preCondition(scf::ForOp forOp) {
@@ -68,13 +71,19 @@ static void tryAndPipelineOuterLoop(scf::ForOp forOp) {
       mlir::triton::pipelineForLoop(rewriter, forOp, options);
 }
 
-static bool pipelineLoop(scf::ForOp forOp, int numStages) {
+static bool pipelineLoop(scf::ForOp forOp, int numStages, bool usePrefetch,
+                         ModuleAxisInfoAnalysis &axisInfoAnalysis) {
   mlir::triton::PipeliningOption options;
   if (!preCondition(forOp))
     return false;
 
   bool foundSchedule = false;
-  foundSchedule = preProcessLoopAndGetSchedule(forOp, numStages, options);
+  if (usePrefetch)
+    foundSchedule =
+        preProcessLoopAndGetPrefetchSchedule(forOp, numStages, options);
+  if (!foundSchedule)
+    foundSchedule = preProcessLoopAndGetSchedule(forOp, numStages, options,
+                                                 axisInfoAnalysis);
 
   // TODO: add more pipelines strategy.
   if (!foundSchedule)
@@ -95,11 +104,13 @@ namespace {
 struct PipelinePass : public TritonGPUPipelineBase<PipelinePass> {
   PipelinePass() = default;
   PipelinePass(int numStages, int numWarps, int numCTAs,
-               int computeCapability) {
+               int computeCapability, bool usePrefetch, int sharedMemorySize) {
     this->numStages = numStages;
     this->numWarps = numWarps;
     this->numCTAs = numCTAs;
     this->computeCapability = computeCapability;
+    this->usePrefetch = usePrefetch;
+    this->sharedMemorySize = sharedMemorySize;
   }
 
   int getNumStagesOrDefault(scf::ForOp forOp) {
@@ -110,21 +121,55 @@ struct PipelinePass : public TritonGPUPipelineBase<PipelinePass> {
     return forOp->getAttr(kNumStagesAttrName).cast<IntegerAttr>().getInt();
   }
 
+  // Return the deepest number of stages, at most `numStages`, for which the
+  // multi-buffered allocations of the loop fit in the shared memory. Deeper
+  // pipelines would only fail later when allocating shared memory.
+  int getFeasibleNumStages(scf::ForOp forOp, int numStages,
+                           ModuleAxisInfoAnalysis &axisInfoAnalysis) {
+    if (sharedMemorySize <= 0)
+      return numStages;
+    while (numStages > 1 &&
+           mlir::triton::getPipelineSharedMemorySize(
+               forOp, numStages, axisInfoAnalysis) > sharedMemorySize)
+      --numStages;
+    return numStages;
+  }
+
   void runOnOperation() override {
     if (this->numStages <= 1)
       return;
     SmallVector<scf::ForOp> loops;
     getOperation()->walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
 
+    // Solved once for all the loops: pipelining a loop only rewrites that
+    // innermost loop, so the axis info of the loads of the other loops stays
+    // valid.
+    ModuleAxisInfoAnalysis &axisInfoAnalysis =
+        getAnalysis<ModuleAxisInfoAnalysis>();
+
     llvm::SmallSetVector<scf::ForOp, 8> outerLoops;
+    std::optional<int> maxNumStages;
     for (scf::ForOp forOp : loops) {
       auto outerLoop = dyn_cast<scf::ForOp>(forOp->getParentOp());
-      int loopNumStages = getNumStagesOrDefault(forOp);
-      bool pipelined = pipelineLoop(forOp, loopNumStages);
+      int loopNumStages = getFeasibleNumStages(
+          forOp, getNumStagesOrDefault(forOp), axisInfoAnalysis);
+      maxNumStages = std::max(maxNumStages.value_or(1), loopNumStages);
+      if (loopNumStages <= 1)
+        continue;
+      bool pipelined =
+          pipelineLoop(forOp, loopNumStages, usePrefetch, axisInfoAnalysis);
       if (pipelined && outerLoop)
         outerLoops.insert(outerLoop);
     }
 
+    // Record the stages actually used so that configurations asking for more
+    // stages than fit can be recognized without compiling them.
+    if (sharedMemorySize > 0 && maxNumStages)
+      getOperation()->setAttr(
+          kModuleNumStagesAttrName,
+          IntegerAttr::get(IntegerType::get(&getContext(), 32),
+                           *maxNumStages));
+
     // schedule the waits
     mlir::triton::insertWaits(getOperation());
 
@@ -148,7 +193,9 @@ struct PipelinePass : public TritonGPUPipelineBase<PipelinePass> {
 
 std::unique_ptr<Pass>
 mlir::triton::gpu::createPipelinePass(int numStages, int numWarps, int numCTAs,
-                                      int computeCapability) {
+                                      int computeCapability, bool usePrefetch,
+                                      int sharedMemorySize) {
   return std::make_unique<PipelinePass>(numStages, numWarps, numCTAs,
-                                        computeCapability);
+                                        computeCapability, usePrefetch,
+                                        sharedMemorySize);
 }
@@ -6,7 +6,7 @@
 #include "triton/Analysis/AxisInfo.h"
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
-#include "TritonAMDGPUTransforms/Passes.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
 #include "llvm/ADT/MapVector.h"
 
@@ -30,6 +30,9 @@
 //   - Store next tile into shared mem
 // - Epilogue: Peeled non-load loop body for last iteration
 //
+// Only plain loads and layout conversions are emitted, so this strategy suits
+// targets without asynchronous copies to shared memory.
+//
 //===----------------------------------------------------------------------===//
 
 using llvm::MapVector;
@@ -37,7 +40,7 @@ using namespace mlir;
 namespace ttg = triton::gpu;
 
 #define GEN_PASS_CLASSES
-#include "TritonAMDGPUTransforms/Passes.h.inc"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
 
 namespace {
 
@@ -176,7 +179,7 @@ public:
   /// create the new ForOp (add new args & insert prefetched ops)
   scf::ForOp createNewForOp();
 
-  friend struct PipelinePass;
+  friend struct StreamPipelinePass;
 };
 
 void LoopPipeliner::collectValueDep(Value v, int stage,
@@ -796,8 +799,9 @@ scf::ForOp LoopPipeliner::createNewForOp() {
 }
 
 // Stream Pipeline
-struct PipelinePass : public TritonAMDGPUStreamPipelineBase<PipelinePass> {
-  PipelinePass() = default;
+struct StreamPipelinePass
+    : public TritonGPUStreamPipelineBase<StreamPipelinePass> {
+  StreamPipelinePass() = default;
 
   void runOnOperation() override {
     // Pre-processing
@@ -833,6 +837,6 @@ struct PipelinePass : public TritonAMDGPUStreamPipelineBase<PipelinePass> {
 };
 } // anonymous namespace
 
-std::unique_ptr<Pass> mlir::createTritonAMDGPUStreamPipelinePass() {
-  return std::make_unique<PipelinePass>();
+std::unique_ptr<Pass> mlir::triton::gpu::createStreamPipelinePass() {
+  return std::make_unique<StreamPipelinePass>();
 }
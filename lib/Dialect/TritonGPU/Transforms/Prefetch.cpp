@@ -45,6 +45,8 @@ class Prefetcher {
   ///
   // TODO: add a hook to infer prefetchWidth
   unsigned prefetchWidth = 32;
+  /// kWidth of the prefetched dot operand encodings
+  unsigned prefetchKWidth = 4;
 
   /// dots to be prefetched
   SetVector<Value> dots;
@@ -132,7 +134,7 @@ Value Prefetcher::generatePrefetch(Value v, unsigned opIdx, bool isPrologue,
       SmallVector<OpFoldResult>{intAttr(1), intAttr(1)});
 
   auto dotOperandEnc = triton::gpu::DotOperandEncodingAttr::get(
-      builder.getContext(), opIdx, dotEncoding, prefetchWidth / 8);
+      builder.getContext(), opIdx, dotEncoding, prefetchKWidth);
   Value prefetchSlice = builder.create<triton::gpu::ConvertLayoutOp>(
       v.getLoc(), RankedTensorType::get(shape, elementType, dotOperandEnc),
       newSmem);
@@ -209,15 +211,24 @@ LogicalResult Prefetcher::initialize() {
 
     auto kSize = aType.getShape()[1];
 
-    // works better with nvidia tensor cores
-    unsigned elementWidth = aType.getElementTypeBitWidth();
-    if (aKWidth == 0)
-      prefetchWidth = 256 / elementWidth;
-    else
-      prefetchWidth = 8 * aKWidth;
+    if (auto dpasEnc =
+            aEnc.getParent().dyn_cast<triton::gpu::DpasEncodingAttr>()) {
+      // Prefetch one DPAS instruction step along K, keeping the kWidth the
+      // operands were laid out with.
+      prefetchWidth = dpasEnc.getSystolicDepth() * aKWidth;
+      prefetchKWidth = aKWidth;
+    } else {
+      // works better with nvidia tensor cores
+      unsigned elementWidth = aType.getElementTypeBitWidth();
+      if (aKWidth == 0)
+        prefetchWidth = 256 / elementWidth;
+      else
+        prefetchWidth = 8 * aKWidth;
+      prefetchKWidth = prefetchWidth / 8;
+    }
 
-    // Skip prefetching if kSize is less than prefetchWidth
-    if (kSize < prefetchWidth)
+    // Skip prefetching if kSize is not a multiple of prefetchWidth
+    if (kSize < prefetchWidth || kSize % prefetchWidth != 0)
       continue;
     auto aVals = getPrefetchSrc(dot.getA());
     auto bVals = getPrefetchSrc(dot.getB());
@@ -16,6 +16,7 @@
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonGPU/Transforms/TritonGPUConversion.h"
+#include "llvm/ADT/MapVector.h"
 #define GEN_PASS_CLASSES
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
 
@@ -29,6 +30,7 @@ public:
 
   void runOnOperation() override {
     ModuleOp mod = getOperation();
+    decomposeBlockedConversions(mod);
     mod.walk([&](triton::gpu::ConvertLayoutOp cvtOp) -> void {
       OpBuilder builder(cvtOp);
       auto srcType = cvtOp.getOperand().getType().cast<RankedTensorType>();
@@ -63,6 +65,54 @@ public:
       cvtOp.erase();
     });
   }
+
+private:
+  // A value converted to several blocked layouts is written to shared memory
+  // once and each conversion reads the elements of its layout back, instead
+  // of every conversion going through its own scratch buffer. Broadcasted
+  // layouts hold duplicated data, so this also avoids storing each copy.
+  void decomposeBlockedConversions(ModuleOp mod) {
+    llvm::MapVector<Value, SmallVector<triton::gpu::ConvertLayoutOp>>
+        conversions;
+    mod.walk([&](triton::gpu::ConvertLayoutOp cvtOp) {
+      auto srcType = cvtOp.getOperand().getType().cast<RankedTensorType>();
+      auto dstType = cvtOp.getType().cast<RankedTensorType>();
+      // Loads from shared memory into distributed layouts are only
+      // implemented for 2D tensors.
+      if (srcType.getRank() != 2 || !srcType.getElementType().isIntOrFloat() ||
+          !triton::gpu::isaDistributedLayout(srcType.getEncoding()) ||
+          !dstType.getEncoding().isa<triton::gpu::BlockedEncodingAttr>())
+        return;
+      conversions[cvtOp.getOperand()].push_back(cvtOp);
+    });
+
+    for (auto &[src, cvtOps] : conversions) {
+      DenseSet<Attribute> dstEncodings;
+      for (auto cvtOp : cvtOps)
+        dstEncodings.insert(cvtOp.getType().getEncoding());
+      if (dstEncodings.size() < 2)
+        continue;
+
+      auto srcType = src.getType().cast<RankedTensorType>();
+      auto srcEncoding = srcType.getEncoding();
+      OpBuilder builder(mod.getContext());
+      builder.setInsertionPointAfterValue(src);
+      auto sharedType = RankedTensorType::get(
+          srcType.getShape(), srcType.getElementType(),
+          triton::gpu::SharedEncodingAttr::get(
+              mod.getContext(), 1, 1, 1, triton::gpu::getOrder(srcEncoding),
+              triton::gpu::getCTALayout(srcEncoding)));
+      auto shared = builder.create<triton::gpu::ConvertLayoutOp>(
+          src.getLoc(), sharedType, src);
+      for (auto cvtOp : cvtOps) {
+        builder.setInsertionPoint(cvtOp);
+        auto newConvert = builder.create<triton::gpu::ConvertLayoutOp>(
+            cvtOp.getLoc(), cvtOp.getType(), shared);
+        cvtOp.replaceAllUsesWith(newConvert.getResult());
+        cvtOp.erase();
+      }
+    }
+  }
 };
 
 std::unique_ptr<Pass> mlir::triton::gpu::createReduceDataDuplicationPass() {
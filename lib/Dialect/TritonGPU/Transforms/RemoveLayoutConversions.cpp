@@ -92,7 +92,9 @@ public:
 //
 // 3. Resolve conflicts by deciding which of the multiple layouts the op should
 //    keep, inserting convert-layout ops to resolve conflicts.  After this
-//    stage, each value has only one layout associated with it.
+//    stage, each value has only one layout associated with it. The layouts are
+//    picked together to minimize the estimated cost of the conversions,
+//    rematerializations and uncoalesced accesses they imply.
 //
 // 4. Rewrite the IR by walking the function in dominance order. Since we
 //    assume the IR is structured we just need to process the regions in the
@@ -120,6 +122,12 @@ public:
                    SmallVector<Value> &changed, Operation *op);
   // Resolve cases where a value has multiple layouts associated to it.
   void resolveConflicts();
+  // Return the layout picked so far for `value`. Values not tracked by the
+  // analysis keep their current layout.
+  Attribute getPickedEncoding(Value value);
+  // Estimated cost of giving `value` the layout `encoding`, given the layouts
+  // picked for the values it is computed from and used by.
+  int64_t getLayoutCost(Value value, Attribute encoding);
   // Rewrite the IR for the full module.
   void rewrite();
   // Rewrite the IR for a region.
@@ -146,6 +154,9 @@ public:
 private:
   // map from value to layout information.
   llvm::MapVector<Value, LayoutInfo> layouts;
+  // Layout picked for the values with conflicting layouts while resolving
+  // them.
+  DenseMap<Value, Attribute> pickedEncodings;
   // map of the values rewrite based on their encoding.
   DenseMap<std::pair<Value, Attribute>, Value> rewriteMapping;
   SetVector<Operation *> opToDelete;
@@ -319,19 +330,178 @@ void LayoutPropagation::propagateLayout() {
   }
 }
 
+static bool isMemoryAccess(Operation *op) {
+  return isa<triton::LoadOp, triton::StoreOp, triton::AtomicRMWOp,
+             triton::AtomicCASOp>(op);
+}
+
+static int64_t getTensorBytes(RankedTensorType ty) {
+  unsigned bitWidth = ty.getElementType().isIntOrFloat()
+                          ? ty.getElementType().getIntOrFloatBitWidth()
+                          : 64;
+  return ty.getNumElements() * std::max<unsigned>(bitWidth, 8) / 8;
+}
+
+// Rough cost, in bytes moved, of converting a tensor of type `ty` from
+// `srcEncoding` to `dstEncoding`. Conversions within a warp only shuffle
+// registers; the others round-trip through shared memory behind a barrier.
+static int64_t getConversionCost(RankedTensorType ty, Attribute srcEncoding,
+                                 Attribute dstEncoding) {
+  if (!srcEncoding || !dstEncoding || srcEncoding == dstEncoding)
+    return 0;
+  auto srcTy = RankedTensorType::get(ty.getShape(), ty.getElementType(),
+                                     srcEncoding);
+  auto dstTy = RankedTensorType::get(ty.getShape(), ty.getElementType(),
+                                     dstEncoding);
+  int64_t bytes = getTensorBytes(ty);
+  bool isShortcut =
+      srcEncoding.isa<NvidiaMmaEncodingAttr>() &&
+      ((dstEncoding.isa<DotOperandEncodingAttr>() &&
+        isMmaToDotShortcut(srcTy, dstTy)) ||
+       isMmaToMmaShortcut(srcTy, dstTy));
+  if (isShortcut)
+    return 0;
+  if (getSubGroupShuffleCvt(srcTy, dstTy))
+    return bytes / 4;
+  constexpr int64_t kBarrierCost = 256;
+  return 2 * bytes + kBarrierCost;
+}
+
+// Collect the values whose layout directly affects the cost of the layout of
+// `value`: the operands of its defining op, the values tied to it through
+// loops and the results of its users.
+static void getLayoutNeighbours(Value value,
+                                SmallVectorImpl<Value> &neighbours) {
+  if (Operation *def = value.getDefiningOp()) {
+    neighbours.append(def->operand_begin(), def->operand_end());
+  } else if (auto arg = value.dyn_cast<BlockArgument>()) {
+    auto forOp = dyn_cast<scf::ForOp>(arg.getOwner()->getParentOp());
+    if (OpOperand *init = forOp ? forOp.getTiedLoopInit(arg) : nullptr) {
+      neighbours.push_back(init->get());
+      neighbours.push_back(forOp.getBody()->getTerminator()->getOperand(
+          init->getOperandNumber() - forOp.getNumControlOperands()));
+    }
+  }
+  for (OpOperand &use : value.getUses()) {
+    Operation *user = use.getOwner();
+    if (auto yieldOp = dyn_cast<scf::YieldOp>(user)) {
+      Operation *parent = yieldOp->getParentOp();
+      if (auto forOp = dyn_cast<scf::ForOp>(parent))
+        neighbours.push_back(forOp.getRegionIterArg(use.getOperandNumber()));
+      else if (isa<scf::IfOp>(parent))
+        neighbours.push_back(parent->getResult(use.getOperandNumber()));
+    } else if (auto forOp = dyn_cast<scf::ForOp>(user)) {
+      if (BlockArgument arg = forOp.getTiedLoopRegionIterArg(&use))
+        neighbours.push_back(arg);
+    } else {
+      neighbours.append(user->result_begin(), user->result_end());
+    }
+  }
+}
+
+Attribute LayoutPropagation::getPickedEncoding(Value value) {
+  auto picked = pickedEncodings.find(value);
+  if (picked != pickedEncodings.end())
+    return picked->second;
+  auto it = layouts.find(value);
+  if (it != layouts.end() && it->second.encodings.size() == 1)
+    return *it->second.encodings.begin();
+  if (auto tensorType = value.getType().dyn_cast<RankedTensorType>())
+    return tensorType.getEncoding();
+  return {};
+}
+
+int64_t LayoutPropagation::getLayoutCost(Value value, Attribute encoding) {
+  auto tensorType = value.getType().cast<RankedTensorType>();
+  auto convertFrom = [&](Value operand, Attribute dstEncoding) -> int64_t {
+    auto operandType = operand.getType().dyn_cast<RankedTensorType>();
+    if (!operandType)
+      return 0;
+    return getConversionCost(operandType, getPickedEncoding(operand),
+                             dstEncoding);
+  };
+  int64_t cost = 0;
+  // Producer side: converting the operands of the defining op, or
+  // rematerializing it when it is cheap.
+  if (Operation *def = value.getDefiningOp()) {
+    if (isMemoryAccess(def) &&
+        !encoding.isa<triton::gpu::BlockedEncodingAttr>()) {
+      // Accesses in anything but a blocked layout are likely not coalesced.
+      cost += 4 * getTensorBytes(tensorType);
+    }
+    if (canFoldIntoConversion(def, encoding)) {
+      // Rematerialized in the new layout for free.
+    } else if (def->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() ||
+               def->hasTrait<mlir::OpTrait::Elementwise>() ||
+               isMemoryAccess(def)) {
+      for (Value operand : def->getOperands())
+        cost += convertFrom(operand, encoding);
+    } else if (isa<triton::ReduceOp, triton::ExpandDimsOp,
+                   triton::ExperimentalInterleaveOp>(def)) {
+      if (std::optional<Attribute> srcEncoding =
+              inferSrcEncoding(def, encoding)) {
+        for (Value operand : def->getOperands())
+          cost += convertFrom(operand, *srcEncoding);
+      }
+    }
+  } else if (auto arg = value.dyn_cast<BlockArgument>()) {
+    auto forOp = dyn_cast<scf::ForOp>(arg.getOwner()->getParentOp());
+    if (OpOperand *init = forOp ? forOp.getTiedLoopInit(arg) : nullptr) {
+      Value yielded = forOp.getBody()->getTerminator()->getOperand(
+          init->getOperandNumber() - forOp.getNumControlOperands());
+      cost += convertFrom(init->get(), encoding);
+      cost += convertFrom(yielded, encoding);
+    }
+  }
+  // Consumer side: converting the value to the layout each user is rewritten
+  // with.
+  for (OpOperand &use : value.getUses()) {
+    Operation *user = use.getOwner();
+    Attribute useEncoding;
+    if (auto convertOp = dyn_cast<ConvertLayoutOp>(user)) {
+      // The convert folds away when the layouts match.
+      useEncoding = getPickedEncoding(convertOp.getResult());
+    } else if (auto yieldOp = dyn_cast<scf::YieldOp>(user)) {
+      Operation *parent = yieldOp->getParentOp();
+      if (auto forOp = dyn_cast<scf::ForOp>(parent))
+        useEncoding = getPickedEncoding(
+            forOp.getRegionIterArg(use.getOperandNumber()));
+      else if (isa<scf::IfOp>(parent))
+        useEncoding =
+            getPickedEncoding(parent->getResult(use.getOperandNumber()));
+    } else if (auto forOp = dyn_cast<scf::ForOp>(user)) {
+      if (BlockArgument arg = forOp.getTiedLoopRegionIterArg(&use))
+        useEncoding = getPickedEncoding(arg);
+    } else if (user->getNumResults() == 0 ||
+               !layouts.count(user->getResult(0))) {
+      // Ops not rewritten by the analysis keep using the current layout.
+      useEncoding = tensorType.getEncoding();
+    } else {
+      Attribute resultEncoding = getPickedEncoding(user->getResult(0));
+      if (user->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() ||
+          user->hasTrait<mlir::OpTrait::Elementwise>() ||
+          isMemoryAccess(user))
+        useEncoding = resultEncoding;
+      else if (std::optional<Attribute> srcEncoding =
+                   inferSrcEncoding(user, resultEncoding))
+        useEncoding = *srcEncoding;
+    }
+    cost += getConversionCost(tensorType, encoding, useEncoding);
+  }
+  return cost;
+}
+
 void LayoutPropagation::resolveConflicts() {
+  // Start from the preferred layouts: blocked for memory accesses and mma for
+  // the rest.
+  SmallVector<Value> conflicts;
   for (auto &it : layouts) {
     Operation *op = it.first.getDefiningOp();
     LayoutInfo &info = it.second;
     if (info.encodings.size() <= 1)
       continue;
-    // Hacky resolve, prefer block encoding.
-    // TODO: add a proper heuristic.
-    int maxSizePerThread = 1;
     Attribute encoding = *info.encodings.begin();
-    bool isLoadOrStore =
-        op && isa<triton::LoadOp, triton::StoreOp, triton::AtomicRMWOp,
-                  triton::AtomicCASOp>(op);
+    bool isLoadOrStore = op && isMemoryAccess(op);
     for (Attribute e : info.encodings) {
       if ((isLoadOrStore && e.isa<triton::gpu::BlockedEncodingAttr>()) ||
           (!isLoadOrStore && e.isa<triton::gpu::NvidiaMmaEncodingAttr>())) {
@@ -339,9 +509,88 @@ void LayoutPropagation::resolveConflicts() {
         break;
       }
     }
+    pickedEncodings[it.first] = encoding;
+    conflicts.push_back(it.first);
+  }
+
+  // Values connected through conflicting def-use chains usually want the same
+  // layout, while moving them one at a time would pay for a conversion in the
+  // middle of the chain. So first give every group of connected values the
+  // layout of least total cost.
+  DenseSet<Value> visited;
+  for (Value root : conflicts) {
+    if (!visited.insert(root).second)
+      continue;
+    SmallVector<Value> group = {root};
+    for (unsigned i = 0; i < group.size(); ++i) {
+      SmallVector<Value> neighbours;
+      getLayoutNeighbours(group[i], neighbours);
+      for (Value neighbour : neighbours) {
+        if (pickedEncodings.count(neighbour) &&
+            visited.insert(neighbour).second)
+          group.push_back(neighbour);
+      }
+    }
+    if (group.size() == 1)
+      continue;
+    auto getGroupCost = [&]() {
+      int64_t cost = 0;
+      for (Value value : group)
+        cost += getLayoutCost(value, pickedEncodings[value]);
+      return cost;
+    };
+    SmallVector<Attribute> initial;
+    llvm::SmallSetVector<Attribute, 8> candidates;
+    for (Value value : group) {
+      initial.push_back(pickedEncodings[value]);
+      candidates.insert(layouts[value].encodings.begin(),
+                        layouts[value].encodings.end());
+    }
+    SmallVector<Attribute> best = initial;
+    int64_t bestCost = getGroupCost();
+    for (Attribute e : candidates) {
+      for (auto [value, init] : llvm::zip(group, initial))
+        pickedEncodings[value] =
+            layouts[value].encodings.contains(e) ? e : init;
+      int64_t cost = getGroupCost();
+      if (cost < bestCost) {
+        bestCost = cost;
+        for (auto [i, value] : llvm::enumerate(group))
+          best[i] = pickedEncodings[value];
+      }
+    }
+    for (auto [value, encoding] : llvm::zip(group, best))
+      pickedEncodings[value] = encoding;
+  }
+
+  // Then move each value to the layout of least cost given the layouts of its
+  // neighbours until the assignment is stable. The number of sweeps is bounded
+  // to keep compile time in check.
+  constexpr int kMaxSweeps = 8;
+  for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+    bool changed = false;
+    for (Value value : conflicts) {
+      Attribute &picked = pickedEncodings[value];
+      int64_t bestCost = getLayoutCost(value, picked);
+      for (Attribute e : layouts[value].encodings) {
+        int64_t cost = getLayoutCost(value, e);
+        if (cost < bestCost) {
+          bestCost = cost;
+          picked = e;
+          changed = true;
+        }
+      }
+    }
+    if (!changed)
+      break;
+  }
+
+  for (Value value : conflicts) {
+    LayoutInfo &info = layouts[value];
     info.encodings.clear();
-    info.encodings.insert(encoding);
+    info.encodings.insert(pickedEncodings[value]);
   }
+  pickedEncodings.clear();
 }
 
 void LayoutPropagation::dump() {
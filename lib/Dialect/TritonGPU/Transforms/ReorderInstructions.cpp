@@ -7,6 +7,7 @@
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Interfaces/InferTypeOpInterface.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Support/LogicalResult.h"
@@ -36,11 +37,252 @@ willIncreaseRegisterPressure(triton::gpu::ConvertLayoutOp op) {
   return false;
 }
 
+namespace {
+
+// A list scheduler for the body of an innermost loop. Ops are issued in order
+// of decreasing critical path length (the latency of the longest dependence
+// chain to the end of the body), so that loads and dots start as early as
+// their operands allow and independent math fills their latency. Once the
+// estimated number of live registers would exceed the budget, the op that
+// frees the most registers is issued instead.
+//
+// Ops with memory effects other than reads, and ops with regions, keep their
+// relative order; reads are not moved across them.
+class LoopBodyScheduler {
+public:
+  LoopBodyScheduler(Block *body, int maxRegisters)
+      : body(body), maxRegisters(maxRegisters) {}
+
+  // Reorders the ops of the body. Returns whether the order changed.
+  bool run() {
+    for (Operation &op : body->without_terminator())
+      ops.push_back(&op);
+    if (ops.size() < 2 || ops.size() > maxOps)
+      return false;
+    for (auto [idx, op] : llvm::enumerate(ops))
+      opIds[op] = idx;
+    buildDependences();
+    SmallVector<unsigned> order = schedule();
+    if (llvm::equal(order, llvm::seq<unsigned>(0, ops.size())))
+      return false;
+    Operation *terminator = body->getTerminator();
+    for (unsigned idx : order)
+      ops[idx]->moveBefore(terminator);
+    return true;
+  }
+
+private:
+  // Bodies larger than this are left alone to bound compile time.
+  static constexpr size_t maxOps = 2048;
+
+  // Rough issue-to-use latencies in cycles.
+  static unsigned getLatency(Operation *op) {
+    if (isa<triton::LoadOp>(op))
+      return 200;
+    if (isa<triton::DotOp, triton::nvidia_gpu::DotAsyncOp>(op))
+      return 32;
+    if (isa<triton::gpu::ConvertLayoutOp>(op))
+      return 20;
+    if (isa<triton::ExternElementwiseOp>(op) ||
+        op->getName().getDialectNamespace() == "math")
+      return 8;
+    return 1;
+  }
+
+  // The number of 32-bit registers each thread needs to hold \p value.
+  static unsigned getNumRegisters(Value value) {
+    auto tensorTy = value.getType().dyn_cast<RankedTensorType>();
+    if (!tensorTy || !tensorTy.getEncoding() ||
+        tensorTy.getEncoding().isa<triton::gpu::SharedEncodingAttr>())
+      return 0;
+    Type elemTy = tensorTy.getElementType();
+    unsigned bitWidth = elemTy.isa<triton::PointerType>()
+                            ? 64
+                            : elemTy.getIntOrFloatBitWidth();
+    unsigned numElems = triton::gpu::getTotalElemsPerThread(tensorTy);
+    return ceil<unsigned>(numElems * bitWidth, 32);
+  }
+
+  void addDependence(unsigned from, unsigned to) {
+    if (from != to && succs[from].insert(to).second)
+      ++numPreds[to];
+  }
+
+  void buildDependences() {
+    unsigned numOps = ops.size();
+    succs.resize(numOps);
+    numPreds.assign(numOps, 0);
+    std::optional<unsigned> lastOrdered;
+    SmallVector<unsigned> readsSinceOrdered;
+    usedValues.resize(numOps);
+    for (auto [idx, op] : llvm::enumerate(ops)) {
+      // Values used by the op or inside its regions.
+      op->walk([&](Operation *nested) {
+        for (Value operand : nested->getOperands()) {
+          usedValues[idx].push_back(operand);
+          if (Operation *def = operand.getDefiningOp())
+            if (def->getBlock() == body)
+              addDependence(opIds.lookup(def), idx);
+        }
+      });
+
+      bool isPure = op->getNumRegions() == 0 && isMemoryEffectFree(op);
+      if (isPure)
+        continue;
+      bool isRead = false;
+      if (auto memInterface = dyn_cast<MemoryEffectOpInterface>(op)) {
+        SmallVector<MemoryEffects::EffectInstance> effects;
+        memInterface.getEffects(effects);
+        isRead = op->getNumRegions() == 0 &&
+                 llvm::all_of(effects, [](const auto &effect) {
+                   return isa<MemoryEffects::Read>(effect.getEffect());
+                 });
+      }
+      if (lastOrdered)
+        addDependence(*lastOrdered, idx);
+      if (isRead) {
+        readsSinceOrdered.push_back(idx);
+        continue;
+      }
+      for (unsigned read : readsSinceOrdered)
+        addDependence(read, idx);
+      readsSinceOrdered.clear();
+      lastOrdered = idx;
+    }
+
+    // Critical path lengths, in reverse program order.
+    heights.assign(numOps, 0);
+    for (unsigned idx = numOps; idx-- > 0;) {
+      unsigned height = 0;
+      for (unsigned succ : succs[idx])
+        height = std::max(height, heights[succ]);
+      heights[idx] = height + getLatency(ops[idx]);
+    }
+
+    // Remaining uses in the body of each result, and results that stay live
+    // past the body (yielded or used outside the loop).
+    for (Operation *op : ops) {
+      for (Value result : op->getResults()) {
+        unsigned numUses = 0;
+        bool liveOut = false;
+        for (Operation *user : result.getUsers()) {
+          Operation *ancestor = body->findAncestorOpInBlock(*user);
+          if (!ancestor || ancestor == body->getTerminator())
+            liveOut = true;
+          else
+            ++numUses;
+        }
+        remainingUses[result] = liveOut ? numUses + 1 : numUses;
+      }
+    }
+  }
+
+  // The change of live registers if op \p idx were issued now.
+  int getPressureDelta(unsigned idx) const {
+    int delta = 0;
+    for (Value result : ops[idx]->getResults())
+      if (remainingUses.lookup(result) > 0)
+        delta += getNumRegisters(result);
+    SmallPtrSet<Value, 4> seen;
+    for (Value operand : usedValues[idx]) {
+      auto it = remainingUses.find(operand);
+      if (it == remainingUses.end() || !seen.insert(operand).second)
+        continue;
+      if (it->second ==
+          static_cast<unsigned>(llvm::count(usedValues[idx], operand)))
+        delta -= getNumRegisters(operand);
+    }
+    return delta;
+  }
+
+  SmallVector<unsigned> schedule() {
+    unsigned numOps = ops.size();
+    SmallVector<unsigned> readyCycle(numOps, 0);
+    SmallVector<unsigned> ready;
+    for (unsigned idx = 0; idx < numOps; ++idx)
+      if (numPreds[idx] == 0)
+        ready.push_back(idx);
+
+    int pressure = 0;
+    unsigned cycle = 0;
+    SmallVector<unsigned> order;
+    while (!ready.empty()) {
+      auto best = ready.begin();
+      int bestDelta = getPressureDelta(*best);
+      for (auto it = std::next(ready.begin()); it != ready.end(); ++it) {
+        int delta = getPressureDelta(*it);
+        if (isBetter(*it, delta, *best, bestDelta, pressure, cycle,
+                     readyCycle)) {
+          best = it;
+          bestDelta = delta;
+        }
+      }
+      unsigned idx = *best;
+      ready.erase(best);
+      order.push_back(idx);
+
+      Operation *op = ops[idx];
+      pressure += bestDelta;
+      for (Value operand : usedValues[idx]) {
+        auto it = remainingUses.find(operand);
+        if (it != remainingUses.end() && it->second > 0)
+          --it->second;
+      }
+      cycle = std::max(cycle, readyCycle[idx]) + 1;
+      for (unsigned succ : succs[idx]) {
+        readyCycle[succ] =
+            std::max(readyCycle[succ], cycle + getLatency(op) - 1);
+        if (--numPreds[succ] == 0)
+          ready.push_back(succ);
+      }
+    }
+    assert(order.size() == numOps && "cyclic dependences in a block");
+    return order;
+  }
+
+  // Whether issuing \p lhs is preferable to issuing \p rhs.
+  bool isBetter(unsigned lhs, int lhsDelta, unsigned rhs, int rhsDelta,
+                int pressure, unsigned cycle,
+                ArrayRef<unsigned> readyCycle) const {
+    // Over the budget, reduce the pressure first.
+    if (pressure + std::max(lhsDelta, rhsDelta) > maxRegisters &&
+        lhsDelta != rhsDelta)
+      return lhsDelta < rhsDelta;
+    // Prefer ops whose operands are available, then the longest path.
+    bool lhsStalls = readyCycle[lhs] > cycle;
+    bool rhsStalls = readyCycle[rhs] > cycle;
+    if (lhsStalls != rhsStalls)
+      return !lhsStalls;
+    if (lhsStalls && readyCycle[lhs] != readyCycle[rhs])
+      return readyCycle[lhs] < readyCycle[rhs];
+    if (heights[lhs] != heights[rhs])
+      return heights[lhs] > heights[rhs];
+    return lhs < rhs;
+  }
+
+  Block *body;
+  int maxRegisters;
+  SmallVector<Operation *> ops;
+  DenseMap<Operation *, unsigned> opIds;
+  SmallVector<llvm::SmallSetVector<unsigned, 4>> succs;
+  SmallVector<unsigned> numPreds;
+  SmallVector<unsigned> heights;
+  // The values each op uses, including inside its regions.
+  SmallVector<SmallVector<Value>> usedValues;
+  DenseMap<Value, unsigned> remainingUses;
+};
+
+} // namespace
+
 class TritonGPUReorderInstructionsPass
     : public TritonGPUReorderInstructionsBase<
           TritonGPUReorderInstructionsPass> {
 public:
   TritonGPUReorderInstructionsPass() = default;
+  TritonGPUReorderInstructionsPass(bool scheduleLoops, int maxRegisters) {
+    this->scheduleLoops = scheduleLoops;
+    this->maxRegisters = maxRegisters;
+  }
 
   Operation *getFirstUse(Operation *op) {
     std::vector<Operation *> users;
@@ -134,10 +376,39 @@ public:
         return;
       moveAfter(op, AOp);
     });
-    return;
+    if (scheduleLoops)
+      scheduleInnermostLoops(m);
+  }
+
+private:
+  void scheduleInnermostLoops(ModuleOp m) {
+    SmallVector<Block *> bodies;
+    m.walk([&](scf::ForOp forOp) {
+      Block *body = forOp.getBody();
+      bool isInnermost = true;
+      llvm::SmallDenseSet<int> roleIds;
+      for (Operation &op : *body) {
+        if (op.walk([](scf::ForOp) { return WalkResult::interrupt(); })
+                .wasInterrupted())
+          isInnermost = false;
+        roleIds.insert(getWSRoleId(&op).value_or(-1));
+      }
+      // Warp specialized bodies interleave the ops of several roles.
+      if (isInnermost && roleIds.size() == 1)
+        bodies.push_back(body);
+    });
+    for (Block *body : bodies)
+      LoopBodyScheduler(body, maxRegisters).run();
   }
 };
 
 std::unique_ptr<Pass> mlir::triton::gpu::createReorderInstructionsPass() {
   return std::make_unique<TritonGPUReorderInstructionsPass>();
 }
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::createReorderInstructionsPass(bool scheduleLoops,
+                                                 int maxRegisters) {
+  return std::make_unique<TritonGPUReorderInstructionsPass>(scheduleLoops,
+                                                            maxRegisters);
+}
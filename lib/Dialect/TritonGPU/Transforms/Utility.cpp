@@ -352,9 +352,17 @@ static std::optional<Attribute> inferSrcEncoding(triton::TransOp op,
                                  triton::inversePermutation(op.getOrder()));
 }
 
+// The results of warp ops depend on the layout of their operands.
+static bool isLayoutDependent(Operation *op) {
+  return isa<triton::WarpShuffleOp, triton::WarpBallotOp, triton::WarpReduceOp,
+             triton::WarpScanOp>(op);
+}
+
 std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
-  if (isa<triton::ScanOp>(op)) {
-    // Scan only supports blocked encoding at the moment.
+  if (isLayoutDependent(op))
+    return std::nullopt;
+  if (isa<triton::ScanOp, triton::SortOp>(op)) {
+    // Scan and sort only support blocked encoding at the moment.
     if (!isa<triton::gpu::BlockedEncodingAttr>(encoding))
       return std::nullopt;
   }
@@ -378,7 +386,9 @@ std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
 }
 
 std::optional<Attribute> inferDstEncoding(Operation *op, Attribute encoding) {
-  if (isa<triton::ScanOp>(op)) {
+  if (isLayoutDependent(op))
+    return std::nullopt;
+  if (isa<triton::ScanOp, triton::SortOp>(op)) {
     if (!isa<triton::gpu::BlockedEncodingAttr>(encoding))
       return std::nullopt;
   }
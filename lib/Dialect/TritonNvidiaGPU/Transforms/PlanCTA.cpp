@@ -24,6 +24,7 @@
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h"
+#include <limits>
 #include <queue>
 
 #define GEN_PASS_CLASSES
@@ -87,6 +88,9 @@ private:
   bool isForward(CastOp cast) const;
 
   void setTiling(llvm::ArrayRef<unsigned> CTAsPerCGA);
+  std::pair<unsigned, unsigned> getDotTiling(int64_t M, int64_t N, int64_t K,
+                                             unsigned numCTAs,
+                                             unsigned elementBytes) const;
   bool processDot(triton::FuncOp &funcOp);
   bool processReduce(triton::FuncOp &funcOp);
   void processStoreLikeOps(triton::FuncOp &funcOp);
@@ -236,23 +240,52 @@ void CTAPlanner::setTiling(llvm::ArrayRef<unsigned> CTAsPerCGA) {
   tiled = true;
 }
 
-bool CTAPlanner::processDot(triton::FuncOp &funcOp) {
-  // TODO: This is a naive implementation and should be refactored
-  auto getCTATiling = [](int64_t M, int64_t N, int64_t K,
-                         unsigned numCTAs) -> std::pair<unsigned, unsigned> {
-    // prefer a larger chunk size, at most 128; first assign splitM.
-    unsigned chunk_m = 128;
-    auto isLegal = [](unsigned chunk) { return chunk >= 64; };
-    unsigned splitM, splitN;
-    for (; isLegal(chunk_m); chunk_m /= 2) {
-      splitM = std::clamp<unsigned>(M / chunk_m, 1, numCTAs);
-      splitN = numCTAs / splitM;
-      if (isLegal(N / splitN)) // chunk_n;
-        break;
+// Picks how the CTAs of a CGA split the M and N dimensions of a dot. The CTAs
+// of a cluster row share their A tile and those of a cluster column share
+// their B tile, which TMA can multicast, so each CTA loads and keeps only
+// (chunkM + chunkN) * K operand elements. Among the splits whose chunks are
+// large enough for the MMA instructions and whose operands fit in shared
+// memory, the one with the smallest footprint gets the most reuse out of each
+// load; ties go to the larger chunkM.
+//
+// Cluster dims set by the user (e.g. from an autotuning config) that cover all
+// the CTAs are taken as is.
+std::pair<unsigned, unsigned>
+CTAPlanner::getDotTiling(int64_t M, int64_t N, int64_t K, unsigned numCTAs,
+                         unsigned elementBytes) const {
+  if (clusterInfo->clusterDimZ == 1 &&
+      unsigned(clusterInfo->clusterDimX * clusterInfo->clusterDimY) ==
+          numCTAs &&
+      M % clusterInfo->clusterDimX == 0 && N % clusterInfo->clusterDimY == 0)
+    return {clusterInfo->clusterDimX, clusterInfo->clusterDimY};
+
+  // Shared memory of an SM90 CTA.
+  constexpr int64_t maxSharedMemory = 227 * 1024;
+  constexpr int64_t minChunk = 64;
+  std::pair<unsigned, unsigned> best = {1, numCTAs};
+  int64_t bestCost = std::numeric_limits<int64_t>::max();
+  bool bestLegal = false;
+  for (unsigned splitM = 1; splitM <= numCTAs; splitM *= 2) {
+    unsigned splitN = numCTAs / splitM;
+    if (splitM > M || splitN > N)
+      continue;
+    int64_t chunkM = M / splitM, chunkN = N / splitN;
+    int64_t cost = (chunkM + chunkN) * K;
+    bool legal = chunkM >= minChunk && chunkN >= minChunk &&
+                 cost * elementBytes <= maxSharedMemory;
+    // Illegal splits are only considered when there are no legal ones.
+    if (bestLegal && !legal)
+      continue;
+    if ((legal && !bestLegal) || cost < bestCost) {
+      best = {splitM, splitN};
+      bestCost = cost;
+      bestLegal = legal;
     }
-    return {splitM, splitN};
-  };
+  }
+  return best;
+}
 
+bool CTAPlanner::processDot(triton::FuncOp &funcOp) {
   funcOp.walk([&](triton::DotOp dot) {
     MLIRContext *ctx = dot.getContext();
 
@@ -273,8 +306,12 @@ bool CTAPlanner::processDot(triton::FuncOp &funcOp) {
     unsigned N = dTy.getShape()[1];
     unsigned K = aTy.getShape()[1];
 
+    unsigned elementBytes =
+        std::max(1u, aTy.getElementType().getIntOrFloatBitWidth() / 8);
+
     unsigned splitM, splitN;
-    std::tie(splitM, splitN) = getCTATiling(M, N, K, ttg::getNumCTAs(dLayout));
+    std::tie(splitM, splitN) =
+        getDotTiling(M, N, K, ttg::getNumCTAs(dLayout), elementBytes);
     // FIXME: Should consider IR with more than one DotOps
     setTiling({splitM, splitN, 1});
 
@@ -1026,7 +1063,7 @@ mlir::createTritonNvidiaGPUPlanCTAPass(ttng::ClusterInfo *clusterInfo) {
 /* TODO
  * - Use ConvertLayoutOp instead of UnrealizedConversionCastOp.
  * - Move PlanCTAPass to the front of CoalescePass.
- * - Design better tiling strategy for DotOp and ReduceOp.
+ * - Design better tiling strategy for ReduceOp.
  * - Consider cases where there are more than one DotOps.
  * - Use better data structure for erasing CastOps from queue (linked list?).
  * - Process eliminable CastOps in higher priority.
@@ -21,6 +21,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "mlir/IR/Matchers.h"
 #include "mlir/Pass/Pass.h"
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
@@ -71,7 +72,45 @@ bool isDivisible(Value v, unsigned divisor) {
   }
 }
 
-bool shouldRemove(tt::MakeTensorPtrOp &op, int computeCapability) {
+// Whether a block pointer can be lowered to Intel 2D block loads/stores: a 2D
+// tensor of 16/32-bit elements with contiguous rows and a pitch that is a
+// multiple of 16 bytes. Unknown strides are treated as not divisible.
+bool isBlockIOCandidate(tt::MakeTensorPtrOp &op) {
+  auto resType = op.getResult()
+                     .getType()
+                     .cast<tt::PointerType>()
+                     .getPointeeType()
+                     .cast<RankedTensorType>();
+  auto elemType = resType.getElementType();
+  if (resType.getRank() != 2 || !elemType.isIntOrFloat())
+    return false;
+  unsigned bitWidth = elemType.getIntOrFloatBitWidth();
+  if (bitWidth != 16 && bitWidth != 32)
+    return false;
+  auto stride = op.getStrides();
+  if (!matchPattern(stride[1], m_One()))
+    return false;
+  unsigned divisor = 128 / bitWidth;
+  Value pitch = stride[0];
+  while (isa_and_nonnull<arith::ExtSIOp, arith::ExtUIOp>(pitch.getDefiningOp()))
+    pitch = pitch.getDefiningOp()->getOperand(0);
+  if (auto cst = pitch.getDefiningOp<arith::ConstantIntOp>())
+    return cst.value() % divisor == 0;
+  if (auto blockArg = pitch.dyn_cast<BlockArgument>()) {
+    auto func = dyn_cast<tt::FuncOp>(blockArg.getOwner()->getParentOp());
+    if (!func)
+      return false;
+    if (auto attr = func.getArgAttrOfType<IntegerAttr>(
+            blockArg.getArgNumber(), "tt.divisibility"))
+      return attr.getValue().getZExtValue() % divisor == 0;
+  }
+  return false;
+}
+
+bool shouldRemove(tt::MakeTensorPtrOp &op, int computeCapability,
+                  bool keepBlockPointers) {
+  if (keepBlockPointers)
+    return !isBlockIOCandidate(op);
   if (computeCapability < 90 || !::triton::tools::getBoolEnv("ENABLE_TMA"))
     return true;
   auto resType = op.getResult()
@@ -399,8 +438,10 @@ public:
   //     : computeCapability(computeCapability) {}
 
   TritonGPURewriteTensorPointerPass() = default;
-  TritonGPURewriteTensorPointerPass(int computeCapability) {
+  TritonGPURewriteTensorPointerPass(int computeCapability,
+                                    bool keepBlockPointers) {
     this->computeCapability = computeCapability;
+    this->keepBlockPointers = keepBlockPointers;
   }
 
   static bool needRewrite(Operation *op, const DenseSet<Value> &valueToRemove) {
@@ -531,6 +572,12 @@ public:
               dyn_cast<RankedTensorType>(storeOp.getValue().getType()))
         info.setEncoding(valueType.getEncoding());
     }
+    // Prefetches never reach out of the bounds of the tensor pointer
+    SmallVector<int32_t> allDims;
+    if (isa<tt::PrefetchOp>(op)) {
+      allDims = llvm::to_vector(llvm::seq<int32_t>(0, info.length()));
+      boundaryCheck = allDims;
+    }
 
     // Generate new `ptr`, `mask` and `other`
     auto newPtr = info.generatePtr(builder, op->getLoc());
@@ -551,6 +598,9 @@ public:
       builder.create<tt::StoreOp>(storeOp.getLoc(), newPtr, storeOp.getValue(),
                                   newMask, storeOp.getCache(),
                                   storeOp.getEvict());
+    } else if (auto prefetchOp = dyn_cast<tt::PrefetchOp>(op)) {
+      builder.create<tt::PrefetchOp>(prefetchOp.getLoc(), newPtr, newMask,
+                                     prefetchOp.getCacheLevel());
     }
 
     // Erase the original operation
@@ -754,7 +804,7 @@ public:
                                     valueToRemove);
     } else if (auto advanceOp = dyn_cast<tt::AdvanceOp>(op)) {
       return rewriteAdvanceOp(builder, advanceOp, eraser, valueToRemove);
-    } else if (isa<tt::LoadOp>(op) || isa<tt::StoreOp>(op)) {
+    } else if (isa<tt::LoadOp, tt::StoreOp, tt::PrefetchOp>(op)) {
       return rewriteLoadStoreOp(builder, op, eraser, valueToRemove);
     } else if (op->getDialect()->getNamespace() == "scf" ||
                op->getDialect()->getNamespace() == "cf") {
@@ -804,23 +854,26 @@ public:
     DenseSet<Value> valueToRemove;
     mod.walk([&valueToRemove, this](Operation *op) {
       if (auto makeTensorPtrOp = dyn_cast<tt::MakeTensorPtrOp>(op)) {
-        if (shouldRemove(makeTensorPtrOp, this->computeCapability))
+        if (shouldRemove(makeTensorPtrOp, this->computeCapability,
+                         this->keepBlockPointers))
           valueToRemove.insert(op->getResult(0));
       }
       if (llvm::isa<tt::AdvanceOp>(op)) {
         auto src = op->getOperand(0);
         if (tt::isTensorPointerType(src.getType())) {
           auto makeTensorPtrOp = getMakeTensorPtrOp(src);
-          if (shouldRemove(makeTensorPtrOp, this->computeCapability)) {
+          if (shouldRemove(makeTensorPtrOp, this->computeCapability,
+                           this->keepBlockPointers)) {
             valueToRemove.insert(op->getResult(0));
           }
         }
       }
-      if (llvm::isa<tt::LoadOp, tt::StoreOp>(op)) {
+      if (llvm::isa<tt::LoadOp, tt::StoreOp, tt::PrefetchOp>(op)) {
         auto src = op->getOperand(0);
         if (tt::isTensorPointerType(src.getType())) {
           auto makeTensorPtrOp = getMakeTensorPtrOp(src);
-          if (shouldRemove(makeTensorPtrOp, this->computeCapability))
+          if (shouldRemove(makeTensorPtrOp, this->computeCapability,
+                           this->keepBlockPointers))
             valueToRemove.insert(src);
         }
       }
@@ -829,7 +882,8 @@ public:
         for (unsigned i = 0, size = forOp.getInitArgs().size(); i < size; ++i) {
           if (tt::isTensorPointerType(iterOperands[i].getType())) {
             auto makeTensorPtrOp = getMakeTensorPtrOp(iterOperands[i]);
-            if (shouldRemove(makeTensorPtrOp, this->computeCapability))
+            if (shouldRemove(makeTensorPtrOp, this->computeCapability,
+                             this->keepBlockPointers))
               valueToRemove.insert(iterOperands[i]);
           }
         }
@@ -838,7 +892,8 @@ public:
         for (unsigned i = 0, size = yieldOp.getNumOperands(); i < size; ++i) {
           if (tt::isTensorPointerType(operands[i].getType())) {
             auto makeTensorPtrOp = getMakeTensorPtrOp(operands[i]);
-            if (shouldRemove(makeTensorPtrOp, this->computeCapability))
+            if (shouldRemove(makeTensorPtrOp, this->computeCapability,
+                             this->keepBlockPointers))
               valueToRemove.insert(operands[i]);
           }
         }
@@ -855,7 +910,7 @@ public:
     // operations and make a canonicalization pass to optimize, which is much
     // So here we recursively build the IR, to be specific, we have to rewrite
     // `tt.make_tensor_ptr`, `tt.advance`, `tt.load`, `tt.store`,
-    // `scf.for` (tensor pointer usages may be in a loop fashion)
+    // `tt.prefetch`, `scf.for` (tensor pointer usages may be in a loop fashion)
     std::stack<Operation *> eraser;
     visitOperation(getOperation(), eraser, valueToRemove);
 
@@ -872,6 +927,8 @@ public:
 };
 
 std::unique_ptr<Pass>
-mlir::createTritonGPURewriteTensorPointerPass(int computeCapability) {
-  return std::make_unique<TritonGPURewriteTensorPointerPass>(computeCapability);
+mlir::createTritonGPURewriteTensorPointerPass(int computeCapability,
+                                              bool keepBlockPointers) {
+  return std::make_unique<TritonGPURewriteTensorPointerPass>(
+      computeCapability, keepBlockPointers);
 }
@@ -510,6 +510,12 @@ bool isWSSupported(ModuleOp mod, int computeCapability) {
     return false;
   }
 
+  // Agents are made of whole warpgroups, and a producer and a consumer agent
+  // must fit in a CTA of at most 32 warps.
+  int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
+  if (numWarps % 4 != 0 || 2 * numWarps > 32)
+    return false;
+
   // TODO: support function call.
   triton::FuncOp funcOp;
   if (mod->walk([&](triton::FuncOp op) {
@@ -23,6 +23,7 @@
 
 #include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h"
 
+#include <algorithm>
 #include <set>
 
 #include "mlir/IR/OperationSupport.h"
@@ -49,7 +50,7 @@ enum class LoadType {
 };
 
 // This helper function returns the real threadId while ttng::GetThreadIdOp is
-// actually threadId % 128 when warp specialization is enabled
+// actually the thread id within the agent when warp specialization is enabled
 Value getThreadId(OpBuilder &builder, Location loc) {
   Value threadId = builder.create<::mlir::gpu::ThreadIdOp>(
       loc, builder.getIndexType(), ::mlir::gpu::Dimension::x);
@@ -62,15 +63,19 @@ Value getThreadId(OpBuilder &builder, Location loc) {
 // Materialize GetAgentIdOp
 //===----------------------------------------------------------------------===//
 
-void materializeGetAgentIdOp(Operation *parentOp) {
-  parentOp->walk([](ttng::GetAgentIdOp op) {
-    // In Hopper, each agent is a warpgroup consisting with 4 warps.
+void materializeGetAgentIdOp(ModuleOp parentOp) {
+  // Each agent has the module's num-warps warps, i.e. one or more Hopper
+  // warpgroups of 4 warps.
+  int warpsPerAgent = ttg::TritonGPUDialect::getNumWarps(parentOp);
+  parentOp->walk([&](ttng::GetAgentIdOp op) {
     auto loc = op.getLoc();
     OpBuilder builder(op);
 
-    Value _4 = builder.create<arith::ConstantIntOp>(loc, 4, 32);
+    Value warpsPerAgentValue =
+        builder.create<arith::ConstantIntOp>(loc, warpsPerAgent, 32);
     Value warpId = builder.create<ttng::GetCanonicalWarpId>(loc);
-    Value agentId = builder.create<arith::DivUIOp>(loc, warpId, _4);
+    Value agentId =
+        builder.create<arith::DivUIOp>(loc, warpId, warpsPerAgentValue);
     op.getResult().replaceAllUsesWith(agentId);
     op->erase();
 
@@ -91,8 +96,7 @@ void materializeGetAgentIdOp(Operation *parentOp) {
           if (u->hasAttr("agent.num-roles")) {
             numRoles =
                 u->getAttrOfType<IntegerAttr>("agent.num-roles").getInt();
-            // TODO: more flexible ways to get numWarps.
-            auto numWarps = builder.getI32IntegerAttr(4 * numRoles);
+            auto numWarps = builder.getI32IntegerAttr(warpsPerAgent * numRoles);
             auto numWarpsBase = builder.getI32IntegerAttr(globalNumWarps);
             u->setAttr("agent.num-warps", numWarps);
             u->walk([&](ttng::GetMutexRoleIdOp roleIdOp) {
@@ -100,7 +104,7 @@ void materializeGetAgentIdOp(Operation *parentOp) {
               roleIdOp->setAttr("agent.num-warps-base", numWarpsBase);
             });
           }
-          globalNumWarps += numRoles * 4;
+          globalNumWarps += numRoles * warpsPerAgent;
           Value offset =
               builder.create<arith::ConstantIntOp>(loc, numRoles, 32);
           Value lowerBound = builder.create<arith::CmpIOp>(
@@ -291,7 +295,8 @@ void processConsumerWaitOp(OpBuilder &builder, ttng::ConsumerWaitOp op,
 }
 
 void processConsumerReleaseOp(OpBuilder &builder, ttng::ConsumerReleaseOp op,
-                              Value bufferEmpty, int numCTAs) {
+                              Value bufferEmpty, int numCTAs,
+                              int threadsPerAgent) {
   auto loc = op.getLoc();
 
   // Constants
@@ -300,10 +305,12 @@ void processConsumerReleaseOp(OpBuilder &builder, ttng::ConsumerReleaseOp op,
   Value _8 = builder.create<arith::ConstantIntOp>(loc, 8, 32);
   Value _32 = builder.create<arith::ConstantIntOp>(loc, 32, 32);
   Value _128 = builder.create<arith::ConstantIntOp>(loc, 128, 32);
+  Value threadsPerAgentValue =
+      builder.create<arith::ConstantIntOp>(loc, threadsPerAgent, 32);
 
-  // threadId = threadId % 128
-  Value threadId =
-      builder.create<arith::RemUIOp>(loc, getThreadId(builder, loc), _128);
+  // threadId = threadId % threadsPerAgent
+  Value threadId = builder.create<arith::RemUIOp>(
+      loc, getThreadId(builder, loc), threadsPerAgentValue);
 
   // k = threadId / 8
   Value k = builder.create<arith::DivUIOp>(loc, threadId, _8);
@@ -334,6 +341,13 @@ void processConsumerReleaseOp(OpBuilder &builder, ttng::ConsumerReleaseOp op,
   // pred = pred0 & pred1
   Value pred = builder.create<arith::AndIOp>(loc, pred0, pred1);
 
+  // Only the first warpgroup of the agent arrives, once per remote CTA.
+  if (threadsPerAgent > 128)
+    pred = builder.create<arith::AndIOp>(
+        loc, pred,
+        builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ult,
+                                      threadId, _128));
+
   // bufferEmpty arrive
   auto arriveOp = builder.create<ttng::MBarrierArriveOp>(loc, bufferEmpty, pred,
                                                          remoteCTAId, false, 0);
@@ -342,7 +356,8 @@ void processConsumerReleaseOp(OpBuilder &builder, ttng::ConsumerReleaseOp op,
   setAgentIds(arriveOp, getAgentIds(op.getOperation()));
 }
 
-void materializeTokenOperations(Operation *parentOp, int numCTAs) {
+void materializeTokenOperations(Operation *parentOp, int numCTAs,
+                                int threadsPerAgent) {
   SmallVector<Operation *> deprecatedOps;
   parentOp->walk([&](ttng::CreateTokenOp createTokenOp) {
     // Scan load type
@@ -363,7 +378,9 @@ void materializeTokenOperations(Operation *parentOp, int numCTAs) {
     // Process CreateTokenOp
     OpBuilder builder(createTokenOp);
     auto tokenLoc = createTokenOp.getLoc();
-    unsigned bufferFullCount = loadType == LoadType::InsertSliceTMAOp ? 1 : 128;
+    // Every thread of the producer agent arrives after its async copies.
+    unsigned bufferFullCount =
+        loadType == LoadType::InsertSliceTMAOp ? 1 : threadsPerAgent;
     Value bufferFullArray = builder.create<ttng::AllocMBarrierOp>(
         tokenLoc, mBarriersTy, bufferFullCount);
     Value bufferEmptyArray =
@@ -412,7 +429,8 @@ void materializeTokenOperations(Operation *parentOp, int numCTAs) {
         Value bufferEmpty = extractBufferEmpty(loc, op.getIdx());
         assert(user->hasAttr("async_agent"));
         setAgentIds(bufferEmpty.getDefiningOp(), getAgentIds(user));
-        processConsumerReleaseOp(builder, op, bufferEmpty, numCTAs);
+        processConsumerReleaseOp(builder, op, bufferEmpty, numCTAs,
+                                 threadsPerAgent);
       } else {
         llvm_unreachable("Unexpected user of token");
       }
@@ -462,6 +480,7 @@ void mutexSyncPingPang(Operation *parentOp, int numAgents, int &nameBarrierId,
   int numRoles = 2, times = 0;
   globalNumRoles += numRoles;
   Value roleId;
+  int agentNumWarps = 0;
   parentOp->walk([&](ttng::GetMutexRoleIdOp getMutexRoleIdOp) {
     // GetMutexRoleIdOp only occurs once.
     assert(times == 0);
@@ -477,7 +496,7 @@ void mutexSyncPingPang(Operation *parentOp, int numAgents, int &nameBarrierId,
         getMutexRoleIdOp->getAttrOfType<IntegerAttr>("agent.num-warps-base")
             .getInt();
     assert(numWarps % numRoles == 0);
-    // TODO: more flexible ways to determine numWarps of each agent.
+    agentNumWarps = numWarps;
     Value numRolesValue =
         builder.create<arith::ConstantIntOp>(loc, numRoles, 32);
     Value numWarpsValue =
@@ -502,9 +521,12 @@ void mutexSyncPingPang(Operation *parentOp, int numAgents, int &nameBarrierId,
     assert(nameBarrierId > globalNumRoles);
     // Process CreateMutexOp
     OpBuilder builder(createMutexOp);
-    // TODO: change the hard code of numThreads
+    // The barriers synchronize all the roles of the agent.
     auto loc = createMutexOp->getLoc();
-    Value numThreads = builder.create<arith::ConstantIntOp>(loc, 256, 32);
+    auto mod = createMutexOp->getParentOfType<ModuleOp>();
+    int threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    Value numThreads = builder.create<arith::ConstantIntOp>(
+        loc, agentNumWarps * threadsPerWarp, 32);
     Value _0 = builder.create<arith::ConstantIntOp>(loc, 0, 32);
     Value isRole0 = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
                                                   roleId, _0);
@@ -622,10 +644,11 @@ void materializeMutexOperations(ModuleOp parentOp) {
   materializeMutexOperationsOthers(parentOp);
 }
 
-// TODO: may also not support 8-warp kernel.
 void tryRegisterRealloc(ModuleOp mod) {
   constexpr int LoadRegisterRequirement = 40;
-  constexpr int MmaRegisterRequirement = 232;
+  constexpr int MaxMmaRegisterRequirement = 232;
+  // Registers of an SM, shared by all the threads of the CTA.
+  constexpr int NumRegisters = 64 * 1024;
   OpBuilderWithAgentIds builder(mod.getContext());
 
   auto isLoadAgent = [](scf::IfOp ifOp) -> bool {
@@ -660,6 +683,28 @@ void tryRegisterRealloc(ModuleOp mod) {
       }
     }
   });
+  // Split what the load agent gives up between the mma agents. setmaxnreg
+  // takes multiples of 8.
+  int threadsPerAgent = ttg::TritonGPUDialect::getNumWarps(mod) *
+                        ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+  int numMmaAgents = 0;
+  for (auto ifOp : agentOps) {
+    if (isMmaAgent(ifOp) && !isLoadAgent(ifOp)) {
+      int numRoles = 1;
+      if (auto attr = ifOp->getAttrOfType<IntegerAttr>("agent.num-roles"))
+        numRoles = attr.getInt();
+      numMmaAgents += numRoles;
+    }
+  }
+  int mmaRegisterRequirement = MaxMmaRegisterRequirement;
+  if (numMmaAgents > 0)
+    mmaRegisterRequirement = std::min(
+        MaxMmaRegisterRequirement,
+        (NumRegisters / threadsPerAgent - LoadRegisterRequirement) /
+            numMmaAgents / 8 * 8);
+  if (mmaRegisterRequirement < LoadRegisterRequirement)
+    return;
+
   for (auto ifOp : agentOps) {
     builder.setInsertionPointToStart(&(ifOp.getThenRegion().front()));
     builder.setAgentIdsFromOp(ifOp);
@@ -670,7 +715,7 @@ void tryRegisterRealloc(ModuleOp mod) {
       continue;
     if (isMmaAgent(ifOp)) {
       builder.createWithAgentIds<ttng::RegAllocOp>(
-          loc, builder.getIntegerAttr(i32_ty, MmaRegisterRequirement));
+          loc, builder.getIntegerAttr(i32_ty, mmaRegisterRequirement));
     } else if (isLoadAgent(ifOp)) {
       builder.createWithAgentIds<ttng::RegDeallocOp>(
           loc, builder.getIntegerAttr(i32_ty, LoadRegisterRequirement));
@@ -679,8 +724,8 @@ void tryRegisterRealloc(ModuleOp mod) {
 }
 
 // This pass adds top-level `if` statements to the module so that:
-//   - there's one group of four warps that handles memory operations, and
-//   - there are one or two groups of four warps handling math operations.
+//   - there's one group of num-warps warps that handles memory operations, and
+//   - there are one or two groups of num-warps warps handling math operations.
 //
 // If we use two groups for math operations, it's in "ping-pong" fashion:
 // The memory warp group does loads/stores for group A while group B runs, then
@@ -704,15 +749,18 @@ struct WSMaterializationPass
 
     int numCTAs = ttg::TritonGPUDialect::getNumCTAs(mod);
 
+    int threadsPerAgent = ttg::TritonGPUDialect::getNumWarps(mod) *
+                          ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+
     materializeGetAgentIdOp(mod);
-    materializeTokenOperations(mod, numCTAs);
+    materializeTokenOperations(mod, numCTAs, threadsPerAgent);
     materializeMutexOperations(mod);
     tryRegisterRealloc(mod);
 
-    // The IR before this pass specifies 4 warps per CTA.  But this pass splits
-    // things so that there are 4 warps per *group* (aka "agent"), and there are
-    // 2 or 3 groups.  So from CUDA's perspective there are now 8 or 12 warps
-    // per CTA.
+    // The IR before this pass specifies num-warps (e.g. 4) warps per CTA.  But
+    // this pass splits things so that there are num-warps warps per *group*
+    // (aka "agent"), and there are 2 or 3 groups.  So from CUDA's perspective
+    // there are now e.g. 8 or 12 warps per CTA.
     //
     // A natural thing to do would be to change the module's num-warps property
     // to be 8 or 12 to match the new reality.  But it's actually better to keep
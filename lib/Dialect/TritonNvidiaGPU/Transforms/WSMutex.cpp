@@ -345,6 +345,10 @@ public:
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     ModuleOp mod = getOperation();
+    // Ping-pong consumers add a third agent, which must fit in a CTA of at
+    // most 32 warps.
+    if (3 * triton::gpu::TritonGPUDialect::getNumWarps(mod) > 32)
+      return;
     mod.walk([&](triton::FuncOp funcOp) {
       for (Operation &bodyOp : funcOp.getBody().front().getOperations()) {
         Operation *op = &bodyOp;
@@ -1,5 +1,7 @@
 #include "triton/Target/SPIRV/SPIRVTranslation.h"
+#include <map>
 #include <optional>
+#include <stdexcept>
 
 #include "LLVMSPIRVLib.h"
 #include "llvm/IR/IRBuilder.h"
@@ -10,6 +12,7 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 
 namespace triton {
@@ -32,7 +35,63 @@ public:
   SmallVectorBuffer(llvm::SmallVectorImpl<char> &O) : OS(O) {}
 };
 
-std::string translateLLVMIRToSPIRV(llvm::Module &module) {
+static const std::map<std::string, SPIRV::ExtensionID> &getExtensionIDs() {
+  static const std::map<std::string, SPIRV::ExtensionID> extensionIDs = {
+#define EXT(X) {#X, SPIRV::ExtensionID::X},
+#include "LLVMSPIRVExtensions.inc"
+#undef EXT
+  };
+  return extensionIDs;
+}
+
+static void setExtensions(SPIRV::TranslatorOpts &SPIRVOpts,
+                          const SPIRVTranslationOptions &options) {
+  if (!options.extensions) {
+    SPIRVOpts.enableAllExtensions();
+    return;
+  }
+  // Extensions unknown to the linked translator are skipped: it could not
+  // make use of them anyway.
+  const auto &extensionIDs = getExtensionIDs();
+  for (const std::string &name : *options.extensions) {
+    auto it = extensionIDs.find(name);
+    if (it != extensionIDs.end())
+      SPIRVOpts.setAllowedToUseExtension(it->second);
+  }
+}
+
+static std::string translateWithLLVMBackend(llvm::Module &module) {
+  const std::string triple = "spirv64-unknown-unknown";
+  std::string error;
+  const llvm::Target *target =
+      llvm::TargetRegistry::lookupTarget(triple, error);
+  if (!target)
+    throw std::runtime_error("SPIRVTranslation: LLVM SPIR-V backend is not "
+                             "available: " +
+                             error);
+  module.setTargetTriple(triple);
+  llvm::TargetOptions opt;
+  std::unique_ptr<llvm::TargetMachine> machine{target->createTargetMachine(
+      triple, "", "", opt, std::nullopt, std::nullopt,
+      llvm::CodeGenOptLevel::Aggressive)};
+  module.setDataLayout(machine->createDataLayout());
+
+  std::string result;
+  {
+    llvm::raw_string_ostream stream(result);
+    llvm::buffer_ostream pstream(stream);
+    llvm::legacy::PassManager pass;
+    if (machine->addPassesToEmitFile(pass, pstream, nullptr,
+                                     llvm::CodeGenFileType::ObjectFile))
+      throw std::runtime_error(
+          "SPIRVTranslation: LLVM SPIR-V backend cannot emit a binary");
+    pass.run(module);
+  }
+  return result;
+}
+
+std::string translateLLVMIRToSPIRV(llvm::Module &module,
+                                   const SPIRVTranslationOptions &options) {
   // initLLVM();
 
   llvm::SmallVector<char, 0> buffer;
@@ -50,17 +109,21 @@ std::string translateLLVMIRToSPIRV(llvm::Module &module) {
     return result;
   }
 
+  if (options.useLLVMBackend)
+    return translateWithLLVMBackend(module);
+
   // emit
   SmallVectorBuffer StreamBuf(buffer);
   std::ostream OS(&StreamBuf);
   std::string Err;
 
   SPIRV::TranslatorOpts SPIRVOpts;
-  SPIRVOpts.enableAllExtensions();
+  setExtensions(SPIRVOpts, options);
   SPIRVOpts.setMemToRegEnabled(true);
   SPIRVOpts.setPreserveOCLKernelArgTypeMetadataThroughString(true);
   SPIRVOpts.setPreserveAuxData(false);
-  SPIRVOpts.setSPIRVAllowUnknownIntrinsics({"llvm.genx.GenISA."});
+  SPIRVOpts.setSPIRVAllowUnknownIntrinsics(
+      {options.allowedIntrinsics.begin(), options.allowedIntrinsics.end()});
   auto success = llvm::writeSpirv(&module, SPIRVOpts, OS, Err);
 
   if (!success) {
@@ -278,6 +278,7 @@ class CMakeBuild(build_ext):
 
         for ext in self.extensions:
             self.build_extension(ext)
+        record_tool_versions()
 
     def build_extension(self, ext):
         lit_dir = shutil.which('lit')
@@ -389,6 +390,16 @@ download_and_copy(
 backends = _copy_backends(["intel"])
 
 
+def record_tool_versions():
+    # the backends read the versions of their bundled tools, which are part of
+    # their cache keys, from these files instead of running the tools
+    for backend in backends:
+        tool = os.path.join(backend.backend_dir, "bin", "spirv-dis")
+        if os.path.isfile(tool):
+            version = subprocess.check_output([tool, "--version"]).decode()
+            Path(f"{tool}.version").write_text(version)
+
+
 def add_link_to_backends():
     for backend in backends:
         if os.path.islink(backend.install_dir):
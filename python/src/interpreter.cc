@@ -1,44 +1,618 @@
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace py = pybind11;
 
+namespace {
+
+template <typename T>
+using contiguous_array_t =
+    py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+// Copies one element; the common sizes compile to a single move.
+inline void copyElement(void *dst, const void *src, size_t itemsize) {
+  switch (itemsize) {
+  case 1:
+    memcpy(dst, src, 1);
+    break;
+  case 2:
+    memcpy(dst, src, 2);
+    break;
+  case 4:
+    memcpy(dst, src, 4);
+    break;
+  case 8:
+    memcpy(dst, src, 8);
+    break;
+  default:
+    memcpy(dst, src, itemsize);
+  }
+}
+
+// Copies `count` elements, in one `memcpy` when there are several.
+inline void copyElements(void *dst, const void *src, size_t count,
+                         size_t itemsize) {
+  if (count == 1)
+    copyElement(dst, src, itemsize);
+  else
+    memcpy(dst, src, count * itemsize);
+}
+
+// Returns the end of the run of enabled elements from `begin` whose
+// addresses follow each other, so that they can be copied at once.
+size_t getContiguousRunEnd(const uint64_t *ptrs, const bool *masks,
+                           size_t begin, size_t numel, size_t itemsize) {
+  size_t end = begin + 1;
+  while (end < numel && masks[end] && ptrs[end] == ptrs[end - 1] + itemsize)
+    ++end;
+  return end;
+}
+
+// Returns the end of the run of disabled elements from `begin`.
+size_t getMaskedRunEnd(const bool *masks, size_t begin, size_t numel) {
+  size_t end = begin + 1;
+  while (end < numel && !masks[end])
+    ++end;
+  return end;
+}
+
+// IEEE half precision conversions, rounding to nearest even.
+float halfToFloat(uint16_t h) {
+  uint32_t sign = (h & 0x8000u) << 16;
+  uint32_t exp = (h >> 10) & 0x1f;
+  uint32_t mant = h & 0x3ff;
+  uint32_t bits;
+  if (exp == 0 && mant == 0) {
+    bits = sign;
+  } else if (exp == 0) {
+    // subnormal, normalized in single precision
+    exp = 127 - 15 + 1;
+    while (!(mant & 0x400)) {
+      mant <<= 1;
+      --exp;
+    }
+    bits = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+  } else if (exp == 0x1f) {
+    bits = sign | 0x7f800000u | (mant << 13);
+  } else {
+    bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+  }
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+uint16_t floatToHalf(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  uint16_t sign = (bits >> 16) & 0x8000;
+  uint32_t exp = (bits >> 23) & 0xff;
+  uint32_t mant = bits & 0x7fffff;
+  if (exp == 0xff)
+    return sign | 0x7c00 | (mant ? 0x200 : 0);
+  int32_t e = (int32_t)exp - 127 + 15;
+  if (e >= 0x1f)
+    return sign | 0x7c00;
+  if (e <= 0) {
+    if (e < -10)
+      return sign;
+    uint32_t full = mant | 0x800000;
+    uint32_t shift = 14 - e;
+    uint32_t halfMant = full >> shift;
+    uint32_t rem = full & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if (rem > halfway || (rem == halfway && (halfMant & 1)))
+      ++halfMant;
+    // a carry out of the mantissa gives the smallest normal number
+    return sign | halfMant;
+  }
+  uint16_t h = sign | (e << 10) | (mant >> 13);
+  uint32_t rem = mant & 0x1fff;
+  if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+    ++h;
+  return h;
+}
+
+// An element stored as `S` and computed on as `C`.
+template <typename S, typename C = S> struct Element {
+  using Storage = S;
+  using Compute = C;
+  static C get(S v) { return static_cast<C>(v); }
+  static S set(C v) { return static_cast<S>(v); }
+};
+
+struct Half : Element<uint16_t, float> {
+  static float get(uint16_t v) { return halfToFloat(v); }
+  static uint16_t set(float v) { return floatToHalf(v); }
+};
+
+// Calls `fn` with the `Element` of the numpy `dtype`.
+template <typename Fn> void dispatchElement(py::dtype dtype, Fn &&fn) {
+  char kind = dtype.kind();
+  size_t size = dtype.itemsize();
+  if (kind == 'i' && size == 1)
+    return fn(Element<int8_t>());
+  if (kind == 'i' && size == 2)
+    return fn(Element<int16_t>());
+  if (kind == 'i' && size == 4)
+    return fn(Element<int32_t>());
+  if (kind == 'i' && size == 8)
+    return fn(Element<int64_t>());
+  if (kind == 'u' && size == 1)
+    return fn(Element<uint8_t>());
+  if (kind == 'u' && size == 2)
+    return fn(Element<uint16_t>());
+  if (kind == 'u' && size == 4)
+    return fn(Element<uint32_t>());
+  if (kind == 'u' && size == 8)
+    return fn(Element<uint64_t>());
+  if (kind == 'f' && size == 2)
+    return fn(Half());
+  if (kind == 'f' && size == 4)
+    return fn(Element<float>());
+  if (kind == 'f' && size == 8)
+    return fn(Element<double>());
+  throw py::type_error("unsupported dtype " +
+                       py::str(dtype).cast<std::string>());
+}
+
+// Mirrors `mlir::triton::RMWOp`, by the names of `ir.ATOMIC_OP`.
+enum class RMWOp {
+  AND,
+  OR,
+  XOR,
+  ADD,
+  FADD,
+  MAX,
+  MIN,
+  UMAX,
+  UMIN,
+  XCHG,
+  FMAX,
+  FMIN
+};
+
+RMWOp getRMWOp(const std::string &name) {
+  static const std::pair<const char *, RMWOp> ops[] = {
+      {"AND", RMWOp::AND},   {"OR", RMWOp::OR},     {"XOR", RMWOp::XOR},
+      {"ADD", RMWOp::ADD},   {"FADD", RMWOp::FADD}, {"MAX", RMWOp::MAX},
+      {"MIN", RMWOp::MIN},   {"UMAX", RMWOp::UMAX}, {"UMIN", RMWOp::UMIN},
+      {"XCHG", RMWOp::XCHG}, {"FMAX", RMWOp::FMAX}, {"FMIN", RMWOp::FMIN}};
+  for (auto [opName, op] : ops)
+    if (name == opName)
+      return op;
+  throw py::value_error("unknown atomic op " + name);
+}
+
+template <typename T> bool isSupported(RMWOp op) {
+  if (op == RMWOp::XCHG)
+    return true;
+  if constexpr (std::is_integral_v<T>)
+    return op != RMWOp::FADD && op != RMWOp::FMAX && op != RMWOp::FMIN;
+  else
+    return op == RMWOp::ADD || op == RMWOp::FADD || op == RMWOp::FMAX ||
+           op == RMWOp::FMIN;
+}
+
+template <typename T> T applyRMW(RMWOp op, T old, T val) {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    switch (op) {
+    case RMWOp::AND:
+      return old & val;
+    case RMWOp::OR:
+      return old | val;
+    case RMWOp::XOR:
+      return old ^ val;
+    case RMWOp::ADD:
+      // wraps around like the hardware does
+      return static_cast<T>(static_cast<U>(old) + static_cast<U>(val));
+    case RMWOp::MAX:
+      return std::max(old, val);
+    case RMWOp::MIN:
+      return std::min(old, val);
+    case RMWOp::UMAX:
+      return static_cast<T>(std::max(static_cast<U>(old), static_cast<U>(val)));
+    case RMWOp::UMIN:
+      return static_cast<T>(std::min(static_cast<U>(old), static_cast<U>(val)));
+    default:
+      return val;
+    }
+  } else {
+    switch (op) {
+    case RMWOp::ADD:
+    case RMWOp::FADD:
+      return old + val;
+    case RMWOp::FMAX:
+      return std::fmax(old, val);
+    case RMWOp::FMIN:
+      return std::fmin(old, val);
+    default:
+      return val;
+    }
+  }
+}
+
+// Applies `op` to each enabled element with one atomic update, so that
+// programs running on several threads see each other's updates.
+template <typename E>
+void atomicRMW(RMWOp op, const uint64_t *ptrs, const char *values,
+               const bool *masks, char *olds, size_t numel) {
+  using S = typename E::Storage;
+  for (size_t i = 0; i < numel; ++i) {
+    if (!masks[i])
+      continue;
+    S *ptr = reinterpret_cast<S *>(ptrs[i]);
+    S val;
+    memcpy(&val, values + i * sizeof(S), sizeof(S));
+    S old;
+    S desired;
+    __atomic_load(ptr, &old, __ATOMIC_RELAXED);
+    do {
+      desired = E::set(applyRMW(op, E::get(old), E::get(val)));
+    } while (!__atomic_compare_exchange(ptr, &old, &desired, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+    memcpy(olds + i * sizeof(S), &old, sizeof(S));
+  }
+}
+
+template <typename S>
+void atomicCAS(const uint64_t *ptrs, const char *cmps, const char *values,
+               char *olds, size_t numel) {
+  for (size_t i = 0; i < numel; ++i) {
+    S *ptr = reinterpret_cast<S *>(ptrs[i]);
+    S expected;
+    S val;
+    memcpy(&expected, cmps + i * sizeof(S), sizeof(S));
+    memcpy(&val, values + i * sizeof(S), sizeof(S));
+    // `expected` holds the previous value whether the exchange happens or not
+    __atomic_compare_exchange(ptr, &expected, &val, false, __ATOMIC_ACQ_REL,
+                              __ATOMIC_ACQUIRE);
+    memcpy(olds + i * sizeof(S), &expected, sizeof(S));
+  }
+}
+
+// Converts `numel` elements of `data` to the accumulation type `A`.
+template <typename E, typename A>
+std::vector<A> convertElements(const char *data, size_t numel) {
+  using S = typename E::Storage;
+  std::vector<A> ret(numel);
+  for (size_t i = 0; i < numel; ++i) {
+    S v;
+    memcpy(&v, data + i * sizeof(S), sizeof(S));
+    ret[i] = static_cast<A>(E::get(v));
+  }
+  return ret;
+}
+
+// acc[M, N] += a[M, K] * b[K, N], blocked along K so that the rows of `b` a
+// block uses stay in cache while the rows of `acc` are updated.
+template <typename A>
+void dotAccumulate(const A *a, const A *b, A *acc, size_t M, size_t N,
+                   size_t K) {
+  constexpr size_t blockK = 64;
+  for (size_t k0 = 0; k0 < K; k0 += blockK) {
+    size_t k1 = std::min(K, k0 + blockK);
+    for (size_t i = 0; i < M; ++i) {
+      A *accRow = acc + i * N;
+      for (size_t k = k0; k < k1; ++k) {
+        A aik = a[i * K + k];
+        const A *bRow = b + k * N;
+        for (size_t j = 0; j < N; ++j)
+          accRow[j] += aik * bRow[j];
+      }
+    }
+  }
+}
+
+// The block a block pointer designates in its tensor. Shapes, strides and
+// offsets are in elements.
+struct BlockDesc {
+  char *base;
+  std::vector<int64_t> shape;
+  std::vector<int64_t> strides;
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> blockShape;
+  std::vector<bool> boundaryCheck;
+  size_t itemsize;
+};
+
+// Copies the in-bounds elements of the block between the tensor and the
+// row-major buffer `block`, a row of the innermost dimension at a time.
+// Elements of the block outside of the checked dimensions of the tensor are
+// left untouched.
+template <bool IsStore> void copyBlock(const BlockDesc &desc, char *block) {
+  size_t rank = desc.blockShape.size();
+  size_t last = rank - 1;
+  int64_t rowSize = desc.blockShape[last];
+  // the part of the rows within the tensor
+  int64_t lo = 0, hi = rowSize;
+  if (desc.boundaryCheck[last]) {
+    lo = std::clamp<int64_t>(-desc.offsets[last], 0, rowSize);
+    hi = std::clamp<int64_t>(desc.shape[last] - desc.offsets[last], lo,
+                             rowSize);
+  }
+  int64_t numRows = 1;
+  for (size_t d = 0; d < last; ++d)
+    numRows *= desc.blockShape[d];
+  if (lo == hi || numRows == 0)
+    return;
+  std::vector<int64_t> idx(rank, 0);
+  int64_t lastStride = desc.strides[last];
+  size_t itemsize = desc.itemsize;
+  for (int64_t row = 0; row < numRows; ++row) {
+    bool inBounds = true;
+    int64_t offset = (desc.offsets[last] + lo) * lastStride;
+    for (size_t d = 0; d < last; ++d) {
+      int64_t i = desc.offsets[d] + idx[d];
+      if (desc.boundaryCheck[d] && (i < 0 || i >= desc.shape[d]))
+        inBounds = false;
+      offset += i * desc.strides[d];
+    }
+    if (inBounds) {
+      char *tensorPtr = desc.base + offset * (int64_t)itemsize;
+      char *blockPtr = block + (row * rowSize + lo) * itemsize;
+      if (lastStride == 1) {
+        if (IsStore)
+          copyElements(tensorPtr, blockPtr, hi - lo, itemsize);
+        else
+          copyElements(blockPtr, tensorPtr, hi - lo, itemsize);
+      } else {
+        for (int64_t j = lo; j < hi; ++j) {
+          if (IsStore)
+            copyElement(tensorPtr, blockPtr, itemsize);
+          else
+            copyElement(blockPtr, tensorPtr, itemsize);
+          tensorPtr += lastStride * (int64_t)itemsize;
+          blockPtr += itemsize;
+        }
+      }
+    }
+    // next row in row-major order
+    for (size_t d = last; d-- > 0;) {
+      if (++idx[d] < desc.blockShape[d])
+        break;
+      idx[d] = 0;
+    }
+  }
+}
+
+BlockDesc getBlockDesc(uint64_t base, std::vector<int64_t> shape,
+                       std::vector<int64_t> strides,
+                       std::vector<int64_t> offsets,
+                       std::vector<int64_t> blockShape,
+                       std::vector<bool> boundaryCheck, size_t itemsize) {
+  size_t rank = blockShape.size();
+  if (rank == 0 || shape.size() != rank || strides.size() != rank ||
+      offsets.size() != rank || boundaryCheck.size() != rank)
+    throw py::value_error("expected one shape, stride, offset and boundary "
+                          "check per dimension of the block");
+  return BlockDesc{reinterpret_cast<char *>(base), std::move(shape),
+                   std::move(strides),             std::move(offsets),
+                   std::move(blockShape),          std::move(boundaryCheck),
+                   itemsize};
+}
+
+} // namespace
+
 void init_triton_interpreter(py::module &&m) {
   using ret = py::return_value_policy;
 
   m.def("load",
-        [](py::array_t<uint64_t> ptrs, py::array_t<bool> masks, py::array other,
-           py::dtype ret_dtype) -> py::array {
-          int numel = ptrs.size();
+        [](contiguous_array_t<uint64_t> ptrs, contiguous_array_t<bool> masks,
+           py::array other, py::dtype ret_dtype) -> py::array {
+          size_t numel = ptrs.size();
           auto shape =
               std::vector<ptrdiff_t>(ptrs.shape(), ptrs.shape() + ptrs.ndim());
-          py::array ret(ret_dtype, py::array::ShapeContainer{numel});
-          py::array_t<uint64_t> reshaped_ptrs = ptrs.reshape({numel});
-          py::array_t<bool> reshaped_masks = masks.reshape({numel});
-          py::array reshaped_others = other.reshape({numel});
-          for (size_t i = 0; i < ptrs.size(); ++i) {
-            if (reshaped_masks.at(i))
-              memcpy(ret.mutable_data(i),
-                     reinterpret_cast<void *>(reshaped_ptrs.at(i)),
-                     ret_dtype.itemsize());
-            else
-              memcpy(ret.mutable_data(i), reshaped_others.data(i),
-                     ret_dtype.itemsize());
+          py::array ret(ret_dtype, shape);
+          py::array others = py::array::ensure(other, py::array::c_style);
+          if (!others || (size_t)masks.size() != numel ||
+              (size_t)others.size() != numel)
+            throw py::value_error("expected one mask and other per pointer");
+          const uint64_t *ptrData = ptrs.data();
+          const bool *maskData = masks.data();
+          const char *otherData = static_cast<const char *>(others.data());
+          char *retData = static_cast<char *>(ret.mutable_data());
+          size_t itemsize = ret_dtype.itemsize();
+          // Only raw buffers are touched from here on.
+          py::gil_scoped_release release;
+          for (size_t i = 0; i < numel;) {
+            size_t end;
+            if (maskData[i]) {
+              end = getContiguousRunEnd(ptrData, maskData, i, numel, itemsize);
+              copyElements(retData + i * itemsize,
+                           reinterpret_cast<const void *>(ptrData[i]), end - i,
+                           itemsize);
+            } else {
+              end = getMaskedRunEnd(maskData, i, numel);
+              copyElements(retData + i * itemsize, otherData + i * itemsize,
+                           end - i, itemsize);
+            }
+            i = end;
           }
-          return ret.reshape(shape);
+          return ret;
         });
 
-  m.def("store", [](py::array_t<uint64_t> ptrs, py::array values,
-                    py::array_t<bool> mask) {
-    int numel = ptrs.size();
-    py::array_t<uint64_t> reshaped_ptrs = ptrs.reshape({numel});
-    py::array_t<int8_t> reshaped_masks = mask.reshape({numel});
-    py::array reshaped_values = values.reshape({numel});
-    for (size_t i = 0; i < ptrs.size(); ++i) {
-      if (reshaped_masks.at(i)) {
-        memcpy(reinterpret_cast<void *>(reshaped_ptrs.mutable_at(i)),
-               reshaped_values.data(i), values.dtype().itemsize());
+  m.def("store", [](contiguous_array_t<uint64_t> ptrs, py::array values,
+                    contiguous_array_t<bool> mask) {
+    size_t numel = ptrs.size();
+    py::array contiguousValues = py::array::ensure(values, py::array::c_style);
+    if (!contiguousValues || (size_t)mask.size() != numel ||
+        (size_t)contiguousValues.size() != numel)
+      throw py::value_error("expected one mask and value per pointer");
+    const uint64_t *ptrData = ptrs.data();
+    const bool *maskData = mask.data();
+    const char *valueData = static_cast<const char *>(contiguousValues.data());
+    size_t itemsize = contiguousValues.itemsize();
+    py::gil_scoped_release release;
+    for (size_t i = 0; i < numel;) {
+      if (!maskData[i]) {
+        i = getMaskedRunEnd(maskData, i, numel);
+        continue;
       }
+      size_t end = getContiguousRunEnd(ptrData, maskData, i, numel, itemsize);
+      copyElements(reinterpret_cast<void *>(ptrData[i]),
+                   valueData + i * itemsize, end - i, itemsize);
+      i = end;
     }
   });
+
+  m.def("atomic_rmw", [](const std::string &opName,
+                         contiguous_array_t<uint64_t> ptrs, py::array values,
+                         contiguous_array_t<bool> mask) -> py::array {
+    RMWOp op = getRMWOp(opName);
+    size_t numel = ptrs.size();
+    py::array contiguousValues = py::array::ensure(values, py::array::c_style);
+    if (!contiguousValues || (size_t)mask.size() != numel ||
+        (size_t)contiguousValues.size() != numel)
+      throw py::value_error("expected one mask and value per pointer");
+    auto shape =
+        std::vector<ptrdiff_t>(ptrs.shape(), ptrs.shape() + ptrs.ndim());
+    py::array ret(contiguousValues.dtype(), shape);
+    const uint64_t *ptrData = ptrs.data();
+    const bool *maskData = mask.data();
+    const char *valueData = static_cast<const char *>(contiguousValues.data());
+    char *retData = static_cast<char *>(ret.mutable_data());
+    // masked-off elements return 0
+    memset(retData, 0, ret.nbytes());
+    dispatchElement(contiguousValues.dtype(), [&](auto element) {
+      using E = decltype(element);
+      if (!isSupported<typename E::Compute>(op))
+        throw py::type_error(
+            "atomic " + opName + " is not supported for " +
+            py::str(contiguousValues.dtype()).cast<std::string>());
+      py::gil_scoped_release release;
+      atomicRMW<E>(op, ptrData, valueData, maskData, retData, numel);
+    });
+    return ret;
+  });
+
+  m.def("atomic_cas", [](contiguous_array_t<uint64_t> ptrs, py::array cmp,
+                         py::array values) -> py::array {
+    size_t numel = ptrs.size();
+    py::array contiguousCmp = py::array::ensure(cmp, py::array::c_style);
+    py::array contiguousValues = py::array::ensure(values, py::array::c_style);
+    if (!contiguousCmp || !contiguousValues ||
+        (size_t)contiguousCmp.size() != numel ||
+        (size_t)contiguousValues.size() != numel ||
+        contiguousCmp.itemsize() != contiguousValues.itemsize())
+      throw py::value_error("expected one comparand and value per pointer");
+    size_t itemsize = contiguousValues.itemsize();
+    if (itemsize != 2 && itemsize != 4 && itemsize != 8)
+      throw py::type_error(
+          "atomic_cas only supports 16, 32 and 64-bit elements");
+    auto shape =
+        std::vector<ptrdiff_t>(ptrs.shape(), ptrs.shape() + ptrs.ndim());
+    py::array ret(contiguousValues.dtype(), shape);
+    const uint64_t *ptrData = ptrs.data();
+    const char *cmpData = static_cast<const char *>(contiguousCmp.data());
+    const char *valueData = static_cast<const char *>(contiguousValues.data());
+    char *retData = static_cast<char *>(ret.mutable_data());
+    py::gil_scoped_release release;
+    // the exchange compares bits, whatever the type
+    switch (itemsize) {
+    case 2:
+      atomicCAS<uint16_t>(ptrData, cmpData, valueData, retData, numel);
+      break;
+    case 4:
+      atomicCAS<uint32_t>(ptrData, cmpData, valueData, retData, numel);
+      break;
+    case 8:
+      atomicCAS<uint64_t>(ptrData, cmpData, valueData, retData, numel);
+      break;
+    }
+    return ret;
+  });
+
+  // Matrix product of `a` and `b` added to `acc`, with the products
+  // accumulated in the precision of `acc` (at least fp32 for floats), like a
+  // dot on the GPU accumulates fp16 products in fp32.
+  m.def("dot", [](py::array a, py::array b, py::array acc) -> py::array {
+    if (a.ndim() != 2 || b.ndim() != 2 || acc.ndim() != 2 ||
+        a.shape(1) != b.shape(0) || acc.shape(0) != a.shape(0) ||
+        acc.shape(1) != b.shape(1))
+      throw py::value_error("expected a [M, K], b [K, N] and acc [M, N]");
+    if (!a.dtype().equal(b.dtype()))
+      throw py::type_error("expected operands of the same dtype");
+    size_t M = a.shape(0), N = b.shape(1), K = a.shape(1);
+    py::array contiguousA = py::array::ensure(a, py::array::c_style);
+    py::array contiguousB = py::array::ensure(b, py::array::c_style);
+    py::array contiguousAcc = py::array::ensure(acc, py::array::c_style);
+    py::array ret(contiguousAcc.dtype(), {M, N});
+    const char *aData = static_cast<const char *>(contiguousA.data());
+    const char *bData = static_cast<const char *>(contiguousB.data());
+    const char *accData = static_cast<const char *>(contiguousAcc.data());
+    char *retData = static_cast<char *>(ret.mutable_data());
+    dispatchElement(contiguousAcc.dtype(), [&](auto accElement) {
+      using AccE = decltype(accElement);
+      // the accumulation type
+      using A = std::conditional_t<
+          std::is_floating_point_v<typename AccE::Compute>,
+          std::conditional_t<sizeof(typename AccE::Compute) < 8, float, double>,
+          typename AccE::Compute>;
+      dispatchElement(contiguousA.dtype(), [&](auto inElement) {
+        using InE = decltype(inElement);
+        py::gil_scoped_release release;
+        std::vector<A> aAcc = convertElements<InE, A>(aData, M * K);
+        std::vector<A> bAcc = convertElements<InE, A>(bData, K * N);
+        std::vector<A> out = convertElements<AccE, A>(accData, M * N);
+        dotAccumulate(aAcc.data(), bAcc.data(), out.data(), M, N, K);
+        using S = typename AccE::Storage;
+        for (size_t i = 0; i < M * N; ++i) {
+          S v = AccE::set(static_cast<typename AccE::Compute>(out[i]));
+          memcpy(retData + i * sizeof(S), &v, sizeof(S));
+        }
+      });
+    });
+    return ret;
+  });
+
+  // Loads the block of a block pointer without materializing its pointers.
+  // Elements out of the checked bounds are 0.
+  m.def("load_block",
+        [](uint64_t base, std::vector<int64_t> shape,
+           std::vector<int64_t> strides, std::vector<int64_t> offsets,
+           std::vector<int64_t> blockShape, std::vector<bool> boundaryCheck,
+           py::dtype dtype) -> py::array {
+          BlockDesc desc =
+              getBlockDesc(base, std::move(shape), std::move(strides),
+                           std::move(offsets), blockShape,
+                           std::move(boundaryCheck), dtype.itemsize());
+          py::array ret(dtype, std::vector<ptrdiff_t>(blockShape.begin(),
+                                                      blockShape.end()));
+          char *retData = static_cast<char *>(ret.mutable_data());
+          memset(retData, 0, ret.nbytes());
+          py::gil_scoped_release release;
+          copyBlock</*IsStore=*/false>(desc, retData);
+          return ret;
+        });
+
+  m.def("store_block", [](uint64_t base, std::vector<int64_t> shape,
+                          std::vector<int64_t> strides,
+                          std::vector<int64_t> offsets, py::array values,
+                          std::vector<bool> boundaryCheck) {
+    py::array contiguousValues = py::array::ensure(values, py::array::c_style);
+    if (!contiguousValues)
+      throw py::value_error("expected an array of values");
+    std::vector<int64_t> blockShape(contiguousValues.shape(),
+                                    contiguousValues.shape() +
+                                        contiguousValues.ndim());
+    BlockDesc desc = getBlockDesc(
+        base, std::move(shape), std::move(strides), std::move(offsets),
+        std::move(blockShape), std::move(boundaryCheck),
+        contiguousValues.itemsize());
+    // only read by a store
+    char *valueData = const_cast<char *>(
+        static_cast<const char *>(contiguousValues.data()));
+    py::gil_scoped_release release;
+    copyBlock</*IsStore=*/true>(desc, valueData);
+  });
 }
@@ -8,6 +8,7 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Parser/Parser.h"
 #include "mlir/Pass/Pass.h"
@@ -21,6 +22,12 @@
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/Triton/IR/Types.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <map>
+#include <mutex>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -125,6 +132,131 @@ static void outputWarning(mlir::Location loc, const std::string &msg) {
                /*stack_level=*/2);
 }
 
+// Appends the wall time of every pass execution to `reportPath`, one JSON
+// object per line.
+class PassTimingInstrumentation : public mlir::PassInstrumentation {
+public:
+  explicit PassTimingInstrumentation(std::string reportPath)
+      : reportPath(std::move(reportPath)) {}
+
+  void runBeforePass(mlir::Pass *pass, mlir::Operation *op) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    startTimes[{pass, op}] = std::chrono::steady_clock::now();
+  }
+
+  void runAfterPass(mlir::Pass *pass, mlir::Operation *op) override {
+    record(pass, op);
+  }
+
+  void runAfterPassFailed(mlir::Pass *pass, mlir::Operation *op) override {
+    record(pass, op);
+  }
+
+private:
+  void record(mlir::Pass *pass, mlir::Operation *op) {
+    auto end = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = startTimes.find({pass, op});
+    if (it == startTimes.end())
+      return;
+    double seconds = std::chrono::duration<double>(end - it->second).count();
+    startTimes.erase(it);
+
+    std::error_code ec;
+    llvm::raw_fd_ostream os(reportPath, ec, llvm::sys::fs::OF_Append);
+    if (ec)
+      return;
+    os << "{\"pass\": \"" << pass->getName() << "\", \"argument\": \""
+       << pass->getArgument() << "\", \"op\": \"" << op->getName()
+       << "\", \"seconds\": " << llvm::format("%.9f", seconds) << "}\n";
+  }
+
+  std::string reportPath;
+  std::mutex mutex;
+  std::map<std::pair<mlir::Pass *, mlir::Operation *>,
+           std::chrono::steady_clock::time_point>
+      startTimes;
+};
+
+// Contexts reused between compilations, initialized once by `initialize`
+// (which loads the dialects of a backend) when they are created. An
+// MLIRContext cannot be cleared, so releasing one undoes what compilations
+// configure on it: the diagnostic handlers they registered and the threading
+// and diagnostic options `pass_manager.enable_debug` sets. Contexts live as
+// long as the pool, so IR still referencing them stays valid.
+class ContextPool {
+public:
+  explicit ContextPool(py::function initialize)
+      : initialize(std::move(initialize)) {}
+
+  mlir::MLIRContext *acquire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!available.empty()) {
+        mlir::MLIRContext *context = available.back();
+        available.pop_back();
+        return context;
+      }
+    }
+    auto context = std::make_unique<mlir::MLIRContext>();
+    initialize(py::cast(context.get(), py::return_value_policy::reference));
+    Entry entry;
+    entry.nextHandlerId = getNextHandlerId(*context);
+    entry.multithreading = context->isMultithreadingEnabled();
+    entry.printOpOnDiagnostic = context->shouldPrintOpOnDiagnostic();
+    entry.printStackTraceOnDiagnostic =
+        context->shouldPrintStackTraceOnDiagnostic();
+    mlir::MLIRContext *ptr = context.get();
+    entry.context = std::move(context);
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.try_emplace(ptr, std::move(entry));
+    return ptr;
+  }
+
+  void release(mlir::MLIRContext *context) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(context);
+    if (it == entries.end())
+      throw std::invalid_argument("context was not acquired from this pool");
+    Entry &entry = it->second;
+    // Handler ids are sequential, so the handlers registered since the
+    // context was last reset are the ones in [nextHandlerId, end).
+    mlir::DiagnosticEngine &diagEngine = context->getDiagEngine();
+    auto end = getNextHandlerId(*context);
+    for (auto id = entry.nextHandlerId; id < end; ++id)
+      diagEngine.eraseHandler(id);
+    entry.nextHandlerId = end;
+    if (context->isMultithreadingEnabled() != entry.multithreading)
+      context->enableMultithreading(entry.multithreading);
+    context->printOpOnDiagnostic(entry.printOpOnDiagnostic);
+    context->printStackTraceOnDiagnostic(entry.printStackTraceOnDiagnostic);
+    available.push_back(context);
+  }
+
+private:
+  struct Entry {
+    std::unique_ptr<mlir::MLIRContext> context;
+    mlir::DiagnosticEngine::HandlerID nextHandlerId = 0;
+    bool multithreading = true;
+    bool printOpOnDiagnostic = false;
+    bool printStackTraceOnDiagnostic = false;
+  };
+
+  static mlir::DiagnosticEngine::HandlerID
+  getNextHandlerId(mlir::MLIRContext &context) {
+    mlir::DiagnosticEngine &diagEngine = context.getDiagEngine();
+    auto id = diagEngine.registerHandler(
+        [](mlir::Diagnostic &) { return mlir::failure(); });
+    diagEngine.eraseHandler(id);
+    return id + 1;
+  }
+
+  py::function initialize;
+  std::mutex mutex;
+  std::map<mlir::MLIRContext *, Entry> entries;
+  std::vector<mlir::MLIRContext *> available;
+};
+
 /*****************************************************************************/
 /* Python bindings for triton::ir::ttgir                                     */
 /*****************************************************************************/
@@ -180,6 +312,18 @@ void init_triton_ir(py::module &&m) {
       .value("EVICT_LAST", mlir::triton::EvictionPolicy::EVICT_LAST)
       .export_values();
 
+  py::enum_<mlir::triton::CacheLevel>(m, "CACHE_LEVEL", py::module_local())
+      .value("L1", mlir::triton::CacheLevel::L1)
+      .value("L2", mlir::triton::CacheLevel::L2)
+      .export_values();
+
+  py::enum_<mlir::triton::ShuffleKind>(m, "SHUFFLE_KIND", py::module_local())
+      .value("IDX", mlir::triton::ShuffleKind::IDX)
+      .value("XOR", mlir::triton::ShuffleKind::XOR)
+      .value("UP", mlir::triton::ShuffleKind::UP)
+      .value("DOWN", mlir::triton::ShuffleKind::DOWN)
+      .export_values();
+
   py::enum_<mlir::triton::RMWOp>(m, "ATOMIC_OP", py::module_local())
       .value("ADD", mlir::triton::RMWOp::ADD)
       .value("FADD", mlir::triton::RMWOp::FADD)
@@ -190,7 +334,9 @@ void init_triton_ir(py::module &&m) {
       .value("MAX", mlir::triton::RMWOp::MAX)
       .value("MIN", mlir::triton::RMWOp::MIN)
       .value("UMIN", mlir::triton::RMWOp::UMIN)
-      .value("UMAX", mlir::triton::RMWOp::UMAX);
+      .value("UMAX", mlir::triton::RMWOp::UMAX)
+      .value("FMAX", mlir::triton::RMWOp::FMAX)
+      .value("FMIN", mlir::triton::RMWOp::FMIN);
 
   py::enum_<mlir::triton::RoundingMode>(m, "ROUNDING_MODE", py::module_local())
       .value("RTZ", mlir::triton::RoundingMode::RTZ)
@@ -203,6 +349,11 @@ void init_triton_ir(py::module &&m) {
   py::class_<mlir::MLIRContext>(m, "context", py::module_local())
       .def(py::init<>());
 
+  py::class_<ContextPool>(m, "context_pool", py::module_local())
+      .def(py::init<py::function>())
+      .def("acquire", &ContextPool::acquire, ret::reference)
+      .def("release", &ContextPool::release);
+
   m.def("load_dialects", [](mlir::MLIRContext &context) {
     mlir::DialectRegistry registry;
     registry.insert<
@@ -410,6 +561,21 @@ void init_triton_ir(py::module &&m) {
              self.print(os, printingFlags);
              return str;
            })
+      .def("write",
+           [](mlir::ModuleOp &self, const std::string &path) {
+             // printed as `str` does, without holding the whole text
+             std::error_code ec;
+             llvm::raw_fd_ostream os(path, ec);
+             if (ec)
+               throw std::runtime_error("cannot write " + path + ": " +
+                                        ec.message());
+             auto printingFlags = mlir::OpPrintingFlags();
+             printingFlags.enableDebugInfo();
+             self.print(os, printingFlags);
+           })
+      // Erases the operations of a module no stage reads anymore, which
+      // otherwise live as long as their (pooled) context.
+      .def("clear", [](mlir::ModuleOp &self) { self.getBody()->clear(); })
       .def("push_back",
            [](mlir::ModuleOp &self, mlir::triton::FuncOp &funcOp) -> void {
              self.push_back(funcOp);
@@ -431,6 +597,13 @@ void init_triton_ir(py::module &&m) {
              if (!ret)
                return py::none();
              return py::int_(ret.getInt());
+           })
+      .def("get_int_array_attr",
+           [](mlir::ModuleOp &self, std::string name) -> py::object {
+             auto ret = self->getAttrOfType<mlir::DenseI32ArrayAttr>(name);
+             if (!ret)
+               return py::none();
+             return py::cast(ret.asArrayRef().vec());
            });
 
   m.def("make_attr",
@@ -445,19 +618,62 @@ void init_triton_ir(py::module &&m) {
 
   m.def(
       "parse_mlir_module",
-      [](const std::string &inputFilename, mlir::MLIRContext &context) {
+      [](const std::string &inputFilename, mlir::MLIRContext &context,
+         bool stripLocations) {
         // parse module
         mlir::OwningOpRef<mlir::ModuleOp> module =
             mlir::parseSourceFile<mlir::ModuleOp>(inputFilename, &context);
         if (!module)
           throw std::runtime_error("Parse MLIR file failed.");
         // locations are incompatible with ptx < 7.5 !
-        module->walk([](mlir::Operation *op) {
-          op->setLoc(mlir::UnknownLoc::get(op->getContext()));
-        });
+        if (stripLocations)
+          module->walk([](mlir::Operation *op) {
+            op->setLoc(mlir::UnknownLoc::get(op->getContext()));
+          });
 
         return module->clone();
       },
+      py::arg("filename"), py::arg("context"),
+      py::arg("strip_locations") = true, ret::take_ownership);
+
+  m.def(
+      "merge_kernel_modules",
+      [](const std::vector<std::string> &sources,
+         const std::vector<std::vector<int32_t>> &grids,
+         mlir::MLIRContext &context) {
+        if (sources.size() != grids.size())
+          throw std::runtime_error("Expected one grid per module.");
+        mlir::OpBuilder builder(&context);
+        mlir::OwningOpRef<mlir::ModuleOp> merged =
+            mlir::ModuleOp::create(builder.getUnknownLoc());
+        for (auto [i, source] : llvm::enumerate(sources)) {
+          mlir::OwningOpRef<mlir::ModuleOp> module =
+              mlir::parseSourceString<mlir::ModuleOp>(source, &context);
+          if (!module)
+            throw std::runtime_error("Parse MLIR module failed.");
+          if (i == 0)
+            merged->getOperation()->setAttrs(
+                module->getOperation()->getAttrs());
+          // the same kernel may be fused more than once, so the symbols of
+          // each module are suffixed with its index
+          std::string suffix = "_k" + std::to_string(i);
+          for (auto func : module->getOps<mlir::triton::FuncOp>()) {
+            auto name = builder.getStringAttr(func.getName() + suffix);
+            if (mlir::failed(mlir::SymbolTable::replaceAllSymbolUses(
+                    func, name, *module)))
+              throw std::runtime_error("Renaming " + func.getName().str() +
+                                       " failed.");
+            mlir::SymbolTable::setSymbolName(func, name);
+            if (func.isPublic())
+              func->setAttr("tt.fusion_grid",
+                            builder.getDenseI32ArrayAttr(grids[i]));
+          }
+          merged->getBody()->getOperations().splice(
+              merged->getBody()->end(), module->getBody()->getOperations());
+        }
+        return merged->clone();
+      },
+      py::arg("sources"), py::arg("grids"), py::arg("context"),
       ret::take_ownership);
 
   py::class_<mlir::triton::FuncOp, mlir::OpState>(m, "function",
@@ -1269,6 +1485,13 @@ void init_triton_ir(py::module &&m) {
              self.create<mlir::triton::StoreOp>(ptrs, val, mask, cacheModifier,
                                                 evictionPolicy);
            })
+      .def("create_prefetch",
+           [](TritonOpBuilder &self, mlir::Value &ptr,
+              std::optional<mlir::Value> &mask,
+              mlir::triton::CacheLevel cacheLevel) -> void {
+             self.create<mlir::triton::PrefetchOp>(
+                 ptr, mask.value_or(mlir::Value()), cacheLevel);
+           })
       .def("create_reshape",
            [](TritonOpBuilder &self, mlir::Value &arg,
               std::vector<int64_t> &shape, bool allowReorder) -> mlir::Value {
@@ -1412,6 +1635,15 @@ void init_triton_ir(py::module &&m) {
                  self.getBuilder().getI32Type(),
                  self.getBuilder().getI32IntegerAttr(axis));
            })
+      .def("create_global_scratch_alloc",
+           [](TritonOpBuilder &self, int nbytes,
+              int alignment) -> mlir::Value {
+             auto ptrType = mlir::triton::PointerType::get(
+                 self.getBuilder().getI8Type(), 1);
+             return self.create<mlir::triton::GlobalScratchAllocOp>(
+                 ptrType, self.getBuilder().getI32IntegerAttr(nbytes),
+                 self.getBuilder().getI32IntegerAttr(alignment));
+           })
       .def("create_dot",
            [](TritonOpBuilder &self, mlir::Value &a, mlir::Value &b,
               mlir::Value &c, bool allowTF32,
@@ -1419,6 +1651,14 @@ void init_triton_ir(py::module &&m) {
              return self.create<mlir::triton::DotOp>(
                  c.getType(), a, b, c, allowTF32, maxNumImpreciseAcc);
            })
+      .def("create_dot_scaled",
+           [](TritonOpBuilder &self, mlir::Value &a, mlir::Value &aScale,
+              mlir::Value &b, mlir::Value &bScale, mlir::Value &c,
+              bool allowTF32, int maxNumImpreciseAcc) -> mlir::Value {
+             return self.create<mlir::triton::DotScaledOp>(
+                 c.getType(), a, b, c, aScale, bScale, allowTF32,
+                 maxNumImpreciseAcc);
+           })
       .def("create_exp",
            [](TritonOpBuilder &self, mlir::Value &val) -> mlir::Value {
              return self.create<mlir::math::ExpOp>(val);
@@ -1473,6 +1713,44 @@ void init_triton_ir(py::module &&m) {
              }
              return self.create<mlir::triton::ScanReturnOp>(return_values);
            })
+      .def("create_gather",
+           [](TritonOpBuilder &self, mlir::Value src, mlir::Value indices,
+              int axis) -> mlir::Value {
+             auto indicesType = indices.getType().cast<mlir::RankedTensorType>();
+             auto srcType = src.getType().cast<mlir::RankedTensorType>();
+             auto resultType = mlir::RankedTensorType::get(
+                 indicesType.getShape(), srcType.getElementType());
+             return self.create<mlir::triton::GatherOp>(resultType, src,
+                                                        indices, axis);
+           })
+      .def("create_warp_shuffle",
+           [](TritonOpBuilder &self, mlir::Value src, mlir::Value lane,
+              mlir::triton::ShuffleKind kind) -> mlir::Value {
+             return self.create<mlir::triton::WarpShuffleOp>(src.getType(),
+                                                             src, lane, kind);
+           })
+      .def("create_warp_ballot",
+           [](TritonOpBuilder &self, mlir::Value pred) -> mlir::Value {
+             auto predType = pred.getType().cast<mlir::RankedTensorType>();
+             auto resultType = mlir::RankedTensorType::get(
+                 predType.getShape(), self.getBuilder().getI32Type(),
+                 predType.getEncoding());
+             return self.create<mlir::triton::WarpBallotOp>(resultType, pred);
+           })
+      .def("create_warp_reduce",
+           [](TritonOpBuilder &self, mlir::Value src) -> mlir::OpState {
+             return self.create<mlir::triton::WarpReduceOp>(src.getType(), src);
+           })
+      .def("create_warp_scan",
+           [](TritonOpBuilder &self, mlir::Value src) -> mlir::OpState {
+             return self.create<mlir::triton::WarpScanOp>(src.getType(), src);
+           })
+      .def("create_sort",
+           [](TritonOpBuilder &self, mlir::Value operand, int axis,
+              bool descending) -> mlir::Value {
+             return self.create<mlir::triton::SortOp>(operand, axis,
+                                                      descending);
+           })
       .def("create_ptr_to_int",
            [](TritonOpBuilder &self, mlir::Value &val,
               mlir::Type &type) -> mlir::Value {
@@ -1586,6 +1864,11 @@ void init_triton_ir(py::module &&m) {
                  /*printAfterOnlyOnChange=*/false,
                  /*printAfterOnlyOnFailure*/ true, llvm::dbgs(), printingFlags);
            })
+      .def("enable_timing",
+           [](mlir::PassManager &self, const std::string &reportPath) {
+             self.addInstrumentation(
+                 std::make_unique<PassTimingInstrumentation>(reportPath));
+           })
       .def("run", [](mlir::PassManager &self, mlir::ModuleOp &mod) {
         // TODO: maybe dump module to file and print error for better
         // diagnostics
@@ -1597,7 +1880,14 @@ void init_triton_ir(py::module &&m) {
           mlir::makeReproducer(anchorName, passes, op, reproducerPath);
         }
 
-        if (mlir::failed(self.run(mod.getOperation())))
+        mlir::LogicalResult result = mlir::failure();
+        {
+          // Passes do not touch Python objects, let other threads (e.g.
+          // parallel autotuning compilations) make progress.
+          py::gil_scoped_release allow_threads;
+          result = self.run(mod.getOperation());
+        }
+        if (mlir::failed(result))
           throw std::runtime_error("PassManager::run failed");
       });
 
@@ -0,0 +1,126 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace {
+
+// How the signature key of an argument follows from the annotation of its
+// parameter. Must be kept in sync with `KernelArg.signature_key`.
+enum class ArgKind : int { Value = 0, Tensor = 1, Bool = 2, Float = 3 };
+
+struct ParamInfo {
+  ArgKind kind;
+  bool isConstexpr;
+  bool doNotSpecialize;
+};
+
+// The type of a scalar or tensor argument, as `JITFunction._key_of` computes
+// it.
+py::object getTypeKey(py::handle value) {
+  if (py::hasattr(value, "dtype"))
+    return value.attr("dtype");
+  if (PyBool_Check(value.ptr()))
+    return py::str("i1");
+  if (PyLong_Check(value.ptr())) {
+    int overflow = 0;
+    long long v = PyLong_AsLongLongAndOverflow(value.ptr(), &overflow);
+    if (overflow == 0)
+      return py::str(INT32_MIN <= v && v <= INT32_MAX ? "i32" : "i64");
+    if (overflow > 0) {
+      // Values in [2**63, 2**64) are unsigned, larger ones still are i64.
+      PyLong_AsUnsignedLongLong(value.ptr());
+      if (!PyErr_Occurred())
+        return py::str("u64");
+      PyErr_Clear();
+    }
+    return py::str("i64");
+  }
+  if (PyFloat_Check(value.ptr()))
+    return py::str("fp32");
+  if (value.is_none())
+    return py::none();
+  throw py::type_error("Unsupported type " +
+                       py::str(py::type::of(value)).cast<std::string>() +
+                       " for " + py::str(value).cast<std::string>());
+}
+
+// Whether the integer `value` is divisible by `divisor`, for any size of
+// Python integer.
+bool isDivisible(py::handle value, int64_t divisor) {
+  int overflow = 0;
+  long long v = PyLong_AsLongLongAndOverflow(value.ptr(), &overflow);
+  if (overflow == 0)
+    return v % divisor == 0;
+  return value.attr("__mod__")(divisor).cast<int64_t>() == 0;
+}
+
+// The facts on an argument the kernel is specialized on, as
+// `KernelArg.specialization_key` computes them.
+py::tuple getSpecializationKey(py::handle value, int64_t divisibility,
+                               int64_t divisibility8) {
+  if (py::hasattr(value, "data_ptr")) {
+    uint64_t ptr = value.attr("data_ptr")().cast<uint64_t>();
+    return py::make_tuple(ptr % divisibility == 0);
+  }
+  // bool is a subclass of int, so we don't check explicitly above.
+  if (PyLong_Check(value.ptr())) {
+    int overflow = 0;
+    long long v = PyLong_AsLongLongAndOverflow(value.ptr(), &overflow);
+    return py::make_tuple(isDivisible(value, divisibility),
+                          isDivisible(value, divisibility8),
+                          overflow == 0 && v == 1);
+  }
+  return py::make_tuple(false);
+}
+
+} // namespace
+
+void init_triton_jit(py::module &&m) {
+  py::class_<ParamInfo>(m, "ParamInfo")
+      .def(py::init([](int kind, bool isConstexpr, bool doNotSpecialize) {
+        return ParamInfo{static_cast<ArgKind>(kind), isConstexpr,
+                         doNotSpecialize};
+      }));
+
+  // Computes the (signature, constexpr, specialization) keys a launch of a
+  // JIT function with arguments `values` is cached under.
+  m.def("get_cache_key",
+        [](py::sequence values, const std::vector<ParamInfo> &params,
+           int64_t divisibility, int64_t divisibility8) {
+          if (values.size() != params.size())
+            throw py::value_error("expected one value per parameter");
+          py::list sigKey, constexprKey, specKey;
+          for (size_t i = 0; i < params.size(); ++i) {
+            py::object value = values[i];
+            const ParamInfo &param = params[i];
+            if (param.isConstexpr) {
+              constexprKey.append(value);
+            } else {
+              switch (param.kind) {
+              case ArgKind::Tensor:
+                sigKey.append(value.attr("dtype"));
+                break;
+              case ArgKind::Bool:
+                sigKey.append(py::str("i1"));
+                break;
+              case ArgKind::Float:
+                sigKey.append(py::str("fp32"));
+                break;
+              case ArgKind::Value:
+                sigKey.append(getTypeKey(value));
+                break;
+              }
+            }
+            if (!param.doNotSpecialize)
+              specKey.append(
+                  getSpecializationKey(value, divisibility, divisibility8));
+          }
+          return py::make_tuple(py::tuple(sigKey), py::tuple(constexprKey),
+                                py::tuple(specKey));
+        });
+}
@@ -20,8 +20,11 @@
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
+#include <optional>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <shared_mutex>
+#include <stdexcept>
 
 namespace py = pybind11;
 
@@ -101,6 +104,19 @@ void findKernels(llvm::Module &M, std::set<llvm::Function *> &functions) {
       functions.insert(&function);
 }
 
+// Returns the SPIR-V binary of `module` together with the name of its kernel.
+std::pair<std::string, std::string>
+translateModuleToSPIRV(llvm::Module &module,
+                       const triton::SPIRVTranslationOptions &options) {
+  // Get name of kernel in the module
+  std::set<llvm::Function *> kernels;
+  findKernels(module, kernels);
+  assert(kernels.size() == 1);
+  std::string name = (*kernels.begin())->getName().str();
+  std::string spirvBitcode = triton::translateLLVMIRToSPIRV(module, options);
+  return {spirvBitcode, name};
+}
+
 void init_triton_llvm(py::module &&m) {
 
   py::class_<llvm::LLVMContext>(m, "context", py::module_local())
@@ -124,6 +140,15 @@ void init_triton_llvm(py::module &&m) {
             return os.str();
           },
           ret::take_ownership)
+      .def("write",
+           [](llvm::Module *self, const std::string &path) {
+             std::error_code ec;
+             llvm::raw_fd_ostream os(path, ec);
+             if (ec)
+               throw std::runtime_error("cannot write " + path + ": " +
+                                        ec.message());
+             os << *self;
+           })
       .def(
           "get_functions",
           [](llvm::Module *mod) -> llvm::Module::FunctionListType & {
@@ -158,70 +183,158 @@ void init_triton_llvm(py::module &&m) {
       },
       py::keep_alive<0, 2>());
 
-  m.def("optimize_module", [](llvm::Module *mod,
-                              const llvm::OptimizationLevel &opt) {
-    if (triton::tools::getBoolEnv("DISABLE_LLVM_OPT"))
-      return;
-    using namespace llvm;
-    LoopAnalysisManager lam;
-    FunctionAnalysisManager fam;
-    CGSCCAnalysisManager cgam;
-    ModuleAnalysisManager mam;
-    PipelineTuningOptions tuningOptions;
-    tuningOptions.LoopUnrolling = true;
-    tuningOptions.LoopInterleaving = true;
-    tuningOptions.LoopVectorization = true;
-    // SLPVectorizer causes test_core.py::test_dot_mulbroadcastred to fail.
-    // It vectorizes @llvm.fmuladd.f32 with @llvm.fmuladd.v32f32. We can
-    // consider to reenable SLP vectorization when the failure is investigated.
-    tuningOptions.SLPVectorization = false;
+  m.def(
+      "optimize_module",
+      [](llvm::Module *mod, const llvm::OptimizationLevel &opt,
+         bool slpVectorization, bool loopUnrolling,
+         std::optional<unsigned> unrollThreshold, const std::string &pipeline,
+         const std::string &targetTriple) {
+        if (triton::tools::getBoolEnv("DISABLE_LLVM_OPT"))
+          return;
+        py::gil_scoped_release allow_threads;
+        using namespace llvm;
+        LoopAnalysisManager lam;
+        FunctionAnalysisManager fam;
+        CGSCCAnalysisManager cgam;
+        ModuleAnalysisManager mam;
+        PipelineTuningOptions tuningOptions;
+        tuningOptions.LoopUnrolling = loopUnrolling;
+        tuningOptions.LoopInterleaving = true;
+        tuningOptions.LoopVectorization = true;
+        // SLPVectorizer causes test_core.py::test_dot_mulbroadcastred to fail.
+        // It vectorizes @llvm.fmuladd.f32 with @llvm.fmuladd.v32f32. We can
+        // consider to reenable SLP vectorization when the failure is
+        // investigated.
+        tuningOptions.SLPVectorization = slpVectorization;
 
-    PassBuilder pb(nullptr /*targetMachine*/, tuningOptions);
+        // Use the target's cost model when its backend is available.
+        std::unique_ptr<TargetMachine> machine;
+        if (!targetTriple.empty()) {
+          std::string error;
+          if (auto *target =
+                  TargetRegistry::lookupTarget(targetTriple, error))
+            machine.reset(target->createTargetMachine(
+                targetTriple, "", "", TargetOptions(), std::nullopt));
+        }
 
-    pb.registerModuleAnalyses(mam);
-    pb.registerCGSCCAnalyses(cgam);
-    pb.registerFunctionAnalyses(fam);
-    pb.registerLoopAnalyses(lam);
-    pb.crossRegisterProxies(lam, fam, cgam, mam);
+        PassBuilder pb(machine.get(), tuningOptions);
 
-    ModulePassManager mpm;
-    pb.registerVectorizerStartEPCallback(
-        [&](llvm::FunctionPassManager &fpm, llvm::OptimizationLevel level) {
-          // Triton generates large structure of scalars which may pessimise
-          // optimizations, we run a pass to break up phi of struct to make sure
-          // all the struct are removed for the following passes.
-          fpm.addPass(BreakStructPhiNodesPass());
-          fpm.addPass(InstCombinePass());
-        });
-    mpm.addPass(pb.buildPerModuleDefaultPipeline(opt));
-    mpm.run(*mod, mam);
-  });
+        pb.registerModuleAnalyses(mam);
+        pb.registerCGSCCAnalyses(cgam);
+        pb.registerFunctionAnalyses(fam);
+        pb.registerLoopAnalyses(lam);
+        pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+        ModulePassManager mpm;
+        if (!pipeline.empty()) {
+          if (auto err = pb.parsePassPipeline(mpm, pipeline))
+            throw std::invalid_argument(
+                "invalid LLVM pass pipeline: " + toString(std::move(err)));
+        } else {
+          pb.registerVectorizerStartEPCallback(
+              [&](llvm::FunctionPassManager &fpm,
+                  llvm::OptimizationLevel level) {
+                // Triton generates large structure of scalars which may
+                // pessimise optimizations, we run a pass to break up phi of
+                // struct to make sure all the struct are removed for the
+                // following passes.
+                fpm.addPass(BreakStructPhiNodesPass());
+                fpm.addPass(InstCombinePass());
+              });
+          mpm.addPass(pb.buildPerModuleDefaultPipeline(opt));
+        }
+
+        // The new pass manager's unroller only takes its thresholds from the
+        // command line options (LoopUnrollOptions has no threshold), so a
+        // pipeline overriding them runs alone, while the others share the
+        // lock for their whole run and never observe the override.
+        static std::shared_mutex unrollOptionsMutex;
+        if (!unrollThreshold) {
+          std::shared_lock<std::shared_mutex> lock(unrollOptionsMutex);
+          mpm.run(*mod, mam);
+          return;
+        }
+        std::unique_lock<std::shared_mutex> lock(unrollOptionsMutex);
+        auto &options = cl::getRegisteredOptions();
+        std::vector<std::pair<cl::opt<unsigned> *, unsigned>> saved;
+        for (const char *name :
+             {"unroll-threshold-default", "unroll-threshold-aggressive"}) {
+          auto *option =
+              static_cast<cl::opt<unsigned> *>(options.lookup(name));
+          if (option == nullptr)
+            continue;
+          saved.emplace_back(option, option->getValue());
+          option->setValue(*unrollThreshold);
+        }
+        mpm.run(*mod, mam);
+        for (auto &[option, value] : saved)
+          option->setValue(value);
+      },
+      py::arg("mod"), py::arg("opt"), py::arg("slp_vectorization") = false,
+      py::arg("loop_unrolling") = true,
+      py::arg("unroll_threshold") = py::none(), py::arg("pipeline") = "",
+      py::arg("target_triple") = "");
 
   m.def(
       "translate_to_spirv",
-      [](const std::string llvmIR) -> std::tuple<py::object, std::string> {
-        py::gil_scoped_release allow_threads;
-        // create LLVM module from C++
-        llvm::LLVMContext context;
-        std::unique_ptr<llvm::MemoryBuffer> buffer =
-            llvm::MemoryBuffer::getMemBuffer(llvmIR.c_str());
-        llvm::SMDiagnostic error;
-        std::unique_ptr<llvm::Module> module =
-            llvm::parseIR(buffer->getMemBufferRef(), error, context);
-        if (!module) {
-          llvm::report_fatal_error(
-              "failed to parse IR: " + error.getMessage() +
-              "lineno: " + std::to_string(error.getLineNo()));
+      [](const std::string llvmIR,
+         std::optional<std::vector<std::string>> extensions,
+         std::vector<std::string> allowedIntrinsics, bool useLLVMBackend)
+          -> std::tuple<py::object, std::string> {
+        triton::SPIRVTranslationOptions options;
+        options.extensions = std::move(extensions);
+        options.allowedIntrinsics = std::move(allowedIntrinsics);
+        options.useLLVMBackend = useLLVMBackend;
+        std::string name;
+        std::string spirvBitcode;
+        {
+          py::gil_scoped_release allow_threads;
+          // create LLVM module from C++
+          llvm::LLVMContext context;
+          std::unique_ptr<llvm::MemoryBuffer> buffer =
+              llvm::MemoryBuffer::getMemBuffer(llvmIR.c_str());
+          llvm::SMDiagnostic error;
+          std::unique_ptr<llvm::Module> module =
+              llvm::parseIR(buffer->getMemBufferRef(), error, context);
+          if (!module) {
+            llvm::report_fatal_error(
+                "failed to parse IR: " + error.getMessage() +
+                "lineno: " + std::to_string(error.getLineNo()));
+          }
+          std::tie(spirvBitcode, name) =
+              translateModuleToSPIRV(*module, options);
         }
-        // Get name of kernel in the module
-        std::set<llvm::Function *> kernels;
-        findKernels(*module, kernels);
-        assert(kernels.size() == 1);
-        std::string name = (*kernels.begin())->getName().str();
-        std::string spirvBitcode = triton::translateLLVMIRToSPIRV(*module);
         return std::make_tuple(py::bytes(spirvBitcode), name);
       },
-      ret::take_ownership);
+      py::arg("llvmIR"), py::arg("extensions") = py::none(),
+      py::arg("allowed_intrinsics") = std::vector<std::string>{
+          "llvm.genx.GenISA."},
+      py::arg("use_llvm_backend") = false, ret::take_ownership);
+
+  // Same as `translate_to_spirv`, but works on the in-memory module produced
+  // by the previous stage instead of re-parsing its textual form. Note that
+  // the translation may modify the module.
+  m.def(
+      "translate_module_to_spirv",
+      [](llvm::Module *mod, std::optional<std::vector<std::string>> extensions,
+         std::vector<std::string> allowedIntrinsics, bool useLLVMBackend)
+          -> std::tuple<py::object, std::string> {
+        triton::SPIRVTranslationOptions options;
+        options.extensions = std::move(extensions);
+        options.allowedIntrinsics = std::move(allowedIntrinsics);
+        options.useLLVMBackend = useLLVMBackend;
+        std::string name;
+        std::string spirvBitcode;
+        {
+          py::gil_scoped_release allow_threads;
+          std::tie(spirvBitcode, name) = translateModuleToSPIRV(*mod, options);
+        }
+        return std::make_tuple(py::bytes(spirvBitcode), name);
+      },
+      py::arg("mod"), py::arg("extensions") = py::none(),
+      py::arg("allowed_intrinsics") = std::vector<std::string>{
+          "llvm.genx.GenISA."},
+      py::arg("use_llvm_backend") = false, ret::take_ownership);
 
   m.def(
       "translate_to_asm",
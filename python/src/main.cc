@@ -36,15 +36,23 @@ void init_triton_env_vars(pybind11::module &m);
 void init_triton_ir(pybind11::module &&m);
 void init_triton_llvm(pybind11::module &&m);
 void init_triton_interpreter(pybind11::module &&m);
+void init_triton_jit(pybind11::module &&m);
 void init_triton_passes(pybind11::module &&m);
 FOR_EACH_P(DECLARE_BACKEND, TRITON_BACKENDS_TUPLE)
 
+namespace triton {
+// Defined in the source generated by cmake/TritonBuildKey.cmake
+const char *getBuildKey();
+} // namespace triton
+
 PYBIND11_MODULE(libtriton, m) {
   m.doc() = "Python bindings to the C++ Triton API";
+  m.attr("build_key") = triton::getBuildKey();
   init_triton_env_vars(m);
   init_triton_ir(m.def_submodule("ir"));
   init_triton_passes(m.def_submodule("passes"));
   init_triton_interpreter(m.def_submodule("interpreter"));
+  init_triton_jit(m.def_submodule("jit"));
   init_triton_llvm(m.def_submodule("llvm"));
   FOR_EACH_P(INIT_BACKEND, TRITON_BACKENDS_TUPLE)
 }
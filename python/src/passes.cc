@@ -16,7 +16,16 @@ namespace py = pybind11;
 
 void init_triton_analysis(py::module &&m) {
   py::class_<mlir::ModuleAllocation>(m, "allocation", py::module_local())
-      .def(py::init<mlir::ModuleOp>());
+      .def(py::init<mlir::ModuleOp>())
+      .def("get_shared_memory_report",
+           [](mlir::ModuleAllocation &self, size_t sharedMemoryPerCore,
+              unsigned maxWarpsPerCore) {
+             std::string report;
+             llvm::raw_string_ostream os(report);
+             mlir::printSharedMemoryReport(self, sharedMemoryPerCore,
+                                           maxWarpsPerCore, os);
+             return os.str();
+           });
   py::class_<mlir::ModuleMembarAnalysis>(m, "membar", py::module_local())
       .def(py::init<mlir::ModuleAllocation *>())
       .def("run", &mlir::ModuleMembarAnalysis::run);
@@ -38,6 +47,17 @@ void init_triton_passes_ttir(py::module &&m) {
   ADD_PASS_WRAPPER_0("add_reorder_broadcast", createReorderBroadcastPass);
   ADD_PASS_WRAPPER_0("add_rewrite_tensor_pointer",
                      createRewriteTensorPointerPass);
+  ADD_PASS_WRAPPER_1("add_split_k", createSplitKPass, int);
+  ADD_PASS_WRAPPER_1("add_loop_unroll", createLoopUnrollPass, int);
+  ADD_PASS_WRAPPER_0("add_int_range_optimize", createIntRangeOptimizePass);
+  ADD_PASS_WRAPPER_0("add_hoist_pointer_offsets",
+                     createHoistPointerOffsetsPass);
+  ADD_PASS_WRAPPER_0("add_hoist_invariant_loads",
+                     createHoistInvariantLoadsPass);
+  ADD_PASS_WRAPPER_0("add_specialize_calls", createSpecializeCallsPass);
+  ADD_PASS_WRAPPER_1("add_outline_cold_calls", createOutlineColdCallsPass,
+                     int);
+  ADD_PASS_WRAPPER_1("add_fuse_kernels", createFuseKernelsPass, std::string);
   ADD_PASS_WRAPPER_4("add_convert_to_ttgpuir",
                      createConvertTritonToTritonGPUPass, int, int, int, int);
 }
@@ -48,6 +68,7 @@ void init_triton_passes_ttgpuir(py::module &&m) {
   ADD_PASS_WRAPPER_0("add_optimize_thread_locality",
                      createOptimizeThreadLocalityPass);
   ADD_PASS_WRAPPER_4("add_pipeline", createPipelinePass, int, int, int, int);
+  ADD_PASS_WRAPPER_0("add_stream_pipeline", createStreamPipelinePass);
   ADD_PASS_WRAPPER_0("add_prefetch", createPrefetchPass);
   ADD_PASS_WRAPPER_1("add_accelerate_matmul", createAccelerateMatmulPass, int);
   ADD_PASS_WRAPPER_0("add_reorder_instructions", createReorderInstructionsPass);
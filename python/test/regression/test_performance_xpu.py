@@ -0,0 +1,276 @@
+"""
+Performance regression tests for Intel GPUs.
+
+The utilization (fraction of the peak the kernel reaches) of each benchmark is
+compared to the baseline stored for the current device in
+`xpu_performance_baselines.json`. Benchmarks without a baseline on the current
+device are skipped. Running with `TRITON_XPU_RECORD_BASELINES=1` stores the
+measured utilizations as the baselines of the current device instead.
+"""
+import json
+import os
+import re
+
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.language as tl
+import triton.ops
+from triton.testing import get_dram_gbps, get_max_tensorcore_tflops
+
+BASELINES_PATH = os.path.join(os.path.dirname(__file__), "xpu_performance_baselines.json")
+RECORD_BASELINES = os.getenv("TRITON_XPU_RECORD_BASELINES", "0") == "1"
+# a benchmark regresses when its utilization falls below its baseline by more
+# than the tolerance
+ATOL = 0.02
+RTOL = 0.05
+
+#######################
+# Utilities
+#######################
+
+
+def get_device_name():
+    # e.g. 'intel_r_data_center_gpu_max_1550'
+    return re.sub(r"[^a-z0-9]+", "_", torch.xpu.get_device_name().lower()).strip("_")
+
+
+DEVICE_NAME = get_device_name()
+
+
+def load_baselines():
+    if not os.path.exists(BASELINES_PATH):
+        return {}
+    with open(BASELINES_PATH) as f:
+        return json.load(f)
+
+
+def print_perf(cur_ms, cur_util, ref_util):
+    # print on the same line cur_ms, cur_util and ref_util with 3 decimal places
+    print(f'{cur_ms:.3f} ms \t cur: {cur_util:.3f} \t ref: {ref_util:.3f} \t dif={cur_util - ref_util:.3f}', end='\t')
+
+
+def check_perf(benchmark, key, cur_ms, cur_util):
+    key = ",".join(str(k) for k in key)
+    baselines = load_baselines()
+    if RECORD_BASELINES:
+        baselines.setdefault(DEVICE_NAME, {}).setdefault(benchmark, {})[key] = round(cur_util, 3)
+        with open(BASELINES_PATH, "w") as f:
+            json.dump(baselines, f, indent=2, sort_keys=True)
+            f.write("\n")
+        return
+    ref_util = baselines.get(DEVICE_NAME, {}).get(benchmark, {}).get(key)
+    if ref_util is None:
+        pytest.skip(f"no {benchmark} baseline for {key} on {DEVICE_NAME}")
+    print_perf(cur_ms, cur_util, ref_util)
+    assert cur_util >= ref_util - ATOL - RTOL * ref_util, \
+        f"{benchmark} {key} regressed: utilization {cur_util:.3f}, baseline {ref_util:.3f}"
+
+
+def bench(fn):
+    return triton.testing.do_bench(fn, device='xpu')
+
+
+#######################
+# Matrix Multiplication
+#######################
+
+matmul_shapes = [
+    # square
+    (512, 512, 512),
+    (1024, 1024, 1024),
+    (2048, 2048, 2048),
+    (4096, 4096, 4096),
+    # tall-skinny
+    (16, 4096, 4096),
+    (64, 4096, 4096),
+    (4096, 64, 4096),
+    # test EVEN_K==False
+    (4096, 4096, 4080),
+]
+
+
+@pytest.mark.parametrize('M, N, K', matmul_shapes)
+@pytest.mark.parametrize('dtype_str', ['float16', 'bfloat16', 'int8', 'float8e5'])
+def test_matmul(M, N, K, dtype_str):
+    torch.manual_seed(0)
+    if dtype_str == 'int8':
+        a = torch.randint(-128, 127, (M, K), dtype=torch.int8, device='xpu')
+        b = torch.randint(-128, 127, (N, K), dtype=torch.int8, device='xpu').t()
+        max_gpu_perf = get_max_tensorcore_tflops(torch.int8, clock_rate=None)
+    elif dtype_str == 'float8e5':
+        a = triton.reinterpret(torch.randint(0, 127, (M, K), dtype=torch.int8, device='xpu'), tl.float8e5)
+        b = triton.reinterpret(torch.randint(0, 127, (K, N), dtype=torch.int8, device='xpu'), tl.float8e5)
+        # fp8 dots run on the fp16 units
+        max_gpu_perf = get_max_tensorcore_tflops(torch.float16, clock_rate=None)
+    else:
+        dtype = getattr(torch, dtype_str)
+        a = torch.randn((M, K), dtype=dtype, device='xpu')
+        b = torch.randn((K, N), dtype=dtype, device='xpu')
+        max_gpu_perf = get_max_tensorcore_tflops(dtype, clock_rate=None)
+    fn = lambda: triton.ops.matmul(a, b)
+    ms = bench(fn)
+    cur_gpu_util = 2. * M * N * K / ms * 1e-9 / max_gpu_perf
+    check_perf('matmul', (M, N, K, dtype_str), ms, cur_gpu_util)
+
+
+#######################
+# Element-Wise
+#######################
+
+
+@triton.jit
+def _add(x_ptr, y_ptr, output_ptr, n_elements, BLOCK_SIZE: tl.constexpr):
+    pid = tl.program_id(axis=0)
+    block_start = pid * BLOCK_SIZE
+    offsets = block_start + tl.arange(0, BLOCK_SIZE)
+    mask = offsets < n_elements
+    x = tl.load(x_ptr + offsets, mask=mask)
+    y = tl.load(y_ptr + offsets, mask=mask)
+    output = x + y
+    tl.store(output_ptr + offsets, output, mask=mask)
+
+
+@pytest.mark.parametrize('N', [1024 * 16, 1024 * 256, 1024 * 16384, 1024 * 65536, 1020 * 100, 10003 * 7007])
+@pytest.mark.parametrize('dtype_str', ['float16', 'bfloat16', 'float32'])
+def test_elementwise(N, dtype_str):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype_str)
+    z = torch.empty((N, ), dtype=dtype, device='xpu')
+    x = torch.randn_like(z)
+    y = torch.randn_like(z)
+    grid = lambda args: (triton.cdiv(N, args['BLOCK_SIZE']), )
+    fn = lambda: _add[grid](x, y, z, N, BLOCK_SIZE=1024)
+    ms = bench(fn)
+    cur_gpu_util = 3. * N * z.element_size() / ms * 1e-6 / get_dram_gbps()
+    check_perf('elementwise', (N, dtype_str), ms, cur_gpu_util)
+
+
+#######################
+# Reduction
+#######################
+
+
+@triton.jit
+def _row_sum(x_ptr, output_ptr, n_cols, BLOCK_SIZE: tl.constexpr):
+    row = tl.program_id(axis=0)
+    offsets = tl.arange(0, BLOCK_SIZE)
+    x = tl.load(x_ptr + row * n_cols + offsets, mask=offsets < n_cols, other=0.)
+    tl.store(output_ptr + row, tl.sum(x.to(tl.float32), axis=0))
+
+
+@pytest.mark.parametrize('M, N', [(4096, 1024), (16384, 4096), (65536, 256)])
+@pytest.mark.parametrize('dtype_str', ['float16', 'float32'])
+def test_reductions(M, N, dtype_str):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype_str)
+    x = torch.randn((M, N), dtype=dtype, device='xpu')
+    z = torch.empty((M, ), dtype=torch.float32, device='xpu')
+    fn = lambda: _row_sum[(M, )](x, z, N, BLOCK_SIZE=triton.next_power_of_2(N))
+    ms = bench(fn)
+    cur_gpu_util = x.numel() * x.element_size() / ms * 1e-6 / get_dram_gbps()
+    check_perf('reduction', (M, N, dtype_str), ms, cur_gpu_util)
+
+
+#######################
+# Softmax
+#######################
+
+
+@triton.jit
+def _softmax(output_ptr, input_ptr, n_cols, BLOCK_SIZE: tl.constexpr):
+    row = tl.program_id(axis=0)
+    offsets = tl.arange(0, BLOCK_SIZE)
+    mask = offsets < n_cols
+    x = tl.load(input_ptr + row * n_cols + offsets, mask=mask, other=-float('inf')).to(tl.float32)
+    x = x - tl.max(x, axis=0)
+    num = tl.exp(x)
+    output = num / tl.sum(num, axis=0)
+    tl.store(output_ptr + row * n_cols + offsets, output.to(output_ptr.dtype.element_ty), mask=mask)
+
+
+@pytest.mark.parametrize('M, N', [(4096, 256), (4096, 1024), (4096, 4096), (1823, 781)])
+@pytest.mark.parametrize('dtype_str', ['float16', 'bfloat16', 'float32'])
+def test_softmax(M, N, dtype_str):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype_str)
+    x = torch.randn((M, N), dtype=dtype, device='xpu')
+    y = torch.empty_like(x)
+    block_size = triton.next_power_of_2(N)
+    num_warps = 4 if block_size < 2048 else 8 if block_size < 4096 else 16
+    fn = lambda: _softmax[(M, )](y, x, N, BLOCK_SIZE=block_size, num_warps=num_warps)
+    ms = bench(fn)
+    cur_gpu_util = 2. * x.numel() * x.element_size() / ms * 1e-6 / get_dram_gbps()
+    check_perf('softmax', (M, N, dtype_str), ms, cur_gpu_util)
+
+
+#######################
+# Layer-Norm
+#######################
+
+
+@triton.jit
+def _layer_norm(X, Y, W, B, n_cols, eps, BLOCK_SIZE: tl.constexpr):
+    row = tl.program_id(axis=0)
+    cols = tl.arange(0, BLOCK_SIZE)
+    mask = cols < n_cols
+    x = tl.load(X + row * n_cols + cols, mask=mask, other=0.).to(tl.float32)
+    mean = tl.sum(x, axis=0) / n_cols
+    xbar = tl.where(mask, x - mean, 0.)
+    rstd = 1 / tl.sqrt(tl.sum(xbar * xbar, axis=0) / n_cols + eps)
+    w = tl.load(W + cols, mask=mask)
+    b = tl.load(B + cols, mask=mask)
+    y = xbar * rstd * w + b
+    tl.store(Y + row * n_cols + cols, y.to(Y.dtype.element_ty), mask=mask)
+
+
+@pytest.mark.parametrize('M, N', [(4096, 512), (4096, 1024), (4096, 4096), (4096, 8192)])
+@pytest.mark.parametrize('dtype_str', ['float16', 'bfloat16', 'float32'])
+def test_layer_norm(M, N, dtype_str):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype_str)
+    x = torch.randn((M, N), dtype=dtype, device='xpu')
+    w = torch.rand((N, ), dtype=dtype, device='xpu')
+    b = torch.rand((N, ), dtype=dtype, device='xpu')
+    y = torch.empty_like(x)
+    block_size = triton.next_power_of_2(N)
+    num_warps = min(max(block_size // 256, 1), 16)
+    fn = lambda: _layer_norm[(M, )](x, y, w, b, N, 1e-5, BLOCK_SIZE=block_size, num_warps=num_warps)
+    ms = bench(fn)
+    cur_gpu_util = 2. * x.numel() * x.element_size() / ms * 1e-6 / get_dram_gbps()
+    check_perf('layer_norm', (M, N, dtype_str), ms, cur_gpu_util)
+
+
+#######################
+# Flash-Attention
+#######################
+
+
+@pytest.mark.parametrize("dtype_str", ['float16', 'bfloat16'])
+@pytest.mark.parametrize("mode", ['forward', 'backward'])
+@pytest.mark.parametrize("causal", [True, False])
+@pytest.mark.parametrize("Z, H, N_CTX, D_HEAD", [[4, 48, 4096, 64]])
+def test_flash_attention(Z, H, N_CTX, D_HEAD, causal, mode, dtype_str):
+    is_backward = mode == 'backward'
+    torch.manual_seed(20)
+    dtype = getattr(torch, dtype_str)
+    q = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device="xpu").normal_(mean=0.1, std=0.2).requires_grad_()
+    k = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device="xpu").normal_(mean=0.4, std=0.2).requires_grad_()
+    v = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device="xpu").normal_(mean=0.3, std=0.2).requires_grad_()
+    sm_scale = 0.2
+    # benchmark
+    fn = lambda: triton.ops.attention(q, k, v, causal, sm_scale)
+    if is_backward:
+        o = fn()
+        do = torch.randn_like(o)
+        fn = lambda: o.backward(do, retain_graph=True)
+    ms = bench(fn)
+    # compute flops
+    flops_per_matmul = 2. * Z * H * N_CTX * N_CTX * D_HEAD * 0.5
+    total_flops = 2 * flops_per_matmul
+    if is_backward:
+        total_flops *= 2.5  # 2.0(bwd) + 0.5(recompute)
+    cur_gpu_util = total_flops / ms * 1e-9 / get_max_tensorcore_tflops(dtype, clock_rate=None)
+    check_perf('flash_attention', (Z, H, N_CTX, D_HEAD, causal, mode, dtype_str), ms, cur_gpu_util)
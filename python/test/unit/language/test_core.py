@@ -1195,6 +1195,115 @@ def test_atomic_rmw_predicate(num_ctas, device):
     assert x.item() == 63
 
 
+@pytest.mark.parametrize("dynamic", [False, True])
+def test_next_tile(dynamic, device):
+
+    @triton.jit
+    def kernel(X, counter, num_tiles, DYNAMIC: tl.constexpr):
+        tile = tl.program_id(0)
+        while tile < num_tiles:
+            tl.atomic_add(X + tile, 1)
+            if DYNAMIC:
+                tile = tl.next_tile(tile, counter)
+            else:
+                tile = tl.next_tile(tile)
+
+    num_tiles = 1000
+    x = torch.zeros((num_tiles, ), device=device, dtype=torch.int32)
+    counter = torch.zeros((1, ), device=device, dtype=torch.int32)
+    grid = triton.PersistentGrid(programs_per_core=2, num_tiles=lambda args: args["num_tiles"])
+    kernel[grid](x, counter, num_tiles, DYNAMIC=dynamic)
+    assert torch.all(x == 1)
+
+
+@pytest.mark.parametrize("dtype_str", ["int32", "float32"])
+def test_device_cumsum(dtype_str, device):
+
+    @triton.jit
+    def kernel(X, Z, counter, state, n, BLOCK: tl.constexpr):
+        tile = tl.atomic_add(counter, 1)
+        offsets = tile * BLOCK + tl.arange(0, BLOCK)
+        x = tl.load(X + offsets, mask=offsets < n, other=0)
+        tl.store(Z + offsets, tl.device_cumsum(x, tile, state), mask=offsets < n)
+
+    n, block = 1000003, 1024
+    num_tiles = triton.cdiv(n, block)
+    x = torch.randint(-8, 8, (n, ), device=device).to(getattr(torch, dtype_str))
+    z = torch.empty_like(x)
+    counter = torch.zeros((1, ), device=device, dtype=torch.int32)
+    state = torch.zeros((num_tiles, ), device=device, dtype=torch.int64)
+    kernel[(num_tiles, )](x, z, counter, state, n, BLOCK=block)
+    # small integers, so float sums are exact too
+    assert torch.equal(z, torch.cumsum(x, 0).to(x.dtype))
+
+
+def test_grid_sync(device):
+    if is_hip():
+        pytest.skip("cooperative launches are not supported on HIP")
+
+    @triton.jit
+    def kernel(X, Z, barrier, NUM_PROGRAMS: tl.constexpr):
+        pid = tl.program_id(0)
+        others = tl.arange(0, NUM_PROGRAMS)
+        tl.store(X + pid, pid + 1)
+        tl.grid_sync(barrier)
+        total = tl.sum(tl.load(X + others))
+        tl.grid_sync(barrier)
+        # every program reads the sums of the first phase before any is overwritten
+        tl.store(X + pid, total)
+        tl.grid_sync(barrier)
+        tl.store(Z + pid, tl.sum(tl.load(X + others)))
+
+    num_programs = 8
+    x = torch.zeros((num_programs, ), device=device, dtype=torch.int32)
+    z = torch.zeros((num_programs, ), device=device, dtype=torch.int32)
+    barrier = torch.zeros((2, ), device=device, dtype=torch.int32)
+    for _ in range(2):
+        kernel[(num_programs, )](x, z, barrier, NUM_PROGRAMS=num_programs, cooperative=True)
+    total = num_programs * (num_programs + 1) // 2
+    assert torch.all(z == num_programs * total)
+    # the barrier is ready for the next launch
+    assert barrier[0].item() == 0
+
+    compiled = kernel[(1, )](x, z, barrier, NUM_PROGRAMS=num_programs, cooperative=True)
+    with pytest.raises(triton.runtime.autotuner.OutOfResources):
+        compiled.check_cooperative_grid(compiled.max_cooperative_programs + 1, 1, 1)
+
+
+def test_global_scratch(device):
+    if is_hip():
+        pytest.skip("global scratch memory is not supported on HIP")
+
+    @triton.jit
+    def kernel(Z):
+        # the scratch memory is zero on the first launch and keeps its
+        # contents between launches
+        counter = tl.global_scratch(4).to(tl.pointer_type(tl.int32))
+        count = tl.load(counter)
+        tl.store(counter, count + 1)
+        tl.store(Z, count)
+
+    z = torch.full((1, ), -1, device=device, dtype=torch.int32)
+    for i in range(3):
+        compiled = kernel[(1, )](z)
+        assert z.item() == i
+    assert compiled.metadata.global_scratch_size == 4
+
+    @triton.jit
+    def sync_kernel(X, Z, NUM_PROGRAMS: tl.constexpr):
+        pid = tl.program_id(0)
+        tl.store(X + pid, pid + 1)
+        tl.grid_sync()
+        tl.store(Z + pid, tl.sum(tl.load(X + tl.arange(0, NUM_PROGRAMS))))
+
+    num_programs = 4
+    x = torch.zeros((num_programs, ), device=device, dtype=torch.int32)
+    z = torch.zeros((num_programs, ), device=device, dtype=torch.int32)
+    for _ in range(2):
+        sync_kernel[(num_programs, )](x, z, NUM_PROGRAMS=num_programs, cooperative=True)
+        assert torch.all(z == num_programs * (num_programs + 1) // 2)
+
+
 @pytest.mark.parametrize("shape, axis, num_ctas", [(shape, axis, num_ctas)
                                                    for shape in [(2, 2), (2, 8), (8, 2), (8, 8), (32, 32), (64, 64)]
                                                    for axis in [0, 1]
@@ -1668,6 +1777,28 @@ def test_reduce1d(op, dtype_str, shape, num_ctas, device):
             np.testing.assert_equal(z_ref, z_tri)
 
 
+@pytest.mark.parametrize("op", ["argmax", "argmin"])
+def test_arg_reduce_nan_and_zeros(op, device):
+
+    @triton.jit
+    def kernel(X, Z, BLOCK: tl.constexpr, OP: tl.constexpr):
+        x = tl.load(X + tl.arange(0, BLOCK))
+        if OP == "argmax":
+            tl.store(Z, tl.argmax(x, axis=0))
+        else:
+            tl.store(Z, tl.argmin(x, axis=0))
+
+    # both zeros are equal, so the first of them is the result
+    x = torch.tensor([-1.0, -0.0, 0.0, -2.0] if op == "argmax" else [1.0, 0.0, -0.0, 2.0], device=device)
+    z = torch.full((1, ), -1, dtype=torch.int32, device=device)
+    kernel[(1, )](x, z, BLOCK=4, OP=op)
+    assert z.item() == 1
+    # NaNs win, like in torch
+    x[2] = float("nan")
+    kernel[(1, )](x, z, BLOCK=4, OP=op)
+    assert z.item() == 2
+
+
 # TODO: [Qingyi] Fix argmin / argmax
 reduce_configs1 = [(op, dtype, (1, 1024), axis, False)
                    for dtype in dtypes_with_bfloat16
@@ -4445,6 +4576,97 @@ def test_fp8_dot_acc(in_type_str, low_precision_acc, device):
         torch.testing.assert_close(ref_out, C)
 
 
+# -----------------------
+# test block scaled dot
+# -----------------------
+
+
+@pytest.mark.parametrize("in_type_str", ['float16', 'float8e5'])
+@pytest.mark.parametrize("scale_type_str", ['float32', 'uint8'])
+def test_dot_scaled(in_type_str, scale_type_str, device):
+    if is_hip():
+        pytest.skip('test_dot_scaled for HIP currently broken in upstream.')
+    check_type_supported(in_type_str, device)
+
+    @triton.jit
+    def kernel(A, B, SA, SB, C, M: tl.constexpr, N: tl.constexpr, K: tl.constexpr, BLOCK_K: tl.constexpr):
+        offs_m = tl.arange(0, M)
+        offs_n = tl.arange(0, N)
+        offs_k = tl.arange(0, BLOCK_K)
+        acc = tl.zeros((M, N), dtype=tl.float32)
+        for k in range(0, K // BLOCK_K):
+            a = tl.load(A + offs_m[:, None] * K + (k * BLOCK_K + offs_k)[None, :])
+            b = tl.load(B + (k * BLOCK_K + offs_k)[:, None] * N + offs_n[None, :])
+            sa = tl.load(SA + offs_m * (K // BLOCK_K) + k)
+            sb = tl.load(SB + k * N + offs_n)
+            acc = tl.dot_scaled(a, sa, b, sb, acc)
+        tl.store(C + offs_m[:, None] * N + offs_n[None, :], acc)
+
+    M, N, K, BLOCK_K = 64, 64, 256, 64
+    A = numpy_random((M, K), dtype_str=in_type_str)
+    B = numpy_random((K, N), dtype_str=in_type_str)
+    a = to_triton(A, device=device, dst_type=in_type_str)
+    b = to_triton(B, device=device, dst_type=in_type_str)
+    if scale_type_str == 'uint8':
+        # E8M0 exponents of 2**-2 to 2**2.
+        sa = torch.randint(125, 130, (M, K // BLOCK_K), dtype=torch.uint8, device=device)
+        sb = torch.randint(125, 130, (K // BLOCK_K, N), dtype=torch.uint8, device=device)
+        sa_ref = torch.exp2(sa.to(torch.float32) - 127)
+        sb_ref = torch.exp2(sb.to(torch.float32) - 127)
+    else:
+        sa = torch.rand((M, K // BLOCK_K), dtype=torch.float32, device=device)
+        sb = torch.rand((K // BLOCK_K, N), dtype=torch.float32, device=device)
+        sa_ref, sb_ref = sa, sb
+    c = torch.empty((M, N), dtype=torch.float32, device=device)
+    kernel[(1, )](a, b, sa, sb, c, M, N, K, BLOCK_K, num_warps=4)
+
+    if in_type_str == 'float16':
+        th_a, th_b = a.to(torch.float32), b.to(torch.float32)
+    else:
+        th_a = f8_to_f16(torch.from_numpy(A).to(device), in_type_str).to(torch.float32)
+        th_b = f8_to_f16(torch.from_numpy(B).to(device), in_type_str).to(torch.float32)
+    ref_out = torch.zeros((M, N), dtype=torch.float32, device=device)
+    for k in range(K // BLOCK_K):
+        ks = slice(k * BLOCK_K, (k + 1) * BLOCK_K)
+        ref_out += torch.matmul(th_a[:, ks], th_b[ks, :]) * sa_ref[:, k, None] * sb_ref[None, k, :]
+    torch.testing.assert_close(ref_out, c, rtol=1e-2, atol=1e-2)
+
+
+# -----------------------
+# test batched dot
+# -----------------------
+
+
+@pytest.mark.parametrize("in_dtype_str, out_dtype_str", [('float16', 'float32'), ('float32', 'float32'),
+                                                         ('int8', 'int32')])
+def test_dot_batched(in_dtype_str, out_dtype_str, device):
+
+    @triton.jit
+    def kernel(X, Y, Z, BATCH: tl.constexpr, M: tl.constexpr, N: tl.constexpr, K: tl.constexpr):
+        offs_b = tl.arange(0, BATCH)[:, None, None]
+        offs_m = tl.arange(0, M)[None, :, None]
+        offs_n = tl.arange(0, N)[None, None, :]
+        offs_k = tl.arange(0, K)
+        x = tl.load(X + offs_b * M * K + offs_m * K + offs_k[None, None, :])
+        y = tl.load(Y + offs_b * K * N + offs_k[None, :, None] * N + offs_n)
+        z = tl.dot(x, y)
+        tl.store(Z + offs_b * M * N + offs_m * N + offs_n, z)
+
+    BATCH, M, N, K = 8, 16, 16, 16
+    rs = RandomState(17)
+    x = numpy_random((BATCH, M, K), dtype_str=in_dtype_str, rs=rs)
+    y = numpy_random((BATCH, K, N), dtype_str=in_dtype_str, rs=rs)
+    if in_dtype_str == 'int8':
+        # keep the reference exact
+        x, y = x % 8, y % 8
+    x_tri = to_triton(x, device=device)
+    y_tri = to_triton(y, device=device)
+    z_tri = to_triton(np.zeros((BATCH, M, N), dtype=getattr(np, out_dtype_str)), device=device)
+    kernel[(1, )](x_tri, y_tri, z_tri, BATCH, M, N, K, num_warps=4)
+    z_ref = np.matmul(x.astype(np.float32), y.astype(np.float32))
+    np.testing.assert_allclose(z_ref, to_numpy(z_tri).astype(np.float32), rtol=1e-2, atol=1e-2)
+
+
 # -----------------------
 # test enable_fp_fusion
 # -----------------------
@@ -4643,6 +4865,111 @@ def test_flip(M, N, dtype_str, device):
     assert (y == z).all(), (y, z)
 
 
+# -----------------------
+# test gather
+# -----------------------
+
+
+@pytest.mark.parametrize("M, N, K", [[16, 16, 64], [4, 256, 128], [32, 8, 8]])
+@pytest.mark.parametrize("dtype_str", ['int32', 'float16', 'float32'])
+def test_gather(M, N, K, dtype_str, device):
+
+    @triton.jit
+    def gather_kernel(X, I, Z, M: tl.constexpr, N: tl.constexpr, K: tl.constexpr):
+        rows = tl.arange(0, M)[:, None]
+        x = tl.load(X + rows * N + tl.arange(0, N)[None, :])
+        idx = tl.load(I + rows * K + tl.arange(0, K)[None, :])
+        z = tl.gather(x, idx, axis=1)
+        tl.store(Z + rows * K + tl.arange(0, K)[None, :], z)
+
+    x = torch.from_numpy(numpy_random((M, N), dtype_str=dtype_str)).to(device)
+    idx = torch.randint(0, N, (M, K), dtype=torch.int32, device=device)
+    z = torch.empty((M, K), dtype=x.dtype, device=device)
+    gather_kernel[(1, )](x, idx, z, M, N, K, num_warps=4)
+    assert (torch.gather(x, 1, idx.to(torch.int64)) == z).all()
+
+
+# -----------------------
+# test prefetch
+# -----------------------
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("cache_level", ["l1", "l2"])
+def test_prefetch(cache_level, device):
+
+    @triton.jit
+    def prefetch_kernel(X, Z, N, BLOCK: tl.constexpr, CACHE_LEVEL: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        tl.prefetch(X + offs, mask=offs < N, cache_level=CACHE_LEVEL)
+        block_ptr = tl.make_block_ptr(X, shape=(N, ), strides=(1, ), offsets=(BLOCK, ), block_shape=(BLOCK, ),
+                                      order=(0, ))
+        tl.prefetch(block_ptr, cache_level=CACHE_LEVEL)
+        x = tl.load(X + offs, mask=offs < N)
+        y = tl.load(block_ptr, boundary_check=(0, ))
+        tl.store(Z + offs, x + y, mask=offs < N)
+
+    N = 200
+    BLOCK = 128
+    x = torch.randn((2 * BLOCK, ), dtype=torch.float32, device=device)
+    z = torch.zeros((BLOCK, ), dtype=torch.float32, device=device)
+    prefetch_kernel[(1, )](x, z, N, BLOCK, cache_level)
+    y = torch.zeros_like(z)
+    y[:N - BLOCK] = x[BLOCK:N]
+    torch.testing.assert_close(z, x[:BLOCK] + y)
+
+
+# -----------------------
+# test warp collectives
+# -----------------------
+
+
+@pytest.mark.parametrize("dtype_str", ['int32', 'float32'])
+def test_warp_collectives(dtype_str, device):
+    if not (is_cuda() or is_xpu()):
+        pytest.skip("warp collectives are only lowered for NVIDIA and Intel GPUs")
+    warp_size = 16 if is_xpu() else 32
+    kwargs = {"threads_per_warp": warp_size} if is_xpu() else {}
+
+    @triton.jit
+    def _add(a, b):
+        return a + b
+
+    @triton.jit
+    def warp_kernel(X, Z, B, WARP_SIZE: tl.constexpr):
+        offs = tl.arange(0, WARP_SIZE)
+        x = tl.load(X + offs)
+        tl.store(Z + offs, tl.extra.warp.shuffle(x, WARP_SIZE - 1 - offs))
+        tl.store(Z + WARP_SIZE + offs, tl.extra.warp.shuffle_xor(x, 1))
+        tl.store(Z + 2 * WARP_SIZE + offs, tl.extra.warp.shuffle_up(x, 2))
+        tl.store(Z + 3 * WARP_SIZE + offs, tl.extra.warp.shuffle_down(x, 3))
+        tl.store(Z + 4 * WARP_SIZE + offs, tl.extra.warp.broadcast(x, 5))
+        tl.store(Z + 5 * WARP_SIZE + offs, tl.extra.warp.reduce(x, _add))
+        tl.store(Z + 6 * WARP_SIZE + offs, tl.extra.warp.scan(x, _add))
+        tl.store(B + offs, tl.extra.warp.ballot(x > 0))
+
+    x = torch.from_numpy(numpy_random((warp_size, ), dtype_str=dtype_str, low=-8, high=8)).to(device)
+    if dtype_str == 'float32':
+        # Keep the sums exact whatever order they are computed in.
+        x = torch.round(x)
+    z = torch.empty((7, warp_size), dtype=x.dtype, device=device)
+    b = torch.empty((warp_size, ), dtype=torch.int32, device=device)
+    warp_kernel[(1, )](x, z, b, warp_size, num_warps=1, **kwargs)
+
+    lanes = torch.arange(warp_size, device=device)
+    torch.testing.assert_close(z[0], x.flip(0))
+    torch.testing.assert_close(z[1], x[lanes ^ 1])
+    torch.testing.assert_close(z[2], torch.where(lanes >= 2, x[(lanes - 2).clamp(min=0)], x))
+    torch.testing.assert_close(z[3], torch.where(lanes + 3 < warp_size, x[(lanes + 3).clamp(max=warp_size - 1)], x))
+    torch.testing.assert_close(z[4], x[5].expand(warp_size))
+    torch.testing.assert_close(z[5], x.sum().expand(warp_size).to(x.dtype))
+    torch.testing.assert_close(z[6], x.cumsum(0).to(x.dtype))
+    ballot = sum(1 << i for i in range(warp_size) if x[i] > 0)
+    if ballot >= 1 << 31:
+        ballot -= 1 << 32
+    assert (b == ballot).all(), (b, ballot)
+
+
 # -----------------------
 # test iterators
 # -----------------------
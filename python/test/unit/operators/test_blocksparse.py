@@ -217,3 +217,29 @@ def triton_attention(
     w = sparse_softmax(w, scale=scale, is_causal=True)
     a = sparse_dot_dsd_nn(w, value)
     return a
+
+
+@pytest.mark.parametrize("H, M, N", [(1, 1, 1), (2, 8, 16), (3, 33, 1500)])
+@pytest.mark.parametrize("trans", [False, True])
+def test_lut_nonzero(H, M, N, trans, device):
+    torch.random.manual_seed(0)
+    layout = torch.randint(2, (H, M, N), device=device)
+    if trans:
+        layout = layout.transpose(1, 2)
+    ref = layout.nonzero(as_tuple=False).int()
+    tri = triton.ops.blocksparse.lut.nonzero(layout)
+    torch.testing.assert_close(ref, tri)
+
+
+def test_set_layout(device, Z=2, H=2, M=256, N=256, K=128, BLOCK=32):
+    torch.random.manual_seed(0)
+    layouts = [torch.randint(2, (H, M // BLOCK, N // BLOCK)) for _ in range(2)]
+    a = torch.randn((Z, H, M, K), dtype=torch.float16, device=device)
+    b = torch.randn((Z, H, K, N), dtype=torch.float16, device=device)
+    op = triton.ops.blocksparse.matmul(layouts[0], BLOCK, "sdd", device=device)
+    # layouts seen before reuse their look-up tables
+    for layout in layouts + layouts:
+        op.set_layout(layout)
+        ref = sparsify_tensor(torch.matmul(a.float(), b.float()), layout, BLOCK).half()
+        torch.testing.assert_close(ref, op(a, b), atol=1e-1, rtol=1e-2)
+    assert op.c_lut is triton.ops.blocksparse.matmul(layouts[1], BLOCK, "sdd", device=device).c_lut
@@ -0,0 +1,64 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+def _make_groups(world_size, nbytes, device):
+    # the ranks of a group on a single device, which reach each other's memory
+    # without mapping it
+    buffers = [torch.empty((nbytes, ), dtype=torch.uint8, device=device) for _ in range(world_size)]
+    signals = [
+        torch.zeros((triton.ops.PeerGroup.signal_size(world_size), ), dtype=torch.int32, device=device)
+        for _ in range(world_size)
+    ]
+    buffer_ptrs = [b.data_ptr() for b in buffers]
+    signal_ptrs = [s.data_ptr() for s in signals]
+    return [triton.ops.PeerGroup(rank, buffers[rank], signals[rank], buffer_ptrs, signal_ptrs) for rank in range(world_size)]
+
+
+def _run_ranks(op, inputs, groups, device):
+    # the launches of the ranks run at the same time on streams of their own
+    module = getattr(torch, device)
+    streams = [module.Stream() for _ in groups]
+    outs = []
+    for x, group, stream in zip(inputs, groups, streams):
+        stream.wait_stream(module.current_stream())
+        with module.stream(stream):
+            outs.append(op(x, group))
+    module.synchronize()
+    return outs
+
+
+@pytest.mark.parametrize('world_size', [1, 2])
+@pytest.mark.parametrize('n', [1000, 3000])
+@pytest.mark.parametrize('dtype', ['float16', 'float32'])
+def test_all_reduce(world_size, n, dtype, device):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype)
+    groups = _make_groups(world_size, 4 * n, device)
+    # the flags of the groups are reused by the following collectives
+    for _ in range(2):
+        inputs = [torch.randn((n, ), dtype=dtype, device=device) for _ in range(world_size)]
+        outs = _run_ranks(triton.ops.all_reduce, inputs, groups, device)
+        ref = torch.stack([x.float() for x in inputs]).sum(0).to(dtype)
+        for out in outs:
+            torch.testing.assert_close(out, ref, atol=1e-2, rtol=1e-2)
+
+
+@pytest.mark.parametrize('world_size', [1, 2])
+def test_all_gather(world_size, device):
+    groups = _make_groups(world_size, 4 * 2048, device)
+    inputs = [torch.full((3, 500), rank, dtype=torch.int32, device=device) for rank in range(world_size)]
+    # inputs already in the buffer of the group are not copied
+    staged = []
+    for x, group in zip(inputs, groups):
+        y = group.tensor(x.shape, x.dtype)
+        y.copy_(x)
+        staged.append(y)
+    outs = _run_ranks(triton.ops.all_gather, staged, groups, device)
+    ref = torch.stack(inputs)
+    for out in outs:
+        torch.testing.assert_close(out, ref, atol=0, rtol=0)
@@ -42,3 +42,30 @@ def test_op(M, N, dtype, mode, device):
             torch.testing.assert_close(th_dx, tt_dx, rtol=0.001, atol=0.001)
         else:
             torch.testing.assert_close(th_dx, tt_dx)
+
+
+@pytest.mark.parametrize("M, K, N, chunk_size", [  #
+    (M, K, N, chunk_size)
+    for M in [256, 301]
+    for K in [64, 256]
+    for N in [1000, 32000]
+    for chunk_size in [64, 1024]
+])
+def test_linear(M, K, N, chunk_size, device):
+    torch.manual_seed(0)
+    h = torch.randn(M, K, dtype=torch.float32, device=device, requires_grad=True)
+    w = torch.randn(N, K, dtype=torch.float32, device=device, requires_grad=True) / K**0.5
+    w = w.detach().requires_grad_()
+    idx = torch.randint(0, N, (M, ), dtype=torch.int64, device=device)
+    dy = torch.randn(M, dtype=torch.float32, device=device)
+    # triton
+    tt_y = triton.ops.linear_cross_entropy(h, w, idx, chunk_size)
+    tt_y.backward(dy)
+    tt_dh, tt_dw = h.grad.clone(), w.grad.clone()
+    # torch
+    h.grad, w.grad = None, None
+    th_y = torch.nn.CrossEntropyLoss(reduction="none")(torch.matmul(h, w.t()), idx)
+    th_y.backward(dy)
+    torch.testing.assert_close(th_y, tt_y)
+    torch.testing.assert_close(h.grad, tt_dh, rtol=1e-4, atol=1e-4)
+    torch.testing.assert_close(w.grad, tt_dw, rtol=1e-4, atol=1e-4)
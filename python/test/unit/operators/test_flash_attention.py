@@ -69,6 +69,59 @@ def test_op(Z, H, N_CTX, D_HEAD, dtype, causal, seq_par, device):
                                torch.nn.functional.normalize(torch.flatten(tri_dq), dim=0), atol=atol, rtol=0)
 
 
+@pytest.mark.parametrize('seqlens', [[(100, 100), (513, 513), (7, 7)], [(1, 300), (64, 1000), (200, 200)]])
+@pytest.mark.parametrize('H, D_HEAD', [(4, 64), (2, 128)])
+@pytest.mark.parametrize('causal, window_size', [(False, (-1, -1)), (True, (-1, -1)), (False, (128, 32)),
+                                                 (True, (300, -1))])
+@pytest.mark.parametrize('use_block_mask', [False, True])
+def test_varlen(seqlens, H, D_HEAD, causal, window_size, use_block_mask, device):
+    torch.manual_seed(20)
+    dtype = torch.float16
+    q_lens = [q_len for q_len, _ in seqlens]
+    k_lens = [k_len for _, k_len in seqlens]
+    cu_seqlens_q = torch.tensor([0] + q_lens, dtype=torch.int32).cumsum(0).to(torch.int32)
+    cu_seqlens_k = torch.tensor([0] + k_lens, dtype=torch.int32).cumsum(0).to(torch.int32)
+    q = torch.empty((sum(q_lens), H, D_HEAD), dtype=dtype, device=device).normal_(mean=0., std=0.5)
+    k = torch.empty((sum(k_lens), H, D_HEAD), dtype=dtype, device=device).normal_(mean=0., std=0.5)
+    v = torch.empty((sum(k_lens), H, D_HEAD), dtype=dtype, device=device).normal_(mean=0., std=0.5)
+    sm_scale = 0.5
+    block_mask = None
+    if use_block_mask:
+        num_m = triton.cdiv(max(q_lens), triton.ops.flash_attention.VARLEN_BLOCK_M)
+        num_n = triton.cdiv(max(k_lens), triton.ops.flash_attention.VARLEN_BLOCK_N)
+        block_mask = torch.rand((H, num_m, num_n)) < 0.7
+    # reference implementation
+    ref_out = torch.empty_like(q)
+    for i, (q_len, k_len) in enumerate(seqlens):
+        qi = q[cu_seqlens_q[i]:cu_seqlens_q[i + 1]].transpose(0, 1).float()
+        ki = k[cu_seqlens_k[i]:cu_seqlens_k[i + 1]].transpose(0, 1).float()
+        vi = v[cu_seqlens_k[i]:cu_seqlens_k[i + 1]].transpose(0, 1).float()
+        rows = torch.arange(q_len)[:, None] + k_len - q_len
+        cols = torch.arange(k_len)[None, :]
+        visible = torch.ones((q_len, k_len), dtype=torch.bool)
+        if causal:
+            visible &= cols <= rows
+        if window_size[0] >= 0:
+            visible &= cols >= rows - window_size[0]
+        if window_size[1] >= 0:
+            visible &= cols <= rows + window_size[1]
+        visible = visible[None].expand(H, q_len, k_len)
+        if use_block_mask:
+            visible = visible & block_mask.repeat_interleave(triton.ops.flash_attention.VARLEN_BLOCK_M, 1) \
+                .repeat_interleave(triton.ops.flash_attention.VARLEN_BLOCK_N, 2)[:, :q_len, :k_len]
+        p = torch.matmul(qi, ki.transpose(1, 2)) * sm_scale
+        p = p.masked_fill(~visible.to(device), float("-inf"))
+        # queries that see no key attend to nothing
+        p = torch.softmax(p, dim=-1).nan_to_num(0.)
+        ref_out[cu_seqlens_q[i]:cu_seqlens_q[i + 1]] = torch.matmul(p, vi).transpose(0, 1).to(dtype)
+    # triton implementation
+    tri_out = triton.ops.attention_varlen(q, k, v, cu_seqlens_q.to(device), cu_seqlens_k.to(device), max(q_lens),
+                                          sm_scale, causal=causal, window_size=window_size,
+                                          block_mask=block_mask.to(device) if use_block_mask else None)
+    # compare
+    torch.testing.assert_close(ref_out, tri_out, atol=1e-2, rtol=0)
+
+
 try:
     from flash_attn.flash_attn_interface import flash_attn_func
     HAS_FLASH = True
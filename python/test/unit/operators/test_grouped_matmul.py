@@ -0,0 +1,41 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+@pytest.mark.parametrize('counts, K, N', [  #
+    ([128, 64, 256, 32], 256, 512),
+    ([0, 17, 300, 1, 0, 45], 128, 96),
+    ([511], 64, 1024),
+])
+@pytest.mark.parametrize('dtype', [torch.float16, torch.float32])
+@pytest.mark.parametrize('use_gates', [False, True])
+@pytest.mark.parametrize('top_k', [None, 2])
+def test_op(counts, K, N, dtype, use_gates, top_k, device):
+    torch.manual_seed(0)
+    E, num_rows = len(counts), sum(counts)
+    a = torch.randn((num_rows, K), dtype=dtype, device=device)
+    w = torch.randn((E, K, N), dtype=dtype, device=device) / K**0.5
+    expert_counts = torch.tensor(counts, dtype=torch.int32, device=device)
+    gates = torch.rand((num_rows, ), dtype=dtype, device=device) if use_gates else None
+    scatter, num_tokens = None, None
+    if top_k is not None:
+        # each token is routed to top_k experts
+        num_tokens = triton.cdiv(num_rows, top_k)
+        scatter = torch.randperm(num_rows, device=device) % num_tokens
+    # reference implementation
+    starts = [sum(counts[:e]) for e in range(E)]
+    ref = torch.cat([torch.matmul(a[s:s + n].float(), w[e].float()) for e, (s, n) in enumerate(zip(starts, counts))])
+    if use_gates:
+        ref *= gates[:, None].float()
+    if top_k is not None:
+        ref = torch.zeros((num_tokens, N), device=device).index_add_(0, scatter, ref)
+    ref = ref.to(dtype)
+    # triton implementation
+    tri = triton.ops.grouped_matmul(a, w, expert_counts, gates=gates, scatter_indices=scatter,
+                                    num_out_rows=num_tokens)
+    atol = 1e-2 if dtype == torch.float16 else 1e-3
+    torch.testing.assert_close(ref, tri, atol=atol, rtol=atol)
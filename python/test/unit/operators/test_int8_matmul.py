@@ -0,0 +1,40 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+@pytest.mark.parametrize('M, N, K', [(1, 1024, 1024), (16, 512, 768), (128, 256, 512), (200, 300, 400)])
+@pytest.mark.parametrize('out_dtype', [torch.int8, torch.int32, torch.float16])
+@pytest.mark.parametrize('per_token', [False, True])
+def test_op(M, N, K, out_dtype, per_token, device):
+    if per_token and out_dtype == torch.int32:
+        pytest.skip("int32 outputs are not scaled")
+    torch.manual_seed(0)
+    a = torch.randint(-128, 128, (M, K), dtype=torch.int8, device=device)
+    b = torch.randint(-128, 128, (K, N), dtype=torch.int8, device=device)
+    # the int32 accumulator is exact
+    acc = torch.matmul(a.double(), b.double())
+    scale = scale_a = zero_point = None
+    if out_dtype == torch.int32:
+        ref = acc.to(torch.int32)
+    else:
+        # outputs spread over the int8 range, saturating at both ends
+        scale = torch.rand((N, ), device=device) * (256 / acc.abs().max().item())
+        ref = acc * scale.double()[None, :]
+        if per_token:
+            scale_a = torch.rand((M, ), device=device) + 0.5
+            ref = ref * scale_a.double()[:, None]
+        if out_dtype == torch.int8:
+            zero_point = torch.randint(-16, 16, (N, ), dtype=torch.int32, device=device)
+            ref = torch.clamp(torch.round(ref) + zero_point[None, :], -128, 127)
+        ref = ref.to(out_dtype)
+    tri = triton.ops.int8_matmul(a, b, scale=scale, zero_point=zero_point, scale_a=scale_a, out_dtype=out_dtype)
+    if out_dtype == torch.int8:
+        # products rounding the other way in float32
+        assert (tri.int() - ref.int()).abs().max().item() <= 1
+        assert (tri != ref).float().mean().item() < 1e-3
+    else:
+        torch.testing.assert_close(ref, tri, atol=0 if out_dtype == torch.int32 else 1e-2, rtol=1e-2)
@@ -0,0 +1,69 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+def _ref_norm(x, w, b, eps, is_rms):
+    x = x.float()
+    if is_rms:
+        y = x * torch.rsqrt(x.pow(2).mean(-1, keepdim=True) + eps) * w.float()
+    else:
+        y = torch.nn.functional.layer_norm(x, (x.shape[-1], ), w.float(), None, eps)
+    if b is not None:
+        y = y + b.float()
+    return y
+
+
+@pytest.mark.parametrize('M, N', [(1, 128), (1151, 1024), (64, 5120), (4, 8193)])
+@pytest.mark.parametrize('dtype', [torch.float16, torch.bfloat16, torch.float32])
+@pytest.mark.parametrize('is_rms', [False, True])
+@pytest.mark.parametrize('has_residual', [False, True])
+def test_op(M, N, dtype, is_rms, has_residual, device):
+    if N * torch.finfo(dtype).bits // 8 > 65536:
+        pytest.skip("rows of more than 64KB are not supported")
+    torch.manual_seed(0)
+    eps = 1e-5
+    x = (torch.randn((M, N), dtype=dtype, device=device) * 2 + 0.5).requires_grad_()
+    w = torch.rand((N, ), dtype=dtype, device=device).requires_grad_()
+    b = None if is_rms else torch.randn((N, ), dtype=dtype, device=device).requires_grad_()
+    res = torch.randn((M, N), dtype=dtype, device=device).requires_grad_() if has_residual else None
+    dy = torch.randn((M, N), dtype=dtype, device=device)
+    leaves = [t for t in (x, w, b, res) if t is not None]
+    # reference implementation
+    h = x + res if has_residual else x
+    ref_y = _ref_norm(h, w, b, eps, is_rms).to(dtype)
+    ref_y.backward(dy)
+    ref_grads = [t.grad.clone() for t in leaves]
+    for t in leaves:
+        t.grad = None
+    # triton implementation
+    if is_rms:
+        out = triton.ops.rms_norm(x, w, eps=eps, residual=res)
+    else:
+        out = triton.ops.layer_norm(x, w, b, eps=eps, residual=res)
+    tri_y = out[0] if has_residual else out
+    if has_residual:
+        torch.testing.assert_close(h, out[1])
+    tri_y.backward(dy)
+    tri_grads = [t.grad.clone() for t in leaves]
+    # compare
+    atol = {torch.float16: 1e-2, torch.bfloat16: 5e-2, torch.float32: 1e-4}[dtype]
+    torch.testing.assert_close(ref_y, tri_y, atol=atol, rtol=atol)
+    for ref, tri in zip(ref_grads, tri_grads):
+        # weight gradients sum over all the rows
+        torch.testing.assert_close(ref, tri, atol=atol * max(1, M**0.5), rtol=atol)
+
+
+@pytest.mark.parametrize('fp8_dtype', ['float8_e5m2', 'float8_e4m3fn'])
+def test_fp8_output(fp8_dtype, device, M=256, N=4096):
+    torch.manual_seed(0)
+    fp8_dtype = getattr(torch, fp8_dtype)
+    x = torch.randn((M, N), dtype=torch.float16, device=device)
+    w = torch.rand((N, ), dtype=torch.float16, device=device)
+    scale = 0.05
+    ref = (_ref_norm(x, w, None, 1e-6, True) / scale).to(fp8_dtype)
+    tri = triton.ops.rms_norm(x, w, out_dtype=fp8_dtype, out_scale=scale)
+    torch.testing.assert_close(ref.float(), tri.float(), atol=0, rtol=0.13)
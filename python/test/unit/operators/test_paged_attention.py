@@ -0,0 +1,51 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+@pytest.mark.parametrize('num_seqs, num_heads, num_kv_heads, head_dim', [  #
+    (3, 8, 8, 64),
+    (3, 8, 2, 64),
+    (5, 32, 8, 128),
+    (2, 16, 1, 128),
+])
+@pytest.mark.parametrize('page_size', [16, 64])
+@pytest.mark.parametrize('kv_dtype', ['float16', 'float8_e5m2'])
+@pytest.mark.parametrize('num_splits', [1, 4, None])
+def test_op(num_seqs, num_heads, num_kv_heads, head_dim, page_size, kv_dtype, num_splits, device):
+    torch.manual_seed(20)
+    dtype = torch.float16
+    seq_lens = torch.randint(1, 1000, (num_seqs, ), dtype=torch.int32)
+    max_pages = triton.cdiv(int(seq_lens.max()), page_size)
+    num_pages = num_seqs * max_pages
+    # pages are shuffled across sequences
+    block_tables = torch.randperm(num_pages, dtype=torch.int32).reshape(num_seqs, max_pages)
+    q = torch.empty((num_seqs, num_heads, head_dim), dtype=dtype, device=device).normal_(mean=0., std=0.5)
+    k_cache = torch.empty((num_pages, page_size, num_kv_heads, head_dim), dtype=dtype,
+                          device=device).normal_(mean=0., std=0.5)
+    v_cache = torch.empty_like(k_cache).normal_(mean=0., std=0.5)
+    k_scale, v_scale = 1.0, 1.0
+    if kv_dtype != 'float16':
+        k_scale, v_scale = 0.5, 2.0
+        k_cache = (k_cache / k_scale).to(getattr(torch, kv_dtype))
+        v_cache = (v_cache / v_scale).to(getattr(torch, kv_dtype))
+    sm_scale = head_dim**-0.5
+    # reference implementation
+    ref_out = torch.empty_like(q)
+    for i in range(num_seqs):
+        pages = block_tables[i, :triton.cdiv(int(seq_lens[i]), page_size)].long().to(device)
+        k = (k_cache[pages].to(dtype) * k_scale).reshape(-1, num_kv_heads, head_dim)[:seq_lens[i]]
+        v = (v_cache[pages].to(dtype) * v_scale).reshape(-1, num_kv_heads, head_dim)[:seq_lens[i]]
+        k = k.repeat_interleave(num_heads // num_kv_heads, dim=1)
+        v = v.repeat_interleave(num_heads // num_kv_heads, dim=1)
+        p = torch.einsum('hd,thd->ht', q[i].float(), k.float()) * sm_scale
+        p = torch.softmax(p, dim=-1)
+        ref_out[i] = torch.einsum('ht,thd->hd', p, v.float()).to(dtype)
+    # triton implementation
+    tri_out = triton.ops.paged_attention(q, k_cache, v_cache, block_tables.to(device), seq_lens.to(device), sm_scale,
+                                         k_scale=k_scale, v_scale=v_scale, num_splits=num_splits)
+    # compare
+    torch.testing.assert_close(ref_out, tri_out, atol=1e-2, rtol=0)
@@ -0,0 +1,39 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+@pytest.mark.parametrize('M, N, K', [(1, 4096, 4096), (7, 1024, 2048), (16, 512, 768), (128, 256, 512)])
+@pytest.mark.parametrize('qtype', ['int8', 'int4', 'float8_e5m2'])
+@pytest.mark.parametrize('group_size', [32, 64, 128])
+@pytest.mark.parametrize('dtype', [torch.float16, torch.bfloat16])
+def test_op(M, N, K, qtype, group_size, dtype, device):
+    torch.manual_seed(0)
+    a = torch.randn((M, K), dtype=dtype, device=device)
+    num_groups = K // group_size
+    scales = (torch.rand((num_groups, N), device=device) * 0.02 + 0.001).to(dtype)
+    zeros = None
+    if qtype == 'int8':
+        bits = 8
+        q = torch.randint(-128, 128, (K, N), dtype=torch.int8, device=device)
+        w = q.float()
+        qweight = q
+    elif qtype == 'int4':
+        bits = 4
+        q = torch.randint(0, 16, (K, N), dtype=torch.uint8, device=device)
+        zeros = torch.randint(0, 16, (num_groups, N), device=device).to(dtype)
+        w = q.float() - zeros.float().repeat_interleave(group_size, 0)
+        qweight = q[0::2] | (q[1::2] << 4)
+    else:
+        bits = 8
+        qweight = torch.randn((K, N), device=device).to(getattr(torch, qtype))
+        w = qweight.float()
+    # reference implementation
+    ref = torch.matmul(a.float(), w * scales.float().repeat_interleave(group_size, 0)).to(dtype)
+    # triton implementation
+    tri = triton.ops.quantized_matmul(a, qweight, scales, zeros=zeros, group_size=group_size, bits=bits)
+    atol = 1e-1 if dtype == torch.bfloat16 else 2e-2
+    torch.testing.assert_close(ref, tri, atol=atol, rtol=1e-2)
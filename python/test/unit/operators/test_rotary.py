@@ -0,0 +1,64 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+def _ref_rotary(x, pos, base, interleaved):
+    head_dim = x.shape[-1]
+    inv_freq = base**(-torch.arange(0, head_dim, 2, dtype=torch.float32, device=x.device) / head_dim)
+    theta = pos.float()[:, None] * inv_freq[None, :]
+    cos, sin = torch.cos(theta)[:, None, :], torch.sin(theta)[:, None, :]
+    x = x.float()
+    if interleaved:
+        x1, x2 = x[..., 0::2], x[..., 1::2]
+    else:
+        x1, x2 = x[..., :head_dim // 2], x[..., head_dim // 2:]
+    o1, o2 = x1 * cos - x2 * sin, x2 * cos + x1 * sin
+    if interleaved:
+        return torch.stack((o1, o2), dim=-1).flatten(-2)
+    return torch.cat((o1, o2), dim=-1)
+
+
+@pytest.mark.parametrize('num_tokens, num_heads, num_kv_heads, head_dim', [(4, 8, 8, 64), (7, 32, 8, 128)])
+@pytest.mark.parametrize('interleaved', [False, True])
+@pytest.mark.parametrize('use_tables', [False, True])
+@pytest.mark.parametrize('cache_dtype', ['float16', 'float8_e5m2'])
+def test_op(num_tokens, num_heads, num_kv_heads, head_dim, interleaved, use_tables, cache_dtype, device,
+            page_size=16, max_pages=8):
+    torch.manual_seed(0)
+    dtype = torch.float16
+    base = 10000.0
+    q = torch.randn((num_tokens, num_heads, head_dim), dtype=dtype, device=device)
+    k = torch.randn((num_tokens, num_kv_heads, head_dim), dtype=dtype, device=device)
+    v = torch.randn((num_tokens, num_kv_heads, head_dim), dtype=dtype, device=device)
+    # one new token per sequence
+    positions = torch.randint(0, page_size * max_pages, (num_tokens, ), dtype=torch.int32, device=device)
+    block_tables = torch.randperm(num_tokens * max_pages, dtype=torch.int32, device=device).view(num_tokens, -1)
+    cache_dtype = getattr(torch, cache_dtype)
+    k_cache = torch.zeros((num_tokens * max_pages, page_size, num_kv_heads, head_dim), dtype=cache_dtype,
+                          device=device)
+    v_cache = torch.zeros_like(k_cache)
+    k_scale, v_scale = (1.0, 1.0) if cache_dtype == torch.float16 else (0.5, 2.0)
+    cos, sin = None, None
+    if use_tables:
+        inv_freq = base**(-torch.arange(0, head_dim, 2, dtype=torch.float32, device=device) / head_dim)
+        theta = torch.arange(page_size * max_pages, device=device).float()[:, None] * inv_freq[None, :]
+        cos, sin = torch.cos(theta), torch.sin(theta)
+    # reference implementation
+    ref_q = _ref_rotary(q, positions, base, interleaved).to(dtype)
+    ref_k = _ref_rotary(k, positions, base, interleaved)
+    # triton implementation
+    tri_q = triton.ops.rotary_kv_append(q, k, v, positions, k_cache, v_cache, block_tables, cos=cos, sin=sin,
+                                        base=base, interleaved=interleaved, k_scale=k_scale, v_scale=v_scale)
+    # compare
+    torch.testing.assert_close(ref_q, tri_q, atol=2e-3, rtol=2e-3)
+    pages = block_tables[torch.arange(num_tokens, device=device), positions.long() // page_size].long()
+    slots = positions.long() % page_size
+    atol, rtol = (2e-3, 2e-3) if cache_dtype == torch.float16 else (0.2, 0.3)
+    torch.testing.assert_close((ref_k / k_scale).to(cache_dtype).float(), k_cache[pages, slots].float(), atol=atol,
+                               rtol=rtol)
+    torch.testing.assert_close((v.float() / v_scale).to(cache_dtype).float(), v_cache[pages, slots].float(),
+                               atol=atol, rtol=rtol)
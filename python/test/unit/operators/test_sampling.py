@@ -0,0 +1,38 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+def _ref_allowed(logits, top_k, top_p, temperature):
+    # the tokens of each row that top-k and top-p sampling may return
+    probs, order = torch.sort(torch.softmax(logits.float() / temperature, dim=-1), dim=-1, descending=True)
+    probs[:, top_k:] = 0
+    probs = probs / probs.sum(-1, keepdim=True)
+    keep = torch.cumsum(probs, -1) - probs < top_p
+    keep[:, top_k:] = False
+    return torch.zeros_like(keep).scatter(1, order, keep)
+
+
+@pytest.mark.parametrize('num_rows, vocab_size', [(4, 1000), (3, 32000), (2, 129280)])
+@pytest.mark.parametrize('top_k, top_p', [(1, 1.0), (50, 1.0), (50, 0.8), (0, 0.9)])
+@pytest.mark.parametrize('dtype', ['float16', 'float32'])
+def test_op(num_rows, vocab_size, top_k, top_p, dtype, device):
+    torch.manual_seed(0)
+    logits = torch.randn((num_rows, vocab_size), dtype=getattr(torch, dtype), device=device) * 4
+    allowed = _ref_allowed(logits, top_k or triton.ops.sampling.MAX_TOP_K, top_p, 0.7)
+    rows = torch.arange(num_rows, device=device)
+    for seed in range(8):
+        tokens = triton.ops.sample(logits, top_k=top_k, top_p=top_p, temperature=0.7, seed=seed)
+        assert tokens.dtype == torch.int32 and tokens.shape == (num_rows, )
+        assert allowed[rows, tokens.long()].all()
+
+
+@pytest.mark.parametrize('num_rows, vocab_size', [(5, 1000), (8, 50257)])
+def test_greedy(num_rows, vocab_size, device):
+    torch.manual_seed(0)
+    logits = torch.randn((num_rows, vocab_size), dtype=torch.float32, device=device)
+    tokens = triton.ops.sample(logits, temperature=0)
+    torch.testing.assert_close(tokens.long(), logits.argmax(-1), rtol=0, atol=0)
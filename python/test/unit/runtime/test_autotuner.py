@@ -80,3 +80,127 @@ def test_prune_configs(with_perf_model: bool):
         assert records['run_perf_model']
     else:
         assert records['run_early_config_prune']
+
+
+def test_cache_results(tmp_path, monkeypatch):
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path))
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    tuned = triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, cache_results=True)(_kernel)
+    tuned[grid](dst, src, N)
+    torch.testing.assert_close(src, dst)
+
+    # A new autotuner, as in another process, reuses the stored result.
+    reused = triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, cache_results=True)(_kernel)
+
+    def bench(*args, **kwargs):
+        raise AssertionError("the stored result should have been used")
+
+    monkeypatch.setattr(reused, "_bench", bench)
+    reused[grid](dst, src, N)
+    assert str(reused.best_config) == str(tuned.best_config)
+
+
+def test_successive_halving(monkeypatch):
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 11)]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=8, rep=8)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    # Larger blocks are faster, the three smallest ones are clearly slower.
+    budgets = []
+
+    def bench(*args, config, budget, **kwargs):
+        block = config.kwargs['BLOCK_SIZE']
+        budgets.append((block, budget))
+        t = 10.0 if block <= 128 else 1.0 + 1.0 / block
+        return [t, 0.9 * t, 1.1 * t]
+
+    monkeypatch.setattr(_kernel, "_bench", bench)
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(src, dst)
+    assert _kernel.best_config.kwargs['BLOCK_SIZE'] == 1024
+    # The clearly slower configs are dropped after the first round, and only the
+    # two fastest ones are timed with the full budget.
+    assert len([block for block, budget in budgets if budget == (2, 2)]) == 6
+    assert sorted(block for block, budget in budgets if budget == (4, 4)) == [256, 512, 1024]
+    assert sorted(block for block, budget in budgets if budget == (8, 8)) == [512, 1024]
+
+
+def test_screening(monkeypatch):
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 11)]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, screening=2)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    # At the screening level the largest block is the fastest, fully optimized
+    # the second largest one is.
+    timed = []
+
+    def bench(*args, config, budget, opt_level=3, **kwargs):
+        block = config.kwargs['BLOCK_SIZE']
+        timed.append((block, opt_level))
+        t = 1.0 / block if opt_level < 3 else abs(block - 512) + 1.0
+        return [t, t, t]
+
+    monkeypatch.setattr(_kernel, "_bench", bench)
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(src, dst)
+    assert _kernel.best_config.kwargs['BLOCK_SIZE'] == 512
+    assert {block for block, opt_level in timed if opt_level == 1} == {2**i for i in range(5, 11)}
+    assert {block for block, opt_level in timed if opt_level == 3} == {512, 1024}
+
+
+def test_key_buckets(monkeypatch):
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, key_buckets="pow2", reuse_nearest=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    tuned = []
+
+    def bench(*args, config, budget, **kwargs):
+        tuned.append(args[2])
+        return [1.0 / config.kwargs['BLOCK_SIZE']] * 3
+
+    monkeypatch.setattr(_kernel, "_bench", bench)
+    grid = lambda META: (triton.cdiv(META['N'], META['BLOCK_SIZE']), )
+    for N in [1000, 1024, 3000, 3000]:
+        src = torch.randn(N, device='xpu')
+        dst = torch.empty(N, device='xpu')
+        _kernel[grid](dst, src, N)
+        torch.testing.assert_close(src, dst)
+    # 1000 and 1024 share a bucket, 3000 first reuses its config and is tuned
+    # on the next call.
+    assert sorted(set(tuned)) == [1000, 3000]
+    assert set(_kernel.cache) == {(1024, 'torch.float32', 'torch.float32'), (4096, 'torch.float32', 'torch.float32')}
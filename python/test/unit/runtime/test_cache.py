@@ -136,6 +136,27 @@ def test_specialize(mode):
     assert counter == target
 
 
+def test_specialize_values(monkeypatch):
+
+    @triton.jit(specialize_values=["N"])
+    def kernel(X, N):
+        offs = tl.arange(0, 16)
+        tl.store(X + offs, N, mask=offs < N)
+
+    x = torch.zeros(16, dtype=torch.int32, device='xpu')
+    device = torch.xpu.current_device()
+    monkeypatch.setattr(JITFunction, "max_value_specializations", 2)
+    kernel[(1, )](x, 5)
+    kernel[(1, )](x, 3)
+    assert x[:6].tolist() == [3, 3, 3, 5, 5, 0]
+    kernel[(1, )](x, 5)
+    assert [key[-1] for key in kernel.cache[device]] == [(5, ), (3, )]
+    # the value used least recently is dropped first
+    kernel[(1, )](x, 7)
+    assert [key[-1] for key in kernel.cache[device]] == [(5, ), (7, )]
+    assert x[:7].tolist() == [7] * 7
+
+
 def test_annotation():
 
     @triton.jit
@@ -152,6 +173,25 @@ def test_annotation():
     assert len(kernel.cache[device]) == 4
 
 
+def test_cache_key_matches_kernel_args():
+    from triton._C.libtriton import jit as _jit
+    from triton.runtime.jit import KernelArg
+
+    @triton.jit(do_not_specialize=["d"])
+    def kernel(X, a, b: bool, c: float, d, E: tl.constexpr):
+        pass
+
+    x = torch.empty(3, dtype=torch.int32, device='xpu')
+    for a in [-16, 1, 8, 17, 2**31, 2**63, 2**64, -2**70, True, 1.5, None, x[1:]]:
+        values = (x, a, True, 2.0, 32, 4)
+        args = [KernelArg(value, param) for value, param in zip(values, kernel.params)]
+        sig_key = tuple(arg.signature_key() for arg in args if not arg.param.is_constexpr)
+        spec_key = tuple(arg.specialization_key() for arg in args if not arg.param.do_not_specialize)
+        constexpr_key = tuple(arg.value for arg in args if arg.param.is_constexpr)
+        assert _jit.get_cache_key(values, kernel._key_infos, JITFunction.divisibility,
+                                  JITFunction.divisibility_8) == (sig_key, constexpr_key, spec_key)
+
+
 def test_constexpr_not_callable() -> None:
 
     @triton.jit
@@ -173,6 +213,63 @@ def test_constexpr_not_callable() -> None:
     assert error is True
 
 
+def test_precompile_manifest(tmp_path):
+    path = tmp_path / "manifest.jsonl"
+    x = torch.empty(1, dtype=torch.int32, device='xpu')
+    device = torch.xpu.current_device()
+    kernel.cache[device].clear()
+    triton.record_manifest(str(path))
+    try:
+        kernel[(1, )](x, 17, BLOCK=128, num_warps=2)
+    finally:
+        triton.record_manifest(None)
+    keys = set(kernel.cache[device].keys())
+    assert len(keys) == 1
+
+    kernel.cache[device].clear()
+    compiled = triton.precompile(str(path))
+    assert len(compiled) == 1 and compiled[0] is not None
+    assert set(kernel.cache[device].keys()) == keys
+
+    counter = 0
+
+    def inc_counter(*args, **kwargs):
+        nonlocal counter
+        counter += 1
+
+    JITFunction.cache_hook = inc_counter
+    try:
+        kernel[(1, )](x, 17, BLOCK=128, num_warps=2)
+    finally:
+        JITFunction.cache_hook = None
+    assert counter == 0
+
+
+def test_pack_cache_manager(tmp_path, monkeypatch):
+    from triton.runtime import cache
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path))
+    monkeypatch.setenv("TRITON_CACHE_MANAGER", "triton.runtime.cache:PackCacheManager")
+    cache._packs.clear()
+    manager = cache.get_cache_manager("key")
+    group = {
+        "kernel.ttir": manager.put("module {}", "kernel.ttir"),
+        "kernel.spv": manager.put(b"\x03\x02\x23\x07", "kernel.spv"),
+    }
+    manager.put_group("kernel.json", group)
+
+    # another process only sees the files
+    cache._packs.clear()
+    manager = cache.get_cache_manager("key")
+    assert manager.get_group("kernel.json") == group
+    assert bytes(cache.read_cache_entry(group["kernel.spv"])) == b"\x03\x02\x23\x07"
+    assert bytes(manager.get_bytes("kernel.ttir")) == b"module {}"
+    with open(manager.get_file("kernel.ttir")) as f:
+        assert f.read() == "module {}"
+    assert not manager.has_file("kernel.llir")
+    assert not cache.get_cache_manager("other").has_file("kernel.ttir")
+    cache._packs.clear()
+
+
 def test_jit_warmup_cache() -> None:
 
     @triton.jit
@@ -196,6 +293,30 @@ def test_jit_warmup_cache() -> None:
     assert len(kernel_add.cache[device]) == 1
 
 
+def test_jit_async_compile() -> None:
+
+    @triton.jit(async_compile=True)
+    def kernel_add(a, b, o, N: tl.constexpr):
+        idx = tl.arange(0, N)
+        tl.store(o + idx, tl.load(a + idx) + tl.load(b + idx))
+
+    a, b = torch.randn(32, device="xpu"), torch.randn(32, device="xpu")
+    o = torch.empty_like(a)
+    device = torch.xpu.current_device()
+    kernel_add[(1, )](a, b, o, 32)
+    torch.testing.assert_close(o, a + b)
+    # the aligned tensors are specialized in the background, while the
+    # kernel compiled without divisibility hints runs
+    assert len(kernel_add.fallbacks[device]) == 1
+    for future, _ in list(kernel_add.pending[device].values()):
+        future.result()
+    assert len(kernel_add.cache[device]) == 1
+    o.zero_()
+    kernel_add[(1, )](a, b, o, 32)
+    torch.testing.assert_close(o, a + b)
+    assert not kernel_add.pending[device]
+
+
 def test_jit_debug() -> None:
 
     @triton.jit
@@ -247,6 +368,66 @@ def test_jit_noinline() -> None:
     assert inline_ttir != noinline_ttir
 
 
+def test_jit_restrict() -> None:
+
+    @triton.jit
+    def kernel_add(a: tl.restrict, b, o: tl.restrict, N: tl.constexpr):
+        idx = tl.arange(0, N)
+        tl.store(o + idx, tl.load(a + idx) + tl.load(b + idx))
+
+    kernel = kernel_add.warmup(torch.float32, torch.float32, torch.float32, 32, grid=(1, ))
+    assert kernel.asm["ttir"].count("tt.restrict") == 2
+    define = next(line for line in kernel.asm["llir"].splitlines() if line.startswith("define"))
+    assert define.count("noalias") == 2
+    assert define.count("align 16") == 3
+
+
+def test_streamed_ir(tmp_path, monkeypatch):
+    from triton.runtime import cache
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path))
+
+    # IR modules print themselves to the cache file
+    class Module:
+
+        def write(self, path):
+            with open(path, "w") as f:
+                f.write("module {}")
+
+    manager = cache.get_cache_manager("key")
+    with open(manager.put(Module(), "kernel.ttir")) as f:
+        assert f.read() == "module {}"
+
+    @triton.jit
+    def kernel(X):
+        tl.store(X, 1)
+
+    x = torch.empty(1, dtype=torch.int32, device='xpu')
+    compiled = kernel[(1, )](x)
+    assert "tt.func" in compiled.asm["ttir"]
+    assert "tt.func" in compiled.asm["ttgir"]
+    assert "define" in compiled.asm["llir"]
+    assert x.item() == 1
+
+
+def test_resumed_compile_keeps_every_stage(tmp_path, monkeypatch):
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path))
+
+    @triton.jit
+    def kernel(X):
+        tl.store(X, 1)
+
+    x = torch.empty(1, dtype=torch.int32, device='xpu')
+    first = kernel[(1, )](x, grf_mode="default")
+    # only the options of the spv stage differ, so the second compilation
+    # resumes from the cached llir
+    second = kernel[(1, )](x, grf_mode="large")
+    assert first.metadata.hash != second.metadata.hash
+    for ext in ("ttir", "ttgir", "llir", "spv"):
+        assert ext in second.asm
+    assert second.asm["ttgir"] == first.asm["ttgir"]
+    assert "tt.func" in second.asm["ttir"]
+
+
 def test_memory_leak() -> None:
 
     @triton.jit
@@ -258,3 +439,52 @@ def test_memory_leak() -> None:
         x0 = xindex
         tmp0 = tl.load(in_ptr0 + (x0), xmask)
         tl.store(out_ptr0 + (x0 + tl.zeros([XBLOCK], tl.int32)), tmp0, xmask)
+
+
+def test_context_pool_reuses_contexts() -> None:
+    from triton._C.libtriton import ir
+
+    initialized = []
+    pool = ir.context_pool(initialized.append)
+    first = pool.acquire()
+    second = pool.acquire()
+    assert first is not second
+    pool.release(first)
+    assert pool.acquire() is first
+    assert len(initialized) == 2
+    # a pass manager left in debug mode doesn't leak into the next compilation
+    pm = ir.pass_manager(second)
+    pm.enable_debug()
+    pool.release(second)
+    assert pool.acquire() is second
+    with pytest.raises(ValueError):
+        pool.release(ir.context())
+
+
+def test_compile_server(tmp_path, monkeypatch):
+    import threading
+    from triton.runtime.compile_server import CompileServer
+
+    @triton.jit
+    def kernel_add(a, b, o, N: tl.constexpr):
+        idx = tl.arange(0, N)
+        tl.store(o + idx, tl.load(a + idx) + tl.load(b + idx))
+
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path / "cache"))
+    server = CompileServer(str(tmp_path / "compile.sock"))
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+    monkeypatch.setenv("TRITON_COMPILE_SERVER", server.server_address)
+    a, b = torch.randn(32, device="xpu"), torch.randn(32, device="xpu")
+    o = torch.empty_like(a)
+    try:
+        kernel_add[(1, )](a, b, o, 32)
+        assert server.num_compiled == 1
+        assert torch.equal(o, a + b)
+    finally:
+        server.shutdown()
+        server.server_close()
+    # without a server, kernels are compiled locally
+    with pytest.warns(UserWarning, match="compiling locally"):
+        kernel_add[(1, )](a, b, o, 16)
+    assert server.num_compiled == 1
@@ -13,3 +13,76 @@ def test_is_lazy():
     assert triton.runtime.driver.active._obj is None
     utils = triton.runtime.driver.active.utils  # noqa: F841
     assert issubclass(triton.runtime.driver.active._obj.__class__, getattr(triton.backends.driver, "DriverBase"))
+
+
+def test_launcher_shared_across_signatures():
+    from triton.backends.intel.driver import make_launcher
+    ids = {"ids_of_tensormaps": None, "ids_of_folded_args": (), "ids_of_const_exprs": ()}
+    fp32 = make_launcher({}, {0: "*fp32", 1: "fp32", 2: "i32"}, ids)
+    fp16 = make_launcher({}, {0: "*fp16", 1: "fp16", 2: "i32"}, ids)
+    # a constexpr between the arguments does not change how they are passed
+    constexpr = make_launcher({1: 64}, {0: "*bf16", 2: "bf16", 3: "i32"}, ids)
+    assert fp32 == fp16 == constexpr
+    assert fp32 != make_launcher({}, {0: "*fp32", 1: "fp32", 2: "i64"}, ids)
+    assert fp32 != make_launcher({2: 1}, {0: "*fp32", 1: "fp32", 2: "i32"}, ids)
+
+
+def test_packed_kernel_args():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def strided_add(x_ptr, y_ptr, out_ptr, sx0, sx1, sy0, sy1, so0, so1, scale, BLOCK: tl.constexpr):
+        row = tl.program_id(0)
+        cols = tl.arange(0, BLOCK)
+        x = tl.load(x_ptr + row * sx0 + cols * sx1)
+        y = tl.load(y_ptr + row * sy0 + cols * sy1)
+        tl.store(out_ptr + row * so0 + cols * so1, x + y * scale)
+
+    x = torch.randn(16, 32, device='xpu')
+    y = torch.randn(32, 16, device='xpu').t()
+    out = torch.empty(16, 32, device='xpu')
+    # the strides of 1 are specialized away
+    kernel = strided_add[(16, )](x, y, out, *x.stride(), *y.stride(), *out.stride(), 0.5, BLOCK=32,
+                                 arg_packing_threshold=2)
+    assert len(kernel.metadata.packed_args) >= 2
+    torch.testing.assert_close(out, x + y * 0.5)
+
+
+def test_native_spirv_extensions():
+    from triton.backends.intel.compiler import get_xpu_target
+    # extensions the lowering emits on every arch: cache control decorations,
+    # sub-group block IO and shuffles, the GenISA inline assembly, bf16
+    # conversions, float atomics and the fast-math and no-wrap flags
+    emitted = {
+        "SPV_INTEL_cache_controls",
+        "SPV_INTEL_subgroups",
+        "SPV_INTEL_inline_assembly",
+        "SPV_INTEL_bfloat16_conversion",
+        "SPV_EXT_shader_atomic_float_add",
+        "SPV_EXT_shader_atomic_float_min_max",
+        "SPV_INTEL_fp_fast_math_mode",
+        "SPV_KHR_no_integer_wrap_decoration",
+    }
+    for arch in (0, 1):
+        assert emitted <= set(get_xpu_target(arch).spirv_extensions)
+    assert {"SPV_INTEL_2d_block_io", "SPV_INTEL_split_barrier"} <= set(get_xpu_target(1).spirv_extensions)
+    # unknown archs allow every extension
+    assert get_xpu_target(42).spirv_extensions is None
+
+
+def test_parse_options_spirv_extensions(monkeypatch):
+    from triton.backends.intel.compiler import XPUBackend, get_xpu_target
+    monkeypatch.delenv("TRITON_XPU_ALL_SPIRV_EXTENSIONS", raising=False)
+    for arch in (0, 1):
+        options = XPUBackend(("xpu", arch)).parse_options({})
+        assert options.spirv_extensions == get_xpu_target(arch).spirv_extensions
+        assert XPUBackend.spirv_options(options)["extensions"] == list(get_xpu_target(arch).spirv_extensions)
+    # 2D block IO is only lowered natively on PVC
+    assert "SPV_INTEL_2d_block_io" not in XPUBackend(("xpu", 0)).parse_options({}).spirv_extensions
+    assert XPUBackend(("xpu", 42)).parse_options({}).spirv_extensions is None
+    # an explicit list wins
+    explicit = ("SPV_INTEL_subgroups", )
+    assert XPUBackend(("xpu", 1)).parse_options({"spirv_extensions": explicit}).spirv_extensions == explicit
+    monkeypatch.setenv("TRITON_XPU_ALL_SPIRV_EXTENSIONS", "1")
+    assert XPUBackend(("xpu", 1)).parse_options({}).spirv_extensions is None
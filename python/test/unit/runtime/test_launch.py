@@ -4,7 +4,7 @@ import gc
 # import sys
 # import tempfile
 # import textwrap
-# import time
+import time
 import tracemalloc
 
 import torch
@@ -44,6 +44,137 @@ def test_memory_leak() -> None:
         tracemalloc.stop()
 
 
+def test_launch_batch() -> None:
+
+    @triton.jit
+    def add_kernel(x_ptr, y_ptr, value, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        tl.store(y_ptr + offsets, tl.load(x_ptr + offsets) + value)
+
+    xs = [torch.randn(128 * (i + 1), device='xpu') for i in range(8)]
+    ys = [torch.empty_like(x) for x in xs]
+    triton.launch_batch([(add_kernel, (x.numel() // 128, ), (x, y, float(i)), {"BLOCK": 128})
+                         for i, (x, y) in enumerate(zip(xs, ys))])
+    for i, (x, y) in enumerate(zip(xs, ys)):
+        torch.testing.assert_close(y, x + i)
+
+
+def test_launch_batch_overhead() -> None:
+
+    @triton.jit
+    def add_kernel(x_ptr, y_ptr, value, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        tl.store(y_ptr + offsets, tl.load(x_ptr + offsets) + value)
+
+    x = torch.randn(128, device='xpu')
+    ys = [torch.empty_like(x) for _ in range(64)]
+    launches = [(add_kernel, (1, ), (x, y, 1.0), {"BLOCK": 128}) for y in ys]
+
+    def one_by_one():
+        for kernel, grid, args, kwargs in launches:
+            kernel[grid](*args, **kwargs)
+
+    def batched():
+        triton.launch_batch(launches)
+
+    def measure(fn):
+        fn()
+        torch.xpu.synchronize()
+        best = float("inf")
+        for _ in range(10):
+            start = time.perf_counter()
+            fn()
+            torch.xpu.synchronize()
+            best = min(best, time.perf_counter() - start)
+        return best
+
+    # a batch must never cost more than launching its kernels one by one,
+    # up to the noise of the measurement
+    assert measure(batched) <= 1.2 * measure(one_by_one)
+    for y in ys:
+        torch.testing.assert_close(y, x + 1)
+
+
+def test_fuse_kernels() -> None:
+
+    @triton.jit
+    def add_kernel(x_ptr, y_ptr, value, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        tl.store(y_ptr + offsets, tl.load(x_ptr + offsets) + value)
+
+    @triton.jit
+    def fill_kernel(x_ptr, BLOCK: tl.constexpr):
+        offsets = (tl.program_id(1) * tl.num_programs(0) + tl.program_id(0)) * BLOCK + tl.arange(0, BLOCK)
+        tl.store(x_ptr + offsets, offsets)
+
+    x = torch.randn(512, device='xpu')
+    y = torch.empty_like(x)
+    z = torch.empty(1024, device='xpu', dtype=torch.int32)
+    launches = [(add_kernel, (4, ), (x, y, 2.0), {"BLOCK": 128}), (fill_kernel, (2, 4), (z, ), {"BLOCK": 128})]
+    fused = triton.fuse_kernels(launches)
+    assert fused.num_programs == 12
+    # the same kernel may be fused twice
+    w = torch.empty_like(x)
+    fused_twice = triton.fuse_kernels(launches + [(add_kernel, (4, ), (x, w, 3.0), {"BLOCK": 128})])
+    fused((x, y, 2.0), (z, ))
+    fused_twice((x, y, 2.0), (z, ), (x, w, 3.0))
+    torch.testing.assert_close(y, x + 2)
+    torch.testing.assert_close(w, x + 3)
+    torch.testing.assert_close(z, torch.arange(1024, device='xpu', dtype=torch.int32))
+
+
+def test_kernel_tracer(tmp_path) -> None:
+    import json
+    from triton.backends.intel.driver import XPUKernelTracer
+
+    @triton.jit
+    def fill_kernel(x_ptr, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        tl.store(x_ptr + offsets, offsets)
+
+    x = torch.empty(1024, device='xpu', dtype=torch.int32)
+    fill_kernel[(8, )](x, BLOCK=128)
+    tracer = XPUKernelTracer()
+    with tracer.record():
+        for _ in range(10):
+            fill_kernel[(8, )](x, BLOCK=128)
+    fill_kernel[(8, )](x, BLOCK=128)
+    assert tracer.dropped == 0
+    assert [(name, grid) for name, _, grid, _, _ in tracer.events] == [("fill_kernel", (8, 1, 1))] * 10
+    assert all(start <= end for _, _, _, start, end in tracer.events)
+
+    path = tmp_path / "trace.json"
+    tracer.export_chrome_trace(str(path))
+    events = json.loads(path.read_text())["traceEvents"]
+    assert len(events) == 10 and events[0]["name"] == "fill_kernel"
+
+
+def test_host_memory() -> None:
+    import numpy as np
+    import pytest
+    from triton.backends.intel.driver import XPUHostBuffer
+
+    @triton.jit
+    def scale_kernel(x_ptr, y_ptr, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        tl.store(y_ptr + offsets, tl.load(x_ptr + offsets) * 2)
+
+    x = XPUHostBuffer((1024, ), np.float32)
+    y = XPUHostBuffer((1024, ), np.float32)
+    x.numpy()[:] = np.arange(1024, dtype=np.float32)
+    for _ in range(2):
+        scale_kernel[(8, )](x, y, BLOCK=128, host_memory=True)
+        torch.xpu.synchronize()
+        np.testing.assert_equal(y.numpy(), 2 * x.numpy())
+
+    # host memory is only accepted by the kernels that expect it
+    out = torch.empty(1024, device='xpu', dtype=torch.float32)
+    with pytest.raises(ValueError, match="host_memory"):
+        scale_kernel[(8, )](x, out, BLOCK=128)
+    with pytest.raises(ValueError, match="cpu tensor"):
+        scale_kernel[(8, )](torch.ones(1024), out, BLOCK=128)
+
+
 # LATENCY_THRESHOLD_US = 46
 
 # def test_kernel_launch_latency() -> None:
@@ -105,3 +236,18 @@ def test_memory_leak() -> None:
 
 #     # Run empty, which would run empty_kernel internally
 #     empty(*kernel_args)
+
+
+def test_tile_splitter() -> None:
+    from triton.backends.intel.driver import XPUTileSplitter
+
+    @triton.jit
+    def fill_kernel(x_ptr, pid_offset, BLOCK: tl.constexpr):
+        offsets = (tl.program_id(0) + pid_offset) * BLOCK + tl.arange(0, BLOCK)
+        tl.store(x_ptr + offsets, offsets)
+
+    x = torch.full((1000 * 128, ), -1, device='xpu', dtype=torch.int32)
+    # the current device split in uneven parts
+    splitter = XPUTileSplitter(devices=[torch.xpu.current_device()] * 3)
+    splitter.launch(fill_kernel, (1000, ), x, BLOCK=128)
+    torch.testing.assert_close(x, torch.arange(x.numel(), device='xpu', dtype=torch.int32))
@@ -8,13 +8,18 @@ __version__ = '3.0.0'
 from .runtime import (
     autotune,
     Config,
+    fuse_kernels,
     heuristics,
     JITFunction,
     KernelInterface,
+    launch_batch,
     reinterpret,
     TensorWrapper,
     OutOfResources,
     MockTensor,
+    PersistentGrid,
+    precompile,
+    record_manifest,
 )
 from .runtime.jit import jit
 from .compiler import compile, CompilationError
@@ -29,16 +34,21 @@ __all__ = [
     "CompilationError",
     "compile",
     "Config",
+    "fuse_kernels",
     "heuristics",
     "impl",
     "jit",
     "JITFunction",
     "KernelInterface",
     "language",
+    "launch_batch",
     "MockTensor",
     "next_power_of_2",
     "ops",
     "OutOfResources",
+    "PersistentGrid",
+    "precompile",
+    "record_manifest",
     "reinterpret",
     "runtime",
     "TensorWrapper",
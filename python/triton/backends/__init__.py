@@ -1,6 +1,8 @@
 import os
 import importlib.util
 import inspect
+import threading
+from collections.abc import Mapping
 from dataclasses import dataclass
 from .driver import DriverBase
 from .compiler import BaseBackend
@@ -47,4 +49,28 @@ def _discover_backends():
     return backends
 
 
-backends = _discover_backends()
+class _LazyBackends(Mapping):
+    """The backends by name, only discovered when first looked up so that `import triton` does not load them."""
+
+    def __init__(self):
+        self._backends = None
+        self._lock = threading.Lock()
+
+    def _get(self):
+        if self._backends is None:
+            with self._lock:
+                if self._backends is None:
+                    self._backends = _discover_backends()
+        return self._backends
+
+    def __getitem__(self, name):
+        return self._get()[name]
+
+    def __iter__(self):
+        return iter(self._get())
+
+    def __len__(self):
+        return len(self._get())
+
+
+backends = _LazyBackends()
@@ -1,7 +1,52 @@
 from abc import ABCMeta, abstractmethod, abstractclassmethod
+from contextlib import contextmanager
 import os
 import subprocess
 import re
+import threading
+import time
+
+
+class CompileTimer:
+    """
+    Collects the time spent in the stages of one compilation. Pass managers
+    append per-pass records to `pass_report_path` (see `enable_timing`).
+    """
+
+    def __init__(self, pass_report_path):
+        self.pass_report_path = pass_report_path
+        self.steps = []
+
+    @contextmanager
+    def step(self, name):
+        start = time.perf_counter()
+        try:
+            yield
+        finally:
+            self.steps.append({"step": name, "seconds": time.perf_counter() - start})
+
+
+_compile_timer = threading.local()
+
+
+def get_compile_timer():
+    """Returns the `CompileTimer` of the compilation running in this thread, if timing is enabled."""
+    return getattr(_compile_timer, "value", None)
+
+
+def set_compile_timer(timer):
+    _compile_timer.value = timer
+
+
+@contextmanager
+def compile_step(name):
+    """Times `name` as a step of the current compilation, if timing is enabled."""
+    timer = get_compile_timer()
+    if timer is None:
+        yield
+        return
+    with timer.step(name):
+        yield
 
 
 class BaseBackend(metaclass=ABCMeta):
@@ -62,3 +107,21 @@ class BaseBackend(metaclass=ABCMeta):
         Load additional MLIR dialects into the provided `context`
         """
         raise NotImplementedError
+
+    def supports_native_block_pointers(self, options: object) -> bool:
+        """
+        Returns whether the backend lowers the loads and stores of block pointers (`tt.make_tensor_ptr`
+        and `tt.advance`) itself with `options`. Such backends keep them through TTGIR, where the ones
+        the target cannot lower are rewritten into tensors of pointers and masks; the others rewrite all
+        of them in TTIR.
+        """
+        return False
+
+    def stage_options(self) -> dict:
+        """
+        Returns a dictionary of the form option_name [str] => ir_name [str] naming, for each option,
+        the first stage that depends on it. Intermediate IRs are cached under a key that only includes
+        the options of the stages that produced them, so they can be reused when only options of later
+        stages change. Options that are not listed are assumed to affect every stage.
+        """
+        return dict()
@@ -11,6 +11,55 @@ class DriverBase(metaclass=ABCMeta):
     def get_current_target(self):
         pass
 
+    def get_device_key(self):
+        """
+        A string identifying the current device and its driver. Measurements made on
+        one device are only valid on devices with the same key.
+        """
+        return str(self.get_current_target())
+
+    def launch_batch(self, launches):
+        """
+        Launches each `(kernel, grid, args, kwargs)` of `launches` in order.
+        Drivers able to submit several kernels at once override this.
+        """
+        for kernel, grid, args, kwargs in launches:
+            kernel[grid](*args, **kwargs)
+
+    def max_cooperative_programs(self, kernel):
+        """
+        The number of programs of the loaded `kernel` that can be resident on
+        the current device at once, or None when the driver cannot tell.
+        """
+        return None
+
+    def get_ipc_handle(self, ptr):
+        """
+        A picklable handle through which other processes map the device memory
+        at `ptr` with `open_ipc_handle`.
+        """
+        raise NotImplementedError(f"{type(self).__name__} does not share memory between processes")
+
+    def open_ipc_handle(self, handle):
+        """
+        Maps the memory of a handle returned by `get_ipc_handle` in another
+        process. Returns the base address of the mapping, to pass to
+        `close_ipc_handle`, and the address of the shared pointer.
+        """
+        raise NotImplementedError(f"{type(self).__name__} does not share memory between processes")
+
+    def close_ipc_handle(self, base):
+        raise NotImplementedError(f"{type(self).__name__} does not share memory between processes")
+
+    def collect_metrics(self, fn):
+        """
+        Runs `fn` and returns the hardware counters of each kernel it launches,
+        as dicts from metric name to value, or None when the driver cannot
+        sample them.
+        """
+        fn()
+        return None
+
     def __init__(self) -> None:
         pass
 
@@ -838,6 +838,7 @@ class CodeGenerator(ast.NodeVisitor):
                     ast.NodeVisitor.generic_visit(self, stmt)
             return
         num_stages = None
+        unroll = None
         if IteratorClass is language.range:
             iterator = IteratorClass(*iter_args, **iter_kwargs)
             # visit iterator arguments
@@ -847,6 +848,7 @@ class CodeGenerator(ast.NodeVisitor):
             ub = iterator.end
             step = iterator.step
             num_stages = iterator.num_stages
+            unroll = iterator.unroll
         elif IteratorClass is range:
             # visit iterator arguments
             # note: only `range` iterator is supported now
@@ -920,6 +922,8 @@ class CodeGenerator(ast.NodeVisitor):
             for_op = self.builder.create_for_op(lb, ub, step, [arg.handle for arg in init_args])
             if num_stages is not None:
                 for_op.set_attr("tt.num_stages", self.builder.get_int32_attr(num_stages))
+            if unroll is not None:
+                for_op.set_attr("tt.unroll", self.builder.get_int32_attr(unroll))
 
             self.scf_stack.append(node)
             self.builder.set_insertion_point_to_start(for_op.get_body(0))
@@ -1219,6 +1223,9 @@ def ast_to_ttir(fn, specialization, context, options):
         else:
             attr.append(("tt.max_divisibility", 8))
         new_attrs[k] = attr
+    for param in fn.params:
+        if param.is_restrict:
+            new_attrs.setdefault(param.num, []).append(("tt.restrict", 1))
 
     all_constants = constants.copy()
     all_constants.update(new_constants)
@@ -3,18 +3,20 @@ import hashlib
 import json
 from .._C.libtriton import get_env_vars, ir
 from ..backends import backends
+from ..backends.compiler import CompileTimer, set_compile_timer
 from .. import __version__
 from ..runtime.autotuner import OutOfResources
-from ..runtime.cache import get_cache_manager, get_dump_manager, get_override_manager
+from ..runtime.cache import get_cache_manager, get_dump_manager, get_override_manager, read_cache_entry
 from ..runtime.driver import driver
-# TODO: this shouldn't be here
-from ..backends.intel.compiler import InfoFromBackendForTensorMap
 from dataclasses import dataclass
 from .code_generator import ast_to_ttir
 from pathlib import Path
 import re
 import functools
 import os
+import threading
+import time
+import weakref
 
 
 @dataclass
@@ -170,15 +172,21 @@ def triton_key():
     for lib in pkgutil.iter_modules([compiler_path, backends_path]):
         with open(lib.module_finder.find_spec(lib.name).origin, "rb") as f:
             contents += [hashlib.sha1(f.read()).hexdigest()]
-    # backend
-    libtriton_hash = hashlib.sha1()
-    with open(os.path.join(TRITON_PATH, "_C/libtriton.so"), "rb") as f:
-        while True:
-            chunk = f.read(1024**2)
-            if not chunk:
-                break
-            libtriton_hash.update(chunk)
-    contents.append(libtriton_hash.hexdigest())
+    # backend: the hash of the sources of libtriton computed when building it,
+    # unless asked to hash the library itself, e.g. when it was rebuilt
+    # against a different LLVM at the same path
+    from .._C import libtriton
+    if os.getenv("TRITON_HASH_LIBTRITON", "0") == "1" or not getattr(libtriton, "build_key", ""):
+        libtriton_hash = hashlib.sha1()
+        with open(os.path.join(TRITON_PATH, "_C/libtriton.so"), "rb") as f:
+            while True:
+                chunk = f.read(1024**2)
+                if not chunk:
+                    break
+                libtriton_hash.update(chunk)
+        contents.append(libtriton_hash.hexdigest())
+    else:
+        contents.append(libtriton.build_key)
     # language
     language_path = os.path.join(TRITON_PATH, 'language')
     for lib in pkgutil.iter_modules([language_path]):
@@ -198,19 +206,135 @@ def parse(full_name, ext, context):
         return Path(full_name).read_bytes()
 
 
+def _release_module(module):
+    # the operations of MLIR modules are owned by their context, which is
+    # pooled, so they are freed as soon as no stage reads them
+    if isinstance(module, ir.module):
+        module.clear()
+
+
+def stage_cache_keys(stages, options, stage_options, base_key):
+    """
+    Returns the cache key of the IR produced by each of `stages`, which only
+    covers the options read by that stage and the ones before it.
+    """
+    names = list(stages.keys())
+    option_items = sorted(options.__dict__.items())
+    keys = dict()
+    for i, ext in enumerate(names):
+        used = [(k, v) for k, v in option_items if names.index(stage_options.get(k, names[0])) <= i]
+        key = f"{base_key}-{ext}-{used}"
+        keys[ext] = hashlib.md5(key.encode("utf-8")).hexdigest()
+    return keys
+
+
+class _FreshContextPool:
+    """Stands in for the context pool of a backend when `TRITON_DISABLE_CONTEXT_POOL=1`."""
+
+    def __init__(self, backend):
+        self.backend = backend
+
+    def acquire(self):
+        context = ir.context()
+        ir.load_dialects(context)
+        self.backend.load_dialects(context)
+        return context
+
+    def release(self, context):
+        pass
+
+
+# contexts with the dialects of each backend loaded, reused between compilations
+_context_pools = dict()
+_context_pools_lock = threading.Lock()
+
+
+def _get_context_pool(backend):
+    if os.getenv("TRITON_DISABLE_CONTEXT_POOL", "0") == "1":
+        return _FreshContextPool(backend)
+    with _context_pools_lock:
+        pool = _context_pools.get(type(backend))
+        if pool is None:
+
+            def initialize(context):
+                ir.load_dialects(context)
+                backend.load_dialects(context)
+
+            pool = _context_pools[type(backend)] = ir.context_pool(initialize)
+        return pool
+
+
+def compile_keys(src, backend, options):
+    """
+    Returns the key of the IR shared by all the options of `src` and the hash
+    its artifacts with `options` are cached under.
+    """
+    env_vars = str(sorted(get_env_vars().items()))
+    base_key = f"{triton_key()}-{src.hash()}-{backend.hash()}-{env_vars}"
+    key = f"{triton_key()}-{src.hash()}-{backend.hash()}-{options.hash()}-{env_vars}"
+    return base_key, hashlib.md5(key.encode("utf-8")).hexdigest()
+
+
+def _source_ir(src, backend, options):
+    """The text of the module of `src`, with its locations, as sent to a compile server."""
+    if isinstance(src, IRSource):
+        return src.src
+    context_pool = _get_context_pool(backend)
+    context = context_pool.acquire()
+    try:
+        return src.make_ir(options, context).str()
+    finally:
+        context_pool.release(context)
+
+
+def _compile_remote(client, src, target, backend, options, hash, fn_cache_manager, metadata_filename):
+    """
+    Compiles `src` on the compile server of `client` and copies its artifacts to
+    `fn_cache_manager`; returns their group, or `None` to compile locally.
+    """
+    files = client.compile({
+        "hash": hash,
+        "name": src.name,
+        "ext": src.ext,
+        "ir": _source_ir(src, backend, options),
+        "src_hash": src.hash(),
+        "target": target,
+        "options": options.__dict__,
+        "metadata": src.metadata(),
+    })
+    if files is None:
+        return None
+    # the server may share our cache directory
+    metadata_group = fn_cache_manager.get_group(metadata_filename)
+    if metadata_group is None or metadata_filename not in metadata_group:
+        metadata_group = {filename: fn_cache_manager.put(data, filename) for filename, data in files.items()}
+        fn_cache_manager.put_group(metadata_filename, metadata_group)
+    return metadata_group
+
+
 def compile(src, target=None, options=None):
     if target is None:
         target = driver.active.get_current_target()
-    backend = make_backend(target)
-    # create backend
     if not isinstance(src, ASTSource):
         assert isinstance(src, str), "source must be either AST or a filepath"
         src = IRSource(src)
+    from ..runtime.compile_server import get_client
+    metadata_group = compile_group(src, target, options, get_client())
+    # return handle to compiled kernel
+    return CompiledKernel(src, metadata_group)
+
+
+def compile_group(src, target, options=None, client=None):
+    """
+    Compiles `src` for `target`, on the compile server of `client` if any, and
+    returns the group of its cached artifacts by file name.
+    """
+    # create backend
+    backend = make_backend(target)
     extra_options = src.parse_options()
     options = backend.parse_options(dict(options or dict(), **extra_options))
     # create cache manager
-    key = f"{triton_key()}-{src.hash()}-{backend.hash()}-{options.hash()}-{str(sorted(get_env_vars().items()))}"
-    hash = hashlib.md5(key.encode("utf-8")).hexdigest()
+    base_key, hash = compile_keys(src, backend, options)
     fn_cache_manager = get_cache_manager(hash)
     # For dumping/overriding only hash the source as we want it to be independent of triton
     # core changes to make it easier to track kernels by hash.
@@ -223,8 +347,13 @@ def compile(src, target=None, options=None):
     metadata_path = metadata_group.get(metadata_filename)
     if metadata_path is not None:
         # cache hit!
-        metadata = json.loads(Path(metadata_path).read_text())
-        return CompiledKernel(src, metadata_group)
+        return metadata_group
+    # dumped and overridden IR are only handled locally
+    if client is not None and fn_dump_manager is None and fn_override_manager is None:
+        remote_group = _compile_remote(client, src, target, backend, options, hash, fn_cache_manager,
+                                       metadata_filename)
+        if remote_group is not None:
+            return remote_group
     # initialize metadata
     metadata = {
         "hash": hash,
@@ -237,27 +366,120 @@ def compile(src, target=None, options=None):
     stages = dict()
     backend.add_stages(stages, options)
     first_stage = list(stages.keys()).index(src.ext)
-    context = ir.context()
-    ir.load_dialects(context)
-    backend.load_dialects(context)
-    module = src.make_ir(options, context)
-    for ext, compile_ir in list(stages.items())[first_stage:]:
-        next_module = compile_ir(module, metadata)
-        ir_filename = f"{src.name}.{ext}"
-        metadata_group[ir_filename] = fn_cache_manager.put(next_module, ir_filename)
-        if fn_dump_manager is not None:
-            fn_dump_manager.put(next_module, ir_filename)
-        if (fn_override_manager is not None and fn_override_manager.has_file(ir_filename)):
-            print(f"\nOverriding kernel with file {ir_filename}")
-            full_name = fn_override_manager.get_file(ir_filename)
-            next_module = parse(full_name, ext, context)
-        module = next_module
+    context_pool = _get_context_pool(backend)
+    context = context_pool.acquire()
+    try:
+        # intermediate IRs are shared between compilations that only differ in
+        # the options of later stages
+        stage_options = backend.stage_options()
+        use_stage_cache = bool(stage_options) and fn_dump_manager is None and fn_override_manager is None
+        stage_keys = stage_cache_keys(stages, options, stage_options, base_key) if use_stage_cache else dict()
+        module = None
+        if use_stage_cache:
+            module, first_stage = _load_cached_stage(src, stages, first_stage, stage_keys, stage_options, options,
+                                                     metadata, context, metadata_group, fn_cache_manager)
+        if module is None:
+            module = src.make_ir(options, context)
+        timing_dir = os.environ.get("TRITON_COMPILE_TIMING_DIR", "")
+        timer = None
+        if timing_dir:
+            os.makedirs(timing_dir, exist_ok=True)
+            timer = CompileTimer(os.path.join(timing_dir, f"{src.name}-{hash}.passes.jsonl"))
+        stage_times = []
+        set_compile_timer(timer)
+        for ext, compile_ir in list(stages.items())[first_stage:]:
+            stage_start = time.perf_counter()
+            try:
+                next_module = compile_ir(module, metadata)
+            finally:
+                stage_times.append({"stage": ext, "seconds": time.perf_counter() - stage_start})
+            ir_filename = f"{src.name}.{ext}"
+            metadata_group[ir_filename] = fn_cache_manager.put(next_module, ir_filename)
+            if ext in stage_keys and ext != list(stages.keys())[-1]:
+                _store_cached_stage(src, ext, next_module, stage_keys[ext], metadata, metadata_group)
+            if fn_dump_manager is not None:
+                fn_dump_manager.put(next_module, ir_filename)
+            if (fn_override_manager is not None and fn_override_manager.has_file(ir_filename)):
+                print(f"\nOverriding kernel with file {ir_filename}")
+                full_name = fn_override_manager.get_file(ir_filename)
+                _release_module(next_module)
+                next_module = parse(full_name, ext, context)
+            if module is not next_module:
+                _release_module(module)
+            module = next_module
+    finally:
+        set_compile_timer(None)
+        context_pool.release(context)
+    if timer is not None:
+        _write_timing_report(timing_dir, src, hash, stage_times, timer)
     # write-back metadata
     metadata_group[metadata_filename] = fn_cache_manager.put(json.dumps(metadata, default=vars), metadata_filename,
                                                              binary=False)
     fn_cache_manager.put_group(metadata_filename, metadata_group)
-    # return handle to compiled kernel
-    return CompiledKernel(src, metadata_group)
+    return metadata_group
+
+
+def _write_timing_report(timing_dir, src, hash, stage_times, timer):
+    passes = []
+    if os.path.exists(timer.pass_report_path):
+        with open(timer.pass_report_path) as f:
+            passes = [json.loads(line) for line in f if line.strip()]
+        os.remove(timer.pass_report_path)
+    report = {"name": src.name, "hash": hash, "stages": stage_times, "steps": timer.steps, "passes": passes}
+    Path(timing_dir, f"{src.name}-{hash}.json").write_text(json.dumps(report, indent=2))
+
+
+def _load_cached_stage(src, stages, first_stage, stage_keys, stage_options, options, metadata, context,
+                       metadata_group, fn_cache_manager):
+    """
+    Looks for the latest intermediate IR that can be reused for this
+    compilation. On a hit, `metadata` is restored to its state after that
+    stage, the IR of that stage and of the earlier ones are copied to the
+    kernel's artifacts in `metadata_group`, and the parsed IR is returned with
+    the index of the next stage.
+    """
+    names = list(stages.keys())
+    # the last stage is covered by the kernel cache itself
+    for i in reversed(range(first_stage, len(names) - 1)):
+        ext = names[i]
+        ir_filename = f"{src.name}.{ext}"
+        meta_filename = f"{ir_filename}.json"
+        cache_manager = get_cache_manager(stage_keys[ext])
+        group = cache_manager.get_group(meta_filename)
+        if group is None or ir_filename not in group or meta_filename not in group:
+            continue
+        # the IR is parsed from a file
+        module = parse(cache_manager.get_file(ir_filename), ext, context)
+        if module is None:
+            continue
+        # options of later stages may differ from the cached compilation
+        stage_metadata = json.loads(bytes(read_cache_entry(group[meta_filename])))
+        later = {k: v for k, v in options.__dict__.items() if names.index(stage_options.get(k, names[0])) > i}
+        metadata.update({**stage_metadata, **later, "hash": metadata["hash"], "target": metadata["target"]})
+        for filename, location in group.items():
+            if filename != meta_filename:
+                metadata_group[filename] = fn_cache_manager.put(bytes(read_cache_entry(location)), filename)
+        return module, i + 1
+    return None, first_stage
+
+
+def _store_cached_stage(src, ext, module, key, metadata, metadata_group):
+    """
+    Caches the IR of stage `ext` with the metadata after it, and the IR of
+    the earlier stages in `metadata_group`, which a compilation resuming from
+    it still returns.
+    """
+    cache_manager = get_cache_manager(key)
+    ir_filename = f"{src.name}.{ext}"
+    meta_filename = f"{ir_filename}.json"
+    group = {
+        filename: cache_manager.put(bytes(read_cache_entry(location)), filename)
+        for filename, location in metadata_group.items()
+        if filename != ir_filename and not filename.endswith(".json")
+    }
+    group[ir_filename] = cache_manager.put(module, ir_filename)
+    group[meta_filename] = cache_manager.put(json.dumps(metadata, default=vars), meta_filename, binary=False)
+    cache_manager.put_group(meta_filename, group)
 
 
 def make_backend(target):
@@ -268,6 +490,35 @@ def make_backend(target):
     return actives[0](target)
 
 
+class _KernelAsm(dict):
+    """
+    The IR of each stage of a `CompiledKernel` by extension. On XPU, `zebin`,
+    the GEN ISA binary IGC finalized the SPIR-V into, is queried from the
+    loaded module on first access, whichever way the kernel was loaded.
+    """
+
+    def __init__(self, kernel, stages):
+        super().__init__(stages)
+        self._kernel = weakref.ref(kernel)
+
+    def _is_lazy(self, key):
+        return key == "zebin" and self._kernel() is not None and driver.active.get_current_target()[0] == "xpu"
+
+    def __missing__(self, key):
+        if not self._is_lazy(key):
+            raise KeyError(key)
+        kernel = self._kernel()
+        kernel._init_handles()
+        value = self[key] = driver.active.utils.get_native_binary(kernel.module)
+        return value
+
+    def __contains__(self, key):
+        return super().__contains__(key) or self._is_lazy(key)
+
+    def get(self, key, default=None):
+        return self[key] if key in self else default
+
+
 class CompiledKernel:
 
     # Hooks for external tools to monitor the execution of triton kernels
@@ -277,8 +528,10 @@ class CompiledKernel:
 
     def __init__(self, src, metadata_group):
         from collections import namedtuple
-        metadata_path = next((Path(p) for c, p in metadata_group.items() if c.endswith(".json")))
-        self.metadata = json.loads(metadata_path.read_text())
+        # TODO: this shouldn't be here
+        from ..backends.intel.compiler import InfoFromBackendForTensorMap
+        metadata_path = next((p for c, p in metadata_group.items() if c.endswith(".json")))
+        self.metadata = json.loads(bytes(read_cache_entry(metadata_path)))
         self.metadata['tensormaps_info'] = [InfoFromBackendForTensorMap(e) for e in self.metadata['tensormaps_info']
                                             ] if 'tensormaps_info' in self.metadata else []
         for i, _ in enumerate(self.metadata["tensormaps_info"]):
@@ -291,17 +544,19 @@ class CompiledKernel:
         # create launcher
         self.run = driver.active.launcher_cls(src, self.metadata)
         # stores the text of each level of IR that was generated during compilation
-        asm_files = [Path(p) for c, p in metadata_group.items() if not c.endswith(".json")]
-        self.asm = {
-            file.suffix[1:]: file.read_bytes() if file.suffix[1:] == driver.active.binary_ext else file.read_text()
-            for file in asm_files
+        asm_files = {Path(c).suffix[1:]: p for c, p in metadata_group.items() if not c.endswith(".json")}
+        asm = {
+            ext: bytes(read_cache_entry(p)) if ext == driver.active.binary_ext else bytes(read_cache_entry(p)).decode()
+            for ext, p in asm_files.items()
         }
+        self.asm = _KernelAsm(self, asm)
         self.kernel = self.asm[driver.active.binary_ext]
         # binaries are lazily initialized
         # because it involves doing runtime things
         # (e.g., checking amount of shared memory on current device)
         self.module = None
         self.function = None
+        self.max_cooperative_programs = None
 
     def _init_handles(self):
         if self.module is not None:
@@ -313,25 +568,64 @@ class CompiledKernel:
             raise OutOfResources(self.metadata.shared, max_shared, "shared memory")
         if driver.active.get_current_target()[0] == "xpu":
             self.module, self.function, self.n_regs, self.n_spills = driver.active.utils.load_binary(
-                self.name, self.kernel, self.metadata.shared, driver.active.utils.get_sycl_device(device))
+                self.name, self.kernel, self.metadata.shared, driver.active.utils.get_sycl_device(device),
+                getattr(self.metadata, "grf_mode", None) or "default", getattr(self.metadata, "opt_level", 3))
         else:
             # TODO: n_regs, n_spills should be metadata generated when calling `ptxas`
             self.module, self.function, self.n_regs, self.n_spills = driver.active.utils.load_binary(
                 self.name, self.kernel, self.metadata.shared, device)
 
+    def check_cooperative_grid(self, grid_0, grid_1, grid_2):
+        """
+        Raises `OutOfResources` when the programs of a `cooperative` kernel, which
+        synchronize with `tl.grid_sync`, cannot all be resident at once and would
+        wait for one another forever.
+        """
+        if self.max_cooperative_programs is None:
+            self._init_handles()
+            self.max_cooperative_programs = driver.active.max_cooperative_programs(self)
+            if self.max_cooperative_programs is None:
+                return
+        num_programs = grid_0 * grid_1 * grid_2
+        if num_programs > self.max_cooperative_programs:
+            raise OutOfResources(num_programs, self.max_cooperative_programs, "co-resident programs")
+
     def __getattribute__(self, name):
         if name == 'run':
             self._init_handles()
         return super().__getattribute__(name)
 
+    def __del__(self):
+        # backends that hand out owned handles release them through `unload_binary`
+        module = self.__dict__.get("module", None)
+        if module is None:
+            return
+        try:
+            utils = driver.active.utils
+        except Exception:
+            # the interpreter is shutting down
+            return
+        if not hasattr(utils, "unload_binary"):
+            return
+        run = self.__dict__.get("run", None)
+        utils.unload_binary(module, self.function, getattr(run, "evict", None))
+        self.module = None
+        self.function = None
+
     def __getitem__(self, grid):
         self._init_handles()
+        if callable(grid):
+            # e.g. a `PersistentGrid`, which the arguments of a compiled kernel are not named for
+            grid = grid({})
+        grid = tuple(grid) + (1, ) * (3 - len(grid))
 
         def runner(*args, stream=None):
             if stream is None:
                 device = driver.active.get_current_device()
                 stream = driver.active.get_current_stream(device)
             md = self.metadata
+            if getattr(md, "cooperative", False):
+                self.check_cooperative_grid(*grid)
             args_expand = driver.active.assemble_tensormap_to_arg(md.tensormaps_info, args)
             self.run(grid[0], grid[1], grid[2], md.num_warps, md.num_ctas, md.cluster_dims[0], md.cluster_dims[1],
                      md.cluster_dims[2], md.shared, stream, self.function, CompiledKernel.launch_enter_hook,
@@ -9,11 +9,14 @@ from .standard import (
     cdiv,
     cumprod,
     cumsum,
+    device_cumsum,
     flip,
+    grid_sync,
     max,
     maximum,
     min,
     minimum,
+    next_tile,
     sigmoid,
     softmax,
     sort,
@@ -51,6 +54,7 @@ from .core import (
     device_assert,
     device_print,
     dot,
+    dot_scaled,
     dtype,
     exp,
     expand_dims,
@@ -64,6 +68,8 @@ from .core import (
     float8e4nv,
     float8e5,
     function_type,
+    gather,
+    global_scratch,
     histogram,
     inline_asm_elementwise,
     int1,
@@ -81,10 +87,12 @@ from .core import (
     permute,
     pi32_t,
     pointer_type,
+    prefetch,
     program_id,
     range,
     reduce,
     reshape,
+    restrict,
     sin,
     sqrt,
     static_assert,
@@ -148,8 +156,10 @@ __all__ = [
     "cumsum",
     "debug_barrier",
     "device_assert",
+    "device_cumsum",
     "device_print",
     "dot",
+    "dot_scaled",
     "dtype",
     "exp",
     "expand_dims",
@@ -165,6 +175,9 @@ __all__ = [
     "float8e5",
     "full",
     "function_type",
+    "gather",
+    "global_scratch",
+    "grid_sync",
     "histogram",
     "inline_asm_elementwise",
     "int1",
@@ -184,6 +197,7 @@ __all__ = [
     "min",
     "minimum",
     "multiple_of",
+    "next_tile",
     "num_programs",
     "pair_uniform_to_normal",
     "permute",
@@ -191,6 +205,7 @@ __all__ = [
     "philox_impl",
     "pi32_t",
     "pointer_type",
+    "prefetch",
     "program_id",
     "rand",
     "rand4x",
@@ -202,6 +217,7 @@ __all__ = [
     "ravel",
     "reduce",
     "reshape",
+    "restrict",
     "sigmoid",
     "sin",
     "softmax",
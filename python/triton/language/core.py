@@ -537,6 +537,16 @@ class constexpr:
         return self.value(*args, **kwds)
 
 
+class restrict:
+    """
+    Annotates a pointer argument of a kernel, as in :code:`def kernel(X: tl.restrict, ...)`,
+    as not aliasing the memory any other argument of the launch points to, like
+    C's :code:`restrict`. The backend may then reorder the accesses through it
+    with the other memory accesses of the kernel.
+    """
+    pass
+
+
 def check_bit_width(value, shift_value):
     if isinstance(value, tensor) and isinstance(shift_value, constexpr):
         bitwidth = value.type.scalar.primitive_bitwidth
@@ -857,6 +867,27 @@ def num_programs(axis, _builder=None):
     return semantic.num_programs(axis, _builder)
 
 
+@builtin
+def global_scratch(nbytes, alignment=16, _builder=None):
+    """
+    Returns a pointer to :code:`nbytes` bytes of global memory shared by all the programs of the
+    launch, e.g. for the partial results or the flags programs exchange, which callers then do not
+    have to allocate. Each call returns a different buffer.
+
+    The memory is allocated by the launcher, once per kernel and stream, and is zero on the first
+    launch. The following launches find it as the previous one left it, so kernels that need it
+    zeroed leave it so, or tell the data of each launch apart with a counter they keep in it.
+
+    :param nbytes: The size of the buffer, in bytes.
+    :type nbytes: int
+    :param alignment: The alignment of the buffer, in bytes; a power of 2.
+    :type alignment: int
+    """
+    nbytes = _constexpr_to_value(nbytes)
+    alignment = _constexpr_to_value(alignment)
+    return semantic.global_scratch(nbytes, alignment, _builder)
+
+
 # -----------------------
 # Block Initialization
 # -----------------------
@@ -1080,12 +1111,22 @@ def dot(input, other, acc=None, allow_tf32=True, max_num_imprecise_acc=None, out
     """
     Returns the matrix product of two blocks.
 
-    The two blocks must be two-dimensional and have compatible inner dimensions.
+    The two blocks must be two-dimensional and have compatible inner dimensions. They can also be
+    three-dimensional, of shapes :code:`[B, M, K]` and :code:`[B, K, N]`, in which case the result is the
+    :code:`[B, M, N]` block of the B matrix products. Batched products are computed with FMAs rather
+    than matrix instructions, so that one program computes many small matrices, e.g. those of each
+    head of attention, instead of spreading them over the grid.
 
     :param input: The first tensor to be multiplied.
-    :type input: 2D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
+    :type input: 2D or 3D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
     :param other: The second tensor to be multiplied.
-    :type other: 2D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
+    :type other: 2D or 3D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
+    :param max_num_imprecise_acc: The number of elements of K accumulated in lower precision than
+        :code:`out_dtype` before being added to the accumulator. It defaults to the backend's choice for
+        fp8 dots and to 0, i.e. full precision, otherwise. On XPU, a positive value makes float16 dots into
+        float32 accumulate in float16 that many elements at a time.
+    :param out_dtype: The type of the accumulator and the result. float16 dots can accumulate in
+        :code:`float16`, which halves the registers of the accumulator at the cost of precision.
     """
     allow_tf32 = _constexpr_to_value(allow_tf32)
     out_dtype = _constexpr_to_value(out_dtype)
@@ -1093,6 +1134,32 @@ def dot(input, other, acc=None, allow_tf32=True, max_num_imprecise_acc=None, out
     return semantic.dot(input, other, acc, allow_tf32, max_num_imprecise_acc, out_dtype, _builder)
 
 
+@builtin
+def dot_scaled(input, input_scale, other, other_scale, acc=None, allow_tf32=True, max_num_imprecise_acc=None,
+               _builder=None):
+    """
+    Returns the matrix product of two blocks scaled by the outer product of :code:`input_scale` and
+    :code:`other_scale`, added to :code:`acc`, in float32.
+
+    Block scaled GEMMs call it once per block of K, with the scales of that block, so that the scales
+    are applied as each block is accumulated.
+
+    :param input: The first tensor to be multiplied.
+    :type input: 2D tensor of scalar-type in {:code:`float8e4nv`, :code:`float8e5`, :code:`float16`, :code:`bfloat16`}
+    :param input_scale: The scales of the rows of :code:`input`, either floating point or :code:`uint8`
+        E8M0 exponents as in the microscaling formats.
+    :type input_scale: 1D tensor
+    :param other: The second tensor to be multiplied.
+    :type other: 2D tensor of scalar-type in {:code:`float8e4nv`, :code:`float8e5`, :code:`float16`, :code:`bfloat16`}
+    :param other_scale: The scales of the columns of :code:`other`, as :code:`input_scale`.
+    :type other_scale: 1D tensor
+    """
+    allow_tf32 = _constexpr_to_value(allow_tf32)
+    max_num_imprecise_acc = _constexpr_to_value(max_num_imprecise_acc)
+    return semantic.dot_scaled(input, input_scale, other, other_scale, acc, allow_tf32, max_num_imprecise_acc,
+                               _builder)
+
+
 # -----------------------
 # Non-Atomic Memory Operations
 # -----------------------
@@ -1193,6 +1260,28 @@ def store(pointer, value, mask=None, boundary_check=(), cache_modifier="", evict
     return semantic.store(pointer, value, mask, boundary_check, cache_modifier, eviction_policy, _builder)
 
 
+@builtin
+def prefetch(pointer, mask=None, cache_level="l2", _builder=None):
+    """
+    Hints that the memory locations defined by `pointer` are going to be loaded soon, so that they are fetched
+    into the cache ahead of the load. As in :code:`load`, `pointer` could be a single element pointer, a tensor of
+    pointers, or a block pointer defined by `make_block_ptr`, which is only prefetched within its boundaries.
+
+    Prefetching is only a hint: it does not return anything and is dropped on targets without prefetch instructions.
+
+    :param pointer: The memory locations to prefetch
+    :type pointer: `triton.PointerType`, or block of `dtype=triton.PointerType`
+    :param mask: If `mask[idx]` is false, do not prefetch `pointer[idx]`. Must be None with block pointers.
+    :type mask: Block of `triton.int1`, optional
+    :param cache_level: The cache level to prefetch into, "l1" or "l2"
+    :type cache_level: str, optional
+    """
+    if _constexpr_to_value(mask) is not None:
+        mask = _to_tensor(mask, _builder)
+    cache_level = _constexpr_to_value(cache_level)
+    return semantic.prefetch(pointer, mask, cache_level, _builder)
+
+
 @builtin
 def make_block_ptr(base: tensor, shape, strides, offsets, block_shape, order, _builder=None):
     """
@@ -1571,7 +1660,8 @@ def _promote_bfloat16_to_float32(t, _builder=None):
 
 
 @builtin
-def _reduce_with_indices(input, axis, combine_fn, keep_dims=False, _builder=None, _generator=None):
+def _indices_along(input, axis, _builder=None):
+    """The index of each element of :code:`input` along :code:`axis`, as an int32 tensor of the shape of :code:`input`."""
     axis = _constexpr_to_value(axis)
     n = input.shape[axis]
     index = arange(0, n, _builder=_builder)
@@ -1582,6 +1672,13 @@ def _reduce_with_indices(input, axis, combine_fn, keep_dims=False, _builder=None
         del axes_to_expand[axis]
         index = expand_dims(index, axes_to_expand, _builder=_builder)
         index = broadcast_to(index, input.shape, _builder=_builder)
+    return index
+
+
+@builtin
+def _reduce_with_indices(input, axis, combine_fn, keep_dims=False, _builder=None, _generator=None):
+    axis = _constexpr_to_value(axis)
+    index = _indices_along(input, axis, _builder=_builder)
 
     rvalue, rindices = reduce((input, index), axis, combine_fn, keep_dims=keep_dims, _builder=_builder,
                               _generator=_generator)
@@ -1653,6 +1750,26 @@ def histogram(input, num_bins, _builder=None, _generator=None):
     return semantic.histogram(input, num_bins, _builder)
 
 
+@builtin
+def gather(src, index, axis, _builder=None):
+    """Gather from a tensor along a given dimension.
+
+    The element of the output at position `[i0, ..., ik, ...]`, where `k` is
+    `axis`, is the element of `src` at position `[i0, ..., index[i0, ..., ik, ...], ...]`.
+    This reads table lookups, e.g. the codebooks of quantized weights, from
+    registers or shared memory rather than global memory.
+
+    :param src: the source tensor
+    :type src: Tensor
+    :param index: the index tensor, of the rank of :code:`src` and with its sizes except along :code:`axis`
+    :type index: Tensor
+    :param axis: the dimension to gather along
+    :type axis: int
+    """
+    axis = _constexpr_to_value(axis)
+    return semantic.gather(src, index, axis, _builder)
+
+
 # -----------------------
 # Compiler Hint Ops
 # -----------------------
@@ -1844,6 +1961,13 @@ def inline_asm_elementwise(asm: str, constraints: str, args: Sequence, dtype: Un
         Input elements of size less than 4 bytes are packed into 4-byte
         registers.
 
+        On Intel GPUs, :code:`asm` is either inline vISA, or the name of a
+        SPIR-V builtin or device function prefixed with :code:`@`, which is
+        called with one argument per input and must return a single value.
+        There, the :code:`pack` elements of each input and output are passed
+        as one vector of :code:`pack` elements, or as a scalar when
+        :code:`pack` is 1.
+
         This op does not support empty :code:`dtype` -- the inline asm must
         return at least one tensor, even if you don't need it.  You can work
         around this by returning a dummy tensor of arbitrary type; it shouldn't
@@ -2020,9 +2144,11 @@ class range:
     :param arg2: the end value.
     :param step: the step value.
     :param num_warps: the num_warps used by pipeliner value.
+    :param unroll: the factor the loop is unrolled by before layout assignment, on backends that
+        unroll at the Triton IR level.
     """
 
-    def __init__(self, arg1, arg2=None, step=None, num_stages=None):
+    def __init__(self, arg1, arg2=None, step=None, num_stages=None, unroll=None):
         if step is None:
             self.step = constexpr(1)
         else:
@@ -2034,6 +2160,7 @@ class range:
             self.start = arg1
             self.end = arg2
         self.num_stages = num_stages
+        self.unroll = unroll
 
     def __iter__(self):
         raise RuntimeError("tl.range can only be used in @triton.jit'd functions")
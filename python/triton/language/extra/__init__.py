@@ -1,3 +1,3 @@
-from . import cuda
+from . import cuda, signal, warp
 
-__all__ = ['cuda']
+__all__ = ['cuda', 'signal', 'warp']
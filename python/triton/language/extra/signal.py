@@ -0,0 +1,34 @@
+"""
+Flags in global memory through which the programs of a kernel wait for
+programs of another kernel, possibly running on another device, whose memory
+they reach over the peer links (Xe Link on Intel GPUs, NVLink on NVIDIA
+GPUs). A flag is an int32 that only grows: the waiting program knows the
+value it waits for, e.g. a count of the launches, so it never needs a reset.
+"""
+
+from ...runtime.jit import jit
+from .. import core
+
+
+@jit
+def notify(flag_ptr, value):
+    """
+    Sets the flag at :code:`flag_ptr` to :code:`value`, once the global memory
+    writes of all the threads of the program before it are visible to the
+    programs of every device that see the new value.
+    """
+    core.debug_barrier()
+    core.atomic_xchg(flag_ptr, value, sem="release", scope="sys")
+
+
+@jit
+def wait(flag_ptr, value):
+    """
+    Waits until the flag at :code:`flag_ptr` is at least :code:`value`; the
+    writes before the :code:`notify` that set it are then visible to all the
+    threads of the program.
+    """
+    ready = False
+    while not ready:
+        ready = core.atomic_add(flag_ptr, 0, sem="acquire", scope="sys") >= value
+    core.debug_barrier()
@@ -0,0 +1,92 @@
+"""
+Collectives across the lanes of a warp (a sub-group on Intel GPUs).
+
+These operate on the registers of the threads, so which elements of a tensor
+share a warp, and which lane holds them, depend on the layout the compiler
+picks for the tensor. They are meant for tensors distributed one element per
+lane, such as :code:`tl.arange(0, WARP_SIZE)` in a kernel launched with a
+single warp.
+"""
+
+from .. import core
+from .. import semantic
+
+
+@core.extern
+def shuffle(x, lane, _builder=None):
+    """Returns the value of :code:`x` held by lane :code:`lane` of the warp, taken modulo the warp size."""
+    lane = core._to_tensor(lane, _builder)
+    return semantic.warp_shuffle(x, lane, "idx", _builder)
+
+
+@core.extern
+def broadcast(x, lane, _builder=None):
+    """Returns the value of :code:`x` held by lane :code:`lane` of the warp to every lane."""
+    return shuffle(x, lane, _builder=_builder)
+
+
+@core.extern
+def shuffle_xor(x, mask, _builder=None):
+    """Returns the value of :code:`x` held by the lane whose id is the lane id xor :code:`mask`.
+    Lanes reading outside of the warp keep their value."""
+    mask = core._to_tensor(mask, _builder)
+    return semantic.warp_shuffle(x, mask, "xor", _builder)
+
+
+@core.extern
+def shuffle_up(x, delta, _builder=None):
+    """Returns the value of :code:`x` held by the lane :code:`delta` below the current one.
+    The first :code:`delta` lanes keep their value."""
+    delta = core._to_tensor(delta, _builder)
+    return semantic.warp_shuffle(x, delta, "up", _builder)
+
+
+@core.extern
+def shuffle_down(x, delta, _builder=None):
+    """Returns the value of :code:`x` held by the lane :code:`delta` above the current one.
+    The last :code:`delta` lanes keep their value."""
+    delta = core._to_tensor(delta, _builder)
+    return semantic.warp_shuffle(x, delta, "down", _builder)
+
+
+@core.extern
+def ballot(pred, _builder=None):
+    """Returns the int32 mask of the lanes of the warp for which :code:`pred` holds."""
+    return semantic.warp_ballot(pred, _builder)
+
+
+def _make_combine_region(input, combine_fn, create_ret, _builder, _generator):
+
+    def make_combine_region(op):
+        scalar_ty = input.type.scalar
+        region = op.get_region(0)
+        with core._insertion_guard(_builder):
+            ir_ty = scalar_ty.to_ir(_builder)
+            block = _builder.create_block_with_parent(region, [ir_ty, ir_ty])
+            args = [core.tensor(block.arg(i), scalar_ty) for i in range(2)]
+            result = _generator.call_JitFunction(combine_fn, args, kwargs={})
+            create_ret(result.handle)
+
+    return make_combine_region
+
+
+@core.extern
+def reduce(x, combine_fn, _builder=None, _generator=None):
+    """Combines the values of :code:`x` held by all the lanes of the warp with :code:`combine_fn`,
+    which must be associative and commutative, and returns the result to every lane.
+
+    :param combine_fn: a function to combine two scalar tensors (must be marked with @triton.jit)
+    """
+    region_builder_fn = _make_combine_region(x, combine_fn, _builder.create_reduce_ret, _builder, _generator)
+    return semantic.warp_reduction(x, region_builder_fn, _builder)
+
+
+@core.extern
+def scan(x, combine_fn, _builder=None, _generator=None):
+    """Returns the inclusive scan with :code:`combine_fn`, which must be associative, of the values of
+    :code:`x` held by the lanes of the warp up to the current one.
+
+    :param combine_fn: a function to combine two scalar tensors (must be marked with @triton.jit)
+    """
+    region_builder_fn = _make_combine_region(x, combine_fn, _builder.create_scan_ret, _builder, _generator)
+    return semantic.warp_scan(x, region_builder_fn, _builder)
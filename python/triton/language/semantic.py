@@ -35,6 +35,14 @@ def num_programs(axis: int, builder: ir.builder) -> tl.tensor:
     return tl.tensor(builder.create_get_num_programs(axis), tl.int32)
 
 
+def global_scratch(nbytes: int, alignment: int, builder: ir.builder) -> tl.tensor:
+    if nbytes <= 0:
+        raise ValueError(f"global scratch memory must have a positive size but got {nbytes}")
+    if alignment <= 0 or alignment & (alignment - 1):
+        raise ValueError(f"global scratch memory alignment must be a power of 2 but got {alignment}")
+    return tl.tensor(builder.create_global_scratch_alloc(nbytes, alignment), tl.pointer_type(tl.int8))
+
+
 # ===----------------------------------------------------------------------===//
 #                               Implicit Casting Utilities
 # ===----------------------------------------------------------------------===//
@@ -1064,6 +1072,35 @@ def store(ptr: tl.tensor, val: tl.tensor, mask: Optional[tl.tensor], boundary_ch
         return _store_legacy(ptr, val, mask, boundary_check, cache, eviction, builder)
 
 
+def _str_to_cache_level(cache_level):
+    if cache_level == "l1":
+        return ir.CACHE_LEVEL.L1
+    if cache_level == "l2":
+        return ir.CACHE_LEVEL.L2
+    raise ValueError(f"Cache level {cache_level} not supported")
+
+
+def prefetch(ptr: tl.tensor, mask: Optional[tl.tensor], cache_level: str, builder: ir.builder) -> tl.tensor:
+    level = _str_to_cache_level(cache_level)
+
+    if ptr.type.is_ptr() and ptr.type.element_ty.is_block():
+        # Prefetch from a block pointer, which is masked by its boundaries
+        if mask:
+            raise ValueError("`mask` argument cannot be specified for prefetching from a block pointer")
+        return tl.tensor(builder.create_prefetch(ptr.handle, None, level), tl.void)
+
+    if not ptr.type.scalar.is_ptr():
+        raise ValueError(f"Unsupported ptr type {ptr.type.__repr__()} in `tl.prefetch`")
+    if mask:
+        if not ptr.type.is_block() and mask.type.is_block():
+            raise ValueError("Mask argument cannot be block type if pointer argument is not a block")
+        if ptr.type.is_block():
+            mask = broadcast_impl_shape(mask, ptr.type.get_block_shapes(), builder)
+        if not mask.type.scalar.is_bool():
+            raise ValueError("Mask must have boolean scalar type")
+    return tl.tensor(builder.create_prefetch(ptr.handle, mask.handle if mask else None, level), tl.void)
+
+
 #########
 # atomic
 #########
@@ -1121,6 +1158,9 @@ def atomic_max(ptr: tl.tensor, val: tl.tensor, mask: tl.tensor, sem: str, scope:
     # return atomic_umin(i_ptr, i_val) if val < 0
     if sca_ty not in {tl.float32, tl.float64}:
         raise TypeError(f"atomic_max not supported for dtype {sca_ty}")
+    if builder.options.native_float_atomic_minmax:
+        return tl.tensor(
+            builder.create_atomic_rmw(ir.ATOMIC_OP.FMAX, ptr.handle, val.handle, mask.handle, sem, scope), val.type)
 
     itype = tl.int32 if sca_ty == tl.float32 else tl.int64
     zero = full([], 0.0, sca_ty, builder)
@@ -1157,6 +1197,9 @@ def atomic_min(ptr: tl.tensor, val: tl.tensor, mask: tl.tensor, sem: str, scope:
     # return atomic_umax(i_ptr, i_val) if val < 0
     if sca_ty not in {tl.float32, tl.float64}:
         raise TypeError(f"atomic_min not supported for dtype {sca_ty}")
+    if builder.options.native_float_atomic_minmax:
+        return tl.tensor(
+            builder.create_atomic_rmw(ir.ATOMIC_OP.FMIN, ptr.handle, val.handle, mask.handle, sem, scope), val.type)
 
     itype = tl.int32 if sca_ty == tl.float32 else tl.int64
     zero = full([], 0.0, sca_ty, builder)
@@ -1222,41 +1265,36 @@ def atomic_xchg(ptr: tl.tensor, val: tl.tensor, mask: tl.tensor, sem: str, scope
 # ===----------------------------------------------------------------------===//
 
 
-def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_num_imprecise_acc: int,
-        out_dtype: tl.dtype, builder: ir.builder) -> tl.tensor:
-
-    def assert_dtypes_valid(lhs_dtype, rhs_dtype, options):
-        if not options.allow_fp8e4nv:
-            assert not lhs_dtype.is_fp8e4nv() and not rhs_dtype.is_fp8e4nv(
-            ), "Dot op does not support fp8e4nv on CUDA arch < 90"
-            if lhs_dtype.is_fp8() and rhs_dtype.is_fp8():
-                return
-            assert lhs_dtype == rhs_dtype, f"First input ({lhs_dtype}) and second input ({rhs_dtype}) must have the same dtype!"
+def _assert_dot_dtypes_valid(lhs_dtype, rhs_dtype, options):
+    if not options.allow_fp8e4nv:
+        assert not lhs_dtype.is_fp8e4nv() and not rhs_dtype.is_fp8e4nv(
+        ), "Dot op does not support fp8e4nv on CUDA arch < 90"
+        if lhs_dtype.is_fp8() and rhs_dtype.is_fp8():
+            return
+        assert lhs_dtype == rhs_dtype, f"First input ({lhs_dtype}) and second input ({rhs_dtype}) must have the same dtype!"
+    else:
+        assert not lhs_dtype.is_fp8e4b15() and not rhs_dtype.is_fp8e4b15(
+        ), "Dot op does not support fp8e4b15 on CUDA arch >= 90"
+        assert not lhs_dtype.is_fp8e4b15x4() and not rhs_dtype.is_fp8e4b15x4(
+        ), "Dot op does not support fp8e4b15x4 on CUDA arch >= 90"
+        if lhs_dtype.is_int() or rhs_dtype.is_int():
+            assert lhs_dtype == rhs_dtype, f"Both operands must be same type. First operand ({lhs_dtype}) and second operand ({rhs_dtype})"
+            assert lhs_dtype.is_int8() or lhs_dtype.is_uint8(
+            ), f"Both operands must be either int8 or uint8. Operand type ({lhs_dtype})"
+        elif lhs_dtype.is_fp8() or rhs_dtype.is_fp8():
+            assert lhs_dtype.is_fp8e4nv() or lhs_dtype.is_fp8e5(
+            ), f"Only supports fp8e4nv or fp8e5. First operand ({lhs_dtype})"
+            assert rhs_dtype.is_fp8e4nv() or rhs_dtype.is_fp8e5(
+            ), f"Only supports fp8e4nv or fp8e5. Second operand ({rhs_dtype})"
         else:
-            assert not lhs_dtype.is_fp8e4b15() and not rhs_dtype.is_fp8e4b15(
-            ), "Dot op does not support fp8e4b15 on CUDA arch >= 90"
-            assert not lhs_dtype.is_fp8e4b15x4() and not rhs_dtype.is_fp8e4b15x4(
-            ), "Dot op does not support fp8e4b15x4 on CUDA arch >= 90"
-            if lhs_dtype.is_int() or rhs_dtype.is_int():
-                assert lhs_dtype == rhs_dtype, f"Both operands must be same type. First operand ({lhs_dtype}) and second operand ({rhs_dtype})"
-                assert lhs_dtype.is_int8() or lhs_dtype.is_uint8(
-                ), f"Both operands must be either int8 or uint8. Operand type ({lhs_dtype})"
-            elif lhs_dtype.is_fp8() or rhs_dtype.is_fp8():
-                assert lhs_dtype.is_fp8e4nv() or lhs_dtype.is_fp8e5(
-                ), f"Only supports fp8e4nv or fp8e5. First operand ({lhs_dtype})"
-                assert rhs_dtype.is_fp8e4nv() or rhs_dtype.is_fp8e5(
-                ), f"Only supports fp8e4nv or fp8e5. Second operand ({rhs_dtype})"
-            else:
-                assert lhs_dtype.is_fp16() or lhs_dtype.is_bf16() or lhs_dtype.is_fp32() or lhs_dtype.is_int1(
-                ), f"Unsupported dtype {lhs_dtype}"
-                assert rhs_dtype.is_fp16() or rhs_dtype.is_bf16() or rhs_dtype.is_fp32() or rhs_dtype.is_int1(
-                ), f"Unsupported dtype {rhs_dtype}"
-                assert lhs_dtype == rhs_dtype, f"First input ({lhs_dtype}) and second input ({rhs_dtype}) must have the same dtype!"
-
-    assert lhs.type.is_block() and rhs.type.is_block()
+            assert lhs_dtype.is_fp16() or lhs_dtype.is_bf16() or lhs_dtype.is_fp32() or lhs_dtype.is_int1(
+            ), f"Unsupported dtype {lhs_dtype}"
+            assert rhs_dtype.is_fp16() or rhs_dtype.is_bf16() or rhs_dtype.is_fp32() or rhs_dtype.is_int1(
+            ), f"Unsupported dtype {rhs_dtype}"
+            assert lhs_dtype == rhs_dtype, f"First input ({lhs_dtype}) and second input ({rhs_dtype}) must have the same dtype!"
 
-    assert_dtypes_valid(lhs.dtype, rhs.dtype, builder.options)
 
+def _assert_dot_shapes_valid(lhs: tl.tensor, rhs: tl.tensor):
     assert len(lhs.shape) == 2, f"First input shape ({lhs.shape}) is not two dimensional!"
     assert len(rhs.shape) == 2, f"Second input shape ({rhs.shape}) is not two dimensional!"
     assert lhs.shape[1].value == rhs.shape[
@@ -1264,10 +1302,32 @@ def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_nu
     assert lhs.shape[0].value >= 16 and lhs.shape[1].value >= 16 \
         and rhs.shape[1].value >= 16, \
         f"All values in both first input shape ({lhs.shape}) and second input shape ({rhs.shape}) must be >= 16!"
+
+
+def _assert_batched_dot_shapes_valid(lhs: tl.tensor, rhs: tl.tensor):
+    # batched dots are computed with FMAs, so the matrices have no minimum size
+    assert len(rhs.shape) == 3, f"Second input shape ({rhs.shape}) is not three dimensional!"
+    assert lhs.shape[0].value == rhs.shape[
+        0].value, f"First input shape ({lhs.shape}) and second input shape {rhs.shape} do not have the same batch size"
+    assert lhs.shape[2].value == rhs.shape[
+        1].value, f"First input shape ({lhs.shape}) and second input shape {rhs.shape} are not compatible for batched matmul (third index of first shape ({lhs.shape[2].value}) must be equal to second index of second shape ({rhs.shape[1].value})"
+
+
+def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_num_imprecise_acc: int,
+        out_dtype: tl.dtype, builder: ir.builder) -> tl.tensor:
+    assert lhs.type.is_block() and rhs.type.is_block()
+
+    _assert_dot_dtypes_valid(lhs.dtype, rhs.dtype, builder.options)
+
+    batched = len(lhs.shape) == 3
+    if batched:
+        _assert_batched_dot_shapes_valid(lhs, rhs)
+    else:
+        _assert_dot_shapes_valid(lhs, rhs)
     if lhs.type.scalar.is_int():
         assert lhs.type.scalar == tl.int8, "only int8 supported!"
         # TODO: This is CUDA specific, check if ROCm has the same limitation
-        assert lhs.shape[1].value >= 32, "small blocks not supported!"
+        assert batched or lhs.shape[1].value >= 32, "small blocks not supported!"
         _0 = builder.get_int32(0)
         ret_scalar_ty = tl.int32
     elif out_dtype.is_bf16():
@@ -1280,12 +1340,12 @@ def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_nu
         _0 = builder.get_fp16(0) if out_dtype.is_fp16() else builder.get_fp32(0)
         ret_scalar_ty = out_dtype
 
-    M = lhs.type.shape[0]
-    N = rhs.type.shape[1]
+    # the leading batch dimension, if any, is kept in the result
+    shape = lhs.type.shape[:-1] + rhs.type.shape[-1:]
 
-    ret_ty = tl.block_type(ret_scalar_ty, [M, N])
+    ret_ty = tl.block_type(ret_scalar_ty, shape)
     if acc is None:
-        acc_handle = builder.create_splat(_0, [M, N])
+        acc_handle = builder.create_splat(_0, shape)
     else:
         acc_handle = acc.handle
         assert acc.type == ret_ty
@@ -1300,6 +1360,50 @@ def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_nu
     return tl.tensor(builder.create_dot(lhs.handle, rhs.handle, acc_handle, allow_tf32, max_num_imprecise_acc), ret_ty)
 
 
+def _decode_dot_scale(scale: tl.tensor, builder: ir.builder) -> tl.tensor:
+    # uint8 scales are E8M0 exponents, as in the microscaling formats.
+    if scale.dtype.is_uint8():
+        bits = shl(cast(scale, tl.int32, builder), tl._to_tensor(23, builder), builder)
+        return bitcast(bits, tl.float32, builder)
+    assert scale.dtype.is_floating(), f"Unsupported scale dtype {scale.dtype}"
+    return cast(scale, tl.float32, builder)
+
+
+def dot_scaled(lhs: tl.tensor, lhs_scale: tl.tensor, rhs: tl.tensor, rhs_scale: tl.tensor, acc: tl.tensor,
+               allow_tf32: bool, max_num_imprecise_acc: int, builder: ir.builder) -> tl.tensor:
+    assert lhs.type.is_block() and rhs.type.is_block()
+    assert lhs.dtype.is_floating() and rhs.dtype.is_floating(), "Scaled dot only supports floating point inputs"
+
+    _assert_dot_dtypes_valid(lhs.dtype, rhs.dtype, builder.options)
+
+    _assert_dot_shapes_valid(lhs, rhs)
+    M = lhs.type.shape[0]
+    N = rhs.type.shape[1]
+    assert lhs_scale.type.is_block() and lhs_scale.type.shape == [M], \
+        f"First scale shape ({lhs_scale.shape}) must have one element per row of the first input ({lhs.shape})"
+    assert rhs_scale.type.is_block() and rhs_scale.type.shape == [N], \
+        f"Second scale shape ({rhs_scale.shape}) must have one element per column of the second input ({rhs.shape})"
+    lhs_scale = _decode_dot_scale(lhs_scale, builder)
+    rhs_scale = _decode_dot_scale(rhs_scale, builder)
+
+    ret_ty = tl.block_type(tl.float32, [M, N])
+    if acc is None:
+        acc_handle = builder.create_splat(builder.get_fp32(0), [M, N])
+    else:
+        acc_handle = acc.handle
+        assert acc.type == ret_ty
+
+    if max_num_imprecise_acc is None:
+        if lhs.dtype.is_fp8() and rhs.dtype.is_fp8():
+            max_num_imprecise_acc = builder.options.max_num_imprecise_acc_default
+        else:
+            max_num_imprecise_acc = 0
+
+    ret = builder.create_dot_scaled(lhs.handle, lhs_scale.handle, rhs.handle, rhs_scale.handle, acc_handle, allow_tf32,
+                                    max_num_imprecise_acc)
+    return tl.tensor(ret, ret_ty)
+
+
 # ===----------------------------------------------------------------------===//
 #                               Indexing
 # ===----------------------------------------------------------------------===//
@@ -1396,6 +1500,114 @@ def histogram(input: tl.tensor, num_bins: int, builder: ir.builder) -> tl.tensor
     return tl.tensor(histogram_op.get_result(0), tl.block_type(tl.int32, (num_bins, )))
 
 
+# ===----------------------------------------------------------------------===
+#                               Gather
+# ===----------------------------------------------------------------------===
+
+
+def gather(src: tl.tensor, index: tl.tensor, axis: int, builder: ir.builder) -> tl.tensor:
+    assert index.dtype.is_int(), "index must be an integer tensor"
+    rank = len(src.type.shape)
+    assert len(index.type.shape) == rank, "source and index tensors must have the same rank"
+    assert -rank <= axis < rank, f"gather axis {axis} must be < source rank ({rank})"
+    if axis < 0:
+        axis += rank
+    for d, (src_dim, index_dim) in enumerate(zip(src.type.shape, index.type.shape)):
+        if d != axis and src_dim != index_dim:
+            raise ValueError(f"index dim {d} must match the corresponding source dim: {index_dim} != {src_dim}")
+    # tt.gather sign extends the indices narrower than 32 bits.
+    if index.dtype.is_int_unsigned() and index.dtype.int_bitwidth < 32:
+        index = cast(index, tl.int32, builder)
+    ret = builder.create_gather(src.handle, index.handle, axis)
+    return tl.tensor(ret, tl.block_type(src.type.scalar, index.type.shape))
+
+
+# ===----------------------------------------------------------------------===
+#                               Sort
+# ===----------------------------------------------------------------------===
+
+
+def sort(input: tl.tensor, axis: int, descending: bool, builder: ir.builder) -> tl.tensor:
+    scalar_ty = input.type.scalar
+    assert scalar_ty.is_floating() or scalar_ty.is_int(), "sort only supports integer and floating point input"
+    assert axis < len(input.shape), f"axis {axis} is out of range for a {len(input.shape)}D input"
+    shape = input.shape[axis]
+    assert shape & (shape - 1) == 0, "sort only supports power of two sizes along the sorted axis"
+    # tt.sort compares floats natively and integers as signed. Floats without
+    # native arithmetic sort as fp32 and booleans as int8, where they are
+    # exactly representable, and flipping the sign bit maps unsigned integers
+    # to the signed order.
+    if scalar_ty.is_fp8() or scalar_ty.is_bf16() or scalar_ty.is_bool():
+        sort_ty = tl.int8 if scalar_ty.is_bool() else tl.float32
+        ret = sort(cast(input, sort_ty, builder), axis, descending, builder)
+        return cast(ret, scalar_ty, builder)
+    if scalar_ty.is_int_unsigned():
+        sign_bit = full(input.shape, 1 << (scalar_ty.int_bitwidth - 1), scalar_ty, builder)
+        input = xor_(input, sign_bit, builder)
+        ret = tl.tensor(builder.create_sort(input.handle, axis, descending), input.type)
+        return xor_(ret, sign_bit, builder)
+    return tl.tensor(builder.create_sort(input.handle, axis, descending), input.type)
+
+
+# ===----------------------------------------------------------------------===
+#                               Warp
+# ===----------------------------------------------------------------------===
+
+
+def _str_to_shuffle_kind(kind):
+    if kind == "idx":
+        return ir.SHUFFLE_KIND.IDX
+    if kind == "xor":
+        return ir.SHUFFLE_KIND.XOR
+    if kind == "up":
+        return ir.SHUFFLE_KIND.UP
+    if kind == "down":
+        return ir.SHUFFLE_KIND.DOWN
+    raise ValueError(f"Shuffle kind {kind} not supported")
+
+
+def _check_warp_operand(input: tl.tensor, name: str):
+    if not input.type.is_block():
+        raise ValueError(f"{name} only applies to tensors")
+    scalar_ty = input.type.scalar
+    if not (scalar_ty.is_floating() or scalar_ty.is_int()):
+        raise ValueError(f"{name} only supports integer and floating point input, got {scalar_ty}")
+
+
+def warp_shuffle(input: tl.tensor, lane: tl.tensor, kind: str, builder: ir.builder) -> tl.tensor:
+    _check_warp_operand(input, "warp shuffle")
+    if not lane.type.scalar.is_int():
+        raise ValueError(f"lane must be an integer, got {lane.type.scalar}")
+    lane = broadcast_impl_shape(cast(lane, tl.int32, builder), input.shape, builder)
+    if lane.shape != input.shape:
+        raise ValueError(f"lane shape {lane.shape} must match the input shape {input.shape}")
+    ret = builder.create_warp_shuffle(input.handle, lane.handle, _str_to_shuffle_kind(kind))
+    return tl.tensor(ret, input.type)
+
+
+def warp_ballot(pred: tl.tensor, builder: ir.builder) -> tl.tensor:
+    if not pred.type.is_block():
+        raise ValueError("warp ballot only applies to tensors")
+    pred = cast(pred, tl.int1, builder)
+    return tl.tensor(builder.create_warp_ballot(pred.handle), tl.block_type(tl.int32, pred.shape))
+
+
+def warp_reduction(input: tl.tensor, region_builder_fn, builder: ir.builder) -> tl.tensor:
+    _check_warp_operand(input, "warp reduce")
+    reduce_op = builder.create_warp_reduce(input.handle)
+    region_builder_fn(reduce_op)
+    reduce_op.verify()
+    return tl.tensor(reduce_op.get_result(0), input.type)
+
+
+def warp_scan(input: tl.tensor, region_builder_fn, builder: ir.builder) -> tl.tensor:
+    _check_warp_operand(input, "warp scan")
+    scan_op = builder.create_warp_scan(input.handle)
+    region_builder_fn(scan_op)
+    scan_op.verify()
+    return tl.tensor(scan_op.get_result(0), input.type)
+
+
 # ===----------------------------------------------------------------------===
 #                               Math
 # ===----------------------------------------------------------------------===
@@ -1,7 +1,7 @@
 from __future__ import annotations
 
 from ..runtime.jit import jit
-from . import core, math
+from . import core, math, semantic
 
 # -----------------------
 # Standard library
@@ -80,6 +80,30 @@ def swizzle2d(i, j, size_i, size_j, size_g):
     return new_i, new_j
 
 
+@jit
+def next_tile(tile, counter_ptr=None):
+    """
+    Returns the tile a program of a persistent kernel processes after :code:`tile`.
+    Each program starts with the tile of its id:
+
+        tile = tl.program_id(0)
+        while tile < num_tiles:
+            ...
+            tile = tl.next_tile(tile, counter_ptr)
+
+    Without :code:`counter_ptr`, programs step over the tiles of the others.
+    With it, the tiles after the first :code:`tl.num_programs(0)` ones go to the
+    programs in the order they ask for them, which balances tiles of uneven cost.
+
+    :param tile: the tile the program processed last
+    :param counter_ptr: pointer to an int32 counter, zero before the launch
+    """
+    if counter_ptr is None:
+        return tile + core.num_programs(0)
+    else:
+        return core.num_programs(0) + core.atomic_add(counter_ptr, 1)
+
+
 @jit
 def zeros(shape, dtype):
     """
@@ -135,6 +159,66 @@ def maximum(x, y, propagate_nan: core.constexpr = core.PropagateNan.NONE):
 # max and argmax
 
 
+# Values of 32 bits or less are reduced with their indices as a single 64-bit
+# key: the value, mapped to an unsigned integer of the same order, in the high
+# half and the index in the low one, so that reductions with indices shuffle
+# one operand instead of two. Equal values go to the lowest index.
+
+
+@jit
+def _to_ordered_bits(input):
+    if core.constexpr(input.dtype.is_floating()):
+        # +0.0 for -0.0, so that both zeros are equal
+        bits = (input + 0.0).to(core.uint32, bitcast=True)
+        bits = core.where((bits & 0x80000000) != 0, ~bits, bits | 0x80000000)
+    else:
+        bits = input.to(core.uint32, bitcast=True)
+        if core.constexpr(input.dtype.is_int_signed()):
+            bits = bits ^ 0x80000000
+    return bits
+
+
+@jit
+def _from_ordered_bits(bits, like):
+    # the inverse of `_to_ordered_bits` for values of the type of `like`
+    if core.constexpr(like.dtype.is_floating()):
+        bits = core.where((bits & 0x80000000) != 0, bits ^ 0x80000000, ~bits)
+    elif core.constexpr(like.dtype.is_int_signed()):
+        bits = bits ^ 0x80000000
+    return bits.to(like.dtype, bitcast=True)
+
+
+@jit
+def _reduce_with_packed_indices(input, axis, largest: core.constexpr, keep_dims):
+    original = input
+    if core.constexpr(input.dtype.primitive_bitwidth) < 32:
+        if core.constexpr(input.dtype.is_floating()):
+            input = input.to(core.float32)
+        elif core.constexpr(input.dtype.is_int_signed()):
+            input = input.to(core.int32)
+        else:
+            input = input.to(core.uint32)
+    bits = _to_ordered_bits(input)
+    index = core._indices_along(input, axis).to(core.uint32, bitcast=True)
+    if largest:
+        # NaNs are the largest values, and the lowest index the largest key
+        if core.constexpr(input.dtype.is_floating()):
+            bits = core.where(input != input, ~zeros_like(bits), bits)
+        index = ~index
+    elif core.constexpr(input.dtype.is_floating()):
+        bits = core.where(input != input, zeros_like(bits), bits)
+    key = (bits.to(core.uint64) << 32) | index.to(core.uint64)
+    if largest:
+        key = core.reduce(key, axis, maximum, keep_dims=keep_dims)
+    else:
+        key = core.reduce(key, axis, minimum, keep_dims=keep_dims)
+    index = key.to(core.uint32)
+    if largest:
+        index = ~index
+    value = _from_ordered_bits((key >> 32).to(core.uint32), input)
+    return value.to(original.dtype), index.to(core.int32, bitcast=True)
+
+
 @jit
 def _argmax_combine(value1, index1, value2, index2, tie_break_left):
     if tie_break_left:
@@ -163,7 +247,9 @@ def _argmax_combine_tie_break_fast(value1, index1, value2, index2):
 def max(input, axis=None, return_indices=False, return_indices_tie_break_left=True, keep_dims=False):
     input = core._promote_bfloat16_to_float32(input)
     if return_indices:
-        if return_indices_tie_break_left:
+        if core.constexpr(input.dtype.primitive_bitwidth) <= 32:
+            return _reduce_with_packed_indices(input, axis, True, keep_dims)
+        elif return_indices_tie_break_left:
             return core._reduce_with_indices(input, axis, _argmax_combine_tie_break_left, keep_dims=keep_dims)
         else:
             return core._reduce_with_indices(input, axis, _argmax_combine_tie_break_fast, keep_dims=keep_dims)
@@ -215,7 +301,9 @@ def _argmin_combine_tie_break_fast(value1, index1, value2, index2):
 def min(input, axis=None, return_indices=False, return_indices_tie_break_left=True, keep_dims=False):
     input = core._promote_bfloat16_to_float32(input)
     if return_indices:
-        if return_indices_tie_break_left:
+        if core.constexpr(input.dtype.primitive_bitwidth) <= 32:
+            return _reduce_with_packed_indices(input, axis, False, keep_dims)
+        elif return_indices_tie_break_left:
             return core._reduce_with_indices(input, axis, _argmin_combine_tie_break_left, keep_dims=keep_dims)
         else:
             return core._reduce_with_indices(input, axis, _argmin_combine_tie_break_fast, keep_dims=keep_dims)
@@ -281,6 +369,102 @@ def cumsum(input, axis=0):
     return core.associative_scan(input, axis, _sum_combine)
 
 
+@jit
+def _scan_state(value, flag: core.constexpr):
+    # the value in the low and the flag in the high 32 bits, so that a single
+    # atomic publishes both
+    return value.to(core.uint32, bitcast=True).to(core.int64) | (flag << 32)
+
+
+@jit
+def device_cumsum(input, tile, state_ptr):
+    """
+    Returns the cumulative sum of the 1D :code:`input` tensor with the ones of
+    the tiles before :code:`tile`, i.e. the tiles of an array scanned by the
+    programs of a single launch, each with its own tile:
+
+        tile = tl.atomic_add(counter_ptr, 1)
+        offsets = tile * BLOCK + tl.arange(0, BLOCK)
+        x = tl.load(X + offsets, mask=offsets < n, other=0)
+        tl.store(Z + offsets, tl.device_cumsum(x, tile, state_ptr), mask=offsets < n)
+
+    Each program publishes the sum of its tile, then adds up the ones of the
+    tiles before it, from the last, until it finds one whose programs already
+    published the sum of all the tiles up to it (decoupled lookback). Tiles
+    have to be numbered in the order programs start, e.g. from an atomic
+    counter as above: a program waiting for a tile whose program cannot start
+    never finishes. Float sums depend on where the lookbacks stop, so they may
+    differ between runs in the last bits.
+
+    :param input: the values of the tile, of a 32-bit type or bfloat16
+    :param tile: the position of the tile in the array, from 0
+    :param state_ptr: pointer to an int64 per tile, zero before the launch
+    """
+    input = core._promote_bfloat16_to_float32(input)
+    core.static_assert(input.dtype.primitive_bitwidth == 32, "device_cumsum only supports 32-bit types")
+    scan = core.associative_scan(input, 0, _sum_combine)
+    aggregate = core.reduce(input, 0, _sum_combine)
+    exclusive = core.full((), 0, aggregate.dtype)
+    if tile == 0:
+        core.atomic_xchg(state_ptr, _scan_state(aggregate, 2), sem="release")
+    else:
+        # flag 1: the sum of the tile only, 2: the sum of the tiles up to it
+        core.atomic_xchg(state_ptr + tile, _scan_state(aggregate, 1), sem="release")
+        predecessor = tile - 1
+        found = tile < 0
+        while not found:
+            state = core.atomic_add(state_ptr + predecessor, 0, sem="acquire")
+            flag = state >> 32
+            if flag != 0:
+                exclusive += state.to(core.uint32).to(aggregate.dtype, bitcast=True)
+                found = flag == 2
+                predecessor -= 1
+        core.atomic_xchg(state_ptr + tile, _scan_state(exclusive + aggregate, 2), sem="release")
+    return scan + exclusive
+
+
+@jit
+def grid_sync(barrier_ptr=None):
+    """
+    Waits until all the programs of the launch reach this point, and makes the
+    global memory writes of each of them before it visible to all of them
+    after it, so that the phases of a persistent kernel can run in a single
+    launch:
+
+        partial = ...
+        tl.store(partials + tl.program_id(0), partial)
+        tl.grid_sync(barrier_ptr)
+        total = tl.sum(tl.load(partials + tl.arange(0, NUM_PROGRAMS)))
+
+    All the programs have to be resident on the device at once, or the ones
+    waiting never let the others start: kernels calling it are launched with
+    :code:`cooperative=True`, which checks the grid against the programs of
+    the kernel the device can hold and raises :code:`OutOfResources` when it
+    is larger. All the programs have to call it the same number of times.
+
+    :param barrier_ptr: pointer to two int32, zero before the first launch;
+        they are left ready for the next barrier and the next launch. The
+        barrier is kept in :code:`tl.global_scratch` memory by default.
+    """
+    if barrier_ptr is None:
+        barrier_ptr = core.global_scratch(8).to(core.pointer_type(core.int32))
+    num_programs = core.num_programs(0) * core.num_programs(1) * core.num_programs(2)
+    # the writes of all the threads of the program come before its arrival
+    core.debug_barrier()
+    # the generation cannot change before this program arrives
+    generation = core.atomic_add(barrier_ptr + 1, 0, sem="acquire")
+    arrived = core.atomic_add(barrier_ptr, 1, sem="acq_rel")
+    if arrived == num_programs - 1:
+        # the last program resets the count before releasing the others
+        core.atomic_xchg(barrier_ptr, 0, sem="relaxed")
+        core.atomic_add(barrier_ptr + 1, 1, sem="release")
+    else:
+        released = False
+        while not released:
+            released = core.atomic_add(barrier_ptr + 1, 0, sem="acquire") != generation
+    core.debug_barrier()
+
+
 # cumprod
 
 
@@ -300,80 +484,6 @@ def cumprod(input, axis=0):
 # sort
 
 
-@jit
-def _indicator(n_dims: core.constexpr, idx: core.constexpr, pos: core.constexpr):
-    core.static_assert(idx < n_dims)
-    core.static_assert((pos == 0) or (pos == 1))
-    y = core.arange(0, 2)
-    if pos == 0:
-        y = 1 - y
-
-    for n in core.static_range(0, n_dims):
-        if n != n_dims - 1 - idx:
-            y = core.expand_dims(y, n)
-    return y
-
-
-@jit
-def _cast_to_int(x):
-    y = x
-    if x.dtype.is_floating():
-        if core.constexpr(x.dtype.primitive_bitwidth) == 16:
-            dtype_int = core.int16
-        elif core.constexpr(x.dtype.primitive_bitwidth) == 32:
-            dtype_int = core.int32
-        elif core.constexpr(x.dtype.primitive_bitwidth) == 64:
-            dtype_int = core.int64
-        else:
-            raise ValueError("Unsupported dtype")
-        y = x.to(dtype_int, bitcast=True)
-    return y
-
-
-@jit
-def _take_slice(x, n_dims: core.constexpr, idx: core.constexpr, pos: core.constexpr, keep_dim: core.constexpr = True):
-    y = sum(x * _indicator(n_dims, idx, pos).to(x.dtype), n_dims - 1 - idx)
-    if keep_dim:
-        y = core.expand_dims(y, n_dims - 1 - idx)
-
-    return y
-
-
-@jit
-def _compare_and_swap(x, desc_mask, n_dims: core.constexpr, idx: core.constexpr):
-    x_int = _cast_to_int(x)
-    l_int = _take_slice(x_int, n_dims, idx, 0)
-    r_int = _take_slice(x_int, n_dims, idx, 1)
-    l = l_int.to(x.dtype, bitcast=True)
-    r = r_int.to(x.dtype, bitcast=True)
-
-    desc_mask = desc_mask.to(x_int.dtype)
-    zero = zeros_like(x_int)
-    y = x_int ^ core.where((l > r) ^ desc_mask, l_int ^ r_int, zero)
-    y = y.to(x.dtype, bitcast=True)
-    return y
-
-
-@jit
-def _bitonic_merge(x, n_dims: core.constexpr, active_dims: core.constexpr, order_type: core.constexpr):
-    '''
-    order_type 0 == ascending
-    order_type 1 == descending
-    order_type 2 == alternating
-    '''
-    core.static_assert(active_dims <= n_dims)
-
-    if order_type == 2:
-        desc_mask = _indicator(n_dims, active_dims, 1)
-    else:
-        desc_mask = order_type
-
-    for i in core.static_range(active_dims):
-        x = _compare_and_swap(x, desc_mask, n_dims, active_dims - 1 - i)
-
-    return x
-
-
 def _log2(i: core.constexpr):
     log2 = 0
     n = i.value
@@ -397,23 +507,27 @@ def _get_sort_dim(dim, shape):
     shape = _unwrap_if_constexpr(shape)
     if dim is None:
         dim = len(shape) - 1
-    assert dim == len(shape) - 1, "Currently only support sorting on the last dimension"
+    if dim < 0:
+        dim += len(shape)
+    assert 0 <= dim < len(shape), f"Invalid sort dimension {dim} for a {len(shape)}D tensor"
     return core.constexpr(dim)
 
 
-@jit
-def sort(x, dim=None, descending: core.constexpr = 0):
-    core.static_assert(_is_power_of_two(x.shape[_get_sort_dim(dim, x.shape)]))
-    core.static_assert(_is_power_of_two(x.numel))
-    # reshape the tensor to have all dimensions be 2.
-    # TODO: We shouldn't have to change the dimensions not sorted.
-    y = core.reshape(x, [2] * _log2(x.numel))
-    for i in core.static_range(1, _log2(x.shape[_get_sort_dim(dim, x.shape)]) + 1):
-        y = _bitonic_merge(y, _log2(x.numel), i, (descending if
-                                                  (i == _log2(x.shape[_get_sort_dim(dim, x.shape)])) else 2))
+@core.builtin
+def sort(x, dim=None, descending: core.constexpr = 0, _builder=None, _generator=None):
+    """
+    Sorts a tensor `x` along the dimension `dim`.
 
-    x = core.reshape(y, x.shape)
-    return x
+    :param x: the input tensor
+    :type x: Block
+    :param dim: the dimension to sort along, the last one by default. Its size must be a power of two.
+    :type dim: int
+    :param descending: whether to sort in descending order
+    :type descending: bool
+    """
+    dim = _get_sort_dim(dim, x.shape)
+    descending = core._constexpr_to_value(descending)
+    return semantic.sort(x, dim.value, bool(descending), _builder)
 
 
 def _get_flip_dim(dim, shape):
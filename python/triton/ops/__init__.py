@@ -1,7 +1,19 @@
 # from .conv import _conv, conv
 from . import blocksparse
-from .cross_entropy import _cross_entropy, cross_entropy
-from .flash_attention import attention
+from .collectives import PeerGroup, all_gather, all_reduce
+from .cross_entropy import _cross_entropy, cross_entropy, linear_cross_entropy
+from .flash_attention import attention, attention_varlen
+from .grouped_matmul import grouped_matmul
+from .int8_matmul import int8_matmul
 from .matmul import _matmul, get_higher_dtype, matmul
+from .norm import layer_norm, rms_norm
+from .paged_attention import paged_attention
+from .quantized_matmul import quantized_matmul
+from .rotary import rotary_kv_append
+from .sampling import sample
 
-__all__ = ["blocksparse", "_cross_entropy", "cross_entropy", "_matmul", "matmul", "attention", "get_higher_dtype"]
+__all__ = [
+    "blocksparse", "_cross_entropy", "cross_entropy", "linear_cross_entropy", "_matmul", "matmul", "attention",
+    "attention_varlen", "get_higher_dtype", "paged_attention", "grouped_matmul", "int8_matmul", "quantized_matmul",
+    "layer_norm", "rms_norm", "rotary_kv_append", "sample", "PeerGroup", "all_reduce", "all_gather"
+]
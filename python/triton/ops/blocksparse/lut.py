@@ -0,0 +1,78 @@
+import hashlib
+from collections import OrderedDict
+
+import torch
+
+from ... import jit, next_power_of_2
+from ... import language as tl
+
+# --------------------------------------------------------
+# Look-up tables of the block-sparse ops are built on the
+# device, and cached by layout so that ops whose layout
+# changes between steps do not rebuild them.
+# --------------------------------------------------------
+
+LUT_CACHE_SIZE = 64
+_lut_cache = OrderedDict()
+
+
+def layout_key(layout):
+    """A digest of the shape and non-zero blocks of `layout`."""
+    data = (layout != 0).to(torch.uint8).cpu().contiguous()
+    digest = hashlib.sha256(data.numpy().tobytes()).hexdigest()
+    return (tuple(layout.shape), digest)
+
+
+def cached_lut(build, layout, *args):
+    """Returns `build(layout, *args)`, computed once per layout and arguments."""
+    key = (build.__qualname__, layout_key(layout)) + args
+    if key in _lut_cache:
+        _lut_cache.move_to_end(key)
+        return _lut_cache[key]
+    lut = build(layout, *args)
+    _lut_cache[key] = lut
+    if len(_lut_cache) > LUT_CACHE_SIZE:
+        _lut_cache.popitem(last=False)
+    return lut
+
+
+@jit
+def _nonzero_kernel(LAYOUT, ROW_OFFSETS, OUT,  #
+                    stride_h, stride_m, stride_n,  #
+                    M, N,  #
+                    BLOCK_N: tl.constexpr  #
+                    ):
+    row = tl.program_id(0)
+    h = row // M
+    m = row % M
+    offset = tl.load(ROW_OFFSETS + row)
+    for start in range(0, N, BLOCK_N):
+        n = start + tl.arange(0, BLOCK_N)
+        nz = tl.load(LAYOUT + h * stride_h + m * stride_m + n * stride_n, mask=n < N, other=0) != 0
+        # the non-zeros of the row are compacted in order
+        nz = nz.to(tl.int32)
+        pos = offset + tl.cumsum(nz, 0) - nz
+        tl.store(OUT + pos * 3 + 0, h, mask=nz != 0)
+        tl.store(OUT + pos * 3 + 1, m, mask=nz != 0)
+        tl.store(OUT + pos * 3 + 2, n, mask=nz != 0)
+        offset += tl.sum(nz, 0)
+
+
+def nonzero(layout):
+    """
+    The indices of the non-zero blocks of the 3D `layout`, as an int32 tensor of
+    shape `(num_nonzero, 3)` ordered as those of `layout.nonzero()`.
+    """
+    H, M, N = layout.shape
+    sizes = (layout != 0).sum(-1, dtype=torch.int32).flatten()
+    offsets = torch.zeros_like(sizes)
+    offsets[1:] = torch.cumsum(sizes[:-1], dim=0)
+    out = torch.empty((int(sizes.sum()), 3), dtype=torch.int32, device=layout.device)
+    if H * M > 0 and out.numel() > 0:
+        _nonzero_kernel[(H * M, )](
+            layout, offsets, out,  #
+            layout.stride(0), layout.stride(1), layout.stride(2),  #
+            M, N,  #
+            BLOCK_N=min(next_power_of_2(N), 1024)  #
+        )
+    return out
@@ -2,6 +2,7 @@ import torch
 
 from ... import cdiv, heuristics, jit
 from ... import language as tl
+from .lut import cached_lut, nonzero
 
 # ********************************************************
 # --------------------------------------------------------
@@ -115,8 +116,7 @@ def sdd_matmul(a, b, trans_a, trans_b, trans_c, spdims, block, lut, widths, out=
 
 
 def sdd_lut(layout, block, device):
-    lut = layout.nonzero(as_tuple=False).to(device).int()
-    lut = lut.contiguous()
+    lut = nonzero(layout.to(device))
     return lut, None
 
 
@@ -264,15 +264,16 @@ def dsd_lut(layout, block, step, trans, device):
     [32, 48, 64, 80]  <- row 1
     [0, 16, 64, 80]   <- row 2
     """
+    layout = layout.to(device)
     sizes = torch.sum(layout, 2 if trans else 1)
     head_id, col_id = torch.ones_like(sizes).nonzero(as_tuple=True)
     sizes = sizes.flatten()
     segments = sizes * step
     # pointer increments
     if trans:
-        nnz = layout.nonzero(as_tuple=False)
+        nnz = nonzero(layout).long()
     else:
-        nnz = layout.transpose(1, 2).nonzero(as_tuple=False)
+        nnz = nonzero(layout.transpose(1, 2)).long()
     num_blocks = nnz.size(0)
     offsets = torch.zeros_like(sizes)
     offsets[1:] = torch.cumsum(sizes[:-1], dim=0)
@@ -300,14 +301,10 @@ def dsd_lut(layout, block, step, trans, device):
     if trans:
         A_idx = torch.arange(num_blocks, device=layout.device)
     else:
-        A_idx = torch.tensor([], dtype=torch.int64, device=layout.device)
-        current_offset = 0
-        for z in range(layout.size(0)):
-            layoutw = layout[z, :, :].clone().long()
-            msum = layoutw.sum()
-            layoutw[layoutw > 0] = 1 + torch.arange(msum, device=layout.device)
-            A_idx = torch.cat((A_idx, current_offset + layoutw.T[layoutw.T > 0] - 1))
-            current_offset += msum
+        # index of each block in the sparse memory layout, i.e. in row-major
+        # order, enumerated in column-major order
+        rank = torch.cumsum((layout != 0).flatten().long(), dim=0).view(layout.shape) - 1
+        A_idx = rank.transpose(1, 2)[layout.transpose(1, 2) != 0]
     A_incs = A_idx * block * block
     A_incs[1:] -= A_idx[:-1] * block * block
     A_incs = A_incs.view(-1, 1).repeat(1, div)
@@ -407,21 +404,30 @@ class matmul:
         self.trans_a = trans_a
         self.trans_b = trans_b
         self.trans_c = trans_c
+        self.device = device
+        self.set_layout(layout)
+
+    def set_layout(self, layout):
+        """
+        Changes the layout of the sparse operand, e.g. between steps with dynamic
+        sparsity. The look-up tables of layouts seen before are reused.
+        """
+        block, device = self.block, self.device
         self.layout = layout
         self.spdims = layout.shape
         step = min(block, 32)
         if self.mode == 'sdd':
-            self.c_lut, self.c_width = sdd_lut(layout, block, device)
-            self.da_lut, self.da_width = dsd_lut(layout, block, step, True, device)
-            self.db_lut, self.db_width = dsd_lut(layout, block, step, False, device)
+            self.c_lut, self.c_width = cached_lut(sdd_lut, layout, block, device)
+            self.da_lut, self.da_width = cached_lut(dsd_lut, layout, block, step, True, device)
+            self.db_lut, self.db_width = cached_lut(dsd_lut, layout, block, step, False, device)
         if self.mode == 'dsd':
-            self.c_lut, self.c_width = dsd_lut(layout, block, step, not self.trans_a, device)
-            self.da_lut, self.da_width = sdd_lut(layout, block, device)
-            self.db_lut, self.db_width = dsd_lut(layout, block, step, self.trans_a, device)
+            self.c_lut, self.c_width = cached_lut(dsd_lut, layout, block, step, not self.trans_a, device)
+            self.da_lut, self.da_width = cached_lut(sdd_lut, layout, block, device)
+            self.db_lut, self.db_width = cached_lut(dsd_lut, layout, block, step, self.trans_a, device)
         if self.mode == 'dds':
-            self.c_lut, self.c_width = dsd_lut(layout, block, step, self.trans_b, device)
-            self.da_lut, self.da_width = dsd_lut(layout, block, step, not self.trans_b, device)
-            self.db_lut, self.db_width = sdd_lut(layout, block, device)
+            self.c_lut, self.c_width = cached_lut(dsd_lut, layout, block, step, self.trans_b, device)
+            self.da_lut, self.da_width = cached_lut(dsd_lut, layout, block, step, not self.trans_b, device)
+            self.db_lut, self.db_width = cached_lut(sdd_lut, layout, block, device)
 
     def __call__(self, a, b, out=None):
         c = _matmul.apply(a, b, self.trans_a, self.trans_b, self.trans_c, self.mode, self.spdims, self.block,  #
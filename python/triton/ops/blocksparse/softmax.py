@@ -3,6 +3,7 @@ import torch
 from ... import jit
 from ... import language as tl
 from ... import next_power_of_2
+from .lut import cached_lut, nonzero
 
 
 def num_warps(n):
@@ -133,19 +134,17 @@ class _softmax(torch.autograd.Function):
 
     @staticmethod
     def make_lut(layout, block, device):
-        _empty = torch.tensor([], dtype=torch.int64, device=layout.device)
-        sizes = _empty.clone()
+        layout = layout.to(device)
         # sizes along rows
-        for h in range(layout.shape[0]):
-            sizes = torch.cat((sizes, layout[h, :, :].sum(-1)))
+        sizes = layout.sum(-1).flatten()
         total_sizes = sizes * block
         # offsets in block format
         offsets = torch.zeros_like(sizes)
         offsets[1:] = torch.cumsum(sizes[:-1], dim=0)
         # block indices
-        columns = layout.nonzero(as_tuple=False)[:, 2]
+        columns = nonzero(layout)[:, 2]
         header = torch.stack((sizes, offsets), dim=1).view(-1)
-        lut = torch.cat((header, columns)).type(torch.int32).to(device)
+        lut = torch.cat((header.type(torch.int32), columns))
         return lut, int(total_sizes.max())
 
     @staticmethod
@@ -214,11 +213,16 @@ class _softmax(torch.autograd.Function):
 class softmax:
 
     def __init__(self, layout, block, device, is_dense=False):
-        self.spdims = layout.shape
-        self.layout = layout
         self.block = block
-        self.lut, self.maxlut = _softmax.make_lut(self.layout, self.block, device)
+        self.device = device
         self.is_dense = is_dense
+        self.set_layout(layout)
+
+    def set_layout(self, layout):
+        """Changes the layout of the op. The look-up tables of layouts seen before are reused."""
+        self.spdims = layout.shape
+        self.layout = layout
+        self.lut, self.maxlut = cached_lut(_softmax.make_lut, layout, self.block, self.device)
 
     def __call__(self, a, *, scale=1.0, rel_logits=None, is_causal=False):
         if rel_logits is not None and rel_logits.dtype != a.dtype:
@@ -0,0 +1,182 @@
+"""
+Collectives
+===========
+All-reduce and all-gather across a group of devices, one rank per device, that
+read each other's memory directly over the peer links (Xe Link on Intel GPUs,
+NVLink on NVIDIA GPUs). Each rank copies its input to a buffer the peers have
+mapped, and a single launch per rank reads the buffers of all the ranks. The
+programs of the ranks synchronize through flags in the memory of each rank,
+so the launches of the ranks have to run at the same time: every rank calls
+the same collectives in the same order, with inputs of the same size.
+"""
+
+import torch
+
+from .. import cdiv, jit
+from .. import language as tl
+from ..language.extra import signal
+from ..runtime import driver
+
+# most programs of a collective launch, which each have a flag per peer
+MAX_PROGRAMS = 64
+
+
+@jit
+def _peer_barrier(SIGNALS, rank, epoch, PHASE: tl.constexpr, WORLD: tl.constexpr, MAX_PROGRAMS: tl.constexpr):
+    # program `pid` of every rank waits for program `pid` of the others: the
+    # programs of all the ranks read and write the same blocks
+    pid = tl.program_id(0)
+    slot = (PHASE * MAX_PROGRAMS + pid) * WORLD
+    for peer in tl.static_range(WORLD):
+        peer_signals = tl.load(SIGNALS + peer).to(tl.pointer_type(tl.int32))
+        signal.notify(peer_signals + slot + rank, epoch)
+    signals = tl.load(SIGNALS + rank).to(tl.pointer_type(tl.int32))
+    for peer in tl.static_range(WORLD):
+        signal.wait(signals + slot + peer, epoch)
+
+
+@jit
+def _all_reduce_kernel(OUT, BUFFERS, SIGNALS, rank, epoch, N,  #
+                       WORLD: tl.constexpr, MAX_PROGRAMS: tl.constexpr, BLOCK: tl.constexpr  #
+                       ):
+    # the inputs of all the ranks are in their buffers
+    _peer_barrier(SIGNALS, rank, epoch, 0, WORLD, MAX_PROGRAMS)
+    dtype = OUT.dtype.element_ty
+    for start in range(tl.program_id(0) * BLOCK, N, tl.num_programs(0) * BLOCK):
+        offs = start + tl.arange(0, BLOCK)
+        mask = offs < N
+        acc = tl.zeros((BLOCK, ), dtype=tl.float32)
+        for peer in tl.static_range(WORLD):
+            x = tl.load(BUFFERS + peer).to(tl.pointer_type(dtype))
+            acc += tl.load(x + offs, mask=mask, other=0).to(tl.float32)
+        tl.store(OUT + offs, acc.to(dtype), mask=mask)
+    # no rank writes its buffer again before the others are done reading it
+    _peer_barrier(SIGNALS, rank, epoch, 1, WORLD, MAX_PROGRAMS)
+
+
+@jit
+def _all_gather_kernel(OUT, BUFFERS, SIGNALS, rank, epoch, N,  #
+                       WORLD: tl.constexpr, MAX_PROGRAMS: tl.constexpr, BLOCK: tl.constexpr  #
+                       ):
+    _peer_barrier(SIGNALS, rank, epoch, 0, WORLD, MAX_PROGRAMS)
+    dtype = OUT.dtype.element_ty
+    for start in range(tl.program_id(0) * BLOCK, N, tl.num_programs(0) * BLOCK):
+        offs = start + tl.arange(0, BLOCK)
+        mask = offs < N
+        for peer in tl.static_range(WORLD):
+            x = tl.load(BUFFERS + peer).to(tl.pointer_type(dtype))
+            tl.store(OUT + peer * N + offs, tl.load(x + offs, mask=mask), mask=mask)
+    _peer_barrier(SIGNALS, rank, epoch, 1, WORLD, MAX_PROGRAMS)
+
+
+class PeerGroup:
+    """
+    The buffers and flags of one rank of a group, and the addresses at which
+    this rank reaches those of every rank.
+
+    :param rank: the rank of this process (or device) in the group.
+    :param buffer: the uint8 tensor holding the input of this rank.
+    :param signals: the int32 tensor of flags of this rank, :code:`signal_size`
+        zeros before the first collective.
+    :param buffer_ptrs: the address of the buffer of each rank, mapped in this
+        process.
+    :param signal_ptrs: the address of the flags of each rank.
+    """
+
+    def __init__(self, rank, buffer, signals, buffer_ptrs, signal_ptrs):
+        assert len(buffer_ptrs) == len(signal_ptrs) and 0 <= rank < len(buffer_ptrs)
+        assert buffer_ptrs[rank] == buffer.data_ptr() and signal_ptrs[rank] == signals.data_ptr()
+        assert signals.numel() >= PeerGroup.signal_size(len(buffer_ptrs))
+        self.rank = rank
+        self.world_size = len(buffer_ptrs)
+        self.buffer = buffer
+        self.signals = signals
+        self.buffer_ptrs = torch.tensor(buffer_ptrs, dtype=torch.int64, device=buffer.device)
+        self.signal_ptrs = torch.tensor(signal_ptrs, dtype=torch.int64, device=buffer.device)
+        # the value of the flags of the current collective, the same on all
+        # the ranks as they run the same collectives
+        self.epoch = 0
+        self._mapped = []
+
+    @staticmethod
+    def signal_size(world_size):
+        return 2 * MAX_PROGRAMS * world_size
+
+    @staticmethod
+    def create(rank, world_size, nbytes, exchange, device=None):
+        """
+        Allocates the buffer and flags of this rank and maps those of the
+        other ranks, each running in its own process.
+
+        :param exchange: a function returning the list of the objects each
+            rank passes it, e.g. built on :code:`torch.distributed.all_gather_object`.
+        """
+        buffer = torch.empty((nbytes, ), dtype=torch.uint8, device=device)
+        signals = torch.zeros((PeerGroup.signal_size(world_size), ), dtype=torch.int32, device=device)
+        # the flags are zero before any peer can set them
+        getattr(torch, signals.device.type).synchronize()
+        handles = exchange((driver.active.get_ipc_handle(buffer.data_ptr()),
+                            driver.active.get_ipc_handle(signals.data_ptr())))
+        assert len(handles) == world_size
+        buffer_ptrs, signal_ptrs, mapped = [], [], []
+        for peer, peer_handles in enumerate(handles):
+            if peer == rank:
+                buffer_ptrs.append(buffer.data_ptr())
+                signal_ptrs.append(signals.data_ptr())
+                continue
+            for handle, ptrs in zip(peer_handles, (buffer_ptrs, signal_ptrs)):
+                base, ptr = driver.active.open_ipc_handle(handle)
+                mapped.append(base)
+                ptrs.append(ptr)
+        group = PeerGroup(rank, buffer, signals, buffer_ptrs, signal_ptrs)
+        group._mapped = mapped
+        return group
+
+    def close(self):
+        """Unmaps the memory of the other ranks, once no collective uses it."""
+        for base in self._mapped:
+            driver.active.close_ipc_handle(base)
+        self._mapped = []
+
+    def tensor(self, shape, dtype):
+        """A tensor in the buffer of this rank, which collectives read without a copy."""
+        numel = 1
+        for dim in shape:
+            numel *= dim
+        nbytes = numel * dtype.itemsize
+        assert nbytes <= self.buffer.numel(), "the buffer of the group is too small"
+        return self.buffer[:nbytes].view(dtype).view(shape)
+
+    def _stage(self, x):
+        if x.data_ptr() != self.buffer.data_ptr():
+            self.tensor(x.shape, x.dtype).copy_(x)
+        self.epoch += 1
+        return x.numel()
+
+    def _launch(self, kernel, out, n):
+        block = 1024
+        device = driver.active.get_current_device()
+        num_cores = driver.active.utils.get_device_properties(device)["multiprocessor_count"]
+        grid = (max(1, min(MAX_PROGRAMS, num_cores, cdiv(n, block))), )
+        kernel[grid](out, self.buffer_ptrs, self.signal_ptrs, self.rank, self.epoch, n,  #
+                     WORLD=self.world_size, MAX_PROGRAMS=MAX_PROGRAMS, BLOCK=block, cooperative=True)
+
+
+def all_reduce(x, group):
+    """
+    The sum of :code:`x` over the ranks of :code:`group`, accumulated in
+    float32. :code:`x` is copied to the buffer of the group, unless it is
+    :code:`group.tensor(...)`.
+    """
+    n = group._stage(x)
+    out = torch.empty_like(x)
+    group._launch(_all_reduce_kernel, out, n)
+    return out
+
+
+def all_gather(x, group):
+    """The :code:`x` of every rank of :code:`group`, stacked along a new first dimension."""
+    n = group._stage(x)
+    out = torch.empty((group.world_size, ) + tuple(x.shape), dtype=x.dtype, device=x.device)
+    group._launch(_all_gather_kernel, out, n)
+    return out
@@ -58,6 +58,52 @@ def _backward(PROBS, IDX, DPROBS, N, BLOCK: tl.constexpr):
     tl.store(PROBS, din.to(PROBS.dtype.element_ty), mask=cols < N)
 
 
+# rows longer than this are processed in chunks of it, without storing their probabilities
+CHUNK = 4096
+
+
+@heuristics({'num_warps': lambda nargs: num_warps(nargs['BLOCK'])})
+@heuristics({'BLOCK': lambda nargs: min(next_power_of_2(nargs['N']), CHUNK)})
+@jit
+def _forward_chunked(LOGITS, IDX, LOSS, LSE, N, stride, BLOCK: tl.constexpr):
+    row = tl.program_id(0)
+    cols = tl.arange(0, BLOCK)
+    idx = tl.load(IDX + row)
+    LOGITS = LOGITS + row.to(tl.int64) * stride
+    # online log-sum-exp over the chunks of the row; the first chunk holds
+    # at least one logit, after which m is finite
+    m = -float('inf')
+    s = 0.
+    for start in range(0, N, BLOCK):
+        logits = tl.load(LOGITS + start + cols, mask=start + cols < N, other=-float('inf')).to(tl.float32)
+        m_new = tl.maximum(m, tl.max(logits, 0))
+        s = s * tl.exp(m - m_new) + tl.sum(tl.exp(logits - m_new), 0)
+        m = m_new
+    lse = m + tl.log(s)
+    tl.store(LSE + row, lse)
+    tl.store(LOSS + row, lse - tl.load(LOGITS + idx).to(tl.float32))
+
+
+@heuristics({'num_warps': lambda nargs: num_warps(nargs['BLOCK'])})
+@heuristics({'BLOCK': lambda nargs: min(next_power_of_2(nargs['N']), CHUNK)})
+@jit
+def _backward_chunked(LOGITS, IDX, LSE, DLOSS, DLOGITS, N, stride, BLOCK: tl.constexpr):
+    row = tl.program_id(0)
+    cols = tl.arange(0, BLOCK)
+    idx = tl.load(IDX + row)
+    lse = tl.load(LSE + row)
+    dout = tl.load(DLOSS + row).to(tl.float32)
+    # DLOGITS may alias LOGITS: each chunk is read before it is written
+    LOGITS = LOGITS + row.to(tl.int64) * stride
+    DLOGITS = DLOGITS + row.to(tl.int64) * stride
+    for start in range(0, N, BLOCK):
+        mask = start + cols < N
+        logits = tl.load(LOGITS + start + cols, mask=mask, other=0.).to(tl.float32)
+        probs = tl.exp(logits - lse)
+        din = (probs - (start + cols == idx)) * dout
+        tl.store(DLOGITS + start + cols, din.to(DLOGITS.dtype.element_ty), mask=mask)
+
+
 class _cross_entropy(torch.autograd.Function):
 
     @classmethod
@@ -69,8 +115,15 @@ class _cross_entropy(torch.autograd.Function):
         n_cols = logits.shape[-1]
         # run the kernel
         result = torch.empty_like(indices, dtype=dtype, device=device)
-        neg_logprobs = torch.empty_like(logits, dtype=dtype, device=device)
         grid = lambda opt: (logits.numel() // n_cols, )
+        if n_cols > CHUNK:
+            # recompute the probabilities in the backward pass rather than storing them
+            logits = logits.contiguous()
+            lse = torch.empty_like(indices, dtype=torch.float32, device=device)
+            _forward_chunked[grid](logits, indices, result, lse, n_cols, n_cols)
+            ctx.save_for_backward(logits, indices, lse)
+            return result
+        neg_logprobs = torch.empty_like(logits, dtype=dtype, device=device)
         _forward[grid](logits, neg_logprobs, indices, result, n_cols)
         # save for backward
         ctx.save_for_backward(neg_logprobs, indices)
@@ -83,6 +136,13 @@ class _cross_entropy(torch.autograd.Function):
         to get p[k], which is most of what we need...  neg_logprobs will be
         modified in place to become the gradient we want
         """
+        if len(ctx.saved_tensors) == 3:
+            logits, indices, lse = ctx.saved_tensors
+            n_cols = logits.shape[-1]
+            dlogits = torch.empty_like(logits)
+            grid = lambda opt: (logits.numel() // n_cols, )
+            _backward_chunked[grid](logits, indices, lse, dneg_logprobs.contiguous(), dlogits, n_cols, n_cols)
+            return dlogits, None
         # load saved tensors
         neg_logprobs, indices = ctx.saved_tensors
         # run the kernel
@@ -94,3 +154,54 @@ class _cross_entropy(torch.autograd.Function):
 
 
 cross_entropy = _cross_entropy.apply
+
+
+class _linear_cross_entropy(torch.autograd.Function):
+
+    @staticmethod
+    def forward(ctx, hidden, weight, indices, chunk_size):
+        assert (indices.dtype == torch.int64), "Indices are expected to be of type long."
+        assert hidden.dim() == 2 and weight.dim() == 2 and hidden.shape[1] == weight.shape[1]
+        hidden = hidden.contiguous()
+        n_rows, n_cols = hidden.shape[0], weight.shape[0]
+        result = torch.empty((n_rows, ), dtype=hidden.dtype, device=hidden.device)
+        lse = torch.empty((n_rows, ), dtype=torch.float32, device=hidden.device)
+        # only `chunk_size` rows of logits exist at a time
+        for start in range(0, n_rows, chunk_size):
+            end = min(start + chunk_size, n_rows)
+            logits = torch.matmul(hidden[start:end], weight.t())
+            _forward_chunked[(end - start, )](logits, indices[start:end], result[start:end], lse[start:end], n_cols,
+                                              n_cols)
+        ctx.save_for_backward(hidden, weight, indices, lse)
+        ctx.chunk_size = chunk_size
+        return result
+
+    @staticmethod
+    def backward(ctx, dloss):
+        hidden, weight, indices, lse = ctx.saved_tensors
+        dloss = dloss.contiguous()
+        n_rows, n_cols = hidden.shape[0], weight.shape[0]
+        dhidden = torch.empty_like(hidden)
+        dweight = torch.zeros_like(weight, dtype=torch.float32)
+        # the logits are recomputed, and overwritten by their gradient
+        for start in range(0, n_rows, ctx.chunk_size):
+            end = min(start + ctx.chunk_size, n_rows)
+            logits = torch.matmul(hidden[start:end], weight.t())
+            _backward_chunked[(end - start, )](logits, indices[start:end], lse[start:end], dloss[start:end], logits,
+                                               n_cols, n_cols)
+            dhidden[start:end] = torch.matmul(logits, weight)
+            dweight += torch.matmul(logits.t(), hidden[start:end]).float()
+        return dhidden, dweight.to(weight.dtype), None, None
+
+
+def linear_cross_entropy(hidden, weight, indices, chunk_size=1024):
+    """
+    The cross-entropy loss of the logits `hidden @ weight.T` of each row, as
+    `cross_entropy(torch.matmul(hidden, weight.t()), indices)`, without storing the
+    logits of more than `chunk_size` rows at a time, in the forward or the backward pass.
+
+    :param hidden: the inputs of the projection, of shape `(n_rows, hidden_size)`.
+    :param weight: the projection, of shape `(vocab_size, hidden_size)`.
+    :param indices: the target of each row, an int64 tensor of shape `(n_rows, )`.
+    """
+    return _linear_cross_entropy.apply(hidden, weight, indices, chunk_size)
@@ -109,6 +109,118 @@ def _fwd_kernel(Q, K, V, sm_scale,  #
     tl.store(O_block_ptr, acc.to(K.dtype.element_ty))
 
 
+@jit
+def _fwd_kernel_varlen(Q, K, V, sm_scale,  #
+                       Out,  #
+                       Cu_seqlens_q, Cu_seqlens_k,  #
+                       Block_mask,  #
+                       stride_qm, stride_qh, stride_qk,  #
+                       stride_kn, stride_kh, stride_kk,  #
+                       stride_vn, stride_vh, stride_vk,  #
+                       stride_om, stride_oh, stride_on,  #
+                       stride_bz, stride_bh, stride_bm, stride_bn,  #
+                       H, window_left, window_right,  #
+                       BLOCK_M: tl.constexpr, BLOCK_DMODEL: tl.constexpr,  #
+                       BLOCK_N: tl.constexpr,  #
+                       HAS_WINDOW: tl.constexpr, HAS_BLOCK_MASK: tl.constexpr  #
+                       ):
+    start_m = tl.program_id(0)
+    off_hz = tl.program_id(1)
+    off_z = off_hz // H
+    off_h = off_hz % H
+    q_start = tl.load(Cu_seqlens_q + off_z)
+    q_len = tl.load(Cu_seqlens_q + off_z + 1) - q_start
+    if start_m * BLOCK_M >= q_len:
+        return
+    k_start = tl.load(Cu_seqlens_k + off_z)
+    k_len = tl.load(Cu_seqlens_k + off_z + 1) - k_start
+    # queries are aligned to the end of the keys, query i sees the keys
+    # [i + diag - window_left, i + diag + window_right]
+    diag = k_len - q_len
+    lo = 0
+    hi = k_len
+    if HAS_WINDOW:
+        # skip the blocks of keys outside of the window of every query of the block
+        lo = tl.maximum(start_m * BLOCK_M + diag - window_left, 0) // BLOCK_N * BLOCK_N
+        hi = tl.minimum((start_m + 1) * BLOCK_M + diag + window_right, k_len)
+
+    Q_block_ptr = tl.make_block_ptr(
+        base=Q + q_start * stride_qm + off_h * stride_qh,
+        shape=(q_len, BLOCK_DMODEL),
+        strides=(stride_qm, stride_qk),
+        offsets=(start_m * BLOCK_M, 0),
+        block_shape=(BLOCK_M, BLOCK_DMODEL),
+        order=(1, 0),
+    )
+    K_block_ptr = tl.make_block_ptr(
+        base=K + k_start * stride_kn + off_h * stride_kh,
+        shape=(BLOCK_DMODEL, k_len),
+        strides=(stride_kk, stride_kn),
+        offsets=(0, lo),
+        block_shape=(BLOCK_DMODEL, BLOCK_N),
+        order=(0, 1),
+    )
+    V_block_ptr = tl.make_block_ptr(
+        base=V + k_start * stride_vn + off_h * stride_vh,
+        shape=(k_len, BLOCK_DMODEL),
+        strides=(stride_vn, stride_vk),
+        offsets=(lo, 0),
+        block_shape=(BLOCK_N, BLOCK_DMODEL),
+        order=(1, 0),
+    )
+    offs_m = start_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_n = tl.arange(0, BLOCK_N)
+    m_i = tl.zeros([BLOCK_M], dtype=tl.float32) - float("inf")
+    l_i = tl.zeros([BLOCK_M], dtype=tl.float32)
+    acc = tl.zeros([BLOCK_M, BLOCK_DMODEL], dtype=tl.float32)
+    qk_scale = sm_scale * 1.44269504
+    q = tl.load(Q_block_ptr, boundary_check=(0, ), padding_option="zero")
+    q = (q * qk_scale).to(K.dtype.element_ty)
+    Block_mask += off_z * stride_bz + off_h * stride_bh + start_m * stride_bm
+    for start_n in range(lo, hi, BLOCK_N):
+        visible = True
+        if HAS_BLOCK_MASK:
+            visible = tl.load(Block_mask + (start_n // BLOCK_N) * stride_bn) != 0
+        if visible:
+            # -- load k, v --
+            k = tl.load(K_block_ptr, boundary_check=(1, ), padding_option="zero")
+            v = tl.load(V_block_ptr, boundary_check=(0, ), padding_option="zero")
+            # -- compute qk ---
+            qk = tl.dot(q, k, allow_tf32=True)
+            offs_k = start_n + offs_n
+            mask = (offs_k < k_len)[None, :]
+            if HAS_WINDOW:
+                mask = mask & (offs_k[None, :] >= offs_m[:, None] + diag - window_left)
+                mask = mask & (offs_k[None, :] <= offs_m[:, None] + diag + window_right)
+            qk = tl.where(mask, qk, float("-inf"))
+            # -- compute scaling constant ---
+            # rows without any visible key so far have no weight
+            m_i_new = tl.maximum(m_i, tl.max(qk, 1))
+            m_i_safe = tl.where(m_i_new == float("-inf"), 0., m_i_new)
+            alpha = tl.math.exp2(m_i - m_i_safe)
+            p = tl.math.exp2(qk - m_i_safe[:, None])
+            # -- scale and update acc --
+            acc *= alpha[:, None]
+            acc += tl.dot(p.to(V.dtype.element_ty), v, allow_tf32=True)
+            # -- update m_i and l_i --
+            l_i = l_i * alpha + tl.sum(p, 1)
+            m_i = m_i_new
+        # update pointers
+        K_block_ptr = tl.advance(K_block_ptr, (0, BLOCK_N))
+        V_block_ptr = tl.advance(V_block_ptr, (BLOCK_N, 0))
+    # queries that see no key attend to nothing
+    acc = acc / tl.where(l_i == 0., 1., l_i)[:, None]
+    O_block_ptr = tl.make_block_ptr(
+        base=Out + q_start * stride_om + off_h * stride_oh,
+        shape=(q_len, BLOCK_DMODEL),
+        strides=(stride_om, stride_on),
+        offsets=(start_m * BLOCK_M, 0),
+        block_shape=(BLOCK_M, BLOCK_DMODEL),
+        order=(1, 0),
+    )
+    tl.store(O_block_ptr, acc.to(K.dtype.element_ty), boundary_check=(0, ))
+
+
 @jit
 def _bwd_preprocess(
     Out,
@@ -457,3 +569,75 @@ class _attention(torch.autograd.Function):
 
 
 attention = _attention.apply
+
+
+def _varlen_launch_options(head_dim):
+    from .matmul_perf_model import is_xpu
+    if is_xpu():
+        # one row of 8x16 DPAS tiles per sub-group of 16 work-items
+        return {"num_warps": 16, "num_stages": 3, "threads_per_warp": 16, "grf_mode": "large"}
+    return {"num_warps": 4 if head_dim <= 64 else 8, "num_stages": 4}
+
+
+# tiles of `attention_varlen`, and blocks of its `block_mask`
+VARLEN_BLOCK_M = 128
+VARLEN_BLOCK_N = 64
+
+
+def attention_varlen(q, k, v, cu_seqlens_q, cu_seqlens_k, max_seqlen_q, sm_scale, causal=False, window_size=(-1, -1),
+                     block_mask=None):
+    """
+    Forward attention of a batch of sequences of different lengths, packed without padding.
+
+    :param q: the queries, of shape `(total_q, num_heads, head_dim)`.
+    :param k: the keys, of shape `(total_k, num_heads, head_dim)`.
+    :param v: the values, of the shape of `k`.
+    :param cu_seqlens_q: the offsets of the sequences in `q`, followed by `total_q`, an int32 tensor
+        of shape `(batch + 1, )`.
+    :param cu_seqlens_k: the offsets of the sequences in `k` and `v`, likewise.
+    :param max_seqlen_q: the number of queries of the longest sequence.
+    :param causal: whether queries only see the keys up to their own position. Queries are
+        aligned to the last keys of their sequence.
+    :param window_size: the number of keys `(left, right)` of each side of its position a query
+        sees, -1 for all of them.
+    :param block_mask: which blocks of `VARLEN_BLOCK_M` queries by `VARLEN_BLOCK_N` keys are computed,
+        of shape `(batch, num_heads, cdiv(max_seqlen_q, VARLEN_BLOCK_M), cdiv(max_seqlen_k, VARLEN_BLOCK_N))`
+        or any shape broadcastable to it. The other blocks are skipped.
+    :return: the output, of the shape and type of `q`.
+    """
+    Lq, Lk, Lv = q.shape[-1], k.shape[-1], v.shape[-1]
+    assert Lq == Lk and Lk == Lv
+    assert Lk in {16, 32, 64, 128}
+    assert q.shape[1] == k.shape[1] == v.shape[1]
+    batch, num_heads = cu_seqlens_q.shape[0] - 1, q.shape[1]
+    window_left, window_right = window_size
+    if causal:
+        window_right = 0
+    has_window = window_left >= 0 or window_right >= 0
+    # an unbounded side of the window spans every key
+    window_left = window_left if window_left >= 0 else 2**30
+    window_right = window_right if window_right >= 0 else 2**30
+    has_block_mask = block_mask is not None
+    if has_block_mask:
+        num_m, num_n = block_mask.shape[-2:]
+        block_mask = block_mask.expand(batch, num_heads, num_m, num_n)
+        bm_strides = block_mask.stride()
+    else:
+        block_mask, bm_strides = cu_seqlens_q, (0, 0, 0, 0)
+    o = torch.empty_like(q)
+    grid = (cdiv(max_seqlen_q, VARLEN_BLOCK_M), batch * num_heads, 1)
+    _fwd_kernel_varlen[grid](
+        q, k, v, sm_scale,  #
+        o,  #
+        cu_seqlens_q, cu_seqlens_k,  #
+        block_mask,  #
+        q.stride(0), q.stride(1), q.stride(2),  #
+        k.stride(0), k.stride(1), k.stride(2),  #
+        v.stride(0), v.stride(1), v.stride(2),  #
+        o.stride(0), o.stride(1), o.stride(2),  #
+        *bm_strides,  #
+        num_heads, window_left, window_right,  #
+        BLOCK_M=VARLEN_BLOCK_M, BLOCK_N=VARLEN_BLOCK_N, BLOCK_DMODEL=Lk,  #
+        HAS_WINDOW=has_window, HAS_BLOCK_MASK=has_block_mask,  #
+        **_varlen_launch_options(Lk))
+    return o
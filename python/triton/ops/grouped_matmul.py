@@ -0,0 +1,150 @@
+"""
+Grouped Matrix Multiplication
+=============================
+The products of the rows of `a` routed to each expert of a mixture of experts by
+the weights of that expert, with the number of rows of each expert known only to
+the device. Each program of a persistent kernel lays out the tiles of every
+expert from these counts and walks its share of them, so that no step waits for
+the host.
+"""
+
+import torch
+
+from .. import Config, autotune, cdiv, jit, next_power_of_2
+from .. import language as tl
+from ..runtime import driver
+from .matmul_perf_model import target_configs
+
+
+def _prune_configs(configs, named_args):
+    return target_configs(configs)
+
+
+def get_configs():
+    configs = [
+        # CUDA
+        Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 64, 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 64, 'BLOCK_K': 64}, num_stages=4, num_warps=4),
+        Config({'BLOCK_M': 32, 'BLOCK_N': 128, 'BLOCK_K': 64}, num_stages=4, num_warps=4),
+    ]
+    # XPU, tiles of 8x16 DPAS per sub-group
+    for block_m, block_n, block_k, num_warps, grf_mode in [
+        (128, 256, 32, 32, "large"),
+        (128, 128, 32, 16, "default"),
+        (64, 256, 32, 16, "default"),
+        (64, 128, 32, 8, "default"),
+        (32, 128, 64, 8, "default"),
+    ]:
+        configs.append(
+            Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': block_k}, num_stages=3, num_warps=num_warps,
+                   threads_per_warp=16, grf_mode=grf_mode))
+    return configs
+
+
+@autotune(
+    configs=get_configs(),
+    key=['N', 'K', 'E'],
+    prune_configs_by={'early_config_prune': _prune_configs},
+    reset_to_zero=['C'],
+)
+@jit
+def _grouped_kernel(A, W, C, COUNTS, GATES, SCATTER,  #
+                    N, K, E,  #
+                    stride_am, stride_ak,  #
+                    stride_we, stride_wk, stride_wn,  #
+                    stride_cm, stride_cn,  #
+                    HAS_GATES: tl.constexpr, HAS_SCATTER: tl.constexpr,  #
+                    BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
+                    BLOCK_E: tl.constexpr  #
+                    ):
+    tiles_n = tl.cdiv(N, BLOCK_N)
+    experts = tl.arange(0, BLOCK_E)
+    counts = tl.load(COUNTS + experts, mask=experts < E, other=0)
+    tiles = tl.cdiv(counts, BLOCK_M) * tiles_n
+    # inclusive prefix sums of the rows and tiles of the experts
+    rows_end = tl.cumsum(counts, 0)
+    tiles_end = tl.cumsum(tiles, 0)
+    num_tiles = tl.sum(tiles, 0)
+    for tile in range(tl.program_id(0), num_tiles, tl.num_programs(0)):
+        expert = tl.sum((tiles_end <= tile).to(tl.int32), 0)
+        is_expert = experts == expert
+        tile_start = tl.sum(tl.where(is_expert, tiles_end - tiles, 0), 0)
+        row_end = tl.sum(tl.where(is_expert, rows_end, 0), 0)
+        row_start = row_end - tl.sum(tl.where(is_expert, counts, 0), 0)
+        pid_m = (tile - tile_start) // tiles_n
+        pid_n = (tile - tile_start) % tiles_n
+        rm = row_start + pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+        rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+        rk = tl.arange(0, BLOCK_K)
+        row_mask = rm < row_end
+        A_ptrs = A + rm[:, None] * stride_am + rk[None, :] * stride_ak
+        W_ptrs = W + expert.to(tl.int64) * stride_we + rk[:, None] * stride_wk + rn[None, :] * stride_wn
+        acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+        for k in range(0, tl.cdiv(K, BLOCK_K)):
+            k_remaining = K - k * BLOCK_K
+            a = tl.load(A_ptrs, mask=row_mask[:, None] & (rk[None, :] < k_remaining), other=0.)
+            b = tl.load(W_ptrs, mask=(rk[:, None] < k_remaining) & (rn[None, :] < N), other=0.)
+            acc += tl.dot(a, b)
+            A_ptrs += BLOCK_K * stride_ak
+            W_ptrs += BLOCK_K * stride_wk
+        if HAS_GATES:
+            gates = tl.load(GATES + rm, mask=row_mask, other=0.).to(tl.float32)
+            acc = acc * gates[:, None]
+        mask = row_mask[:, None] & (rn < N)[None, :]
+        if HAS_SCATTER:
+            # the rows of the experts a token is routed to are summed into its row
+            out_rows = tl.load(SCATTER + rm, mask=row_mask, other=0)
+            C_ptrs = C + out_rows[:, None] * stride_cm + rn[None, :] * stride_cn
+            tl.atomic_add(C_ptrs, acc.to(C.dtype.element_ty), mask=mask)
+        else:
+            C_ptrs = C + rm[:, None] * stride_cm + rn[None, :] * stride_cn
+            tl.store(C_ptrs, acc.to(C.dtype.element_ty), mask=mask)
+
+
+def grouped_matmul(a, w, expert_counts, gates=None, scatter_indices=None, num_out_rows=None):
+    """
+    The product of the rows of `a` routed to each expert by the weights of that expert.
+
+    :param a: the rows, sorted by expert, of shape `(num_rows, K)`.
+    :param w: the weights of the experts, of shape `(E, K, N)`.
+    :param expert_counts: the number of rows of each expert, an int32 tensor of shape `(E, )`
+        on the device. Their sum must not exceed `num_rows`.
+    :param gates: the scale of the output of each row, of shape `(num_rows, )`.
+    :param scatter_indices: the row of the output each row is added to, of shape `(num_rows, )`.
+        By default, row `i` of `a` produces row `i` of the output.
+    :param num_out_rows: the number of rows of the output when scattering.
+    :return: the output, of shape `(num_rows, N)`, or `(num_out_rows, N)` when scattering,
+        of the type of `a`.
+    """
+    assert a.dim() == 2 and w.dim() == 3 and a.shape[1] == w.shape[1], "incompatible dimensions"
+    num_rows, K = a.shape
+    E, _, N = w.shape
+    assert expert_counts.shape == (E, )
+    has_scatter = scatter_indices is not None
+    if has_scatter:
+        assert num_out_rows is not None, "the number of rows of the output is needed to scatter"
+        assert a.dtype in (torch.float16, torch.float32), "scattered outputs are added atomically"
+        c = torch.zeros((num_out_rows, N), device=a.device, dtype=a.dtype)
+    else:
+        c = torch.empty((num_rows, N), device=a.device, dtype=a.dtype)
+    device = driver.active.get_current_device()
+    num_cores = driver.active.utils.get_device_properties(device)["multiprocessor_count"]
+    block_e = next_power_of_2(E)
+
+    def grid(META):
+        # an upper bound of the number of tiles, known to the host
+        max_tiles = (cdiv(num_rows, META['BLOCK_M']) + E) * cdiv(N, META['BLOCK_N'])
+        return (min(max_tiles, 2 * num_cores), )
+
+    _grouped_kernel[grid](
+        a, w, c, expert_counts, gates if gates is not None else a,
+        scatter_indices if has_scatter else a,  #
+        N, K, E,  #
+        a.stride(0), a.stride(1),  #
+        w.stride(0), w.stride(1), w.stride(2),  #
+        c.stride(0), c.stride(1),  #
+        HAS_GATES=gates is not None, HAS_SCATTER=has_scatter,  #
+        BLOCK_E=block_e)
+    return c
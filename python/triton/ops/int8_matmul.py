@@ -0,0 +1,144 @@
+"""
+Int8 Matrix Multiplication
+==========================
+The product of int8 activations by int8 weights (W8A8), accumulated in int32 on
+the matrix engines (DPAS on Intel GPUs, IMMA on NVIDIA GPUs), with the
+dequantization, or the requantization back to int8 with a scale and a zero
+point per output channel, fused into the epilogue.
+"""
+
+import torch
+
+from .. import Config, autotune, cdiv, heuristics, jit
+from .. import language as tl
+from .matmul_perf_model import target_configs
+
+
+def get_configs():
+    configs = []
+    # CUDA
+    for block_m, block_n, block_k, num_warps in [(32, 64, 128, 4), (64, 128, 64, 4), (128, 128, 64, 8),
+                                                 (128, 256, 64, 8)]:
+        configs.append(
+            Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': block_k}, num_stages=4, num_warps=num_warps))
+    # XPU, 8x16 DPAS of 32 int8 per sub-group
+    for block_m, block_n, block_k, num_warps in [(32, 64, 64, 4), (64, 128, 64, 8), (128, 128, 64, 16),
+                                                 (256, 256, 32, 32)]:
+        configs.append(
+            Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': block_k}, num_stages=3, num_warps=num_warps,
+                   threads_per_warp=16))
+    return configs
+
+
+def _prune_configs(configs, named_args):
+    return target_configs(configs)
+
+
+@autotune(
+    configs=get_configs(),
+    key=['M', 'N', 'K'],
+    prune_configs_by={'early_config_prune': _prune_configs},
+)
+@heuristics({
+    'EVEN_K': lambda args: args['K'] % args['BLOCK_K'] == 0,
+})
+@jit
+def _kernel(A, B, C, SCALE_A, SCALE, ZERO_POINT, M, N, K,  #
+            stride_am, stride_ak,  #
+            stride_bk, stride_bn,  #
+            stride_cm, stride_cn,  #
+            HAS_SCALE_A: tl.constexpr, HAS_SCALE: tl.constexpr, HAS_ZERO_POINT: tl.constexpr,  #
+            BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
+            GROUP_M: tl.constexpr, EVEN_K: tl.constexpr  #
+            ):
+    pid = tl.program_id(0)
+    grid_m = tl.cdiv(M, BLOCK_M)
+    grid_n = tl.cdiv(N, BLOCK_N)
+    # re-order program ID for better L2 performance
+    width = GROUP_M * grid_n
+    group_id = pid // width
+    group_size = min(grid_m - group_id * GROUP_M, GROUP_M)
+    pid_m = group_id * GROUP_M + (pid % group_size)
+    pid_n = (pid % width) // (group_size)
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    ram = tl.max_contiguous(tl.multiple_of(rm % M, BLOCK_M), BLOCK_M)
+    rbn = tl.max_contiguous(tl.multiple_of(rn % N, BLOCK_N), BLOCK_N)
+    rk = tl.arange(0, BLOCK_K)
+    A = A + (ram[:, None] * stride_am + rk[None, :] * stride_ak)
+    B = B + (rk[:, None] * stride_bk + rbn[None, :] * stride_bn)
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.int32)
+    for k in range(0, tl.cdiv(K, BLOCK_K)):
+        if EVEN_K:
+            a = tl.load(A)
+            b = tl.load(B)
+        else:
+            k_remaining = K - k * BLOCK_K
+            a = tl.load(A, mask=rk[None, :] < k_remaining, other=0)
+            b = tl.load(B, mask=rk[:, None] < k_remaining, other=0)
+        acc += tl.dot(a, b, out_dtype=tl.int32)
+        A += BLOCK_K * stride_ak
+        B += BLOCK_K * stride_bk
+    # rematerialize rm and rn to save registers
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    # the epilogue is elementwise on the accumulator, so that it runs in the
+    # layout of the dot and the result is stored from it
+    if HAS_SCALE:
+        out = acc.to(tl.float32) * tl.load(SCALE + rn, mask=rn < N, other=0.)[None, :]
+        if HAS_SCALE_A:
+            out = out * tl.load(SCALE_A + rm, mask=rm < M, other=0.)[:, None]
+    else:
+        out = acc
+    if C.dtype.element_ty == tl.int8:
+        if HAS_SCALE:
+            out = tl.math.rint(out)
+        else:
+            out = out.to(tl.float32)
+        if HAS_ZERO_POINT:
+            out = out + tl.load(ZERO_POINT + rn, mask=rn < N, other=0)[None, :].to(tl.float32)
+        out = tl.clamp(out, -128., 127.)
+    out = out.to(C.dtype.element_ty)
+    C = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
+    mask = (rm < M)[:, None] & (rn < N)[None, :]
+    tl.store(C, out, mask=mask)
+
+
+def int8_matmul(a, b, scale=None, zero_point=None, scale_a=None, out_dtype=torch.int8):
+    """
+    The product of the int8 matrices `a` and `b`, accumulated in int32 and then
+    scaled per column and per row: `clamp(round(a @ b * scale_a[:, None] * scale[None, :]) + zero_point, -128, 127)`
+    when requantized to int8.
+
+    :param a: the activations, of shape `(M, K)`, in int8.
+    :param b: the weights, of shape `(K, N)`, in int8.
+    :param scale: the float32 scale of each output channel, of shape `(N, )`: the weight scale,
+        divided by the output scale when requantizing. None to keep the int32 accumulator.
+    :param zero_point: the int32 zero point of each output channel, of shape `(N, )`, added
+        after rounding. Only for int8 outputs.
+    :param scale_a: the float32 scale of each row of `a`, of shape `(M, )`, for activations
+        quantized per token. Only along with `scale`.
+    :param out_dtype: int8 to requantize, int32 for the accumulator, or float16, bfloat16 or
+        float32 to dequantize.
+    :return: the output, of shape `(M, N)` and of type `out_dtype`.
+    """
+    assert a.dtype == torch.int8 and b.dtype == torch.int8
+    assert out_dtype in (torch.int8, torch.int32, torch.float16, torch.bfloat16, torch.float32)
+    M, K = a.shape
+    assert b.shape[0] == K, "incompatible dimensions"
+    N = b.shape[1]
+    assert scale is None or (scale.shape == (N, ) and scale.dtype == torch.float32)
+    assert scale_a is None or (scale is not None and scale_a.shape == (M, ) and scale_a.dtype == torch.float32)
+    assert zero_point is None or (out_dtype == torch.int8 and zero_point.shape == (N, ))
+    assert scale is not None or not out_dtype.is_floating_point, "dequantized outputs need a scale"
+    c = torch.empty((M, N), device=a.device, dtype=out_dtype)
+    grid = lambda META: (cdiv(M, META['BLOCK_M']) * cdiv(N, META['BLOCK_N']), )
+    _kernel[grid](
+        a, b, c, scale_a if scale_a is not None else c, scale if scale is not None else c,  #
+        zero_point if zero_point is not None else c, M, N, K,  #
+        a.stride(0), a.stride(1),  #
+        b.stride(0), b.stride(1),  #
+        c.stride(0), c.stride(1),  #
+        HAS_SCALE_A=scale_a is not None, HAS_SCALE=scale is not None, HAS_ZERO_POINT=zero_point is not None,  #
+        GROUP_M=8)
+    return c
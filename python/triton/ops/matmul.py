@@ -2,7 +2,7 @@ import torch
 
 from .. import Config, autotune, cdiv, heuristics, jit
 from .. import language as tl
-from .matmul_perf_model import early_config_prune, estimate_matmul_time
+from .matmul_perf_model import early_config_prune, estimate_matmul_time, is_xpu
 
 _ordered_datatypes = [torch.int8, torch.float16, torch.bfloat16, torch.float32]
 
@@ -147,6 +147,107 @@ def _kernel(A, B, C, M, N, K,  #
         tl.atomic_add(C, acc, mask=mask)
 
 
+def get_configs_xpu():
+    # Tiles are multiples of the 8x16 DPAS output sub-tile of each sub-group. The
+    # largest ones only fit in registers with the large GRF mode.
+    configs = []
+    for block_m, block_n, block_k, num_warps, num_stages, grf_mode in [
+        (256, 256, 32, 32, 3, "large"),
+        (256, 128, 32, 32, 3, "large"),
+        (128, 256, 32, 32, 3, "large"),
+        (128, 256, 64, 32, 2, "large"),
+        (128, 128, 32, 16, 3, "default"),
+        (128, 128, 64, 16, 2, "default"),
+        (64, 256, 32, 16, 3, "default"),
+        (64, 128, 32, 8, 3, "default"),
+        (64, 64, 64, 8, 2, "default"),
+    ]:
+        configs.append(
+            Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': block_k, 'SPLIT_K': 1}, num_stages=num_stages,
+                   num_warps=num_warps, threads_per_warp=16, grf_mode=grf_mode))
+    # sub-groups of 32 work-items run each DPAS twice, halving the sub-groups per tile
+    for block_m, block_n, block_k, num_warps in [(256, 128, 32, 16), (128, 128, 32, 8)]:
+        configs.append(
+            Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': block_k, 'SPLIT_K': 1}, num_stages=3,
+                   num_warps=num_warps, threads_per_warp=32, grf_mode="large"))
+    # io bound
+    for block_m in [16, 32]:
+        for block_n in [64, 128, 256]:
+            for split_k in [1, 4, 8]:
+                configs.append(
+                    Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': 64, 'SPLIT_K': split_k}, num_stages=3,
+                           num_warps=block_n // 32, threads_per_warp=16,
+                           pre_hook=init_to_zero('C') if split_k > 1 else None))
+    return configs
+
+
+@autotune(
+    configs=get_configs_xpu(),
+    key=['M', 'N', 'K'],
+    prune_configs_by={
+        'early_config_prune': early_config_prune,
+        'perf_model': estimate_matmul_time,
+        'top_k': 10,
+    },
+)
+@jit
+def _xpu_kernel(A, B, C, M, N, K,  #
+                stride_am, stride_ak,  #
+                stride_bk, stride_bn,  #
+                stride_cm, stride_cn,  #
+                acc_dtype: tl.constexpr,  #
+                allow_tf32: tl.constexpr,  #
+                fp8_fast_accum: tl.constexpr,  #
+                BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
+                GROUP_M: tl.constexpr, SPLIT_K: tl.constexpr, AB_DTYPE: tl.constexpr  #
+                ):
+    # matrix multiplication through block pointers, which the XPU backend lowers
+    # to 2D block loads and stores
+    pid = tl.program_id(0)
+    pid_z = tl.program_id(1)
+    grid_m = tl.cdiv(M, BLOCK_M)
+    grid_n = tl.cdiv(N, BLOCK_N)
+    # re-order program ID for better L2 performance
+    width = GROUP_M * grid_n
+    group_id = pid // width
+    group_size = min(grid_m - group_id * GROUP_M, GROUP_M)
+    pid_m = group_id * GROUP_M + (pid % group_size)
+    pid_n = (pid % width) // (group_size)
+    # the K loop and its remainder are bounds checked by the block loads
+    a_block_ptr = tl.make_block_ptr(base=A, shape=(M, K), strides=(stride_am, stride_ak),
+                                    offsets=(pid_m * BLOCK_M, pid_z * BLOCK_K), block_shape=(BLOCK_M, BLOCK_K),
+                                    order=(1, 0))
+    b_block_ptr = tl.make_block_ptr(base=B, shape=(K, N), strides=(stride_bk, stride_bn),
+                                    offsets=(pid_z * BLOCK_K, pid_n * BLOCK_N), block_shape=(BLOCK_K, BLOCK_N),
+                                    order=(1, 0))
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=acc_dtype)
+    for k in range(0, tl.cdiv(K, BLOCK_K * SPLIT_K)):
+        a = tl.load(a_block_ptr, boundary_check=(0, 1), padding_option="zero")
+        b = tl.load(b_block_ptr, boundary_check=(0, 1), padding_option="zero")
+        if AB_DTYPE is not None:
+            a = a.to(AB_DTYPE)
+            b = b.to(AB_DTYPE)
+        if fp8_fast_accum:
+            acc = tl.dot(a, b, acc, out_dtype=acc_dtype, allow_tf32=allow_tf32)
+        else:
+            acc += tl.dot(a, b, out_dtype=acc_dtype, allow_tf32=allow_tf32)
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_K * SPLIT_K))
+        b_block_ptr = tl.advance(b_block_ptr, (BLOCK_K * SPLIT_K, 0))
+    acc = acc.to(C.dtype.element_ty)
+    # handles write-back with reduction-splitting
+    if SPLIT_K == 1:
+        c_block_ptr = tl.make_block_ptr(base=C, shape=(M, N), strides=(stride_cm, stride_cn),
+                                        offsets=(pid_m * BLOCK_M, pid_n * BLOCK_N), block_shape=(BLOCK_M, BLOCK_N),
+                                        order=(1, 0))
+        tl.store(c_block_ptr, acc, boundary_check=(0, 1))
+    else:
+        rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+        rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+        C = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
+        mask = (rm < M)[:, None] & (rn < N)[None, :]
+        tl.atomic_add(C, acc, mask=mask)
+
+
 class _matmul(torch.autograd.Function):
     kernel = _kernel
 
@@ -199,6 +300,20 @@ class _matmul(torch.autograd.Function):
             ab_dtype = None
         # launch kernel
         grid = lambda META: (cdiv(M, META['BLOCK_M']) * cdiv(N, META['BLOCK_N']), META['SPLIT_K'])
+        if is_xpu():
+            # groups of 4 rows of tiles keep the A and B tiles of concurrent
+            # work-groups resident in the L2 of PVC; block pointers are kept
+            # as such on the devices with 2D block IO
+            _xpu_kernel[grid](
+                a, b, c, M, N, K,  #
+                a.stride(0), a.stride(1),  #
+                b.stride(0), b.stride(1),  #
+                c.stride(0), c.stride(1),  #
+                acc_dtype=acc_dtype,  #
+                allow_tf32=allow_tf32,  #
+                fp8_fast_accum=fp8_fast_accum,  #
+                GROUP_M=4, AB_DTYPE=ab_dtype, native_block_pointers=True)
+            return c
         _kernel[grid](
             a, b, c, M, N, K,  #
             a.stride(0), a.stride(1),  #
@@ -25,6 +25,47 @@ def get_simd_tflops(device, num_ctas, num_warps, dtype):
     return tflops
 
 
+# Dense operations per clock of one Xe core, by device arch (0 for Arc, 1 for
+# PVC). Types DPAS supports run on the matrix engines, FP32 on the vector ones.
+_XE_CORE_OPS_PER_CLOCK = {
+    0: {torch.float16: 2048, torch.bfloat16: 2048, torch.int8: 4096, torch.float32: 256},
+    1: {torch.float16: 4096, torch.bfloat16: 4096, torch.int8: 8192, torch.float32: 256, 'tf32': 2048},
+}
+# vector engines per Xe core
+_XE_CORE_NUM_EUS = 8
+
+
+def is_xpu():
+    return driver.active.get_current_target()[0] == "xpu"
+
+
+def target_configs(configs):
+    ''' return the configs of the current target, those with a sub-group size being tuned for XPU '''
+    xpu = is_xpu()
+    return [config for config in configs if (config.threads_per_warp is not None) == xpu]
+
+
+def get_xpu_tflops(device, num_ctas, num_warps, dtype, allow_tf32=False):
+    ''' return compute throughput in TOPS '''
+    props = driver.active.utils.get_device_properties(device)
+    num_cores = props["multiprocessor_count"]
+    ops_per_clock = _XE_CORE_OPS_PER_CLOCK.get(props["device_arch"], _XE_CORE_OPS_PER_CLOCK[1])
+    if dtype == torch.float32 and allow_tf32:
+        dtype = 'tf32'
+    ops_per_clock = ops_per_clock.get(dtype, ops_per_clock[torch.float32])
+    # each sub-group of a work-group runs on one vector engine of its Xe core
+    num_eus = num_cores * _XE_CORE_NUM_EUS
+    total_warps = num_ctas * min(num_warps, _XE_CORE_NUM_EUS)
+    max_tflops = num_cores * ops_per_clock * props["sm_clock_rate"] * 1e-6  # clock in MHz
+    return min(num_eus, total_warps) / num_eus * max_tflops
+
+
+def get_xpu_dram_gbps(device):
+    ''' return DRAM bandwidth in GB/s '''
+    props = driver.active.utils.get_device_properties(device)
+    return props["mem_clock_rate"] * props["mem_bus_width"] * 2 / 8 / 1e3  # clock in MHz, width in bits
+
+
 def get_tflops(device, num_ctas, num_warps, dtype):
     capability = torch.cuda.get_device_capability(device)
     if capability[0] < 8 and dtype == torch.float32:
@@ -42,7 +83,7 @@ def estimate_matmul_time(
 ):
     ''' return estimated running time in ms
           = max(compute, loading) + store '''
-    device = torch.cuda.current_device()
+    device = driver.active.get_current_device()
     dtype = A.dtype
     dtsize = A.element_size()
 
@@ -56,7 +97,10 @@ def estimate_matmul_time(
 
     # time to compute
     total_ops = 2 * M * N * K / (1024 * 1024 * 1024)  # GOPS
-    tput = get_tflops(device, num_ctas, num_warps, dtype)
+    if is_xpu():
+        tput = get_xpu_tflops(device, num_ctas, num_warps, dtype, kwargs.get('allow_tf32', False))
+    else:
+        tput = get_tflops(device, num_ctas, num_warps, dtype)
     compute_ms = total_ops / tput
 
     # time to load data
@@ -64,7 +108,8 @@ def estimate_matmul_time(
     active_cta_ratio = min(1, num_ctas / num_sm)
     active_cta_ratio_bw1 = min(1, num_ctas / 32)  # 32 active ctas are enough to saturate
     active_cta_ratio_bw2 = max(min(1, (num_ctas - 32) / (108 - 32)), 0)  # 32-108, remaining 5%
-    dram_bw = get_dram_gbps(device) * (active_cta_ratio_bw1 * 0.95 + active_cta_ratio_bw2 * 0.05)  # in GB/s
+    peak_dram_bw = get_xpu_dram_gbps(device) if is_xpu() else get_dram_gbps(device)
+    dram_bw = peak_dram_bw * (active_cta_ratio_bw1 * 0.95 + active_cta_ratio_bw2 * 0.05)  # in GB/s
     l2_bw = dram_bw * 4  # rough estimation (should be 4.7 for A100?)
     # assume 80% of (following) loads are in L2 cache
     load_a_dram = M * K * dtsize * (1 + 0.2 * (num_cta_n - 1))
@@ -98,8 +143,9 @@ def estimate_matmul_time(
 
 
 def early_config_prune(configs, named_args):
-    device = torch.cuda.current_device()
-    capability = torch.cuda.get_device_capability()
+    device = driver.active.get_current_device()
+    xpu = is_xpu()
+    capability = None if xpu else torch.cuda.get_device_capability()
     # BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, num_warps, num_stages
     dtsize = named_args['A'].element_size()
     dtype = named_args['A'].dtype
@@ -137,7 +183,22 @@ def early_config_prune(configs, named_args):
     pruned_configs = []
     for k, v in configs_map.items():
         BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, num_warps = k
-        if capability[0] >= 8:
+        if xpu:
+            # compute cycles of the 8x16x16 DPAS of the sub-groups sharing an Xe core
+            dpas = BLOCK_M * BLOCK_N * BLOCK_K / (8 * 16 * 16)
+            dpas_cycles = dpas / min(_XE_CORE_NUM_EUS, num_warps) * 8
+
+            load_latency = 500  # global load latency in cycles
+            optimal_num_stages = load_latency / dpas_cycles
+
+            # nearest stages, prefer large #stages
+            nearest = heapq.nsmallest(
+                2, v, key=lambda x: 10 + abs(x[1] - optimal_num_stages)
+                if (x[1] - optimal_num_stages) < 0 else x[1] - optimal_num_stages)
+
+            for n in nearest:
+                pruned_configs.append(n[0])
+        elif capability[0] >= 8:
             # compute cycles (only works for ampere GPUs)
             mmas = BLOCK_M * BLOCK_N * BLOCK_K / (16 * 8 * 16)
             mma_cycles = mmas / min(4, num_warps) * 8
@@ -0,0 +1,187 @@
+"""
+Fused Normalization
+===================
+LayerNorm and RMSNorm of the rows of a tensor, optionally added to a residual
+first and quantized to fp8 after. The backward pass runs persistent programs,
+each accumulating the weight and bias gradients of its rows in registers, so
+that no lock serializes them.
+"""
+
+import torch
+
+from .. import Config, autotune, heuristics, jit, next_power_of_2
+from .. import language as tl
+from ..runtime import driver
+from .matmul_perf_model import target_configs
+
+
+def get_configs():
+    # CUDA
+    configs = [Config({}, num_warps=num_warps) for num_warps in [1, 2, 4, 8, 16]]
+    # XPU, for both sub-group sizes
+    for threads_per_warp in [16, 32]:
+        for num_warps in [4, 8, 16, 32]:
+            configs.append(Config({}, num_warps=num_warps, threads_per_warp=threads_per_warp))
+    return configs
+
+
+def _prune_configs(configs, named_args):
+    configs = target_configs(configs)
+    # at least one element per work-item
+    block_n = next_power_of_2(named_args['N'])
+    return [
+        config for config in configs if config.num_warps * (config.threads_per_warp or 32) <= max(block_n, 32)
+    ] or configs[:1]
+
+
+@autotune(configs=get_configs(), key=['N', 'IS_RMS'], prune_configs_by={'early_config_prune': _prune_configs})
+@heuristics({'BLOCK_N': lambda nargs: next_power_of_2(nargs['N'])})
+@jit
+def _norm_fwd(X, RES, H, Y, W, B, Mean, Rstd,  #
+              stride_x, stride_res, stride_h, stride_y,  #
+              N, eps, out_scale,  #
+              IS_RMS: tl.constexpr, HAS_RES: tl.constexpr, HAS_BIAS: tl.constexpr,  #
+              HAS_OUT_SCALE: tl.constexpr, BLOCK_N: tl.constexpr):
+    row = tl.program_id(0).to(tl.int64)
+    cols = tl.arange(0, BLOCK_N)
+    mask = cols < N
+    x = tl.load(X + row * stride_x + cols, mask=mask, other=0.).to(tl.float32)
+    if HAS_RES:
+        # the sum is both normalized and returned as the next residual
+        x += tl.load(RES + row * stride_res + cols, mask=mask, other=0.).to(tl.float32)
+        tl.store(H + row * stride_h + cols, x.to(H.dtype.element_ty), mask=mask)
+    if IS_RMS:
+        xc = x
+    else:
+        mean = tl.sum(x, axis=0) / N
+        tl.store(Mean + row, mean)
+        xc = tl.where(mask, x - mean, 0.)
+    var = tl.sum(xc * xc, axis=0) / N
+    rstd = 1 / tl.sqrt(var + eps)
+    tl.store(Rstd + row, rstd)
+    y = xc * rstd * tl.load(W + cols, mask=mask, other=0.).to(tl.float32)
+    if HAS_BIAS:
+        y += tl.load(B + cols, mask=mask, other=0.).to(tl.float32)
+    if HAS_OUT_SCALE:
+        y = y / out_scale
+    tl.store(Y + row * stride_y + cols, y.to(Y.dtype.element_ty), mask=mask)
+
+
+@autotune(configs=get_configs(), key=['N', 'IS_RMS'], prune_configs_by={'early_config_prune': _prune_configs})
+@heuristics({'BLOCK_N': lambda nargs: next_power_of_2(nargs['N'])})
+@jit
+def _norm_bwd(DX, DY, DH, X, W, Mean, Rstd, DW, DB,  #
+              stride_dx, stride_dy, stride_dh, stride_x,  #
+              M, N,  #
+              IS_RMS: tl.constexpr, HAS_DH: tl.constexpr, HAS_BIAS: tl.constexpr,  #
+              BLOCK_N: tl.constexpr):
+    pid = tl.program_id(0)
+    cols = tl.arange(0, BLOCK_N)
+    mask = cols < N
+    w = tl.load(W + cols, mask=mask, other=0.).to(tl.float32)
+    dw = tl.zeros((BLOCK_N, ), dtype=tl.float32)
+    db = tl.zeros((BLOCK_N, ), dtype=tl.float32)
+    # each program reduces the weight gradients of its rows in registers
+    for r in range(pid, M, tl.num_programs(0)):
+        row = r.to(tl.int64)
+        x = tl.load(X + row * stride_x + cols, mask=mask, other=0.).to(tl.float32)
+        dy = tl.load(DY + row * stride_dy + cols, mask=mask, other=0.).to(tl.float32)
+        rstd = tl.load(Rstd + row)
+        if IS_RMS:
+            xhat = x * rstd
+        else:
+            xhat = tl.where(mask, (x - tl.load(Mean + row)) * rstd, 0.)
+        wdy = w * dy
+        c1 = tl.sum(xhat * wdy, axis=0) / N
+        if IS_RMS:
+            dx = (wdy - xhat * c1) * rstd
+        else:
+            c2 = tl.sum(wdy, axis=0) / N
+            dx = (wdy - (xhat * c1 + c2)) * rstd
+        if HAS_DH:
+            # gradient of the returned residual
+            dx += tl.load(DH + row * stride_dh + cols, mask=mask, other=0.).to(tl.float32)
+        tl.store(DX + row * stride_dx + cols, dx.to(DX.dtype.element_ty), mask=mask)
+        dw += dy * xhat
+        if HAS_BIAS:
+            db += dy
+    tl.store(DW + pid * N + cols, dw, mask=mask)
+    if HAS_BIAS:
+        tl.store(DB + pid * N + cols, db, mask=mask)
+
+
+class _norm(torch.autograd.Function):
+
+    @staticmethod
+    def forward(ctx, x, weight, bias, residual, eps, is_rms, out_dtype, out_scale):
+        N = x.shape[-1]
+        assert weight.shape == (N, ) and (bias is None or bias.shape == (N, ))
+        # Less than 64KB per feature
+        assert N * x.element_size() <= 65536, "rows of more than 64KB are not supported"
+        x_arg = x.reshape(-1, N).contiguous()
+        M = x_arg.shape[0]
+        y = torch.empty((M, N), dtype=out_dtype or x.dtype, device=x.device)
+        h = None
+        if residual is not None:
+            residual = residual.reshape(-1, N).contiguous()
+            h = torch.empty_like(x_arg)
+        mean = torch.empty((M, ), dtype=torch.float32, device=x.device)
+        rstd = torch.empty((M, ), dtype=torch.float32, device=x.device)
+        _norm_fwd[(M, )](
+            x_arg, residual, h, y, weight, bias, mean, rstd,  #
+            x_arg.stride(0), residual.stride(0) if residual is not None else 0, h.stride(0) if h is not None else 0,
+            y.stride(0),  #
+            N, eps, out_scale if out_scale is not None else 1.0,  #
+            IS_RMS=is_rms, HAS_RES=residual is not None, HAS_BIAS=bias is not None,  #
+            HAS_OUT_SCALE=out_scale is not None)
+        ctx.save_for_backward(x_arg if h is None else h, weight, bias, mean, rstd)
+        ctx.is_rms = is_rms
+        ctx.quantized = out_scale is not None
+        ctx.has_residual = residual is not None
+        ctx.shape = x.shape
+        y = y.view(x.shape)
+        if h is None:
+            return y
+        return y, h.view(x.shape)
+
+    @staticmethod
+    def backward(ctx, dy, dh=None):
+        assert not ctx.quantized, "the backward pass of quantized outputs is not supported"
+        x, w, b, mean, rstd = ctx.saved_tensors
+        M, N = x.shape
+        dy = dy.reshape(-1, N).contiguous()
+        if dh is not None:
+            dh = dh.reshape(-1, N).contiguous()
+        dx = torch.empty_like(x)
+        # persistent programs, enough to fill the device
+        device = driver.active.get_current_device()
+        num_programs = min(M, 4 * driver.active.utils.get_device_properties(device)["multiprocessor_count"])
+        partial_dw = torch.empty((num_programs, N), dtype=torch.float32, device=x.device)
+        partial_db = torch.empty((num_programs, N), dtype=torch.float32, device=x.device) if b is not None else None
+        _norm_bwd[(num_programs, )](
+            dx, dy, dh, x, w, mean, rstd, partial_dw, partial_db,  #
+            dx.stride(0), dy.stride(0), dh.stride(0) if dh is not None else 0, x.stride(0),  #
+            M, N,  #
+            IS_RMS=ctx.is_rms, HAS_DH=dh is not None, HAS_BIAS=b is not None)
+        dw = partial_dw.sum(0).to(w.dtype)
+        db = partial_db.sum(0).to(b.dtype) if b is not None else None
+        dx = dx.view(ctx.shape)
+        return dx, dw, db, dx if ctx.has_residual else None, None, None, None, None
+
+
+def layer_norm(x, weight, bias=None, eps=1e-5, residual=None, out_dtype=None, out_scale=None):
+    """
+    LayerNorm of the last dimension of `x`, or of `x + residual`.
+
+    :param out_dtype: the type of the output, that of `x` by default. With `out_scale`, e.g. a
+        float8 type the output is quantized to, as `y / out_scale`.
+    :return: the output, and `x + residual` when `residual` is given.
+    """
+    return _norm.apply(x, weight, bias, residual, eps, False, out_dtype, out_scale)
+
+
+def rms_norm(x, weight, eps=1e-6, residual=None, out_dtype=None, out_scale=None):
+    """
+    RMSNorm of the last dimension of `x`, or of `x + residual`, see `layer_norm`.
+    """
+    return _norm.apply(x, weight, None, residual, eps, True, out_dtype, out_scale)
@@ -0,0 +1,189 @@
+"""
+Paged Attention
+===============
+Attention of the single new token of each sequence of a batch over a KV cache
+stored in fixed-size pages, for the decode phase of LLM inference
+(see: Kwon et al., https://arxiv.org/abs/2309.06180).
+
+The KV tokens of a sequence are split across programs, each of which writes the
+partial output of its tokens and their log-sum-exp, and a second kernel reduces
+them (see: Dao et al., https://crfm.stanford.edu/2023/10/12/flashdecoding.html).
+The query heads sharing a KV head (grouped-query and multi-query attention) are
+handled by the same program, so that each page is loaded once.
+"""
+
+import torch
+
+from .. import cdiv, jit, next_power_of_2
+from .. import language as tl
+from ..runtime import driver
+
+
+@jit
+def _paged_attn_split_kernel(Q, K_cache, V_cache, Block_tables, Seq_lens, qk_scale, v_scale,  #
+                             Out, Partial_out, Partial_lse,  #
+                             stride_qs, stride_qh, stride_qd,  #
+                             stride_kb, stride_kt, stride_kh, stride_kd,  #
+                             stride_vb, stride_vt, stride_vh, stride_vd,  #
+                             stride_bts, stride_btb,  #
+                             stride_os, stride_oh, stride_od,  #
+                             stride_pos, stride_poh, stride_posp, stride_pod,  #
+                             stride_pls, stride_plh, stride_plsp,  #
+                             pages_per_split,  #
+                             QUERY_GROUP: tl.constexpr, BLOCK_H: tl.constexpr,  #
+                             PAGE_SIZE: tl.constexpr, HEAD_DIM: tl.constexpr,  #
+                             NUM_SPLITS: tl.constexpr  #
+                             ):
+    seq = tl.program_id(0)
+    kv_head = tl.program_id(1)
+    split = tl.program_id(2)
+    seq_len = tl.load(Seq_lens + seq)
+    page_lo = split * pages_per_split
+    page_hi = tl.minimum(page_lo + pages_per_split, tl.cdiv(seq_len, PAGE_SIZE))
+
+    offs_h = tl.arange(0, BLOCK_H)
+    offs_t = tl.arange(0, PAGE_SIZE)
+    offs_d = tl.arange(0, HEAD_DIM)
+    head_mask = offs_h < QUERY_GROUP
+    q_heads = kv_head * QUERY_GROUP + offs_h
+    # the rows of the padding heads are zero, and discarded
+    q = tl.load(Q + seq * stride_qs + q_heads[:, None] * stride_qh + offs_d[None, :] * stride_qd,
+                mask=head_mask[:, None], other=0.)
+
+    m_i = tl.zeros([BLOCK_H], dtype=tl.float32) - float("inf")
+    l_i = tl.zeros([BLOCK_H], dtype=tl.float32)
+    acc = tl.zeros([BLOCK_H, HEAD_DIM], dtype=tl.float32)
+    K_ptrs = K_cache + kv_head * stride_kh + offs_t[:, None] * stride_kt + offs_d[None, :] * stride_kd
+    V_ptrs = V_cache + kv_head * stride_vh + offs_t[:, None] * stride_vt + offs_d[None, :] * stride_vd
+    for page in range(page_lo, page_hi):
+        block = tl.load(Block_tables + seq * stride_bts + page * stride_btb).to(tl.int64)
+        # fp8 pages are upcast to the type of q, their scales are folded into
+        # qk_scale and v_scale
+        k = tl.load(K_ptrs + block * stride_kb).to(Q.dtype.element_ty)
+        v = tl.load(V_ptrs + block * stride_vb).to(Q.dtype.element_ty)
+        qk = tl.dot(q, tl.trans(k)) * qk_scale
+        token_mask = page * PAGE_SIZE + offs_t < seq_len
+        qk = tl.where(token_mask[None, :], qk, float("-inf"))
+        # every page holds at least one token of the sequence, so m_ij is finite
+        m_ij = tl.maximum(m_i, tl.max(qk, 1))
+        p = tl.math.exp2(qk - m_ij[:, None])
+        alpha = tl.math.exp2(m_i - m_ij)
+        acc = acc * alpha[:, None] + tl.dot(p.to(Q.dtype.element_ty), v)
+        l_i = l_i * alpha + tl.sum(p, 1)
+        m_i = m_ij
+
+    if NUM_SPLITS == 1:
+        acc = acc / l_i[:, None] * v_scale
+        O_ptrs = Out + seq * stride_os + q_heads[:, None] * stride_oh + offs_d[None, :] * stride_od
+        tl.store(O_ptrs, acc.to(Out.dtype.element_ty), mask=head_mask[:, None])
+    else:
+        # the splits past the end of the sequence have no tokens, and no weight
+        empty = l_i == 0.
+        acc = acc / tl.where(empty, 1., l_i)[:, None]
+        lse = tl.where(empty, float("-inf"), m_i + tl.math.log2(l_i))
+        P_ptrs = Partial_out + seq * stride_pos + q_heads[:, None] * stride_poh + split * stride_posp + \
+            offs_d[None, :] * stride_pod
+        tl.store(P_ptrs, acc, mask=head_mask[:, None])
+        tl.store(Partial_lse + seq * stride_pls + q_heads * stride_plh + split * stride_plsp, lse, mask=head_mask)
+
+
+@jit
+def _paged_attn_reduce_kernel(Partial_out, Partial_lse, v_scale,  #
+                              Out,  #
+                              stride_pos, stride_poh, stride_posp, stride_pod,  #
+                              stride_pls, stride_plh, stride_plsp,  #
+                              stride_os, stride_oh, stride_od,  #
+                              NUM_SPLITS: tl.constexpr, BLOCK_SPLITS: tl.constexpr,  #
+                              HEAD_DIM: tl.constexpr  #
+                              ):
+    seq = tl.program_id(0)
+    head = tl.program_id(1)
+    offs_s = tl.arange(0, BLOCK_SPLITS)
+    offs_d = tl.arange(0, HEAD_DIM)
+    split_mask = offs_s < NUM_SPLITS
+    lse = tl.load(Partial_lse + seq * stride_pls + head * stride_plh + offs_s * stride_plsp, mask=split_mask,
+                  other=float("-inf"))
+    # log-sum-exp of the splits, in base 2
+    weights = tl.math.exp2(lse - tl.max(lse, 0))
+    acc = tl.load(
+        Partial_out + seq * stride_pos + head * stride_poh + offs_s[:, None] * stride_posp +
+        offs_d[None, :] * stride_pod, mask=split_mask[:, None], other=0.)
+    out = tl.sum(acc * weights[:, None], 0) / tl.sum(weights, 0) * v_scale
+    tl.store(Out + seq * stride_os + head * stride_oh + offs_d * stride_od, out.to(Out.dtype.element_ty))
+
+
+def _default_num_splits(q, num_kv_heads, max_pages):
+    # enough programs to fill the device twice over
+    device = driver.active.get_current_device()
+    num_cores = driver.active.utils.get_device_properties(device)["multiprocessor_count"]
+    return max(1, min(cdiv(2 * num_cores, q.shape[0] * num_kv_heads), max_pages, 64))
+
+
+def paged_attention(q, k_cache, v_cache, block_tables, seq_lens, sm_scale, k_scale=1.0, v_scale=1.0, num_splits=None):
+    """
+    Attention of one query token per sequence over a paged KV cache.
+
+    :param q: the queries, of shape `(num_seqs, num_heads, head_dim)`.
+    :param k_cache: the keys, of shape `(num_pages, page_size, num_kv_heads, head_dim)`.
+        `num_heads` must be a multiple of `num_kv_heads`. The cache may be stored in fp8,
+        as `k_cache * k_scale`.
+    :param v_cache: the values, laid out as `k_cache`, stored as `v_cache * v_scale`.
+    :param block_tables: the pages of each sequence, an int32 tensor of shape `(num_seqs, max_pages)`.
+    :param seq_lens: the number of cached tokens of each sequence, an int32 tensor of shape `(num_seqs, )`,
+        at least one.
+    :param sm_scale: the scale of the attention scores.
+    :param num_splits: the number of programs splitting the tokens of a sequence. By default,
+        enough to fill the device.
+    :return: the output, of the shape and type of `q`.
+    """
+    num_seqs, num_heads, head_dim = q.shape
+    _, page_size, num_kv_heads, _ = k_cache.shape
+    assert k_cache.shape == v_cache.shape and k_cache.shape[-1] == head_dim
+    assert q.dtype in (torch.float16, torch.bfloat16)
+    assert num_heads % num_kv_heads == 0, "the number of query heads must be a multiple of the number of KV heads"
+    assert head_dim in {16, 32, 64, 128, 256}
+    assert page_size >= 16 and page_size == next_power_of_2(page_size), "pages must hold a power of 2 of tokens"
+    query_group = num_heads // num_kv_heads
+    max_pages = block_tables.shape[1]
+    if num_splits is None:
+        num_splits = _default_num_splits(q, num_kv_heads, max_pages)
+    pages_per_split = cdiv(max_pages, num_splits)
+
+    o = torch.empty_like(q)
+    if num_splits > 1:
+        partial_out = torch.empty((num_seqs, num_heads, num_splits, head_dim), device=q.device, dtype=torch.float32)
+        partial_lse = torch.empty((num_seqs, num_heads, num_splits), device=q.device, dtype=torch.float32)
+    else:
+        partial_out, partial_lse = o, o
+    # scores are exponentiated in base 2
+    qk_scale = sm_scale * k_scale * 1.44269504
+    num_warps = 4 if head_dim <= 64 else 8
+    _paged_attn_split_kernel[(num_seqs, num_kv_heads, num_splits)](
+        q, k_cache, v_cache, block_tables, seq_lens, qk_scale, v_scale,  #
+        o, partial_out, partial_lse,  #
+        q.stride(0), q.stride(1), q.stride(2),  #
+        k_cache.stride(0), k_cache.stride(1), k_cache.stride(2), k_cache.stride(3),  #
+        v_cache.stride(0), v_cache.stride(1), v_cache.stride(2), v_cache.stride(3),  #
+        block_tables.stride(0), block_tables.stride(1),  #
+        o.stride(0), o.stride(1), o.stride(2),  #
+        *(partial_out.stride() if num_splits > 1 else (0, 0, 0, 0)),  #
+        *(partial_lse.stride() if num_splits > 1 else (0, 0, 0)),  #
+        pages_per_split,  #
+        QUERY_GROUP=query_group, BLOCK_H=max(16, next_power_of_2(query_group)),  #
+        PAGE_SIZE=page_size, HEAD_DIM=head_dim,  #
+        NUM_SPLITS=num_splits,  #
+        num_warps=num_warps,  #
+        num_stages=2  #
+    )
+    if num_splits > 1:
+        _paged_attn_reduce_kernel[(num_seqs, num_heads)](
+            partial_out, partial_lse, v_scale,  #
+            o,  #
+            partial_out.stride(0), partial_out.stride(1), partial_out.stride(2), partial_out.stride(3),  #
+            partial_lse.stride(0), partial_lse.stride(1), partial_lse.stride(2),  #
+            o.stride(0), o.stride(1), o.stride(2),  #
+            NUM_SPLITS=num_splits, BLOCK_SPLITS=next_power_of_2(num_splits),  #
+            HEAD_DIM=head_dim,  #
+            num_warps=4  #
+        )
+    return o
@@ -0,0 +1,169 @@
+"""
+Weight-Only Quantized Matrix Multiplication
+===========================================
+The product of activations by weights stored as int8, packed int4 or fp8 with a
+scale, and optionally a zero point, per group of rows of the weights. Weights are
+dequantized in registers, one group at a time, and the configs favor the small M
+of decoding, where the product is bound by the bandwidth of the weights.
+"""
+
+import torch
+
+from .. import Config, autotune, cdiv, heuristics, jit
+from .. import language as tl
+from .matmul import init_to_zero
+from .matmul_perf_model import target_configs
+
+
+def get_configs():
+    configs = []
+    # CUDA
+    for block_m, block_n, block_k, num_warps in [(16, 64, 64, 4), (16, 128, 64, 4), (16, 128, 128, 4),
+                                                 (32, 128, 64, 4), (64, 128, 32, 4), (128, 128, 32, 8)]:
+        for split_k in [1, 4] if block_m <= 32 else [1]:
+            configs.append(
+                Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': block_k, 'SPLIT_K': split_k}, num_stages=4,
+                       num_warps=num_warps, pre_hook=init_to_zero('C') if split_k > 1 else None))
+    # XPU, rows of 8x16 DPAS per sub-group
+    for block_m, block_n, block_k, num_warps in [(16, 64, 64, 4), (16, 128, 64, 8), (16, 256, 32, 16),
+                                                 (32, 128, 64, 8), (64, 128, 32, 16), (128, 128, 32, 16)]:
+        for split_k in [1, 4] if block_m <= 32 else [1]:
+            configs.append(
+                Config({'BLOCK_M': block_m, 'BLOCK_N': block_n, 'BLOCK_K': block_k, 'SPLIT_K': split_k}, num_stages=3,
+                       num_warps=num_warps, threads_per_warp=16,
+                       pre_hook=init_to_zero('C') if split_k > 1 else None))
+    return configs
+
+
+def _prune_configs(configs, named_args):
+    configs = target_configs(configs)
+    group_size = named_args['GROUP_SIZE']
+    # each iteration of the K loop dequantizes rows of a single group
+    configs = [config for config in configs if group_size % config.kwargs['BLOCK_K'] == 0]
+    # only some types allow atomic_add
+    if named_args['A'].dtype != torch.float16:
+        configs = [config for config in configs if config.kwargs['SPLIT_K'] == 1]
+    # tiles larger than M only load zeros
+    M = named_args['M']
+    smallest = min((config.kwargs['BLOCK_M'] for config in configs if config.kwargs['BLOCK_M'] >= M),
+                   default=max(config.kwargs['BLOCK_M'] for config in configs))
+    return [config for config in configs if config.kwargs['BLOCK_M'] <= smallest]
+
+
+@autotune(
+    configs=get_configs(),
+    key=['M', 'N', 'K', 'GROUP_SIZE'],
+    prune_configs_by={'early_config_prune': _prune_configs},
+)
+@heuristics({
+    'EVEN_K': lambda args: args['K'] % (args['BLOCK_K'] * args['SPLIT_K']) == 0,
+})
+@jit
+def _kernel(A, B, C, SCALES, ZEROS, M, N, K,  #
+            stride_am, stride_ak,  #
+            stride_bk, stride_bn,  #
+            stride_cm, stride_cn,  #
+            stride_sg, stride_sn,  #
+            stride_zg, stride_zn,  #
+            GROUP_SIZE: tl.constexpr, BITS: tl.constexpr, HAS_ZEROS: tl.constexpr,  #
+            BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
+            GROUP_M: tl.constexpr, SPLIT_K: tl.constexpr, EVEN_K: tl.constexpr  #
+            ):
+    pid = tl.program_id(0)
+    pid_z = tl.program_id(1)
+    grid_m = tl.cdiv(M, BLOCK_M)
+    grid_n = tl.cdiv(N, BLOCK_N)
+    # re-order program ID for better L2 performance
+    width = GROUP_M * grid_n
+    group_id = pid // width
+    group_size = min(grid_m - group_id * GROUP_M, GROUP_M)
+    pid_m = group_id * GROUP_M + (pid % group_size)
+    pid_n = (pid % width) // (group_size)
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    ram = tl.max_contiguous(tl.multiple_of(rm % M, BLOCK_M), BLOCK_M)
+    rbn = tl.max_contiguous(tl.multiple_of(rn % N, BLOCK_N), BLOCK_N)
+    rk = pid_z * BLOCK_K + tl.arange(0, BLOCK_K)
+    A = A + (ram[:, None] * stride_am + rk[None, :] * stride_ak)
+    if BITS == 4:
+        # two rows of weights per byte, the even one in the low nibble
+        B = B + ((rk // 2)[:, None] * stride_bk + rbn[None, :] * stride_bn)
+        shifts = ((rk % 2) * 4)[:, None]
+    else:
+        B = B + (rk[:, None] * stride_bk + rbn[None, :] * stride_bn)
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    for k in range(0, tl.cdiv(K, BLOCK_K * SPLIT_K)):
+        k_start = k * (BLOCK_K * SPLIT_K) + pid_z * BLOCK_K
+        if EVEN_K:
+            a = tl.load(A)
+            b = tl.load(B)
+        else:
+            k_remaining = K - k * (BLOCK_K * SPLIT_K)
+            a = tl.load(A, mask=rk[None, :] < k_remaining, other=0.)
+            b = tl.load(B, mask=rk[:, None] < k_remaining, other=0)
+        # scales and zeros only depend on the group and the column, so that they
+        # apply to the product of the quantized values
+        group = k_start // GROUP_SIZE
+        if BITS == 4:
+            b = (b.to(tl.uint8, bitcast=True) >> shifts) & 0xF
+        b = b.to(A.dtype.element_ty)
+        if HAS_ZEROS:
+            zeros = tl.load(ZEROS + group * stride_zg + rbn * stride_zn)
+            b = b - zeros[None, :].to(A.dtype.element_ty)
+        scales = tl.load(SCALES + group * stride_sg + rbn * stride_sn).to(tl.float32)
+        acc += tl.dot(a, b, out_dtype=tl.float32) * scales[None, :]
+        A += BLOCK_K * SPLIT_K * stride_ak
+        if BITS == 4:
+            B += BLOCK_K * SPLIT_K // 2 * stride_bk
+        else:
+            B += BLOCK_K * SPLIT_K * stride_bk
+    acc = acc.to(C.dtype.element_ty)
+    # rematerialize rm and rn to save registers
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    C = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
+    mask = (rm < M)[:, None] & (rn < N)[None, :]
+    # handles write-back with reduction-splitting
+    if SPLIT_K == 1:
+        tl.store(C, acc, mask=mask)
+    else:
+        tl.atomic_add(C, acc, mask=mask)
+
+
+def quantized_matmul(a, qweight, scales, zeros=None, group_size=128, bits=8):
+    """
+    The product of `a` by the weights `(qweight - zeros) * scales`, dequantized per
+    group of `group_size` rows.
+
+    :param a: the activations, of shape `(M, K)`, in float16 or bfloat16.
+    :param qweight: the quantized weights, of shape `(K, N)`: int8 when `bits` is 8, each
+        byte holding two rows, the even one in its low nibble, of shape `(K // 2, N)` when
+        `bits` is 4, or float8 when `bits` is 8 and the type of `qweight` is a float8 one.
+    :param scales: the scale of each group of rows of each column, of shape `(K // group_size, N)`.
+    :param zeros: the zero point of each group of rows of each column, in quantized units, of
+        the shape of `scales`. None for symmetric quantization.
+    :param group_size: the number of rows sharing a scale, 32, 64 or 128.
+    :param bits: the width of the quantized weights, 4 or 8.
+    :return: the output, of shape `(M, N)` and of the type of `a`.
+    """
+    assert group_size in {32, 64, 128}, "only groups of 32, 64 and 128 rows are supported"
+    assert bits in {4, 8}
+    assert a.dtype in (torch.float16, torch.bfloat16)
+    M, K = a.shape
+    N = qweight.shape[1]
+    assert qweight.shape[0] * (2 if bits == 4 else 1) == K, "incompatible dimensions"
+    assert K % group_size == 0
+    assert scales.shape == (K // group_size, N)
+    assert zeros is None or zeros.shape == scales.shape
+    c = torch.empty((M, N), device=a.device, dtype=a.dtype)
+    grid = lambda META: (cdiv(M, META['BLOCK_M']) * cdiv(N, META['BLOCK_N']), META['SPLIT_K'])
+    _kernel[grid](
+        a, qweight, c, scales, zeros if zeros is not None else scales, M, N, K,  #
+        a.stride(0), a.stride(1),  #
+        qweight.stride(0), qweight.stride(1),  #
+        c.stride(0), c.stride(1),  #
+        scales.stride(0), scales.stride(1),  #
+        *(zeros.stride() if zeros is not None else (0, 0)),  #
+        GROUP_SIZE=group_size, BITS=bits, HAS_ZEROS=zeros is not None,  #
+        GROUP_M=8)
+    return c
@@ -0,0 +1,136 @@
+"""
+Rotary Embedding
+================
+Rotary position embedding of the queries and keys of new tokens (see: Su et al.,
+https://arxiv.org/abs/2104.09864), fused with the append of their keys and values
+to a KV cache paged as that of `paged_attention`, optionally in fp8.
+"""
+
+import math
+
+from .. import jit, next_power_of_2
+from .. import language as tl
+
+
+@jit
+def _rotate(X, offs_h, offs_d, cos, sin, mask, stride_h, HALF: tl.constexpr, INTERLEAVED: tl.constexpr):
+    # the two halves of each pair of rotated features
+    if INTERLEAVED:
+        offs_1 = 2 * offs_d
+        offs_2 = 2 * offs_d + 1
+    else:
+        offs_1 = offs_d
+        offs_2 = offs_d + HALF
+    X1 = X + offs_h[:, None] * stride_h + offs_1[None, :]
+    X2 = X + offs_h[:, None] * stride_h + offs_2[None, :]
+    x1 = tl.load(X1, mask=mask, other=0.).to(tl.float32)
+    x2 = tl.load(X2, mask=mask, other=0.).to(tl.float32)
+    return x1 * cos - x2 * sin, x2 * cos + x1 * sin, offs_1, offs_2
+
+
+@jit
+def _rotary_kv_kernel(Q, K, V, POSITIONS, SEQ_IDS, COS, SIN,  #
+                      K_cache, V_cache, Block_tables,  #
+                      stride_qt, stride_qh,  #
+                      stride_kt, stride_kh,  #
+                      stride_vt, stride_vh,  #
+                      stride_cos,  #
+                      stride_kb, stride_kp, stride_kh_cache,  #
+                      stride_vb, stride_vp, stride_vh_cache,  #
+                      stride_bts,  #
+                      log2_base, inv_k_scale, inv_v_scale,  #
+                      NUM_HEADS: tl.constexpr, NUM_KV_HEADS: tl.constexpr,  #
+                      BLOCK_H: tl.constexpr, BLOCK_KV_H: tl.constexpr,  #
+                      HEAD_DIM: tl.constexpr, PAGE_SIZE: tl.constexpr,  #
+                      HAS_TABLES: tl.constexpr, HAS_SEQ_IDS: tl.constexpr, INTERLEAVED: tl.constexpr  #
+                      ):
+    token = tl.program_id(0).to(tl.int64)
+    pos = tl.load(POSITIONS + token)
+    offs_d = tl.arange(0, HEAD_DIM // 2)
+    if HAS_TABLES:
+        cos = tl.load(COS + pos * stride_cos + offs_d).to(tl.float32)
+        sin = tl.load(SIN + pos * stride_cos + offs_d).to(tl.float32)
+    else:
+        # theta_i = pos * base ** (-2 * i / head_dim)
+        theta = pos.to(tl.float32) * tl.math.exp2(-log2_base * (2 * offs_d).to(tl.float32) / HEAD_DIM)
+        cos = tl.cos(theta)
+        sin = tl.sin(theta)
+    cos = cos[None, :]
+    sin = sin[None, :]
+    # queries are rotated in place
+    offs_h = tl.arange(0, BLOCK_H)
+    mask = (offs_h < NUM_HEADS)[:, None]
+    q1, q2, offs_1, offs_2 = _rotate(Q + token * stride_qt, offs_h, offs_d, cos, sin, mask, stride_qh,  #
+                                     HEAD_DIM // 2, INTERLEAVED)
+    Q = Q + token * stride_qt + offs_h[:, None] * stride_qh
+    tl.store(Q + offs_1[None, :], q1.to(Q.dtype.element_ty), mask=mask)
+    tl.store(Q + offs_2[None, :], q2.to(Q.dtype.element_ty), mask=mask)
+    # keys and values are written to the slot of the token in the cache
+    offs_h = tl.arange(0, BLOCK_KV_H)
+    mask = (offs_h < NUM_KV_HEADS)[:, None]
+    k1, k2, offs_1, offs_2 = _rotate(K + token * stride_kt, offs_h, offs_d, cos, sin, mask, stride_kh,  #
+                                     HEAD_DIM // 2, INTERLEAVED)
+    seq = token
+    if HAS_SEQ_IDS:
+        seq = tl.load(SEQ_IDS + token).to(tl.int64)
+    block = tl.load(Block_tables + seq * stride_bts + pos // PAGE_SIZE).to(tl.int64)
+    slot = pos % PAGE_SIZE
+    K_cache = K_cache + block * stride_kb + slot * stride_kp + offs_h[:, None] * stride_kh_cache
+    tl.store(K_cache + offs_1[None, :], (k1 * inv_k_scale).to(K_cache.dtype.element_ty), mask=mask)
+    tl.store(K_cache + offs_2[None, :], (k2 * inv_k_scale).to(K_cache.dtype.element_ty), mask=mask)
+    offs_dv = tl.arange(0, HEAD_DIM)
+    v = tl.load(V + token * stride_vt + offs_h[:, None] * stride_vh + offs_dv[None, :], mask=mask, other=0.)
+    V_cache = V_cache + block * stride_vb + slot * stride_vp + offs_h[:, None] * stride_vh_cache
+    tl.store(V_cache + offs_dv[None, :], (v.to(tl.float32) * inv_v_scale).to(V_cache.dtype.element_ty), mask=mask)
+
+
+def rotary_kv_append(q, k, v, positions, k_cache, v_cache, block_tables, seq_ids=None, cos=None, sin=None,
+                     base=10000.0, interleaved=False, k_scale=1.0, v_scale=1.0):
+    """
+    Applies the rotary embedding to the queries and keys of new tokens, and appends
+    their keys and values to a paged KV cache.
+
+    :param q: the queries, of shape `(num_tokens, num_heads, head_dim)`, rotated in place.
+    :param k: the keys, of shape `(num_tokens, num_kv_heads, head_dim)`.
+    :param v: the values, of the shape of `k`.
+    :param positions: the position of each token in its sequence, of shape `(num_tokens, )`.
+    :param k_cache: the cached keys, of shape `(num_pages, page_size, num_kv_heads, head_dim)`,
+        see `paged_attention`. When it is stored in fp8, the keys are stored as `k / k_scale`.
+    :param v_cache: the cached values, laid out as `k_cache`, stored as `v / v_scale`.
+    :param block_tables: the pages of each sequence, an int32 tensor of shape `(num_seqs, max_pages)`.
+    :param seq_ids: the sequence of each token, of shape `(num_tokens, )`. By default, token `i`
+        is the new token of sequence `i`, as when decoding.
+    :param cos: the cosines of the rotation of each position, of shape `(max_position, head_dim // 2)`.
+        By default, they are computed from `base`.
+    :param sin: the sines, likewise.
+    :param interleaved: whether the rotated pairs of features are adjacent (GPT-J style), rather
+        than in the two halves of the head (GPT-NeoX style).
+    """
+    num_tokens, num_heads, head_dim = q.shape
+    _, page_size, num_kv_heads, _ = k_cache.shape
+    assert k.shape == v.shape == (num_tokens, num_kv_heads, head_dim)
+    assert k_cache.shape == v_cache.shape and k_cache.shape[-1] == head_dim
+    assert head_dim >= 2 and head_dim == next_power_of_2(head_dim)
+    # the features of each head are contiguous
+    assert q.stride(2) == k.stride(2) == v.stride(2) == k_cache.stride(3) == v_cache.stride(3) == 1
+    has_tables = cos is not None
+    if has_tables:
+        assert sin is not None and cos.shape == sin.shape and cos.shape[-1] == head_dim // 2
+        cos, sin = cos.contiguous(), sin.contiguous()
+    _rotary_kv_kernel[(num_tokens, )](
+        q, k, v, positions, seq_ids, cos, sin,  #
+        k_cache, v_cache, block_tables,  #
+        q.stride(0), q.stride(1),  #
+        k.stride(0), k.stride(1),  #
+        v.stride(0), v.stride(1),  #
+        cos.stride(0) if has_tables else 0,  #
+        k_cache.stride(0), k_cache.stride(1), k_cache.stride(2),  #
+        v_cache.stride(0), v_cache.stride(1), v_cache.stride(2),  #
+        block_tables.stride(0),  #
+        math.log2(base), 1.0 / k_scale, 1.0 / v_scale,  #
+        NUM_HEADS=num_heads, NUM_KV_HEADS=num_kv_heads,  #
+        BLOCK_H=next_power_of_2(num_heads), BLOCK_KV_H=next_power_of_2(num_kv_heads),  #
+        HEAD_DIM=head_dim, PAGE_SIZE=page_size,  #
+        HAS_TABLES=has_tables, HAS_SEQ_IDS=seq_ids is not None, INTERLEAVED=interleaved,  #
+        num_warps=4)
+    return q
@@ -0,0 +1,121 @@
+"""
+Sampling
+========
+Top-k and top-p (nucleus) sampling of one token per row of logits, in a single
+launch. The k-th largest logit of each row is found by a radix select over
+histograms of its bits, the logits above it are compacted and sorted, and the
+top-p cutoff and the sampling itself use prefix sums of their probabilities.
+"""
+
+import torch
+
+from .. import jit, next_power_of_2
+from .. import language as tl
+
+# most tokens considered per row, also when top-k is disabled
+MAX_TOP_K = 1024
+
+
+@jit
+def _ordered_key(x):
+    # signed integers ordered as the floats they are the bits of
+    bits = x.to(tl.int32, bitcast=True)
+    return bits ^ ((bits >> 31) & 0x7FFFFFFF)
+
+
+@jit
+def _sample_kernel(LOGITS, CANDIDATES, OUT,  #
+                   stride_l, N,  #
+                   top_k, top_p, inv_temperature, seed,  #
+                   GREEDY: tl.constexpr, CHUNK: tl.constexpr, BLOCK_K: tl.constexpr  #
+                   ):
+    row = tl.program_id(0).to(tl.int64)
+    LOGITS += row * stride_l
+    CANDIDATES += row * BLOCK_K
+    cols = tl.arange(0, CHUNK)
+    bins = tl.arange(0, 512)
+    # radix select of the k-th largest key, 8 bits at a time; the keys of the
+    # other prefixes are counted in bin 256, which is ignored
+    k_remaining = top_k
+    prefix = tl.zeros((), dtype=tl.int64)
+    for shift in tl.static_range(24, -1, -8):
+        hist = tl.zeros((512, ), dtype=tl.int32)
+        for start in range(0, N, CHUNK):
+            mask = start + cols < N
+            x = tl.load(LOGITS + start + cols, mask=mask, other=0.).to(tl.float32)
+            ukey = _ordered_key(x).to(tl.int64) + 2147483648
+            matched = mask & ((ukey >> (shift + 8)) == (prefix >> (shift + 8)))
+            digits = tl.where(matched, (ukey >> shift) & 0xFF, 256).to(tl.int32)
+            hist += tl.histogram(digits, 512)
+        hist = tl.where(bins < 256, hist, 0)
+        # number of keys of each digit or above
+        count_ge = tl.sum(hist, 0) - tl.cumsum(hist, 0) + hist
+        digit = tl.sum(((count_ge >= k_remaining) & (bins < 256)).to(tl.int32), 0) - 1
+        k_remaining -= tl.sum(tl.where(bins > digit, hist, 0), 0)
+        prefix |= digit.to(tl.int64) << shift
+    # the keys at least as large as the k-th one, packed with their index so that
+    # sorting them keeps the index of each
+    count = 0
+    for start in range(0, N, CHUNK):
+        mask = start + cols < N
+        x = tl.load(LOGITS + start + cols, mask=mask, other=0.).to(tl.float32)
+        key = _ordered_key(x)
+        selected = mask & (key.to(tl.int64) + 2147483648 >= prefix)
+        pos = count + tl.cumsum(selected.to(tl.int32), 0) - selected.to(tl.int32)
+        packed = (key.to(tl.int64) << 32) | (start + cols).to(tl.int64)
+        tl.store(CANDIDATES + pos, packed, mask=selected & (pos < BLOCK_K))
+        count += tl.sum(selected.to(tl.int32), 0)
+    tl.debug_barrier()
+    offs = tl.arange(0, BLOCK_K)
+    # ties of the k-th key are cut in the sorted order
+    valid = offs < tl.minimum(count, top_k)
+    packed = tl.load(CANDIDATES + offs, mask=valid, other=-9223372036854775808)
+    packed = tl.sort(packed, descending=True)
+    index = (packed & 0xFFFFFFFF).to(tl.int32)
+    if GREEDY:
+        tl.store(OUT + row, tl.max(tl.where(offs == 0, index, 0), 0))
+        return
+    key = (packed >> 32).to(tl.int32)
+    x = (key ^ ((key >> 31) & 0x7FFFFFFF)).to(tl.float32, bitcast=True) * inv_temperature
+    # probabilities of the top-k tokens, in decreasing order
+    p = tl.where(valid, tl.exp(x - tl.max(tl.where(valid, x, -float("inf")), 0)), 0.)
+    p = p / tl.sum(p, 0)
+    # the smallest prefix whose probability reaches top_p
+    keep = valid & (tl.cumsum(p, 0) - p < top_p)
+    p = tl.where(keep, p, 0.)
+    u = tl.rand(seed, tl.program_id(0)) * tl.sum(p, 0)
+    choice = tl.minimum(tl.sum((keep & (tl.cumsum(p, 0) < u)).to(tl.int32), 0), tl.sum(keep.to(tl.int32), 0) - 1)
+    tl.store(OUT + row, tl.sum(tl.where(offs == choice, index, 0), 0))
+
+
+def sample(logits, top_k=0, top_p=1.0, temperature=1.0, seed=0):
+    """
+    Samples one token per row of `logits`.
+
+    :param logits: the logits, of shape `(num_rows, vocab_size)`.
+    :param top_k: the number of most likely tokens sampled from, at most `MAX_TOP_K`.
+        0 considers the `MAX_TOP_K` most likely ones.
+    :param top_p: the probability of the most likely tokens sampled from, among the top-k.
+    :param temperature: the temperature dividing the logits, 0 for greedy decoding.
+    :param seed: the seed of the random numbers, which should change between calls.
+    :return: the tokens, an int32 tensor of shape `(num_rows, )`.
+    """
+    assert logits.dim() == 2 and logits.stride(1) == 1
+    num_rows, N = logits.shape
+    assert 0 <= top_k <= MAX_TOP_K, f"top-k is limited to {MAX_TOP_K} tokens"
+    top_k = min(top_k or MAX_TOP_K, N)
+    greedy = temperature == 0
+    if greedy:
+        top_k = 1
+    assert 0 < top_p <= 1 and temperature >= 0
+    # the candidates are sorted in a single bitonic sort
+    block_k = max(next_power_of_2(top_k), 16)
+    candidates = torch.empty((num_rows, block_k), dtype=torch.int64, device=logits.device)
+    out = torch.empty((num_rows, ), dtype=torch.int32, device=logits.device)
+    _sample_kernel[(num_rows, )](
+        logits, candidates, out,  #
+        logits.stride(0), N,  #
+        top_k, top_p, 1.0 if greedy else 1.0 / temperature, seed,  #
+        GREEDY=greedy, CHUNK=min(next_power_of_2(N), 2048), BLOCK_K=block_k,  #
+        num_warps=8)
+    return out
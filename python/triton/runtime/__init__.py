@@ -1,18 +1,26 @@
 from .autotuner import (Autotuner, Config, Heuristics, OutOfResources, autotune, heuristics)
 from .driver import driver
-from .jit import JITFunction, KernelInterface, MockTensor, TensorWrapper, reinterpret
+from .fusion import FusedKernel, fuse_kernels
+from .jit import JITFunction, KernelInterface, MockTensor, PersistentGrid, TensorWrapper, launch_batch, reinterpret
+from .manifest import precompile, record_manifest
 
 __all__ = [
     "driver",
     "Config",
     "Heuristics",
     "autotune",
+    "fuse_kernels",
+    "FusedKernel",
     "heuristics",
     "JITFunction",
     "KernelInterface",
+    "launch_batch",
     "reinterpret",
     "TensorWrapper",
     "OutOfResources",
     "MockTensor",
+    "PersistentGrid",
     "Autotuner",
+    "precompile",
+    "record_manifest",
 ]
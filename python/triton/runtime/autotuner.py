@@ -1,10 +1,16 @@
 from __future__ import annotations
 
 import builtins
+import hashlib
+import json
+import math
+import os
 import time
+from concurrent.futures import ThreadPoolExecutor
 from typing import Dict
 
 from ..testing import do_bench
+from .cache import get_cache_manager
 from .jit import KernelInterface
 
 
@@ -23,6 +29,38 @@ class OutOfResources(Exception):
         return (type(self), (self.required, self.limit, self.name))
 
 
+def _bucket(value, bucketing):
+    """
+    The bucket of a key value: the next power of two for "pow2", the first of
+    the increasing upper bounds of a list not below it, or the result of a
+    callable. Values above every bound and non-integer values are their own
+    bucket.
+    """
+    if bucketing is None or isinstance(value, bool) or not isinstance(value, int):
+        return value
+    if bucketing == "pow2":
+        return 1 if value <= 1 else 1 << (value - 1).bit_length()
+    if callable(bucketing):
+        return bucketing(value)
+    return next((bound for bound in bucketing if value <= bound), value)
+
+
+def _key_distance(lhs, rhs):
+    """
+    How far apart the shapes of two keys are, as the sum of the log2 ratios of
+    their positive numeric entries. None if their other entries, e.g. dtypes,
+    differ.
+    """
+    distance = 0.0
+    for a, b in zip(lhs, rhs):
+        numeric = all(isinstance(v, (int, float)) and not isinstance(v, bool) and v > 0 for v in (a, b))
+        if numeric:
+            distance += abs(math.log2(a) - math.log2(b))
+        elif a != b:
+            return None
+    return distance
+
+
 class Autotuner(KernelInterface):
 
     def __init__(
@@ -36,18 +74,35 @@ class Autotuner(KernelInterface):
         prune_configs_by: Dict = None,
         warmup=25,
         rep=100,
+        cache_results=False,
+        screening=None,
+        key_buckets=None,
+        reuse_nearest=0,
     ):
         """
         :param prune_configs_by: a dict of functions that are used to prune configs, fields:
             'perf_model': performance model used to predicate running time with different configs, returns running time
             'top_k': number of configs to bench
             'prune_num_stages_by'(optional): a function used to prune num_stages. It takes configs:List[Config] as its input, and returns pruned configs.
+        :param cache_results: whether the best config for each key is stored through the cache manager, so
+            that other processes using the same kernel, configs and device do not benchmark it again.
+        :param screening: number of configs timed at full optimization, the fastest of all of them
+            compiled with the cheaper `screening_opt_level`. None or 0 times all of them at full optimization.
+        :param key_buckets: how the values of `key` arguments are bucketed before looking up the tuned configs,
+            per argument name as a dict or the same for all of them (see `_bucket`).
+        :param reuse_nearest: number of calls of an untuned key served with the config of the nearest tuned key
+            before it is tuned itself.
         """
         if not configs:
             self.configs = [Config({}, num_warps=4, num_stages=2, num_ctas=1)]
         else:
             self.configs = configs
         self.key_idx = [arg_names.index(k) for k in key]
+        if not isinstance(key_buckets, dict):
+            key_buckets = {k: key_buckets for k in key}
+        self.key_buckets = [key_buckets.get(k) for k in key]
+        self.reuse_nearest = reuse_nearest
+        self.reuse_counts = {}
         self.cache = {}
         self.arg_names = arg_names
 
@@ -91,14 +146,27 @@ class Autotuner(KernelInterface):
         self.fn = fn
         self.num_warmups = warmup
         self.num_reps = rep
-
-    def _bench(self, *args, config, **meta):
+        self.cache_results = cache_results or os.getenv("TRITON_CACHE_AUTOTUNING", "0") == "1"
+        self.collect_metrics = os.getenv("TRITON_AUTOTUNE_METRICS", "0") == "1"
+        if screening is None:
+            screening = int(os.getenv("TRITON_AUTOTUNE_SCREENING", "0"))
+        self.screening = screening
+        self.screening_opt_level = 1
+
+    def _bench(self, *args, config, budget=None, **meta):
         # check for conflicts, i.e. meta-parameters both provided
         # as kwargs and by the autotuner
         conflicts = meta.keys() & config.kwargs.keys()
         if conflicts:
             raise ValueError(f"Conflicting meta-parameters: {', '.join(conflicts)}."
                              " Make sure that you don't re-define auto-tuned symbols.")
+        try:
+            warmup, rep = budget or (self.num_warmups, self.num_reps)
+            return do_bench(self._kernel_call(args, config, meta), warmup=warmup, rep=rep, quantiles=(0.5, 0.2, 0.8))
+        except OutOfResources:
+            return [float("inf"), float("inf"), float("inf")]
+
+    def _kernel_call(self, args, config, meta):
         # augment meta-parameters with tunable ones
         current = dict(meta, **config.kwargs)
         full_nargs = {**self.nargs, **current}
@@ -109,20 +177,146 @@ class Autotuner(KernelInterface):
             self.pre_hook(args)
             self.fn.run(
                 *args,
-                num_warps=config.num_warps,
-                num_stages=config.num_stages,
-                num_ctas=config.num_ctas,
-                enable_warp_specialization=config.enable_warp_specialization,
-                # TODO: Make it configurable
-                # enable_persistent=False,
-                **current,
+                # TODO: Make enable_persistent configurable
+                **{**config.all_kwargs(), **current},
             )
             self.post_hook(args)
 
-        try:
-            return do_bench(kernel_call, warmup=self.num_warmups, rep=self.num_reps, quantiles=(0.5, 0.2, 0.8))
-        except OutOfResources:
-            return [float("inf"), float("inf"), float("inf")]
+        return kernel_call
+
+    def _collect_metrics(self, *args, configs, **kwargs):
+        """
+        Returns the hardware counters of one run of each of `configs`, as the
+        driver reports them, so that configs can be ranked by other measures
+        than their time.
+        """
+        from .driver import driver
+        metrics = {}
+        for config in configs:
+            try:
+                metrics[config] = driver.active.collect_metrics(self._kernel_call(args, config, kwargs))
+            except OutOfResources:
+                metrics[config] = None
+        return metrics
+
+    def _search(self, *args, configs, **kwargs):
+        """
+        Times `configs` by successive halving. Each round times the remaining
+        configs, then keeps the faster half of them, or fewer when the others
+        are clearly slower than the fastest one: even their fast runs are slower
+        than its typical ones. The budget per config doubles every round, so
+        only the last configs standing get the full `warmup` and `rep`.
+        Returns the last timings of every config and the configs of the last
+        round.
+        """
+        timings = {}
+        num_rounds = builtins.max(1, math.ceil(math.log2(builtins.max(1, len(configs)))))
+        for i in range(num_rounds):
+            scale = 2**(num_rounds - 1 - i)
+            budget = (builtins.max(1, self.num_warmups // scale), builtins.max(1, self.num_reps // scale))
+            for config in configs:
+                timings[config] = self._bench(*args, config=config, budget=budget, **kwargs)
+            if i == num_rounds - 1:
+                break
+            # timings are (median, 20th percentile, 80th percentile)
+            ranked = sorted(configs, key=lambda config: timings[config][0])
+            fastest = timings[ranked[0]]
+            num_contenders = len([config for config in configs if timings[config][1] <= fastest[2]])
+            configs = ranked[:builtins.max(1, builtins.min(num_contenders, (len(configs) + 1) // 2))]
+            if len(configs) == 1:
+                break
+        return timings, configs
+
+    def _screen(self, *args, configs, **kwargs):
+        """
+        Ranks `configs` compiled at `screening_opt_level`, which is much
+        cheaper to compile, then times the `screening` fastest of them again
+        compiled at full optimization and picks among those, so that configs
+        the optimizations rank differently do not decide the choice. Returns
+        the timings of both rounds and the finalists.
+        """
+        screening_kwargs = dict(kwargs, opt_level=self.screening_opt_level)
+        self._precompile(*args, configs=configs, **screening_kwargs)
+        screening_timings, _ = self._search(*args, configs=configs, **screening_kwargs)
+        ranked = sorted(configs, key=lambda config: screening_timings[config][0])[:self.screening]
+        self._precompile(*args, configs=ranked, **kwargs)
+        timings, finalists = self._search(*args, configs=ranked, **kwargs)
+        return screening_timings, timings, finalists
+
+    def _precompile(self, *args, configs, **kwargs):
+        """
+        Compiles `configs` concurrently so that benchmarking does not pay for
+        each compilation sequentially. The heavy parts of the compiler release
+        the GIL. Failures are ignored here and surface again when the
+        corresponding config is benchmarked.
+        """
+        num_threads = int(os.getenv("TRITON_AUTOTUNE_COMPILE_THREADS", builtins.min(8, os.cpu_count() or 1)))
+        num_threads = builtins.min(num_threads, len(configs))
+        if num_threads <= 1:
+            return
+        from .driver import driver
+        device = driver.active.get_current_device()
+        set_device = getattr(driver.active, "set_current_device", None)
+        kwargs = dict(kwargs, warmup=True)
+
+        def compile_config(config):
+            # the current device is thread-local in most frameworks
+            if set_device is not None:
+                set_device(device)
+            try:
+                self.fn.run(
+                    *args,
+                    **kwargs,
+                    **config.all_kwargs(),
+                )
+            except Exception:
+                pass
+
+        with ThreadPoolExecutor(max_workers=num_threads) as executor:
+            list(executor.map(compile_config, configs))
+
+    def _get_results_cache(self, key):
+        """
+        The cache manager the best config for `key` is stored in. It depends on the
+        source of the kernel, the configs tuned over and the device they are timed on.
+        """
+        from .driver import driver
+        fn = self.fn
+        # the JIT function may be wrapped by heuristics
+        while not hasattr(fn, "cache_key"):
+            fn = fn.fn
+        configs = [str(config) for config in self.configs]
+        contents = repr((fn.cache_key, key, driver.active.get_device_key(), configs))
+        return get_cache_manager(hashlib.sha256(contents.encode("utf-8")).hexdigest())
+
+    def _load_best_config(self, key):
+        path = self._get_results_cache(key).get_file("autotune.json")
+        if path is None:
+            return None
+        with open(path) as f:
+            index = json.load(f).get("config_index")
+        if not isinstance(index, int) or not 0 <= index < len(self.configs):
+            return None
+        return self.configs[index]
+
+    def _store_best_config(self, key, config, timings):
+        data = {
+            "config_index": self.configs.index(config),
+            "config": str(config),
+            "timings": {str(c): t for c, t in timings.items()},
+        }
+        self._get_results_cache(key).put(json.dumps(data), "autotune.json", binary=False)
+
+    def _nearest_config(self, key):
+        calls = self.reuse_counts.get(key, 0)
+        if calls >= self.reuse_nearest:
+            return None
+        distances = {tuned: _key_distance(key, tuned) for tuned in self.cache}
+        tuned = [k for k, distance in distances.items() if distance is not None]
+        if not tuned:
+            return None
+        self.reuse_counts[key] = calls + 1
+        return self.cache[builtins.min(tuned, key=distances.get)]
 
     def run(self, *args, **kwargs):
         self.nargs = dict(zip(self.arg_names, args))
@@ -132,22 +326,40 @@ class Autotuner(KernelInterface):
             for name in self.arg_names:
                 if name in all_args:
                     _args.append(all_args[name])
-            key = [_args[i] for i in self.key_idx]
+            key = [_bucket(_args[i], bucketing) for i, bucketing in zip(self.key_idx, self.key_buckets)]
             for arg in _args:
                 if hasattr(arg, "dtype"):
                     key.append(str(arg.dtype))
             key = tuple(key)
-            if key not in self.cache:
+            if key not in self.cache and self.cache_results:
+                config = self._load_best_config(key)
+                if config is not None:
+                    self.cache[key] = config
+            config = self.cache.get(key)
+            if config is None:
+                config = self._nearest_config(key)
+            if config is None:
                 # prune configs
                 pruned_configs = self.prune_configs(kwargs)
                 bench_start = time.time()
-                timings = {config: self._bench(*args, config=config, **kwargs) for config in pruned_configs}
+                if self.screening and len(pruned_configs) > self.screening:
+                    self.screening_timings, timings, finalists = self._screen(*args, configs=pruned_configs,
+                                                                              **kwargs)
+                else:
+                    self._precompile(*args, configs=pruned_configs, **kwargs)
+                    timings, finalists = self._search(*args, configs=pruned_configs, **kwargs)
                 bench_end = time.time()
                 self.bench_time = bench_end - bench_start
-                self.cache[key] = builtins.min(timings, key=timings.get)
+                self.cache[key] = builtins.min(finalists, key=timings.get)
                 self.pre_hook(args, reset_only=True)
                 self.configs_timings = timings
-            config = self.cache[key]
+                if self.collect_metrics:
+                    self.configs_metrics = self._collect_metrics(*args, configs=list(timings), **kwargs)
+                    self.pre_hook(args, reset_only=True)
+                if self.cache_results:
+                    self._store_best_config(key, self.cache[key], timings)
+                self.reuse_counts.pop(key, None)
+                config = self.cache[key]
         else:
             config = self.configs[0]
         self.best_config = config
@@ -156,12 +368,8 @@ class Autotuner(KernelInterface):
             config.pre_hook(full_nargs)
         ret = self.fn.run(
             *args,
-            num_warps=config.num_warps,
-            num_stages=config.num_stages,
-            num_ctas=config.num_ctas,
-            enable_warp_specialization=config.enable_warp_specialization,
             **kwargs,
-            **config.kwargs,
+            **config.all_kwargs(),
         )
         self.nargs = None
         return ret
@@ -200,14 +408,8 @@ class Autotuner(KernelInterface):
             ret.append(
                 self.fn.warmup(
                     *args,
-                    num_warps=config.num_warps,
-                    num_ctas=config.num_ctas,
-                    num_stages=config.num_stages,
-                    enable_warp_specialization=config.enable_warp_specialization,
-                    # TODO: Make it configurable
-                    # enable_persistent=False,
                     **kwargs,
-                    **config.kwargs,
+                    **config.all_kwargs(),
                 ))
         self.nargs = None
         return ret
@@ -229,20 +431,68 @@ class Config:
     :ivar num_ctas: number of blocks in a block cluster. SM90+ only.
     :type enable_warp_specialization: bool
     :ivar enable_warp_specialization: enable specialization (spatial partitioning) or not. See https://docs.nvidia.com/cuda/cuda-c-programming-guide/index.html#spatial-partitioning-also-known-as-warp-specialization
+    :ivar threads_per_warp: the sub-group size (8, 16 or 32) to compile for on backends that support
+                            several. `None` leaves the choice to the backend.
+    :type threads_per_warp: int
+    :ivar split_k: the number of programs sharing the K loop of each GEMM output tile on backends
+                   that split it in the compiler. The partial results are added atomically, so the
+                   output must be zeroed before each launch (see `reset_to_zero`). `None` disables it.
+    :type split_k: int
+    :ivar unroll_factor: the factor short reduction loops are unrolled by at the Triton IR level on
+                         backends that support it. `None` leaves the choice to the backend.
+    :type unroll_factor: int
+    :ivar grf_mode: the register file size ("default", "large" or "auto") to compile for on backends
+                    that support several. `None` leaves the choice to the backend.
+    :type grf_mode: str
+    :ivar cluster_dims: the shape of the block cluster, whose product must be `num_ctas`, that the
+                        CTAs of GEMM kernels split the output tile over. `None` lets the compiler
+                        pick the split. SM90+ only.
+    :type cluster_dims: tuple
     :ivar pre_hook: a function that will be called before the kernel is called. Parameters of this
                     function are args.
     """
 
-    def __init__(self, kwargs, num_warps=4, num_stages=2, num_ctas=1, enable_warp_specialization=False, pre_hook=None):
+    def __init__(self, kwargs, num_warps=4, num_stages=2, num_ctas=1, enable_warp_specialization=False,
+                 threads_per_warp=None, split_k=None, unroll_factor=None, grf_mode=None, cluster_dims=None,
+                 pre_hook=None):
         self.kwargs = kwargs
         self.num_warps = num_warps
         self.num_ctas = num_ctas
         self.num_stages = num_stages
         self.enable_warp_specialization = enable_warp_specialization
+        self.threads_per_warp = threads_per_warp
+        self.split_k = split_k
+        self.unroll_factor = unroll_factor
+        self.grf_mode = grf_mode
+        self.cluster_dims = cluster_dims
         # TODO[shuhaoj]: May make enable_persistent configurable in future if necessary.
         self.enable_persistent = False
         self.pre_hook = pre_hook
 
+    def all_kwargs(self):
+        """
+        The meta-parameters and compilation options of this config, as the
+        keyword arguments of `JITFunction.run`.
+        """
+        options = {
+            "num_warps": self.num_warps,
+            "num_stages": self.num_stages,
+            "num_ctas": self.num_ctas,
+            "enable_warp_specialization": self.enable_warp_specialization,
+        }
+        # only backends with a configurable sub-group size accept this option
+        if self.threads_per_warp is not None:
+            options["threads_per_warp"] = self.threads_per_warp
+        if self.split_k is not None:
+            options["split_k"] = self.split_k
+        if self.unroll_factor is not None:
+            options["unroll_factor"] = self.unroll_factor
+        if self.grf_mode is not None:
+            options["grf_mode"] = self.grf_mode
+        if self.cluster_dims is not None:
+            options["cluster_dims"] = tuple(self.cluster_dims)
+        return {**options, **self.kwargs}
+
     def __str__(self):
         res = []
         for k, v in self.kwargs.items():
@@ -251,11 +501,22 @@ class Config:
         res.append(f"num_ctas: {self.num_ctas}")
         res.append(f"num_stages: {self.num_stages}")
         res.append(f"enable_warp_specialization: {self.enable_warp_specialization}")
+        if self.threads_per_warp is not None:
+            res.append(f"threads_per_warp: {self.threads_per_warp}")
+        if self.split_k is not None:
+            res.append(f"split_k: {self.split_k}")
+        if self.unroll_factor is not None:
+            res.append(f"unroll_factor: {self.unroll_factor}")
+        if self.grf_mode is not None:
+            res.append(f"grf_mode: {self.grf_mode}")
+        if self.cluster_dims is not None:
+            res.append(f"cluster_dims: {self.cluster_dims}")
         res.append(f"enable_persistent: {self.enable_persistent}")
         return ", ".join(res)
 
 
-def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_value=None, warmup=25, rep=100):
+def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_value=None, warmup=25, rep=100,
+             cache_results=False, screening=None, key_buckets=None, reuse_nearest=0):
     """
     Decorator for auto-tuning a :code:`triton.jit`'d function.
 
@@ -292,10 +553,31 @@ def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_va
     :type warmup: int
     :param rep: Repetition time (in ms) to pass to benchmarking, defaults to 100.
     :type rep: int
+    :param cache_results: whether to store the best config for each key through the cache manager
+        (see :code:`TRITON_CACHE_MANAGER`), so that processes using the same kernel, configs and device
+        reuse it instead of benchmarking again. Setting :code:`TRITON_CACHE_AUTOTUNING=1` enables it for
+        all autotuned kernels.
+    :type cache_results: bool
+    :param screening: when set, the configs are first timed compiled at a low optimization level, which
+        compiles much faster, and only the :code:`screening` fastest of them are compiled at full optimization
+        and timed again to pick the best one. :code:`TRITON_AUTOTUNE_SCREENING` sets it for all autotuned kernels.
+    :type screening: int
+    :param key_buckets: buckets the values of the :code:`key` arguments so that close shapes share their tuned
+        config: :code:`"pow2"` rounds them up to powers of two, a list of increasing bounds to the first bound
+        not below them, and a callable maps them itself. Either one for all the :code:`key` arguments or a dict
+        of them per argument name.
+    :type key_buckets: str, list[int], callable or dict
+    :param reuse_nearest: when set, the first :code:`reuse_nearest` calls with a key that was not tuned run
+        the config of the nearest tuned key with the same dtypes instead of benchmarking, and the key is tuned
+        on the next call. Keys are near when their numeric values have close log2.
+    :type reuse_nearest: int
+    :note: Setting :code:`TRITON_AUTOTUNE_METRICS=1` also samples the hardware counters of one run of every
+           benchmarked config, on drivers able to, into the :code:`configs_metrics` of the autotuner.
     """
 
     def decorator(fn):
-        return Autotuner(fn, fn.arg_names, configs, key, reset_to_zero, restore_value, prune_configs_by, warmup, rep)
+        return Autotuner(fn, fn.arg_names, configs, key, reset_to_zero, restore_value, prune_configs_by, warmup, rep,
+                         cache_results, screening, key_buckets, reuse_nearest)
 
     return decorator
 
@@ -1,6 +1,8 @@
 import json
+import mmap
 import os
 import random
+import threading
 from abc import ABC, abstractmethod
 from pathlib import Path
 from typing import Dict, Optional
@@ -36,6 +38,11 @@ class CacheManager(ABC):
     def put(self, data, filename, binary=True) -> str:
         pass
 
+    def get_bytes(self, filename):
+        """Returns the contents of `filename` as a bytes-like object, or `None` if it is not cached."""
+        path = self.get_file(filename)
+        return None if path is None else Path(path).read_bytes()
+
     @abstractmethod
     def get_group(self, filename: str) -> Optional[Dict[str, str]]:
         pass
@@ -111,7 +118,9 @@ class FileCacheManager(CacheManager):
         if not self.cache_dir:
             raise RuntimeError("Could not create or locate cache dir")
         binary = isinstance(data, bytes)
-        if not binary:
+        # IR modules print themselves to the file rather than to a string
+        streamed = not binary and hasattr(data, "write")
+        if not binary and not streamed:
             data = str(data)
         assert self.lock_path is not None
         filepath = self._make_path(filename)
@@ -121,15 +130,204 @@ class FileCacheManager(CacheManager):
         pid = os.getpid()
         # use tempfile to be robust against program interruptions
         temp_path = f"{filepath}.tmp.pid_{pid}_{rnd_id}"
-        mode = "wb" if binary else "w"
-        with open(temp_path, mode) as f:
-            f.write(data)
+        if streamed:
+            data.write(temp_path)
+        else:
+            mode = "wb" if binary else "w"
+            with open(temp_path, mode) as f:
+                f.write(data)
         # Replace is guaranteed to be atomic on POSIX systems if it succeeds
         # so filepath cannot see a partial write
         os.replace(temp_path, filepath)
         return filepath
 
 
+class _Pack:
+    """
+    The entries of all the keys of a cache directory, appended to a single pack
+    file. The index file has one `key/filename\toffset\tsize` line per entry,
+    later lines replacing earlier ones, and is written after the data it points
+    to, so a reader never sees an entry whose data is incomplete.
+    """
+
+    def __init__(self, cache_dir):
+        os.makedirs(cache_dir, exist_ok=True)
+        self.pack_path = os.path.join(cache_dir, "pack.bin")
+        self.index_path = os.path.join(cache_dir, "pack.idx")
+        for path in (self.pack_path, self.index_path):
+            open(path, "ab").close()
+        self.lock = threading.Lock()
+        self.entries = {}
+        self.index_pos = 0
+        self.map = None
+
+    def _read_index(self):
+        # reads the lines other processes appended since the last call,
+        # leaving out a line still being written
+        with open(self.index_path, "rb") as f:
+            f.seek(self.index_pos)
+            data = f.read()
+        end = data.rfind(b"\n") + 1
+        for line in data[:end].splitlines():
+            try:
+                name, offset, size = line.decode().rsplit("\t", 2)
+                self.entries[name] = (int(offset), int(size))
+            except ValueError:
+                # the line of an interrupted append
+                pass
+        self.index_pos += end
+
+    def lookup(self, name):
+        with self.lock:
+            entry = self.entries.get(name)
+            if entry is None:
+                self._read_index()
+                entry = self.entries.get(name)
+            return entry
+
+    def read(self, offset, size):
+        if size == 0:
+            return memoryview(b"")
+        with self.lock:
+            # entries appended after the pack was mapped need a new mapping;
+            # views of the previous one keep it alive
+            if self.map is None or len(self.map) < offset + size:
+                with open(self.pack_path, "rb") as f:
+                    self.map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+            return memoryview(self.map)[offset:offset + size]
+
+    def append(self, name, data):
+        import fcntl
+        with self.lock, open(self.index_path, "a+b") as index:
+            # the lock on the index serializes appends of all processes
+            fcntl.flock(index, fcntl.LOCK_EX)
+            try:
+                with open(self.pack_path, "ab") as pack:
+                    offset = pack.seek(0, os.SEEK_END)
+                    pack.write(data)
+                line = f"{name}\t{offset}\t{len(data)}\n".encode()
+                if index.seek(0, os.SEEK_END) > 0:
+                    index.seek(-1, os.SEEK_END)
+                    if index.read(1) != b"\n":
+                        line = b"\n" + line
+                index.write(line)
+                index.flush()
+            finally:
+                fcntl.flock(index, fcntl.LOCK_UN)
+            self.entries[name] = (offset, len(data))
+        return offset
+
+
+_packs: Dict[str, _Pack] = {}
+_packs_lock = threading.Lock()
+
+
+def _get_pack(cache_dir) -> _Pack:
+    with _packs_lock:
+        if cache_dir not in _packs:
+            _packs[cache_dir] = _Pack(cache_dir)
+        return _packs[cache_dir]
+
+
+def _parse_pack_location(location):
+    # pack:<pack path>:<offset>:<size>
+    if not location.startswith("pack:"):
+        return None
+    path, offset, size = location[len("pack:"):].rsplit(":", 2)
+    return path, int(offset), int(size)
+
+
+def read_cache_entry(location):
+    """
+    Returns the contents of an entry at a location a cache manager returned
+    from `put` or `get_group`, as a bytes-like object.
+    """
+    pack_location = _parse_pack_location(location)
+    if pack_location is None:
+        return Path(location).read_bytes()
+    path, offset, size = pack_location
+    return _get_pack(os.path.dirname(path)).read(offset, size)
+
+
+def _location_exists(location):
+    pack_location = _parse_pack_location(location)
+    if pack_location is None:
+        return os.path.exists(location)
+    return os.path.exists(pack_location[0])
+
+
+class PackCacheManager(CacheManager):
+    """
+    Stores the entries of all keys in a single memory-mapped pack file of the
+    cache directory instead of one file per entry. Lookups go through an
+    in-memory index and `get_bytes` returns views of the mapping. Callers that
+    need a path, e.g. to import a module, get a copy of the entry extracted to
+    the `files` directory. Select it with
+    `TRITON_CACHE_MANAGER=triton.runtime.cache:PackCacheManager`.
+    """
+
+    def __new__(cls, key, override=False, dump=False):
+        # overrides and dumps are directories of files meant to be edited by hand
+        if override or dump:
+            return FileCacheManager(key, override=override, dump=dump)
+        return super().__new__(cls)
+
+    def __init__(self, key, override=False, dump=False):
+        self.key = key
+        cache_dir = os.getenv("TRITON_CACHE_DIR", "").strip() or default_cache_dir()
+        if not cache_dir:
+            raise RuntimeError("Could not create or locate cache dir")
+        self.pack = _get_pack(cache_dir)
+        self.files_dir = os.path.join(cache_dir, "files", self.key)
+
+    def _lookup(self, filename):
+        return self.pack.lookup(f"{self.key}/{filename}")
+
+    def has_file(self, filename) -> bool:
+        return self._lookup(filename) is not None
+
+    def get_bytes(self, filename):
+        entry = self._lookup(filename)
+        return None if entry is None else self.pack.read(*entry)
+
+    def get_file(self, filename) -> Optional[str]:
+        entry = self._lookup(filename)
+        if entry is None:
+            return None
+        path = os.path.join(self.files_dir, filename)
+        if not os.path.exists(path):
+            os.makedirs(self.files_dir, exist_ok=True)
+            temp_path = f"{path}.tmp.pid_{os.getpid()}_{random.randint(0, 1000000)}"
+            with open(temp_path, "wb") as f:
+                f.write(self.pack.read(*entry))
+            os.replace(temp_path, path)
+        return path
+
+    def get_group(self, filename: str) -> Optional[Dict[str, str]]:
+        grp_data = self.get_bytes(f"__grp__{filename}")
+        if grp_data is None:
+            return None
+        child_paths = json.loads(bytes(grp_data)).get("child_paths", None)
+        # Invalid group data.
+        if child_paths is None:
+            return None
+        return {c: p for c, p in child_paths.items() if _location_exists(p)}
+
+    def put_group(self, filename: str, group: Dict[str, str]) -> str:
+        grp_contents = json.dumps({"child_paths": group})
+        return self.put(grp_contents, f"__grp__{filename}", binary=False)
+
+    def put(self, data, filename, binary=True) -> str:
+        if not isinstance(data, bytes):
+            data = str(data).encode("utf-8")
+        offset = self.pack.append(f"{self.key}/{filename}", data)
+        # an extracted copy of a previous version is stale
+        path = os.path.join(self.files_dir, filename)
+        if os.path.exists(path):
+            os.remove(path)
+        return f"pack:{self.pack.pack_path}:{offset}:{len(data)}"
+
+
 __cache_cls = FileCacheManager
 __cache_cls_nme = "DEFAULT"
 
@@ -0,0 +1,228 @@
+"""
+A compile server shared by the processes of a node, e.g. the ranks of a
+distributed job, so that each kernel is compiled once rather than once per
+process:
+
+    python -m triton.runtime.compile_server --socket /tmp/triton-compile.sock &
+    TRITON_COMPILE_SERVER=/tmp/triton-compile.sock python train.py
+
+On a cache miss, processes with `TRITON_COMPILE_SERVER` set send the Triton IR
+of the kernel, its options and its target to the server, which compiles it
+unless it already has, and copy the artifacts it returns to their own cache.
+Concurrent requests for the same kernel wait for a single compilation. The
+server only compiles kernels whose cache key it computes the same as the
+client, i.e. with the same Triton and the same environment; in every other
+case, and when the server cannot be reached, the client compiles locally.
+
+Requests and replies are pickled, so the socket is only accessible to the
+user that started the server.
+"""
+
+import argparse
+import os
+import pickle
+import socket
+import socketserver
+import struct
+import tempfile
+import threading
+import warnings
+from concurrent.futures import Future, ThreadPoolExecutor
+from pathlib import Path
+
+from .cache import read_cache_entry
+
+# size of the length prefix of each message
+_HEADER = struct.Struct("!Q")
+
+
+def send_message(sock, obj):
+    data = pickle.dumps(obj, protocol=pickle.HIGHEST_PROTOCOL)
+    sock.sendall(_HEADER.pack(len(data)) + data)
+
+
+def recv_message(sock):
+    size, = _HEADER.unpack(_recv_exactly(sock, _HEADER.size))
+    return pickle.loads(_recv_exactly(sock, size))
+
+
+def _recv_exactly(sock, size):
+    chunks = []
+    while size > 0:
+        chunk = sock.recv(min(size, 1 << 20))
+        if not chunk:
+            raise ConnectionError("compile server connection closed")
+        chunks.append(chunk)
+        size -= len(chunk)
+    return b"".join(chunks)
+
+
+class ServedSource:
+    """The source of a kernel sent to the server: the text of its Triton IR or TritonGPU IR module."""
+
+    def __init__(self, name, ext, ir, src_hash, metadata):
+        self.name = name
+        self.ext = ext
+        self.src = ir
+        self.src_hash = src_hash
+        self._metadata = metadata
+
+    def hash(self):
+        # the hash of the client's source, so that both compute the same cache key
+        return self.src_hash
+
+    def make_ir(self, options, context):
+        from .._C.libtriton import ir
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, f"{self.name}.{self.ext}")
+            Path(path).write_text(self.src)
+            module = ir.parse_mlir_module(path, context, strip_locations=False)
+        module.context = context
+        return module
+
+    def metadata(self):
+        return self._metadata
+
+    def parse_options(self):
+        # the client sends the options it already parsed
+        return dict()
+
+
+class CompileServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    """Compiles the kernels requested on the socket at `path` on up to `num_threads` threads."""
+
+    daemon_threads = True
+
+    def __init__(self, path, num_threads=None):
+        if os.path.exists(path):
+            os.unlink(path)
+        # the socket file is created with the permissions the umask leaves
+        old_umask = os.umask(0o177)
+        try:
+            super().__init__(path, _CompileRequestHandler)
+        finally:
+            os.umask(old_umask)
+        self.executor = ThreadPoolExecutor(max_workers=num_threads or os.cpu_count() or 1)
+        self.lock = threading.Lock()
+        # futures of the compilations in flight, by cache key
+        self.pending = dict()
+        # number of kernels compiled, not counting the requests that waited for another one
+        self.num_compiled = 0
+
+    def server_close(self):
+        super().server_close()
+        self.executor.shutdown(wait=False)
+        if os.path.exists(self.server_address):
+            os.unlink(self.server_address)
+
+    def compile(self, request):
+        """Returns the artifacts of the kernel of `request` by file name, compiling it once for concurrent requests."""
+        with self.lock:
+            future = self.pending.get(request["hash"])
+            if future is None:
+                future = self.pending[request["hash"]] = Future()
+                owner = True
+            else:
+                owner = False
+        if owner:
+            try:
+                future.set_result(self.executor.submit(self._compile, request).result())
+            except BaseException as e:
+                future.set_exception(e)
+            finally:
+                with self.lock:
+                    del self.pending[request["hash"]]
+        return future.result()
+
+    def _compile(self, request):
+        from ..compiler.compiler import compile_group, compile_keys, make_backend
+        src = ServedSource(request["name"], request["ext"], request["ir"], request["src_hash"], request["metadata"])
+        target = request["target"]
+        backend = make_backend(target)
+        options = backend.parse_options(dict(request["options"]))
+        _, hash = compile_keys(src, backend, options)
+        if hash != request["hash"]:
+            raise RuntimeError("the cache key differs from the client's: different Triton or environment")
+        metadata_group = compile_group(src, target, request["options"])
+        with self.lock:
+            self.num_compiled += 1
+        return {filename: bytes(read_cache_entry(path)) for filename, path in metadata_group.items()}
+
+
+class _CompileRequestHandler(socketserver.BaseRequestHandler):
+
+    def handle(self):
+        try:
+            request = recv_message(self.request)
+        except (ConnectionError, pickle.UnpicklingError, struct.error):
+            return
+        try:
+            reply = {"files": self.server.compile(request)}
+        except Exception as e:
+            reply = {"error": f"{type(e).__name__}: {e}"}
+        try:
+            send_message(self.request, reply)
+        except OSError:
+            pass
+
+
+class CompileClient:
+    """Sends compile requests to the server listening on the socket at `path`."""
+
+    def __init__(self, path):
+        self.path = path
+        self.warned = False
+
+    def compile(self, request):
+        """Returns the artifacts of the kernel of `request` by file name, or `None` if the server did not compile it."""
+        try:
+            with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+                sock.connect(self.path)
+                send_message(sock, request)
+                reply = recv_message(sock)
+        except (OSError, ConnectionError, pickle.UnpicklingError, struct.error) as e:
+            self._warn(f"cannot reach the compile server at {self.path}: {e}")
+            return None
+        if "error" in reply:
+            self._warn(f"the compile server at {self.path} failed: {reply['error']}")
+            return None
+        return reply["files"]
+
+    def _warn(self, message):
+        # once per process: compiling locally is a fallback, not an error
+        if not self.warned:
+            self.warned = True
+            warnings.warn(f"{message}; compiling locally")
+
+
+_clients = dict()
+_clients_lock = threading.Lock()
+
+
+def get_client():
+    """The client of the server at `TRITON_COMPILE_SERVER`, if set."""
+    path = os.getenv("TRITON_COMPILE_SERVER", "").strip()
+    if not path:
+        return None
+    with _clients_lock:
+        client = _clients.get(path)
+        if client is None:
+            client = _clients[path] = CompileClient(path)
+        return client
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--socket", required=True, help="path of the Unix socket to listen on")
+    parser.add_argument("--threads", type=int, default=None, help="number of kernels compiled at once")
+    args = parser.parse_args()
+    with CompileServer(args.socket, args.threads) as server:
+        print(f"compile server listening on {args.socket}")
+        try:
+            server.serve_forever()
+        except KeyboardInterrupt:
+            pass
+
+
+if __name__ == "__main__":
+    main()
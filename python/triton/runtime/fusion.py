@@ -0,0 +1,96 @@
+from __future__ import annotations
+
+import hashlib
+
+from .._C.libtriton import ir, passes
+from .cache import get_cache_manager
+from .driver import driver
+
+
+class FusedKernel:
+    """
+    The kernels given to `fuse_kernels`, launched at once. Calling it with the
+    positional arguments of each kernel, in order, launches them on the grids
+    and with the keyword arguments they were fused for.
+    """
+
+    def __init__(self, kernel, launches):
+        self.kernel = kernel
+        self.launches = launches
+        self.num_programs = sum(grid[0] * grid[1] * grid[2] for _, grid, _, _, _ in launches)
+
+    def _launch_args(self, args):
+        launch_args = []
+        for (fn, _, kwargs, folded, _), fn_args in zip(self.launches, args):
+            bound_args = fn.signature.bind(*fn_args, **kwargs)
+            bound_args.apply_defaults()
+            # the arguments the kernel was specialized on are not passed
+            launch_args += [
+                value for i, (value, param) in enumerate(zip(bound_args.arguments.values(), fn.params))
+                if not param.is_constexpr and i not in folded
+            ]
+        return launch_args
+
+    def __call__(self, *args):
+        from ..compiler import CompiledKernel
+        assert len(args) == len(self.launches), "expected the arguments of each fused kernel"
+        device = driver.active.get_current_device()
+        stream = driver.active.get_current_stream(device)
+        kernel = self.kernel
+        metadata = kernel.metadata
+        kernel.run(self.num_programs, 1, 1, metadata.num_warps, metadata.num_ctas, metadata.cluster_dims[0],
+                   metadata.cluster_dims[1], metadata.cluster_dims[2], metadata.shared, stream, kernel.function,
+                   CompiledKernel.launch_enter_hook, CompiledKernel.launch_exit_hook, metadata,
+                   *self._launch_args(args))
+
+
+def fuse_kernels(launches, name="fused"):
+    """
+    Fuses independent kernels, each given as `(kernel, grid, args)` or
+    `(kernel, grid, args, kwargs)` like for `launch_batch`, into one kernel
+    launched on a 1D grid of the total number of their programs, each range
+    of which runs one of them. `args` are only used to specialize the kernels;
+    the returned `FusedKernel` is called with the arguments of every launch.
+    The kernels must be compiled with the same options, must not synchronize
+    across their programs, and must not depend on the order they run in.
+    """
+    from ..compiler import compile, make_backend
+    assert launches, "expected at least one kernel to fuse"
+    target = driver.active.get_current_target()
+    backend = make_backend(target)
+    sources, grids, fused_launches = [], [], []
+    fused_options = None
+    for launch in launches:
+        fn, grid, args = launch[:3]
+        kwargs = launch[3] if len(launch) > 3 else {}
+        options = backend.parse_options({**kwargs, "debug": fn.debug})
+        assert fused_options in (None, options), "fused kernels must be compiled with the same options"
+        fused_options = options
+        if callable(grid):
+            bound_args = fn.signature.bind(*args, **kwargs)
+            bound_args.apply_defaults()
+            grid = grid(dict(bound_args.arguments))
+        grid = tuple(grid) + (1, ) * (3 - len(grid))
+        kernel = fn.warmup(*args, grid=grid, **kwargs)
+        metadata = kernel.metadata
+        if getattr(metadata, "cooperative", False) or getattr(metadata, "split_k", 1) > 1:
+            raise ValueError(f"{kernel.name} cannot be fused: it synchronizes across its programs")
+        sources.append(kernel.asm["ttir"])
+        grids.append(list(grid))
+        fn_kwargs = {k: v for k, v in kwargs.items() if k not in options.__dict__}
+        fused_launches.append((fn, grid, fn_kwargs, set(metadata.ids_of_folded_args), kernel))
+
+    context = ir.context()
+    ir.load_dialects(context)
+    backend.load_dialects(context)
+    module = ir.merge_kernel_modules(sources, grids, context)
+    pm = ir.pass_manager(context)
+    pm.enable_debug()
+    passes.ttir.add_fuse_kernels(pm, name)
+    pm.run(module)
+
+    src = str(module)
+    key = hashlib.sha256(src.encode("utf-8")).hexdigest()
+    path = get_cache_manager(key).put(src, f"{name}.ttir", binary=False)
+    kernel = compile(path, target=target, options=fused_options.__dict__)
+    return FusedKernel(kernel, fused_launches)
@@ -1,4 +1,8 @@
 import inspect
+import itertools
+import os
+import threading
+from concurrent.futures import ThreadPoolExecutor
 
 import numpy as np
 
@@ -56,21 +60,17 @@ class BlockPointerHandle:
         self.tensor_shape = tensor_shape
         self.order = order
 
-    def materialize_pointers(self, boundary_check):
-        dtype_tt = self.base.dtype.element_ty
-        n_bytes = dtype_tt.primitive_bitwidth // 8
-        tensor_shape = self.tensor_shape
-        ptrs = np.broadcast_to(self.base.data, self.tensor_shape)
-        masks = np.ones(self.tensor_shape, dtype=bool)
-        for dim in range(len(tensor_shape)):
-            bcast_dims = [1] * len(tensor_shape)
-            bcast_dims[dim] = tensor_shape[dim]
-            off = (self.offsets[dim].data + np.arange(tensor_shape[dim])).reshape(bcast_dims)
-            ptrs = ptrs + (n_bytes * off * self.strides[dim].data).astype(np.uint64)
-            if dim in boundary_check:
-                masks = np.logical_and(masks, off < self.shape[dim].data)
-        ptrs = TensorHandle(ptrs, self.base.dtype)
-        return ptrs, masks
+    def block_args(self, boundary_check):
+        """The description of the block the native block loads and stores take."""
+        scalar = lambda handle: int(handle.data.reshape(-1)[0])
+        return (
+            scalar(self.base),
+            [scalar(s) for s in self.shape],
+            [scalar(s) for s in self.strides],
+            [scalar(o) for o in self.offsets],
+            list(self.tensor_shape),
+            [dim in boundary_check for dim in range(len(self.tensor_shape))],
+        )
 
 
 def wrap_ret(compute_ret_ty):
@@ -86,17 +86,26 @@ def wrap_ret(compute_ret_ty):
     return wrapper
 
 
+class InterpreterOptions:
+    # float atomic min and max are native operations of the interpreter
+    native_float_atomic_minmax = True
+    max_num_imprecise_acc_default = 0
+    allow_fp8e4nv = False
+
+
 class Builder:
 
     def __init__(self) -> None:
         self.arch = None
-        # pass
+        self.options = InterpreterOptions()
+        # programs run concurrently on several threads, each with its own id
+        self._program = threading.local()
 
     def set_grid_idx(self, x, y, z):
         assert x < self.grid_dim[0]
         assert y < self.grid_dim[1]
         assert z < self.grid_dim[2]
-        self.grid_idx = (x, y, z)
+        self._program.grid_idx = (x, y, z)
 
     def set_grid_dim(self, nx, ny, nz):
         self.grid_dim = (nx, ny, nz)
@@ -152,8 +161,9 @@ class Builder:
 
     # programming model
     def create_get_program_id(self, axis):
-        assert self.grid_idx is not None
-        return TensorHandle(np.array([self.grid_idx[axis]], dtype=np.int32), tl.int32)
+        grid_idx = getattr(self._program, "grid_idx", None)
+        assert grid_idx is not None
+        return TensorHandle(np.array([grid_idx[axis]], dtype=np.int32), tl.int32)
 
     def create_get_num_programs(self, axis):
         return TensorHandle(np.array([self.grid_dim[axis]], dtype=np.int32), tl.int32)
@@ -179,6 +189,10 @@ class Builder:
     def create_masked_store(self, ptrs, value, mask, cache_modifier, eviction_policy):
         return _interpreter.store(ptrs.data, value.data, mask.data)
 
+    def create_prefetch(self, ptr, mask, cache_level):
+        # Prefetching has no effect on the results
+        pass
+
     # casting ops
     def cast_impl(self, src, dst_type):
         if isinstance(dst_type, tl.tensor):
@@ -274,7 +288,15 @@ class Builder:
     create_trans = lambda self, arg: self.unary_op(arg, np.transpose)
 
     def create_dot(self, a, b, d, allow_tf32, maxNumImpreciseAcc):
-        return TensorHandle(np.dot(a.data, b.data) + d.data, a.dtype)
+        if a.data.ndim == 3:
+            # one product per batch
+            return TensorHandle(np.stack([_interpreter.dot(*operands) for operands in zip(a.data, b.data, d.data)]),
+                                d.dtype)
+        return TensorHandle(_interpreter.dot(a.data, b.data, d.data), d.dtype)
+
+    def create_dot_scaled(self, a, a_scale, b, b_scale, d, allow_tf32, maxNumImpreciseAcc):
+        product = _interpreter.dot(a.data, b.data, np.zeros_like(d.data))
+        return TensorHandle(product * np.outer(a_scale.data, b_scale.data) + d.data, d.dtype)
 
     def create_make_range(self, start, stop):
         return TensorHandle(np.arange(start, stop, dtype=np.int32), tl.int32)
@@ -287,14 +309,16 @@ class Builder:
 
     def create_tensor_pointer_load(self, ptr, boundary_check, padding_option, cache_modifier, eviction_policy,
                                    is_volatile):
-        ptrs, masks = ptr.materialize_pointers(boundary_check)
         assert padding_option is None
-        other = None
-        return self.create_masked_load(ptrs, masks, other, cache_modifier, eviction_policy, is_volatile)
+        dtype_tt = ptr.base.dtype.element_ty
+        base, shape, strides, offsets, tensor_shape, checks = ptr.block_args(boundary_check)
+        ret = _interpreter.load_block(base, shape, strides, offsets, tensor_shape, checks, self.np_dtype(dtype_tt))
+        return TensorHandle(ret, dtype_tt)
 
     def create_tensor_pointer_store(self, ptr, value, boundary_check, cache_modifier, eviction_policy):
-        ptrs, masks = ptr.materialize_pointers(boundary_check)
-        return self.create_masked_store(ptrs, value, masks, cache_modifier, eviction_policy)
+        base, shape, strides, offsets, tensor_shape, checks = ptr.block_args(boundary_check)
+        value = np.broadcast_to(value.data, tensor_shape).astype(self.np_dtype(ptr.base.dtype.element_ty), copy=False)
+        return _interpreter.store_block(base, shape, strides, offsets, value, checks)
 
     def create_expand_dims(self, arg, axis):
         return TensorHandle(np.expand_dims(arg.data, axis), arg.dtype)
@@ -311,14 +335,32 @@ class Builder:
     # def create_broadcast(self, arg, shape):
     #     pass
 
+    def create_gather(self, src, index, axis):
+        return TensorHandle(np.take_along_axis(src.data, index.data, axis=axis), src.dtype)
+
+    def create_sort(self, arg, axis, descending):
+        data = arg.data
+        # Like tt.sort, compare integers as signed.
+        if arg.dtype.is_int_unsigned():
+            data = data.view(f"int{arg.dtype.int_bitwidth}")
+        ret = np.sort(data, axis=axis).view(arg.data.dtype)
+        if descending:
+            ret = np.flip(ret, axis=axis)
+        return TensorHandle(ret, arg.dtype)
+
     def create_splat(self, arg, shape):
         return TensorHandle(np.full(shape, arg.data[0], dtype=self.np_dtype(arg.dtype)), arg.dtype)
 
-    # def create_atomic_cas(self, ptr, cmp, val, sem):
-    #     pass
+    def create_atomic_cas(self, ptr, cmp, val, sem, scope):
+        shape = ptr.data.shape
+        ret = _interpreter.atomic_cas(ptr.data, np.broadcast_to(cmp.data, shape), np.broadcast_to(val.data, shape))
+        return TensorHandle(ret, val.dtype)
 
-    # def create_atomic_rmw(self, rmwOp, ptr, val, mask, sem):
-    #     pass
+    def create_atomic_rmw(self, rmwOp, ptr, val, mask, sem, scope):
+        shape = ptr.data.shape
+        ret = _interpreter.atomic_rmw(rmwOp.name, ptr.data, np.broadcast_to(val.data, shape),
+                                      np.broadcast_to(mask.data, shape))
+        return TensorHandle(ret, val.dtype)
 
     # def create_extern_elementwise(self, libName, libPath, symbol, argList, retType, isPure):
     #     pass
@@ -504,11 +546,22 @@ class GridExecutor:
         assert len(grid) <= 3
         grid = grid + (1, ) * (3 - len(grid))
         builder.set_grid_dim(*grid)
-        for x in range(grid[0]):
-            for y in range(grid[1]):
-                for z in range(grid[2]):
-                    builder.set_grid_idx(x, y, z)
-                    self.fn(**args)
+
+        def run_program(idx):
+            builder.set_grid_idx(*idx)
+            self.fn(**args)
+
+        # Programs are independent, and numpy and the native loads and stores
+        # release the GIL, so they run on a pool of threads.
+        program_ids = list(itertools.product(range(grid[0]), range(grid[1]), range(grid[2])))
+        num_threads = min(int(os.getenv("TRITON_INTERPRET_THREADS", os.cpu_count() or 1)), len(program_ids))
+        if num_threads <= 1:
+            for idx in program_ids:
+                run_program(idx)
+        else:
+            with ThreadPoolExecutor(max_workers=num_threads) as executor:
+                # re-raises the first error of a program
+                list(executor.map(run_program, program_ids))
         # copy arguments back to propagate side-effects
         for arg_dev, arg_hst in zip(args_dev, args_hst):
             if hasattr(arg_dev, "data_ptr"):
@@ -4,10 +4,14 @@ import hashlib
 import inspect
 import os
 import textwrap
-from collections import defaultdict, namedtuple
+import threading
+from collections import OrderedDict, defaultdict, namedtuple
+from concurrent.futures import ThreadPoolExecutor
 from functools import cached_property
 from typing import Callable, Generic, Iterable, List, Optional, TypeVar, Union, cast, overload
+from .._C.libtriton import jit as _jit
 from ..runtime.driver import driver
+from . import manifest
 
 TRITON_MODULE = __name__[:-len(".runtime.jit")]
 
@@ -78,10 +82,11 @@ class KernelParam:
     KernelArg.
     """
 
-    def __init__(self, num: int, param: inspect.Parameter, do_not_specialize: bool):
+    def __init__(self, num: int, param: inspect.Parameter, do_not_specialize: bool, specialize_value: bool = False):
         self.num = num
         self._param = param
         self.do_not_specialize = do_not_specialize
+        self.specialize_value = specialize_value
 
     @cached_property
     def name(self):
@@ -97,6 +102,10 @@ class KernelParam:
     def is_constexpr(self):
         return "constexpr" in self.annotation
 
+    @cached_property
+    def is_restrict(self):
+        return "restrict" in self.annotation
+
     @property
     def default(self):
         return self._param.default
@@ -105,6 +114,20 @@ class KernelParam:
     def has_default(self):
         return self._param.default != inspect.Parameter.empty
 
+    @cached_property
+    def key_info(self):
+        """What the native cache key computation needs to know about the parameter."""
+        annotation = self.annotation
+        if "Tensor" in annotation:
+            kind = 1
+        elif annotation == "bool":
+            kind = 2
+        elif annotation == "float":
+            kind = 3
+        else:
+            kind = 0
+        return _jit.ParamInfo(kind, self.is_constexpr, self.do_not_specialize)
+
 
 class KernelArg:
     """Represents an argument to a @jit'ed function.
@@ -170,6 +193,13 @@ class JITFunction(KernelInterface[T]):
     # So whether the LoadOp and StoreOp will lowering into TMA copy depend on whether the tensor stride is divisible by 8.
     # TODO: Make it more reasonable to handle multiple dtypes.
     divisibility_8 = 8
+    # Number of distinct values of the `specialize_values` arguments a kernel
+    # keeps compiled kernels for; the least recently used ones are dropped.
+    max_value_specializations = 8
+    # Threads compiling the specialized kernels of `async_compile` kernels.
+    async_compile_threads = 1
+    _async_compile_executor = None
+    _async_compile_lock = threading.Lock()
 
     @staticmethod
     def _key_of(arg):
@@ -234,15 +264,34 @@ class JITFunction(KernelInterface[T]):
             for param, arg in zip(self.params, args)
             if isinstance(arg, int) and not isinstance(arg, bool) and arg == 1 and not param.do_not_specialize
         }
-        # folded equal_to_1 and None
+        # folded equal_to_1, None and specialized values
         # TODO: method to collect all folded args
         none_args = {param.num for param, arg in zip(self.params, args) if arg is None and not param.do_not_specialize}
-        ids_of_folded_args = equal_to_1 | none_args
+        value_args = {param.num for param, arg in zip(self.params, args) if self._is_specialized_value(param, arg)}
+        ids_of_folded_args = equal_to_1 | none_args | value_args
         return AttrsDescriptor(tuple(divisible_by_16), tuple(equal_to_1), tuple(ids_of_folded_args),
                                tuple(divisible_by_8))
         # return _triton.code_gen.instance_descriptor(divisible_by_16,
         # equal_to_1)
 
+    @staticmethod
+    def _is_specialized_value(param, arg):
+        return param.specialize_value and isinstance(arg, int) and not isinstance(arg, bool)
+
+    def _use_value_specialization(self, device, value_key):
+        # Drops the kernels of the least recently used values once more than
+        # `max_value_specializations` are live, which bounds recompilation.
+        values = self.value_specializations[device]
+        if value_key in values:
+            values.move_to_end(value_key)
+            return
+        values[value_key] = None
+        if len(values) > JITFunction.max_value_specializations:
+            evicted, _ = values.popitem(last=False)
+            cache = self.cache[device]
+            for key in [key for key in cache if key[-1] == evicted]:
+                del cache[key]
+
     @staticmethod
     def _type_of(key):
         # `None` is nullptr.  Implicitly convert to *i8.
@@ -331,6 +380,58 @@ class JITFunction(KernelInterface[T]):
             already_compiled=False,
         )
 
+    @classmethod
+    def _get_async_compile_executor(cls):
+        with cls._async_compile_lock:
+            if JITFunction._async_compile_executor is None:
+                JITFunction._async_compile_executor = ThreadPoolExecutor(max_workers=cls.async_compile_threads,
+                                                                         thread_name_prefix="triton-compile")
+            return JITFunction._async_compile_executor
+
+    def _get_pending_kernel(self, device, key):
+        """
+        Returns the kernel to launch for `key` while its specialized kernel is
+        compiled in the background: the fallback until it is ready, then the
+        specialized one. Returns None if `key` isn't being compiled.
+        """
+        pending = self.pending[device].get(key)
+        if pending is None:
+            return None
+        future, fallback = pending
+        if not future.done():
+            return fallback
+        del self.pending[device][key]
+        # raises the error of a failed compilation
+        return future.result()
+
+    def _compile_async(self, device, key, src, target, options):
+        """
+        Compiles the kernel of `key` in the background and returns the kernel
+        to launch meanwhile: the one compiled without the divisibility hints of
+        `src`, which are the only ones that don't change how it is called.
+        """
+        from ..compiler import AttrsDescriptor, ASTSource, compile
+        attrs = src.attrs
+        generic = AttrsDescriptor(tuple(), tuple(attrs.equal_to_1), tuple(attrs.ids_of_folded_args), tuple())
+        if not attrs.divisible_by_16 and not attrs.divisible_by_8:
+            kernel = self.cache[device][key] = compile(src, target=target, options=options.__dict__)
+            return kernel
+        fallback_key = (key[0], key[1], tuple(sorted(attrs.ids_of_folded_args)), *key[3:])
+        fallback = self.fallbacks[device].get(fallback_key)
+        if fallback is None:
+            generic_src = ASTSource(self, src.signature, src.constants, generic)
+            fallback = self.fallbacks[device][fallback_key] = compile(generic_src, target=target,
+                                                                      options=options.__dict__)
+
+        def compile_specialized():
+            kernel = compile(src, target=target, options=options.__dict__)
+            self.cache[device][key] = kernel
+            return kernel
+
+        future = self._get_async_compile_executor().submit(compile_specialized)
+        self.pending[device][key] = (future, fallback)
+        return fallback
+
     def run(self, *args, grid, warmup, **kwargs):
         from ..compiler import CompiledKernel, compile, ASTSource, make_backend
         # deprecated arguments
@@ -345,34 +446,51 @@ class JITFunction(KernelInterface[T]):
         kwargs["debug"] = self.debug
         options = backend.parse_options(kwargs)
         # bind non-reserved keyword args and set defaults
+        all_kwargs = kwargs
         kwargs = {k: v for k, v in kwargs.items() if not k in options.__dict__}
-        bound_args = self.signature.bind(*args, **kwargs)
-        bound_args.apply_defaults()
-        assert len(bound_args.arguments) == len(self.params)
+        if not kwargs and len(args) == len(self.params):
+            # All arguments are positional, there is nothing to bind.
+            arg_values = args
+        else:
+            bound_args = self.signature.bind(*args, **kwargs)
+            bound_args.apply_defaults()
+            arg_values = tuple(bound_args.arguments.values())
+        assert len(arg_values) == len(self.params)
         # canonicalize grid
         assert grid is not None
         if callable(grid):
             # Arguments are passed as a dict to `grid`, by contract.
             # TODO(jlebar): In the new launch API, pass the compiler flags as a
             # second parameter to `grid`.
-            grid = grid(dict(bound_args.arguments))
+            grid = grid(dict(zip(self.arg_names, arg_values)))
         grid_size = len(grid)
         grid_0 = grid[0]
         grid_1 = grid[1] if grid_size > 1 else 1
         grid_2 = grid[2] if grid_size > 2 else 1
         # compute cache key
-        args = [KernelArg(arg_value, param) for (_, arg_value), param in zip(bound_args.arguments.items(), self.params)]
-        sig_key = tuple(arg.signature_key() for arg in args if not arg.param.is_constexpr)
-        spec_key = tuple(arg.specialization_key() for arg in args if not arg.param.do_not_specialize)
-        constexpr_key = tuple(arg.value for arg in args if arg.param.is_constexpr)
+        sig_key, constexpr_key, spec_key = _jit.get_cache_key(arg_values, self._key_infos, JITFunction.divisibility,
+                                                              JITFunction.divisibility_8)
         key = (sig_key, constexpr_key, spec_key, options)
+        if self.specialized_values:
+            value_key = tuple(arg_values[i] if self._is_specialized_value(self.params[i], arg_values[i]) else None
+                              for i in self.specialized_values)
+            key = key + (value_key, )
+            self._use_value_specialization(device, value_key)
+        kernel = self.cache[device].get(key)
+        if kernel is None and self.async_compile:
+            kernel = self._get_pending_kernel(device, key)
         # Kernel is not cached; we have to compile.
-        if key not in self.cache[device]:
+        if kernel is None:
+            args = [KernelArg(arg_value, param) for arg_value, param in zip(arg_values, self.params)]
+            if manifest.is_recording():
+                option_kwargs = {k: v for k, v in all_kwargs.items() if k in options.__dict__ and k != "debug"}
+                manifest.record(self, arg_values, option_kwargs)
             configs = (self._get_config(*[arg.value for arg in args]), )
             constants = {
                 arg.param.num: arg.value
                 for arg in args
                 if arg.param.is_constexpr or arg.param.num in configs[0].equal_to_1 or arg.value is None
+                or self._is_specialized_value(arg.param, arg.value)
             }
             for i, arg in constants.items():
                 if callable(arg):
@@ -391,16 +509,20 @@ class JITFunction(KernelInterface[T]):
                 return None
             # compile the kernel
             src = ASTSource(self, signature, constants, configs[0])
-            self.cache[device][key] = compile(
-                src,
-                target=target,
-                options=options.__dict__,
-            )
+            if self.async_compile and not warmup:
+                kernel = self._compile_async(device, key, src, target, options)
+            else:
+                kernel = self.cache[device][key] = compile(
+                    src,
+                    target=target,
+                    options=options.__dict__,
+                )
 
-        kernel = self.cache[device][key]
         if not warmup:
-            args = [arg.value for arg in args if not arg.param.is_constexpr]
+            args = [arg_value for arg_value, param in zip(arg_values, self.params) if not param.is_constexpr]
             metadata = kernel.metadata
+            if getattr(metadata, "cooperative", False):
+                kernel.check_cooperative_grid(grid_0, grid_1, grid_2)
             kernel.run(grid_0, grid_1, grid_2, metadata.num_warps,
                        metadata.num_ctas,  # number of warps/ctas per instance
                        metadata.cluster_dims[0], metadata.cluster_dims[1], metadata.cluster_dims[2],  # cluster
@@ -409,8 +531,10 @@ class JITFunction(KernelInterface[T]):
                        *driver.active.assemble_tensormap_to_arg(metadata.tensormaps_info, args))
         return kernel
 
-    def __init__(self, fn, version=None, do_not_specialize=None, debug=None, noinline=None):
+    def __init__(self, fn, version=None, do_not_specialize=None, debug=None, noinline=None, specialize_values=None,
+                 async_compile=False):
         do_not_specialize = do_not_specialize if do_not_specialize else []
+        specialize_values = specialize_values if specialize_values else []
 
         self.fn = fn
         self.module = fn.__module__
@@ -422,13 +546,23 @@ class JITFunction(KernelInterface[T]):
         self.params = []
         for i, param in enumerate(self.signature.parameters.values()):
             dns = do_not_specialize and (i in do_not_specialize or param.name in do_not_specialize)
-            self.params.append(KernelParam(i, param, dns))
+            sv = specialize_values and (i in specialize_values or param.name in specialize_values)
+            assert not (dns and sv), f"argument {param.name} can not be both specialized and not specialized"
+            self.params.append(KernelParam(i, param, dns, sv))
 
         # function source code (without decorators)
         self.src = textwrap.dedent(inspect.getsource(fn))
         self.src = self.src[self.src.find("def"):]
         # cache of just-in-time compiled kernels
         self.cache = defaultdict(dict)
+        # recently used values of the `specialize_values` arguments
+        self.specialized_values = [p.num for p in self.params if p.specialize_value]
+        self.value_specializations = defaultdict(OrderedDict)
+        # with `async_compile`, the (future, fallback kernel) of the kernels
+        # compiled in the background, and the fallbacks by signature
+        self.async_compile = async_compile
+        self.pending = defaultdict(dict)
+        self.fallbacks = defaultdict(dict)
         self.hash = None
         # JITFunction can be instantiated as kernel
         # when called with a grid using __getitem__
@@ -440,6 +574,7 @@ class JITFunction(KernelInterface[T]):
         # remove the fields here.
         self.arg_names = [p.name for p in self.params]
         self.constexprs = [p.num for p in self.params if p.is_constexpr]
+        self._key_infos = [p.key_info for p in self.params]
 
         # reuse docs of wrapped function
         self.__doc__ = fn.__doc__
@@ -500,6 +635,8 @@ def jit(
     do_not_specialize: Optional[Iterable[int]] = None,
     debug: Optional[bool] = None,
     noinline: Optional[bool] = None,
+    specialize_values: Optional[Iterable[int]] = None,
+    async_compile: bool = False,
 ) -> Callable[[T], JITFunction[T]]:
     ...
 
@@ -511,6 +648,8 @@ def jit(
     do_not_specialize: Optional[Iterable[int]] = None,
     debug: Optional[bool] = None,
     noinline: Optional[bool] = None,
+    specialize_values: Optional[Iterable[int]] = None,
+    async_compile: bool = False,
 ) -> Union[JITFunction[T], Callable[[T], JITFunction[T]]]:
     """
     Decorator for JIT-compiling a function using the Triton compiler.
@@ -528,6 +667,20 @@ def jit(
 
     :param fn: the function to be jit-compiled
     :type fn: Callable
+    :param specialize_values: integer arguments, by index or name, whose values
+        are compiled into the kernel as constants, like :code:`tl.constexpr`
+        ones, without changing how the kernel is called. Each new value
+        compiles a new kernel; only the :code:`JITFunction.max_value_specializations`
+        most recently used values are kept.
+    :type specialize_values: Iterable[int | str], optional
+    :param async_compile: on a cache miss, compile the kernel in the background
+        instead of blocking the launch. Until it is ready, launches run a
+        kernel compiled without the divisibility hints of the arguments, which
+        is only compiled once for all the values of the arguments with the same
+        types, constants and values equal to 1. Errors of the background
+        compilation are raised by the next launch that needs it. Not meant for
+        kernels being autotuned, which would time the fallback.
+    :type async_compile: bool, optional
     """
 
     def decorator(fn: T) -> JITFunction[T]:
@@ -542,6 +695,8 @@ def jit(
                 do_not_specialize=do_not_specialize,
                 debug=debug,
                 noinline=noinline,
+                specialize_values=specialize_values,
+                async_compile=async_compile,
             )
 
     if fn is not None:
@@ -597,6 +752,51 @@ class TensorWrapper:
         return self.base.element_size()
 
 
+class PersistentGrid:
+    """
+    The grid of a persistent kernel: `programs_per_core` programs for each
+    multiprocessor (Xe core on XPU) of the current device, and not more than
+    `num_tiles(args)` programs when it is given:
+
+        grid = triton.PersistentGrid(num_tiles=lambda args: triton.cdiv(args["N"], args["BLOCK"]))
+        kernel[grid](...)
+
+    Programs then loop over their tiles with `tl.next_tile`.
+    """
+    _multiprocessor_counts = {}
+
+    def __init__(self, programs_per_core=1, num_tiles=None):
+        self.programs_per_core = programs_per_core
+        self.num_tiles = num_tiles
+
+    @staticmethod
+    def multiprocessor_count(device):
+        count = PersistentGrid._multiprocessor_counts.get(device)
+        if count is None:
+            count = driver.active.utils.get_device_properties(device)["multiprocessor_count"]
+            PersistentGrid._multiprocessor_counts[device] = count
+        return count
+
+    def __call__(self, args):
+        size = self.programs_per_core * PersistentGrid.multiprocessor_count(driver.active.get_current_device())
+        if self.num_tiles is not None:
+            size = max(1, min(size, self.num_tiles(args)))
+        return (size, )
+
+
+def launch_batch(launches):
+    """
+    Launches a list of independent kernels, each given as `(kernel, grid, args)`
+    or `(kernel, grid, args, kwargs)`, in order. Drivers that support it submit
+    them to the device at once, which is cheaper than launching many small
+    kernels one by one. Autotuned kernels should be tuned for the launched
+    configurations beforehand, as benchmarking cannot happen in a batch.
+    """
+    launches = [(launch[0], launch[1], launch[2], launch[3] if len(launch) > 3 else {}) for launch in launches]
+    if launches:
+        driver.active.launch_batch(launches)
+
+
 def reinterpret(tensor, dtype):
     if isinstance(tensor, TensorWrapper):
         if dtype == tensor.base.dtype:
@@ -0,0 +1,162 @@
+"""
+Manifests of the kernels a process compiles, so that other processes can compile
+them ahead of time instead of on their first launch.
+
+A manifest is a file with one JSON object per line, one per compiled
+specialization of a kernel:
+
+    {"kernel": "pkg.module:kernel_name",
+     "args": [{"tensor": "torch.float16", "aligned": true}, {"value": 1024}, ...],
+     "options": {"num_warps": 4}}
+
+Tensor arguments are recorded by dtype and by whether their address is divisible
+by 16, Triton dtypes (e.g. `{"dtype": "fp32"}`) by name, the other arguments
+(constexprs included) by value.
+"""
+
+import builtins
+import importlib
+import json
+import os
+import threading
+from concurrent.futures import ThreadPoolExecutor
+
+_record_path = os.getenv("TRITON_RECORD_MANIFEST", "").strip() or None
+_record_lock = threading.Lock()
+
+
+def record_manifest(path):
+    """
+    Appends the specialization of every kernel compiled from now on to the manifest
+    at `path`. `None` stops recording. Setting `TRITON_RECORD_MANIFEST` records from
+    the start of the process.
+    """
+    global _record_path
+    _record_path = path
+
+
+def is_recording():
+    return _record_path is not None
+
+
+class _ManifestTensor:
+    """Stands for a tensor argument when compiling from a manifest."""
+
+    def __init__(self, dtype, aligned):
+        self.dtype = dtype
+        self._data_ptr = 0 if aligned else 1
+
+    def data_ptr(self):
+        return self._data_ptr
+
+
+def _encode_arg(value, divisibility):
+    from .. import language as tl
+    if hasattr(value, "data_ptr"):
+        return {"tensor": str(value.dtype), "aligned": value.data_ptr() % divisibility == 0}
+    # pointer and block types cannot be recreated from their name
+    if type(value) is tl.dtype:
+        return {"dtype": value.name}
+    if value is None or isinstance(value, (bool, int, float, str)):
+        return {"value": value}
+    raise TypeError(f"cannot record argument of type {type(value)}")
+
+
+def _decode_dtype(name):
+    if name.startswith("torch."):
+        import torch
+        return getattr(torch, name[len("torch."):])
+    from .. import language as tl
+    return tl.dtype(name)
+
+
+def _decode_arg(arg):
+    if "tensor" in arg:
+        return _ManifestTensor(_decode_dtype(arg["tensor"]), arg["aligned"])
+    if "dtype" in arg:
+        from .. import language as tl
+        return tl.dtype(arg["dtype"])
+    return arg["value"]
+
+
+def _decode_option(value):
+    # options are hashed as part of the cache key
+    if isinstance(value, list):
+        return tuple(_decode_option(v) for v in value)
+    return value
+
+
+def record(fn, arg_values, options):
+    """Appends the specialization of `fn` for `arg_values` and `options` to the manifest being recorded."""
+    from .jit import JITFunction
+    path = _record_path
+    if path is None or "<locals>" in fn.fn.__qualname__:
+        return
+    try:
+        entry = {
+            "kernel": f"{fn.fn.__module__}:{fn.fn.__qualname__}",
+            "args": [_encode_arg(value, JITFunction.divisibility) for value in arg_values],
+            "options": options,
+        }
+        line = json.dumps(entry)
+    except TypeError:
+        # only kernels whose arguments can be recreated are recorded
+        return
+    with _record_lock:
+        with open(path, "a") as f:
+            f.write(line + "\n")
+
+
+def load_manifest(path):
+    """Returns the distinct entries of the manifest at `path`."""
+    entries = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line:
+                entries.setdefault(line, json.loads(line))
+    return list(entries.values())
+
+
+def _resolve_kernel(name):
+    from .jit import JITFunction
+    module_name, qualname = name.split(":")
+    fn = importlib.import_module(module_name)
+    for attr in qualname.split("."):
+        fn = getattr(fn, attr)
+    # kernels may be wrapped by autotuners and heuristics
+    while not isinstance(fn, JITFunction):
+        fn = fn.fn
+    return fn
+
+
+def precompile(manifest, num_threads=None):
+    """
+    Compiles the kernels listed in `manifest`, a path or a list of entries, on the
+    current device, so that launching them with the recorded specializations does
+    not compile them again. Compilations run in parallel on `num_threads` threads,
+    `TRITON_PRECOMPILE_THREADS` or the number of CPUs by default.
+    Returns the compiled kernels, with `None` for the entries that could not be compiled.
+    """
+    from .driver import driver
+    entries = load_manifest(manifest) if isinstance(manifest, (str, os.PathLike)) else list(manifest)
+    if num_threads is None:
+        num_threads = int(os.getenv("TRITON_PRECOMPILE_THREADS", os.cpu_count() or 1))
+    num_threads = builtins.max(1, builtins.min(num_threads, len(entries)))
+    device = driver.active.get_current_device()
+    set_device = getattr(driver.active, "set_current_device", None)
+
+    def compile_entry(entry):
+        # the current device is thread-local in most frameworks
+        if set_device is not None:
+            set_device(device)
+        try:
+            fn = _resolve_kernel(entry["kernel"])
+            args = [_decode_arg(arg) for arg in entry["args"]]
+            options = {k: _decode_option(v) for k, v in entry["options"].items()}
+            return fn.run(*args, grid=(1, ), warmup=True, **options)
+        except Exception:
+            return None
+
+    with ThreadPoolExecutor(max_workers=num_threads) as executor:
+        return list(executor.map(compile_entry, entries))
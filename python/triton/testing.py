@@ -77,8 +77,93 @@ def do_bench_cudagraph(fn, rep=20, grad_to_none=None):
     return torch.mean(torch.tensor(ret)).item()
 
 
+def _xpu_utils(device):
+    if device != 'xpu':
+        return None
+    from .runtime.driver import driver
+    if driver.active.get_current_target()[0] != 'xpu':
+        return None
+    return driver.active.utils
+
+
+def _flush_cache_size(utils):
+    # The buffer cleared before each run is at least twice the size of the last
+    # level cache, so that none of the inputs of the previous run stay in it.
+    size = int(256e6)
+    if utils is not None:
+        props = utils.get_device_properties(utils.get_current_device())
+        size = max(size, 2 * props.get("l3_cache_size", 0))
+    return size
+
+
+def _device_time_ms(profiler, num_events, props):
+    """
+    Returns the time from the start of the first to the end of the last kernel
+    of each run, given the number of kernel timestamps each run recorded, or
+    None if one of the runs did not launch any Triton kernel.
+    """
+    timestamps = profiler.timestamps()
+    if not all(num_events):
+        return None
+    mask = (1 << props["timestamp_valid_bits"]) - 1
+    resolution_ms = props["timer_resolution"] * 1e-6
+    times, begin = [], 0
+    for n in num_events:
+        start, end = timestamps[begin][0], timestamps[begin + n - 1][1]
+        times.append(((end - start) & mask) * resolution_ms)
+        begin += n
+    return times
+
+
+def do_bench_xpugraph(fn, rep=20, grad_to_none=None):
+    """
+    Benchmark the runtime of the provided function by replaying the Triton
+    kernels it launches from an :code:`XPUGraph`, without host overhead. Only the
+    Triton launches of :code:`fn` are captured, other work it does runs once,
+    during the capture.
+
+    :param fn: Function to benchmark
+    :type fn: Callable
+    :param rep: Repetition time (in ms)
+    :type rep: int
+    :param grad_to_none: Reset the gradient of the provided tensor to None
+    :type grad_to_none: torch.tensor, optional
+    """
+    import time
+    import torch
+    from triton.backends.intel.driver import XPUGraph
+
+    def capture(n):
+        g = XPUGraph()
+        with g.capture():
+            for _ in range(n):
+                if grad_to_none is not None:
+                    for x in grad_to_none:
+                        x.grad = None
+                fn()
+        return g
+
+    def replay_ms(g):
+        # replaying waits for the graph to complete
+        start = time.perf_counter()
+        g.replay()
+        return (time.perf_counter() - start) * 1e3
+
+    # warmup
+    fn()
+    torch.xpu.synchronize()
+    # step 1 - we estimate the amount of time the kernel call takes
+    estimate_ms = replay_ms(capture(1))
+    n_repeat = max(1, int(rep / max(estimate_ms, 1e-3)))
+    # step 2 - capture `n_repeat` unrolled function calls to amortize the
+    # submission of the graph
+    g = capture(n_repeat)
+    ret = [replay_ms(g) / n_repeat for _ in range(10)]
+    return torch.mean(torch.tensor(ret)).item()
+
+
 def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flush=True, return_mode="mean",
-             device='xpu'):
+             device='xpu', device_timer=True):
     assert return_mode in ["min", "max", "mean", "median"]
     import torch
     """
@@ -97,45 +182,47 @@ def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flu
     :type quantiles: list[float]
     :param fast_flush: Use faster kernel to flush L2 between measurements
     :type fast_flush: bool
+    :param device_timer: On XPU, time the Triton kernels :code:`fn` launches with their device timestamps.
+        Runs of functions that launch no Triton kernel are timed on the host.
+    :type device_timer: bool
     """
 
+    def synchronize():
+        if torch.cuda.is_available():
+            torch.cuda.synchronize()
+        elif torch.xpu.is_available():
+            torch.xpu.synchronize()
+
     fn()
-    if torch.cuda.is_available():
-        torch.cuda.synchronize()
-    elif torch.xpu.is_available():
-        torch.xpu.synchronize()
+    synchronize()
 
-    # We maintain a buffer of 256 MB that we clear
-    # before each kernel call to make sure that the L2
-    # doesn't contain any input data before the run
+    # We maintain a buffer that we clear before each kernel call to make sure
+    # that the L2 (the L3 on XPU) doesn't contain any input data before the run
+    utils = _xpu_utils(device)
+    cache_size = _flush_cache_size(utils)
     if fast_flush:
-        cache = torch.empty(int(256e6 // 4), dtype=torch.int, device=device)
+        cache = torch.empty(cache_size // 4, dtype=torch.int, device=device)
     else:
-        cache = torch.empty(int(256e6), dtype=torch.int8, device=device)
+        cache = torch.empty(cache_size, dtype=torch.int8, device=device)
 
     # Estimate the runtime of the function
     start_time = datetime.now()
     for _ in range(5):
         cache.zero_()
         fn()
+    synchronize()
     end_time = datetime.now()
-    if torch.cuda.is_available():
-        torch.cuda.synchronize()
-    elif torch.xpu.is_available():
-        torch.xpu.synchronize()
     estimate_ms = ((end_time.timestamp() - start_time.timestamp()) * 1000) / 5
 
     # compute number of warmup and repeat
     n_warmup = max(1, int(warmup / estimate_ms))
     n_repeat = max(1, int(rep / estimate_ms))
-    start_times = [datetime for i in range(n_repeat)]
-    end_times = [datetime for i in range(n_repeat)]
 
     # Warm-up
     for _ in range(n_warmup):
         fn()
-    # Benchmark
-    for i in range(n_repeat):
+
+    def clear():
         # we don't want `fn` to accumulate gradient values
         # if it contains a backward pass. So we clear the
         # provided gradients
@@ -144,17 +231,32 @@ def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flu
                 x.grad = None
         # we clear the L2 cache before each run
         cache.zero_()
-        # record time of `fn`
-        start_times[i] = datetime.now()
-        fn()
-        end_times[i] = datetime.now()
-    # Record clocks
-    if torch.cuda.is_available():
-        torch.cuda.synchronize()
-    elif torch.xpu.is_available():
-        torch.xpu.synchronize()
-    times = torch.tensor([(e.timestamp() - s.timestamp()) * 1000 for s, e in zip(start_times, end_times)],
-                         dtype=torch.float)
+
+    times = None
+    if utils is not None and device_timer:
+        from triton.backends.intel.driver import XPUEventProfiler
+        profiler = XPUEventProfiler(utils)
+        num_events = []
+        with profiler.record():
+            for i in range(n_repeat):
+                clear()
+                n = len(profiler.events)
+                fn()
+                num_events.append(len(profiler.events) - n)
+        synchronize()
+        times = _device_time_ms(profiler, num_events, utils.get_device_properties(utils.get_current_device()))
+    if times is None:
+        # Benchmark on the host, waiting for each run to complete
+        times = []
+        for i in range(n_repeat):
+            clear()
+            synchronize()
+            start_time = datetime.now()
+            fn()
+            synchronize()
+            end_time = datetime.now()
+            times.append((end_time.timestamp() - start_time.timestamp()) * 1000)
+    times = torch.tensor(times, dtype=torch.float)
     if quantiles is not None:
         ret = torch.quantile(times, torch.tensor(quantiles, dtype=torch.float)).tolist()
         if len(ret) == 1:
@@ -376,11 +478,77 @@ def perf_report(benchmarks):
     return wrapper
 
 
+def _get_xpu_properties(device):
+    from .runtime import driver
+    if driver.active.get_current_target()[0] != "xpu":
+        return None
+    if device is None:
+        device = driver.active.get_current_device()
+    return driver.active.utils.get_device_properties(device)
+
+
+# width in bits of the XMX (DPAS) engine of each EU, by device architecture
+_XMX_WIDTH = {
+    0: 1024,  # Arc
+    1: 4096,  # PVC
+}
+
+
+# Level Zero reports clock rates in MHz, the CUDA driver in kHz
+
+
+def _get_dram_gbps_xpu(props):
+    return props["mem_clock_rate"] * props["mem_bus_width"] * 2 / 1e3 / 8
+
+
+def _get_num_eus(props):
+    return props["multiprocessor_count"] * props["num_eus_per_subslice"]
+
+
+def _get_clock_rate_xpu(props, clock_rate):
+    # in kHz, like the clock rates given for NVIDIA GPUs
+    return props["sm_clock_rate"] * 1e3 if clock_rate is None else clock_rate
+
+
+def _get_max_dpas_tflops(dtype, clock_rate, props):
+    import torch
+    xmx_width = _XMX_WIDTH.get(props["device_arch"])
+    if xmx_width is None:
+        raise RuntimeError("device not supported")
+    if dtype in [torch.float32, torch.int32] and props["device_arch"] == 1:
+        # tf32
+        dtype_bits = 32
+    elif dtype in [torch.float16, torch.bfloat16, torch.int16]:
+        dtype_bits = 16
+    elif dtype == torch.int8:
+        dtype_bits = 8
+    else:
+        raise RuntimeError("dtype not supported")
+    # one multiply-add per element the engine reads per clock
+    ops_per_eu = 2 * xmx_width // dtype_bits
+    return _get_num_eus(props) * _get_clock_rate_xpu(props, clock_rate) * ops_per_eu * 1e-9
+
+
+def _get_max_simd_tflops_xpu(dtype, clock_rate, props):
+    import torch
+    # one multiply-add per SIMD lane, two of them for packed 16-bit floats
+    if dtype == torch.float32:
+        ops_per_eu = 2 * props["eu_simd_width"]
+    elif dtype in [torch.float16, torch.bfloat16]:
+        ops_per_eu = 4 * props["eu_simd_width"]
+    else:
+        raise RuntimeError("dtype not supported")
+    return _get_num_eus(props) * _get_clock_rate_xpu(props, clock_rate) * ops_per_eu * 1e-9
+
+
 def get_dram_gbps(device=None):
     ''' return DRAM bandwidth in GB/s '''
     import torch
 
     from .runtime import driver
+    props = _get_xpu_properties(device)
+    if props is not None:
+        return _get_dram_gbps_xpu(props)
     if not device:
         device = torch.cuda.current_device()
     mem_clock_khz = driver.active.utils.get_device_properties(device)["mem_clock_rate"]  # in kHz
@@ -393,6 +561,10 @@ def get_max_tensorcore_tflops(dtype, clock_rate, device=None):
     import torch
 
     from .runtime import driver
+    props = _get_xpu_properties(device)
+    if props is not None:
+        # XMX engines take the place of tensor cores
+        return _get_max_dpas_tflops(dtype, clock_rate, props)
     if not device:
         device = torch.cuda.current_device()
 
@@ -478,6 +650,9 @@ def get_max_simd_tflops(dtype, clock_rate, device=None):
     import torch
 
     from .runtime import driver
+    props = _get_xpu_properties(device)
+    if props is not None:
+        return _get_max_simd_tflops_xpu(dtype, clock_rate, props)
     if not device:
         device = torch.cuda.current_device()
 
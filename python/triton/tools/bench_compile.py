@@ -0,0 +1,215 @@
+"""
+Measures how long compiling kernels takes, per stage of the backend pipeline,
+and compares it to stored baselines:
+
+    python -m triton.tools.bench_compile [--manifest kernels.jsonl] [--baselines compile_times.json] [--update]
+
+The kernels are those of manifests recorded with `TRITON_RECORD_MANIFEST` (see
+`triton.runtime.manifest`), the kernels of `triton.ops` by default. Each of them
+is compiled for the current device with an empty cache, so that no stage is
+skipped. Baselines are stored per target, and a kernel regresses when one of its
+stages takes longer than `(1 + rtol) * baseline + atol`.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import sys
+import tempfile
+import time
+from contextlib import contextmanager
+
+from triton.runtime.driver import driver
+from triton.runtime.manifest import _resolve_kernel, load_manifest, precompile
+
+
+def _tensor(dtype, aligned=True):
+    return {"tensor": f"torch.{dtype}", "aligned": aligned}
+
+
+def _value(value):
+    return {"value": value}
+
+
+def _matmul(dtype):
+    M = N = K = 4096
+    return {
+        "kernel": "triton.ops.matmul:_kernel",
+        "args": [_tensor(dtype)] * 3 + [_value(M), _value(N), _value(K)] +
+        [_value(K), _value(1), _value(N), _value(1), _value(N), _value(1)] +
+        # acc_dtype, allow_tf32, fp8_fast_accum
+        [{"dtype": "fp32"}, _value(True), _value(True)] +
+        # BLOCK_M, BLOCK_N, BLOCK_K, GROUP_M, SPLIT_K, EVEN_K, AB_DTYPE
+        [_value(128), _value(128), _value(32), _value(8), _value(1), _value(True), _value(None)],
+        "options": {"num_warps": 8, "num_stages": 3},
+    }
+
+
+def _attention_strides(Z, H, N_CTX, D_HEAD):
+    return [_value(H * N_CTX * D_HEAD), _value(N_CTX * D_HEAD), _value(D_HEAD), _value(1)]
+
+
+def _attention_fwd(dtype, causal, Z=4, H=48, N_CTX=1024, D_HEAD=64):
+    strides = _attention_strides(Z, H, N_CTX, D_HEAD)
+    return {
+        "kernel": "triton.ops.flash_attention:_fwd_kernel",
+        "args": [_tensor(dtype)] * 3 + [_value(0.5), _tensor("float32"), _tensor(dtype)] + strides * 4 +
+        [_value(Z), _value(H), _value(N_CTX), _value(Z * H * N_CTX)] +
+        # BLOCK_M, BLOCK_DMODEL, BLOCK_N, IS_CAUSAL
+        [_value(128), _value(D_HEAD), _value(64), _value(causal)],
+        "options": {"num_warps": 4, "num_stages": 4},
+    }
+
+
+def _attention_bwd(dtype, causal, Z=4, H=48, N_CTX=1024, D_HEAD=64):
+    strides = _attention_strides(Z, H, N_CTX, D_HEAD)
+    return [{
+        "kernel": "triton.ops.flash_attention:_bwd_preprocess",
+        "args": [_tensor(dtype), _tensor(dtype), _tensor("float32"), _value(128), _value(D_HEAD)],
+        "options": {},
+    }, {
+        "kernel": "triton.ops.flash_attention:_bwd_kernel",
+        "args": [_tensor(dtype)] * 3 + [_value(0.5)] + [_tensor(dtype)] * 5 + [_tensor("float32")] * 2 +
+        [_value(Z * H * N_CTX * D_HEAD)] + strides * 3 +
+        [_value(Z), _value(H), _value(N_CTX), _value(Z * H * N_CTX), _value(N_CTX // 128 * Z * H * N_CTX)] +
+        # BLOCK_M, BLOCK_DMODEL, BLOCK_N, SEQUENCE_PARALLEL, CAUSAL, MMA_V3
+        [_value(128), _value(D_HEAD), _value(128), _value(False), _value(causal), _value(False)],
+        "options": {"num_warps": 8, "num_stages": 1},
+    }]
+
+
+def _cross_entropy(N=4096):
+    return [{
+        "kernel": "triton.ops.cross_entropy:_forward",
+        "args": [_tensor("float32"), _tensor("float32"), _tensor("int64"), _tensor("float32"), _value(N), _value(N)],
+        "options": {"num_warps": 8},
+    }, {
+        "kernel": "triton.ops.cross_entropy:_backward",
+        "args": [_tensor("float32"), _tensor("int64"), _tensor("float32"), _value(N), _value(N)],
+        "options": {"num_warps": 8},
+    }]
+
+
+def default_entries():
+    """The kernels of `triton.ops`, specialized as they commonly are."""
+    entries = [_matmul("float16"), _matmul("bfloat16")]
+    for causal in [False, True]:
+        entries.append(_attention_fwd("float16", causal))
+        entries += _attention_bwd("float16", causal)
+    entries += _cross_entropy()
+    return entries
+
+
+def entry_key(entry):
+    """A name identifying the specialization of a manifest entry across runs."""
+    digest = hashlib.md5(json.dumps(entry, sort_keys=True).encode("utf-8")).hexdigest()
+    return f"{entry['kernel']}-{digest[:8]}"
+
+
+@contextmanager
+def _env(**values):
+    saved = {name: os.environ.get(name) for name in values}
+    os.environ.update(values)
+    try:
+        yield
+    finally:
+        for name, value in saved.items():
+            if value is None:
+                del os.environ[name]
+            else:
+                os.environ[name] = value
+
+
+def compile_once(entry):
+    """Compiles `entry` with an empty cache and returns the seconds each stage, and the whole compilation, took."""
+    fn = _resolve_kernel(entry["kernel"])
+    fn.cache.clear()
+    with tempfile.TemporaryDirectory() as cache_dir, tempfile.TemporaryDirectory() as timing_dir:
+        with _env(TRITON_CACHE_DIR=cache_dir, TRITON_COMPILE_TIMING_DIR=timing_dir):
+            start = time.perf_counter()
+            kernel, = precompile([entry], num_threads=1)
+            total = time.perf_counter() - start
+        if kernel is None:
+            return None
+        times = {"total": total}
+        for name in os.listdir(timing_dir):
+            if name.endswith(".json"):
+                with open(os.path.join(timing_dir, name)) as f:
+                    for stage in json.load(f)["stages"]:
+                        times[stage["stage"]] = times.get(stage["stage"], 0.) + stage["seconds"]
+        return times
+
+
+def compile_times(entries, repeat=1):
+    """Returns the median time of each stage of each of `entries`, by entry key, or None for the entries that fail."""
+    results = {}
+    for entry in entries:
+        samples = [compile_once(entry) for _ in range(repeat)]
+        if any(sample is None for sample in samples):
+            results[entry_key(entry)] = None
+            continue
+        results[entry_key(entry)] = {
+            stage: sorted(sample[stage] for sample in samples)[len(samples) // 2]
+            for stage in samples[0]
+        }
+    return results
+
+
+def find_regressions(results, baselines, rtol, atol):
+    """Returns the (key, stage, seconds, baseline) of the stages slower than their baseline."""
+    regressions = []
+    for key, times in results.items():
+        for stage, seconds in (times or {}).items():
+            baseline = baselines.get(key, {}).get(stage)
+            if baseline is not None and seconds > (1 + rtol) * baseline + atol:
+                regressions.append((key, stage, seconds, baseline))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--manifest", nargs="+", default=None, help="manifests of the kernels to compile")
+    parser.add_argument("--baselines", default=None, help="JSON file holding the baselines, by target")
+    parser.add_argument("--update", action="store_true", help="store the measured times as the baselines")
+    parser.add_argument("--repeat", type=int, default=3, help="number of compilations of each kernel")
+    parser.add_argument("--rtol", type=float, default=0.2)
+    parser.add_argument("--atol", type=float, default=0.05, help="in seconds")
+    args = parser.parse_args()
+
+    entries = default_entries()
+    if args.manifest is not None:
+        entries = [entry for path in args.manifest for entry in load_manifest(path)]
+    results = compile_times(entries, args.repeat)
+
+    stages = []
+    for times in results.values():
+        stages += [stage for stage in (times or {}) if stage not in stages]
+    print(f"{'kernel':<56}" + "".join(f"{stage:>10}" for stage in stages))
+    for key, times in results.items():
+        if times is None:
+            print(f"{key:<56}{'failed':>10}")
+            continue
+        print(f"{key:<56}" + "".join(f"{times[stage]:10.3f}" if stage in times else f"{'':>10}" for stage in stages))
+
+    if args.baselines is None:
+        return
+    all_baselines = {}
+    if os.path.exists(args.baselines):
+        with open(args.baselines) as f:
+            all_baselines = json.load(f)
+    target = ":".join(str(t) for t in driver.active.get_current_target())
+    if args.update:
+        all_baselines.setdefault(target, {}).update({key: times for key, times in results.items() if times})
+        with open(args.baselines, "w") as f:
+            json.dump(all_baselines, f, indent=2, sort_keys=True)
+            f.write("\n")
+        return
+    regressions = find_regressions(results, all_baselines.get(target, {}), args.rtol, args.atol)
+    for key, stage, seconds, baseline in regressions:
+        print(f"regression: {key} {stage} took {seconds:.3f}s, baseline {baseline:.3f}s")
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
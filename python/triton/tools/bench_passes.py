@@ -0,0 +1,165 @@
+"""
+Runs the backend pipeline on a directory of dumped modules and reports how long
+each file, stage and pass took:
+
+    python -m triton.tools.bench_passes [DIR] [--target xpu:1] [--threads N] [--json times.json]
+
+The modules are the `.ttir` (or, with `--ext ttgir`, the `.ttgir`) files under
+DIR, the dump directory of `TRITON_KERNEL_DUMP=1` by default. Each of them goes
+through the stages of the backend of `--target`, the current device by default,
+from the one following its own up to `--stop-after`, without a device or a
+cache. Files are compiled in parallel on `--threads` threads; use `--threads 1`
+when comparing the times of single passes, which otherwise compete for the CPU.
+"""
+
+import argparse
+import json
+import os
+import sys
+import tempfile
+import time
+from collections import defaultdict
+from concurrent.futures import ThreadPoolExecutor
+
+from triton._C.libtriton import get_env_vars, ir
+from triton.backends.compiler import CompileTimer, set_compile_timer
+from triton.compiler.compiler import IRSource, make_backend
+from triton.runtime.cache import default_dump_dir
+
+
+def find_modules(root, ext):
+    """Returns the paths of the `.{ext}` files under `root`, sorted."""
+    paths = []
+    for dirpath, _, filenames in os.walk(root):
+        paths += [os.path.join(dirpath, name) for name in filenames if name.endswith(f".{ext}")]
+    return sorted(paths)
+
+
+def parse_target(target):
+    """Parses `backend:arch`, e.g. `cuda:90` or `xpu:1` (PVC)."""
+    backend, arch = target.split(":", 1)
+    return (backend, int(arch) if arch.isdigit() else arch)
+
+
+def run_pipeline(path, target, options, stop_after, report_dir):
+    """
+    Runs the stages of the backend of `target` on the module at `path` and returns
+    the seconds each stage and each pass took.
+    """
+    src = IRSource(path)
+    backend = make_backend(target)
+    options = backend.parse_options(dict(options, **src.parse_options()))
+    stages = dict()
+    backend.add_stages(stages, options)
+    names = list(stages.keys())
+    first_stage = names.index(src.ext) + 1
+    last_stage = names.index(stop_after) + 1 if stop_after in names else len(names)
+    context = ir.context()
+    ir.load_dialects(context)
+    backend.load_dialects(context)
+    metadata = {"hash": src.hash(), "target": target, **options.__dict__, **get_env_vars(), **src.metadata()}
+    module = src.make_ir(options, context)
+    if src.ext == "ttgir":
+        # set by the ttgir stage, which dumped TTGIR has already been through
+        metadata["ws_enabled"] = module.get_int_attr("triton_gpu.num-warp-groups-per-cta") is not None
+    # the timer is thread-local, so files compiled in parallel get their own reports
+    timer = CompileTimer(os.path.join(report_dir, f"{src.name}-{src.hash()}-{time.monotonic_ns()}.passes.jsonl"))
+    stage_times = []
+    set_compile_timer(timer)
+    try:
+        for ext in names[first_stage:last_stage]:
+            start = time.perf_counter()
+            module = stages[ext](module, metadata)
+            stage_times.append({"stage": ext, "seconds": time.perf_counter() - start})
+    finally:
+        set_compile_timer(None)
+    passes = []
+    if os.path.exists(timer.pass_report_path):
+        with open(timer.pass_report_path) as f:
+            passes = [json.loads(line) for line in f if line.strip()]
+        os.remove(timer.pass_report_path)
+    return {"name": src.name, "stages": stage_times, "steps": timer.steps, "passes": passes}
+
+
+def run_batch(paths, target, options, stop_after, num_threads):
+    """Returns the report of `run_pipeline` of each of `paths`, by path, with the error of the files that fail."""
+    num_threads = max(1, min(num_threads, len(paths)))
+    with tempfile.TemporaryDirectory() as report_dir:
+
+        def run(path):
+            start = time.perf_counter()
+            try:
+                report = run_pipeline(path, target, options, stop_after, report_dir)
+            except Exception as e:
+                report = {"error": f"{type(e).__name__}: {e}"}
+            report["seconds"] = time.perf_counter() - start
+            return report
+
+        with ThreadPoolExecutor(max_workers=num_threads) as executor:
+            return dict(zip(paths, executor.map(run, paths)))
+
+
+def pass_totals(reports):
+    """Returns the total seconds and number of runs of each pass over `reports`, slowest first."""
+    totals = defaultdict(lambda: [0., 0])
+    for report in reports.values():
+        for record in report.get("passes", []):
+            total = totals[record["argument"] or record["pass"]]
+            total[0] += record["seconds"]
+            total[1] += 1
+    return sorted(((name, seconds, count) for name, (seconds, count) in totals.items()), key=lambda t: -t[1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dir", nargs="?", default=None, help="directory of dumped modules")
+    parser.add_argument("--ext", choices=["ttir", "ttgir"], default="ttir", help="extension of the modules to run")
+    parser.add_argument("--target", default=None, help="backend:arch to compile for, e.g. cuda:90 or xpu:1")
+    parser.add_argument("--options", default="{}", help="JSON object of backend options, e.g. '{\"num_warps\": 8}'")
+    parser.add_argument("--stop-after", default=None, help="last stage to run, e.g. llir; all of them by default")
+    parser.add_argument("--threads", type=int, default=os.cpu_count() or 1, help="number of files compiled at once")
+    parser.add_argument("--top", type=int, default=20, help="number of passes listed, slowest first")
+    parser.add_argument("--json", default=None, help="file to write the full reports to")
+    args = parser.parse_args()
+
+    root = args.dir or default_dump_dir()
+    paths = find_modules(root, args.ext)
+    if not paths:
+        sys.exit(f"no .{args.ext} files under {root}")
+    if args.target is None:
+        from triton.runtime.driver import driver
+        target = driver.active.get_current_target()
+    else:
+        target = parse_target(args.target)
+    start = time.perf_counter()
+    reports = run_batch(paths, target, json.loads(args.options), args.stop_after, args.threads)
+    wall = time.perf_counter() - start
+
+    stages = []
+    for report in reports.values():
+        stages += [s["stage"] for s in report.get("stages", []) if s["stage"] not in stages]
+    print(f"{'file':<56}{'total':>10}" + "".join(f"{stage:>10}" for stage in stages))
+    for path, report in reports.items():
+        name = os.path.relpath(path, root)
+        if "error" in report:
+            print(f"{name:<56}{'failed':>10}  {report['error']}")
+            continue
+        times = {s["stage"]: s["seconds"] for s in report["stages"]}
+        print(f"{name:<56}{report['seconds']:10.3f}" +
+              "".join(f"{times[stage]:10.3f}" if stage in times else f"{'':>10}" for stage in stages))
+    print()
+    print(f"{'pass':<56}{'seconds':>10}{'runs':>10}")
+    for name, seconds, count in pass_totals(reports)[:args.top]:
+        print(f"{name:<56}{seconds:10.3f}{count:10d}")
+    failed = sum("error" in report for report in reports.values())
+    print(f"\n{len(paths)} files, {failed} failed, {wall:.3f}s on {args.threads} threads")
+
+    if args.json is not None:
+        with open(args.json, "w") as f:
+            json.dump({"target": list(target), "wall_seconds": wall, "files": reports}, f, indent=2)
+            f.write("\n")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
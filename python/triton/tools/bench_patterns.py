@@ -0,0 +1,248 @@
+"""
+Times individual lowering patterns on the current device.
+
+Each pattern is a minimal TTGIR kernel (a layout conversion, a reduction, a
+DPAS dot, a masked load) generated for a given layout and element type. It is
+compiled from TTGIR through the rest of the backend pipeline, so that a change
+in the lowering of the pattern shows up in its time:
+
+    python -m triton.tools.bench_patterns [--patterns convert_layout reduce] [--dtypes f16 f32]
+
+Every program of a kernel processes one tile, the kernels are launched on
+enough programs to fill the device.
+"""
+
+import argparse
+import json
+import os
+import tempfile
+
+import triton
+
+M, N, K = 64, 64, 32
+NUM_WARPS = 4
+THREADS_PER_WARP = 16
+NUM_TILES = 4096
+
+LAYOUTS = {
+    "row": "#triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>",
+    "row_scalar": "#triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>",
+    "col": "#triton_gpu.blocked<{sizePerThread = [4, 1], threadsPerWarp = [16, 1], warpsPerCTA = [1, 4], order = [0, 1]}>",
+}
+DPAS_LAYOUT = ("#triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], "
+               "CTAOrder = [1, 0]}>")
+
+# element size in bytes
+DTYPE_SIZES = {"f16": 2, "bf16": 2, "f32": 4}
+
+#######################
+# IR generation
+#######################
+
+
+def _tensor(shape, ty, layout):
+    return f"tensor<{'x'.join(str(s) for s in shape)}x{ty}, {layout}>"
+
+
+def _ptr(ty):
+    return f"!tt.ptr<{ty}, 1>"
+
+
+def _module(layouts, name, args, body):
+    aliases = "\n".join(f"#{alias} = {layout}" for alias, layout in layouts.items())
+    params = ", ".join(f"%{arg}: {_ptr(ty)} {{tt.divisibility = 16 : i32}}" for arg, ty in args)
+    body = "\n".join("    " + line for line in body)
+    return f"""{aliases}
+module attributes {{"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = {NUM_WARPS} : i32, "triton_gpu.threads-per-warp" = {THREADS_PER_WARP} : i32}} {{
+  tt.func public @{name}({params}) {{
+{body}
+    tt.return
+  }}
+}}
+"""
+
+
+def _tile_ptrs(prefix, base, ty, shape, layout, stride):
+    """Returns the lines computing the pointers `%{prefix}ptrs` to the tile of shape `shape` at `base`."""
+    rows, cols = shape
+    slice0 = f"#triton_gpu.slice<{{dim = 0, parent = {layout}}}>"
+    slice1 = f"#triton_gpu.slice<{{dim = 1, parent = {layout}}}>"
+    p = prefix
+    return [
+        f"%{p}r = tt.make_range {{end = {rows} : i32, start = 0 : i32}} : tensor<{rows}xi32, {slice1}>",
+        f"%{p}c = tt.make_range {{end = {cols} : i32, start = 0 : i32}} : tensor<{cols}xi32, {slice0}>",
+        f"%{p}r2 = tt.expand_dims %{p}r {{axis = 1 : i32}} : (tensor<{rows}xi32, {slice1}>) -> {_tensor((rows, 1), 'i32', layout)}",
+        f"%{p}c2 = tt.expand_dims %{p}c {{axis = 0 : i32}} : (tensor<{cols}xi32, {slice0}>) -> {_tensor((1, cols), 'i32', layout)}",
+        f"%{p}stride = arith.constant dense<{stride}> : {_tensor((rows, 1), 'i32', layout)}",
+        f"%{p}r3 = arith.muli %{p}r2, %{p}stride : {_tensor((rows, 1), 'i32', layout)}",
+        f"%{p}rb = tt.broadcast %{p}r3 : ({_tensor((rows, 1), 'i32', layout)}) -> {_tensor(shape, 'i32', layout)}",
+        f"%{p}cb = tt.broadcast %{p}c2 : ({_tensor((1, cols), 'i32', layout)}) -> {_tensor(shape, 'i32', layout)}",
+        f"%{p}off = arith.addi %{p}rb, %{p}cb : {_tensor(shape, 'i32', layout)}",
+        f"%{p}base = tt.splat %{base} : ({_ptr(ty)}) -> {_tensor(shape, _ptr(ty), layout)}",
+        f"%{p}ptrs = tt.addptr %{p}base, %{p}off : {_tensor(shape, _ptr(ty), layout)}, {_tensor(shape, 'i32', layout)}",
+    ]
+
+
+def _tile_base(args, tile_sizes):
+    """Returns the lines offsetting each of `args` by the tile of the program, of the given size, to `%{arg}_tile`."""
+    lines = ["%pid = tt.get_program_id x : i32"]
+    for (arg, ty), tile_size in zip(args, tile_sizes):
+        lines += [
+            f"%{arg}_tile_size = arith.constant {tile_size} : i32",
+            f"%{arg}_offset = arith.muli %pid, %{arg}_tile_size : i32",
+            f"%{arg}_tile = tt.addptr %{arg}, %{arg}_offset : {_ptr(ty)}, i32",
+        ]
+    return lines
+
+
+def _load(result, ptrs, ty, shape, layout, mask=None, other=None):
+    operands = ", ".join(v for v in (ptrs, mask, other) if v is not None)
+    return (f"%{result} = tt.load {operands} {{cache = 1 : i32, evict = 1 : i32, isVolatile = false}} : "
+            f"{_tensor(shape, ty, layout)}")
+
+
+def _store(ptrs, value, ty, shape, layout):
+    return f"tt.store {ptrs}, {value} : {_tensor(shape, ty, layout)}"
+
+
+def convert_layout(ty, src, dst):
+    """Loads a tile in layout `src` and stores it in layout `dst`."""
+    layouts = {"src": LAYOUTS[src], "dst": LAYOUTS[dst]}
+    args = [("in", ty), ("out", ty)]
+    body = _tile_base(args, [M * N, M * N])
+    body += _tile_ptrs("a", "in_tile", ty, (M, N), "#src", N)
+    body += _tile_ptrs("b", "out_tile", ty, (M, N), "#dst", N)
+    body += [
+        _load("x", "%aptrs", ty, (M, N), "#src"),
+        f"%y = triton_gpu.convert_layout %x : ({_tensor((M, N), ty, '#src')}) -> {_tensor((M, N), ty, '#dst')}",
+        _store("%bptrs", "%y", ty, (M, N), "#dst"),
+    ]
+    return _module(layouts, "convert_layout", args, body), args, 2 * M * N * DTYPE_SIZES[ty], 0
+
+
+def reduce(ty, src):
+    """Sums the rows of a tile in layout `src`."""
+    layouts = {"src": LAYOUTS[src]}
+    slice1 = "#triton_gpu.slice<{dim = 1, parent = #src}>"
+    args = [("in", ty), ("out", ty)]
+    body = _tile_base(args, [M * N, M])
+    body += _tile_ptrs("a", "in_tile", ty, (M, N), "#src", N)
+    body += [
+        f"%o = tt.make_range {{end = {M} : i32, start = 0 : i32}} : tensor<{M}xi32, {slice1}>",
+        f"%obase = tt.splat %out_tile : ({_ptr(ty)}) -> tensor<{M}x{_ptr(ty)}, {slice1}>",
+        f"%optrs = tt.addptr %obase, %o : tensor<{M}x{_ptr(ty)}, {slice1}>, tensor<{M}xi32, {slice1}>",
+        _load("x", "%aptrs", ty, (M, N), "#src"),
+        "%y = \"tt.reduce\"(%x) ({",
+        f"^bb0(%lhs: {ty}, %rhs: {ty}):",
+        f"  %sum = arith.addf %lhs, %rhs : {ty}",
+        f"  tt.reduce.return %sum : {ty}",
+        f"}}) {{axis = 1 : i32}} : ({_tensor((M, N), ty, '#src')}) -> tensor<{M}x{ty}, {slice1}>",
+        f"tt.store %optrs, %y : tensor<{M}x{ty}, {slice1}>",
+    ]
+    return _module(layouts, "reduce", args, body), args, (M * N + M) * DTYPE_SIZES[ty], 0
+
+
+def masked_load(ty, src):
+    """Loads the first half of the columns of a tile in layout `src`, and zeros for the others."""
+    layouts = {"src": LAYOUTS[src]}
+    args = [("in", ty), ("out", ty)]
+    body = _tile_base(args, [M * N, M * N])
+    body += _tile_ptrs("a", "in_tile", ty, (M, N), "#src", N)
+    body += _tile_ptrs("b", "out_tile", ty, (M, N), "#src", N)
+    body += [
+        f"%bound = arith.constant dense<{N // 2}> : {_tensor((M, N), 'i32', '#src')}",
+        f"%mask = arith.cmpi slt, %acb, %bound : {_tensor((M, N), 'i32', '#src')}",
+        f"%other = arith.constant dense<0.000000e+00> : {_tensor((M, N), ty, '#src')}",
+        _load("x", "%aptrs", ty, (M, N), "#src", "%mask", "%other"),
+        _store("%bptrs", "%x", ty, (M, N), "#src"),
+    ]
+    return _module(layouts, "masked_load", args, body), args, (M * N // 2 + M * N) * DTYPE_SIZES[ty], 0
+
+
+def dot(ty, src):
+    """Multiplies an MxK and a KxN tile loaded in layout `src` with DPAS, into f32."""
+    layouts = {"src": LAYOUTS[src], "dpas": DPAS_LAYOUT}
+    dot_a = "#triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>"
+    dot_b = "#triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>"
+    args = [("a", ty), ("b", ty), ("c", "f32")]
+    body = _tile_base(args, [M * K, K * N, M * N])
+    body += _tile_ptrs("pa", "a_tile", ty, (M, K), "#src", K)
+    body += _tile_ptrs("pb", "b_tile", ty, (K, N), "#src", N)
+    body += _tile_ptrs("pc", "c_tile", "f32", (M, N), "#src", N)
+    body += [
+        _load("x", "%paptrs", ty, (M, K), "#src"),
+        _load("y", "%pbptrs", ty, (K, N), "#src"),
+        f"%xa = triton_gpu.convert_layout %x : ({_tensor((M, K), ty, '#src')}) -> {_tensor((M, K), ty, dot_a)}",
+        f"%yb = triton_gpu.convert_layout %y : ({_tensor((K, N), ty, '#src')}) -> {_tensor((K, N), ty, dot_b)}",
+        f"%acc = arith.constant dense<0.000000e+00> : {_tensor((M, N), 'f32', '#dpas')}",
+        f"%z = tt.dot %xa, %yb, %acc {{allowTF32 = true, maxNumImpreciseAcc = 0 : i32}} : "
+        f"{_tensor((M, K), ty, dot_a)} * {_tensor((K, N), ty, dot_b)} -> {_tensor((M, N), 'f32', '#dpas')}",
+        f"%zc = triton_gpu.convert_layout %z : ({_tensor((M, N), 'f32', '#dpas')}) -> {_tensor((M, N), 'f32', '#src')}",
+        _store("%pcptrs", "%zc", "f32", (M, N), "#src"),
+    ]
+    return _module(layouts, "dot", args, body), args, (M * K + K * N) * DTYPE_SIZES[ty] + M * N * 4, 2 * M * N * K
+
+
+# name -> (generator, dtypes, layout arguments)
+PATTERNS = {
+    "convert_layout": (convert_layout, ["f16", "f32"], [("row", "col"), ("col", "row"), ("row", "row_scalar")]),
+    "reduce": (reduce, ["f16", "f32"], [("row", ), ("col", )]),
+    "masked_load": (masked_load, ["f16", "f32"], [("row", ), ("row_scalar", )]),
+    "dot": (dot, ["f16", "bf16"], [("row", )]),
+}
+
+#######################
+# Benchmarking
+#######################
+
+
+def _torch_dtype(ty):
+    import torch
+    return {"f16": torch.float16, "bf16": torch.bfloat16, "f32": torch.float32}[ty]
+
+
+def bench_pattern(src, args, device="xpu"):
+    """Compiles the TTGIR kernel `src` taking pointers to `args` and returns its time per launch in ms."""
+    import torch
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        path = os.path.join(tmp_dir, "pattern.ttgir")
+        with open(path, "w") as f:
+            f.write(src)
+        kernel = triton.compile(path)
+    # every buffer holds the tiles of all programs
+    buffers = [torch.randn((NUM_TILES * M * max(N, K), ), dtype=_torch_dtype(ty), device=device) for _, ty in args]
+    return triton.testing.do_bench(lambda: kernel[(NUM_TILES, )](*buffers), device=device)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--patterns", nargs="+", choices=list(PATTERNS), default=list(PATTERNS))
+    parser.add_argument("--dtypes", nargs="+", default=None, help="element types to benchmark, all by default")
+    parser.add_argument("--dump-ir", action="store_true", help="print the TTGIR of each pattern")
+    parser.add_argument("--output", default=None, help="also write the results to this JSON file")
+    args = parser.parse_args()
+
+    results = []
+    for name in args.patterns:
+        generator, dtypes, layouts = PATTERNS[name]
+        for ty in dtypes:
+            if args.dtypes is not None and ty not in args.dtypes:
+                continue
+            for layout in layouts:
+                src, kernel_args, num_bytes, num_flops = generator(ty, *layout)
+                if args.dump_ir:
+                    print(src)
+                ms = bench_pattern(src, kernel_args)
+                gbps = NUM_TILES * num_bytes / ms * 1e-6
+                tflops = NUM_TILES * num_flops / ms * 1e-9
+                results.append({"pattern": name, "dtype": ty, "layout": "->".join(layout), "ms": ms, "gbps": gbps,
+                                "tflops": tflops})
+                print(f"{name:<16}{ty:<6}{'->'.join(layout):<20}{ms:10.4f} ms{gbps:10.1f} GB/s" +
+                      (f"{tflops:10.2f} TFLOPS" if num_flops else ""))
+    if args.output is not None:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
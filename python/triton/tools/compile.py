@@ -15,7 +15,8 @@ Triton ahead-of-time compiler:
 
 This program compiles the kernel with name `kernel-name` in the file at the
 provided `path` into self-contained C source-code that embeds the `cubin`
-data along with utilities to load, unload and launch the kernel.
+data (or the SPIR-V binary with `--target xpu`) along with utilities to load,
+unload and launch the kernel.
 
 signature is provided as a list of (optionally divisibility-hinted) types
 or constexpr values, e.g.
@@ -30,6 +31,10 @@ The resulting entry point will have signature
 
 CUresult kernel_{specialization_suffix}(CUstream stream, unsigned gX, unsigned gY, unsigned gZ, float* arg0, int32_t arg1, int32_t arg2)
 
+or, for the XPU target, which launches through Level Zero after `load_kernel_{specialization_suffix}(context, device)`,
+
+ze_result_t kernel_{specialization_suffix}(ze_command_list_handle_t stream, float* arg0, int32_t arg1, int32_t arg2)
+
 Different such specialized entry points can be combined using the `linker.py` script.
 
 NOTE: when resolving the scope of /path/to/kernel.py, the file will be executed from within its parent directory with the python interpreter
@@ -51,6 +56,8 @@ if __name__ == "__main__":
     parser.add_argument("--out-path", "-o", type=Path, default=None, help="Out filename")
     parser.add_argument("--signature", "-s", type=str, help="Signature of the kernel", required=True)
     parser.add_argument("--grid", "-g", type=str, help="Launch grid of the kernel", required=True)
+    parser.add_argument("--target", "-t", type=str, choices=["cuda", "xpu"], default="cuda",
+                        help="Runtime targeted by the generated launcher")
     args = parser.parse_args()
 
     out_name = args.out_name if args.out_name else args.kernel_name
@@ -121,26 +128,48 @@ if __name__ == "__main__":
     suffix = kernel_suffix(signature.values(), attrs)
     func_name = '_'.join([out_name, sig_hash, suffix])
     triton_kernel_name = '_'.join([args.kernel_name, suffix])
-    hex_ = str(binascii.hexlify(ccinfo.asm["cubin"]))[2:-1]
+    hex_ = str(binascii.hexlify(ccinfo.asm["spv" if args.target == "xpu" else "cubin"]))[2:-1]
     params = {
         "kernel_name": func_name,
         "triton_kernel_name": triton_kernel_name,
         "bin_size": len(hex_),
+        "bin_len": len(hex_) // 2,
         "bin_data": ", ".join([f"0x{x}{y}" for x, y in zip(hex_[::2], hex_[1::2])]),
         "signature": ", ".join([f"{ty_to_cpp(ty)} {name}" for name, ty in zip(arg_names, arg_types)]),
         "full_signature": ", ".join([f"{ty_to_cpp(signature[i])} {kernel.arg_names[i]}" for i in signature.keys()]),
         "arg_pointers": ", ".join([f"&{arg}" for arg in arg_names]),
+        "arg_sizes": ", ".join([f"sizeof({arg})" for arg in arg_names]),
         "num_args": len(arg_names),
         "kernel_docstring": doc_string,
         "shared": ccinfo.metadata.shared,
         "num_warps": args.num_warps,
+        "threads_per_warp": ccinfo.metadata.threads_per_warp if args.target == "xpu" else 32,
         "algo_info": '_'.join([const_sig, meta_sig]),
         "gridX": grid[0],
         "gridY": grid[1],
         "gridZ": grid[2],
         "_placeholder": "",
     }
+    if args.target == "xpu":
+        # kernels with many arguments take some of them in a struct passed
+        # first (see `arg_packing_threshold`)
+        packed = [arg_names[k] for k in getattr(ccinfo.metadata, "packed_args", ())]
+        kernel_args = [name for name in arg_names if name not in packed]
+        if packed:
+            fields = " ".join(f"{ty_to_cpp(ty)} {name};" for name, ty in zip(arg_names, arg_types) if name in packed)
+            params["packed_decl"] = f"typedef struct {{ {fields} }} {func_name}_packed_args_t;"
+            params["packed_init"] = f"{func_name}_packed_args_t packed_args = {{ {', '.join(packed)} }};"
+            kernel_args = ["packed_args"] + kernel_args
+        else:
+            params["packed_decl"] = params["packed_init"] = ""
+        params["arg_pointers"] = ", ".join([f"&{arg}" for arg in kernel_args])
+        params["arg_sizes"] = ", ".join([f"sizeof({arg})" for arg in kernel_args])
+        params["num_args"] = len(kernel_args)
+        params["global_scratch_size"] = getattr(ccinfo.metadata, "global_scratch_size", 0)
+        params["global_scratch_align"] = getattr(ccinfo.metadata, "global_scratch_align", 1)
+        params["ze_module"] = (Path(triton.backends.intel.__file__).parent / "ze_module.h").read_text()
     for ext in ['h', 'c']:
-        template_path = Path(__file__).parent / f"compile.{ext}"
+        template_name = "compile_xpu" if args.target == "xpu" else "compile"
+        template_path = Path(__file__).parent / f"{template_name}.{ext}"
         with out_path.with_suffix(f".{sig_hash}_{suffix}.{ext}").open("w") as fp:
             fp.write(Path(template_path).read_text().format(**params))
@@ -0,0 +1,106 @@
+/* clang-format off */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <level_zero/ze_api.h>
+
+{ze_module}
+
+// helpers to check for level zero errors
+#define ZE_CHECK(ans) {{\
+    zeAssert((ans), __FILE__, __LINE__);\
+  }}\
+
+static inline void zeAssert(ze_result_t code, const char *file, int line) {{
+  if (code != ZE_RESULT_SUCCESS) {{
+    printf("Triton Error [ZE]: 0x%x at %s:%d\\n", code, file, line);
+    exit(code);
+  }}
+}}
+
+// globals
+#define SPIRV_NAME {kernel_name}_spirv
+ze_context_handle_t {kernel_name}_context = NULL;
+ze_module_handle_t {kernel_name}_mod = NULL;
+ze_kernel_handle_t {kernel_name}_func = NULL;
+// the `tl.global_scratch` buffer of the kernel, zeroed when loaded and
+// shared by all its launches, which must therefore not overlap
+void *{kernel_name}_scratch = NULL;
+unsigned char SPIRV_NAME[{bin_len}] = {{ {bin_data} }};
+{packed_decl}
+
+
+void unload_{kernel_name}(void) {{
+    if ({kernel_name}_func != NULL)
+      ZE_CHECK(zeKernelDestroy({kernel_name}_func));
+    if ({kernel_name}_mod != NULL)
+      ZE_CHECK(zeModuleDestroy({kernel_name}_mod));
+    {kernel_name}_func = NULL;
+    {kernel_name}_mod = NULL;
+    if ({kernel_name}_scratch != NULL)
+      ZE_CHECK(zeMemFree({kernel_name}_context, {kernel_name}_scratch));
+    {kernel_name}_scratch = NULL;
+}}
+
+void load_{kernel_name}(ze_context_handle_t context, ze_device_handle_t device) {{
+    ze_module_desc_t module_desc = {{ZE_STRUCTURE_TYPE_MODULE_DESC, NULL, ZE_MODULE_FORMAT_IL_SPIRV,
+                                    sizeof(SPIRV_NAME), SPIRV_NAME, "", NULL}};
+    ZE_CHECK(createZeModule(context, device, &module_desc, "{triton_kernel_name}", &{kernel_name}_mod));
+    {kernel_name}_context = context;
+    if ({global_scratch_size} > 0) {{
+      ze_device_mem_alloc_desc_t alloc_desc = {{ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC, NULL, 0, 0}};
+      ZE_CHECK(zeMemAllocDevice(context, &alloc_desc, {global_scratch_size}, {global_scratch_align}, device,
+                                &{kernel_name}_scratch));
+      // a synchronous immediate command list has completed the fill on return
+      ze_command_queue_desc_t queue_desc = {{ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC, NULL, 0, 0, 0,
+                                            ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS, ZE_COMMAND_QUEUE_PRIORITY_NORMAL}};
+      ze_command_list_handle_t fill_list;
+      ZE_CHECK(zeCommandListCreateImmediate(context, device, &queue_desc, &fill_list));
+      uint8_t zero = 0;
+      ZE_CHECK(zeCommandListAppendMemoryFill(fill_list, {kernel_name}_scratch, &zero, sizeof(zero),
+                                             {global_scratch_size}, NULL, 0, NULL));
+      ZE_CHECK(zeCommandListDestroy(fill_list));
+    }}
+    ze_kernel_desc_t kernel_desc = {{ZE_STRUCTURE_TYPE_KERNEL_DESC, NULL, 0, "{triton_kernel_name}"}};
+    ZE_CHECK(zeKernelCreate({kernel_name}_mod, &kernel_desc, &{kernel_name}_func));
+    ZE_CHECK(zeKernelSetGroupSize({kernel_name}_func, {num_warps} * {threads_per_warp}, 1, 1));
+}}
+
+/*
+{kernel_docstring}
+*/
+ze_result_t {kernel_name}(ze_command_list_handle_t stream, {signature}) {{
+    if ({kernel_name}_func == NULL)
+      return ZE_RESULT_ERROR_UNINITIALIZED;
+    unsigned int gX = {gridX};
+    unsigned int gY = {gridY};
+    unsigned int gZ = {gridZ};
+    {packed_init}
+    void *args[{num_args}] = {{ {arg_pointers} }};
+    size_t arg_sizes[{num_args}] = {{ {arg_sizes} }};
+    for (uint32_t i = 0; i < {num_args}; ++i) {{
+      ze_result_t ret = zeKernelSetArgumentValue({kernel_name}_func, i, arg_sizes[i], args[i]);
+      if (ret != ZE_RESULT_SUCCESS)
+        return ret;
+    }}
+    uint32_t num_params = {num_args};
+    // the global scratch pointer precedes the shared memory argument
+    if ({global_scratch_size} > 0) {{
+      ze_result_t ret = zeKernelSetArgumentValue({kernel_name}_func, num_params++, sizeof(void *),
+                                                 &{kernel_name}_scratch);
+      if (ret != ZE_RESULT_SUCCESS)
+        return ret;
+    }}
+    if ({shared} > 0) {{
+      // local memory arguments only carry a size
+      ze_result_t ret = zeKernelSetArgumentValue({kernel_name}_func, num_params, {shared}, NULL);
+      if (ret != ZE_RESULT_SUCCESS)
+        return ret;
+    }}
+    ze_group_count_t group_count = {{gX, gY, gZ}};
+    if(gX * gY * gZ > 0)
+      return zeCommandListAppendLaunchKernel(stream, {kernel_name}_func, &group_count, NULL, 0, NULL);
+    return ZE_RESULT_SUCCESS;
+}}
@@ -20,13 +20,14 @@
 # OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 # SOFTWARE.
 
+import argparse
 import functools
+import glob
 import os
 import re
 import subprocess
 import tempfile
-
-from ..common.backend import path_to_cuobjdump, path_to_nvdisasm
+from collections import Counter
 
 FLINE_RE = re.compile(r'\s*/\*\w{4}\*/\s*([^;]*;)\s*/\* 0x(\w{16}) \*/\s*')
 SLINE_RE = re.compile(r'\s*/\* 0x(\w{16}) \*/\s*')
@@ -78,8 +79,9 @@ def get_sass(cubin_asm, fun=None):
 
 
 def extract(file_path, fun):
-    cuobjdump, _ = path_to_cuobjdump()
-    nvdisasm, _ = path_to_nvdisasm()
+    from ..backends.nvidia.compiler import _path_to_binary
+    cuobjdump, _ = _path_to_binary("cuobjdump")
+    nvdisasm, _ = _path_to_binary("nvdisasm")
     os.environ["NVDISASM_PATH"] = nvdisasm
     if fun is None:
         sass_str = subprocess.check_output([cuobjdump, "-sass", file_path])
@@ -140,3 +142,133 @@ def extract(file_path, fun):
             ret += asm + '\n'
         ret += '\n'
         return ret
+
+
+# ------------------------
+# XPU
+# ------------------------
+
+# `ocloc -device` names of the XPU target archs
+OCLOC_DEVICES = {0: "dg2", 1: "pvc"}
+
+# [label:] [(predicate)] opcode[.modifiers] ...
+GEN_LINE_RE = re.compile(r'\s*(?:\(([^)]*)\)\s*)?([a-z][\w.]*)\s')
+GEN_LABEL_RE = re.compile(r'\s*\w+:\s*$')
+GEN_GRF_RE = re.compile(r'\br(\d+)(?:\.\d+)?\b')
+SEND_OPCODES = {"send", "sendc", "sends", "sendsc"}
+DPAS_OPCODES = {"dpas", "dpasw"}
+
+
+def get_spirv_asm(spv):
+    """Returns the text of the SPIR-V module `spv`, as disassembled by the shipped `spirv-dis`."""
+    from ..backends.intel.compiler import _path_to_binary
+    spirv_dis, _ = _path_to_binary("spirv-dis")
+    fd, path = tempfile.mkstemp(suffix=".spv")
+    try:
+        with open(fd, 'wb') as f:
+            f.write(spv)
+        return subprocess.check_output([spirv_dis, path]).decode()
+    finally:
+        os.remove(path)
+
+
+@functools.lru_cache()
+def get_gen_asm(zebin, device="pvc"):
+    """
+    Returns the GEN ISA of each kernel of the native binary `zebin` (see
+    `CompiledKernel.asm["zebin"]`) by name, as disassembled by `ocloc` for
+    `device`. `ocloc` comes with the GPU driver and is looked up in
+    `TRITON_OCLOC_PATH`, then in PATH.
+    """
+    ocloc = os.environ.get("TRITON_OCLOC_PATH", "ocloc")
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path = os.path.join(tmpdir, "kernel.zebin")
+        with open(path, 'wb') as f:
+            f.write(zebin)
+        dump_dir = os.path.join(tmpdir, "dump")
+        subprocess.check_output([ocloc, "disasm", "-file", path, "-device", device, "-dump", dump_dir],
+                                stderr=subprocess.STDOUT)
+        ret = {}
+        for asm_path in sorted(glob.glob(os.path.join(dump_dir, "*.asm"))):
+            # ocloc names the dumps after the sections holding the kernels, e.g. `.text.<kernel>.asm`
+            name = os.path.basename(asm_path)[:-len(".asm")]
+            name = name[len(".text."):] if name.startswith(".text.") else name
+            with open(asm_path) as f:
+                ret[name] = f.read()
+        return ret
+
+
+def gen_report(asm):
+    """
+    Returns static counts over the GEN ISA text `asm`: the number of each
+    opcode, of DPAS and of send instructions, of the sends that access the
+    scratch space (which, in Triton kernels, only register spills and fills
+    do) and the highest GRF referenced, a lower bound of the registers used.
+    """
+    mix = Counter()
+    spills = fills = 0
+    max_grf = -1
+    for line in asm.splitlines():
+        code, _, comment = line.partition("//")
+        if not code.strip() or GEN_LABEL_RE.match(code):
+            continue
+        match = GEN_LINE_RE.match(code + " ")
+        if match is None:
+            continue
+        opcode = match.group(2).split(".")[0]
+        mix[opcode] += 1
+        max_grf = max([max_grf] + [int(r) for r in GEN_GRF_RE.findall(code)])
+        # the decoded message descriptor is printed in the trailing comment
+        if opcode in SEND_OPCODES and re.search(r'scratch|\.ss\[', line):
+            if re.search(r'\b(?:store|write)', comment or code):
+                spills += 1
+            else:
+                fills += 1
+    return {
+        "instructions": sum(mix.values()),
+        "mix": dict(mix.most_common()),
+        "dpas": sum(mix[op] for op in DPAS_OPCODES),
+        "sends": sum(mix[op] for op in SEND_OPCODES),
+        "spill_stores": spills,
+        "spill_fills": fills,
+        "max_grf": max_grf,
+    }
+
+
+def xpu_report(kernel, device=None):
+    """
+    Returns the `gen_report` of each kernel in the native binary of the XPU
+    `CompiledKernel` `kernel`, with the register usage reported by the driver.
+    """
+    kernel._init_handles()
+    if device is None:
+        from ..runtime.driver import driver
+        device = OCLOC_DEVICES[driver.active.get_current_target()[1]]
+    ret = {}
+    for name, asm in get_gen_asm(kernel.asm["zebin"], device).items():
+        ret[name] = dict(gen_report(asm), n_regs=kernel.n_regs, spill_bytes=kernel.n_spills,
+                         grf_mode=getattr(kernel.metadata, "grf_mode", None) or "default")
+    return ret
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Disassembles an XPU native binary and reports static counts")
+    parser.add_argument("zebin", help="native binary, e.g. the .zebin of a kernel in the Triton cache")
+    parser.add_argument("--device", default="pvc", help="ocloc device name, e.g. pvc or dg2")
+    parser.add_argument("--asm", action="store_true", help="print the GEN ISA too")
+    args = parser.parse_args()
+    with open(args.zebin, 'rb') as f:
+        kernels = get_gen_asm(f.read(), args.device)
+    for name, asm in kernels.items():
+        print(f"Function:{name}")
+        if args.asm:
+            print(asm)
+        report = gen_report(asm)
+        for key in ("instructions", "dpas", "sends", "spill_stores", "spill_fills", "max_grf"):
+            print(f"  {key:<14}{report[key]:>8}")
+        print("  mix: " + ", ".join(f"{op} {n}" for op, n in report["mix"].items()))
+        print()
+
+
+if __name__ == "__main__":
+    main()
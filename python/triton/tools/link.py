@@ -26,6 +26,26 @@ class KernelLinkerMeta:
     """ number of specialized arguments """
 
 
+@dataclass
+class LinkerTarget:
+    include: str
+    result: str
+    stream: str
+    invalid_value: str
+    load_params: str = "void"
+    load_args: str = ""
+
+
+TARGETS = {
+    "cuda":
+    LinkerTarget(include="cuda.h", result="CUresult", stream="CUstream", invalid_value="CUDA_ERROR_INVALID_VALUE"),
+    "xpu":
+    LinkerTarget(include="level_zero/ze_api.h", result="ze_result_t", stream="ze_command_list_handle_t",
+                 invalid_value="ZE_RESULT_ERROR_INVALID_ARGUMENT",
+                 load_params="ze_context_handle_t context, ze_device_handle_t device", load_args="context, device"),
+}
+
+
 class HeaderParser:
 
     def __init__(self) -> None:
@@ -131,76 +151,161 @@ def gen_signature(m):
 
 
 # generate declarations of kernels with meta-parameter and constant values
-def make_algo_decls(name: str, metas: Sequence[KernelLinkerMeta]) -> str:
+def make_algo_decls(name: str, metas: Sequence[KernelLinkerMeta], target: LinkerTarget = TARGETS["cuda"]) -> str:
     return f"""
-CUresult {name}(CUstream stream, {gen_signature_with_full_args(metas[-1])});
-void load_{name}();
+{target.result} {name}({target.stream} stream, {gen_signature_with_full_args(metas[-1])});
+void load_{name}({target.load_params});
 void unload_{name}();
     """
 
 
 # generate declarations of kernels with meta-parameter and constant values
-def make_global_decl(meta: KernelLinkerMeta) -> str:
+def make_global_decl(meta: KernelLinkerMeta, target: LinkerTarget = TARGETS["cuda"]) -> str:
     return f"""
-CUresult {meta.orig_kernel_name}_default(CUstream stream, {gen_signature_with_full_args(meta)});
-CUresult {meta.orig_kernel_name}(CUstream stream, {gen_signature_with_full_args(meta)}, int algo_id);
-void load_{meta.orig_kernel_name}();
+{target.result} {meta.orig_kernel_name}_default({target.stream} stream, {gen_signature_with_full_args(meta)});
+{target.result} {meta.orig_kernel_name}({target.stream} stream, {gen_signature_with_full_args(meta)}, int algo_id);
+void load_{meta.orig_kernel_name}({target.load_params});
 void unload_{meta.orig_kernel_name}();
     """
 
 
 # generate dispatcher function for kernels with different meta-parameter and constant values
-def make_default_algo_kernel(meta: KernelLinkerMeta) -> str:
-    src = f"CUresult {meta.orig_kernel_name}_default(CUstream stream, {gen_signature_with_full_args(meta)}){{\n"
+def make_default_algo_kernel(meta: KernelLinkerMeta, target: LinkerTarget = TARGETS["cuda"]) -> str:
+    src = f"{target.result} {meta.orig_kernel_name}_default({target.stream} stream, {gen_signature_with_full_args(meta)}){{\n"
     src += (f"  return {meta.orig_kernel_name}(stream, {', '.join(meta.arg_names)}, 0);\n")
     src += "}\n"
     return src
 
 
+# dispatchers over at most this many hint conditions switch over a key packing
+# the outcome of each of them, for which C compilers emit a jump table
+MAX_DISPATCH_TABLE_BITS = 8
+
+
+def _variant_name(meta: KernelLinkerMeta) -> str:
+    return f"{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}"
+
+
+def _hint_cond(val: str, hint: int) -> str:
+    return f"({val} % {hint} == 0)" if hint == 16 else f"({val} == {hint})"
+
+
+def _hint_conds(metas: Sequence[KernelLinkerMeta]):
+    """Returns the (argument name, hint) conditions the variants of `metas` are specialized for, in argument order."""
+    conds = []
+    for meta in metas:
+        conds += [(val, hint) for val, hint in zip(meta.arg_names, meta.sizes) if hint is not None]
+    order = {name: i for i, name in enumerate(metas[-1].arg_names)}
+    return sorted(set(conds), key=lambda c: (order[c[0]], c[1]))
+
+
+def _load_params(target: LinkerTarget):
+    """Returns the (type, name) of each parameter of the load functions of `target`."""
+    if target.load_params == "void":
+        return []
+    return [tuple(param.strip().rsplit(" ", 1)) for param in target.load_params.split(",")]
+
+
+def _is_dispatched(key: int, meta: KernelLinkerMeta, conds) -> bool:
+    """Returns whether all the hint conditions of `meta` hold for `key`, which packs the outcome of `conds`."""
+    hints = set(zip(meta.arg_names, meta.sizes))
+    return all(key >> i & 1 for i, cond in enumerate(conds) if cond in hints)
+
+
+def _make_variant_call(meta: KernelLinkerMeta, lazy: bool) -> str:
+    arg_names = [arg for arg, hint in zip(meta.arg_names, meta.sizes) if hint != 1]
+    call = f"return {_variant_name(meta)}(stream, {', '.join(arg_names)});"
+    if lazy:
+        call = f"{{ ensure_{_variant_name(meta)}(); {call} }}"
+    return call
+
+
 # generate dispatcher function for kernels with different integer value hints
-def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta]) -> str:
+def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta], target: LinkerTarget = TARGETS["cuda"],
+                                 lazy: bool = False) -> str:
+    metas = sorted(metas, key=lambda m: -m.num_specs)
     src = f"// launcher for: {name}\n"
-    for meta in sorted(metas, key=lambda m: -m.num_specs):
-        src += f"CUresult {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}(CUstream stream, {gen_signature(meta)});\n"
+    for meta in metas:
+        src += f"{target.result} {_variant_name(meta)}({target.stream} stream, {gen_signature(meta)});\n"
+        src += f"void load_{_variant_name(meta)}({target.load_params});\n"
+        src += f"void unload_{_variant_name(meta)}(void);\n"
     src += "\n"
 
-    src += (f"CUresult {name}(CUstream stream, {gen_signature_with_full_args(metas[-1])}){{")
+    load_params = _load_params(target)
+    if lazy:
+        # variants are loaded the first time they are dispatched to, with the
+        # arguments `load_{name}` got
+        for ty, arg in load_params:
+            src += f"static {ty} {name}_{arg};\n"
+        for meta in metas:
+            src += f"static int {_variant_name(meta)}_loaded = 0;\n"
+            src += f"static inline void ensure_{_variant_name(meta)}(void) {{\n"
+            src += f"  if (!{_variant_name(meta)}_loaded) {{\n"
+            src += f"    load_{_variant_name(meta)}({', '.join(f'{name}_{arg}' for _, arg in load_params)});\n"
+            src += f"    {_variant_name(meta)}_loaded = 1;\n"
+            src += "  }\n"
+            src += "}\n"
+        src += "\n"
+
+    src += (f"{target.result} {name}({target.stream} stream, {gen_signature_with_full_args(metas[0])}){{")
     src += "\n"
-    for meta in sorted(metas, key=lambda m: -m.num_specs):
-        cond_fn = (  #
-            lambda val, hint: f"({val} % {hint} == 0)"  #
-            if hint == 16  #
-            else f"({val} == {hint})"  #
-            if hint == 1  #
-            else None)
-        conds = " && ".join([  #
-            cond_fn(val, hint)  #
-            for val, hint in zip(meta.arg_names, meta.sizes)  #
-            if hint is not None
-        ])
-        src += (f"  if ({conds})\n" if any(meta.sizes) else "if (1)\n"
-                )  # Edge case where no specializations hence no dispatching required
-        arg_names = [arg for arg, hint in zip(meta.arg_names, meta.sizes) if hint != 1]
-        src += f"    return {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}(stream, {', '.join(arg_names)});\n"
+    conds = _hint_conds(metas)
+    if len(conds) <= MAX_DISPATCH_TABLE_BITS:
+        # bit i of the key is set when conds[i] holds; each key dispatches to
+        # the most specialized variant all the conditions of which hold
+        src += "  unsigned key = 0"
+        for i, (val, hint) in enumerate(conds):
+            src += f" |\n                 ({_hint_cond(val, hint)} << {i})"
+        src += ";\n"
+        src += "  switch (key) {\n"
+        dispatched = defaultdict(list)
+        for key in range(1 << len(conds)):
+            meta = next((m for m in metas if _is_dispatched(key, m, conds)), None)
+            if meta is not None:
+                dispatched[_variant_name(meta)].append(key)
+        for meta in metas:
+            if not dispatched[_variant_name(meta)]:
+                continue
+            for key in dispatched[_variant_name(meta)]:
+                src += f"  case {key}:\n"
+            src += f"    {_make_variant_call(meta, lazy)}\n"
+        src += "  default:\n"
+        src += "    break;\n"
+        src += "  }\n"
+    else:
+        for meta in metas:
+            meta_conds = " && ".join(
+                [_hint_cond(val, hint) for val, hint in zip(meta.arg_names, meta.sizes) if hint is not None])
+            src += (f"  if ({meta_conds})\n" if any(meta.sizes) else "if (1)\n"
+                    )  # Edge case where no specializations hence no dispatching required
+            src += f"    {_make_variant_call(meta, lazy)}\n"
     src += "\n"
-    src += "  return CUDA_ERROR_INVALID_VALUE;\n"
+    src += f"  return {target.invalid_value};\n"
     src += "}\n"
 
     for mode in ["load", "unload"]:
+        params, args = (target.load_params, target.load_args) if mode == "load" else ("", "")
         src += f"\n// {mode} for: {name}\n"
-        for meta in sorted(metas, key=lambda m: -m.num_specs):
-            src += f"void {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}();\n"
-        src += f"void {mode}_{name}() {{"
+        src += f"void {mode}_{name}({params}) {{"
         src += "\n"
-        for meta in sorted(metas, key=lambda m: -m.num_specs):
-            src += (f"  {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}();\n")
+        for meta in metas:
+            if not lazy:
+                src += (f"  {mode}_{_variant_name(meta)}({args});\n")
+            elif mode == "unload":
+                src += f"  if ({_variant_name(meta)}_loaded) {{\n"
+                src += f"    unload_{_variant_name(meta)}();\n"
+                src += f"    {_variant_name(meta)}_loaded = 0;\n"
+                src += "  }\n"
+        if lazy and mode == "load":
+            for _, arg in load_params:
+                src += f"  {name}_{arg} = {arg};\n"
         src += "}\n"
     return src
 
 
 # generate dispatcher function for kernels with different meta-parameter and constant values
-def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta) -> str:
-    src = f"CUresult {meta.orig_kernel_name}(CUstream stream, {gen_signature_with_full_args(meta)}, int algo_id){{\n"
+def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta, target: LinkerTarget = TARGETS["cuda"]) -> str:
+    src = f"{target.result} {meta.orig_kernel_name}({target.stream} stream, {gen_signature_with_full_args(meta)}, int algo_id){{\n"
     src += f"  assert (algo_id < (int)sizeof({meta.orig_kernel_name}_kernels));\n"
     src += f"  return {meta.orig_kernel_name}_kernels[algo_id](stream, {', '.join(meta.arg_names)});\n"
     src += "}\n"
@@ -208,9 +313,9 @@ def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta) -> str:
 
 
 # generate definition of function pointers of kernel dispatchers based on meta-parameter and constant values
-def make_func_pointers(names: str, meta: KernelLinkerMeta) -> str:
+def make_func_pointers(names: str, meta: KernelLinkerMeta, target: LinkerTarget = TARGETS["cuda"]) -> str:
     # the table of hint dispatchers
-    src = f"typedef CUresult (*kernel_func_t)(CUstream stream, {gen_signature_with_full_args(meta)});\n"
+    src = f"typedef {target.result} (*kernel_func_t)({target.stream} stream, {gen_signature_with_full_args(meta)});\n"
     src += f"kernel_func_t {meta.orig_kernel_name}_kernels[] = {{\n"
     for name in names:
         src += f"  {name},\n"
@@ -219,12 +324,13 @@ def make_func_pointers(names: str, meta: KernelLinkerMeta) -> str:
 
 
 # generate definition for load/unload functions for kernels with different meta-parameter and constant values
-def make_kernel_load_def(names: str, meta: KernelLinkerMeta) -> str:
+def make_kernel_load_def(names: str, meta: KernelLinkerMeta, target: LinkerTarget = TARGETS["cuda"]) -> str:
     src = ""
     for mode in ["load", "unload"]:
-        src += f"void {mode}_{meta.orig_kernel_name}(void){{\n"
+        params, args = (target.load_params, target.load_args) if mode == "load" else ("void", "")
+        src += f"void {mode}_{meta.orig_kernel_name}({params}){{\n"
         for name in names:
-            src += f"  {mode}_{name}();\n"
+            src += f"  {mode}_{name}({args});\n"
         src += "}\n\n"
     return src
 
@@ -246,7 +352,10 @@ Triton ahead-of-time linker:
 
 This program takes in header files generated by compile.py, and generates a
 single entry-point responsible for dispatching the user's input to the right
-kernel given the specializations that were compiled.
+kernel given the specializations that were compiled. Dispatchers over few
+specializations switch over a key of the hints the arguments satisfy, which
+takes constant time however many variants there are. With --lazy, variants are
+loaded the first time they are launched rather than all by `load_*`.
 
 Example usage:
 python link.py /path/to/headers/*.h -o kernel_name
@@ -268,7 +377,20 @@ if __name__ == "__main__":
         default="",
         help="String to prefix kernel dispatcher names",
     )
+    parser.add_argument(
+        "--target",
+        type=str,
+        choices=list(TARGETS.keys()),
+        default="cuda",
+        help="Runtime targeted by the kernels being linked (see compile.py --target)",
+    )
+    parser.add_argument(
+        "--lazy",
+        action="store_true",
+        help="Load each variant on its first launch; `load_*` only records the arguments to load it with",
+    )
     args = parser.parse_args()
+    target = TARGETS[args.target]
 
     # metadata
     parser = HeaderParser()
@@ -280,13 +402,13 @@ if __name__ == "__main__":
         parser.extract_linker_meta(h_str)
 
     # generate headers
-    algo_decls = [make_algo_decls(name, meta) for name, meta in parser.kernels.items()]
+    algo_decls = [make_algo_decls(name, meta, target) for name, meta in parser.kernels.items()]
     meta_lists = [meta for name, meta in parser.kernels.items()]
     meta = meta_lists[0][0]
     get_num_algos_decl = make_get_num_algos_decl(meta)
-    global_decl = make_global_decl(meta)
+    global_decl = make_global_decl(meta, target)
     with args.out.with_suffix(".h").open("w") as fp:
-        out = "#include <cuda.h>\n"
+        out = f"#include <{target.include}>\n"
         out += "\n".join(algo_decls)
         out += "\n"
         out += get_num_algos_decl
@@ -295,16 +417,16 @@ if __name__ == "__main__":
         fp.write(out)
 
     # generate source
-    defs = [make_kernel_hints_dispatcher(name, meta) for name, meta in parser.kernels.items()]
+    defs = [make_kernel_hints_dispatcher(name, meta, target, args.lazy) for name, meta in parser.kernels.items()]
     names = [name for name in parser.kernels.keys()]
-    func_pointers_def = make_func_pointers(names, meta)
-    meta_const_def = make_kernel_meta_const_dispatcher(meta)
-    load_unload_def = make_kernel_load_def(names, meta)
+    func_pointers_def = make_func_pointers(names, meta, target)
+    meta_const_def = make_kernel_meta_const_dispatcher(meta, target)
+    load_unload_def = make_kernel_load_def(names, meta, target)
     get_num_algos_def = make_get_num_algos_def(meta)
-    default_algo_kernel = make_default_algo_kernel(meta)
+    default_algo_kernel = make_default_algo_kernel(meta, target)
     with args.out.with_suffix(".c").open("w") as fp:
         out = ""
-        out += "#include <cuda.h>\n"
+        out += f"#include <{target.include}>\n"
         out += "#include <stdint.h>\n"
         out += "#include <assert.h>\n"
         out += "\n"
@@ -0,0 +1,90 @@
+"""
+Interestingness test for `triton-reduce` that keeps a performance problem
+instead of a miscompilation: a candidate module is interesting when, compiled
+and loaded on the current device, it still spills at least `--min-spills`
+registers or still runs for at least `--min-ms` milliseconds.
+
+    cat > interesting.sh <<'EOF'
+    #!/bin/sh
+    exec python -m triton.tools.perf_interesting --min-spills 1 "$@"
+    EOF
+    triton-reduce kernel.ttgir -reduction-tree='traversal-mode=0 test=./interesting.sh'
+
+`triton-reduce` passes the candidate file last and keeps the candidates the
+test exits with 1 for. Candidates that fail to compile or to run are not
+interesting, so reductions never trade the performance problem for a crash.
+
+Timing launches the kernel on `--grid` programs, with a zeroed buffer of
+`--buffer-bytes` bytes for each pointer argument and `--int-value` for each
+integer argument, which must keep the accesses of the kernel within bounds.
+"""
+
+import argparse
+import json
+import sys
+
+import triton
+from triton.compiler.compiler import IRSource
+from triton.runtime.driver import driver
+
+# scalar argument types of the float kinds, as written in the IR
+_FLOAT_TYPES = {"f16", "bf16", "f32", "f64"}
+
+
+def make_args(src, buffer_bytes, int_value):
+    """Arguments for the signature of `src`: a zeroed buffer per pointer and `int_value` per scalar."""
+    import torch
+    backend = driver.active.get_current_target()[0]
+    device = "cuda" if backend == "hip" else backend
+    args = []
+    for ty in src.signature.values():
+        if ty.startswith("*"):
+            args.append(torch.zeros(buffer_bytes, dtype=torch.uint8, device=device))
+        elif ty in _FLOAT_TYPES:
+            args.append(float(int_value))
+        else:
+            args.append(int_value)
+    return args
+
+
+def measure(path, options, grid, buffer_bytes, int_value, time_it):
+    """Returns the number of spilled registers of the kernel at `path` and its run time in ms, if `time_it`."""
+    src = IRSource(path)
+    kernel = triton.compile(path, options=options)
+    kernel._init_handles()
+    ms = None
+    if time_it:
+        runner = kernel[grid]
+        args = make_args(src, buffer_bytes, int_value)
+        ms = triton.testing.do_bench(lambda: runner(*args))
+    return kernel.n_spills, ms
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("file", help="candidate .ttir or .ttgir module")
+    parser.add_argument("--min-spills", type=int, default=None, help="interesting from this many spills")
+    parser.add_argument("--min-ms", type=float, default=None, help="interesting from this run time, in ms")
+    parser.add_argument("--options", default="{}", help="JSON object of backend options, e.g. '{\"num_warps\": 8}'")
+    parser.add_argument("--grid", type=int, nargs="+", default=[1], help="number of programs launched per axis")
+    parser.add_argument("--buffer-bytes", type=int, default=1 << 26, help="size of the buffer of each pointer")
+    parser.add_argument("--int-value", type=int, default=1, help="value of each scalar argument")
+    args = parser.parse_args()
+    if args.min_spills is None and args.min_ms is None:
+        parser.error("one of --min-spills and --min-ms is required")
+
+    try:
+        spills, ms = measure(args.file, json.loads(args.options), args.grid, args.buffer_bytes, args.int_value,
+                             args.min_ms is not None)
+    except Exception as e:
+        print(f"not interesting: {type(e).__name__}: {e}", file=sys.stderr)
+        sys.exit(0)
+    interesting = (args.min_spills is not None and spills >= args.min_spills) or \
+                  (args.min_ms is not None and ms >= args.min_ms)
+    print(f"{'interesting' if interesting else 'not interesting'}: {spills} spills" +
+          (f", {ms:.3f} ms" if ms is not None else ""), file=sys.stderr)
+    sys.exit(1 if interesting else 0)
+
+
+if __name__ == "__main__":
+    main()
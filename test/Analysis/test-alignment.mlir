@@ -475,6 +475,64 @@ tt.func @for_dynamic(%lb: index {tt.divisibility = 16 : i32}, %step: index {tt.d
 
 // -----
 
+// CHECK-LABEL: @for_carried_ptr
+tt.func @for_carried_ptr(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %ub: index) {
+  // CHECK: contiguity = [128], divisibility = [1073741824], constancy = [1], constant_value = <none>
+  %range = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  // CHECK-NEXT: contiguity = [1], divisibility = [16], constancy = [128], constant_value = <none>
+  %splat = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<128x!tt.ptr<f32>>
+  // CHECK-NEXT: contiguity = [128], divisibility = [16], constancy = [1], constant_value = <none>
+  %init = tt.addptr %splat, %range : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  // CHECK-NEXT: contiguity = [1], divisibility = [128], constancy = [128], constant_value = 128
+  %stride = arith.constant dense<128> : tensor<128xi32>
+  // CHECK-NEXT: contiguity = [1], divisibility = [4611686018427387904], constancy = [1], constant_value = 0
+  %lb = arith.constant 0 : index
+  // CHECK-NEXT: contiguity = [1], divisibility = [1], constancy = [1], constant_value = 1
+  %step = arith.constant 1 : index
+  %res = scf.for %iv = %lb to %ub step %step iter_args(%ptr = %init) -> (tensor<128x!tt.ptr<f32>>) {
+    // CHECK-NEXT: contiguity = [128], divisibility = [16], constancy = [1], constant_value = <none>
+    %next = tt.addptr %ptr, %stride : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+    scf.yield %next : tensor<128x!tt.ptr<f32>>
+  }
+  // CHECK-NEXT: contiguity = [128], divisibility = [16], constancy = [1], constant_value = <none>
+  tt.return
+}
+
+// -----
+
+// CHECK-LABEL: @while_carried_ptr
+tt.func @while_carried_ptr(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %n: i32) {
+  // CHECK: contiguity = [128], divisibility = [1073741824], constancy = [1], constant_value = <none>
+  %range = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  // CHECK-NEXT: contiguity = [1], divisibility = [16], constancy = [128], constant_value = <none>
+  %splat = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<128x!tt.ptr<f32>>
+  // CHECK-NEXT: contiguity = [128], divisibility = [16], constancy = [1], constant_value = <none>
+  %init = tt.addptr %splat, %range : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  // CHECK-NEXT: contiguity = [1], divisibility = [128], constancy = [128], constant_value = 128
+  %stride = arith.constant dense<128> : tensor<128xi32>
+  // CHECK-NEXT: contiguity = [1], divisibility = [4611686018427387904], constancy = [1], constant_value = 0
+  %c0 = arith.constant 0 : i32
+  // CHECK-NEXT: contiguity = [1], divisibility = [1], constancy = [1], constant_value = 1
+  %c1 = arith.constant 1 : i32
+  %res:2 = scf.while (%ptr = %init, %i = %c0) : (tensor<128x!tt.ptr<f32>>, i32) -> (tensor<128x!tt.ptr<f32>>, i32) {
+    // CHECK-NEXT: contiguity = [1], divisibility = [1], constancy = [1], constant_value = <none>
+    %cond = arith.cmpi slt, %i, %n : i32
+    scf.condition(%cond) %ptr, %i : tensor<128x!tt.ptr<f32>>, i32
+  } do {
+  ^bb0(%ptr: tensor<128x!tt.ptr<f32>>, %i: i32):
+    // CHECK-NEXT: contiguity = [128], divisibility = [16], constancy = [1], constant_value = <none>
+    %next = tt.addptr %ptr, %stride : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+    // CHECK-NEXT: contiguity = [1], divisibility = [1], constancy = [1], constant_value = <none>
+    %i_next = arith.addi %i, %c1 : i32
+    scf.yield %next, %i_next : tensor<128x!tt.ptr<f32>>, i32
+  }
+  // CHECK-NEXT: contiguity = [128], divisibility = [16], constancy = [1], constant_value = <none>
+  // CHECK-NEXT: contiguity = [1], divisibility = [1], constancy = [1], constant_value = <none>
+  tt.return
+}
+
+// -----
+
 // CHECK-LABEL: @permute_2d
 tt.func @permute_2d(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}, %arg2: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg3: i32 {tt.divisibility = 16 : i32}) {
   // CHECK: contiguity = [1, 1], divisibility = [1, 1], constancy = [128, 128], constant_value = 1
@@ -0,0 +1,84 @@
+// RUN: triton-opt %s --mlir-disable-threading -test-print-kernel-stats 2>&1 | FileCheck %s
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#L1D = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+#A_SHARED = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#C = #triton_gpu.nvidia_mma<{versionMajor = 2, warpsPerCTA = [4, 1]}>
+#A_DOT = #triton_gpu.dot_op<{opIdx = 0, parent = #C}>
+#B_DOT = #triton_gpu.dot_op<{opIdx = 1, parent = #C}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+
+// CHECK: "shared": {{[1-9][0-9]*}},
+// COM: Reading the converted buffer back from shared memory needs a barrier.
+// CHECK-NEXT: "barriers": 1,
+// CHECK-NEXT: "convert_layouts": [
+// CHECK-NEXT: {
+// CHECK-NEXT: "src": "#triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32]
+// CHECK-NEXT: "dst": "#triton_gpu.dot_op<{opIdx = 1
+// CHECK-NEXT: "count": 1
+// CHECK: "src": "#triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8]
+// CHECK-NEXT: "dst": "#triton_gpu.dot_op<{opIdx = 0
+// CHECK-NEXT: "count": 1
+// CHECK: "src": "#triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8]
+// CHECK-NEXT: "dst": "#triton_gpu.shared<
+// CHECK-NEXT: "count": 1
+// CHECK: "src": "#triton_gpu.shared<
+// CHECK-NEXT: "dst": "#triton_gpu.shared<
+// CHECK-NEXT: "count": 1
+// CHECK: "accesses": [
+// CHECK-NEXT: {
+// COM: Splats of an unaligned pointer.
+// CHECK-NEXT: "kind": "load",
+// CHECK-NEXT: "vec": 1,
+// CHECK-NEXT: "bits": 16,
+// CHECK-NEXT: "count": 3
+// COM: Four contiguous and aligned halves per thread.
+// CHECK: "kind": "load",
+// CHECK-NEXT: "vec": 4,
+// CHECK-NEXT: "bits": 64,
+// CHECK-NEXT: "count": 1
+// CHECK: "kind": "store",
+// CHECK-NEXT: "vec": 4,
+// CHECK-NEXT: "bits": 64,
+// CHECK-NEXT: "count": 1
+// CHECK: "dots": [
+// CHECK-NEXT: {
+// CHECK-NEXT: "m": 128,
+// CHECK-NEXT: "n": 128,
+// CHECK-NEXT: "k": 32,
+// CHECK-NEXT: "operand": "f16",
+// CHECK-NEXT: "encoding": "#triton_gpu.nvidia_mma<{versionMajor = 2
+// CHECK-NEXT: "count": 1
+
+tt.func @matmul(%A : !tt.ptr<f16>, %B : !tt.ptr<f16>) -> tensor<128x128xf32, #C> {
+  %a_ptr = tt.splat %A : (!tt.ptr<f16>) -> tensor<128x32x!tt.ptr<f16>, #AL>
+  %b_ptr = tt.splat %B : (!tt.ptr<f16>) -> tensor<32x128x!tt.ptr<f16>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_ = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+  %a = triton_gpu.convert_layout %a_ : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A_DOT>
+  %b_ = tt.load %b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16, #BL>
+  %b = triton_gpu.convert_layout %b_ : (tensor<32x128xf16, #BL>) -> tensor<32x128xf16, #B_DOT>
+  %c = tt.dot %a, %b, %c_init {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<128x32xf16, #A_DOT> * tensor<32x128xf16, #B_DOT> -> tensor<128x128xf32, #C>
+  tt.return %c : tensor<128x128xf32, #C>
+}
+
+tt.func @raw_single_block(%A : !tt.ptr<f16>) {
+  %0 = tt.splat %A : (!tt.ptr<f16>) -> tensor<128x32x!tt.ptr<f16>, #AL>
+  %1 = tt.load %0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+  %2 = triton_gpu.convert_layout %1 : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A_SHARED>
+  %3 = triton_gpu.convert_layout %2 : (tensor<128x32xf16, #A_SHARED>) -> tensor<128x32xf16, #A_SHARED>
+  tt.return
+}
+
+tt.func @copy(%A : !tt.ptr<f16> {tt.divisibility = 16 : i32}) {
+  %0 = tt.make_range {end = 512 : i32, start = 0 : i32} : tensor<512xi32, #L1D>
+  %1 = tt.splat %A : (!tt.ptr<f16>) -> tensor<512x!tt.ptr<f16>, #L1D>
+  %2 = tt.addptr %1, %0 : tensor<512x!tt.ptr<f16>, #L1D>, tensor<512xi32, #L1D>
+  %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<512xf16, #L1D>
+  tt.store %2, %3 : tensor<512xf16, #L1D>
+  tt.return
+}
+
+}
@@ -169,6 +169,32 @@ tt.func @insert_slice_op(%A : !tt.ptr<f16>, %i1 : i1) {
   tt.return
 }
 
+// Accesses to different stages of a multi-buffer do not conflict
+// CHECK-LABEL: insert_slice_async_stages
+tt.func @insert_slice_async_stages(%A : !tt.ptr<f16>) {
+  %a_ptr = tt.splat %A : (!tt.ptr<f16>) -> tensor<16x16x!tt.ptr<f16>, #AL>
+  %tensor = triton_gpu.alloc_tensor : tensor<2x16x16xf16, #A_SHARED>
+  %c0 = arith.constant 0 : i32
+  %c1 = arith.constant 1 : i32
+  %0 = triton_gpu.insert_slice_async %a_ptr, %tensor, %c0 {axis = 0 : i32, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x16x!tt.ptr<f16>, #AL> -> tensor<2x16x16xf16, #A_SHARED>
+  // CHECK-NOT: gpu.barrier
+  // CHECK: triton_gpu.insert_slice_async
+  %1 = triton_gpu.insert_slice_async %a_ptr, %0, %c1 {axis = 0 : i32, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x16x!tt.ptr<f16>, #AL> -> tensor<2x16x16xf16, #A_SHARED>
+  // CHECK: triton_gpu.async_wait
+  // CHECK-NEXT: gpu.barrier
+  triton_gpu.async_wait {num = 0 : i32}
+  %2 = triton_gpu.extract_slice %1[%c0, 0, 0][1, 16, 16][1, 1, 1] : tensor<2x16x16xf16, #A_SHARED> to tensor<16x16xf16, #A_SHARED>
+  %3 = triton_gpu.convert_layout %2 : (tensor<16x16xf16, #A_SHARED>) -> tensor<16x16xf16, #AL>
+  // CHECK-NOT: gpu.barrier
+  // CHECK: triton_gpu.insert_slice_async
+  %4 = triton_gpu.insert_slice_async %a_ptr, %1, %c1 {axis = 0 : i32, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x16x!tt.ptr<f16>, #AL> -> tensor<2x16x16xf16, #A_SHARED>
+  %5 = triton_gpu.extract_slice %4[%c1, 0, 0][1, 16, 16][1, 1, 1] : tensor<2x16x16xf16, #A_SHARED> to tensor<16x16xf16, #A_SHARED>
+  // CHECK: gpu.barrier
+  // CHECK-NEXT: triton_gpu.convert_layout
+  %6 = triton_gpu.convert_layout %5 : (tensor<16x16xf16, #A_SHARED>) -> tensor<16x16xf16, #AL>
+  tt.return
+}
+
 // If branch inserted a barrier for %cst0 and %cst1, but else didn't, then the barrier should be inserted in the parent region
 // CHECK-LABEL: multi_blocks
 tt.func @multi_blocks(%i1 : i1) {
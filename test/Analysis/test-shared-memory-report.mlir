@@ -0,0 +1,46 @@
+// RUN: triton-opt %s --mlir-disable-threading -test-print-shared-memory-report="shared-memory-per-core=4096 max-warps-per-core=64" 2>&1 | FileCheck %s
+
+#A_SHARED = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+
+// COM: 16 work-groups of 4 warps fit the warp limit, but only two fit in the
+// COM: 4 KB of shared memory.
+// CHECK: "shared": 2048,
+// CHECK-NEXT: "num_warps": 4,
+// CHECK-NEXT: "work_groups_per_core": 2,
+// CHECK-NEXT: "occupancy": 0.125,
+// CHECK-NEXT: "limited_by": "shared",
+// CHECK: "name": "peak",
+// CHECK-NEXT: "size": 2048,
+// CHECK-NEXT: "peak_live_size": 2048,
+// CHECK-NEXT: "peak_live_op": "triton_gpu.alloc_tensor",
+// CHECK-NEXT: "peak_live_loc": {{.*}}test-shared-memory-report.mlir{{.*}}:39:
+// CHECK: "kind": "explicit",
+// CHECK-NEXT: "offset": 0,
+// CHECK-NEXT: "size": 1024,
+// CHECK-NEXT: "owner": "triton_gpu.alloc_tensor",
+// CHECK-NEXT: "loc": {{.*}}:38:
+// CHECK-NEXT: "live_at_peak": true
+// CHECK: "kind": "explicit",
+// CHECK-NEXT: "offset": 1024,
+// CHECK-NEXT: "size": 1024,
+// CHECK-NEXT: "owner": "triton_gpu.alloc_tensor",
+// CHECK-NEXT: "loc": {{.*}}:39:
+// CHECK-NEXT: "live_at_peak": true
+// CHECK: "kind": "explicit",
+// CHECK-NEXT: "offset": {{[0-9]+}},
+// CHECK-NEXT: "size": 512,
+// CHECK-NEXT: "owner": "triton_gpu.alloc_tensor",
+// CHECK-NEXT: "loc": {{.*}}:42:
+// CHECK-NEXT: "live_at_peak": false
+tt.func @peak(%A : !tt.ptr<f16>) {
+  %cst0 = triton_gpu.alloc_tensor : tensor<32x16xf16, #A_SHARED>
+  %cst1 = triton_gpu.alloc_tensor : tensor<32x16xf16, #A_SHARED>
+  triton_gpu.dealloc_tensor %cst0 : tensor<32x16xf16, #A_SHARED>
+  // cst0 is released: the third buffer does not add to the peak.
+  %cst2 = triton_gpu.alloc_tensor : tensor<16x16xf16, #A_SHARED>
+  tt.return
+}
+
+}
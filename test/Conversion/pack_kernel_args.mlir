@@ -0,0 +1,39 @@
+// RUN: triton-opt %s -split-input-file -pack-kernel-args="threshold=3" | FileCheck %s
+
+// COM: The i32, i64 and f32 arguments are loaded from a struct passed first,
+// COM: with the 8-byte fields first, and the others are kept in order.
+// CHECK: module attributes {triton_gpu.packed_args = array<i32: 2, 1, 4, 5>}
+// CHECK-LABEL: llvm.func @kernel(%arg0: !llvm.ptr {llvm.align = 8 : i64, llvm.byval = !llvm.struct<(i64, i32, f32, i32)>}, %arg1: !llvm.ptr<1>, %arg2: i1)
+// CHECK: %[[STRIDE_ADDR:.*]] = llvm.getelementptr %arg0[0, 0] : (!llvm.ptr) -> !llvm.ptr, !llvm.struct<(i64, i32, f32, i32)>
+// CHECK: %[[STRIDE:.*]] = llvm.load %[[STRIDE_ADDR]] : !llvm.ptr -> i64
+// CHECK: %[[N_ADDR:.*]] = llvm.getelementptr %arg0[0, 1]
+// CHECK: %[[N:.*]] = llvm.load %[[N_ADDR]] : !llvm.ptr -> i32
+// CHECK: llvm.getelementptr %arg0[0, 2]
+// CHECK: llvm.getelementptr %arg0[0, 3]
+// CHECK: llvm.mul %[[N]], %{{.*}} : i32
+// CHECK: llvm.sext %{{.*}} : i32 to i64
+// CHECK: llvm.mul %{{.*}}, %[[STRIDE]] : i64
+module {
+  llvm.func @kernel(%ptr: !llvm.ptr<1>, %n: i32, %stride: i64, %flag: i1, %scale: f32, %m: i32) {
+    %0 = llvm.mul %n, %m : i32
+    %1 = llvm.sext %0 : i32 to i64
+    %2 = llvm.mul %1, %stride : i64
+    %3 = llvm.getelementptr %ptr[%2] : (!llvm.ptr<1>, i64) -> !llvm.ptr<1>, f32
+    %4 = llvm.select %flag, %scale, %scale : i1, f32
+    llvm.store %4, %3 : f32, !llvm.ptr<1>
+    llvm.return
+  }
+}
+
+// -----
+
+// COM: Kernels with fewer scalar arguments than the threshold are unchanged.
+// CHECK-NOT: triton_gpu.packed_args
+// CHECK-LABEL: llvm.func @few_args(%arg0: !llvm.ptr<1>, %arg1: i32, %arg2: i32)
+module {
+  llvm.func @few_args(%ptr: !llvm.ptr<1>, %n: i32, %m: i32) {
+    %0 = llvm.mul %n, %m : i32
+    llvm.store %0, %ptr : i32, !llvm.ptr<1>
+    llvm.return
+  }
+}
@@ -224,3 +224,53 @@ tt.func @histogram(%0: tensor<512xi32>) {
   %1 = tt.histogram %0 : tensor<512xi32> -> tensor<16xi32>
   tt.return
 }
+
+// CHECK-LABEL: sort
+tt.func @sort(%0: tensor<16x64xf32>) {
+  // CHECK: tt.sort %{{.+}} {axis = 1 : i32, descending = true} : tensor<16x64xf32>
+  %1 = tt.sort %0 {axis = 1 : i32, descending = true} : tensor<16x64xf32>
+  tt.return
+}
+
+// CHECK-LABEL: gather
+tt.func @gather(%0: tensor<16x8xf16>, %1: tensor<16x64xi32>) {
+  // CHECK: tt.gather %{{.+}}[%{{.+}}] {axis = 1 : i32} : (tensor<16x8xf16>, tensor<16x64xi32>) -> tensor<16x64xf16>
+  %2 = tt.gather %0[%1] {axis = 1 : i32} : (tensor<16x8xf16>, tensor<16x64xi32>) -> tensor<16x64xf16>
+  tt.return
+}
+
+// CHECK-LABEL: prefetch
+tt.func @prefetch(%ptrs: tensor<128x!tt.ptr<f32, 1>>, %mask: tensor<128xi1>, %ptr: !tt.ptr<f16, 1>) {
+  // CHECK: tt.prefetch %{{.+}}, %{{.+}} {cacheLevel = 1 : i32} : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi1>
+  tt.prefetch %ptrs, %mask {cacheLevel = 1 : i32} : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi1>
+  %c0 = arith.constant 0 : i32
+  %c1 = arith.constant 1 : i64
+  %c64 = arith.constant 64 : i64
+  %0 = tt.make_tensor_ptr %ptr, [%c64, %c64], [%c64, %c1], [%c0, %c0] {order = array<i32: 1, 0>} : <tensor<32x32xf16>, 1>
+  // CHECK: tt.prefetch %{{.+}} {cacheLevel = 2 : i32} : !tt.ptr<tensor<32x32xf16>, 1>
+  tt.prefetch %0 {cacheLevel = 2 : i32} : !tt.ptr<tensor<32x32xf16>, 1>
+  tt.return
+}
+
+// CHECK-LABEL: warp_ops
+tt.func @warp_ops(%0: tensor<16xf32>, %1: tensor<16xi32>, %2: tensor<16xi1>) {
+  // CHECK: tt.warp_shuffle %{{.+}}, %{{.+}} {kind = 2 : i32} : tensor<16xf32>, tensor<16xi32>
+  %3 = tt.warp_shuffle %0, %1 {kind = 2 : i32} : tensor<16xf32>, tensor<16xi32>
+  // CHECK: tt.warp_ballot %{{.+}} : tensor<16xi1> -> tensor<16xi32>
+  %4 = tt.warp_ballot %2 : tensor<16xi1> -> tensor<16xi32>
+  // CHECK: "tt.warp_reduce"(%{{.+}}) ({
+  // CHECK: tt.reduce.return
+  %5 = "tt.warp_reduce"(%0) ({
+  ^bb0(%arg0: f32, %arg1: f32):
+    %7 = arith.addf %arg0, %arg1 : f32
+    tt.reduce.return %7 : f32
+  }) : (tensor<16xf32>) -> tensor<16xf32>
+  // CHECK: "tt.warp_scan"(%{{.+}}) ({
+  // CHECK: tt.scan.return
+  %6 = "tt.warp_scan"(%1) ({
+  ^bb0(%arg0: i32, %arg1: i32):
+    %7 = arith.maxsi %arg0, %arg1 : i32
+    tt.scan.return %7 : i32
+  }) : (tensor<16xi32>) -> tensor<16xi32>
+  tt.return
+}
@@ -87,3 +87,25 @@ tt.func public @select_op(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg
   tt.store %6, %4 {cache = 1 : i32, evict = 1 : i32} : tensor<128xf32>
   tt.return
 }
+
+// -----
+
+// CHECK: #[[COL_MAJOR:.*]] = #triton_gpu.blocked<{{.*}}order = [0, 1]{{.*}}>
+// CHECK-LABEL: tt.func @column_major_load
+tt.func @column_major_load(%ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}) -> tensor<64x32xf32> {
+  // Shapes mostly accessed along their first dimension start with that order.
+  %rows = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+  %cols = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %c64 = arith.constant dense<64> : tensor<1x32xi32>
+  %0 = tt.expand_dims %rows {axis = 1 : i32} : (tensor<64xi32>) -> tensor<64x1xi32>
+  %1 = tt.expand_dims %cols {axis = 0 : i32} : (tensor<32xi32>) -> tensor<1x32xi32>
+  %2 = arith.muli %1, %c64 : tensor<1x32xi32>
+  %3 = tt.broadcast %0 : (tensor<64x1xi32>) -> tensor<64x32xi32>
+  %4 = tt.broadcast %2 : (tensor<1x32xi32>) -> tensor<64x32xi32>
+  %5 = arith.addi %3, %4 : tensor<64x32xi32>
+  %6 = tt.splat %ptr : (!tt.ptr<f32>) -> tensor<64x32x!tt.ptr<f32>>
+  %7 = tt.addptr %6, %5 : tensor<64x32x!tt.ptr<f32>>, tensor<64x32xi32>
+  // CHECK: tt.load %{{.*}} : tensor<64x32xf32, #[[COL_MAJOR]]>
+  %8 = tt.load %7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x32xf32>
+  tt.return %8 : tensor<64x32xf32>
+}
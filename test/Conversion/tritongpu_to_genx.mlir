@@ -222,18 +222,16 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     // CHECK-NEXT: [[STRUCT:%.*]] = llvm.mlir.undef : !llvm.struct<(f32, f32)>
     // CHECK-NEXT: [[STRUCT1:%.*]] = llvm.insertvalue [[ARG0_0]], [[STRUCT]][0]
     // CHECK-NEXT: [[STRUCT2:%.*]] = llvm.insertvalue [[ARG0_1]], [[STRUCT1]][1]
-    // CHECK-NEXT: [[T0:%.*]] = llvm.extractvalue [[STRUCT2]][0]
-    // CHECK-NEXT: [[T1:%.*]] = llvm.extractvalue [[STRUCT2]][1]
     %0 = tt.reshape %arg {allow_reorder = true} : tensor<256xf32, #blocked0> -> tensor<256x1xf32,#blocked2>
     // CHECK:      [[RES:%.*]] = llvm.mlir.undef : !llvm.struct<(f32, f32, f32, f32, f32, f32, f32, f32)>
-    // CHECK-NEXT: [[RES1:%.*]] = llvm.insertvalue [[T0]], [[RES]][0]
-    // CHECK-NEXT: [[RES2:%.*]] = llvm.insertvalue [[T1]], [[RES1]][1]
-    // CHECK-NEXT: [[RES3:%.*]] = llvm.insertvalue [[T0]], [[RES2]][2]
-    // CHECK-NEXT: [[RES4:%.*]] = llvm.insertvalue [[T1]], [[RES3]][3]
-    // CHECK-NEXT: [[RES5:%.*]] = llvm.insertvalue [[T0]], [[RES4]][4]
-    // CHECK-NEXT: [[RES6:%.*]] = llvm.insertvalue [[T1]], [[RES5]][5]
-    // CHECK-NEXT: [[RES7:%.*]] = llvm.insertvalue [[T0]], [[RES6]][6]
-    // CHECK-NEXT: [[RES8:%.*]] = llvm.insertvalue [[T1]], [[RES7]][7]
+    // CHECK-NEXT: [[RES1:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES]][0]
+    // CHECK-NEXT: [[RES2:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES1]][1]
+    // CHECK-NEXT: [[RES3:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES2]][2]
+    // CHECK-NEXT: [[RES4:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES3]][3]
+    // CHECK-NEXT: [[RES5:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES4]][4]
+    // CHECK-NEXT: [[RES6:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES5]][5]
+    // CHECK-NEXT: [[RES7:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES6]][6]
+    // CHECK-NEXT: [[RES8:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES7]][7]
     %1 = tt.broadcast %0 : (tensor<256x1xf32,#blocked2>) -> tensor<256x4xf32, #blocked2>
     tt.return
   }
@@ -275,6 +273,38 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: packed_addf_f16
+  tt.func @packed_addf_f16(%arg0 : tensor<256xf16,#blocked0>, %arg1 : tensor<256xf16,#blocked0>) {
+    // CHECK: llvm.fadd {{.*}} : vector<2xf16>
+    // CHECK-NOT: llvm.fadd {{.*}} : f16
+    %1 = arith.addf %arg0, %arg1 : tensor<256xf16,#blocked0>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK: llvm.mlir.global internal constant @constantTable_0({{.*}}) {{.*}}addr_space = 2 : i32
+  // CHECK-LABEL: dense_constant_tables
+  tt.func @dense_constant_tables() {
+    // CHECK: llvm.mlir.constant(dense<[1, 2, 3, 4]> : vector<4xi32>) : vector<4xi32>
+    // CHECK: llvm.extractelement
+    %small = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi32, #blocked0>
+    // CHECK: llvm.mlir.addressof @constantTable_0 : !llvm.ptr<2>
+    // CHECK: llvm.getelementptr
+    // CHECK: llvm.load {{.*}} : !llvm.ptr<2> -> i32
+    // CHECK: llvm.bitcast {{.*}} : i32 to f32
+    %lut = arith.constant dense<[-8.000000e+00, -7.000000e+00, -6.000000e+00, -5.000000e+00, -4.000000e+00, -3.000000e+00, -2.000000e+00, -1.000000e+00, 0.000000e+00, 1.000000e+00, 2.000000e+00, 3.000000e+00, 4.000000e+00, 5.000000e+00, 6.000000e+00, 7.000000e+00, 8.000000e+00, 9.000000e+00, 1.000000e+01, 1.100000e+01, 1.200000e+01, 1.300000e+01, 1.400000e+01, 1.500000e+01, 1.600000e+01, 1.700000e+01, 1.800000e+01, 1.900000e+01, 2.000000e+01, 2.100000e+01, 2.200000e+01, 2.300000e+01]> : tensor<32xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
   // CHECK-LABEL: basic_addi
@@ -477,7 +507,8 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
     // CHECK-SAME: vector<1xf32>, !llvm.ptr<3>
     // CHECK: llvm.store
     // CHECK-SAME: vector<1xf32>, !llvm.ptr<3>
-    // CHECK: genx.barrier
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.call spir_funccc @_Z22__spirv_ControlBarrieriii({{.*}}) : (i32, i32, i32) -> ()
     // CHECK: llvm.load
     // CHECK-SAME: !llvm.ptr<3> -> vector<4xf32>
     // CHECK: llvm.load
@@ -498,7 +529,8 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
     // CHECK-SAME: vector<4xf32>, !llvm.ptr<3>
     // CHECK: llvm.store
     // CHECK-SAME: vector<4xf32>, !llvm.ptr<3>
-    // CHECK: genx.barrier
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.call spir_funccc @_Z22__spirv_ControlBarrieriii({{.*}}) : (i32, i32, i32) -> ()
     // CHECK: llvm.load
     // CHECK-SAME: !llvm.ptr<3> -> vector<4xf32>
     // CHECK: llvm.load
@@ -537,6 +569,36 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [2, 2], threadsPerWarp = [2, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked2 = #triton_gpu.blocked<{sizePerThread = [4, 1], threadsPerWarp = [4, 8], warpsPerCTA = [1, 4], order = [0, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // COM: Every sub-group keeps its four rows: it only waits for itself.
+  // CHECK-LABEL: convert_layout_blocked_blocked_subgroup_local
+  tt.func @convert_layout_blocked_blocked_subgroup_local(%arg0: tensor<16x32xf32, #blocked0>) {
+    // CHECK: llvm.store
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.call spir_funccc @_Z22__spirv_ControlBarrieriii({{.*}}) : (i32, i32, i32) -> ()
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.load
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x32xf32, #blocked0>) -> tensor<16x32xf32, #blocked1>
+    tt.return
+  }
+
+  // COM: Rows move to the sub-groups owning columns: the work-group waits.
+  // CHECK-LABEL: convert_layout_blocked_blocked_cross_subgroup
+  tt.func @convert_layout_blocked_blocked_cross_subgroup(%arg0: tensor<16x32xf32, #blocked0>) {
+    // CHECK: llvm.store
+    // CHECK-NOT: __spirv_ControlBarrier
+    // CHECK: genx.barrier
+    // CHECK: llvm.load
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x32xf32, #blocked0>) -> tensor<16x32xf32, #blocked2>
+    tt.return
+  }
+}
+
+// -----
+
 #dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
 #dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
 #dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
@@ -572,6 +634,60 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 #dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
 #dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
 
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: dot_f16_f16_f16_f16
+  tt.func @dot_f16_f16_f16_f16(%a: tensor<8x32xf16, #dot_operand_a>, %b: tensor<32x16xf16, #dot_operand_b>, %c: tensor<8x16xf16, #dpas>) {
+    // COM: The accumulator is kept in f16.
+    // CHECK-COUNT-2: genx.matrix.dpas {{.*}}, {{.*}}, {{.*}} {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf16>, vector<8xf16>, vector<16xf16>) -> vector<8xf16>
+    // CHECK-NOT: llvm.fpext
+    %0 = tt.dot %a, %b, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<8x32xf16, #dot_operand_a> * tensor<32x16xf16, #dot_operand_b> -> tensor<8x16xf16, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: dot_f32_f16_f16_f32_imprecise_acc
+  tt.func @dot_f32_f16_f16_f32_imprecise_acc(%a: tensor<8x64xf16, #dot_operand_a>, %b: tensor<64x16xf16, #dot_operand_b>, %c: tensor<8x16xf32, #dpas>) {
+    // COM: Every 32 elements of K are accumulated in f16, then added in f32.
+    // CHECK-COUNT-2: genx.matrix.dpas {{.*}}, {{.*}}, {{.*}} {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf16>, vector<8xf16>, vector<16xf16>) -> vector<8xf16>
+    // CHECK: %[[EXT0:.*]] = llvm.fpext %{{.*}} : vector<8xf16> to vector<8xf32>
+    // CHECK: %[[ACC0:.*]] = llvm.fadd %{{.*}}, %[[EXT0]] : vector<8xf32>
+    // CHECK-COUNT-2: genx.matrix.dpas {{.*}}, {{.*}}, {{.*}} {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf16>, vector<8xf16>, vector<16xf16>) -> vector<8xf16>
+    // CHECK: %[[EXT1:.*]] = llvm.fpext %{{.*}} : vector<8xf16> to vector<8xf32>
+    // CHECK: llvm.fadd %[[ACC0]], %[[EXT1]] : vector<8xf32>
+    %0 = tt.dot %a, %b, %c {allowTF32 = true, maxNumImpreciseAcc = 32 : i32, transA = false, transB = false} : tensor<8x64xf16, #dot_operand_a> * tensor<64x16xf16, #dot_operand_b> -> tensor<8x16xf32, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=4, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: dot_f32_f16_f16_f32_rc4
+  tt.func @dot_f32_f16_f16_f32_rc4(%a: tensor<4x32xf16, #dot_operand_a>, %b: tensor<32x32xf16, #dot_operand_b>, %c: tensor<4x32xf32, #dpas>) {
+    // COM: The 2 independent accumulators along N are interleaved per K step.
+    // CHECK-COUNT-4: genx.matrix.dpas {{.*}}, {{.*}}, {{.*}} {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 4 : i32} : (vector<4xf32>, vector<4xf16>, vector<16xf16>) -> vector<4xf32>
+    %0 = tt.dot %a, %b, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<4x32xf16, #dot_operand_a> * tensor<32x32xf16, #dot_operand_b> -> tensor<4x32xf32, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
+
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: dot_i32_i8_i8_i32_1
   tt.func @dot_i32_i8_i8_i32_1(%a: tensor<8x32xi8, #dot_operand_a>, %b: tensor<32x16xi8, #dot_operand_b>, %c: tensor<8x16xi32, #dpas>) {
@@ -834,6 +950,42 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     // CHECK-NEXT:  ^bb4:
     // CHECK-NEXT:    genx.barrier
     %0 = "tt.atomic_rmw" (%arg0, %arg2, %arg1) {atomic_rmw_op = 5 : i32, sem = 1 : i32, scope = 1 : i32} : (!tt.ptr<f32>, f32, i1) -> f32
+    tt.store %arg0, %0 : f32
+    tt.return
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: atomic_add_f32_scalar_unused
+  tt.func @atomic_add_f32_scalar_unused(%arg0 : !tt.ptr<f32>, %arg1 : i1, %arg2 : f32) {
+    // CHECK:     llvm.atomicrmw fadd %arg0, {{.*}} acq_rel : !llvm.ptr<1>, f32
+    // CHECK-NOT: genx.barrier
+    // CHECK:     llvm.return
+    %0 = "tt.atomic_rmw" (%arg0, %arg2, %arg1) {atomic_rmw_op = 5 : i32, sem = 1 : i32, scope = 1 : i32} : (!tt.ptr<f32>, f32, i1) -> f32
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: atomic_native_float
+  tt.func @atomic_native_float(%arg0 : !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg1 : !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg2 : tensor<256xf16, #blocked0>, %arg3 : tensor<256xf32, #blocked0>) {
+    %true = arith.constant dense<true> : tensor<256xi1, #blocked0>
+    %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked0>
+    %1 = tt.splat %arg0 : (!tt.ptr<f16>) -> tensor<256x!tt.ptr<f16>, #blocked0>
+    %2 = tt.addptr %1, %0 : tensor<256x!tt.ptr<f16>, #blocked0>, tensor<256xi32, #blocked0>
+    %3 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<256x!tt.ptr<f32>, #blocked0>
+    %4 = tt.addptr %3, %0 : tensor<256x!tt.ptr<f32>, #blocked0>, tensor<256xi32, #blocked0>
+    // CHECK-COUNT-2: llvm.atomicrmw fadd {{.*}} acq_rel : !llvm.ptr<1>, f16
+    %5 = "tt.atomic_rmw" (%2, %arg2, %true) {atomic_rmw_op = 5 : i32, sem = 1 : i32, scope = 1 : i32} : (tensor<256x!tt.ptr<f16>, #blocked0>, tensor<256xf16, #blocked0>, tensor<256xi1, #blocked0>) -> tensor<256xf16, #blocked0>
+    // CHECK-COUNT-2: llvm.atomicrmw fmax {{.*}} acq_rel : !llvm.ptr<1>, f32
+    %6 = "tt.atomic_rmw" (%4, %arg3, %true) {atomic_rmw_op = 11 : i32, sem = 1 : i32, scope = 1 : i32} : (tensor<256x!tt.ptr<f32>, #blocked0>, tensor<256xf32, #blocked0>, tensor<256xi1, #blocked0>) -> tensor<256xf32, #blocked0>
+    // CHECK-COUNT-2: llvm.atomicrmw fmin {{.*}} acq_rel : !llvm.ptr<1>, f32
+    %7 = "tt.atomic_rmw" (%4, %arg3, %true) {atomic_rmw_op = 12 : i32, sem = 1 : i32, scope = 1 : i32} : (tensor<256x!tt.ptr<f32>, #blocked0>, tensor<256xf32, #blocked0>, tensor<256xi1, #blocked0>) -> tensor<256xf32, #blocked0>
     tt.return
   }
 }
@@ -985,3 +1137,531 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     tt.return
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: subgroup_reduce
+  tt.func @subgroup_reduce(%f : tensor<128xf32, #blocked>) {
+    // The whole sub-group reduces within warps, 4 lanes across warps.
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiif({{.*}}) : (i32, i32, f32) -> f32
+    // CHECK: genx.barrier
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiifj({{.*}}) : (i32, i32, f32, i32) -> f32
+    %g = "tt.reduce" (%f) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %add = arith.addf %arg0, %arg1 : f32
+      tt.reduce.return %add : f32
+    }) {axis = 0 : i32} : (tensor<128xf32, #blocked>) -> f32
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [8, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: block_ptr_load_store
+  tt.func @block_ptr_load_store(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64, %arg3: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>
+    // CHECK: llvm.cond_br
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v8i16
+    // CHECK: llvm.load {{.*}} -> f16
+    %1 = tt.load %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1> -> tensor<32x16xf16, #blocked>
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockWrite.v8i16
+    // CHECK: llvm.store {{.*}} : f16, !llvm.ptr<1>
+    tt.store %0, %1 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>, tensor<32x16xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [8, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: A row stride of 33 f16 is not a multiple of 16 bytes: the surface
+  // COM: check tests the pitch and width alignment, and the per-element
+  // COM: accesses take over when it fails.
+  // CHECK-LABEL: block_ptr_misaligned_pitch
+  tt.func @block_ptr_misaligned_pitch(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c33_i64 = arith.constant 33 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%c33_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>
+    // CHECK: %[[C15:.*]] = llvm.mlir.constant(15 : i64) : i64
+    // CHECK: %[[PITCH_REM:.*]] = llvm.and %{{.*}}, %[[C15]] : i64
+    // CHECK: llvm.icmp "eq" %[[PITCH_REM]], %{{.*}} : i64
+    // CHECK: %[[C3:.*]] = llvm.mlir.constant(3 : i64) : i64
+    // CHECK: %[[WIDTH_REM:.*]] = llvm.and %{{.*}}, %[[C3]] : i64
+    // CHECK: llvm.icmp "eq" %[[WIDTH_REM]], %{{.*}} : i64
+    // CHECK: llvm.cond_br
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v8i16
+    // CHECK: llvm.load {{.*}} -> f16
+    %1 = tt.load %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1> -> tensor<32x16xf16, #blocked>
+    // CHECK: llvm.and %{{.*}}, %{{.*}} : i64
+    // CHECK: llvm.cond_br
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockWrite.v8i16
+    // CHECK: llvm.store {{.*}} : f16, !llvm.ptr<1>
+    tt.store %0, %1 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>, tensor<32x16xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [1, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: block_ptr_load_dpas_operands
+  tt.func @block_ptr_load_dpas_operands(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: i64, %arg3: i64, %arg4: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32, #dpas>
+    %a_ptr = tt.make_tensor_ptr %arg0, [%arg2, %arg3], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<8x32xf16, #dot_operand_a>, 1>
+    %b_ptr = tt.make_tensor_ptr %arg1, [%arg3, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x16xf16, #dot_operand_b>, 1>
+    // COM: One 16x8 block read per K repetition of A.
+    // CHECK: llvm.cond_br
+    // CHECK-COUNT-2: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v8i16({{.*}}) : (i64, i32, i32, i32, i32, i32, i32, i32, i32, i32, i1, i1, i32) -> vector<8xi16>
+    %a = tt.load %a_ptr {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<8x32xf16, #dot_operand_a>, 1> -> tensor<8x32xf16, #dot_operand_a>
+    // COM: One VNNI-transformed 16x16 block read per K repetition of B.
+    // CHECK: llvm.cond_br
+    // CHECK-COUNT-2: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v8i32({{.*}}) : (i64, i32, i32, i32, i32, i32, i32, i32, i32, i32, i1, i1, i32) -> vector<8xi32>
+    %b = tt.load %b_ptr {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #dot_operand_b>, 1> -> tensor<32x16xf16, #dot_operand_b>
+    // CHECK-COUNT-2: genx.matrix.dpas
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<8x32xf16, #dot_operand_a> * tensor<32x16xf16, #dot_operand_b> -> tensor<8x16xf32, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [1, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: transposed_block_ptr_load_dpas_operand
+  tt.func @transposed_block_ptr_load_dpas_operand(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %b_ptr = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%c1_i64, %arg1], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>} : !tt.ptr<tensor<32x16xf16, #dot_operand_b>, 1>
+    // COM: One transposing 8x16 dword block read per K repetition of B, with
+    // COM: the per-element loads of a column-major pointer as the fallback.
+    // CHECK: llvm.cond_br
+    // CHECK-COUNT-2: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v8i32({{.*}}) : (i64, i32, i32, i32, i32, i32, i32, i32, i32, i32, i1, i1, i32) -> vector<8xi32>
+    // CHECK: llvm.load
+    %b = tt.load %b_ptr {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32, triton_gpu.transposed_block_load} : !tt.ptr<tensor<32x16xf16, #dot_operand_b>, 1> -> tensor<32x16xf16, #dot_operand_b>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: subgroup_block_load_store
+  tt.func @subgroup_block_load_store(%arg0: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32}, %arg2: i32 {tt.divisibility = 16 : i32}) {
+    %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %1 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<256x!tt.ptr<f32, 1>, #blocked>, tensor<256xi32, #blocked>
+    %3 = tt.splat %arg1 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    %4 = tt.addptr %3, %0 : tensor<256x!tt.ptr<f32, 1>, #blocked>, tensor<256xi32, #blocked>
+    // CHECK-COUNT-2: llvm.call spir_funccc @llvm.genx.GenISA.simdBlockRead.i64.p1
+    %5 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked>
+    // A masked chunk is only block read when all lanes are enabled.
+    // CHECK: genx.sub_group_shuffle
+    // CHECK: llvm.cond_br
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.simdBlockRead.i64.p1
+    // CHECK: llvm.load {{.*}} -> vector<2xf32>
+    %6 = tt.splat %arg2 : (i32) -> tensor<256xi32, #blocked>
+    %7 = arith.cmpi slt, %0, %6 : tensor<256xi32, #blocked>
+    %8 = tt.load %2, %7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.simdBlockWrite.p1.i64
+    tt.store %4, %5 {cache = 1 : i32, evict = 1 : i32} : tensor<256xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-DAG: llvm.mlir.global internal constant @cache_controls_6442_0_1("{6442:\220,0\22}{6442:\221,1\22}\00") {addr_space = 1 : i32}
+  // CHECK-DAG: llvm.mlir.global internal constant @cache_controls_6443_1_1("{6443:\220,1\22}{6443:\221,1\22}\00") {addr_space = 1 : i32}
+  // CHECK-LABEL: cache_controls
+  tt.func @cache_controls(%arg0: !tt.ptr<f32, 1>, %arg1: !tt.ptr<f32, 1>) {
+    %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32, #blocked>
+    %1 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<128x!tt.ptr<f32, 1>, #blocked>, tensor<128xi32, #blocked>
+    %3 = tt.splat %arg1 : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>, #blocked>
+    %4 = tt.addptr %3, %0 : tensor<128x!tt.ptr<f32, 1>, #blocked>, tensor<128xi32, #blocked>
+    // CHECK: llvm.mlir.addressof @cache_controls_6442_0_1
+    // CHECK: llvm.call @llvm.ptr.annotation.p1.p1
+    // CHECK: llvm.load
+    %5 = tt.load %2 {cache = 3 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32, #blocked>
+    // CHECK: llvm.mlir.addressof @cache_controls_6443_1_1
+    // CHECK: llvm.call @llvm.ptr.annotation.p1.p1
+    // CHECK: llvm.store
+    tt.store %4, %5 {cache = 6 : i32, evict = 1 : i32} : tensor<128xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: subgroup_scan
+  tt.func @subgroup_scan(%f : tensor<128xi32, #blocked>) {
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformIAddiii({{.*}}) : (i32, i32, i32) -> i32
+    // CHECK: genx.barrier
+    %g = "tt.scan" (%f) <{axis = 0 : i32}> ({
+    ^bb0(%arg0: i32, %arg1: i32):
+      %add = arith.addi %arg0, %arg1 : i32
+      tt.scan.return %add : i32
+    }) : (tensor<128xi32, #blocked>) -> tensor<128xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: histogram_ballot
+  tt.func @histogram_ballot(%arg0: tensor<128xi32, #blocked>) {
+    // CHECK-COUNT-6: llvm.call spir_funccc @_Z29__spirv_GroupNonUniformBallotib({{.*}}) : (i32, i1) -> vector<4xi32>
+    // CHECK: llvm.atomicrmw add {{.*}} monotonic : !llvm.ptr<3>, i32
+    %0 = tt.histogram %arg0 : tensor<128xi32, #blocked> -> tensor<64xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: histogram_shared_atomics
+  tt.func @histogram_shared_atomics(%arg0: tensor<128xi32, #blocked>) {
+    // CHECK-NOT: __spirv_GroupNonUniformBallot
+    // CHECK: llvm.and {{.*}}, {{.*}} : i32
+    // CHECK: llvm.atomicrmw add {{.*}} monotonic : !llvm.ptr<3>, i32
+    // CHECK: genx.barrier
+    %0 = tt.histogram %arg0 : tensor<128xi32, #blocked> -> tensor<1024xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: min_max_nan_propagation
+  tt.func @min_max_nan_propagation(%arg0: tensor<128xf32, #blocked>, %arg1: tensor<128xf32, #blocked>) {
+    // CHECK: [[ISNAN:%.*]] = llvm.fcmp "uno" {{.*}} : f32
+    // CHECK-NEXT: [[MAX:%.*]] = llvm.intr.maxnum({{.*}}) : (f32, f32) -> f32
+    // CHECK-NEXT: [[NAN:%.*]] = llvm.mlir.constant(0x7FC00000 : f32) : f32
+    // CHECK-NEXT: llvm.select [[ISNAN]], [[NAN]], [[MAX]] : i1, f32
+    %0 = arith.maximumf %arg0, %arg1 : tensor<128xf32, #blocked>
+    // CHECK: llvm.fcmp "uno" {{.*}} : f32
+    // CHECK-NEXT: llvm.intr.minnum
+    %1 = arith.minimumf %arg0, %arg1 : tensor<128xf32, #blocked>
+    // CHECK-NOT: llvm.fcmp
+    // CHECK: llvm.intr.maxnum
+    // CHECK-NOT: llvm.select
+    %2 = arith.maxnumf %arg0, %arg1 : tensor<128xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: fp_to_fp_packed
+  tt.func @fp_to_fp_packed(%arg0: tensor<256xf32, #blocked>, %arg1: tensor<256xf8E5M2, #blocked>) {
+    // CHECK: llvm.fptrunc {{.*}} : vector<4xf32> to vector<4xf16>
+    %0 = tt.fp_to_fp %arg0 {rounding = 1 : i32} : tensor<256xf32, #blocked> -> tensor<256xf16, #blocked>
+    // CHECK: llvm.bitcast {{.*}} : vector<4xi8> to i32
+    // CHECK: llvm.fpext {{.*}} : vector<4xf16> to vector<4xf32>
+    %1 = tt.fp_to_fp %arg1 : tensor<256xf8E5M2, #blocked> -> tensor<256xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: named_barriers
+  tt.func @named_barriers(%bar: i32, %num_threads: i32) {
+    // CHECK: [[SG:%.*]] = llvm.udiv %arg1, {{.*}} : i32
+    // CHECK-NEXT: llvm.call spir_funccc @llvm.genx.GenISA.threadgroupnamedbarriers.signal(%arg0, [[SG]])
+    // CHECK-NOT: threadgroupnamedbarriers.wait
+    triton_nvidia_gpu.bar_arrive %bar, %num_threads : i32, i32
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.threadgroupnamedbarriers.signal
+    // CHECK-NEXT: llvm.call spir_funccc @llvm.genx.GenISA.threadgroupnamedbarriers.wait(%arg0)
+    triton_nvidia_gpu.bar_wait %bar, %num_threads : i32, i32
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [8, 1], threadsPerWarp = [2, 8], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: convert_layout_dpas_blocked_shuffle
+  tt.func @convert_layout_dpas_blocked_shuffle(%arg0: tensor<8x16xf32, #dpas>) {
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.mlir.constant(dense<[0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7]> : vector<16xi32>) : vector<16xi32>
+    // CHECK: llvm.extractelement
+    // CHECK-COUNT-8: genx.sub_group_shuffle
+    // CHECK: llvm.mlir.constant(dense<[8, 9, 10, 11, 12, 13, 14, 15, 8, 9, 10, 11, 12, 13, 14, 15]> : vector<16xi32>) : vector<16xi32>
+    // CHECK: llvm.extractelement
+    // CHECK-COUNT-8: genx.sub_group_shuffle
+    // CHECK-NOT: genx.barrier
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<8x16xf32, #dpas>) -> tensor<8x16xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The result of a dot becomes the A operand of the next one in
+  // COM: registers: lanes 0-7 read the even rows, lanes 8-15 the odd ones.
+  // CHECK-LABEL: convert_layout_dpas_dot_operand_shuffle
+  tt.func @convert_layout_dpas_dot_operand_shuffle(%arg0: tensor<8x16xf16, #dpas>) {
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.mlir.constant(dense<[0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1]> : vector<16xi32>) : vector<16xi32>
+    // CHECK: llvm.mlir.constant(dense<[0, 2, 4, 6, 8, 10, 12, 14, 0, 2, 4, 6, 8, 10, 12, 14]> : vector<16xi32>) : vector<16xi32>
+    // CHECK-COUNT-2: genx.sub_group_shuffle
+    // CHECK: llvm.select
+    // CHECK: llvm.mlir.constant(dense<[1, 3, 5, 7, 9, 11, 13, 15, 1, 3, 5, 7, 9, 11, 13, 15]> : vector<16xi32>) : vector<16xi32>
+    // CHECK-COUNT-14: genx.sub_group_shuffle
+    // CHECK-COUNT-8: llvm.insertelement {{.*}} : vector<8xf16>
+    // CHECK-NOT: genx.barrier
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<8x16xf16, #dpas>) -> tensor<8x16xf16, #dot_operand_a>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: A uniform mask predicates every access with its first element.
+  // CHECK-LABEL: uniform_mask_load
+  tt.func @uniform_mask_load(%a_ptr_init : tensor<128x!tt.ptr<f32>, #blocked0>, %pred : i1) {
+    %mask = tt.splat %pred : (i1) -> tensor<128xi1, #blocked0>
+    // CHECK:     [[MASK0:%.*]] = llvm.extractvalue {{.*}}[0] : !llvm.struct<(i1, i1)>
+    // CHECK:     llvm.cond_br [[MASK0]]
+    // CHECK:     llvm.cond_br [[MASK0]]
+    %0 = tt.load %a_ptr_init, %mask {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK: llvm.func spir_funccc @_Z16__spirv_ocl_fmaxDv2_fS_(vector<2xf32>, vector<2xf32>) -> vector<2xf32>
+  // CHECK-LABEL: inline_asm
+  tt.func @inline_asm(%arg0: tensor<128xi8, #blocked>, %arg1: tensor<128xf32, #blocked>) {
+    // COM: The packed elements go in vectors of their own type, not in 32-bit registers.
+    // CHECK: llvm.inline_asm asm_dialect = att "shl (M1, 16) $0 $1 3", "=rw,rw" %{{.*}} : (vector<2xi8>) -> vector<2xi8>
+    %0 = tt.elementwise_inline_asm "shl (M1, 16) $0 $1 3" {constraints = "=rw,rw", packed_element = 2 : i32, pure = true} %arg0 : tensor<128xi8, #blocked> -> tensor<128xi8, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z16__spirv_ocl_fmaxDv2_fS_({{.*}}) : (vector<2xf32>, vector<2xf32>) -> vector<2xf32>
+    %1 = tt.elementwise_inline_asm "@_Z16__spirv_ocl_fmaxDv2_fS_" {constraints = "", packed_element = 2 : i32, pure = true} %arg1, %arg1 : tensor<128xf32, #blocked>, tensor<128xf32, #blocked> -> tensor<128xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [16], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The elements of a thread are compare-exchanged in registers and
+  // COM: the ones of the other lanes are shuffled in.
+  // CHECK-LABEL: sort_in_warp
+  tt.func @sort_in_warp(%arg0: tensor<32xf32, #blocked>) {
+    // CHECK-NOT: genx.sub_group_shuffle
+    // CHECK: llvm.fcmp "ogt" {{.*}} : f32
+    // CHECK: genx.sub_group_shuffle
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.return
+    %0 = tt.sort %arg0 {axis = 0 : i32, descending = false} : tensor<32xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 2], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Only the compare-exchanges between warps go through shared memory.
+  // CHECK-LABEL: sort_across_warps
+  tt.func @sort_across_warps(%arg0: tensor<2x128xi32, #blocked>) {
+    // CHECK-NOT: genx.barrier
+    // CHECK: genx.sub_group_shuffle
+    // CHECK: llvm.icmp "sgt" {{.*}} : i32
+    // CHECK: llvm.store {{.*}} : i32, !llvm.ptr<3>
+    // CHECK: genx.barrier
+    // CHECK: llvm.load {{.*}} : !llvm.ptr<3> -> i32
+    %0 = tt.sort %arg0 {axis = 1 : i32, descending = true} : tensor<2x128xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 2], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Each sub-group holds whole rows of the table, which are shuffled.
+  // CHECK-LABEL: gather_in_warp
+  tt.func @gather_in_warp(%arg0: tensor<8x16xf16, #blocked>, %arg1: tensor<8x64xi8, #blocked>) {
+    // CHECK-NOT: llvm.store
+    // CHECK: llvm.sext {{.*}} : i8 to i32
+    // CHECK: genx.sub_group_shuffle
+    // CHECK: llvm.select
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.return
+    %0 = tt.gather %arg0[%arg1] {axis = 1 : i32} : (tensor<8x16xf16, #blocked>, tensor<8x64xi8, #blocked>) -> tensor<8x64xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: A table spread over the sub-groups is read from shared memory.
+  // CHECK-LABEL: gather_shared_memory
+  tt.func @gather_shared_memory(%arg0: tensor<256xf32, #blocked>, %arg1: tensor<256xi32, #blocked1>) {
+    // CHECK-NOT: genx.sub_group_shuffle
+    // CHECK: llvm.store {{.*}} : f32, !llvm.ptr<3>
+    // CHECK: genx.barrier
+    // CHECK-COUNT-4: llvm.load {{.*}} : !llvm.ptr<3> -> f32
+    %0 = tt.gather %arg0[%arg1] {axis = 0 : i32} : (tensor<256xf32, #blocked>, tensor<256xi32, #blocked1>) -> tensor<256xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: prefetch_ptrs
+  tt.func @prefetch_ptrs(%arg0: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32}) {
+    %0 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    %1 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %2 = tt.addptr %0, %1 : tensor<256x!tt.ptr<f32, 1>, #blocked>, tensor<256xi32, #blocked>
+    // COM: Each work-item prefetches its 4 contiguous elements at once.
+    // CHECK: llvm.cond_br
+    // CHECK: llvm.call spir_funccc @_Z20__spirv_ocl_prefetchPU3AS1Kcm({{.*}}) : (!llvm.ptr<1>, i64) -> ()
+    // CHECK-NOT: @_Z20__spirv_ocl_prefetchPU3AS1Kcm
+    // CHECK: llvm.return
+    tt.prefetch %2 {cacheLevel = 2 : i32} : tensor<256x!tt.ptr<f32, 1>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: prefetch_block_ptr
+  tt.func @prefetch_block_ptr(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16>, 1>
+    // CHECK: llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockPrefetch.isVoid
+    tt.prefetch %0 {cacheLevel = 1 : i32} : !tt.ptr<tensor<32x64xf16>, 1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: warp_shuffle_ballot
+  tt.func @warp_shuffle_ballot(%arg0: tensor<16xf32, #blocked>, %arg1: tensor<16xi32, #blocked>) {
+    // CHECK: genx.sub_group_shuffle
+    // CHECK-NOT: llvm.select
+    %cst = arith.constant dense<1> : tensor<16xi32, #blocked>
+    %0 = tt.warp_shuffle %arg0, %cst {kind = 2 : i32} : tensor<16xf32, #blocked>, tensor<16xi32, #blocked>
+    // COM: Lanes are computed for runtime deltas.
+    // CHECK: llvm.sub
+    // CHECK: genx.sub_group_shuffle
+    // CHECK: llvm.select
+    %1 = tt.warp_shuffle %0, %arg1 {kind = 3 : i32} : tensor<16xf32, #blocked>, tensor<16xi32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z29__spirv_GroupNonUniformBallotib({{.*}}) : (i32, i1) -> vector<4xi32>
+    %2 = arith.cmpf ogt, %1, %arg0 : tensor<16xf32, #blocked>
+    %3 = tt.warp_ballot %2 : tensor<16xi1, #blocked> -> tensor<16xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: warp_reduce_scan
+  tt.func @warp_reduce_scan(%arg0: tensor<16xf32, #blocked>, %arg1: tensor<16xi32, #blocked>) {
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiif({{.*}}) : (i32, i32, f32) -> f32
+    %0 = "tt.warp_reduce"(%arg0) ({
+    ^bb0(%a: f32, %b: f32):
+      %add = arith.addf %a, %b : f32
+      tt.reduce.return %add : f32
+    }) : (tensor<16xf32, #blocked>) -> tensor<16xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformIAddiii({{.*}}) : (i32, i32, i32) -> i32
+    %1 = "tt.warp_scan"(%arg1) ({
+    ^bb0(%a: i32, %b: i32):
+      %add = arith.addi %a, %b : i32
+      tt.scan.return %add : i32
+    }) : (tensor<16xi32, #blocked>) -> tensor<16xi32, #blocked>
+    // COM: Combinations without a SPIR-V group operation go through shuffles.
+    // CHECK-COUNT-4: genx.sub_group_shuffle
+    %2 = "tt.warp_reduce"(%arg1) ({
+    ^bb0(%a: i32, %b: i32):
+      %sub = arith.subi %a, %b : i32
+      %abs = math.absi %sub : i32
+      tt.reduce.return %abs : i32
+    }) : (tensor<16xi32, #blocked>) -> tensor<16xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: llvm.func @pointer_arg_attrs
+  // CHECK-SAME: (%arg0: !llvm.ptr<1> {llvm.align = 16 : i64, llvm.noalias, tt.divisibility = 16 : i32, tt.restrict = 1 : i32},
+  // CHECK-SAME: %arg1: !llvm.ptr<1> {tt.divisibility = 1 : i32},
+  // CHECK-SAME: %arg2: i32 {tt.divisibility = 16 : i32})
+  tt.func @pointer_arg_attrs(%arg0: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32, tt.restrict = 1 : i32}, %arg1: !tt.ptr<f32, 1> {tt.divisibility = 1 : i32}, %arg2: i32 {tt.divisibility = 16 : i32}) {
+    tt.return
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK: llvm.func @global_scratch_alloc(%arg0: i32, %arg1: !llvm.ptr<1>)
+  tt.func public @global_scratch_alloc(%arg0: i32) {
+    // CHECK: [[OFFSET0:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK: llvm.getelementptr %arg1[[[OFFSET0]]] : (!llvm.ptr<1>, i32) -> !llvm.ptr<1>, i8
+    %0 = tt.global_scratch_alloc {alignment = 8 : i32, nbytes = 4 : i32} : !tt.ptr<i8, 1>
+    // CHECK: [[OFFSET1:%.*]] = llvm.mlir.constant(16 : i32) : i32
+    // CHECK: llvm.getelementptr %arg1[[[OFFSET1]]] : (!llvm.ptr<1>, i32) -> !llvm.ptr<1>, i8
+    %1 = tt.global_scratch_alloc {alignment = 16 : i32, nbytes = 32 : i32} : !tt.ptr<i8, 1>
+    tt.return
+  }
+}
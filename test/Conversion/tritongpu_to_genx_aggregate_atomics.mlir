@@ -0,0 +1,32 @@
+// RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm="target=genx aggregate-atomics=true" | FileCheck %s
+
+// COM: Each lane combines the values of the lanes updating the same address and
+// COM: only the first of them issues the atomic.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: histogram_add
+  tt.func @histogram_add(%ptrs : tensor<64x!tt.ptr<i32>, #blocked>, %vals : tensor<64xi32, #blocked>) {
+    // CHECK:     llvm.ptrtoint
+    // CHECK-COUNT-64: genx.sub_group_shuffle
+    // CHECK:     llvm.add
+    // CHECK:     llvm.atomicrmw add
+    %true = arith.constant dense<true> : tensor<64xi1, #blocked>
+    %0 = "tt.atomic_rmw" (%ptrs, %vals, %true) {atomic_rmw_op = 4 : i32, sem = 1 : i32, scope = 1 : i32} : (tensor<64x!tt.ptr<i32>, #blocked>, tensor<64xi32, #blocked>, tensor<64xi1, #blocked>) -> tensor<64xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Lanes reading the value they replaced update memory themselves.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: used_result
+  tt.func @used_result(%ptrs : tensor<64x!tt.ptr<f32>, #blocked>, %vals : tensor<64xf32, #blocked>) -> tensor<64xf32, #blocked> {
+    // CHECK-NOT: genx.sub_group_shuffle
+    // CHECK:     llvm.atomicrmw fadd
+    %true = arith.constant dense<true> : tensor<64xi1, #blocked>
+    %0 = "tt.atomic_rmw" (%ptrs, %vals, %true) {atomic_rmw_op = 5 : i32, sem = 1 : i32, scope = 1 : i32} : (tensor<64x!tt.ptr<f32>, #blocked>, tensor<64xf32, #blocked>, tensor<64xi1, #blocked>) -> tensor<64xf32, #blocked>
+    tt.return %0 : tensor<64xf32, #blocked>
+  }
+}
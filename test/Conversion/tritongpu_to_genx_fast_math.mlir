@@ -0,0 +1,40 @@
+// RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm="target=genx fast-math=true" | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-DAG: llvm.func spir_funccc @_Z22__spirv_ocl_native_expf(f32) -> f32
+  // CHECK-DAG: llvm.func spir_funccc @_Z23__spirv_ocl_native_exp2f(f32) -> f32
+  // CHECK-DAG: llvm.func spir_funccc @_Z23__spirv_ocl_native_log2f(f32) -> f32
+  // CHECK-DAG: llvm.func spir_funccc @_Z24__spirv_ocl_native_rsqrtf(f32) -> f32
+  // CHECK-DAG: llvm.func spir_funccc @_Z22__spirv_ocl_native_sinf(f32) -> f32
+  // CHECK-DAG: llvm.func spir_funccc @_Z22__spirv_ocl_native_cosf(f32) -> f32
+  // CHECK-LABEL: native_math_f32
+  tt.func @native_math_f32(%arg0: tensor<64xf32, #blocked>) {
+    // CHECK: llvm.call spir_funccc @_Z22__spirv_ocl_native_expf
+    %0 = math.exp %arg0 : tensor<64xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z23__spirv_ocl_native_exp2f
+    %1 = math.exp2 %arg0 : tensor<64xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z23__spirv_ocl_native_log2f
+    %2 = math.log2 %arg0 : tensor<64xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z24__spirv_ocl_native_rsqrtf
+    %3 = math.rsqrt %arg0 : tensor<64xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z22__spirv_ocl_native_sinf
+    %4 = math.sin %arg0 : tensor<64xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z22__spirv_ocl_native_cosf
+    %5 = math.cos %arg0 : tensor<64xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: native_math_f16_fallback
+  tt.func @native_math_f16_fallback(%arg0: tensor<64xf16, #blocked>) {
+    // CHECK-NOT: __spirv_ocl_native
+    %0 = math.exp2 %arg0 : tensor<64xf16, #blocked>
+    // CHECK: llvm.return
+    tt.return
+  }
+}
@@ -0,0 +1,32 @@
+// RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm="target=genx vector-tensors=true" | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: vector_elementwise
+  // CHECK-SAME: (%arg0: vector<4xf32>, %arg1: vector<4xf32>
+  tt.func @vector_elementwise(%arg0: tensor<256xf32, #blocked>, %arg1: tensor<256xf32, #blocked>) {
+    // CHECK: llvm.extractelement %arg0[{{.*}} : i32] : vector<4xf32>
+    // CHECK: llvm.extractelement %arg1[{{.*}} : i32] : vector<4xf32>
+    // CHECK: %[[SUM:.*]] = llvm.fadd
+    // CHECK: llvm.mlir.undef : vector<4xf32>
+    // CHECK: llvm.insertelement %[[SUM]], {{.*}} : vector<4xf32>
+    %0 = arith.addf %arg0, %arg1 : tensor<256xf32, #blocked>
+    // COM: The elements of the sum are read from where they were inserted.
+    // CHECK-NOT: llvm.extractelement
+    // CHECK: llvm.fmul %[[SUM]], %[[SUM]]
+    %1 = arith.mulf %0, %0 : tensor<256xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [32], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: SPIR-V has no vectors of 32 elements, nor of pointers.
+  // CHECK-LABEL: struct_tensors
+  // CHECK-SAME: (%arg0: !llvm.struct<(f32, {{.*}})>, %arg1: !llvm.struct<(ptr<1>, {{.*}})>
+  tt.func @struct_tensors(%arg0: tensor<2048xf32, #blocked>, %arg1: tensor<2048x!tt.ptr<f32>, #blocked>) {
+    tt.return
+  }
+}
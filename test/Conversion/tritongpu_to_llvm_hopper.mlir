@@ -333,3 +333,30 @@ module attributes {"triton_gpu.compute-capability" = 90 : i32, "triton_gpu.num-c
     tt.return
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 2], CTASplitNum = [1, 2], CTAOrder = [1, 0]}>
+// CHECK-LABEL: reduce_across_ctas
+module attributes {"triton_gpu.compute-capability" = 90 : i32, "triton_gpu.num-ctas" = 2 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @reduce_across_ctas(%arg0: tensor<4x256xf32, #blocked>) {
+    // COM: Each CTA publishes its partial sums before accumulating those of
+    // COM: both CTAs along the axis through distributed shared memory.
+    // CHECK: nvvm.shfl.sync
+    // CHECK: llvm.store
+    // CHECK: nvgpu.cluster_arrive
+    // CHECK-NEXT: nvgpu.cluster_wait
+    // CHECK: nvgpu.cluster_id
+    // CHECK: nvgpu.load_dsmem
+    // CHECK: nvgpu.load_dsmem
+    // CHECK: llvm.fadd
+    // CHECK: nvgpu.cluster_arrive
+    // CHECK-NEXT: nvgpu.cluster_wait
+    %0 = "tt.reduce"(%arg0) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %1 : f32
+    }) : (tensor<4x256xf32, #blocked>) -> tensor<4xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return
+  }
+}
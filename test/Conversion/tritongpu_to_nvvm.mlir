@@ -352,7 +352,6 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
   // CHECK-LABEL: basic_view_broadcast
   tt.func @basic_view_broadcast(%arg : tensor<256xf32,#blocked0>) {
-    // CHECK: llvm.mlir.undef
     // CHECK: %[[T0:.*]] = llvm.extractvalue
     // CHECK: %[[T1:.*]] = llvm.extractvalue
     %0 = tt.reshape %arg {allow_reorder = true} : tensor<256xf32, #blocked0> -> tensor<256x1xf32,#blocked2>
@@ -400,6 +399,32 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: packed_addf_f16
+  tt.func @packed_addf_f16(%arg0 : tensor<256xf16,#blocked0>, %arg1 : tensor<256xf16,#blocked0>) {
+    // CHECK: llvm.fadd {{.*}} : vector<2xf16>
+    // CHECK-NOT: llvm.fadd {{.*}} : f16
+    %1 = arith.addf %arg0, %arg1 : tensor<256xf16,#blocked0>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: packed_addf_bf16
+  tt.func @packed_addf_bf16(%arg0 : tensor<256xbf16,#blocked0>, %arg1 : tensor<256xbf16,#blocked0>) {
+    // CHECK: fma.rn.bf16x2
+    // CHECK-NOT: fma.rn.bf16 $0
+    %1 = arith.addf %arg0, %arg1 : tensor<256xbf16,#blocked0>
+    tt.return
+  }
+}
+
+// -----
+
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
   // CHECK-LABEL: basic_addi
@@ -1444,6 +1469,37 @@ module attributes {"triton_gpu.compute-capability" = 80 : i32, "triton_gpu.num-c
 
 // -----
 
+// COM: The butterfly steps of the two rows each thread holds are interleaved,
+// COM: and pairs of 16-bit rows share a shuffle.
+#blocked = #triton_gpu.blocked<{sizePerThread = [2, 1], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 80 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: reduce_rows_interleaved
+  tt.func public @reduce_rows_interleaved(%arg0: tensor<8x32xf32, #blocked>, %arg1: tensor<8x32xf16, #blocked>) {
+    // CHECK: nvvm.shfl.sync bfly
+    // CHECK-NOT: llvm.fadd
+    // CHECK: nvvm.shfl.sync bfly
+    // CHECK: llvm.fadd
+    // CHECK: llvm.fadd
+    %0 = "tt.reduce"(%arg0) <{axis = 1 : i32}> ({
+    ^bb0(%arg2: f32, %arg3: f32):
+      %2 = arith.addf %arg2, %arg3 : f32
+      tt.reduce.return %2 : f32
+    }) : (tensor<8x32xf32, #blocked>) -> tensor<8xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    // CHECK: llvm.bitcast {{.*}} : vector<2xi16> to i32
+    // CHECK: nvvm.shfl.sync bfly
+    // CHECK: llvm.fadd {{.*}} : f16
+    // CHECK: llvm.fadd {{.*}} : f16
+    %1 = "tt.reduce"(%arg1) <{axis = 1 : i32}> ({
+    ^bb0(%arg2: f16, %arg3: f16):
+      %2 = arith.addf %arg2, %arg3 : f16
+      tt.reduce.return %2 : f16
+    }) : (tensor<8x32xf16, #blocked>) -> tensor<8xf16, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return
+  }
+}
+
+// -----
+
 //  CHECK-LABEL: reduce_slice
 //  CHECK-NOT: st.shared
 //  CHECK-NOT: ld.shared
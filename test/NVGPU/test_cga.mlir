@@ -7,9 +7,10 @@ module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 2 :
     %pred = arith.constant 1 : i1
     %id0 = arith.constant 0 : i32
     %id1 = arith.constant 1 : i32
-    // CHECK: llvm.inline_asm
-    // CHECK: llvm.inline_asm
-    // CHECK: llvm.inline_asm
+    // CHECK: nvvm.cluster.arrive {aligned}
+    // CHECK-NEXT: nvvm.cluster.wait {aligned}
+    // CHECK-NEXT: nvvm.cluster.arrive{{$}}
+    // CHECK-NEXT: nvvm.cluster.wait{{$}}
     nvgpu.cga_barrier_sync
     nvgpu.cga_barrier_arrive
     nvgpu.cga_barrier_wait
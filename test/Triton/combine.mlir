@@ -272,3 +272,100 @@ tt.func @test_nested_transpose(%arg0: tensor<2x4x8xf32>) -> (tensor<8x2x4xf32>)
     // CHECK: tt.return %[[res]]
     tt.return %b : tensor<8x2x4xf32>
 }
+
+// -----
+
+// CHECK-LABEL: @test_combine_broadcast_mul_reduce
+tt.func @test_combine_broadcast_mul_reduce(%x: tensor<32x64xf32>, %y: tensor<64x16xf32>) -> tensor<32x16xf32> {
+    // CHECK: %[[zero:.*]] = arith.constant dense<0.000000e+00> : tensor<32x16xf32>
+    // CHECK: %[[res:.*]] = tt.dot %arg0, %arg1, %[[zero]] {allowTF32 = true, maxNumImpreciseAcc = 0 : i32}
+    // CHECK: tt.return %[[res]]
+    %x0 = tt.expand_dims %x {axis = 2 : i32} : (tensor<32x64xf32>) -> tensor<32x64x1xf32>
+    %x1 = tt.broadcast %x0 : (tensor<32x64x1xf32>) -> tensor<32x64x16xf32>
+    %y0 = tt.expand_dims %y {axis = 0 : i32} : (tensor<64x16xf32>) -> tensor<1x64x16xf32>
+    %y1 = tt.broadcast %y0 : (tensor<1x64x16xf32>) -> tensor<32x64x16xf32>
+    %mul = arith.mulf %y1, %x1 : tensor<32x64x16xf32>
+    %res = "tt.reduce" (%mul) ({
+    ^bb0(%arg2: f32, %arg3: f32):
+      %add = arith.addf %arg2, %arg3 : f32
+      tt.reduce.return %add : f32
+    }) {axis = 1 : i32} : (tensor<32x64x16xf32>) -> tensor<32x16xf32>
+    tt.return %res : tensor<32x16xf32>
+}
+
+// -----
+
+// COM: GEMV-like products stay exact.
+// CHECK-LABEL: @test_combine_broadcast_mul_reduce_skinny
+tt.func @test_combine_broadcast_mul_reduce_skinny(%x: tensor<4x8xf32>, %y: tensor<8x1xf32>) -> tensor<4x1xf32> {
+    // CHECK: %[[res:.*]] = tt.dot %arg0, %arg1, %{{.*}} {allowTF32 = false, maxNumImpreciseAcc = 0 : i32}
+    // CHECK: tt.return %[[res]]
+    %x0 = tt.expand_dims %x {axis = 2 : i32} : (tensor<4x8xf32>) -> tensor<4x8x1xf32>
+    %y0 = tt.expand_dims %y {axis = 0 : i32} : (tensor<8x1xf32>) -> tensor<1x8x1xf32>
+    %y1 = tt.broadcast %y0 : (tensor<1x8x1xf32>) -> tensor<4x8x1xf32>
+    %mul = arith.mulf %x0, %y1 : tensor<4x8x1xf32>
+    %res = "tt.reduce" (%mul) ({
+    ^bb0(%arg2: f32, %arg3: f32):
+      %add = arith.addf %arg2, %arg3 : f32
+      tt.reduce.return %add : f32
+    }) {axis = 1 : i32} : (tensor<4x8x1xf32>) -> tensor<4x1xf32>
+    tt.return %res : tensor<4x1xf32>
+}
+
+// -----
+
+// COM: Skinny products of 16-bit operands are left as they are.
+// CHECK-LABEL: @test_combine_broadcast_mul_reduce_skinny_f16
+tt.func @test_combine_broadcast_mul_reduce_skinny_f16(%x: tensor<4x32xf16>, %y: tensor<32x32xf16>) -> tensor<4x32xf16> {
+    // CHECK-NOT: tt.dot
+    // CHECK: tt.reduce
+    %x0 = tt.expand_dims %x {axis = 2 : i32} : (tensor<4x32xf16>) -> tensor<4x32x1xf16>
+    %x1 = tt.broadcast %x0 : (tensor<4x32x1xf16>) -> tensor<4x32x32xf16>
+    %y0 = tt.expand_dims %y {axis = 0 : i32} : (tensor<32x32xf16>) -> tensor<1x32x32xf16>
+    %y1 = tt.broadcast %y0 : (tensor<1x32x32xf16>) -> tensor<4x32x32xf16>
+    %mul = arith.mulf %x1, %y1 : tensor<4x32x32xf16>
+    %res = "tt.reduce" (%mul) ({
+    ^bb0(%arg2: f16, %arg3: f16):
+      %add = arith.addf %arg2, %arg3 : f16
+      tt.reduce.return %add : f16
+    }) {axis = 1 : i32} : (tensor<4x32x32xf16>) -> tensor<4x32xf16>
+    tt.return %res : tensor<4x32xf16>
+}
+
+// -----
+
+// CHECK-LABEL: @test_decompose_dot_scaled
+tt.func @test_decompose_dot_scaled(%a: tensor<64x128xf8E5M2>, %b: tensor<128x32xf8E5M2>, %sa: tensor<64xf32>, %sb: tensor<32xf32>, %c: tensor<64x32xf32>) -> tensor<64x32xf32> {
+    // CHECK-DAG: %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : tensor<64x32xf32>
+    // CHECK: %[[DOT:.*]] = tt.dot %{{.*}}, %{{.*}}, %[[ZERO]] {allowTF32 = true, maxNumImpreciseAcc = 0 : i32}
+    // CHECK: %[[SA:.*]] = tt.expand_dims %{{.*}} {axis = 1 : i32}
+    // CHECK: %[[SA1:.*]] = tt.broadcast %[[SA]]
+    // CHECK: %[[SB:.*]] = tt.expand_dims %{{.*}} {axis = 0 : i32}
+    // CHECK: %[[SB1:.*]] = tt.broadcast %[[SB]]
+    // CHECK: %[[SCALE:.*]] = arith.mulf %[[SA1]], %[[SB1]]
+    // CHECK: %[[SCALED:.*]] = arith.mulf %[[DOT]], %[[SCALE]]
+    // CHECK: %[[RES:.*]] = arith.addf %[[SCALED]], %{{.*}}
+    // CHECK: tt.return %[[RES]]
+    %d = tt.dot_scaled %a scale %sa, %b scale %sb, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x128xf8E5M2>, tensor<64xf32> * tensor<128x32xf8E5M2>, tensor<32xf32> -> tensor<64x32xf32>
+    tt.return %d : tensor<64x32xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @test_decompose_batched_dot
+tt.func @test_decompose_batched_dot(%a: tensor<4x16x8xf16>, %b: tensor<4x8x32xf16>, %c: tensor<4x16x32xf32>) -> tensor<4x16x32xf32> {
+    // CHECK: %[[A:.*]] = tt.fp_to_fp %{{.*}} : tensor<4x16x8xf16> -> tensor<4x16x8xf32>
+    // CHECK: %[[A1:.*]] = tt.expand_dims %[[A]] {axis = 3 : i32}
+    // CHECK: %[[A2:.*]] = tt.broadcast %[[A1]] : tensor<4x16x8x1xf32> -> tensor<4x16x8x32xf32>
+    // CHECK: %[[B:.*]] = tt.fp_to_fp %{{.*}} : tensor<4x8x32xf16> -> tensor<4x8x32xf32>
+    // CHECK: %[[B1:.*]] = tt.expand_dims %[[B]] {axis = 1 : i32}
+    // CHECK: %[[B2:.*]] = tt.broadcast %[[B1]] : tensor<4x1x8x32xf32> -> tensor<4x16x8x32xf32>
+    // CHECK: %[[PROD:.*]] = arith.mulf %[[A2]], %[[B2]]
+    // CHECK: %[[SUM:.*]] = "tt.reduce"(%[[PROD]])
+    // CHECK: arith.addf
+    // CHECK: {axis = 2 : i32} : (tensor<4x16x8x32xf32>) -> tensor<4x16x32xf32>
+    // CHECK: %[[RES:.*]] = arith.addf %[[SUM]], %{{.*}}
+    // CHECK: tt.return %[[RES]]
+    %d = tt.dot %a, %b, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<4x16x8xf16> * tensor<4x8x32xf16> -> tensor<4x16x32xf32>
+    tt.return %d : tensor<4x16x32xf32>
+}
@@ -0,0 +1,59 @@
+// RUN: triton-opt %s -split-input-file -triton-fuse-kernels | FileCheck %s
+
+// COM: Each kernel runs the range of programs after the ones of the kernels
+// COM: before it, with its program ids rebuilt from its offset in the range.
+// CHECK-LABEL: tt.func @fused(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg2: i32)
+// CHECK: %[[PID:.*]] = tt.get_program_id x : i32
+// CHECK: %[[END:.*]] = arith.constant 8 : i32
+// CHECK: %[[FIRST:.*]] = arith.cmpi slt, %[[PID]], %[[END]] : i32
+// CHECK: scf.if %[[FIRST]] {
+// CHECK:   tt.addptr %arg0
+// CHECK: } else {
+// CHECK:   %[[START:.*]] = arith.constant 8 : i32
+// CHECK:   %[[LOCAL:.*]] = arith.subi %[[PID]], %[[START]] : i32
+// CHECK:   %[[GX:.*]] = arith.constant 2 : i32
+// CHECK:   %[[X:.*]] = arith.remsi %[[LOCAL]], %[[GX]] : i32
+// CHECK:   arith.divsi %[[LOCAL]], %[[GX]] : i32
+// CHECK:   %[[GY:.*]] = arith.constant 3 : i32
+// CHECK:   %[[Y:.*]] = arith.remsi %{{.*}}, %[[GY]] : i32
+// CHECK:   %[[NX:.*]] = arith.constant 2 : i32
+// CHECK:   arith.muli %[[Y]], %[[NX]]
+// CHECK:   arith.addi %{{.*}}, %[[X]]
+// CHECK:   tt.store %arg1
+// CHECK: }
+// CHECK: tt.return
+// CHECK-NOT: tt.func
+module {
+  tt.func public @scale(%ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}) attributes {tt.fusion_grid = array<i32: 8, 1, 1>} {
+    %pid = tt.get_program_id x : i32
+    %p = tt.addptr %ptr, %pid : !tt.ptr<f32>, i32
+    %v = tt.load %p {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : f32
+    %w = arith.addf %v, %v : f32
+    tt.store %p, %w {cache = 1 : i32, evict = 1 : i32} : f32
+    tt.return
+  }
+  tt.func public @fill(%ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %value: i32) attributes {tt.fusion_grid = array<i32: 2, 3, 1>} {
+    %x = tt.get_program_id x : i32
+    %y = tt.get_program_id y : i32
+    %nx = tt.get_num_programs {axis = 0 : i32} : i32
+    %row = arith.muli %y, %nx : i32
+    %idx = arith.addi %row, %x : i32
+    %p = tt.addptr %ptr, %idx : !tt.ptr<f32>, i32
+    %v = arith.sitofp %value : i32 to f32
+    tt.store %p, %v {cache = 1 : i32, evict = 1 : i32} : f32
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Functions without a fusion grid are left alone.
+// CHECK-LABEL: tt.func @not_fused
+// CHECK: tt.get_program_id x
+module {
+  tt.func public @not_fused(%ptr: !tt.ptr<i32>) {
+    %pid = tt.get_program_id x : i32
+    tt.store %ptr, %pid {cache = 1 : i32, evict = 1 : i32} : i32
+    tt.return
+  }
+}
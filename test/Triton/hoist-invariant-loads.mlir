@@ -0,0 +1,100 @@
+// RUN: triton-opt %s -split-input-file -triton-hoist-invariant-loads | FileCheck %s
+
+// COM: The bias is loaded once, masked by whether the loop runs, as the only
+// COM: store goes to another restrict argument.
+// CHECK-LABEL: tt.func @hoist_bias
+// CHECK: %[[OFFS:.*]] = tt.make_range
+// CHECK: %[[SPLAT:.*]] = tt.splat %arg0
+// CHECK: %[[PTRS:.*]] = tt.addptr %[[SPLAT]], %[[OFFS]]
+// CHECK: %[[RUNS:.*]] = arith.cmpi slt, %{{.*}}, %arg2 : i32
+// CHECK: %[[MASK:.*]] = tt.splat %[[RUNS]] : (i1) -> tensor<128xi1>
+// CHECK: %[[BIAS:.*]] = tt.load %[[PTRS]], %[[MASK]]
+// CHECK: scf.for
+// CHECK-NOT: tt.load
+// CHECK:   arith.addf %{{.*}}, %[[BIAS]]
+// CHECK:   tt.store
+module {
+  tt.func @hoist_bias(%bias: !tt.ptr<f32> {tt.restrict = 1 : i32}, %out: !tt.ptr<f32> {tt.restrict = 1 : i32}, %n: i32) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %c128 = arith.constant 128 : i32
+    scf.for %i = %c0 to %n step %c1 : i32 {
+      %offs = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+      %bias_splat = tt.splat %bias : (!tt.ptr<f32>) -> tensor<128x!tt.ptr<f32>>
+      %bias_ptrs = tt.addptr %bias_splat, %offs : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+      %b = tt.load %bias_ptrs {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32>
+      %i_f = arith.sitofp %i : i32 to f32
+      %i_splat = tt.splat %i_f : (f32) -> tensor<128xf32>
+      %v = arith.addf %i_splat, %b : tensor<128xf32>
+      %row = arith.muli %i, %c128 : i32
+      %out_ptr = tt.addptr %out, %row : !tt.ptr<f32>, i32
+      %out_splat = tt.splat %out_ptr : (!tt.ptr<f32>) -> tensor<128x!tt.ptr<f32>>
+      %out_ptrs = tt.addptr %out_splat, %offs : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+      tt.store %out_ptrs, %v {cache = 1 : i32, evict = 1 : i32} : tensor<128xf32>
+    }
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Loops known to run do not mask the hoisted load.
+// CHECK-LABEL: tt.func @hoist_scale
+// CHECK: %[[SCALE:.*]] = tt.load %arg0 {{.*}} : f32
+// CHECK: scf.for
+// CHECK-NOT: tt.load
+module {
+  tt.func @hoist_scale(%scale: !tt.ptr<f32> {tt.restrict = 1 : i32}, %out: !tt.ptr<f32>) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %c8 = arith.constant 8 : i32
+    scf.for %i = %c0 to %c8 step %c1 : i32 {
+      %s = tt.load %scale {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : f32
+      %ptr = tt.addptr %out, %i : !tt.ptr<f32>, i32
+      tt.store %ptr, %s {cache = 1 : i32, evict = 1 : i32} : f32
+    }
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Arguments that are not restrict may be the memory the loop stores to.
+// CHECK-LABEL: tt.func @may_alias
+// CHECK: scf.for
+// CHECK:   tt.load
+// CHECK:   tt.store
+module {
+  tt.func @may_alias(%scale: !tt.ptr<f32>, %out: !tt.ptr<f32>) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %c8 = arith.constant 8 : i32
+    scf.for %i = %c0 to %c8 step %c1 : i32 {
+      %s = tt.load %scale {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : f32
+      %ptr = tt.addptr %out, %i : !tt.ptr<f32>, i32
+      tt.store %ptr, %s {cache = 1 : i32, evict = 1 : i32} : f32
+    }
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Atomics are left in place with the loads around them.
+// CHECK-LABEL: tt.func @atomic_in_loop
+// CHECK: scf.for
+// CHECK:   tt.load
+// CHECK:   "tt.atomic_rmw"
+module {
+  tt.func @atomic_in_loop(%scale: !tt.ptr<f32> {tt.restrict = 1 : i32}, %out: !tt.ptr<f32> {tt.restrict = 1 : i32}) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %c8 = arith.constant 8 : i32
+    %true = arith.constant true
+    scf.for %i = %c0 to %c8 step %c1 : i32 {
+      %s = tt.load %scale {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : f32
+      %old = "tt.atomic_rmw" (%out, %s, %true) {atomic_rmw_op = 5 : i32, sem = 1 : i32, scope = 1 : i32} : (!tt.ptr<f32>, f32, i1) -> f32
+    }
+    tt.return
+  }
+}
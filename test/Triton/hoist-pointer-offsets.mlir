@@ -0,0 +1,108 @@
+// RUN: triton-opt %s -split-input-file -triton-hoist-pointer-offsets | FileCheck %s
+
+// COM: The loop carries the scalar base and adds the step once per iteration.
+// CHECK-LABEL: tt.func @k_loop
+// CHECK-SAME: (%[[BASE:.*]]: !tt.ptr<f16, 1>, %[[STEP:.*]]: i32
+// CHECK: %[[OFFS:.*]] = tt.make_range
+// CHECK: scf.for {{.*}} iter_args(%[[PTR:[a-z0-9_]+]] = %[[BASE]], %{{.*}} = %{{.*}}) -> (!tt.ptr<f16, 1>, tensor<128xf32>)
+// CHECK:   %[[SPLAT:.*]] = tt.splat %[[PTR]] : (!tt.ptr<f16, 1>) -> tensor<128x!tt.ptr<f16, 1>>
+// CHECK:   %[[PTRS:.*]] = tt.addptr %[[SPLAT]], %[[OFFS]] : tensor<128x!tt.ptr<f16, 1>>, tensor<128xi32>
+// CHECK:   tt.load %[[PTRS]]
+// CHECK:   %[[NEXT:.*]] = tt.addptr %[[PTR]], %[[STEP]] : !tt.ptr<f16, 1>, i32
+// CHECK:   scf.yield %[[NEXT]], %{{.*}} : !tt.ptr<f16, 1>, tensor<128xf32>
+module {
+  tt.func @k_loop(%base: !tt.ptr<f16>, %step: i32, %n: i32) -> tensor<128xf32> {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<128xf32>
+    %offs = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+    %splat = tt.splat %base : (!tt.ptr<f16>) -> tensor<128x!tt.ptr<f16>>
+    %ptrs = tt.addptr %splat, %offs : tensor<128x!tt.ptr<f16>>, tensor<128xi32>
+    %steps = tt.splat %step : (i32) -> tensor<128xi32>
+    %res:2 = scf.for %i = %c0 to %n step %c1 iter_args(%p = %ptrs, %acc = %cst) -> (tensor<128x!tt.ptr<f16>>, tensor<128xf32>) : i32 {
+      %x = tt.load %p {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf16>
+      %xf = arith.extf %x : tensor<128xf16> to tensor<128xf32>
+      %sum = arith.addf %acc, %xf : tensor<128xf32>
+      %next = tt.addptr %p, %steps : tensor<128x!tt.ptr<f16>>, tensor<128xi32>
+      scf.yield %next, %sum : tensor<128x!tt.ptr<f16>>, tensor<128xf32>
+    }
+    tt.return %res#1 : tensor<128xf32>
+  }
+}
+
+// -----
+
+// COM: Chains of constant steps are followed, and the pointers after the loop
+// COM: are recomputed from its scalar result.
+// CHECK-LABEL: tt.func @constant_steps
+// CHECK: %[[C32:.*]] = arith.constant 32 : i32
+// CHECK: %[[RES:.*]] = scf.for {{.*}} -> (!tt.ptr<f32, 1>)
+// CHECK:   %[[P1:.*]] = tt.addptr %{{.*}}, %[[C32]] : !tt.ptr<f32, 1>, i32
+// CHECK:   %[[P2:.*]] = tt.addptr %[[P1]], %[[C32]] : !tt.ptr<f32, 1>, i32
+// CHECK:   scf.yield %[[P2]] : !tt.ptr<f32, 1>
+// CHECK: %[[SPLAT:.*]] = tt.splat %[[RES]] : (!tt.ptr<f32, 1>) -> tensor<64x!tt.ptr<f32, 1>>
+// CHECK: %[[PTRS:.*]] = tt.addptr %[[SPLAT]], %{{.*}} : tensor<64x!tt.ptr<f32, 1>>, tensor<64xi32>
+// CHECK: tt.store %[[PTRS]]
+module {
+  tt.func @constant_steps(%base: !tt.ptr<f32>, %n: i32, %v: tensor<64xf32>) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %c32 = arith.constant dense<32> : tensor<64xi32>
+    %offs = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %splat = tt.splat %base : (!tt.ptr<f32>) -> tensor<64x!tt.ptr<f32>>
+    %ptrs = tt.addptr %splat, %offs : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+    %res = scf.for %i = %c0 to %n step %c1 iter_args(%p = %ptrs) -> (tensor<64x!tt.ptr<f32>>) : i32 {
+      tt.store %p, %v {cache = 1 : i32, evict = 1 : i32} : tensor<64xf32>
+      %p1 = tt.addptr %p, %c32 : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+      tt.store %p1, %v {cache = 1 : i32, evict = 1 : i32} : tensor<64xf32>
+      %p2 = tt.addptr %p1, %c32 : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+      scf.yield %p2 : tensor<64x!tt.ptr<f32>>
+    }
+    tt.store %res, %v {cache = 1 : i32, evict = 1 : i32} : tensor<64xf32>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Pointers moved by non-uniform offsets are left as they are.
+// CHECK-LABEL: tt.func @non_uniform_step
+// CHECK: scf.for {{.*}} -> (tensor<64x!tt.ptr<f32, 1>>)
+module {
+  tt.func @non_uniform_step(%base: !tt.ptr<f32>, %n: i32, %v: tensor<64xf32>) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %offs = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %splat = tt.splat %base : (!tt.ptr<f32>) -> tensor<64x!tt.ptr<f32>>
+    %ptrs = tt.addptr %splat, %offs : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+    %res = scf.for %i = %c0 to %n step %c1 iter_args(%p = %ptrs) -> (tensor<64x!tt.ptr<f32>>) : i32 {
+      tt.store %p, %v {cache = 1 : i32, evict = 1 : i32} : tensor<64xf32>
+      %next = tt.addptr %p, %offs : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+      scf.yield %next : tensor<64x!tt.ptr<f32>>
+    }
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Non-splat constant steps are not uniform either.
+// CHECK-LABEL: tt.func @non_splat_constant_step
+// CHECK: scf.for {{.*}} -> (tensor<4x!tt.ptr<f32, 1>>)
+// CHECK:   tt.addptr %{{.*}}, %{{.*}} : tensor<4x!tt.ptr<f32, 1>>, tensor<4xi32>
+module {
+  tt.func @non_splat_constant_step(%base: !tt.ptr<f32>, %n: i32, %v: tensor<4xf32>) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %steps = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi32>
+    %offs = tt.make_range {end = 4 : i32, start = 0 : i32} : tensor<4xi32>
+    %splat = tt.splat %base : (!tt.ptr<f32>) -> tensor<4x!tt.ptr<f32>>
+    %ptrs = tt.addptr %splat, %offs : tensor<4x!tt.ptr<f32>>, tensor<4xi32>
+    %res = scf.for %i = %c0 to %n step %c1 iter_args(%p = %ptrs) -> (tensor<4x!tt.ptr<f32>>) : i32 {
+      tt.store %p, %v {cache = 1 : i32, evict = 1 : i32} : tensor<4xf32>
+      %next = tt.addptr %p, %steps : tensor<4x!tt.ptr<f32>>, tensor<4xi32>
+      scf.yield %next : tensor<4x!tt.ptr<f32>>
+    }
+    tt.return
+  }
+}
@@ -0,0 +1,84 @@
+// RUN: triton-opt %s -split-input-file -triton-int-range-optimize | FileCheck %s
+
+// COM: A mask the block always satisfies is folded, one depending on an
+// COM: argument is kept.
+// CHECK-LABEL: tt.func @mask_in_block
+// CHECK: %[[TRUE:.*]] = arith.constant dense<true> : tensor<128xi1>
+// CHECK: tt.load %{{.*}}, %[[TRUE]]
+// CHECK: %[[MASK:.*]] = arith.cmpi slt
+// CHECK: tt.load %{{.*}}, %[[MASK]]
+tt.func @mask_in_block(%ptr: !tt.ptr<f32, 1>, %n: i32) -> (tensor<128xf32>, tensor<128xf32>) {
+  %c128 = arith.constant dense<128> : tensor<128xi32>
+  %range = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %ptrs0 = tt.splat %ptr : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>>
+  %ptrs = tt.addptr %ptrs0, %range : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi32>
+  %in_block = arith.cmpi slt, %range, %c128 : tensor<128xi32>
+  %a = tt.load %ptrs, %in_block {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32>
+  %n_splat = tt.splat %n : (i32) -> tensor<128xi32>
+  %in_bounds = arith.cmpi slt, %range, %n_splat : tensor<128xi32>
+  %b = tt.load %ptrs, %in_bounds {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32>
+  tt.return %a, %b : tensor<128xf32>, tensor<128xf32>
+}
+
+// -----
+
+// COM: The lower bound check of a rewritten tensor pointer advanced by a loop
+// COM: with a positive step is folded. The offsets may not fit in i32.
+// CHECK-LABEL: tt.func @k_loop_bounds
+// CHECK: scf.for
+// CHECK: %[[TRUE:.*]] = arith.constant dense<true> : tensor<64xi1>
+// CHECK: %[[UPPER:.*]] = arith.cmpi slt
+// CHECK: arith.andi %[[TRUE]], %[[UPPER]]
+// CHECK: tt.addptr %{{.*}}, %{{.*}} : tensor<64x!tt.ptr<f32, 1>>, tensor<64xi64>
+tt.func @k_loop_bounds(%ptr: !tt.ptr<f32, 1>, %shape: i64, %K: i32) -> tensor<64xf32> {
+  %c0 = arith.constant 0 : i32
+  %c64 = arith.constant 64 : i32
+  %zero = arith.constant dense<0> : tensor<64xi64>
+  %cst = arith.constant dense<0.000000e+00> : tensor<64xf32>
+  %range = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+  %range64 = arith.extsi %range : tensor<64xi32> to tensor<64xi64>
+  %shape_splat = tt.splat %shape : (i64) -> tensor<64xi64>
+  %ptrs0 = tt.splat %ptr : (!tt.ptr<f32, 1>) -> tensor<64x!tt.ptr<f32, 1>>
+  %res = scf.for %k = %c0 to %K step %c64 iter_args(%acc = %cst) -> (tensor<64xf32>) : i32 {
+    %k64 = arith.extsi %k : i32 to i64
+    %k_splat = tt.splat %k64 : (i64) -> tensor<64xi64>
+    %offs = arith.addi %k_splat, %range64 : tensor<64xi64>
+    %lower = arith.cmpi sge, %offs, %zero : tensor<64xi64>
+    %upper = arith.cmpi slt, %offs, %shape_splat : tensor<64xi64>
+    %mask = arith.andi %lower, %upper : tensor<64xi1>
+    %ptrs = tt.addptr %ptrs0, %offs : tensor<64x!tt.ptr<f32, 1>>, tensor<64xi64>
+    %x = tt.load %ptrs, %mask {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64xf32>
+    %sum = arith.addf %acc, %x : tensor<64xf32>
+    scf.yield %sum : tensor<64xf32>
+  }
+  tt.return %res : tensor<64xf32>
+}
+
+// -----
+
+// COM: 64-bit offsets bounded by the program id are computed in i32.
+// CHECK-LABEL: tt.func @narrow_offsets
+// CHECK: %[[C256:.*]] = arith.constant dense<256> : tensor<128xi32>
+// CHECK: %[[BLOCK:.*]] = arith.remsi
+// CHECK: %[[SPLAT:.*]] = tt.splat %[[BLOCK]] : (i32) -> tensor<128xi32>
+// CHECK: %[[START:.*]] = arith.muli %[[SPLAT]], %[[C256]] : tensor<128xi32>
+// CHECK: %[[RANGE:.*]] = tt.make_range
+// CHECK: %[[OFFS:.*]] = arith.addi %[[START]], %[[RANGE]] : tensor<128xi32>
+// CHECK-NOT: i64
+// CHECK: tt.addptr %{{.*}}, %[[OFFS]] : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi32>
+tt.func @narrow_offsets(%ptr: !tt.ptr<f32, 1>) -> tensor<128xf32> {
+  %c256 = arith.constant dense<256> : tensor<128xi64>
+  %c8 = arith.constant 8 : i32
+  %pid = tt.get_program_id x : i32
+  %block = arith.remsi %pid, %c8 : i32
+  %block64 = arith.extsi %block : i32 to i64
+  %block_splat = tt.splat %block64 : (i64) -> tensor<128xi64>
+  %start = arith.muli %block_splat, %c256 : tensor<128xi64>
+  %range = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %range64 = arith.extsi %range : tensor<128xi32> to tensor<128xi64>
+  %offs = arith.addi %start, %range64 : tensor<128xi64>
+  %ptrs0 = tt.splat %ptr : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>>
+  %ptrs = tt.addptr %ptrs0, %offs : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi64>
+  %x = tt.load %ptrs {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32>
+  tt.return %x : tensor<128xf32>
+}
@@ -228,3 +228,11 @@ tt.func public @fn(%arg0: tensor<16x32xf32>) {
     tt.return
 }
 }  // end module
+
+// -----
+
+tt.func public @fn(%a: tensor<64x128xf8E5M2>, %b: tensor<128x32xf8E5M2>, %sa: tensor<32xf32>, %sb: tensor<32xf32>, %c: tensor<64x32xf32>) {
+    // expected-error @+1 {{scales must have one element per row of A and per column of B}}
+    %d = tt.dot_scaled %a scale %sa, %b scale %sb, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x128xf8E5M2>, tensor<32xf32> * tensor<128x32xf8E5M2>, tensor<32xf32> -> tensor<64x32xf32>
+    tt.return
+}
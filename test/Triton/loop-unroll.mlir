@@ -0,0 +1,66 @@
+// RUN: triton-opt %s -split-input-file -triton-loop-unroll=unroll-factor=2 | FileCheck %s
+
+// COM: A tt.unroll attribute overrides the default factor.
+// CHECK-LABEL: tt.func @unroll_attr
+// CHECK: %[[STEP:.*]] = arith.constant 128 : i32
+// CHECK: scf.for %{{.*}} = %{{.*}} to %{{.*}} step %[[STEP]]
+// CHECK-COUNT-4: tt.dot
+// CHECK-NOT: tt.dot
+// CHECK: scf.yield
+// CHECK-NOT: tt.unroll
+module {
+  tt.func @unroll_attr(%a: tensor<32x32xf16>, %b: tensor<32x32xf16>) -> tensor<32x32xf32> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c256_i32 = arith.constant 256 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32>
+    %res = scf.for %k = %c0_i32 to %c256_i32 step %c32_i32 iter_args(%acc = %cst) -> (tensor<32x32xf32>) : i32 {
+      %d = tt.dot %a, %b, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<32x32xf16> * tensor<32x32xf16> -> tensor<32x32xf32>
+      scf.yield %d : tensor<32x32xf32>
+    } {tt.unroll = 4 : i32}
+    tt.return %res : tensor<32x32xf32>
+  }
+}
+
+// -----
+
+// COM: Reduction loops take the default factor, with an epilogue loop for
+// COM: dynamic trip counts.
+// CHECK-LABEL: tt.func @unroll_default
+// CHECK: scf.for
+// CHECK-COUNT-2: tt.dot
+// CHECK: scf.yield
+// CHECK: scf.for
+// CHECK: tt.dot
+// CHECK: scf.yield
+module {
+  tt.func @unroll_default(%a: tensor<32x32xf16>, %b: tensor<32x32xf16>, %K: i32) -> tensor<32x32xf32> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32>
+    %res = scf.for %k = %c0_i32 to %K step %c32_i32 iter_args(%acc = %cst) -> (tensor<32x32xf32>) : i32 {
+      %d = tt.dot %a, %b, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<32x32xf16> * tensor<32x32xf16> -> tensor<32x32xf32>
+      scf.yield %d : tensor<32x32xf32>
+    }
+    tt.return %res : tensor<32x32xf32>
+  }
+}
+
+// -----
+
+// COM: Other loops are left alone.
+// CHECK-LABEL: tt.func @no_unroll
+// CHECK: scf.for
+// CHECK-COUNT-1: arith.addf
+// CHECK-NOT: arith.addf
+module {
+  tt.func @no_unroll(%x: tensor<32xf32>, %n: i32) -> tensor<32xf32> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %res = scf.for %i = %c0_i32 to %n step %c1_i32 iter_args(%acc = %x) -> (tensor<32xf32>) : i32 {
+      %y = arith.addf %acc, %x : tensor<32xf32>
+      scf.yield %y : tensor<32xf32>
+    }
+    tt.return %res : tensor<32xf32>
+  }
+}
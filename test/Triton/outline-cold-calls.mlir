@@ -0,0 +1,78 @@
+// RUN: triton-opt %s -split-input-file -triton-outline-cold-calls=size-threshold=4 | FileCheck %s
+
+// COM: A scalar helper only called under a condition is kept out of line once
+// COM: it reaches the size threshold.
+// CHECK-LABEL: tt.func private @slow_path
+// CHECK-SAME: noinline = true
+module {
+  tt.func private @slow_path(%arg0: i32, %arg1: !tt.ptr<i32>) -> i32 attributes {noinline = false} {
+    %c1 = arith.constant 1 : i32
+    %0 = arith.muli %arg0, %arg0 : i32
+    %1 = arith.addi %0, %c1 : i32
+    tt.store %arg1, %1 {cache = 1 : i32, evict = 1 : i32} : i32
+    tt.return %1 : i32
+  }
+  tt.func public @kernel(%arg0: i32, %arg1: !tt.ptr<i32>) {
+    %c0 = arith.constant 0 : i32
+    %0 = arith.cmpi slt, %arg0, %c0 : i32
+    scf.if %0 {
+      %1 = tt.call @slow_path(%arg0, %arg1) : (i32, !tt.ptr<i32>) -> i32
+    }
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Helpers reporting errors are outlined whatever their size.
+// CHECK-LABEL: tt.func private @report
+// CHECK-SAME: noinline = true
+module {
+  tt.func private @report(%arg0: i32) attributes {noinline = false} {
+    tt.print "out of bounds: " : %arg0 : i32
+    tt.return
+  }
+  tt.func public @kernel(%arg0: i32, %arg1: i1) {
+    scf.if %arg1 {
+      tt.call @report(%arg0) : (i32) -> ()
+    }
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Helpers called unconditionally, small helpers and helpers taking
+// COM: tensors are left to the inliner.
+// CHECK-LABEL: tt.func private @hot
+// CHECK-SAME: noinline = false
+// CHECK-LABEL: tt.func private @small
+// CHECK-SAME: noinline = false
+// CHECK-LABEL: tt.func private @tensor_arg
+// CHECK-SAME: noinline = false
+module {
+  tt.func private @hot(%arg0: i32, %arg1: !tt.ptr<i32>) attributes {noinline = false} {
+    %0 = arith.muli %arg0, %arg0 : i32
+    %1 = arith.addi %0, %arg0 : i32
+    tt.store %arg1, %1 {cache = 1 : i32, evict = 1 : i32} : i32
+    tt.return
+  }
+  tt.func private @small(%arg0: i32) -> i32 attributes {noinline = false} {
+    tt.return %arg0 : i32
+  }
+  tt.func private @tensor_arg(%arg0: tensor<16xi32>, %arg1: tensor<16x!tt.ptr<i32>>) attributes {noinline = false} {
+    %0 = arith.muli %arg0, %arg0 : tensor<16xi32>
+    %1 = arith.addi %0, %arg0 : tensor<16xi32>
+    tt.store %arg1, %1 {cache = 1 : i32, evict = 1 : i32} : tensor<16xi32>
+    tt.return
+  }
+  tt.func public @kernel(%arg0: i32, %arg1: !tt.ptr<i32>, %arg2: tensor<16xi32>, %arg3: tensor<16x!tt.ptr<i32>>, %arg4: i1) {
+    tt.call @hot(%arg0, %arg1) : (i32, !tt.ptr<i32>) -> ()
+    scf.if %arg4 {
+      tt.call @hot(%arg0, %arg1) : (i32, !tt.ptr<i32>) -> ()
+      %0 = tt.call @small(%arg0) : (i32) -> i32
+      tt.call @tensor_arg(%arg2, %arg3) : (tensor<16xi32>, tensor<16x!tt.ptr<i32>>) -> ()
+    }
+    tt.return
+  }
+}
@@ -65,3 +65,42 @@ tt.func @test_broadcast_mix_type_op_pattern(%arg0: tensor<128x1xf32>, %arg1: f32
 
     tt.return %sel : tensor<128x128xf32>
 }
+
+// CHECK-LABEL: @test_expand_dims_elementwise_pattern
+tt.func @test_expand_dims_elementwise_pattern(%bias: tensor<128xf32>, %scale: tensor<128xf32>, %acc: tensor<64x128xf32>) -> tensor<64x128xf32> {
+    // CHECK: %[[mul:.*]] = arith.mulf %{{.*}}, %{{.*}} : tensor<128xf32>
+    // CHECK: %[[add:.*]] = arith.addf %[[mul]], %{{.*}} : tensor<128xf32>
+    // CHECK-NEXT: %[[expand:.*]] = tt.expand_dims %[[add]] {axis = 0 : i32} : (tensor<128xf32>) -> tensor<1x128xf32>
+    // CHECK-NEXT: %[[broadcast:.*]] = tt.broadcast %[[expand]] : (tensor<1x128xf32>) -> tensor<64x128xf32>
+    // CHECK-NEXT: arith.addf %{{.*}}, %[[broadcast]] : tensor<64x128xf32>
+    %one = arith.constant dense<1.0> : tensor<64x128xf32>
+    %bias0 = tt.expand_dims %bias {axis = 0 : i32} : (tensor<128xf32>) -> tensor<1x128xf32>
+    %bias1 = tt.broadcast %bias0 : (tensor<1x128xf32>) -> tensor<64x128xf32>
+    %scale0 = tt.expand_dims %scale {axis = 0 : i32} : (tensor<128xf32>) -> tensor<1x128xf32>
+    %scale1 = tt.broadcast %scale0 : (tensor<1x128xf32>) -> tensor<64x128xf32>
+    %mul = arith.mulf %bias1, %scale1 : tensor<64x128xf32>
+    %add = arith.addf %mul, %one : tensor<64x128xf32>
+    %res = arith.addf %acc, %add : tensor<64x128xf32>
+    tt.return %res : tensor<64x128xf32>
+}
+
+// CHECK-LABEL: @test_trans_reshape_elementwise_pattern
+tt.func @test_trans_reshape_elementwise_pattern(%arg0: tensor<32x64xf16>, %arg1: tensor<32x64xf16>, %arg2: tensor<64x32xf32>) -> (tensor<64x32xf32>, tensor<2048xf32>, tensor<2048xf32>) {
+    // CHECK: %[[ext:.*]] = arith.extf %arg0 : tensor<32x64xf16> to tensor<32x64xf32>
+    // CHECK-NEXT: %{{.*}} = tt.trans %[[ext]] {order = array<i32: 1, 0>} : (tensor<32x64xf32>) -> tensor<64x32xf32>
+    %trans = tt.trans %arg0 {order = array<i32: 1, 0>} : (tensor<32x64xf16>) -> tensor<64x32xf16>
+    %ext = arith.extf %trans : tensor<64x32xf16> to tensor<64x32xf32>
+
+    // CHECK: %[[ext1:.*]] = arith.extf %arg1 : tensor<32x64xf16> to tensor<32x64xf32>
+    // CHECK-NEXT: %{{.*}} = tt.reshape %[[ext1]] {allow_reorder = false} : tensor<32x64xf32> -> tensor<2048xf32>
+    %reshape = tt.reshape %arg1 {allow_reorder = false} : tensor<32x64xf16> -> tensor<2048xf16>
+    %ext1 = arith.extf %reshape : tensor<2048xf16> to tensor<2048xf32>
+
+    // COM: Reshapes allowed to reorder the elements are left in place.
+    // CHECK: %[[reorder:.*]] = tt.reshape %arg2 {allow_reorder = true} : tensor<64x32xf32> -> tensor<2048xf32>
+    // CHECK-NEXT: math.absf %[[reorder]] : tensor<2048xf32>
+    %reorder = tt.reshape %arg2 {allow_reorder = true} : tensor<64x32xf32> -> tensor<2048xf32>
+    %abs = math.absf %reorder : tensor<2048xf32>
+
+    tt.return %ext, %ext1, %abs : tensor<64x32xf32>, tensor<2048xf32>, tensor<2048xf32>
+}
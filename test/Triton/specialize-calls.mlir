@@ -0,0 +1,56 @@
+// RUN: triton-opt %s -split-input-file -triton-specialize-calls | FileCheck %s
+
+// COM: Calls with differently aligned pointers get their own version of the
+// COM: callee, calls with the same alignment share one.
+// CHECK-LABEL: tt.func public @kernel
+// CHECK: tt.call @load(%arg0)
+// CHECK: tt.call @[[LOAD1:.*]](%arg1)
+// CHECK: tt.call @load(%arg2)
+// CHECK: tt.func private @load(%arg0: !tt.ptr<f32, 1> {{.*}}tt.divisibility = 16 : i64}
+// CHECK: tt.func private @[[LOAD1]](%arg0: !tt.ptr<f32, 1> {{.*}}tt.divisibility = 1 : i64}
+module {
+  tt.func public @kernel(%arg0: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32, 1>, %arg2: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32}) {
+    %0 = tt.call @load(%arg0) : (!tt.ptr<f32, 1>) -> tensor<128xf32>
+    %1 = tt.call @load(%arg1) : (!tt.ptr<f32, 1>) -> tensor<128xf32>
+    %2 = tt.call @load(%arg2) : (!tt.ptr<f32, 1>) -> tensor<128xf32>
+    tt.return
+  }
+
+  tt.func private @load(%arg0: !tt.ptr<f32, 1>) -> tensor<128xf32> attributes {noinline = true} {
+    %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+    %1 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>>
+    %2 = tt.addptr %1, %0 : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi32>
+    %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32>
+    tt.return %3 : tensor<128xf32>
+  }
+}
+
+// -----
+
+// COM: The versions of a caller are specialized before its callees, so each
+// COM: of them calls its own version of the callee.
+// CHECK-LABEL: tt.func public @kernel
+// CHECK: tt.call @outer(%arg0)
+// CHECK: tt.call @[[OUTER1:.*]](%arg1)
+// CHECK: tt.func private @outer(
+// CHECK: tt.call @inner(
+// CHECK: tt.func private @[[OUTER1]](
+// CHECK: tt.call @[[INNER1:.*]](
+// CHECK: tt.func private @inner(%arg0: i32 {{.*}}tt.divisibility = 16 : i64}
+// CHECK: tt.func private @[[INNER1]](%arg0: i32 {{.*}}tt.divisibility = 8 : i64}
+module {
+  tt.func public @kernel(%arg0: i32 {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 8 : i32}) {
+    tt.call @outer(%arg0) : (i32) -> ()
+    tt.call @outer(%arg1) : (i32) -> ()
+    tt.return
+  }
+
+  tt.func private @outer(%arg0: i32) attributes {noinline = true} {
+    tt.call @inner(%arg0) : (i32) -> ()
+    tt.return
+  }
+
+  tt.func private @inner(%arg0: i32) attributes {noinline = true} {
+    tt.return
+  }
+}
@@ -0,0 +1,63 @@
+// RUN: triton-opt %s -split-input-file -triton-split-k=split-k=4 | FileCheck %s
+
+// CHECK: module attributes {"tt.split-k" = 4 : i32}
+// CHECK-LABEL: tt.func @matmul_kernel
+// CHECK: %[[PID:.*]] = tt.get_program_id z : i32
+// CHECK: %[[ITERS:.*]] = arith.ceildivsi
+// CHECK: %[[PER:.*]] = arith.ceildivsi %[[ITERS]], %c4_i32
+// CHECK: %[[SKIP:.*]] = arith.muli %[[PID]], %[[PER]]
+// CHECK: %[[LB:.*]] = arith.addi
+// CHECK: %[[UB:.*]] = arith.minsi
+// CHECK: %[[FIRST:.*]] = arith.cmpi eq, %[[PID]]
+// CHECK: %[[ACC:.*]] = arith.select %[[FIRST]]
+// CHECK: %[[A:.*]] = tt.addptr %{{.*}}, %{{.*}} : tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32xi32>
+// CHECK: %[[B:.*]] = tt.addptr %{{.*}}, %{{.*}} : tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32xi32>
+// CHECK: scf.for %{{.*}} = %[[LB]] to %[[UB]] step %{{.*}} iter_args(%{{.*}} = %[[ACC]], %{{.*}} = %[[A]], %{{.*}} = %[[B]])
+// CHECK-NOT: tt.store
+// CHECK: "tt.atomic_rmw"
+// CHECK-SAME: atomic_rmw_op = 5 : i32
+module {
+  tt.func public @matmul_kernel(%a_ptr: tensor<32x32x!tt.ptr<f16, 1>>, %b_ptr: tensor<32x32x!tt.ptr<f16, 1>>, %c_ptr: tensor<32x32x!tt.ptr<f16, 1>>, %K: i32, %a_step: tensor<32x32xi32>, %b_step: tensor<32x32xi32>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32>
+    %res:3 = scf.for %k = %c0_i32 to %K step %c32_i32 iter_args(%acc = %cst, %a_it = %a_ptr, %b_it = %b_ptr) -> (tensor<32x32xf32>, tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32x!tt.ptr<f16, 1>>) : i32 {
+      %a = tt.load %a_it {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16>
+      %b = tt.load %b_it {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16>
+      %d = tt.dot %a, %b, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<32x32xf16> * tensor<32x32xf16> -> tensor<32x32xf32>
+      %a_next = tt.addptr %a_it, %a_step : tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32xi32>
+      %b_next = tt.addptr %b_it, %b_step : tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32xi32>
+      scf.yield %d, %a_next, %b_next : tensor<32x32xf32>, tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32x!tt.ptr<f16, 1>>
+    }
+    %c = arith.truncf %res#0 : tensor<32x32xf32> to tensor<32x32xf16>
+    tt.store %c_ptr, %c {cache = 1 : i32, evict = 1 : i32} : tensor<32x32xf16>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Kernels that already use the third grid dimension are left alone.
+// CHECK-NOT: tt.split-k
+// CHECK-LABEL: tt.func @batched_matmul_kernel
+// CHECK-NOT: tt.atomic_rmw
+// CHECK: tt.store
+module {
+  tt.func public @batched_matmul_kernel(%a_ptr: tensor<32x32x!tt.ptr<f16, 1>>, %b_ptr: tensor<32x32x!tt.ptr<f16, 1>>, %c_ptr: tensor<32x32x!tt.ptr<f32, 1>>, %K: i32, %a_step: tensor<32x32xi32>, %b_step: tensor<32x32xi32>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32>
+    %batch = tt.get_program_id z : i32
+    %lb = arith.muli %batch, %c0_i32 : i32
+    %res:3 = scf.for %k = %lb to %K step %c32_i32 iter_args(%acc = %cst, %a_it = %a_ptr, %b_it = %b_ptr) -> (tensor<32x32xf32>, tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32x!tt.ptr<f16, 1>>) : i32 {
+      %a = tt.load %a_it {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16>
+      %b = tt.load %b_it {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16>
+      %d = tt.dot %a, %b, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<32x32xf16> * tensor<32x32xf16> -> tensor<32x32xf32>
+      %a_next = tt.addptr %a_it, %a_step : tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32xi32>
+      %b_next = tt.addptr %b_it, %b_step : tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32xi32>
+      scf.yield %d, %a_next, %b_next : tensor<32x32xf32>, tensor<32x32x!tt.ptr<f16, 1>>, tensor<32x32x!tt.ptr<f16, 1>>
+    }
+    tt.store %c_ptr, %res#0 {cache = 1 : i32, evict = 1 : i32} : tensor<32x32xf32>
+    tt.return
+  }
+}
@@ -0,0 +1,106 @@
+// RUN: triton-opt %s -split-input-file --tritongpu-accelerate-matmul=enable-dpas=true | FileCheck %s
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [2, 2]{{.*}}}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dpas_f16
+  tt.func @dpas_f16(%a: tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<64x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<64x64xf32, #[[DPAS]]>
+    %0 = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xf32, #blocked>
+    tt.return %0 : tensor<64x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [2, 2]{{.*}}}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: f16 dots may accumulate in f16.
+  // CHECK-LABEL: dpas_f16_acc
+  tt.func @dpas_f16_acc(%a: tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<64x64xf16, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf16, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<64x64xf16, #[[DPAS]]>
+    %0 = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xf16, #blocked>
+    tt.return %0 : tensor<64x64xf16, #blocked>
+  }
+}
+
+// -----
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 4, warpsPerCTA = [1, 4]{{.*}}}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dpas_small_m
+  tt.func @dpas_small_m(%a: tensor<4x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<4x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<4x64xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<4x64xf32, #[[DPAS]]>
+    %0 = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<4x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<4x64xf32, #blocked>
+    tt.return %0 : tensor<4x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK-NOT: triton_gpu.dpas
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: no_dpas_simd32
+  tt.func @no_dpas_simd32(%a: tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<64x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<64x64xf32, #blocked>
+    %0 = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xf32, #blocked>
+    tt.return %0 : tensor<64x64xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dpas_fp8
+  tt.func @dpas_fp8(%a: tensor<64x32xf8E5M2, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<32x64xf8E5M2, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<64x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #blocked>
+    // CHECK: %[[A:.*]] = tt.fp_to_fp {{.*}} -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #{{.*}}, kWidth = 2}>>
+    // CHECK: %[[B:.*]] = tt.fp_to_fp {{.*}} -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #{{.*}}, kWidth = 2}>>
+    // CHECK: tt.dot %[[A]], %[[B]]
+    %0 = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf8E5M2, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf8E5M2, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xf32, #blocked>
+    tt.return %0 : tensor<64x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: A skinny (decode) GEMM gives all the warps to N so that B is loaded once.
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [1, 8]{{.*}}}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [8, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dpas_skinny_m
+  tt.func @dpas_skinny_m(%a: tensor<16x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<64x128xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<16x128xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<16x128xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<16x128xf32, #[[DPAS]]>
+    %0 = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<16x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<64x128xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<16x128xf32, #blocked>
+    tt.return %0 : tensor<16x128xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: Back-to-back dots share one DPAS layout with the warps along M.
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1]{{.*}}}>
+// CHECK-NOT: #triton_gpu.dpas
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dpas_chained
+  tt.func @dpas_chained(%q: tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %k: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>, %v: tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<64x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<64x64xf32, #[[DPAS]]>
+    %0 = tt.dot %q, %k, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xf32, #blocked>
+    %1 = arith.truncf %0 : tensor<64x64xf32, #blocked> to tensor<64x64xf16, #blocked>
+    %2 = triton_gpu.convert_layout %1 : (tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>
+    // CHECK: tt.dot {{.*}} -> tensor<64x64xf32, #[[DPAS]]>
+    %3 = tt.dot %2, %v, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xf32, #blocked>
+    tt.return %3 : tensor<64x64xf32, #blocked>
+  }
+}
@@ -0,0 +1,51 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-coalesce="max-vector-bits=64 cache-line-bytes=64" | FileCheck %s
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+
+// COM: Per-thread vectors are capped at the 64-bit sub-group block I/O unit.
+// CHECK: [[layout:#.*]] = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+// CHECK-LABEL: tt.func @copy_1d
+// CHECK: tt.load {{.*}} : tensor<256xf32, [[layout]]>
+// CHECK: tt.store {{.*}} : tensor<256xf32, [[layout]]>
+tt.func @copy_1d(%arg0: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32},
+                 %arg1: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32}) {
+  %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked0>
+  %1 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked0>
+  %2 = tt.addptr %1, %0 : tensor<256x!tt.ptr<f32, 1>, #blocked0>, tensor<256xi32, #blocked0>
+  %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
+  %4 = tt.splat %arg1 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked0>
+  %5 = tt.addptr %4, %0 : tensor<256x!tt.ptr<f32, 1>, #blocked0>, tensor<256xi32, #blocked0>
+  tt.store %5, %3 {cache = 1 : i32, evict = 1 : i32} : tensor<256xf32, #blocked0>
+  tt.return
+}
+
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [16, 1], warpsPerCTA = [1, 4], order = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+
+// COM: The lanes of a sub-group are kept within a 64-byte row rather than
+// COM: widening the per-thread vector across several rows.
+// CHECK: [[layout:#.*]] = #triton_gpu.blocked<{sizePerThread = [1, 2], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK-LABEL: tt.func @load_rows
+// CHECK: tt.load {{.*}} : tensor<64x32xf16, [[layout]]>
+tt.func @load_rows(%arg0: !tt.ptr<f16, 1> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}) -> tensor<64x32xf16, #blocked> {
+  %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+  %1 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+  %2 = tt.expand_dims %0 {axis = 1 : i32} : (tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>) -> tensor<64x1xi32, #blocked>
+  %3 = tt.splat %arg1 : (i32) -> tensor<64x1xi32, #blocked>
+  %4 = arith.muli %2, %3 : tensor<64x1xi32, #blocked>
+  %5 = tt.broadcast %4 : (tensor<64x1xi32, #blocked>) -> tensor<64x32xi32, #blocked>
+  %6 = tt.expand_dims %1 {axis = 0 : i32} : (tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>) -> tensor<1x32xi32, #blocked>
+  %7 = tt.broadcast %6 : (tensor<1x32xi32, #blocked>) -> tensor<64x32xi32, #blocked>
+  %8 = arith.addi %5, %7 : tensor<64x32xi32, #blocked>
+  %9 = tt.splat %arg0 : (!tt.ptr<f16, 1>) -> tensor<64x32x!tt.ptr<f16, 1>, #blocked>
+  %10 = tt.addptr %9, %8 : tensor<64x32x!tt.ptr<f16, 1>, #blocked>, tensor<64x32xi32, #blocked>
+  %11 = tt.load %10 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x32xf16, #blocked>
+  tt.return %11 : tensor<64x32xf16, #blocked>
+}
+
+}
@@ -2087,3 +2087,30 @@ tt.func @scan_propagation(%arg: tensor<1024xi32, #slice1dim1>) -> tensor<1024xi3
   tt.return %3: tensor<1024xi32, #slice1dim1>
 }
 }
+
+// -----
+
+// The epilogue is kept in the layout of the load and the store; moving it to
+// the dot layout would need two conversions instead of one.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+// CHECK-LABEL: dpas_epilogue_layout_cost
+tt.func @dpas_epilogue_layout_cost(%a: tensor<64x32xf16, #dot_operand_a>, %b: tensor<32x64xf16, #dot_operand_b>, %ptr: tensor<64x64x!tt.ptr<f32, 1>, #blocked>, %out: tensor<64x64x!tt.ptr<f32, 1>, #blocked>) {
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #dpas>
+  %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #dot_operand_a> * tensor<32x64xf16, #dot_operand_b> -> tensor<64x64xf32, #dpas>
+  // CHECK: triton_gpu.convert_layout %{{.*}} : (tensor<64x64xf32, #[[$DPAS:.+]]>) -> tensor<64x64xf32, #[[$BLOCKED:.+]]>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: arith.addf {{.*}} : tensor<64x64xf32, #[[$BLOCKED]]>
+  // CHECK: math.exp {{.*}} : tensor<64x64xf32, #[[$BLOCKED]]>
+  // CHECK: tt.store
+  %cvt = triton_gpu.convert_layout %d : (tensor<64x64xf32, #dpas>) -> tensor<64x64xf32, #blocked>
+  %l = tt.load %ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf32, #blocked>
+  %s = arith.addf %cvt, %l : tensor<64x64xf32, #blocked>
+  %e = math.exp %s : tensor<64x64xf32, #blocked>
+  tt.store %out, %e {cache = 1 : i32, evict = 1 : i32} : tensor<64x64xf32, #blocked>
+  tt.return
+}
+}
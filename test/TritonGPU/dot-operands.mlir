@@ -176,3 +176,136 @@ module attributes {"triton_gpu.compute-capability" = 80 : i32, "triton_gpu.num-c
     tt.return %td : tensor<128x128xf32, #mma>
   }
 }
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#Adpas = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#Bdpas = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+#ALR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BLR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_gpu.compute-capability" = 1} {
+// CHECK: tt.func @push_int8_dequant_dpas
+// CHECK: %[[BLOAD:.*]] = tt.load %arg1
+// CHECK: %[[BCVT:.*]] = triton_gpu.convert_layout %[[BLOAD]] {{.*}} -> tensor<32x16xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>
+// CHECK: %[[BF16:.*]] = arith.sitofp %[[BCVT]] {{.*}} to tensor<32x16xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>
+// CHECK: tt.dot %{{.*}}, %[[BF16]]
+tt.func @push_int8_dequant_dpas(
+                   %pa: tensor<32x32x!tt.ptr<f16>, #ALR> {tt.divisibility=16: i32, tt.contiguity=2 : i32},
+                   %pb: tensor<32x16x!tt.ptr<i8>, #BLR> {tt.divisibility=16: i32, tt.contiguity=2 : i32},
+                   %c: tensor<32x16xf32, #dpas>) -> tensor<32x16xf32, #dpas>{
+  %a = tt.load %pa {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16, #ALR>
+  %bi8 = tt.load %pb {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x16xi8, #BLR>
+  %b = arith.sitofp %bi8 : tensor<32x16xi8, #BLR> to tensor<32x16xf16, #BLR>
+  %dota = triton_gpu.convert_layout %a : (tensor<32x32xf16, #ALR>) -> tensor<32x32xf16, #Adpas>
+  %dotb = triton_gpu.convert_layout %b : (tensor<32x16xf16, #BLR>) -> tensor<32x16xf16, #Bdpas>
+  %newc = tt.dot %dota, %dotb, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<32x32xf16, #Adpas> * tensor<32x16xf16, #Bdpas> -> tensor<32x16xf32, #dpas>
+  tt.return %newc : tensor<32x16xf32, #dpas>
+}
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#Adpas = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#Bdpas = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+#ALR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BLR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_gpu.compute-capability" = 1} {
+// CHECK: tt.func @block_ptr_load_dpas_operands
+// CHECK-NOT: triton_gpu.convert_layout
+// CHECK: tt.load {{.*}} -> tensor<32x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>>
+// CHECK: tt.load {{.*}} -> tensor<32x16xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>
+// CHECK-NOT: triton_gpu.convert_layout
+// CHECK: tt.dot
+tt.func @block_ptr_load_dpas_operands(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: i64, %c: tensor<32x16xf32, #dpas>) -> tensor<32x16xf32, #dpas>{
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i64 = arith.constant 1 : i64
+  %pa = tt.make_tensor_ptr %arg0, [%arg2, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x32xf16, #ALR>, 1>
+  %pb = tt.make_tensor_ptr %arg1, [%arg2, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x16xf16, #BLR>, 1>
+  %a = tt.load %pa {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x32xf16, #ALR>, 1> -> tensor<32x32xf16, #ALR>
+  %b = tt.load %pb {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #BLR>, 1> -> tensor<32x16xf16, #BLR>
+  %dota = triton_gpu.convert_layout %a : (tensor<32x32xf16, #ALR>) -> tensor<32x32xf16, #Adpas>
+  %dotb = triton_gpu.convert_layout %b : (tensor<32x16xf16, #BLR>) -> tensor<32x16xf16, #Bdpas>
+  %newc = tt.dot %dota, %dotb, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<32x32xf16, #Adpas> * tensor<32x16xf16, #Bdpas> -> tensor<32x16xf32, #dpas>
+  tt.return %newc : tensor<32x16xf32, #dpas>
+}
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#Adpas = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#Bdpas = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+#ALR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BLR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BT = #triton_gpu.blocked<{sizePerThread = [4, 1], threadsPerWarp = [4, 4], warpsPerCTA = [1, 4], order = [0, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_gpu.compute-capability" = 1} {
+// COM: The transposed B operand is read through a column-major block pointer
+// COM: carried by the loop, straight into the DPAS registers.
+// CHECK: tt.func @transposed_block_ptr_load_dpas_operand
+// CHECK: %[[PTR:.*]] = tt.make_tensor_ptr %arg1, [%arg2, %arg3], [%c1_i64, %arg2], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>}
+// CHECK: scf.for {{.*}} iter_args({{.*}}, %[[ARG:.*]] = %[[PTR]])
+// CHECK-NOT: tt.trans
+// CHECK: tt.load %[[ARG]] {boundaryCheck = array<i32: 0, 1>, {{.*}}triton_gpu.transposed_block_load} {{.*}} -> tensor<32x16xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>
+// CHECK-NOT: triton_gpu.convert_layout
+// CHECK: tt.dot
+// CHECK: tt.advance %[[ARG]], [%c32_i32, %c0_i32]
+tt.func @transposed_block_ptr_load_dpas_operand(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: i64, %arg3: i64, %c: tensor<32x16xf32, #dpas>, %n: i32) -> tensor<32x16xf32, #dpas>{
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c32_i32 = arith.constant 32 : i32
+  %c1_i64 = arith.constant 1 : i64
+  %pa = tt.make_tensor_ptr %arg0, [%arg2, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x32xf16, #ALR>, 1>
+  %pb = tt.make_tensor_ptr %arg1, [%arg3, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<16x32xf16, #BLR>, 1>
+  %res:2 = scf.for %iv = %c0_i32 to %n step %c1_i32 iter_args(%acc = %c, %pbi = %pb) -> (tensor<32x16xf32, #dpas>, !tt.ptr<tensor<16x32xf16, #BLR>, 1>) : i32 {
+    %a = tt.load %pa {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x32xf16, #ALR>, 1> -> tensor<32x32xf16, #ALR>
+    %b = tt.load %pbi {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<16x32xf16, #BLR>, 1> -> tensor<16x32xf16, #BLR>
+    %bt = tt.trans %b {order = array<i32: 1, 0>} : (tensor<16x32xf16, #BLR>) -> tensor<32x16xf16, #BT>
+    %dota = triton_gpu.convert_layout %a : (tensor<32x32xf16, #ALR>) -> tensor<32x32xf16, #Adpas>
+    %dotb = triton_gpu.convert_layout %bt : (tensor<32x16xf16, #BT>) -> tensor<32x16xf16, #Bdpas>
+    %newc = tt.dot %dota, %dotb, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<32x32xf16, #Adpas> * tensor<32x16xf16, #Bdpas> -> tensor<32x16xf32, #dpas>
+    %next = tt.advance %pbi, [%c0_i32, %c32_i32] : !tt.ptr<tensor<16x32xf16, #BLR>, 1>
+    scf.yield %newc, %next : tensor<32x16xf32, #dpas>, !tt.ptr<tensor<16x32xf16, #BLR>, 1>
+  }
+  tt.return %res#0 : tensor<32x16xf32, #dpas>
+}
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#Adpas = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#Bdpas = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+#ALR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BLR = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_gpu.compute-capability" = 1} {
+// CHECK: tt.func @hoist_invariant_dequant_dpas
+// CHECK: %[[BLOAD:.*]] = tt.load %arg1
+// CHECK: %[[BCVT:.*]] = triton_gpu.convert_layout %[[BLOAD]] {{.*}} -> tensor<32x16xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>
+// CHECK: %[[BF16:.*]] = arith.sitofp %[[BCVT]]
+// CHECK: scf.for
+// CHECK-NOT: arith.sitofp
+// CHECK: tt.dot %{{.*}}, %[[BF16]]
+tt.func @hoist_invariant_dequant_dpas(
+                   %pa: tensor<32x32x!tt.ptr<f16>, #ALR> {tt.divisibility=16: i32, tt.contiguity=2 : i32},
+                   %pb: tensor<32x16x!tt.ptr<i8>, #BLR> {tt.divisibility=16: i32, tt.contiguity=2 : i32},
+                   %c: tensor<32x16xf32, #dpas>, %n: i32) -> tensor<32x16xf32, #dpas>{
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %bi8 = tt.load %pb {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x16xi8, #BLR>
+  %res = scf.for %iv = %c0_i32 to %n step %c1_i32 iter_args(%acc = %c) -> (tensor<32x16xf32, #dpas>) : i32 {
+    %a = tt.load %pa {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16, #ALR>
+    %b = arith.sitofp %bi8 : tensor<32x16xi8, #BLR> to tensor<32x16xf16, #BLR>
+    %dota = triton_gpu.convert_layout %a : (tensor<32x32xf16, #ALR>) -> tensor<32x32xf16, #Adpas>
+    %dotb = triton_gpu.convert_layout %b : (tensor<32x16xf16, #BLR>) -> tensor<32x16xf16, #Bdpas>
+    %newc = tt.dot %dota, %dotb, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<32x32xf16, #Adpas> * tensor<32x16xf16, #Bdpas> -> tensor<32x16xf32, #dpas>
+    scf.yield %newc : tensor<32x16xf32, #dpas>
+  }
+  tt.return %res : tensor<32x16xf32, #dpas>
+}
+}
@@ -0,0 +1,81 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-pipeline="num-stages=3 use-prefetch=true" | FileCheck %s
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 2], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Block pointer loads are prefetched numStages - 1 iterations ahead and
+  // COM: keep loading straight into registers.
+  // CHECK-LABEL: tt.func @matmul_block_ptr_prefetch
+  // CHECK: triton_gpu.prefetch_tensor
+  // CHECK: triton_gpu.prefetch_tensor
+  // CHECK: triton_gpu.prefetch_tensor
+  // CHECK: triton_gpu.prefetch_tensor
+  // CHECK-NOT: triton_gpu.insert_slice_async
+  // CHECK: scf.for
+  // CHECK-NOT: triton_gpu.insert_slice_async
+  // CHECK-DAG: tt.dot
+  // CHECK-DAG: triton_gpu.prefetch_tensor
+  // CHECK-DAG: triton_gpu.prefetch_tensor
+  // CHECK: scf.yield
+  tt.func @matmul_block_ptr_prefetch(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: i64, %arg3: i64, %arg4: i64, %arg5: i32) -> tensor<64x64xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #dpas>
+    %a_ptr = tt.make_tensor_ptr %arg0, [%arg2, %arg3], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1>
+    %b_ptr = tt.make_tensor_ptr %arg1, [%arg3, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1>
+    %res:3 = scf.for %iv = %c0_i32 to %arg5 step %c1_i32 iter_args(%acc = %cst, %a_it = %a_ptr, %b_it = %b_ptr) -> (tensor<64x64xf32, #dpas>, !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1>, !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1>) : i32 {
+      %a = tt.load %a_it {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1> -> tensor<64x32xf16, #dot_operand_a>
+      %b = tt.load %b_it {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1> -> tensor<32x64xf16, #dot_operand_b>
+      %d = tt.dot %a, %b, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #dot_operand_a> * tensor<32x64xf16, #dot_operand_b> -> tensor<64x64xf32, #dpas>
+      %a_next = tt.advance %a_it, [%c0_i32, %c32_i32] : <tensor<64x32xf16, #dot_operand_a>, 1>
+      %b_next = tt.advance %b_it, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #dot_operand_b>, 1>
+      scf.yield %d, %a_next, %b_next : tensor<64x64xf32, #dpas>, !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1>, !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1>
+    }
+    tt.return %res#0 : tensor<64x64xf32, #dpas>
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 2], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: In a persistent loop the prologue prefetches of the next tile are
+  // COM: issued before the epilogue of the current one.
+  // CHECK-LABEL: tt.func @persistent_matmul_prefetch
+  // CHECK: triton_gpu.prefetch_tensor
+  // CHECK: scf.for
+  // CHECK:   scf.for
+  // CHECK:   scf.yield
+  // CHECK:   triton_gpu.prefetch_tensor
+  // CHECK:   tt.store
+  // CHECK:   scf.yield
+  tt.func @persistent_matmul_prefetch(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: !tt.ptr<f32, 1>, %arg3: i64, %arg4: i32, %arg5: i32, %arg6: i32, %arg7: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #dpas>
+    scf.for %tile = %arg5 to %arg6 step %arg7 : i32 {
+      %m = arith.muli %tile, %c64_i32 : i32
+      %a_ptr = tt.make_tensor_ptr %arg0, [%arg3, %arg3], [%arg3, %c1_i64], [%m, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1>
+      %b_ptr = tt.make_tensor_ptr %arg1, [%arg3, %arg3], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1>
+      %res:3 = scf.for %iv = %c0_i32 to %arg4 step %c1_i32 iter_args(%acc = %cst, %a_it = %a_ptr, %b_it = %b_ptr) -> (tensor<64x64xf32, #dpas>, !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1>, !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1>) : i32 {
+        %a = tt.load %a_it {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1> -> tensor<64x32xf16, #dot_operand_a>
+        %b = tt.load %b_it {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1> -> tensor<32x64xf16, #dot_operand_b>
+        %d = tt.dot %a, %b, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #dot_operand_a> * tensor<32x64xf16, #dot_operand_b> -> tensor<64x64xf32, #dpas>
+        %a_next = tt.advance %a_it, [%c0_i32, %c32_i32] : <tensor<64x32xf16, #dot_operand_a>, 1>
+        %b_next = tt.advance %b_it, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #dot_operand_b>, 1>
+        scf.yield %d, %a_next, %b_next : tensor<64x64xf32, #dpas>, !tt.ptr<tensor<64x32xf16, #dot_operand_a>, 1>, !tt.ptr<tensor<32x64xf16, #dot_operand_b>, 1>
+      }
+      %c_ptr = tt.make_tensor_ptr %arg2, [%arg3, %arg3], [%arg3, %c1_i64], [%m, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<64x64xf32, #dpas>, 1>
+      tt.store %c_ptr, %res#0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<64x64xf32, #dpas>, 1>, tensor<64x64xf32, #dpas>
+    }
+    tt.return
+  }
+}
@@ -804,3 +804,34 @@ module attributes {"triton_gpu.compute-capability" = 86 : i32, "triton_gpu.num-c
     tt.return
   }
 }
+
+// -----
+
+// Loads that do not feed a dot are pipelined through plain shared memory and
+// converted back to their layout.
+// CHECK-LABEL: tt.func @reduce_loop_no_dot
+// CHECK: %[[BUFFER:.*]] = triton_gpu.alloc_tensor : tensor<2x32x32xf32, #[[$SHARED:.*]]>
+// CHECK: triton_gpu.insert_slice_async
+// CHECK: triton_gpu.insert_slice_async
+// CHECK: scf.for
+// CHECK:   %[[SLICE:.*]] = triton_gpu.extract_slice
+// CHECK:   triton_gpu.convert_layout %[[SLICE]] : (tensor<32x32xf32, #[[$SHARED]]>) -> tensor<32x32xf32, #blocked>
+// CHECK:   arith.addf
+// CHECK:   triton_gpu.insert_slice_async
+// CHECK:   scf.yield
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 80 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @reduce_loop_no_dot(%ptr_init : tensor<32x32x!tt.ptr<f32>, #blocked> {tt.divisibility = 16 : i32, tt.contiguity = 32 : i32}, %ub : i32) -> tensor<32x32xf32, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32, #blocked>
+    %off = arith.constant dense<32> : tensor<32x32xi32, #blocked>
+    %res:2 = scf.for %iv = %c0_i32 to %ub step %c1_i32 iter_args(%acc = %cst, %ptr = %ptr_init) -> (tensor<32x32xf32, #blocked>, tensor<32x32x!tt.ptr<f32>, #blocked>) : i32 {
+      %x = tt.load %ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf32, #blocked>
+      %acc_next = arith.addf %acc, %x : tensor<32x32xf32, #blocked>
+      %ptr_next = tt.addptr %ptr, %off : tensor<32x32x!tt.ptr<f32>, #blocked>, tensor<32x32xi32, #blocked>
+      scf.yield %acc_next, %ptr_next : tensor<32x32xf32, #blocked>, tensor<32x32x!tt.ptr<f32>, #blocked>
+    }
+    tt.return %res#0 : tensor<32x32xf32, #blocked>
+  }
+}
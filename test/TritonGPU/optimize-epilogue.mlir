@@ -0,0 +1,88 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-optimize-epilogue | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The bias add and the cast run on the DPAS accumulator, which is
+  // COM: stored without a conversion.
+  // CHECK-LABEL: tt.func @dpas_bias_cast_store
+  // CHECK: %[[BIAS:.*]] = triton_gpu.convert_layout %arg2 {{.*}} -> tensor<32x16xf32, #dpas>
+  // CHECK: %[[ADD:.*]] = arith.addf %arg1, %[[BIAS]] : tensor<32x16xf32, #dpas>
+  // CHECK: %[[CAST:.*]] = arith.truncf %[[ADD]] : tensor<32x16xf32, #dpas> to tensor<32x16xf16, #dpas>
+  // CHECK: %[[PTR:.*]] = triton_gpu.convert_layout %arg0 {{.*}} -> tensor<32x16x!tt.ptr<f16, 1>, #dpas>
+  // CHECK: tt.store %[[PTR]], %[[CAST]] {{.*}} : tensor<32x16xf16, #dpas>
+  tt.func @dpas_bias_cast_store(%ptr: tensor<32x16x!tt.ptr<f16, 1>, #blocked>, %acc: tensor<32x16xf32, #dpas>, %bias: tensor<32x16xf32, #blocked>) {
+    %0 = triton_gpu.convert_layout %acc : (tensor<32x16xf32, #dpas>) -> tensor<32x16xf32, #blocked>
+    %1 = arith.addf %0, %bias : tensor<32x16xf32, #blocked>
+    %2 = arith.truncf %1 : tensor<32x16xf32, #blocked> to tensor<32x16xf16, #blocked>
+    tt.store %ptr, %2 {cache = 1 : i32, evict = 1 : i32} : tensor<32x16xf16, #blocked>
+    tt.return
+  }
+
+  // COM: Stores through a tensor pointer take the DPAS value as is.
+  // CHECK-LABEL: tt.func @dpas_block_ptr_store
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store {{.*}} : !tt.ptr<tensor<32x16xf32, #blocked>, 1>, tensor<32x16xf32, #dpas>
+  tt.func @dpas_block_ptr_store(%arg0: !tt.ptr<f32, 1>, %arg1: i64, %acc: tensor<32x16xf32, #dpas>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %ptr = tt.make_tensor_ptr %arg0, [%arg1, %arg1], [%arg1, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x16xf32, #blocked>, 1>
+    %0 = triton_gpu.convert_layout %acc : (tensor<32x16xf32, #dpas>) -> tensor<32x16xf32, #blocked>
+    tt.store %ptr, %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<32x16xf32, #blocked>, 1>, tensor<32x16xf32, #blocked>
+    tt.return
+  }
+
+  // COM: The requantization of an int8 GEMM runs on the DPAS accumulator:
+  // COM: per-channel scale, zero point, rounding and saturation to int8.
+  // CHECK-LABEL: tt.func @dpas_requantize_store
+  // CHECK: %[[ACC:.*]] = arith.sitofp %arg1 : tensor<32x16xi32, #dpas> to tensor<32x16xf32, #dpas>
+  // CHECK: %[[SCALE:.*]] = triton_gpu.convert_layout %arg2 {{.*}} -> tensor<32x16xf32, #dpas>
+  // CHECK: arith.mulf %[[ACC]], %[[SCALE]] : tensor<32x16xf32, #dpas>
+  // CHECK: arith.addf {{.*}} : tensor<32x16xf32, #dpas>
+  // CHECK: tt.extern_elementwise {{.*}} -> tensor<32x16xf32, #dpas>
+  // CHECK: tt.clampf {{.*}} : tensor<32x16xf32, #dpas>
+  // CHECK: arith.fptosi {{.*}} : tensor<32x16xf32, #dpas> to tensor<32x16xi8, #dpas>
+  // CHECK: tt.store {{.*}} : tensor<32x16xi8, #dpas>
+  tt.func @dpas_requantize_store(%ptr: tensor<32x16x!tt.ptr<i8, 1>, #blocked>, %acc: tensor<32x16xi32, #dpas>, %scale: tensor<32x16xf32, #blocked>, %zp: tensor<32x16xf32, #blocked>) {
+    %lo = arith.constant dense<-1.280000e+02> : tensor<32x16xf32, #blocked>
+    %hi = arith.constant dense<1.270000e+02> : tensor<32x16xf32, #blocked>
+    %0 = triton_gpu.convert_layout %acc : (tensor<32x16xi32, #dpas>) -> tensor<32x16xi32, #blocked>
+    %1 = arith.sitofp %0 : tensor<32x16xi32, #blocked> to tensor<32x16xf32, #blocked>
+    %2 = arith.mulf %1, %scale : tensor<32x16xf32, #blocked>
+    %3 = arith.addf %2, %zp : tensor<32x16xf32, #blocked>
+    %4 = tt.extern_elementwise %3 {libname = "", libpath = "", pure = true, symbol = "__imf_rintf"} : (tensor<32x16xf32, #blocked>) -> tensor<32x16xf32, #blocked>
+    %5 = tt.clampf %4, %lo, %hi {propagateNan = 0 : i32} : tensor<32x16xf32, #blocked>
+    %6 = arith.fptosi %5 : tensor<32x16xf32, #blocked> to tensor<32x16xi8, #blocked>
+    tt.store %ptr, %6 {cache = 1 : i32, evict = 1 : i32} : tensor<32x16xi8, #blocked>
+    tt.return
+  }
+
+  // COM: Saturating with a compare and a select uses the accumulator twice;
+  // COM: both uses move with it.
+  // CHECK-LABEL: tt.func @dpas_saturate_select_store
+  // CHECK: %[[CMP:.*]] = arith.cmpi sgt, %arg1, {{.*}} : tensor<32x16xi32, #dpas>
+  // CHECK: %[[SEL:.*]] = arith.select %[[CMP]], {{.*}}, %arg1 : tensor<32x16xi1, #dpas>, tensor<32x16xi32, #dpas>
+  // CHECK: arith.trunci %[[SEL]] : tensor<32x16xi32, #dpas> to tensor<32x16xi8, #dpas>
+  // CHECK: tt.store {{.*}} : tensor<32x16xi8, #dpas>
+  tt.func @dpas_saturate_select_store(%ptr: tensor<32x16x!tt.ptr<i8, 1>, #blocked>, %acc: tensor<32x16xi32, #dpas>) {
+    %hi = arith.constant dense<127> : tensor<32x16xi32, #blocked>
+    %0 = triton_gpu.convert_layout %acc : (tensor<32x16xi32, #dpas>) -> tensor<32x16xi32, #blocked>
+    %1 = arith.cmpi sgt, %0, %hi : tensor<32x16xi32, #blocked>
+    %2 = arith.select %1, %hi, %0 : tensor<32x16xi1, #blocked>, tensor<32x16xi32, #blocked>
+    %3 = arith.trunci %2 : tensor<32x16xi32, #blocked> to tensor<32x16xi8, #blocked>
+    tt.store %ptr, %3 {cache = 1 : i32, evict = 1 : i32} : tensor<32x16xi8, #blocked>
+    tt.return
+  }
+
+  // COM: An accumulator also used outside of the epilogue stays converted.
+  // CHECK-LABEL: tt.func @dpas_acc_other_use
+  // CHECK: %[[CVT:.*]] = triton_gpu.convert_layout %arg2 {{.*}} -> tensor<32x16xf32, #blocked>
+  // CHECK: arith.addf %[[CVT]], %[[CVT]] : tensor<32x16xf32, #blocked>
+  tt.func @dpas_acc_other_use(%ptr: tensor<32x16x!tt.ptr<f32, 1>, #blocked>, %other: tensor<32x16x!tt.ptr<f32, 1>, #blocked>, %acc: tensor<32x16xf32, #dpas>) {
+    %0 = triton_gpu.convert_layout %acc : (tensor<32x16xf32, #dpas>) -> tensor<32x16xf32, #blocked>
+    %1 = arith.addf %0, %0 : tensor<32x16xf32, #blocked>
+    tt.store %ptr, %1 {cache = 1 : i32, evict = 1 : i32} : tensor<32x16xf32, #blocked>
+    tt.store %other, %0 {cache = 1 : i32, evict = 1 : i32} : tensor<32x16xf32, #blocked>
+    tt.return
+  }
+}
@@ -595,3 +595,53 @@ module attributes {"triton_gpu.compute-capability" = 80 : i32, "triton_gpu.num-c
     tt.return %1 : tensor<64xf32, #triton_gpu.slice<{dim = 1, parent = #blocked1}>>
   }
 }
+
+// -----
+
+// COM: A loop over a long 1D row keeps per-thread partial sums of squares
+// COM: across iterations and only reduces across the sub-group after the loop.
+// CHECK-LABEL: row_sum_of_squares
+// CHECK: %[[CST:.*]] = arith.constant 0.000000e+00 : f32
+// CHECK: %[[PARTIAL_INIT:.*]] = arith.constant dense<0.000000e+00> : tensor<64xf32
+// CHECK: %[[LOOP_OUTPUT:.*]] = scf.for {{.*}} iter_args(%[[FOR_ARG:.*]] = %[[PARTIAL_INIT]]) -> {{.*}}
+// CHECK: %[[LOAD:.*]] = tt.load
+// CHECK: %[[SQUARE:.*]] = arith.mulf %[[LOAD]], %[[LOAD]]
+// CHECK: tt.reshape %[[SQUARE]] {allow_reorder = true, efficient_layout} : {{.*}} -> tensor<{{64x16xf32.*}}
+// CHECK-NEXT: %[[REDUCE:.*]] = "tt.reduce"({{%.*}}) <{axis = 1 : i32}>
+// CHECK: arith.addf
+// CHECK: arith.addf %[[FOR_ARG]], %[[REDUCE]] : tensor<64xf32
+// CHECK-NEXT: scf.yield
+// CHECK: %[[FINAL_REDUCE:.*]] = "tt.reduce"(%[[LOOP_OUTPUT]]) <{axis = 0 : i32}>
+// CHECK-NOT: triton_gpu.convert_layout
+// CHECK: %[[RESULT:.*]] = arith.addf %[[FINAL_REDUCE]], %[[CST]] : f32
+// CHECK: tt.store {{%.*}}, %[[RESULT]]
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @row_sum_of_squares(
+    %arg0: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32},
+    %arg1: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32},
+    %arg2: i32 {tt.divisibility = 16 : i32}
+    ) attributes {noinline = false} {
+    %cst = arith.constant 0.000000e+00 : f32
+    %c0_i32 = arith.constant 0 : i32
+    %c1024_i32 = arith.constant 1024 : i32
+    %0 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked>
+    %1 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<1024x!tt.ptr<f32, 1>, #blocked>
+    %2 = scf.for %arg3 = %c0_i32 to %arg2 step %c1024_i32 iter_args(%arg4 = %cst) -> (f32)  : i32 {
+      %3 = tt.splat %arg3 : (i32) -> tensor<1024xi32, #blocked>
+      %4 = arith.addi %3, %0 : tensor<1024xi32, #blocked>
+      %5 = tt.addptr %1, %4 : tensor<1024x!tt.ptr<f32, 1>, #blocked>, tensor<1024xi32, #blocked>
+      %6 = tt.load %5 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1024xf32, #blocked>
+      %7 = arith.mulf %6, %6 : tensor<1024xf32, #blocked>
+      %8 = "tt.reduce"(%7) <{axis = 0 : i32}> ({
+      ^bb0(%arg5: f32, %arg6: f32):
+        %10 = arith.addf %arg5, %arg6 : f32
+        tt.reduce.return %10 : f32
+      }) : (tensor<1024xf32, #blocked>) -> f32
+      %9 = arith.addf %arg4, %8 : f32
+      scf.yield %9 : f32
+    }
+    tt.store %arg1, %2 {cache = 1 : i32, evict = 1 : i32} : f32
+    tt.return
+  }
+}
@@ -68,3 +68,40 @@ tt.func @matmul_loop_mixed(%lb : index, %ub : index, %step : index, %A : !tt.ptr
   tt.return %loop#4 : tensor<128x128xf32, #C>
 }
 }  // end module
+
+// -----
+
+#SA = #triton_gpu.shared<{vec = 8, perPhase = 1, maxPhase = 8, order = [1, 0]}>
+#SB = #triton_gpu.shared<{vec = 8, perPhase = 1, maxPhase = 8, order = [1, 0]}>
+#DPAS = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#DPAS_A = #triton_gpu.dot_op<{opIdx = 0, parent = #DPAS, kWidth = 2}>
+#DPAS_B = #triton_gpu.dot_op<{opIdx = 1, parent = #DPAS, kWidth = 2}>
+
+// COM: DPAS operands are prefetched one instruction step (systolic depth x
+// COM: ops per channel) along K and keep the kWidth of the original operands.
+// CHECK-LABEL: tt.func @matmul_loop_dpas
+// CHECK-DAG: %[[A0_PREFETCH_SMEM:.*]] = triton_gpu.extract_slice %[[A0:.*]][0, 0] [64, 16]
+// CHECK-DAG: %[[A0_PREFETCH:.*]] = triton_gpu.convert_layout %[[A0_PREFETCH_SMEM]] {{.*}} -> tensor<64x16xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #{{.*}}, kWidth = 2}>>
+// CHECK-DAG: %[[B0_PREFETCH_SMEM:.*]] = triton_gpu.extract_slice %[[B0:.*]][0, 0] [16, 64]
+// CHECK-DAG: %[[B0_PREFETCH:.*]] = triton_gpu.convert_layout %[[B0_PREFETCH_SMEM]] {{.*}} -> tensor<16x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #{{.*}}, kWidth = 2}>>
+// CHECK:     scf.for {{.*}} iter_args(%[[arg_a0:.*]] = %[[A0]], %[[arg_b0:.*]] = %[[B0]], {{.*}}, %[[a0_prefetch:.*]] = %[[A0_PREFETCH]], %[[b0_prefetch:.*]] = %[[B0_PREFETCH]]
+// CHECK:       %[[D_FIRST:.*]] = tt.dot %[[a0_prefetch]], %[[b0_prefetch]], {{.*}}
+// CHECK-DAG:   triton_gpu.extract_slice %[[arg_a0]][0, 16] [64, 16]
+// CHECK-DAG:   triton_gpu.extract_slice %[[arg_b0]][16, 0] [16, 64]
+// CHECK:       %[[D_SECOND:.*]] = tt.dot {{.*}}, {{.*}}, %[[D_FIRST]]
+// CHECK-DAG:   triton_gpu.extract_slice %[[arg_a0]][0, 32] [64, 16]
+// CHECK-DAG:   triton_gpu.extract_slice %[[arg_b0]][32, 0] [16, 64]
+// CHECK:       tt.dot {{.*}}, {{.*}}, %[[D_SECOND]]
+// CHECK:     scf.yield
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+tt.func @matmul_loop_dpas(%lb : index, %ub : index, %step : index, %a_init : tensor<64x48xf16, #SA>, %b_init : tensor<48x64xf16, #SB>) -> tensor<64x64xf32, #DPAS> {
+  %c_init = arith.constant dense<0.00e+00> : tensor<64x64xf32, #DPAS>
+  %loop:3 = scf.for %iv = %lb to %ub step %step iter_args(%a = %a_init, %b = %b_init, %prev_c = %c_init) -> (tensor<64x48xf16, #SA>, tensor<48x64xf16, #SB>, tensor<64x64xf32, #DPAS>) {
+    %a_op = triton_gpu.convert_layout %a : (tensor<64x48xf16, #SA>) -> tensor<64x48xf16, #DPAS_A>
+    %b_op = triton_gpu.convert_layout %b : (tensor<48x64xf16, #SB>) -> tensor<48x64xf16, #DPAS_B>
+    %c = tt.dot %a_op, %b_op, %prev_c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x48xf16, #DPAS_A> * tensor<48x64xf16, #DPAS_B> -> tensor<64x64xf32, #DPAS>
+    scf.yield %a, %b, %c : tensor<64x48xf16, #SA>, tensor<48x64xf16, #SB>, tensor<64x64xf32, #DPAS>
+  }
+  tt.return %loop#2 : tensor<64x64xf32, #DPAS>
+}
+}  // end module
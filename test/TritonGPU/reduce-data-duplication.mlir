@@ -0,0 +1,43 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-reduce-data-duplication | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [32, 1], warpsPerCTA = [1, 4], order = [0, 1]}>
+#blocked2 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // COM: A value converted to several blocked layouts goes through a single
+  // COM: shared memory copy.
+  // CHECK-LABEL: tt.func @multiple_blocked_conversions
+  // CHECK: %[[SHARED:.*]] = triton_gpu.convert_layout %arg0 {{.*}} -> tensor<32x64xf16, #shared>
+  // CHECK-NEXT: triton_gpu.convert_layout %[[SHARED]] {{.*}} -> tensor<32x64xf16, #blocked{{[0-9]+}}>
+  // CHECK-NEXT: triton_gpu.convert_layout %[[SHARED]] {{.*}} -> tensor<32x64xf16, #blocked{{[0-9]+}}>
+  tt.func @multiple_blocked_conversions(%arg0: tensor<32x64xf16, #blocked>) -> (tensor<32x64xf16, #blocked1>, tensor<32x64xf16, #blocked2>) {
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #blocked1>
+    %1 = triton_gpu.convert_layout %arg0 : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #blocked2>
+    tt.return %0, %1 : tensor<32x64xf16, #blocked1>, tensor<32x64xf16, #blocked2>
+  }
+
+  // COM: A single conversion keeps its direct lowering.
+  // CHECK-LABEL: tt.func @single_blocked_conversion
+  // CHECK-NOT: #shared
+  // CHECK: triton_gpu.convert_layout %arg0 {{.*}} -> tensor<32x64xf16, #blocked{{[0-9]+}}>
+  tt.func @single_blocked_conversion(%arg0: tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #blocked1> {
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #blocked1>
+    tt.return %0 : tensor<32x64xf16, #blocked1>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot_a = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Conversions to DPAS dot operands are redistributed through SLM.
+  // CHECK-LABEL: tt.func @dpas_dot_operand
+  // CHECK: %[[SHARED:.*]] = triton_gpu.convert_layout %arg0 {{.*}} -> tensor<32x32xf16, #shared>
+  // CHECK: triton_gpu.convert_layout %[[SHARED]] {{.*}} -> tensor<32x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>>
+  tt.func @dpas_dot_operand(%arg0: tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #dot_a> {
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #dot_a>
+    tt.return %0 : tensor<32x32xf16, #dot_a>
+  }
+}
@@ -1,4 +1,5 @@
 // RUN: triton-opt %s -split-input-file -tritongpu-reorder-instructions | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-reorder-instructions="schedule-loops=true" | FileCheck %s --check-prefix=SCHED
 
 // check that we don't hoist convert_layout above its operand definition.
 // CHECK-LABEL: convert_cannot_hoist
@@ -70,3 +71,32 @@ module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-war
     tt.return
   }
 }
+
+// -----
+
+// The load is issued first, and independent math fills its latency.
+// SCHED-LABEL: schedule_loop_body
+//       SCHED: scf.for
+//  SCHED-NEXT:   tt.load
+//  SCHED-NEXT:   math.exp
+//  SCHED-NEXT:   tt.addptr
+//  SCHED-NEXT:   arith.mulf
+//  SCHED-NEXT:   arith.addf
+//  SCHED-NEXT:   scf.yield
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func public @schedule_loop_body(%arg0: tensor<128x!tt.ptr<f32>, #blocked>, %arg1: tensor<128xi32, #blocked>, %arg2: i32) -> tensor<128xf32, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<128xf32, #blocked>
+    %0:2 = scf.for %iv = %c0_i32 to %arg2 step %c1_i32 iter_args(%acc = %cst, %ptr = %arg0) -> (tensor<128xf32, #blocked>, tensor<128x!tt.ptr<f32>, #blocked>) : i32 {
+      %1 = math.exp %acc : tensor<128xf32, #blocked>
+      %2 = arith.mulf %1, %1 : tensor<128xf32, #blocked>
+      %3 = tt.load %ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32, #blocked>
+      %4 = arith.addf %2, %3 : tensor<128xf32, #blocked>
+      %5 = tt.addptr %ptr, %arg1 : tensor<128x!tt.ptr<f32>, #blocked>, tensor<128xi32, #blocked>
+      scf.yield %4, %5 : tensor<128xf32, #blocked>, tensor<128x!tt.ptr<f32>, #blocked>
+    }
+    tt.return %0#0 : tensor<128xf32, #blocked>
+  }
+}
@@ -0,0 +1,41 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-rewrite-tensor-pointer="compute-capability=1 keep-block-pointers=true" | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [8, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // Row-major block pointer with a 16-byte aligned pitch: kept.
+  // CHECK-LABEL: @keep_row_major
+  tt.func public @keep_row_major(%arg0: !tt.ptr<f16, 1>, %arg1: i32 {tt.divisibility = 16 : i32}) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c64_i64 = arith.constant 64 : i64
+    %0 = arith.extsi %arg1 : i32 to i64
+    // CHECK: %[[PTR:.*]] = tt.make_tensor_ptr
+    // CHECK: %[[VAL:.*]] = tt.load %[[PTR]] {boundaryCheck = array<i32: 0, 1>
+    // CHECK: tt.store %[[PTR]], %[[VAL]] {boundaryCheck = array<i32: 0, 1>
+    %1 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%0, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>
+    %2 = tt.load %1 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1> -> tensor<32x16xf16, #blocked>
+    tt.store %1, %2 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>, tensor<32x16xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [8, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // Column-major block pointer and pitch of unknown alignment: rewritten.
+  // CHECK-LABEL: @rewrite_unsupported
+  tt.func public @rewrite_unsupported(%arg0: !tt.ptr<f16, 1>, %arg1: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c64_i64 = arith.constant 64 : i64
+    // CHECK-NOT: tt.make_tensor_ptr
+    // CHECK: tt.load %{{.*}}, %{{.*}}, %{{.*}} {boundaryCheck = array<i32: 0, 1>
+    // CHECK: tt.load %{{.*}}, %{{.*}}, %{{.*}} {boundaryCheck = array<i32: 0, 1>
+    %0 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c1_i64, %c64_i64], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>
+    %1 = tt.load %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1> -> tensor<32x16xf16, #blocked>
+    %2 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%arg1, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x16xf16, #blocked>, 1>
+    %3 = tt.load %2 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #blocked>, 1> -> tensor<32x16xf16, #blocked>
+    tt.return
+  }
+}
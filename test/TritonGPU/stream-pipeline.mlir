@@ -0,0 +1,70 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-stream-pipeline | FileCheck %s
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [8, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [2, 8], warpsPerCTA = [8, 1], order = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 2], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The first tiles are stored to shared memory before the loop, which
+  // COM: loads the next tiles into registers before computing on the current
+  // COM: ones and stores them at the end of the iteration. The last iteration
+  // COM: is peeled.
+  // CHECK-LABEL: tt.func @matmul_loop
+  // CHECK: %[[A0:.*]] = tt.load
+  // CHECK: triton_gpu.convert_layout %[[A0]] : (tensor<64x32xf16, #{{.*}}>) -> tensor<64x32xf16, #shared
+  // CHECK: %[[B0:.*]] = tt.load
+  // CHECK: triton_gpu.convert_layout %[[B0]] : (tensor<32x64xf16, #{{.*}}>) -> tensor<32x64xf16, #shared
+  // CHECK: %[[UB:.*]] = arith.subi %{{.*}}, %{{.*}} : i32
+  // CHECK: scf.for %{{.*}} = %{{.*}} to %[[UB]]
+  // CHECK:   %[[NEXT_A:.*]] = tt.load
+  // CHECK:   %[[NEXT_B:.*]] = tt.load
+  // CHECK:   tt.dot
+  // CHECK:   triton_gpu.convert_layout %[[NEXT_A]] : {{.*}} -> tensor<64x32xf16, #shared
+  // CHECK:   triton_gpu.convert_layout %[[NEXT_B]] : {{.*}} -> tensor<32x64xf16, #shared
+  // CHECK:   scf.yield
+  // CHECK: tt.dot
+  // CHECK-NOT: tt.load
+  // CHECK: tt.return
+  tt.func @matmul_loop(%lb: i32, %ub: i32, %step: i32, %A: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %B: !tt.ptr<f16> {tt.divisibility = 16 : i32}) -> tensor<64x64xf32, #dpas> {
+    %a_splat = tt.splat %A : (!tt.ptr<f16>) -> tensor<64x32x!tt.ptr<f16>, #AL>
+    %b_splat = tt.splat %B : (!tt.ptr<f16>) -> tensor<32x64x!tt.ptr<f16>, #BL>
+    %a_off = arith.constant dense<32> : tensor<64x32xi32, #AL>
+    %b_off = arith.constant dense<2048> : tensor<32x64xi32, #BL>
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #dpas>
+    %res:3 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_splat, %b_ptr = %b_splat, %acc = %cst) -> (tensor<64x32x!tt.ptr<f16>, #AL>, tensor<32x64x!tt.ptr<f16>, #BL>, tensor<64x64xf32, #dpas>) : i32 {
+      %a_ = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x32xf16, #AL>
+      %a = triton_gpu.convert_layout %a_ : (tensor<64x32xf16, #AL>) -> tensor<64x32xf16, #A>
+      %b_ = tt.load %b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x64xf16, #BL>
+      %b = triton_gpu.convert_layout %b_ : (tensor<32x64xf16, #BL>) -> tensor<32x64xf16, #B>
+      %c = tt.dot %a, %b, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #A> * tensor<32x64xf16, #B> -> tensor<64x64xf32, #dpas>
+      %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<64x32x!tt.ptr<f16>, #AL>, tensor<64x32xi32, #AL>
+      %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<32x64x!tt.ptr<f16>, #BL>, tensor<32x64xi32, #BL>
+      scf.yield %next_a_ptr, %next_b_ptr, %c : tensor<64x32x!tt.ptr<f16>, #AL>, tensor<32x64x!tt.ptr<f16>, #BL>, tensor<64x64xf32, #dpas>
+    }
+    tt.return %res#2 : tensor<64x64xf32, #dpas>
+  }
+}
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [8, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Loads that do not feed dot operands are left in the loop.
+  // CHECK-LABEL: tt.func @reduce_loop
+  // CHECK-NOT: tt.load
+  // CHECK: scf.for
+  // CHECK: tt.load
+  tt.func @reduce_loop(%lb: i32, %ub: i32, %step: i32, %A: !tt.ptr<f16>) -> tensor<64x32xf16, #AL> {
+    %a_splat = tt.splat %A : (!tt.ptr<f16>) -> tensor<64x32x!tt.ptr<f16>, #AL>
+    %a_off = arith.constant dense<32> : tensor<64x32xi32, #AL>
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x32xf16, #AL>
+    %res:2 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_splat, %acc = %cst) -> (tensor<64x32x!tt.ptr<f16>, #AL>, tensor<64x32xf16, #AL>) : i32 {
+      %a = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x32xf16, #AL>
+      %sum = arith.addf %acc, %a : tensor<64x32xf16, #AL>
+      %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<64x32x!tt.ptr<f16>, #AL>, tensor<64x32xi32, #AL>
+      scf.yield %next_a_ptr, %sum : tensor<64x32x!tt.ptr<f16>, #AL>, tensor<64x32xf16, #AL>
+    }
+    tt.return %res#1 : tensor<64x32xf16, #AL>
+  }
+}
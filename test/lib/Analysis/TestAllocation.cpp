@@ -50,10 +50,45 @@ struct TestAllocationPass
   }
 };
 
+struct TestSharedMemoryReportPass
+    : public PassWrapper<TestSharedMemoryReportPass, OperationPass<ModuleOp>> {
+
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestSharedMemoryReportPass);
+
+  TestSharedMemoryReportPass() = default;
+  TestSharedMemoryReportPass(const TestSharedMemoryReportPass &other)
+      : PassWrapper(other) {}
+
+  StringRef getArgument() const final {
+    return "test-print-shared-memory-report";
+  }
+  StringRef getDescription() const final {
+    return "print the shared memory usage and occupancy of each kernel";
+  }
+
+  Option<unsigned> sharedMemoryPerCore{
+      *this, "shared-memory-per-core",
+      llvm::cl::desc("shared memory available on one core, in bytes"),
+      llvm::cl::init(128 * 1024)};
+  Option<unsigned> maxWarpsPerCore{
+      *this, "max-warps-per-core",
+      llvm::cl::desc("warps one core keeps resident"), llvm::cl::init(64)};
+
+  void runOnOperation() override {
+    ModuleAllocation moduleAllocation(getOperation());
+    printSharedMemoryReport(moduleAllocation, sharedMemoryPerCore,
+                            maxWarpsPerCore, llvm::errs());
+    llvm::errs() << "\n";
+  }
+};
+
 } // namespace
 
 namespace mlir {
 namespace test {
-void registerTestAllocationPass() { PassRegistration<TestAllocationPass>(); }
+void registerTestAllocationPass() {
+  PassRegistration<TestAllocationPass>();
+  PassRegistration<TestSharedMemoryReportPass>();
+}
 } // namespace test
 } // namespace mlir
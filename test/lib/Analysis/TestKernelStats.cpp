@@ -0,0 +1,31 @@
+#include "mlir/Pass/Pass.h"
+#include "triton/Analysis/KernelStats.h"
+
+using namespace mlir;
+
+namespace {
+
+struct TestKernelStatsPass
+    : public PassWrapper<TestKernelStatsPass, OperationPass<ModuleOp>> {
+
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestKernelStatsPass);
+
+  StringRef getArgument() const final { return "test-print-kernel-stats"; }
+  StringRef getDescription() const final {
+    return "print the layout conversions, shared memory, barriers, vector "
+           "widths and dot shapes of each module";
+  }
+
+  void runOnOperation() override {
+    printKernelStats(getOperation(), llvm::errs());
+    llvm::errs() << "\n";
+  }
+};
+
+} // namespace
+
+namespace mlir {
+namespace test {
+void registerTestKernelStatsPass() { PassRegistration<TestKernelStatsPass>(); }
+} // namespace test
+} // namespace mlir
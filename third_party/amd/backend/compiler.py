@@ -21,6 +21,7 @@ class HIPOptions:
     debug: bool = False
     arch: str = None
     allow_fp8e4nv: bool = False
+    native_float_atomic_minmax: bool = False
     # TODO: deprecate when hook interface has changed
     enable_warp_specialization: bool = False
     enable_fp_fusion: bool = True
@@ -73,11 +74,12 @@ class HIPBackend(BaseBackend):
         return "/opt/rocm/llvm/bin/ld.lld"
 
     @staticmethod
-    def make_ttir(mod, metadata, opt):
+    def make_ttir(mod, metadata, opt, native_block_pointers=False):
         pm = ir.pass_manager(mod.context)
         pm.enable_debug()
         passes.common.add_inliner(pm)
-        passes.ttir.add_rewrite_tensor_pointer(pm)
+        if not native_block_pointers:
+            passes.ttir.add_rewrite_tensor_pointer(pm)
         passes.ttir.add_combine(pm)
         passes.common.add_canonicalizer(pm)
         passes.ttir.add_reorder_broadcast(pm)
@@ -103,7 +105,7 @@ class HIPBackend(BaseBackend):
         amd.passes.ttgpuir.add_optimize_epilogue(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm)
         if opt.num_stages == 0 and opt.matrix_core_version != 0:
-            amd.passes.ttgpuir.add_stream_pipeline(pm)
+            passes.ttgpuir.add_stream_pipeline(pm)
             passes.common.add_canonicalizer(pm)
         passes.ttgpuir.add_pipeline(pm, opt.num_stages, opt.num_warps, opt.num_ctas, 0)
         passes.ttgpuir.add_optimize_dot_operands(pm)
@@ -181,7 +183,8 @@ class HIPBackend(BaseBackend):
         return ret
 
     def add_stages(self, stages, options):
-        stages["ttir"] = lambda src, metadata: self.make_ttir(src, metadata, options)
+        stages["ttir"] = lambda src, metadata: self.make_ttir(src, metadata, options,
+                                                              self.supports_native_block_pointers(options))
         stages["ttgir"] = lambda src, metadata: self.make_ttgir(src, metadata, options)
         stages["llir"] = lambda src, metadata: self.make_llir(src, metadata, options, 90)
         # TODO: first amdgcn, then hsaco
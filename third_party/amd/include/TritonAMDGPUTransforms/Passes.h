@@ -11,8 +11,6 @@ std::unique_ptr<Pass> createTritonAMDGPUPipelinePass(int numStages = 3,
                                                   int numCTAs = 1,
                                                   int computeCapability = 80);
 
-std::unique_ptr<Pass> createTritonAMDGPUStreamPipelinePass();
-
 std::unique_ptr<Pass>
 createTritonAMDGPUAccelerateMatmulPass(int matrixCoreVersion=0,
                                        int matrixInstructionSize=0);
@@ -38,6 +38,9 @@ public:
     assert(helper.isSupportedLayout() &&
            "Unexpected srcLayout in ReduceOpConversion");
     Location loc = op->getLoc();
+    if (!helper.isReduceWithinCTA())
+      return emitOptionalError(
+          loc, "cross-CTA reductions require thread block clusters");
 
     auto srcValues = unpackInputs(loc, op, adaptor, rewriter);
     std::map<SmallVector<unsigned>, SmallVector<Value>> accs;
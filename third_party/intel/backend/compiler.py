@@ -1,10 +1,10 @@
-from triton.backends.compiler import BaseBackend
+from triton.backends.compiler import BaseBackend, compile_step, get_compile_timer
 from triton._C.libtriton import ir, passes, llvm, intel
-from triton.backends.intel.driver import XPUUtils
 from dataclasses import dataclass
 import functools
 from typing import Any
 import hashlib
+import json
 import re
 import tempfile
 import signal
@@ -315,6 +315,19 @@ def _path_to_binary(binary: str):
     raise RuntimeError(f"Cannot find {binary}")
 
 
+@functools.lru_cache()
+def _spirv_dis_version():
+    """
+    The version of spirv-dis: the one setup.py recorded for the bundled binary,
+    or, for the binary `TRITON_SPIRV-DIS_PATH` selects, the one it reports.
+    """
+    recorded = Path(__file__).parent / "bin" / "spirv-dis.version"
+    if not os.environ.get("TRITON_SPIRV-DIS_PATH", "") and recorded.exists():
+        return recorded.read_text().strip()
+    version = subprocess.check_output([_path_to_binary("spirv-dis")[0], "--version"])
+    return version.decode("utf-8").strip()
+
+
 @functools.lru_cache()
 def ptx_get_version(cuda_version) -> int:
     '''
@@ -331,22 +344,189 @@ def ptx_get_version(cuda_version) -> int:
     raise RuntimeError("Triton only support CUDA 10.0 or higher")
 
 
+# SPIR-V extensions the driver lowers natively on every device arch.
+_SPIRV_EXTENSIONS_COMMON = (
+    "SPV_EXT_shader_atomic_float_add",
+    "SPV_EXT_shader_atomic_float_min_max",
+    "SPV_INTEL_arbitrary_precision_integers",
+    "SPV_INTEL_bfloat16_conversion",
+    "SPV_INTEL_cache_controls",
+    "SPV_INTEL_fp_fast_math_mode",
+    "SPV_INTEL_inline_assembly",
+    "SPV_INTEL_subgroups",
+    "SPV_INTEL_unstructured_loop_controls",
+    "SPV_INTEL_variable_length_array",
+    "SPV_KHR_bit_instructions",
+    "SPV_KHR_float_controls",
+    "SPV_KHR_no_integer_wrap_decoration",
+)
+
+
+@dataclass(frozen=True)
+class XPUTarget:
+    """
+    What the compiler lowers differently between Intel GPU archs.
+    """
+    # `device_arch` reported by the driver
+    arch: int
+    name: str
+    # sub-group sizes kernels can be compiled for
+    threads_per_warp: tuple
+    # shared local memory available to a work-group; it bounds the number of
+    # stages the pipeliner multi-buffers loads with. 0 means unknown.
+    shared_memory_size: int
+    # sub-groups an Xe core keeps resident: one per hardware thread of its
+    # vector engines. With `shared_memory_size` it bounds the work-groups per
+    # Xe core. 0 means unknown.
+    max_warps_per_core: int
+    # execution size (N) of the DPAS instruction, 0 without DPAS
+    dpas_execution_size: int
+    # 2D block loads, stores and prefetches
+    has_2d_block_io: bool
+    # 256-GRF mode
+    has_large_grf: bool
+    # SPIR-V extensions the driver lowers natively, which modules are
+    # restricted to unless TRITON_XPU_ALL_SPIRV_EXTENSIONS=1; `None` allows
+    # every extension known to the translator
+    spirv_extensions: tuple
+
+    @property
+    def supports_dpas_layout(self):
+        # the DPAS layouts map the N dimension to a 16-wide sub-group
+        return self.dpas_execution_size == 16
+
+
+_XPU_TARGETS = {
+    # Arc: 16 vector engines of 8 threads per Xe core, systolic arrays of
+    # execution size 8
+    0:
+    XPUTarget(arch=0, name="arc", threads_per_warp=(8, 16, 32), shared_memory_size=64 * 1024,
+              max_warps_per_core=128, dpas_execution_size=8, has_2d_block_io=False, has_large_grf=False,
+              spirv_extensions=_SPIRV_EXTENSIONS_COMMON),
+    # PVC: 8 vector engines of 8 threads per Xe core, 2D block IO and DPAS
+    1:
+    XPUTarget(arch=1, name="pvc", threads_per_warp=(16, 32), shared_memory_size=128 * 1024,
+              max_warps_per_core=64, dpas_execution_size=16, has_2d_block_io=True, has_large_grf=True,
+              spirv_extensions=_SPIRV_EXTENSIONS_COMMON + (
+                  "SPV_EXT_shader_atomic_float16_add",
+                  "SPV_INTEL_2d_block_io",
+                  "SPV_INTEL_joint_matrix",
+                  "SPV_INTEL_split_barrier",
+                  "SPV_INTEL_subgroup_matrix_multiply_accumulate",
+              )),
+}
+
+
+def get_xpu_target(arch: int) -> XPUTarget:
+    # Unknown archs get the portable lowering and no device limits
+    if arch in _XPU_TARGETS:
+        return _XPU_TARGETS[arch]
+    return XPUTarget(arch=arch, name="unknown", threads_per_warp=(16, 32), shared_memory_size=0,
+                     max_warps_per_core=0, dpas_execution_size=0, has_2d_block_io=False, has_large_grf=False,
+                     spirv_extensions=None)
+
+
+# Memory access granularity the coalescing pass sizes layouts for: sub-group
+# block reads/writes move at most 64 bits per lane, and both Arc and PVC have
+# 64-byte cache lines.
+_MAX_VECTOR_BITS = 64
+_CACHE_LINE_BYTES = 64
+
+
+def _supports_native_block_pointers(options, target):
+    return options.native_block_pointers and target.has_2d_block_io
+
+
+def make_pass_manager(context):
+    pm = ir.pass_manager(context)
+    pm.enable_debug()
+    timer = get_compile_timer()
+    if timer is not None:
+        pm.enable_timing(timer.pass_report_path)
+    return pm
+
+
 @dataclass(frozen=True)
 class XPUOptions:
     num_warps: int = 4
     num_ctas: int = 1
     num_stages: int = 2
     cluster_dims: tuple = (1, 1, 1)
-    threads_per_warp: int = 32
+    # sub-group size; `None` lets the compiler pick one per kernel
+    threads_per_warp: int = None
     ptx_version: int = None
     enable_warp_specialization: bool = False
     enable_persistent: bool = False
-    optimize_epilogue: bool = False
+    # store accumulators straight from the dot layout; `None` enables it on
+    # PVC, where DPAS tiles are written with block writes instead of going
+    # through SLM
+    optimize_epilogue: bool = None
     enable_fp_fusion: bool = True
+    # lower f32 exp/exp2/log2/rsqrt/sin/cos to the approximate native_* SPIR-V
+    # built-ins instead of the full-precision libdevice paths
+    enable_fast_math: bool = os.getenv("TRITON_XPU_FAST_MATH", "0") == "1"
+    # hold the values each work-item owns of blocked tensors in LLVM vectors
+    # rather than structs, so LLVM and the SPIR-V translator keep them packed
+    vector_tensors: bool = os.getenv("TRITON_INTEL_VECTOR_TENSORS", "0") == "1"
+    # combine the updates of the work-items of a sub-group to the same address
+    # before atomics whose result is unused, so that hot histogram bins see one
+    # atomic per sub-group
+    aggregate_atomics: bool = os.getenv("TRITON_INTEL_AGGREGATE_ATOMICS", "0") == "1"
+    # pass the i32, i64, f32 and f64 arguments of kernels taking at least this
+    # many of them in one struct, which the launcher sets at once and the
+    # kernel unpacks in its prologue; 0 passes every argument on its own
+    arg_packing_threshold: int = int(os.getenv("TRITON_INTEL_ARG_PACKING_THRESHOLD", "0"))
     allow_fp8e4nv: bool = False
+    native_float_atomic_minmax: bool = False
     max_num_imprecise_acc_default: bool = None
     extern_libs: dict = None
     debug: bool = False
+    # keep `tl.make_block_ptr` pointers and lower them to 2D block loads and
+    # stores instead of per-element pointer arithmetic (PVC only)
+    native_block_pointers: bool = os.getenv("TRITON_INTEL_NATIVE_BLOCK_PTR", "0") == "1"
+    # number of programs sharing the K loop of each GEMM output tile; the
+    # partial results are added atomically, so the output must be zeroed
+    # before each launch. Kernels the split does not apply to are unchanged.
+    split_k: int = 1
+    # the programs of the kernel synchronize with `tl.grid_sync`: launches
+    # check that they can all be resident on the device at once
+    cooperative: bool = False
+    # pointer arguments may be USM host memory (e.g. `XPUHostBuffer`), which
+    # the kernel reads and writes in place; on integrated GPUs this avoids
+    # copies, on discrete ones every access crosses the bus
+    host_memory: bool = False
+    # factor the innermost dot and reduction loops without a `tl.range(...,
+    # unroll=)` are unrolled by at the Triton IR level
+    unroll_factor: int = 1
+    # number of operations from which helpers only called under a condition,
+    # with scalar arguments and results, are kept out of line instead of
+    # inlined; 0 inlines every helper not marked `noinline`
+    outline_threshold: int = 64
+    # register file size: "default" (128 GRFs), "large" (256 GRFs, PVC only) or
+    # "auto", which switches to "large" at load time when a kernel spills.
+    # `None` selects "auto" on PVC and "default" elsewhere.
+    grf_mode: str = os.getenv("TRITON_INTEL_GRF_MODE", None)
+    # how loops feeding dots are pipelined: "multistage" copies `num_stages` - 1
+    # tiles ahead to SLM, "stream" loads the next tile into registers while
+    # the current one is computed from SLM (`num_stages` > 1 only enables it)
+    pipeline_strategy: str = os.getenv("TRITON_INTEL_PIPELINE_STRATEGY", "multistage")
+    # SLM bytes the pipelined buffers may use; `None` selects the device's SLM
+    # size and 0 disables the limit
+    shared_memory_size: int = None
+    spirv_extensions: tuple = None
+    spirv_allowed_intrinsics: tuple = ("llvm.genx.GenISA.", )
+    # "translator" (SPIRV-LLVM-Translator) or "llvm" (LLVM's SPIR-V backend)
+    spirv_backend: str = os.getenv("TRITON_XPU_SPIRV_BACKEND", "translator")
+    # LLVM optimization pipeline; `llvm_pipeline` (in `opt -passes=` syntax)
+    # replaces the default O3 pipeline
+    llvm_slp_vectorization: bool = False
+    llvm_loop_unrolling: bool = True
+    # optimization level of LLVM and of the IGC finalization, 0 to 3; the
+    # autotuner screens configs at a lower one before timing the fastest of
+    # them at 3
+    opt_level: int = 3
+    llvm_unroll_threshold: int = None
+    llvm_pipeline: str = ""
 
     def __post_init__(self):
         default_libdir = Path(__file__).parent / 'lib'
@@ -356,6 +536,16 @@ class XPUOptions:
         object.__setattr__(self, 'extern_libs', tuple(extern_libs.items()))
         assert self.num_warps > 0 and (self.num_warps & (self.num_warps - 1)) == 0, \
                "num_warps must be a power of 2"
+        assert self.spirv_backend in ("translator", "llvm"), \
+               f"unknown SPIR-V backend {self.spirv_backend}"
+        assert self.grf_mode in (None, "default", "large", "auto"), \
+               f"unknown GRF mode {self.grf_mode}"
+        assert self.pipeline_strategy in ("multistage", "stream"), \
+               f"unknown pipeline strategy {self.pipeline_strategy}"
+        assert self.split_k > 0, "split_k must be positive"
+        assert self.unroll_factor > 0, "unroll_factor must be positive"
+        assert self.outline_threshold >= 0, "outline_threshold must be non-negative"
+        assert self.opt_level in (0, 1, 2, 3), f"unknown optimization level {self.opt_level}"
 
     def hash(self):
         key = '_'.join([f'{name}-{val}' for name, val in self.__dict__.items()])
@@ -372,50 +562,104 @@ class XPUBackend(BaseBackend):
         super().__init__(target)
         self.capability = target[1]
         assert isinstance(self.capability, int)
+        self.xpu_target = get_xpu_target(self.capability)
 
     def parse_options(self, opts) -> Any:
         args = {k: opts[k] for k in XPUOptions.__dataclass_fields__.keys() if k in opts}
         args["allow_fp8e4nv"] = True
+        # SPV_EXT_shader_atomic_float_min_max
+        args["native_float_atomic_minmax"] = True
         args["max_num_imprecise_acc_default"] = 2**30 if self.capability == 90 else 0
+        target = self.xpu_target
+        threads_per_warp = args.get("threads_per_warp", None)
+        assert threads_per_warp is None or threads_per_warp in target.threads_per_warp, \
+               f"{target.name} does not support {threads_per_warp} threads per warp"
+        # the extensions the device lowers natively, unless
+        # TRITON_XPU_ALL_SPIRV_EXTENSIONS=1 allows every one the translator knows
+        if args.get("spirv_extensions", None) is None and os.getenv("TRITON_XPU_ALL_SPIRV_EXTENSIONS", "0") != "1":
+            args["spirv_extensions"] = target.spirv_extensions
+        if args.get("grf_mode", XPUOptions.grf_mode) is None:
+            args["grf_mode"] = "auto" if target.has_large_grf else "default"
+        if args.get("optimize_epilogue", None) is None:
+            args["optimize_epilogue"] = target.supports_dpas_layout
+        if args.get("shared_memory_size", None) is None:
+            args["shared_memory_size"] = target.shared_memory_size
         return XPUOptions(**args)
 
     def load_dialects(self, ctx):
         intel.load_dialects(ctx)
 
+    def stage_options(self):
+        # `num_warps` is only read by `tl.extra.cuda` during code generation
+        ttgir = ("num_warps", "num_ctas", "num_stages", "cluster_dims", "threads_per_warp",
+                 "enable_warp_specialization", "optimize_epilogue", "native_block_pointers", "pipeline_strategy",
+                 "shared_memory_size")
+        llir = ("vector_tensors", "aggregate_atomics", "arg_packing_threshold", "extern_libs", "llvm_slp_vectorization",
+                "llvm_loop_unrolling", "llvm_unroll_threshold", "llvm_pipeline", "opt_level")
+        # `grf_mode` only changes how the driver builds the module, and
+        # `cooperative` and `host_memory` how the kernel is launched
+        spv = ("spirv_extensions", "spirv_allowed_intrinsics", "spirv_backend", "grf_mode", "cooperative",
+               "host_memory")
+        return {
+            **{name: "ttgir"
+               for name in ttgir},
+            **{name: "llir"
+               for name in llir},
+            **{name: "spv"
+               for name in spv},
+        }
+
     @staticmethod
     def make_ttir(mod, metadata, opt):
-        pm = ir.pass_manager(mod.context)
-        pm.enable_debug()
+        pm = make_pass_manager(mod.context)
+        if opt.outline_threshold > 0:
+            passes.ttir.add_outline_cold_calls(pm, opt.outline_threshold)
         passes.common.add_inliner(pm)
         passes.ttir.add_combine(pm)
         passes.common.add_canonicalizer(pm)
         passes.ttir.add_reorder_broadcast(pm)
+        if opt.split_k > 1:
+            passes.ttir.add_split_k(pm, opt.split_k)
+        passes.ttir.add_hoist_pointer_offsets(pm)
+        passes.ttir.add_hoist_invariant_loads(pm)
+        passes.ttir.add_loop_unroll(pm, opt.unroll_factor)
+        passes.ttir.add_int_range_optimize(pm)
         passes.common.add_cse(pm)
         passes.common.add_licm(pm)
+        passes.ttir.add_specialize_calls(pm)
         passes.common.add_symbol_dce(pm)
         pm.run(mod)
+        # the launcher multiplies the third grid dimension by the split
+        metadata["split_k"] = mod.get_int_attr("tt.split-k") or 1
         return mod
 
     @staticmethod
-    def make_ttgir(mod, metadata, opt, capability):
+    def make_ttgir(mod, metadata, opt, target):
+        capability = target.arch
         cluster_info = intel.ClusterInfo()
         if opt.cluster_dims is not None:
             cluster_info.clusterDimX = opt.cluster_dims[0]
             cluster_info.clusterDimY = opt.cluster_dims[1]
             cluster_info.clusterDimZ = opt.cluster_dims[2]
+        threads_per_warp = opt.threads_per_warp
+        if threads_per_warp is None:
+            dot_threads_per_warp = target.dpas_execution_size if target.supports_dpas_layout else 0
+            threads_per_warp = intel.select_threads_per_warp(mod, dot_threads_per_warp, opt.num_warps)
         # TTIR -> TTGIR
-        pm = ir.pass_manager(mod.context)
-        pm.enable_debug()
-        passes.ttir.add_convert_to_ttgpuir(pm, opt.num_warps, opt.threads_per_warp, opt.num_ctas, capability)
+        pm = make_pass_manager(mod.context)
+        passes.ttir.add_convert_to_ttgpuir(pm, opt.num_warps, threads_per_warp, opt.num_ctas, capability)
         # optimize TTGIR
-        passes.ttgpuir.add_coalesce(pm)
+        intel.passes.ttgpuir.add_coalesce(pm, _MAX_VECTOR_BITS, _CACHE_LINE_BYTES)
         # TODO(Qingyi): Move PlanCTAPass to the front of CoalescePass
         intel.passes.ttnvgpuir.add_plan_cta(pm, cluster_info)
-        intel.passes.ttgpuir.add_rewrite_tensor_pointer(pm, capability)
+        keep_block_pointers = _supports_native_block_pointers(opt, target)
+        intel.passes.ttgpuir.add_rewrite_tensor_pointer(pm, capability, keep_block_pointers)
+        # fold the bounds checks and narrow the 64-bit offsets it generates
+        passes.ttir.add_int_range_optimize(pm)
         intel.passes.ttnvgpuir.add_plan_cta(pm, cluster_info)
         passes.ttgpuir.add_remove_layout_conversions(pm)
         passes.ttgpuir.add_optimize_thread_locality(pm)
-        passes.ttgpuir.add_accelerate_matmul(pm, capability)
+        intel.passes.ttgpuir.add_accelerate_matmul(pm, capability, target.supports_dpas_layout)
         passes.ttgpuir.add_remove_layout_conversions(pm)
         if opt.optimize_epilogue:
             passes.ttgpuir.add_optimize_epilogue(pm)
@@ -424,15 +668,13 @@ class XPUBackend(BaseBackend):
         # `num_warps` does not mean the total number of warps of a CTA when
         # warp specialization is enabled.
         # it's the responsibility of the compiler to figure out the exact
-        # `num_warps` to use.
-        # TODO: support the case where `num_warps` from user is not 4.
+        # `num_warps` to use: each agent gets the user's `num_warps` warps.
         ws_enabled = False
-        if capability // 10 >= 9 and opt.enable_warp_specialization and opt.num_warps == 4:
+        if capability // 10 >= 9 and opt.enable_warp_specialization and opt.num_warps in (4, 8, 16):
             intel.passes.ttnvgpuir.add_wsfeasibility_checking(pm, capability)
             pm.run(mod)
             ws_enabled = intel.passes.ttnvgpuir.is_ws_supported(mod)
-            pm = ir.pass_manager(mod.context)
-            pm.enable_debug()
+            pm = make_pass_manager(mod.context)
         metadata["ws_enabled"] = ws_enabled
         if ws_enabled:
             intel.passes.ttnvgpuir.add_wsdecomposing(pm, capability)
@@ -441,16 +683,24 @@ class XPUBackend(BaseBackend):
             intel.passes.ttnvgpuir.add_wsmaterialization(pm, capability)
             passes.common.add_licm(pm)
             passes.common.add_cse(pm)
+        elif opt.pipeline_strategy == "stream":
+            if opt.num_stages > 1:
+                passes.ttgpuir.add_stream_pipeline(pm)
+                passes.common.add_canonicalizer(pm)
         else:
-            passes.ttgpuir.add_pipeline(pm, opt.num_stages, opt.num_warps, opt.num_ctas, capability)
+            # Block pointer loads kept for 2D block IO are pipelined with
+            # prefetches rather than copies through SLM
+            intel.passes.ttgpuir.add_pipeline(pm, opt.num_stages, opt.num_warps, opt.num_ctas, capability,
+                                              keep_block_pointers, opt.shared_memory_size)
         intel.passes.ttnvgpuir.add_materialize_load_store(pm, opt.num_warps, capability)
-        if capability // 10 <= 8:
-            passes.ttgpuir.add_prefetch(pm)
+        passes.ttgpuir.add_prefetch(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm)
         passes.ttgpuir.add_remove_layout_conversions(pm)
         passes.ttgpuir.add_reduce_data_duplication(pm)
         intel.passes.ttnvgpuir.add_wsfixup_missing_attrs(pm)
-        passes.ttgpuir.add_reorder_instructions(pm)
+        # Schedule loop bodies for the 128 registers per lane of the default
+        # GRF mode; "auto" only switches to large GRFs when a kernel spills
+        intel.passes.ttgpuir.add_reorder_instructions(pm, True, 128)
         passes.common.add_cse(pm)
         passes.common.add_symbol_dce(pm)
         if capability // 10 >= 9:
@@ -458,11 +708,15 @@ class XPUBackend(BaseBackend):
         intel.passes.ttnvgpuir.add_wsfixup_missing_attrs(pm)
         passes.common.add_canonicalizer(pm)
         pm.run(mod)
+        # Number of stages the pipeliner could fit in SLM; configurations asking
+        # for more stages compile to the same kernel
+        metadata["num_stages_used"] = mod.get_int_attr("triton_gpu.num-stages")
         metadata["cluster_dims"] = (cluster_info.clusterDimX, cluster_info.clusterDimY, cluster_info.clusterDimZ)
         return mod
 
     @staticmethod
-    def make_llir(src, metadata, options, capability):
+    def make_llir(src, metadata, options, target):
+        capability = target.arch
         # warp-specialization mutates num_warps
         num_warp_groups = src.get_int_attr("triton_gpu.num-warp-groups-per-cta")
         if num_warp_groups is not None:
@@ -472,58 +726,92 @@ class XPUBackend(BaseBackend):
         mod = src
         # TritonGPU -> LLVM-IR (MLIR)
         tma_infos = intel.TMAInfos()
-        pm = ir.pass_manager(mod.context)
-        pm.enable_debug()
+        pm = make_pass_manager(mod.context)
         passes.ttgpuir.add_decompose_unsupported_conversions(pm)
         passes.convert.add_scf_to_cf(pm)
         passes.convert.add_index_to_llvmir(pm)
         passes.ttgpuir.add_allocate_shared_memory(pm)
-        intel.passes.ttgpuir.add_to_llvmir(pm, capability, tma_infos)
+        pm.run(mod)
+        # Report the shared memory buffers while they are still visible
+        allocation = passes.analysis.allocation(mod)
+        report = allocation.get_shared_memory_report(target.shared_memory_size, target.max_warps_per_core)
+        metadata["shared_report"] = json.loads(report)
+        pm = make_pass_manager(mod.context)
+        intel.passes.ttgpuir.add_to_llvmir(pm, capability, tma_infos, options.enable_fast_math, options.vector_tensors,
+                                           options.aggregate_atomics)
         if metadata["ws_enabled"]:
             passes.common.add_licm(pm)
             passes.common.add_cse(pm)
         intel.passes.ttnvgpuir.add_nvgpu_to_llvm(pm)
         passes.convert.add_arith_to_llvmir(pm)
+        if options.arg_packing_threshold > 0:
+            intel.passes.ttgpuir.add_pack_kernel_args(pm, options.arg_packing_threshold)
         passes.common.add_canonicalizer(pm)
         passes.common.add_cse(pm)
         passes.common.add_symbol_dce(pm)
         if os.environ.get("TRITON_DISABLE_LINE_INFO", "0") == "0":
             passes.llvmir.add_di_scope(pm)
         pm.run(mod)
+        metadata["shared"] = src.get_int_attr("triton_gpu.shared")
+        # the `tl.global_scratch` buffers, which the launcher allocates
+        metadata["global_scratch_size"] = src.get_int_attr("triton_gpu.global_scratch_memory_size") or 0
+        metadata["global_scratch_align"] = src.get_int_attr("triton_gpu.global_scratch_memory_alignment") or 1
+        # the positions of the kernel arguments passed in one struct, in order
+        metadata["packed_args"] = src.get_int_array_attr("triton_gpu.packed_args") or []
         # LLVM-IR (MLIR) -> LLVM-IR (LLVM)
         llvm.init_targets()
         context = llvm.context()
         llvm_mod = llvm.to_module(mod, context)
+        # the MLIR module is not needed anymore while LLVM optimizes
+        src.clear()
         llvm.set_spv_target_triple(llvm_mod)
         if options.extern_libs:
             for name, path in options.extern_libs:
                 llvm.link_extern_lib(llvm_mod, path)
-        llvm.optimize_module(llvm_mod, llvm.OPTIMIZE_O3)
+        with compile_step("optimize_module"):
+            llvm.optimize_module(llvm_mod, getattr(llvm, f"OPTIMIZE_O{options.opt_level}"),
+                                 slp_vectorization=options.llvm_slp_vectorization,
+                                 loop_unrolling=options.llvm_loop_unrolling,
+                                 unroll_threshold=options.llvm_unroll_threshold, pipeline=options.llvm_pipeline,
+                                 target_triple="spirv64-unknown-unknown")
         # Get some metadata
         if len(tma_infos) > 0:
             metadata["tensormaps_info"] = parse_tma_info(tma_infos, metadata["ids_of_folded_args"])
             for i, _ in enumerate(metadata["tensormaps_info"]):
                 metadata["tensormaps_info"][i].ids_of_folded_args = metadata["ids_of_folded_args"]
         metadata["ids_of_tensormaps"] = get_ids_of_tensormaps(metadata.get("tensormaps_info", None))
-        metadata["shared"] = src.get_int_attr("triton_gpu.shared")
-        ret = str(llvm_mod)
-        del llvm_mod
-        del context
-        return ret
+        # the module itself is the output of the stage: the cache prints it to
+        # its file without a copy of the whole text, and the spv stage
+        # translates it without parsing that text again
+        return llvm_mod
 
     @staticmethod
-    def make_spv(src, metadata):
-        ret, name = llvm.translate_to_spirv(src)
+    def spirv_options(options):
+        extensions = options.spirv_extensions
+        return dict(extensions=None if extensions is None else list(extensions),
+                    allowed_intrinsics=list(options.spirv_allowed_intrinsics),
+                    use_llvm_backend=options.spirv_backend == "llvm")
+
+    @staticmethod
+    def make_spv(src, metadata, options):
+        with compile_step("translate_to_spirv"):
+            # the textual IR when it was overridden or loaded from the cache
+            if isinstance(src, str):
+                ret, name = llvm.translate_to_spirv(src, **XPUBackend.spirv_options(options))
+            else:
+                ret, name = llvm.translate_module_to_spirv(src, **XPUBackend.spirv_options(options))
         metadata["name"] = name
         return ret
 
+    def supports_native_block_pointers(self, options):
+        return _supports_native_block_pointers(options, self.xpu_target)
+
     def add_stages(self, stages, options):
         stages["ttir"] = lambda src, metadata: self.make_ttir(src, metadata, options)
-        stages["ttgir"] = lambda src, metadata: self.make_ttgir(src, metadata, options, self.capability)
-        stages["llir"] = lambda src, metadata: self.make_llir(src, metadata, options, self.capability)
-        stages["spv"] = lambda src, metadata: self.make_spv(src, metadata)
+        stages["ttgir"] = lambda src, metadata: self.make_ttgir(src, metadata, options, self.xpu_target)
+        stages["llir"] = lambda src, metadata: self.make_llir(src, metadata, options, self.xpu_target)
+        stages["spv"] = lambda src, metadata: self.make_spv(src, metadata, options)
 
     @functools.lru_cache()
     def hash(self):
-        version = subprocess.check_output([_path_to_binary("spirv-dis")[0], "--version"])
-        return f'{version}-{self.capability}'
+        return f'{_spirv_dis_version()}-{self.capability}'
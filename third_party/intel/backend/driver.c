@@ -6,11 +6,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cerrno>
 #include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+#include <map>
+#include <mutex>
 #include <string>
 #include <sycl/sycl.hpp>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -20,6 +27,8 @@
 #include <Python.h>
 #include <numpy/arrayobject.h>
 
+#include "ze_module.h"
+
 typedef struct l0_resc_handles {
   ze_context_handle_t context;
   ze_device_handle_t device;
@@ -27,10 +36,16 @@ typedef struct l0_resc_handles {
   ze_command_list_handle_t cmd_list;
 } l0_resc_handles;
 
+// L0 handles of every sycl queue seen so far. Each queue keeps its own
+// context, device and command queue/list, so queues created on different
+// devices (or different tiles of the same device) do not alias each other.
+// All accesses go through getL0Handles, which serializes them.
 std::unordered_map<sycl::queue, l0_resc_handles> sycl_queue_map;
-static ze_context_handle_t context = {nullptr};
+static std::mutex sycl_queue_map_mutex;
+// Context to use for each device when only a device id is available.
+static std::unordered_map<ze_device_handle_t, ze_context_handle_t>
+    device_context_map;
 static ze_driver_handle_t driverHandle = {nullptr};
-static ze_event_pool_handle_t eventPoolHandle = {nullptr};
 
 static std::vector<ze_device_handle_t> devices;
 static std::vector<std::pair<sycl::device, ze_device_handle_t>>
@@ -62,7 +77,7 @@ static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
   if (!PyArg_ParseTuple(args, "i", &device_id))
     return NULL;
 
-  if (device_id > sycl_l0_device_list.size()) {
+  if (device_id < 0 || device_id >= sycl_l0_device_list.size()) {
     std::cerr << "Device is not found " << std::endl;
     return NULL;
   }
@@ -79,6 +94,8 @@ static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
   int multiprocessor_count =
       device_properties.numSlices * device_properties.numSubslicesPerSlice;
   int sm_clock_rate = device_properties.coreClockRate;
+  int num_eus_per_subslice = device_properties.numEUsPerSubslice;
+  int eu_simd_width = device_properties.physicalEUSimdWidth;
 
   // Extract triton::gpu::intel::DeviceArch from pci_device_id
   // https://dgpu-docs.intel.com/devices/hardware-table.html
@@ -120,12 +137,32 @@ static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
 
   delete[] pMemoryProperties;
 
-  return Py_BuildValue("{s:i, s:i, s:i, s:i, s:i, s:i, s:i, s:O}", "max_shared_mem",
+  std::string driver_version =
+      device.first.get_info<sycl::info::device::driver_version>();
+
+  uint64_t l3_cache_size =
+      device.first.get_info<sycl::info::device::global_mem_cache_size>();
+
+  // duration of a kernel timestamp tick, in nanoseconds
+  uint64_t timer_resolution = device_properties.timerResolution;
+  int timestamp_valid_bits = device_properties.kernelTimestampValidBits;
+
+  // tiles (sub-devices) the device is made of; with the COMPOSITE device
+  // hierarchy, kernels are spread over them by implicit scaling
+  uint32_t num_tiles = 0;
+  zeDeviceGetSubDevices(phDevice, &num_tiles, nullptr);
+  num_tiles = std::max<uint32_t>(num_tiles, 1);
+
+  return Py_BuildValue("{s:i, s:i, s:i, s:i, s:i, s:i, s:i, s:O, s:i, s:s, s:K, s:i, s:K, s:i, s:i, s:I}", "max_shared_mem",
                        max_shared_mem, "multiprocessor_count",
                        multiprocessor_count, "sm_clock_rate", sm_clock_rate,
                        "mem_clock_rate", mem_clock_rate, "mem_bus_width",
                        mem_bus_width, "device_arch", gpu_arch,
-                       "max_group_size", max_group_size, "subgroup_sizes", subgroup_sizes);
+                       "max_group_size", max_group_size, "subgroup_sizes", subgroup_sizes,
+                       "device_id", pci_device_id, "driver_version", driver_version.c_str(),
+                       "timer_resolution", timer_resolution, "timestamp_valid_bits", timestamp_valid_bits,
+                       "l3_cache_size", l3_cache_size, "num_eus_per_subslice", num_eus_per_subslice,
+                       "eu_simd_width", eu_simd_width, "num_tiles", num_tiles);
 }
 
 /*Sycl code Start*/
@@ -138,34 +175,22 @@ bool getBoolEnv(const std::string &env) {
 }
 
 ze_module_handle_t create_module(ze_context_handle_t context,
-                                 ze_device_handle_t device,
-                                 uint32_t *binary_ptr, size_t binary_size) {
-  const char *build_flags = "";
-  const ze_module_format_t format = ZE_MODULE_FORMAT_IL_SPIRV;
+                                 ze_device_handle_t device, const char *name,
+                                 uint8_t *binary_ptr, size_t binary_size,
+                                 bool is_native = false,
+                                 const char *build_flags = "") {
+  // A native binary has already been finalized by IGC for this device, so
+  // zeModuleCreate only needs to load it.
+  const ze_module_format_t format =
+      is_native ? ZE_MODULE_FORMAT_NATIVE : ZE_MODULE_FORMAT_IL_SPIRV;
   ze_module_desc_t module_description = {};
   module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
   module_description.format = format;
-  module_description.inputSize =
-      static_cast<uint32_t>(binary_size * sizeof(uint32_t));
-  module_description.pInputModule = (uint8_t *)binary_ptr;
+  module_description.inputSize = binary_size;
+  module_description.pInputModule = binary_ptr;
   module_description.pBuildFlags = build_flags;
-  ze_module_build_log_handle_t buildlog;
   ze_module_handle_t module;
-  auto context_initial = context;
-  auto device_initial = device;
-  auto error_no = ZE_RESULT_SUCCESS;
-  error_no =
-      zeModuleCreate(context, device, &module_description, &module, &buildlog);
-  if (error_no != ZE_RESULT_SUCCESS) {
-    size_t szLog = 0;
-    ZE_CHECK(zeModuleBuildLogGetString(buildlog, &szLog, nullptr));
-    char *strLog = (char *)malloc(szLog);
-    ZE_CHECK(zeModuleBuildLogGetString(buildlog, &szLog, strLog));
-    std::cerr << "L0 build module failed. Log: " << strLog << std::endl;
-    free(strLog);
-    ZE_CHECK(zeModuleBuildLogDestroy(buildlog));
-  }
-  ZE_CHECK(error_no);
+  ZE_CHECK(createZeModule(context, device, &module_description, name, &module));
   return module;
 }
 
@@ -205,14 +230,51 @@ ze_kernel_handle_t create_function(ze_module_handle_t module,
   return create_function(module, ZE_KERNEL_FLAG_FORCE_RESIDENCY, func_name);
 }
 
-std::vector<std::unique_ptr<sycl::kernel>> compiled_kernels;
+// Kernels and kernel bundles handed out to Python as raw pointers. They are
+// owned here until unload_binary is called, which releases the underlying L0
+// kernel and module once no SYCL object refers to them anymore.
+using kernel_bundle_t = sycl::kernel_bundle<sycl::bundle_state::executable>;
+static std::unordered_map<sycl::kernel *, std::unique_ptr<sycl::kernel>>
+    loaded_kernels;
+static std::unordered_map<kernel_bundle_t *, std::unique_ptr<kernel_bundle_t>>
+    loaded_bundles;
+
+static PyObject *buildKernelHandles(const kernel_bundle_t &mod,
+                                    const sycl::kernel &fun, int32_t n_regs,
+                                    int32_t n_spills) {
+  auto k = std::make_unique<sycl::kernel>(fun);
+  auto kb = std::make_unique<kernel_bundle_t>(mod);
+  PyObject *ret = Py_BuildValue("(KKii)", (uint64_t)kb.get(),
+                                (uint64_t)k.get(), n_regs, n_spills);
+  if (getBoolEnv("MLIR_ENABLE_DUMP")) {
+    std::cout << "compiled kernel ptr: " << k.get() << std::endl;
+    std::cout << "total kernels:" << loaded_kernels.size() + 1 << std::endl;
+  }
+  loaded_kernels.emplace(k.get(), std::move(k));
+  loaded_bundles.emplace(kb.get(), std::move(kb));
+  return ret;
+}
+
+static PyObject *unloadBinary(PyObject *self, PyObject *args) {
+  uint64_t bundle_ptr;
+  uint64_t kernel_ptr;
+  if (!PyArg_ParseTuple(args, "KK", &bundle_ptr, &kernel_ptr))
+    return NULL;
+  loaded_kernels.erase(reinterpret_cast<sycl::kernel *>(kernel_ptr));
+  loaded_bundles.erase(reinterpret_cast<kernel_bundle_t *>(bundle_ptr));
+  Py_RETURN_NONE;
+}
 
 static PyObject *loadSyclBinary(PyObject *self, PyObject *args) {
   const char *name;
   int shared;
   PyObject *py_bytes;
   PyObject *py_dev;
-  if (!PyArg_ParseTuple(args, "sSiO", &name, &py_bytes, &shared, &py_dev)) {
+  int is_native = 0;
+  // IGC options, e.g. -ze-opt-large-register-file; ignored for native binaries
+  const char *build_flags = "";
+  if (!PyArg_ParseTuple(args, "sSiO|ps", &name, &py_bytes, &shared, &py_dev,
+                        &is_native, &build_flags)) {
     std::cerr << "loadSyclBinary arg parse failed" << std::endl;
     return NULL;
   }
@@ -224,50 +286,194 @@ static PyObject *loadSyclBinary(PyObject *self, PyObject *args) {
 
   sycl::device device = *(static_cast<sycl::device *>(pdevID));
   std::string kernel_name = name;
+  // Native binaries are not necessarily a multiple of the SPIR-V word size,
+  // so the module is described in bytes.
   size_t binary_size = PyBytes_Size(py_bytes);
-  binary_size = binary_size / sizeof(uint32_t);
-
-  uint32_t *binary_ptr = (uint32_t *)PyBytes_AsString(py_bytes);
-  ;
+  uint8_t *binary_ptr = (uint8_t *)PyBytes_AsString(py_bytes);
   auto ctx = device.get_platform().ext_oneapi_get_default_context();
   auto l0_device =
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(device);
   auto l0_context = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(ctx);
-  auto l0_module =
-      create_module(l0_context, l0_device, binary_ptr, binary_size);
+  auto l0_module = create_module(l0_context, l0_device, name, binary_ptr,
+                                 binary_size, is_native, build_flags);
+  if (PyErr_Occurred())
+    return NULL;
   auto l0_kernel = create_function(l0_module, kernel_name);
-
   if (PyErr_Occurred()) {
-    // check for errors from module/kernel creation
+    // check for errors from kernel creation
+    zeModuleDestroy(l0_module);
     return NULL;
   }
 
   ze_kernel_properties_t props;
   props.stype = ZE_STRUCTURE_TYPE_KERNEL_PROPERTIES;
   props.pNext = nullptr;
-  ZE_CHECK(zeKernelGetProperties(l0_kernel, &props));
+  ze_result_t props_ret = zeKernelGetProperties(l0_kernel, &props);
+  if (props_ret != ZE_RESULT_SUCCESS) {
+    zeKernelDestroy(l0_kernel);
+    zeModuleDestroy(l0_module);
+    ZE_CHECK(props_ret);
+  }
   n_spills = props.spillMemSize;
+  // From here on, the L0 handles are owned by the SYCL objects.
   auto mod = sycl::make_kernel_bundle<sycl::backend::ext_oneapi_level_zero,
                                       sycl::bundle_state::executable>(
       {l0_module, sycl::ext::oneapi::level_zero::ownership::transfer}, ctx);
   auto fun = sycl::make_kernel<sycl::backend::ext_oneapi_level_zero>(
       {mod, l0_kernel, sycl::ext::oneapi::level_zero::ownership::transfer},
       ctx);
-  compiled_kernels.push_back(std::make_unique<sycl::kernel>(fun));
-  sycl::kernel *ptr = compiled_kernels[compiled_kernels.size() - 1].get();
-  if (getBoolEnv("MLIR_ENABLE_DUMP")) {
-    std::cout << "compiled kernel ptr: " << ptr << std::endl;
-    std::cout << "total kernels:" << compiled_kernels.size() << std::endl;
-    for (auto &k : compiled_kernels) {
-      std::cout << "  kernel:"
-                << k->get_info<sycl::info::kernel::function_name>() << " @"
-                << k.get() << std::endl;
+  return buildKernelHandles(mod, fun, n_regs, n_spills);
+}
+
+// Build several SPIR-V modules into a single L0 module so that the module
+// creation (and IGC invocation) is paid once for the whole batch. Kernel
+// names must be unique across the batch.
+static PyObject *loadSyclBinaries(PyObject *self, PyObject *args) {
+  PyObject *py_names;
+  PyObject *py_binaries;
+  int shared;
+  PyObject *py_dev;
+  if (!PyArg_ParseTuple(args, "O!O!iO", &PyList_Type, &py_names, &PyList_Type,
+                        &py_binaries, &shared, &py_dev)) {
+    std::cerr << "loadSyclBinaries arg parse failed" << std::endl;
+    return NULL;
+  }
+  Py_ssize_t count = PyList_Size(py_names);
+  if (count != PyList_Size(py_binaries) || count == 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "expected the same non-zero number of names and binaries");
+    return NULL;
+  }
+  void *pdevID = PyCapsule_GetPointer(py_dev, PyCapsule_GetName(py_dev));
+  if (pdevID == nullptr)
+    return NULL;
+  sycl::device device = *(static_cast<sycl::device *>(pdevID));
+
+  std::vector<size_t> input_sizes(count);
+  std::vector<const uint8_t *> input_modules(count);
+  std::vector<const char *> build_flags(count, "");
+  std::vector<const ze_module_constants_t *> constants(count, nullptr);
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    PyObject *py_bytes = PyList_GetItem(py_binaries, i);
+    if (!PyBytes_Check(py_bytes)) {
+      PyErr_SetString(PyExc_TypeError, "binaries must be bytes");
+      return NULL;
+    }
+    input_sizes[i] = PyBytes_Size(py_bytes);
+    input_modules[i] = (const uint8_t *)PyBytes_AsString(py_bytes);
+  }
+
+  ze_module_program_exp_desc_t program_description = {};
+  program_description.stype = ZE_STRUCTURE_TYPE_MODULE_PROGRAM_EXP_DESC;
+  program_description.count = static_cast<uint32_t>(count);
+  program_description.inputSizes = input_sizes.data();
+  program_description.pInputModules = input_modules.data();
+  program_description.pBuildFlags = build_flags.data();
+  program_description.pConstants = constants.data();
+
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+  module_description.pNext = &program_description;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+
+  auto ctx = device.get_platform().ext_oneapi_get_default_context();
+  auto l0_device =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(device);
+  auto l0_context = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(ctx);
+  ze_module_handle_t l0_module;
+  ZE_CHECK(createZeModule(l0_context, l0_device, &module_description, "batch",
+                          &l0_module));
+
+  std::vector<ze_kernel_handle_t> l0_kernels;
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    const char *name = PyUnicode_AsUTF8(PyList_GetItem(py_names, i));
+    ze_kernel_handle_t l0_kernel =
+        name ? create_function(l0_module, name) : nullptr;
+    if (PyErr_Occurred()) {
+      for (auto created : l0_kernels)
+        zeKernelDestroy(created);
+      zeModuleDestroy(l0_module);
+      return NULL;
+    }
+    l0_kernels.push_back(l0_kernel);
+  }
+
+  auto mod = sycl::make_kernel_bundle<sycl::backend::ext_oneapi_level_zero,
+                                      sycl::bundle_state::executable>(
+      {l0_module, sycl::ext::oneapi::level_zero::ownership::transfer}, ctx);
+  PyObject *ret = PyList_New(count);
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    ze_kernel_properties_t props;
+    props.stype = ZE_STRUCTURE_TYPE_KERNEL_PROPERTIES;
+    props.pNext = nullptr;
+    ze_result_t props_ret = zeKernelGetProperties(l0_kernels[i], &props);
+    if (props_ret != ZE_RESULT_SUCCESS) {
+      Py_DECREF(ret);
+      ZE_CHECK(props_ret);
     }
+    int32_t n_regs = 0;
+    int32_t n_spills = props.spillMemSize;
+    auto fun = sycl::make_kernel<sycl::backend::ext_oneapi_level_zero>(
+        {mod, l0_kernels[i],
+         sycl::ext::oneapi::level_zero::ownership::transfer},
+        ctx);
+    PyList_SetItem(ret, i, buildKernelHandles(mod, fun, n_regs, n_spills));
+  }
+  return ret;
+}
+
+static PyObject *getNativeBinary(PyObject *self, PyObject *args) {
+  uint64_t bundle_ptr;
+  if (!PyArg_ParseTuple(args, "K", &bundle_ptr))
+    return NULL;
+  auto *kb = reinterpret_cast<
+      sycl::kernel_bundle<sycl::bundle_state::executable> *>(bundle_ptr);
+  if (kb == nullptr) {
+    PyErr_SetString(PyExc_ValueError, "invalid kernel bundle");
+    return NULL;
+  }
+  std::vector<ze_module_handle_t> l0_modules =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(*kb);
+  if (l0_modules.size() != 1) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "expected exactly one L0 module per kernel bundle");
+    return NULL;
+  }
+  size_t size = 0;
+  ZE_CHECK(zeModuleGetNativeBinary(l0_modules[0], &size, nullptr));
+  PyObject *py_bytes = PyBytes_FromStringAndSize(nullptr, size);
+  if (py_bytes == NULL)
+    return NULL;
+  ze_result_t ret = zeModuleGetNativeBinary(
+      l0_modules[0], &size, (uint8_t *)PyBytes_AsString(py_bytes));
+  if (ret != ZE_RESULT_SUCCESS) {
+    Py_DECREF(py_bytes);
+    ZE_CHECK(ret);
+  }
+  return py_bytes;
+}
+// The number of work-groups of `num_warps` sub-groups of `threads_per_warp`
+// work-items of a loaded kernel that can be resident on the device at once,
+// which kernels synchronizing all their programs must not exceed.
+static PyObject *getMaxCooperativePrograms(PyObject *self, PyObject *args) {
+  uint64_t kernel_ptr;
+  int num_warps;
+  int threads_per_warp;
+  if (!PyArg_ParseTuple(args, "Kii", &kernel_ptr, &num_warps,
+                        &threads_per_warp))
+    return NULL;
+  auto *kernel = reinterpret_cast<sycl::kernel *>(kernel_ptr);
+  if (kernel == nullptr) {
+    PyErr_SetString(PyExc_ValueError, "invalid kernel");
+    return NULL;
   }
-  sycl::kernel *k = new sycl::kernel(*ptr);
-  sycl::kernel_bundle<sycl::bundle_state::executable> *kb =
-      new sycl::kernel_bundle<sycl::bundle_state::executable>(mod);
-  return Py_BuildValue("(KKii)", (uint64_t)kb, (uint64_t)k, n_regs, n_spills);
+  auto l0_kernel =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(*kernel);
+  // the count depends on the group size, which launches set again anyway
+  ZE_CHECK(zeKernelSetGroupSize(l0_kernel, num_warps * threads_per_warp, 1, 1));
+  uint32_t count = 0;
+  ZE_CHECK(zeKernelSuggestMaxCooperativeGroupCount(l0_kernel, &count));
+  return Py_BuildValue("I", count);
 }
 /*Sycl code end*/
 
@@ -281,12 +487,24 @@ static PyObject *loadBinary(PyObject *self, PyObject *args) {
     return NULL;
   }
 
-  if (device_id > devices.size()) {
+  if (device_id < 0 || device_id >= devices.size()) {
     std::cerr << "Device ID not found: " << device_id << std::endl;
     return NULL;
   }
 
   ze_device_handle_t device = devices[device_id];
+  ze_context_handle_t context = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(sycl_queue_map_mutex);
+    auto it = device_context_map.find(device);
+    if (it != device_context_map.end())
+      context = it->second;
+  }
+  if (context == nullptr) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "no L0 context has been initialized for this device");
+    return NULL;
+  }
 
   int32_t n_regs = 0;
   int32_t n_spills = 0;
@@ -312,17 +530,19 @@ static PyObject *loadBinary(PyObject *self, PyObject *args) {
                        n_spills);
 }
 
+// Must be called with sycl_queue_map_mutex held.
 bool update(sycl::queue sycl_queue) {
   // Get l0-context
   auto sycl_context = sycl_queue.get_context();
   ze_context_handle_t hCtxt =
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(sycl_context);
-  // Get l0-device
-  std::vector<sycl::device> sycl_devices = sycl_context.get_devices();
+  // Get l0-device of the queue, which is not necessarily the first device of
+  // its context.
   ze_device_handle_t hDev =
-      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(sycl_devices[0]);
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+          sycl_queue.get_device());
   // Get l0-queue
-  bool immediate_cmd_list = false;
+  l0_resc_handles handles = {};
   std::variant<ze_command_queue_handle_t, ze_command_list_handle_t> queue_var =
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(sycl_queue);
   auto l0_queue = std::get_if<ze_command_queue_handle_t>(&queue_var);
@@ -331,37 +551,51 @@ bool update(sycl::queue sycl_queue) {
     if (imm_cmd_list == nullptr) {
       return false;
     }
-    immediate_cmd_list = true;
-    sycl_queue_map[sycl_queue].cmd_list = *imm_cmd_list;
+    handles.cmd_list = *imm_cmd_list;
+  } else {
+    handles.queue = *l0_queue;
   }
-  sycl_queue_map[sycl_queue].context = hCtxt;
-  sycl_queue_map[sycl_queue].device = hDev;
-  sycl_queue_map[sycl_queue].queue = immediate_cmd_list ? 0 : *l0_queue;
+  handles.context = hCtxt;
+  handles.device = hDev;
+  sycl_queue_map[sycl_queue] = handles;
+  device_context_map.emplace(hDev, hCtxt);
+  return true;
+}
 
-  // Update global data
-  context = sycl_queue_map[sycl_queue].context;
-  uint32_t deviceCount = std::min(sycl_devices.size(), devices.size());
-  for (uint32_t i = 0; i < deviceCount; ++i) {
-    devices[i] =
-        sycl::get_native<sycl::backend::ext_oneapi_level_zero>(sycl_devices[i]);
+static bool getL0Handles(const sycl::queue &sycl_queue,
+                         l0_resc_handles &handles) {
+  std::lock_guard<std::mutex> lock(sycl_queue_map_mutex);
+  auto it = sycl_queue_map.find(sycl_queue);
+  if (it == sycl_queue_map.end()) {
+    if (!update(sycl_queue))
+      return false;
+    it = sycl_queue_map.find(sycl_queue);
   }
-
+  handles = it->second;
   return true;
 }
 
+static sycl::queue *getSyclQueue(PyObject *cap, l0_resc_handles &handles) {
+  void *queue = PyCapsule_GetPointer(cap, PyCapsule_GetName(cap));
+  if (queue == nullptr)
+    return nullptr;
+  sycl::queue *sycl_queue = static_cast<sycl::queue *>(queue);
+  if (!getL0Handles(*sycl_queue, handles)) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "sycl queue is not backed by a L0 queue");
+    return nullptr;
+  }
+  return sycl_queue;
+}
+
 static PyObject *initContext(PyObject *self, PyObject *args) {
   PyObject *cap;
-  void *queue = NULL;
   if (!PyArg_ParseTuple(args, "O", &cap))
     return NULL;
-  if (!(queue = PyCapsule_GetPointer(cap, PyCapsule_GetName(cap))))
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
     return NULL;
-  sycl::queue *sycl_queue = static_cast<sycl::queue *>(queue);
-  if (sycl_queue_map.find(*sycl_queue) == sycl_queue_map.end()) {
-    update(*sycl_queue);
-  }
-  context = sycl_queue_map[*sycl_queue].context;
-  return Py_BuildValue("(K)", (uint64_t)context);
+  return Py_BuildValue("(K)", (uint64_t)handles.context);
 }
 
 static PyObject *initDevices(PyObject *self, PyObject *args) {
@@ -380,6 +614,9 @@ static PyObject *initDevices(PyObject *self, PyObject *args) {
 
   // Retrieve l0 devices
   uint32_t deviceCount = sycl_devices.size();
+  std::lock_guard<std::mutex> lock(sycl_queue_map_mutex);
+  sycl_l0_device_list.clear();
+  devices.clear();
   for (uint32_t i = 0; i < deviceCount; ++i) {
     sycl_l0_device_list.push_back(std::make_pair(
         sycl_devices[i], sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
@@ -393,39 +630,686 @@ static PyObject *initDevices(PyObject *self, PyObject *args) {
 
 static PyObject *getL0Queue(PyObject *self, PyObject *args) {
   PyObject *cap;
-  void *queue = NULL;
   if (!PyArg_ParseTuple(args, "O", &cap))
     return NULL;
-  if (!(queue = PyCapsule_GetPointer(cap, PyCapsule_GetName(cap))))
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
     return NULL;
-  sycl::queue *sycl_queue = static_cast<sycl::queue *>(queue);
-  if (sycl_queue_map.find(*sycl_queue) == sycl_queue_map.end()) {
-    update(*sycl_queue);
-  }
-  return Py_BuildValue("(K)", (uint64_t)(sycl_queue_map[*sycl_queue].queue));
+  return Py_BuildValue("(K)", (uint64_t)handles.queue);
 }
 
 static PyObject *getL0CtxtPtr(PyObject *self, PyObject *args) {
   PyObject *cap;
-  void *queue = NULL;
   if (!PyArg_ParseTuple(args, "O", &cap))
     return NULL;
-  if (!(queue = PyCapsule_GetPointer(cap, PyCapsule_GetName(cap))))
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return NULL;
+  return Py_BuildValue("(K)", (uint64_t)handles.context);
+}
+
+// USM host memory, which the devices of the queue's context access in place.
+static PyObject *mallocHost(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  uint64_t nbytes;
+  if (!PyArg_ParseTuple(args, "OK", &cap, &nbytes))
+    return NULL;
+  void *queue = PyCapsule_GetPointer(cap, PyCapsule_GetName(cap));
+  if (queue == nullptr)
     return NULL;
   sycl::queue *sycl_queue = static_cast<sycl::queue *>(queue);
-  if (sycl_queue_map.find(*sycl_queue) == sycl_queue_map.end()) {
-    update(*sycl_queue);
+  void *ptr = sycl::malloc_host(nbytes, *sycl_queue);
+  if (ptr == nullptr)
+    return PyErr_NoMemory();
+  return PyLong_FromUnsignedLongLong((uint64_t)ptr);
+}
+
+static PyObject *freeHost(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  uint64_t ptr;
+  if (!PyArg_ParseTuple(args, "OK", &cap, &ptr))
+    return NULL;
+  void *queue = PyCapsule_GetPointer(cap, PyCapsule_GetName(cap));
+  if (queue == nullptr)
+    return NULL;
+  sycl::free((void *)ptr, *static_cast<sycl::queue *>(queue));
+  Py_RETURN_NONE;
+}
+
+// Makes the work submitted next to a queue wait for the work submitted so far
+// to other queues, which may belong to other devices of the same context.
+static PyObject *waitQueues(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  PyObject *others;
+  if (!PyArg_ParseTuple(args, "OO", &cap, &others))
+    return NULL;
+  void *queue = PyCapsule_GetPointer(cap, PyCapsule_GetName(cap));
+  if (queue == nullptr)
+    return NULL;
+  PyObject *seq = PySequence_Fast(others, "expected a sequence of queues");
+  if (seq == NULL)
+    return NULL;
+  std::vector<sycl::event> events;
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+    PyObject *other_cap = PySequence_Fast_GET_ITEM(seq, i);
+    void *other = PyCapsule_GetPointer(other_cap, PyCapsule_GetName(other_cap));
+    if (other == nullptr) {
+      Py_DECREF(seq);
+      return NULL;
+    }
+    events.push_back(
+        static_cast<sycl::queue *>(other)->ext_oneapi_submit_barrier());
+  }
+  Py_DECREF(seq);
+  static_cast<sycl::queue *>(queue)->ext_oneapi_submit_barrier(events);
+  Py_RETURN_NONE;
+}
+
+// Returns the IPC handle of the allocation holding `ptr`, the offset of `ptr`
+// in it and the id of this process.
+static PyObject *getIpcHandle(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  uint64_t ptr;
+  if (!PyArg_ParseTuple(args, "OK", &cap, &ptr))
+    return NULL;
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return NULL;
+  void *base = nullptr;
+  size_t size = 0;
+  ZE_CHECK(zeMemGetAddressRange(handles.context, (void *)ptr, &base, &size));
+  ze_ipc_mem_handle_t handle;
+  ZE_CHECK(zeMemGetIpcHandle(handles.context, base, &handle));
+  return Py_BuildValue("(y#KI)", handle.data, (Py_ssize_t)ZE_MAX_IPC_HANDLE_SIZE,
+                       (uint64_t)(ptr - (uint64_t)base), (unsigned)getpid());
+}
+
+// Maps the allocation of an IPC handle exported by process `pid` on the device
+// of the queue, and returns its base address in this process.
+static PyObject *openIpcHandle(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  const char *data;
+  Py_ssize_t size;
+  unsigned pid;
+  if (!PyArg_ParseTuple(args, "Oy#I", &cap, &data, &size, &pid))
+    return NULL;
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return NULL;
+  ze_ipc_mem_handle_t handle;
+  if (size != ZE_MAX_IPC_HANDLE_SIZE) {
+    PyErr_SetString(PyExc_ValueError, "invalid IPC memory handle");
+    return NULL;
+  }
+  memcpy(handle.data, data, ZE_MAX_IPC_HANDLE_SIZE);
+  // The handle holds a file descriptor of the exporting process, which is
+  // duplicated into this one.
+  int local_fd = -1;
+  if (pid != (unsigned)getpid()) {
+#if defined(SYS_pidfd_open) && defined(SYS_pidfd_getfd)
+    int fd;
+    memcpy(&fd, handle.data, sizeof(fd));
+    int pidfd = syscall(SYS_pidfd_open, pid, 0);
+    if (pidfd >= 0) {
+      local_fd = syscall(SYS_pidfd_getfd, pidfd, fd, 0);
+      close(pidfd);
+    }
+    if (local_fd < 0) {
+      PyErr_SetFromErrno(PyExc_OSError);
+      return NULL;
+    }
+    memcpy(handle.data, &local_fd, sizeof(local_fd));
+#else
+    PyErr_SetString(PyExc_RuntimeError,
+                    "opening IPC handles of other processes requires pidfd");
+    return NULL;
+#endif
+  }
+  void *ptr = nullptr;
+  ze_result_t ret =
+      zeMemOpenIpcHandle(handles.context, handles.device, handle, 0, &ptr);
+  // the mapping keeps its own reference to the memory
+  if (local_fd >= 0)
+    close(local_fd);
+  ZE_CHECK(ret);
+  return PyLong_FromUnsignedLongLong((uint64_t)ptr);
+}
+
+static PyObject *closeIpcHandle(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  uint64_t ptr;
+  if (!PyArg_ParseTuple(args, "OK", &cap, &ptr))
+    return NULL;
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return NULL;
+  ZE_CHECK(zeMemCloseIpcHandle(handles.context, (void *)ptr));
+  Py_RETURN_NONE;
+}
+
+/*Graph code start*/
+// Recorded command lists are replayed on an immediate command list of their
+// own, ordered against the SYCL queue with L0 events: a replay waits for a
+// barrier submitted to the queue, and the queue waits for the event signaled
+// by the replay. Neither the host nor the queue block on a replay.
+typedef struct replay_resc {
+  ze_command_list_handle_t imm_cmd_list;
+  std::vector<ze_event_pool_handle_t> pools;
+  std::vector<ze_event_handle_t> free_events;
+  // The event signaled by each replay in flight, with the barrier the replay
+  // waits for and the barrier of the queue waiting for it. The event is
+  // recycled once the latter completed.
+  struct in_flight_t {
+    ze_event_handle_t signal_event;
+    sycl::event wait_barrier;
+    sycl::event queue_barrier;
+  };
+  std::vector<in_flight_t> in_flight;
+} replay_resc;
+
+static constexpr uint32_t replay_event_pool_size = 64;
+static std::unordered_map<sycl::queue, replay_resc> replay_map;
+// The barrier following the last replay of each command list on each queue,
+// which must complete before the command list is destroyed.
+static std::unordered_map<ze_command_list_handle_t,
+                          std::unordered_map<sycl::queue, sycl::event>>
+    replayed_cmd_lists;
+
+static uint32_t getComputeQueueGroupOrdinal(ze_device_handle_t device) {
+  uint32_t count = 0;
+  zeDeviceGetCommandQueueGroupProperties(device, &count, nullptr);
+  std::vector<ze_command_queue_group_properties_t> props(count);
+  for (auto &prop : props) {
+    prop.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES;
+    prop.pNext = nullptr;
+  }
+  zeDeviceGetCommandQueueGroupProperties(device, &count, props.data());
+  for (uint32_t i = 0; i < count; ++i) {
+    if (props[i].flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE)
+      return i;
+  }
+  return 0;
+}
+
+// Must be called with sycl_queue_map_mutex held.
+static ze_result_t createReplayList(const l0_resc_handles &handles,
+                                    replay_resc &resc) {
+  ze_command_queue_desc_t desc = {};
+  desc.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  desc.ordinal = getComputeQueueGroupOrdinal(handles.device);
+  desc.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  return zeCommandListCreateImmediate(handles.context, handles.device, &desc,
+                                      &resc.imm_cmd_list);
+}
+
+// Must be called with sycl_queue_map_mutex held.
+static ze_result_t acquireReplayEvent(const l0_resc_handles &handles,
+                                      replay_resc &resc,
+                                      ze_event_handle_t &event) {
+  for (auto it = resc.in_flight.begin(); it != resc.in_flight.end();) {
+    if (it->queue_barrier
+            .get_info<sycl::info::event::command_execution_status>() ==
+        sycl::info::event_command_status::complete) {
+      ze_result_t ret = zeEventHostReset(it->signal_event);
+      if (ret != ZE_RESULT_SUCCESS)
+        return ret;
+      resc.free_events.push_back(it->signal_event);
+      it = resc.in_flight.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (resc.free_events.empty()) {
+    ze_event_pool_desc_t pool_desc = {};
+    pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+    pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+    pool_desc.count = replay_event_pool_size;
+    ze_event_pool_handle_t pool;
+    ze_device_handle_t device = handles.device;
+    ze_result_t ret =
+        zeEventPoolCreate(handles.context, &pool_desc, 1, &device, &pool);
+    if (ret != ZE_RESULT_SUCCESS)
+      return ret;
+    resc.pools.push_back(pool);
+    for (uint32_t i = 0; i < replay_event_pool_size; ++i) {
+      ze_event_desc_t event_desc = {};
+      event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+      event_desc.index = i;
+      event_desc.signal = ZE_EVENT_SCOPE_FLAG_DEVICE;
+      event_desc.wait = ZE_EVENT_SCOPE_FLAG_DEVICE;
+      ze_event_handle_t created;
+      ret = zeEventCreate(pool, &event_desc, &created);
+      if (ret != ZE_RESULT_SUCCESS)
+        return ret;
+      resc.free_events.push_back(created);
+    }
+  }
+  event = resc.free_events.back();
+  resc.free_events.pop_back();
+  return ZE_RESULT_SUCCESS;
+}
+
+static PyObject *createCommandList(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return NULL;
+  ze_command_list_desc_t desc = {};
+  desc.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+  desc.commandQueueGroupOrdinal = getComputeQueueGroupOrdinal(handles.device);
+  ze_command_list_handle_t cmd_list;
+  ZE_CHECK(
+      zeCommandListCreate(handles.context, handles.device, &desc, &cmd_list));
+  return Py_BuildValue("(K)", (uint64_t)cmd_list);
+}
+
+static PyObject *closeCommandList(PyObject *self, PyObject *args) {
+  uint64_t cmd_list;
+  if (!PyArg_ParseTuple(args, "K", &cmd_list))
+    return NULL;
+  ZE_CHECK(zeCommandListClose((ze_command_list_handle_t)cmd_list));
+  Py_RETURN_NONE;
+}
+
+static PyObject *executeCommandList(PyObject *self, PyObject *args) {
+  uint64_t cmd_list;
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "KO", &cmd_list, &cap))
+    return NULL;
+  l0_resc_handles handles;
+  sycl::queue *sycl_queue = getSyclQueue(cap, handles);
+  if (sycl_queue == nullptr)
+    return NULL;
+  std::lock_guard<std::mutex> lock(sycl_queue_map_mutex);
+  replay_resc &resc = replay_map[*sycl_queue];
+  if (resc.imm_cmd_list == nullptr)
+    ZE_CHECK(createReplayList(handles, resc));
+  ze_event_handle_t signal_event;
+  ZE_CHECK(acquireReplayEvent(handles, resc, signal_event));
+  // The recorded kernels must observe the work already submitted to the
+  // SYCL queue, and the work submitted afterwards must observe them.
+  sycl::event wait_barrier = sycl_queue->ext_oneapi_submit_barrier();
+  ze_event_handle_t wait_event =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(wait_barrier);
+  auto cmd_list_handle = (ze_command_list_handle_t)cmd_list;
+  ze_result_t ret = zeCommandListImmediateAppendCommandListsExp(
+      resc.imm_cmd_list, 1, &cmd_list_handle, signal_event, 1, &wait_event);
+  if (ret != ZE_RESULT_SUCCESS) {
+    resc.free_events.push_back(signal_event);
+    ZE_CHECK(ret);
+  }
+  sycl::event replayed =
+      sycl::make_event<sycl::backend::ext_oneapi_level_zero>(
+          {signal_event, sycl::ext::oneapi::level_zero::ownership::keep},
+          sycl_queue->get_context());
+  sycl::event queue_barrier = sycl_queue->ext_oneapi_submit_barrier({replayed});
+  resc.in_flight.push_back({signal_event, wait_barrier, queue_barrier});
+  replayed_cmd_lists[cmd_list_handle][*sycl_queue] = queue_barrier;
+  Py_RETURN_NONE;
+}
+
+static PyObject *destroyCommandList(PyObject *self, PyObject *args) {
+  uint64_t cmd_list;
+  if (!PyArg_ParseTuple(args, "K", &cmd_list))
+    return NULL;
+  auto cmd_list_handle = (ze_command_list_handle_t)cmd_list;
+  std::unordered_map<sycl::queue, sycl::event> replays;
+  {
+    std::lock_guard<std::mutex> lock(sycl_queue_map_mutex);
+    auto it = replayed_cmd_lists.find(cmd_list_handle);
+    if (it != replayed_cmd_lists.end()) {
+      replays = std::move(it->second);
+      replayed_cmd_lists.erase(it);
+    }
+  }
+  // replays may still be in flight
+  for (auto &replay : replays)
+    replay.second.wait();
+  ZE_CHECK(zeCommandListDestroy(cmd_list_handle));
+  Py_RETURN_NONE;
+}
+/*Graph code end*/
+
+/*Event code start*/
+// Recyclable kernel timestamp events, grouped in pools of fixed size. Events
+// are handed out by acquireTimestampEvent and returned to the free list by
+// releaseTimestampEvent, so steady-state profiling does not create any L0
+// object.
+typedef struct timestamp_event_pool {
+  static constexpr uint32_t pool_size = 256;
+  ze_context_handle_t context;
+  ze_device_handle_t device;
+  std::vector<ze_event_pool_handle_t> pools;
+  std::vector<ze_event_handle_t> free_events;
+} timestamp_event_pool;
+
+static std::map<std::pair<ze_context_handle_t, ze_device_handle_t>,
+                timestamp_event_pool>
+    timestamp_pool_map;
+static std::unordered_map<ze_event_handle_t, timestamp_event_pool *>
+    timestamp_event_owner;
+
+static ze_result_t growTimestampPool(timestamp_event_pool &pool) {
+  ze_event_pool_desc_t pool_desc = {};
+  pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+  pool_desc.flags =
+      ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP | ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  pool_desc.count = timestamp_event_pool::pool_size;
+  ze_event_pool_handle_t handle;
+  ze_result_t ret =
+      zeEventPoolCreate(pool.context, &pool_desc, 1, &pool.device, &handle);
+  if (ret != ZE_RESULT_SUCCESS)
+    return ret;
+  pool.pools.push_back(handle);
+  for (uint32_t i = 0; i < timestamp_event_pool::pool_size; ++i) {
+    ze_event_desc_t event_desc = {};
+    event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+    event_desc.index = i;
+    event_desc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+    event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+    ze_event_handle_t event;
+    ret = zeEventCreate(handle, &event_desc, &event);
+    if (ret != ZE_RESULT_SUCCESS)
+      return ret;
+    pool.free_events.push_back(event);
+    timestamp_event_owner[event] = &pool;
+  }
+  return ZE_RESULT_SUCCESS;
+}
+
+static timestamp_event_pool *getTimestampPool(PyObject *cap) {
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return nullptr;
+  auto &pool = timestamp_pool_map[{handles.context, handles.device}];
+  pool.context = handles.context;
+  pool.device = handles.device;
+  return &pool;
+}
+
+static PyObject *getEventPool(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  timestamp_event_pool *pool = getTimestampPool(cap);
+  if (pool == nullptr)
+    return NULL;
+  if (pool->pools.empty())
+    ZE_CHECK(growTimestampPool(*pool));
+  return Py_BuildValue("(K)", (uint64_t)pool->pools[0]);
+}
+
+static PyObject *acquireTimestampEvent(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  timestamp_event_pool *pool = getTimestampPool(cap);
+  if (pool == nullptr)
+    return NULL;
+  if (pool->free_events.empty())
+    ZE_CHECK(growTimestampPool(*pool));
+  ze_event_handle_t event = pool->free_events.back();
+  pool->free_events.pop_back();
+  return PyLong_FromUnsignedLongLong((uint64_t)event);
+}
+
+static PyObject *releaseTimestampEvent(PyObject *self, PyObject *args) {
+  uint64_t event;
+  if (!PyArg_ParseTuple(args, "K", &event))
+    return NULL;
+  auto handle = (ze_event_handle_t)event;
+  auto it = timestamp_event_owner.find(handle);
+  if (it == timestamp_event_owner.end()) {
+    PyErr_SetString(PyExc_ValueError, "event does not belong to a pool");
+    return NULL;
+  }
+  ZE_CHECK(zeEventHostReset(handle));
+  it->second->free_events.push_back(handle);
+  Py_RETURN_NONE;
+}
+
+// Waits for the kernel signaling `event` and returns its device-side
+// (start, end) timestamps in ticks.
+static PyObject *queryTimestampEvent(PyObject *self, PyObject *args) {
+  uint64_t event;
+  if (!PyArg_ParseTuple(args, "K", &event))
+    return NULL;
+  auto handle = (ze_event_handle_t)event;
+  ZE_CHECK(zeEventHostSynchronize(handle, UINT64_MAX));
+  ze_kernel_timestamp_result_t result;
+  ZE_CHECK(zeEventQueryKernelTimestamp(handle, &result));
+  return Py_BuildValue("(KK)", (uint64_t)result.global.kernelStart,
+                       (uint64_t)result.global.kernelEnd);
+}
+/*Event code end*/
+
+/*Metric code start*/
+// Pools of metric queries, each sampling the hardware counters of one metric
+// group between a begin and an end appended around a kernel. Sampling needs
+// ZET_ENABLE_METRICS=1 to be set before Level Zero is initialized.
+typedef struct metric_query_pool {
+  ze_context_handle_t context;
+  ze_device_handle_t device;
+  zet_metric_group_handle_t group;
+} metric_query_pool;
+
+static std::unordered_map<zet_metric_query_pool_handle_t, metric_query_pool>
+    metric_query_pools;
+
+// The metric groups of `device` that can be sampled around kernels.
+static std::vector<std::pair<std::string, zet_metric_group_handle_t>>
+getMetricGroups(ze_device_handle_t device) {
+  std::vector<std::pair<std::string, zet_metric_group_handle_t>> ret;
+  uint32_t count = 0;
+  if (zetMetricGroupGet(device, &count, nullptr) != ZE_RESULT_SUCCESS)
+    return ret;
+  std::vector<zet_metric_group_handle_t> groups(count);
+  if (zetMetricGroupGet(device, &count, groups.data()) != ZE_RESULT_SUCCESS)
+    return ret;
+  for (auto group : groups) {
+    zet_metric_group_properties_t props = {};
+    props.stype = ZET_STRUCTURE_TYPE_METRIC_GROUP_PROPERTIES;
+    if (zetMetricGroupGetProperties(group, &props) == ZE_RESULT_SUCCESS &&
+        (props.samplingType & ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_EVENT_BASED))
+      ret.emplace_back(props.name, group);
+  }
+  return ret;
+}
+
+static PyObject *getMetricGroupNames(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return NULL;
+  auto groups = getMetricGroups(handles.device);
+  PyObject *names = PyList_New(groups.size());
+  for (size_t i = 0; i < groups.size(); ++i)
+    PyList_SetItem(names, i, PyUnicode_FromString(groups[i].first.c_str()));
+  return names;
+}
+
+// Activates the metric group `name` on the device of a sycl queue and creates
+// a pool of `count` queries sampling it.
+static PyObject *createMetricQueryPool(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  const char *name;
+  uint32_t count;
+  if (!PyArg_ParseTuple(args, "OsI", &cap, &name, &count))
+    return NULL;
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return NULL;
+  zet_metric_group_handle_t group = nullptr;
+  for (auto &entry : getMetricGroups(handles.device))
+    if (entry.first == name)
+      group = entry.second;
+  if (group == nullptr) {
+    PyErr_Format(PyExc_ValueError,
+                 "metric group %s cannot be sampled on this device (is "
+                 "ZET_ENABLE_METRICS=1 set?)",
+                 name);
+    return NULL;
+  }
+  ZE_CHECK(zetContextActivateMetricGroups(handles.context, handles.device, 1,
+                                          &group));
+  zet_metric_query_pool_desc_t desc = {};
+  desc.stype = ZET_STRUCTURE_TYPE_METRIC_QUERY_POOL_DESC;
+  desc.type = ZET_METRIC_QUERY_POOL_TYPE_PERFORMANCE;
+  desc.count = count;
+  zet_metric_query_pool_handle_t pool;
+  ZE_CHECK(zetMetricQueryPoolCreate(handles.context, handles.device, group,
+                                    &desc, &pool));
+  metric_query_pools[pool] = {handles.context, handles.device, group};
+  return PyLong_FromUnsignedLongLong((uint64_t)pool);
+}
+
+static PyObject *destroyMetricQueryPool(PyObject *self, PyObject *args) {
+  uint64_t pool;
+  if (!PyArg_ParseTuple(args, "K", &pool))
+    return NULL;
+  auto handle = (zet_metric_query_pool_handle_t)pool;
+  auto it = metric_query_pools.find(handle);
+  if (it == metric_query_pools.end()) {
+    PyErr_SetString(PyExc_ValueError, "unknown metric query pool");
+    return NULL;
+  }
+  metric_query_pool info = it->second;
+  metric_query_pools.erase(it);
+  ZE_CHECK(zetMetricQueryPoolDestroy(handle));
+  ZE_CHECK(zetContextActivateMetricGroups(info.context, info.device, 0,
+                                          nullptr));
+  Py_RETURN_NONE;
+}
+
+static ze_command_list_handle_t getImmCmdList(PyObject *cap) {
+  l0_resc_handles handles;
+  if (!getSyclQueue(cap, handles))
+    return nullptr;
+  if (handles.cmd_list == nullptr)
+    PyErr_SetString(PyExc_RuntimeError, "metric queries require a queue "
+                                        "backed by an immediate command list");
+  return handles.cmd_list;
+}
+
+// Starts sampling with the query at `index` of a pool, in the order of the
+// kernels launched on a sycl queue.
+static PyObject *beginMetricQuery(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  uint64_t pool;
+  uint32_t index;
+  if (!PyArg_ParseTuple(args, "OKI", &cap, &pool, &index))
+    return NULL;
+  ze_command_list_handle_t cmd_list = getImmCmdList(cap);
+  if (cmd_list == nullptr)
+    return NULL;
+  zet_metric_query_handle_t query;
+  ZE_CHECK(zetMetricQueryCreate((zet_metric_query_pool_handle_t)pool, index,
+                                &query));
+  ZE_CHECK(zetCommandListAppendMetricQueryBegin(cmd_list, query));
+  return PyLong_FromUnsignedLongLong((uint64_t)query);
+}
+
+// Stops sampling with a query, signaling `event` once its data is available.
+static PyObject *endMetricQuery(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  uint64_t query, event;
+  if (!PyArg_ParseTuple(args, "OKK", &cap, &query, &event))
+    return NULL;
+  ze_command_list_handle_t cmd_list = getImmCmdList(cap);
+  if (cmd_list == nullptr)
+    return NULL;
+  ZE_CHECK(zetCommandListAppendMetricQueryEnd(
+      cmd_list, (zet_metric_query_handle_t)query, (ze_event_handle_t)event, 0,
+      nullptr));
+  Py_RETURN_NONE;
+}
+
+static PyObject *typedValueToPython(const zet_typed_value_t &value) {
+  switch (value.type) {
+  case ZET_VALUE_TYPE_UINT32:
+    return PyLong_FromUnsignedLong(value.value.ui32);
+  case ZET_VALUE_TYPE_UINT64:
+    return PyLong_FromUnsignedLongLong(value.value.ui64);
+  case ZET_VALUE_TYPE_FLOAT32:
+    return PyFloat_FromDouble(value.value.fp32);
+  case ZET_VALUE_TYPE_FLOAT64:
+    return PyFloat_FromDouble(value.value.fp64);
+  case ZET_VALUE_TYPE_BOOL8:
+    return PyBool_FromLong(value.value.b8);
+  default:
+    Py_RETURN_NONE;
+  }
+}
+
+// Waits for `event`, then returns the values of the metrics a query sampled,
+// by metric name, and destroys the query.
+static PyObject *queryMetricValues(PyObject *self, PyObject *args) {
+  uint64_t pool, query, event;
+  if (!PyArg_ParseTuple(args, "KKK", &pool, &query, &event))
+    return NULL;
+  auto it = metric_query_pools.find((zet_metric_query_pool_handle_t)pool);
+  if (it == metric_query_pools.end()) {
+    PyErr_SetString(PyExc_ValueError, "unknown metric query pool");
+    return NULL;
+  }
+  zet_metric_group_handle_t group = it->second.group;
+  auto query_handle = (zet_metric_query_handle_t)query;
+  ZE_CHECK(zeEventHostSynchronize((ze_event_handle_t)event, UINT64_MAX));
+
+  size_t raw_size = 0;
+  ZE_CHECK(zetMetricQueryGetData(query_handle, &raw_size, nullptr));
+  std::vector<uint8_t> raw(raw_size);
+  ZE_CHECK(zetMetricQueryGetData(query_handle, &raw_size, raw.data()));
+  ZE_CHECK(zetMetricQueryDestroy(query_handle));
+
+  uint32_t num_values = 0;
+  ZE_CHECK(zetMetricGroupCalculateMetricValues(
+      group, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES, raw_size,
+      raw.data(), &num_values, nullptr));
+  std::vector<zet_typed_value_t> values(num_values);
+  ZE_CHECK(zetMetricGroupCalculateMetricValues(
+      group, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES, raw_size,
+      raw.data(), &num_values, values.data()));
+  uint32_t num_metrics = 0;
+  ZE_CHECK(zetMetricGet(group, &num_metrics, nullptr));
+  std::vector<zet_metric_handle_t> metrics(num_metrics);
+  ZE_CHECK(zetMetricGet(group, &num_metrics, metrics.data()));
+
+  // values hold one report of every metric, the first one covers the query
+  PyObject *ret = PyDict_New();
+  for (uint32_t i = 0; i < num_metrics && i < num_values; ++i) {
+    zet_metric_properties_t props = {};
+    props.stype = ZET_STRUCTURE_TYPE_METRIC_PROPERTIES;
+    if (zetMetricGetProperties(metrics[i], &props) != ZE_RESULT_SUCCESS)
+      continue;
+    PyObject *value = typedValueToPython(values[i]);
+    PyDict_SetItemString(ret, props.name, value);
+    Py_DECREF(value);
   }
-  return Py_BuildValue("(K)", (uint64_t)(sycl_queue_map[*sycl_queue].context));
+  return ret;
 }
+/*Metric code end*/
 
 static PyMethodDef ModuleMethods[] = {
     {"load_binary", loadSyclBinary, METH_VARARGS,
      "Load provided SPV into ZE driver"},
     {"load_sycl_binary", loadSyclBinary, METH_VARARGS,
      "Load provided SPV into ZE driver"},
+    {"load_sycl_binaries", loadSyclBinaries, METH_VARARGS,
+     "Load several SPVs into a single ZE module"},
+    {"unload_binary", unloadBinary, METH_VARARGS,
+     "Release the kernel bundle and kernel returned by load_binary"},
+    {"get_native_binary", getNativeBinary, METH_VARARGS,
+     "Get the device-specific native binary of a loaded kernel bundle"},
     {"get_device_properties", getDeviceProperties, METH_VARARGS,
      "Get the properties for a given device"},
+    {"get_max_cooperative_programs", getMaxCooperativePrograms, METH_VARARGS,
+     "Get the number of programs of a loaded kernel that can be resident at "
+     "once"},
     {"init_context", initContext, METH_VARARGS,
      "Initialize the ZE GPU context"},
     {"init_devices", initDevices, METH_VARARGS,
@@ -433,6 +1317,47 @@ static PyMethodDef ModuleMethods[] = {
     {"get_l0_queue", getL0Queue, METH_VARARGS, "Get l0 queue from sycl queue"},
     {"get_l0_ctxt_ptr", getL0CtxtPtr, METH_VARARGS,
      "Extract l0 context pointer from sycl queue"},
+    {"malloc_host", mallocHost, METH_VARARGS,
+     "Allocate USM host memory in the context of a sycl queue"},
+    {"free_host", freeHost, METH_VARARGS,
+     "Free USM host memory allocated by malloc_host"},
+    {"wait_queues", waitQueues, METH_VARARGS,
+     "Order the next work of a sycl queue after the work of other queues"},
+    {"get_ipc_handle", getIpcHandle, METH_VARARGS,
+     "Get the IPC handle of the allocation holding a device pointer"},
+    {"open_ipc_handle", openIpcHandle, METH_VARARGS,
+     "Map the allocation of an IPC handle of another process"},
+    {"close_ipc_handle", closeIpcHandle, METH_VARARGS,
+     "Unmap an allocation mapped by open_ipc_handle"},
+    {"get_event_pool", getEventPool, METH_VARARGS,
+     "Get the first kernel timestamp event pool of a sycl queue's context"},
+    {"acquire_timestamp_event", acquireTimestampEvent, METH_VARARGS,
+     "Get a kernel timestamp event from the pool of a sycl queue's context"},
+    {"release_timestamp_event", releaseTimestampEvent, METH_VARARGS,
+     "Reset a kernel timestamp event and return it to its pool"},
+    {"query_timestamp_event", queryTimestampEvent, METH_VARARGS,
+     "Wait for a kernel timestamp event and return its (start, end) ticks"},
+    {"get_metric_group_names", getMetricGroupNames, METH_VARARGS,
+     "Get the metric groups that can be sampled around kernels on a sycl "
+     "queue's device"},
+    {"create_metric_query_pool", createMetricQueryPool, METH_VARARGS,
+     "Activate a metric group and create a pool of queries sampling it"},
+    {"destroy_metric_query_pool", destroyMetricQueryPool, METH_VARARGS,
+     "Destroy a metric query pool and deactivate its metric group"},
+    {"begin_metric_query", beginMetricQuery, METH_VARARGS,
+     "Start sampling metrics in the order of a sycl queue"},
+    {"end_metric_query", endMetricQuery, METH_VARARGS,
+     "Stop sampling metrics and signal an event when their data is ready"},
+    {"query_metric_values", queryMetricValues, METH_VARARGS,
+     "Wait for a metric query and return the sampled metrics by name"},
+    {"create_command_list", createCommandList, METH_VARARGS,
+     "Create a command list to record kernels launched on a sycl queue"},
+    {"close_command_list", closeCommandList, METH_VARARGS,
+     "Finish recording a command list"},
+    {"execute_command_list", executeCommandList, METH_VARARGS,
+     "Replay a recorded command list in the order of a sycl queue"},
+    {"destroy_command_list", destroyCommandList, METH_VARARGS,
+     "Destroy a recorded command list"},
     {NULL, NULL, 0, NULL} // sentinel
 };
 
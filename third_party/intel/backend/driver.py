@@ -1,10 +1,14 @@
+import contextlib
+import json
 import os
 import hashlib
 import tempfile
+import threading
 from pathlib import Path
 from triton.runtime.build import _build
 from triton.runtime.cache import get_cache_manager
 from triton.backends.driver import DriverBase
+from triton.runtime.driver import LazyProxy
 
 
 
@@ -16,8 +20,10 @@ library_dir = [os.path.join(dirname, "lib")]
 libraries = ['ze_loader']
 
 
-def compile_module_from_src(src, name):
-    key = hashlib.md5(src.encode("utf-8")).hexdigest()
+def compile_module_from_src(src, name, headers=()):
+    # `headers` are the paths of the local headers `src` includes
+    headers = {os.path.basename(path): Path(path).read_text() for path in headers}
+    key = hashlib.md5("".join([src, *headers.values()]).encode("utf-8")).hexdigest()
     cache = get_cache_manager(key)
     cache_path = cache.get_file(f"{name}.so")
     if cache_path is None:
@@ -25,9 +31,13 @@ def compile_module_from_src(src, name):
             src_path = os.path.join(tmpdir, "main.cpp")
             with open(src_path, "w") as f:
                 f.write(src)
+            for header, text in headers.items():
+                Path(tmpdir, header).write_text(text)
             so = _build(name, src_path, tmpdir, library_dir, include_dir, libraries)
             with open(so, "rb") as f:
-                cache_path = cache.put(f.read(), f"{name}.so", binary=True)
+                cache.put(f.read(), f"{name}.so", binary=True)
+            # the module is imported from a file, whatever the cache stores it in
+            cache_path = cache.get_file(f"{name}.so")
     import importlib.util
     spec = importlib.util.spec_from_file_location(name, cache_path)
     mod = importlib.util.module_from_spec(spec)
@@ -39,6 +49,25 @@ def compile_module_from_src(src, name):
 # Utils
 # ------------------------
 
+# IGC options selecting the register file size of a kernel
+_GRF_MODE_BUILD_FLAGS = {"default": "", "large": "-ze-opt-large-register-file"}
+# IGC options of the optimization levels of `XPUOptions.opt_level`
+_OPT_LEVEL_BUILD_FLAGS = {0: "-ze-opt-disable", 1: "-ze-opt-level=1", 2: "", 3: ""}
+
+
+def _grf_mode(metadata):
+    # kernels cached before `grf_mode` existed were built in the default mode
+    return getattr(metadata, "grf_mode", None) or "default"
+
+
+def _opt_level(metadata):
+    return getattr(metadata, "opt_level", 3)
+
+
+def _build_flags(grf_mode, opt_level):
+    return " ".join(flags for flags in (_GRF_MODE_BUILD_FLAGS[grf_mode], _OPT_LEVEL_BUILD_FLAGS[opt_level]) if flags)
+
+
 
 class XPUUtils(object):
 
@@ -49,21 +78,191 @@ class XPUUtils(object):
 
     def __init__(self):
         dirname = os.path.dirname(os.path.realpath(__file__))
-        mod = compile_module_from_src(Path(os.path.join(dirname, "driver.c")).read_text(), "spirv_utils")
-        self.load_binary = mod.load_binary
+        mod = compile_module_from_src(Path(os.path.join(dirname, "driver.c")).read_text(), "spirv_utils",
+                                      [os.path.join(dirname, "ze_module.h")])
+        self._load_binary = mod.load_binary
         self.load_sycl_binary = mod.load_sycl_binary
+        self.load_sycl_binaries = mod.load_sycl_binaries
+        self.get_native_binary = mod.get_native_binary
+        self._unload_binary = mod.unload_binary
+        # references held on loaded kernels by graphs recorded with them, and
+        # the unloads deferred until the last of them is dropped
+        self._binary_refs = dict()
+        self._deferred_unloads = dict()
+        self._get_event_pool = mod.get_event_pool
+        self.acquire_timestamp_event = mod.acquire_timestamp_event
+        self.release_timestamp_event = mod.release_timestamp_event
+        self.query_timestamp_event = mod.query_timestamp_event
+        self.get_metric_group_names = mod.get_metric_group_names
+        self.create_metric_query_pool = mod.create_metric_query_pool
+        self.destroy_metric_query_pool = mod.destroy_metric_query_pool
+        self.begin_metric_query = mod.begin_metric_query
+        self.end_metric_query = mod.end_metric_query
+        self.query_metric_values = mod.query_metric_values
+        self.create_command_list = mod.create_command_list
+        self.close_command_list = mod.close_command_list
+        self.execute_command_list = mod.execute_command_list
+        self.destroy_command_list = mod.destroy_command_list
         self.get_device_properties = mod.get_device_properties
+        self.get_max_cooperative_programs = mod.get_max_cooperative_programs
         self.get_l0_queue = mod.get_l0_queue
         self.get_l0_ctxt_ptr = mod.get_l0_ctxt_ptr
+        self.malloc_host = mod.malloc_host
+        self.free_host = mod.free_host
+        self.wait_queues = mod.wait_queues
+        self.get_ipc_handle = mod.get_ipc_handle
+        self.open_ipc_handle = mod.open_ipc_handle
+        self.close_ipc_handle = mod.close_ipc_handle
         self.context = mod.init_context(self.get_sycl_queue())
         self.device_count = mod.init_devices(self.get_sycl_queue())
         self.current_device = 0 if self.device_count[0] > 0 else -1
 
     def get_current_device(self):
+        # follow the device selected through torch so that each thread/device
+        # launches on its own queue
+        import torch
+        if self.current_device >= 0:
+            return torch.xpu.current_device()
         return self.current_device
 
+    def set_current_device(self, device):
+        import torch
+        torch.xpu.set_device(device)
+
+    def _native_cache_key(self, name, kernel, device_id):
+        # Native binaries are only valid for the device and driver that
+        # finalized them: IGC targets the arch and the configuration of the
+        # device (e.g. its EU count and SIMD width), which devices sharing a
+        # PCI id may not all have in common.
+        props = self.get_device_properties(device_id)
+        device = "-".join(
+            str(props[k]) for k in ("device_arch", "device_id", "driver_version", "multiprocessor_count",
+                                    "num_eus_per_subslice", "eu_simd_width", "subgroup_sizes", "max_shared_mem",
+                                    "num_tiles"))
+        key = f"{hashlib.md5(kernel).hexdigest()}-{name}-{device}"
+        return hashlib.md5(key.encode("utf-8")).hexdigest()
+
+    def _load_spirv(self, name, kernel, shared, device, grf_mode, opt_level=3):
+        """
+        Builds a SPIR-V kernel in the requested register file mode. In "auto"
+        mode a kernel that spills in the default 128-GRF mode is rebuilt with
+        the large (256-GRF) register file, which is kept if it spills less.
+        """
+        if grf_mode != "auto":
+            return self._load_binary(name, kernel, shared, device, False, _build_flags(grf_mode, opt_level))
+        ret = self._load_binary(name, kernel, shared, device, False, _build_flags("default", opt_level))
+        if ret[3] == 0:
+            return ret
+        large = self._load_binary(name, kernel, shared, device, False, _build_flags("large", opt_level))
+        if large[3] < ret[3]:
+            ret, large = large, ret
+        self.unload_binary(large[0], large[1])
+        return ret
+
+    def retain_binary(self, function):
+        self._binary_refs[function] = self._binary_refs.get(function, 0) + 1
+
+    def release_binary(self, function):
+        count = self._binary_refs.pop(function) - 1
+        if count > 0:
+            self._binary_refs[function] = count
+            return
+        unload = self._deferred_unloads.pop(function, None)
+        if unload is not None:
+            unload()
+
+    def unload_binary(self, module, function, evict=None):
+        """
+        Unloads a kernel, after `evict` has forgotten what its launcher cached
+        about it, which also waits for its launches still in flight. Graphs
+        recorded with the kernel keep it loaded until they are destroyed.
+        """
+
+        def unload():
+            if evict is not None:
+                evict(function)
+            self._unload_binary(module, function)
+
+        if function in self._binary_refs:
+            self._deferred_unloads[function] = unload
+        else:
+            unload()
+
+    def load_binary(self, name, kernel, shared, device, grf_mode="default", opt_level=3):
+        """
+        Loads a SPIR-V kernel. The device-specific native binary produced by
+        the driver is stored in the Triton cache so that subsequent processes
+        can skip the JIT finalization of the SPIR-V module.
+        """
+        ret = self._load_cached_binary(name, kernel, shared, device, grf_mode, opt_level)
+        XPUKernelTracer.kernel_names[ret[1]] = name
+        return ret
+
+    def _load_cached_binary(self, name, kernel, shared, device, grf_mode, opt_level):
+        if os.getenv("TRITON_XPU_DISABLE_NATIVE_CACHE", "0") == "1":
+            return self._load_spirv(name, kernel, shared, device, grf_mode, opt_level)
+        build = f"{name}-{grf_mode}" if opt_level == 3 else f"{name}-{grf_mode}-O{opt_level}"
+        cache = get_cache_manager(self._native_cache_key(build, kernel, self.get_current_device()))
+        native_filename = f"{name}.zebin"
+        native_binary = cache.get_bytes(native_filename)
+        if native_binary is not None:
+            try:
+                return self._load_binary(name, bytes(native_binary), shared, device, True)
+            except RuntimeError:
+                # fall back to SPIR-V, e.g. if the cached file is corrupted
+                pass
+        ret = self._load_spirv(name, kernel, shared, device, grf_mode, opt_level)
+        cache.put(self.get_native_binary(ret[0]), native_filename, binary=True)
+        return ret
+
+    def load_binaries(self, names, kernels, shared, device):
+        """
+        Loads several SPIR-V kernels with as few module creations as possible.
+        Kernels sharing a name (e.g. autotuning variants of the same function)
+        cannot live in the same module, so they are spread over several ones.
+        Returns one (module, function, n_regs, n_spills) tuple per kernel.
+        """
+        groups = []
+        for i, name in enumerate(names):
+            group = next((g for g in groups if name not in g), None)
+            if group is None:
+                group = dict()
+                groups.append(group)
+            group[name] = i
+        ret = [None] * len(names)
+        for group in groups:
+            ids = list(group.values())
+            handles = self.load_sycl_binaries([names[i] for i in ids], [kernels[i] for i in ids], shared, device)
+            for i, handle in zip(ids, handles):
+                ret[i] = handle
+                XPUKernelTracer.kernel_names[handle[1]] = names[i]
+        return ret
+
+    def init_handles(self, compiled_kernels):
+        """
+        Initializes the handles of many `CompiledKernel`s at once,
+        e.g. all the configurations of an autotuning sweep.
+        """
+        pending = [k for k in compiled_kernels if k.module is None]
+        if len(pending) == 0:
+            return
+        device = self.get_current_device()
+        max_shared = self.get_device_properties(device)["max_shared_mem"]
+        pending = [k for k in pending if k.metadata.shared <= max_shared]
+        # kernels with their own build flags cannot share a module
+        for k in [k for k in pending if _grf_mode(k.metadata) != "default" or _opt_level(k.metadata) != 3]:
+            k._init_handles()
+        pending = [k for k in pending if k.module is None]
+        if len(pending) == 0:
+            return
+        shared = max((k.metadata.shared for k in pending), default=0)
+        handles = self.load_binaries([k.name for k in pending], [k.kernel for k in pending], shared,
+                                     self.get_sycl_device(device))
+        for k, (module, function, n_regs, n_spills) in zip(pending, handles):
+            k.module, k.function, k.n_regs, k.n_spills = module, function, n_regs, n_spills
+
     def get_event_pool(self):
-        return self.event_pool
+        return self._get_event_pool(self.get_sycl_queue())[0]
 
     def get_sycl_queue(self):
         import torch
@@ -109,11 +308,45 @@ def generate_cu_signature(constants, signature, ids):
     return signature, num_regular_signatures
 
 
-def make_launcher(constants, signature, ids):
+# Argument types the launcher passes the same way
+_LAUNCHER_ARG_TYPES = {"i1": "i32", "fp16": "fp32", "bf16": "fp32", "f32": "fp32"}
+
+
+def normalize_launcher_signature(constants, signature):
+    """
+    Returns the signature and constants of the launcher of a kernel, with the
+    arguments numbered by position and typed by how they are passed, so that
+    kernels that only differ in pointee types, floating-point types or in the
+    position of their constexprs share the same launcher.
+    """
+    launcher_signature = {}
+    launcher_constants = {}
+    for pos, (i, ty) in enumerate(signature.items()):
+        launcher_signature[pos] = "*i8" if ty[0] == '*' else _LAUNCHER_ARG_TYPES.get(ty, ty)
+        if i in constants:
+            launcher_constants[pos] = constants[i]
+    return launcher_constants, launcher_signature
+
+
+def make_launcher(constants, signature, ids, global_scratch_size=0, global_scratch_align=1, host_memory=False,
+                  packed_args=(), split_k=1):
+    constants, signature = normalize_launcher_signature(constants, signature)
     # Record the end of regular arguments;
     # subsequent arguments are architecture-specific descriptors, such as tensor descriptors for CUDA.
     signature, desc_start_idx = generate_cu_signature(constants, signature, ids)
     arg_decls = ', '.join(f"{ty_to_cpp(ty)} arg{i}" for i, ty in signature.items())
+    # `packed_args` numbers the arguments of the kernel, the non-constexpr ones,
+    # that it takes in a struct passed as its first argument
+    kernel_args = [i for i in signature if i not in constants]
+    packed = [kernel_args[k] for k in packed_args]
+    unpacked = [i for i in kernel_args if i not in packed]
+    first_unpacked = 1 if packed else 0
+    packed_decl = ""
+    packed_init = ""
+    if packed:
+        fields = ' '.join(f"{ty_to_cpp(signature[i])} arg{i};" for i in packed)
+        packed_decl = f"typedef struct _PackedArgs {{ {fields} }} PackedArgs;"
+        packed_init = f"PackedArgs packed_args = {{ {', '.join(f'arg{i}' for i in packed)} }};"
 
     def _extracted_type(ty):
         if ty[0] == '*':
@@ -154,6 +387,14 @@ def make_launcher(constants, signature, ids):
     #include <iomanip>
     #include <level_zero/ze_api.h>
     #include <sycl/sycl.hpp>
+    #include <algorithm>
+    #include <atomic>
+    #include <chrono>
+    #include <map>
+    #include <mutex>
+    #include <unordered_map>
+    #include <variant>
+    #include <vector>
 
     #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
     #include <Python.h>
@@ -175,12 +416,72 @@ def make_launcher(constants, signature, ids):
 
     #define ZE_CHECK(ans) {{ gpuAssert((ans), __FILE__, __LINE__); }}
 
+    // Variant of ZE_CHECK usable without holding the GIL: the error is
+    // returned and turned into a Python exception by the caller.
+    #define ZE_RETURN_ON_ERROR(ans) {{ ze_result_t ret = (ans); if (ret != ZE_RESULT_SUCCESS) return ret; }}
+
     typedef struct _DevicePtrInfo {{
       void* dev_ptr;
       bool valid;
     }} DevicePtrInfo;
 
-    static inline DevicePtrInfo getPointer(PyObject *obj, int idx) {{
+    // Interned at module initialization so that looking up the method does not
+    // allocate a string on every launch.
+    static PyObject* data_ptr_str = NULL;
+
+    // USM allocations the pointer arguments were found in, by base address, so
+    // that each allocation is only queried once rather than on every launch.
+    // Only touched with the GIL held.
+    typedef struct _AllocInfo {{
+      uintptr_t end;
+      sycl::usm::alloc type;
+    }} AllocInfo;
+    static std::map<uintptr_t, AllocInfo> alloc_cache;
+    static constexpr bool host_memory = {'true' if host_memory else 'false'};
+
+    static inline bool isAccepted(sycl::usm::alloc type) {{
+      return type == sycl::usm::alloc::device || type == sycl::usm::alloc::shared ||
+             (type == sycl::usm::alloc::host && host_memory);
+    }}
+
+    static bool checkPointer(void* ptr, int idx, sycl::queue& stream) {{
+      uintptr_t addr = (uintptr_t)ptr;
+      auto it = alloc_cache.upper_bound(addr);
+      if (it != alloc_cache.begin() && addr < std::prev(it)->second.end &&
+          isAccepted(std::prev(it)->second.type))
+        return true;
+      // Not cached, or cached with a type the kernel does not accept, which
+      // is outdated if the allocation was freed since.
+      sycl::context context = stream.get_context();
+      sycl::usm::alloc type = sycl::get_pointer_type(ptr, context);
+      void* base = nullptr;
+      size_t size = 0;
+      if (type != sycl::usm::alloc::unknown &&
+          zeMemGetAddressRange(sycl::get_native<sycl::backend::ext_oneapi_level_zero>(context), ptr, &base,
+                               &size) == ZE_RESULT_SUCCESS) {{
+        uintptr_t begin = (uintptr_t)base;
+        uintptr_t end = begin + size;
+        // forget the freed allocations the new one overlaps
+        auto first = alloc_cache.upper_bound(begin);
+        if (first != alloc_cache.begin() && std::prev(first)->second.end > begin)
+          --first;
+        alloc_cache.erase(first, alloc_cache.lower_bound(end));
+        alloc_cache[begin] = AllocInfo{{end, type}};
+      }}
+      if (type == sycl::usm::alloc::unknown) {{
+        PyErr_Format(PyExc_ValueError,
+                     "Pointer argument (at %d) cannot be accessed from Triton (cpu tensor?)", idx);
+        return false;
+      }}
+      if (!isAccepted(type)) {{
+        PyErr_Format(PyExc_ValueError,
+                     "Pointer argument (at %d) is USM host memory, which requires host_memory=True", idx);
+        return false;
+      }}
+      return true;
+    }}
+
+    static inline DevicePtrInfo getPointer(PyObject *obj, int idx, sycl::queue& stream) {{
       DevicePtrInfo ptr_info;
       ptr_info.dev_ptr = 0;
       ptr_info.valid = true;
@@ -192,26 +493,28 @@ def make_launcher(constants, signature, ids):
         // valid nullptr
         return ptr_info;
       }}
-      PyObject *ptr = PyObject_GetAttrString(obj, "data_ptr");
-      if(ptr){{
-        PyObject *empty_tuple = PyTuple_New(0);
-        PyObject *ret = PyObject_Call(ptr, empty_tuple, NULL);
-        Py_DECREF(empty_tuple);
-        Py_DECREF(ptr);
-        if (!PyLong_Check(ret)) {{
-          PyErr_SetString(PyExc_TypeError, "data_ptr method of Pointer object must return 64-bit int");
-          ptr_info.valid = false;
-          return ptr_info;
-        }}
-        ptr_info.dev_ptr = (void*) PyLong_AsLongLong(ret);
-        if(!ptr_info.dev_ptr) {{
-          return ptr_info;
-        }}
-        Py_DECREF(ret);  // Thanks ChatGPT!
+      // Vectorcall of the bound method, without building an argument tuple.
+    #if PY_VERSION_HEX >= 0x03090000
+      PyObject *ret = PyObject_CallMethodNoArgs(obj, data_ptr_str);
+    #else
+      PyObject *ret = PyObject_CallMethodObjArgs(obj, data_ptr_str, NULL);
+    #endif
+      if (ret == NULL) {{
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "Pointer argument must be either uint64 or have data_ptr method");
+        ptr_info.valid = false;
         return ptr_info;
       }}
-      PyErr_SetString(PyExc_TypeError, "Pointer argument must be either uint64 or have data_ptr method");
-      ptr_info.valid = false;
+      if (!PyLong_Check(ret)) {{
+        Py_DECREF(ret);
+        PyErr_SetString(PyExc_TypeError, "data_ptr method of Pointer object must return 64-bit int");
+        ptr_info.valid = false;
+        return ptr_info;
+      }}
+      ptr_info.dev_ptr = (void*) PyLong_AsLongLong(ret);
+      Py_DECREF(ret);
+      if (ptr_info.dev_ptr != nullptr && !checkPointer(ptr_info.dev_ptr, idx, stream))
+        ptr_info.valid = false;
       return ptr_info;
     }}
 // start sycl
@@ -237,12 +540,129 @@ def make_launcher(constants, signature, ids):
       assert(false && "wrong scalar size in sycl gen.");
       }}
   }}
-  static void sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, sycl::queue& stream, sycl::kernel& kernel_ptr {', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
+  {packed_decl}
+  // Per-kernel information that does not change between launches.
+  typedef struct _KernelInfo {{
+    uint32_t num_args;
+    ze_kernel_handle_t l0_kernel;
+    uint32_t group_size;
+    // L0 kernel arguments are per kernel object, so launches of the same
+    // kernel from different threads must not interleave.
+    std::mutex l0_mutex;
+    // The queues the kernel was launched on, which `evict` waits for.
+    std::vector<sycl::queue> queues;
+  }} KernelInfo;
+
+  // Entries must be evicted (see `evict`) before the kernel is unloaded, as
+  // its address may then be reused by another kernel.
+  static std::unordered_map<const void*, KernelInfo> kernel_info_cache;
+  // Immediate command list of each queue, nullptr if the queue does not use one.
+  static std::unordered_map<const void*, ze_command_list_handle_t> imm_cmd_list_cache;
+  // Set at module initialization from TRITON_XPU_L0_LAUNCH.
+  static bool use_l0_launch = false;
+  // Split-K kernels run `split_k` programs per output tile along Z.
+  static constexpr int split_k = {split_k};
+
+  // Launches recorded while tracing is on, until `drain_trace` collects them.
+  // Launching threads never wait for each other or for the drain: each one
+  // claims a slot and publishes it by storing its sequence number last.
+  typedef struct _TraceRecord {{
+    std::atomic<uint64_t> seq;
+    uint64_t kernel;
+    uint64_t stream;
+    uint32_t grid[3];
+    uint64_t start_ns;
+    uint64_t end_ns;
+  }} TraceRecord;
+  static constexpr uint64_t trace_capacity = 4096;
+  static constexpr uint64_t trace_writing = UINT64_MAX;
+  static TraceRecord trace_ring[trace_capacity];
+  static std::atomic<uint64_t> trace_head{{0}};
+  // Only touched by `drain_trace`, which holds the GIL.
+  static uint64_t trace_tail = 0;
+  static std::atomic<bool> trace_enabled{{false}};
+
+  static inline uint64_t trace_now_ns() {{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }}
 
-    std::string kernel_name = kernel_ptr.get_info<sycl::info::kernel::function_name>();
-    void *params[] = {{ {', '.join(f"&arg{i}" for i in signature.keys() if i not in constants)} }};
-    uint32_t num_params = sizeof(params)/sizeof(params[0]);
-    uint32_t expected_num_params = kernel_ptr.get_info<sycl::info::kernel::num_args>();
+  static void trace_launch(const void* kernel, const void* stream, uint32_t gridX, uint32_t gridY, uint32_t gridZ,
+                           uint64_t start_ns, uint64_t end_ns) {{
+    uint64_t index = trace_head.fetch_add(1, std::memory_order_relaxed);
+    TraceRecord& record = trace_ring[index % trace_capacity];
+    record.seq.store(trace_writing, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.kernel = (uint64_t)kernel;
+    record.stream = (uint64_t)stream;
+    record.grid[0] = gridX;
+    record.grid[1] = gridY;
+    record.grid[2] = gridZ;
+    record.start_ns = start_ns;
+    record.end_ns = end_ns;
+    record.seq.store(index + 1, std::memory_order_release);
+  }}
+
+  // Global scratch memory of the kernels using `tl.global_scratch`, one buffer
+  // per kernel and queue so that concurrent launches never share it. A buffer
+  // is zeroed when allocated and keeps its contents between launches.
+  typedef struct _GlobalScratch {{
+    void* ptr;
+    sycl::queue queue;
+  }} GlobalScratch;
+  static constexpr size_t global_scratch_size = {global_scratch_size};
+  static constexpr size_t global_scratch_align = {global_scratch_align};
+  static std::map<std::pair<const void*, const void*>, GlobalScratch> global_scratch_pool;
+
+  // Must be called with the GIL held. Returns nullptr if the kernel uses no
+  // global scratch memory or if the allocation failed, which sets an error.
+  static void* get_global_scratch(const void* kernel_key, const void* stream_key, sycl::queue& stream) {{
+    if (global_scratch_size == 0)
+      return nullptr;
+    auto key = std::make_pair(kernel_key, stream_key);
+    auto it = global_scratch_pool.find(key);
+    if (it != global_scratch_pool.end())
+      return it->second.ptr;
+    void* ptr = sycl::aligned_alloc_device(global_scratch_align, global_scratch_size, stream);
+    if (ptr == nullptr) {{
+      PyErr_SetString(PyExc_MemoryError, "failed to allocate the global scratch memory of the kernel");
+      return nullptr;
+    }}
+    stream.memset(ptr, 0, global_scratch_size).wait();
+    global_scratch_pool.emplace(key, GlobalScratch{{ptr, stream}});
+    return ptr;
+  }}
+
+  static KernelInfo& get_kernel_info(const void* key, sycl::kernel& kernel_ptr) {{
+    auto it = kernel_info_cache.find(key);
+    if (it != kernel_info_cache.end())
+      return it->second;
+    KernelInfo& info = kernel_info_cache.try_emplace(key).first->second;
+    info.num_args = kernel_ptr.get_info<sycl::info::kernel::num_args>();
+    info.l0_kernel = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(kernel_ptr);
+    info.group_size = 0;
+    return info;
+  }}
+
+  static ze_command_list_handle_t get_imm_cmd_list(const void* key, sycl::queue& stream) {{
+    auto it = imm_cmd_list_cache.find(key);
+    if (it != imm_cmd_list_cache.end())
+      return it->second;
+    std::variant<ze_command_queue_handle_t, ze_command_list_handle_t> queue_var =
+        sycl::get_native<sycl::backend::ext_oneapi_level_zero>(stream);
+    auto imm_cmd_list = std::get_if<ze_command_list_handle_t>(&queue_var);
+    ze_command_list_handle_t ret = imm_cmd_list ? *imm_cmd_list : nullptr;
+    imm_cmd_list_cache.emplace(key, ret);
+    return ret;
+  }}
+
+  // Returns an empty string on success and the error message otherwise.
+  static std::string sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, void* global_scratch, sycl::queue& stream, sycl::kernel& kernel_ptr, const KernelInfo& info {', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
+
+    {packed_init}
+    void *params[] = {{ {', '.join(f"&arg{i}" for i in unpacked)} }};
+    uint32_t num_params = sizeof(params)/sizeof(params[0]) + {first_unpacked};
+    uint32_t expected_num_params = info.num_args;
     size_t global_range_x = gridX*threads_per_warp*num_warps;
     size_t global_range_y = gridY;
     size_t global_range_z = gridZ;
@@ -255,23 +675,67 @@ def make_launcher(constants, signature, ids):
     if (shared_memory) {{
       expected_num_params -= 1;
     }}
+    if (global_scratch_size) {{
+      expected_num_params -= 1;
+    }}
     assert(num_params == expected_num_params && "number of kernel param not matched");
     // Submit the imported kernel.
     auto cgf = [&](sycl::handler &cgh) {{
-      {" ".join(f'set_scalar_arg(cgh, {idx}, sizeof({ty_to_cpp(item)}), params[{idx}]);' for idx, item in enumerate([signature[i] for i in signature if i not in constants]))}
+      {"cgh.set_arg(0, packed_args);" if packed else ""}
+      {" ".join(f'set_scalar_arg(cgh, {idx + first_unpacked}, sizeof({ty_to_cpp(signature[i])}), params[{idx}]);' for idx, i in enumerate(unpacked))}
+      // the global scratch pointer precedes the shared memory argument
+      if (global_scratch_size) {{
+          cgh.set_arg(num_params, global_scratch);
+      }}
       if (shared_memory) {{
           using share_mem_t = sycl::local_accessor<int8_t, 1>;
           share_mem_t local_buffer = share_mem_t(shared_memory, cgh);
-          cgh.set_arg(num_params, local_buffer);
+          cgh.set_arg(num_params + (global_scratch_size ? 1 : 0), local_buffer);
           cgh.parallel_for(parallel_work_size, kernel_ptr);
       }} else {{
           cgh.parallel_for(parallel_work_size, kernel_ptr);
       }}
       }};
-    auto event = stream.submit(cgf);
+    try {{
+      auto event = stream.submit(cgf);
+    }} catch (const sycl::exception& e) {{
+      return std::string("Triton Error [SYCL]: ") + e.what();
+    }}
+    return std::string();
+  }}
+
+  // Appends the kernel directly to the immediate command list of the queue,
+  // bypassing the SYCL command group machinery.
+  static ze_result_t l0_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, void* global_scratch, ze_command_list_handle_t cmd_list, ze_event_handle_t signal_event, KernelInfo& info {', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
+    ze_kernel_handle_t l0_kernel = info.l0_kernel;
+    std::lock_guard<std::mutex> lock(info.l0_mutex);
+    {packed_init}
+    {"ZE_RETURN_ON_ERROR(zeKernelSetArgumentValue(l0_kernel, 0, sizeof(PackedArgs), &packed_args));" if packed else ""}
+    {" ".join(f'ZE_RETURN_ON_ERROR(zeKernelSetArgumentValue(l0_kernel, {idx + first_unpacked}, sizeof({ty_to_cpp(signature[i])}), &arg{i}));' for idx, i in enumerate(unpacked))}
+    uint32_t num_params = {len(unpacked) + first_unpacked};
+    if (global_scratch_size) {{
+      ZE_RETURN_ON_ERROR(zeKernelSetArgumentValue(l0_kernel, num_params, sizeof(void*), &global_scratch));
+      num_params += 1;
+    }}
+    if (shared_memory) {{
+      // local memory arguments only carry a size
+      ZE_RETURN_ON_ERROR(zeKernelSetArgumentValue(l0_kernel, num_params, shared_memory, nullptr));
+    }}
+    uint32_t group_size = num_warps*threads_per_warp;
+    if (info.group_size != group_size) {{
+      ZE_RETURN_ON_ERROR(zeKernelSetGroupSize(l0_kernel, group_size, 1, 1));
+      info.group_size = group_size;
+    }}
+    ze_group_count_t group_count = {{gridX, gridY, gridZ}};
+    return zeCommandListAppendLaunchKernel(cmd_list, l0_kernel, &group_count, signal_event, 0, nullptr);
   }}
 // end sycl
-    static PyObject* launch(PyObject* self, PyObject* args) {{
+    // When `capture_cmd_list` is set, the kernel is recorded into that command
+    // list instead of being submitted to the queue. When `signal_event` is set,
+    // the kernel signals it on completion (this requires an L0 command list).
+    // When `direct` is set, the kernel is appended to the immediate command
+    // list of the queue, if it has one, as with TRITON_XPU_L0_LAUNCH=1.
+    static PyObject* launch_impl(PyObject* args, ze_command_list_handle_t capture_cmd_list, ze_event_handle_t signal_event, bool direct = false) {{
 
       int gridX, gridY, gridZ;
       uint64_t _queue;
@@ -317,9 +781,43 @@ def make_launcher(constants, signature, ids):
         if (PyLong_Check(_threads_per_warp))
            threads_per_warp = PyLong_AsLong(_threads_per_warp);
       }}
+      if (split_k > 1)
+        gridZ *= split_k;
 
-      {"; ".join([f"DevicePtrInfo ptr_info{i} = getPointer(_arg{i}, {i}); if (!ptr_info{i}.valid) return NULL;" if ty[0] == "*" else "" for i, ty in signature.items()])};
-      sycl_kernel_launch(gridX, gridY, gridZ, num_warps, threads_per_warp, shared_memory, stream, kernel {',' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''});
+      {"; ".join([f"DevicePtrInfo ptr_info{i} = getPointer(_arg{i}, {i}, stream); if (!ptr_info{i}.valid) return NULL;" if ty[0] == "*" else "" for i, ty in signature.items()])};
+      KernelInfo& info = get_kernel_info(pKrnl, kernel);
+      if (std::find(info.queues.begin(), info.queues.end(), stream) == info.queues.end())
+        info.queues.push_back(stream);
+      void* global_scratch = get_global_scratch(pKrnl, pStream, stream);
+      if (global_scratch_size && global_scratch == nullptr)
+        return NULL;
+      ze_command_list_handle_t imm_cmd_list = capture_cmd_list;
+      if (imm_cmd_list == nullptr && (use_l0_launch || direct || signal_event != nullptr))
+        imm_cmd_list = get_imm_cmd_list(pStream, stream);
+      if (imm_cmd_list == nullptr && signal_event != nullptr) {{
+        PyErr_SetString(PyExc_RuntimeError, "timestamp events require a queue backed by an immediate command list");
+        return NULL;
+      }}
+      // Everything touching Python objects is done above; the submission
+      // itself runs without the GIL so that threads launching on different
+      // devices do not serialize.
+      ze_result_t ze_ret = ZE_RESULT_SUCCESS;
+      std::string sycl_err;
+      bool tracing = trace_enabled.load(std::memory_order_relaxed);
+      uint64_t start_ns = tracing ? trace_now_ns() : 0;
+      Py_BEGIN_ALLOW_THREADS;
+      if (imm_cmd_list != nullptr) {{
+        ze_ret = l0_kernel_launch(gridX, gridY, gridZ, num_warps, threads_per_warp, shared_memory, global_scratch, imm_cmd_list, signal_event, info {',' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''});
+      }} else {{
+        sycl_err = sycl_kernel_launch(gridX, gridY, gridZ, num_warps, threads_per_warp, shared_memory, global_scratch, stream, kernel, info {',' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''});
+      }}
+      Py_END_ALLOW_THREADS;
+      if (tracing)
+        trace_launch(pKrnl, pStream, gridX, gridY, gridZ, start_ns, trace_now_ns());
+      ZE_CHECK(ze_ret);
+      if (!sycl_err.empty()) {{
+        PyErr_SetString(PyExc_RuntimeError, sycl_err.c_str());
+      }}
 
       if (launch_exit_hook != Py_None) {{
         PyObject_CallObject(launch_exit_hook, args);
@@ -333,8 +831,124 @@ def make_launcher(constants, signature, ids):
       return Py_None;
     }}
 
+    static PyObject* launch(PyObject* self, PyObject* args) {{
+      return launch_impl(args, nullptr, nullptr);
+    }}
+
+    static PyObject* launch_direct(PyObject* self, PyObject* args) {{
+      return launch_impl(args, nullptr, nullptr, true);
+    }}
+
+    // Splits a leading L0 handle off the launch arguments.
+    static PyObject* launch_with_handle(PyObject* args, bool is_event) {{
+      Py_ssize_t num_args = PyTuple_Size(args);
+      if (num_args < 1) {{
+        PyErr_SetString(PyExc_TypeError, "expected a L0 handle as first argument");
+        return NULL;
+      }}
+      uint64_t handle = PyLong_AsUnsignedLongLong(PyTuple_GetItem(args, 0));
+      if (PyErr_Occurred())
+        return NULL;
+      PyObject* launch_args = PyTuple_GetSlice(args, 1, num_args);
+      PyObject* ret = is_event ? launch_impl(launch_args, nullptr, (ze_event_handle_t)handle)
+                               : launch_impl(launch_args, (ze_command_list_handle_t)handle, nullptr);
+      Py_DECREF(launch_args);
+      return ret;
+    }}
+
+    static PyObject* launch_into(PyObject* self, PyObject* args) {{
+      return launch_with_handle(args, false);
+    }}
+
+    static PyObject* launch_timed(PyObject* self, PyObject* args) {{
+      return launch_with_handle(args, true);
+    }}
+
+    static PyObject* evict(PyObject* self, PyObject* args) {{
+      uint64_t pKrnl;
+      if (!PyArg_ParseTuple(args, "K", &pKrnl))
+        return NULL;
+      auto info_it = kernel_info_cache.find((const void*)pKrnl);
+      if (info_it != kernel_info_cache.end()) {{
+        // launches still in flight use the kernel
+        for (auto& queue : info_it->second.queues)
+          queue.ext_oneapi_submit_barrier().wait();
+        kernel_info_cache.erase(info_it);
+      }}
+      for (auto it = global_scratch_pool.begin(); it != global_scratch_pool.end();) {{
+        if (it->first.first == (const void*)pKrnl) {{
+          // launches still in flight may use the buffer
+          it->second.queue.wait();
+          sycl::free(it->second.ptr, it->second.queue);
+          it = global_scratch_pool.erase(it);
+        }} else {{
+          ++it;
+        }}
+      }}
+      Py_RETURN_NONE;
+    }}
+
+    static PyObject* set_tracing(PyObject* self, PyObject* args) {{
+      int enabled;
+      if (!PyArg_ParseTuple(args, "p", &enabled))
+        return NULL;
+      trace_enabled.store(enabled, std::memory_order_relaxed);
+      Py_RETURN_NONE;
+    }}
+
+    // Returns the launches recorded since the last call, as (kernel, stream,
+    // grid, start_ns, end_ns) tuples, and the number of launches lost because
+    // the ring was full.
+    static PyObject* drain_trace(PyObject* self, PyObject* args) {{
+      uint64_t head = trace_head.load(std::memory_order_acquire);
+      uint64_t dropped = 0;
+      if (head - trace_tail > trace_capacity) {{
+        dropped += head - trace_tail - trace_capacity;
+        trace_tail = head - trace_capacity;
+      }}
+      PyObject* records = PyList_New(0);
+      if (records == NULL)
+        return NULL;
+      for (; trace_tail < head; ++trace_tail) {{
+        TraceRecord& record = trace_ring[trace_tail % trace_capacity];
+        uint64_t seq = record.seq.load(std::memory_order_acquire);
+        // still being written, collected by the next drain
+        if (seq == trace_writing || seq < trace_tail + 1)
+          break;
+        TraceRecord copy;
+        copy.kernel = record.kernel;
+        copy.stream = record.stream;
+        copy.grid[0] = record.grid[0];
+        copy.grid[1] = record.grid[1];
+        copy.grid[2] = record.grid[2];
+        copy.start_ns = record.start_ns;
+        copy.end_ns = record.end_ns;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // overwritten by a later launch, before or while it was copied
+        if (seq != trace_tail + 1 || record.seq.load(std::memory_order_relaxed) != seq) {{
+          ++dropped;
+          continue;
+        }}
+        PyObject* item = Py_BuildValue("(KK(III)KK)", copy.kernel, copy.stream, copy.grid[0], copy.grid[1],
+                                       copy.grid[2], copy.start_ns, copy.end_ns);
+        if (item == NULL || PyList_Append(records, item) < 0) {{
+          Py_XDECREF(item);
+          Py_DECREF(records);
+          return NULL;
+        }}
+        Py_DECREF(item);
+      }}
+      return Py_BuildValue("(NK)", records, dropped);
+    }}
+
     static PyMethodDef ModuleMethods[] = {{
       {{"launch", launch, METH_VARARGS, "Entry point for all kernels with this signature"}},
+      {{"launch_direct", launch_direct, METH_VARARGS, "Append a kernel with this signature to the immediate command list of the queue"}},
+      {{"launch_into", launch_into, METH_VARARGS, "Record a kernel with this signature into a command list"}},
+      {{"launch_timed", launch_timed, METH_VARARGS, "Launch a kernel with this signature signaling a timestamp event"}},
+      {{"evict", evict, METH_VARARGS, "Forget the cached information about a kernel before it is unloaded"}},
+      {{"set_tracing", set_tracing, METH_VARARGS, "Start or stop recording launches"}},
+      {{"drain_trace", drain_trace, METH_VARARGS, "Collect the launches recorded since the last call"}},
       {{NULL, NULL, 0, NULL}} // sentinel
     }};
 
@@ -347,6 +961,12 @@ def make_launcher(constants, signature, ids):
     }};
 
     PyMODINIT_FUNC PyInit___triton_launcher(void) {{
+      data_ptr_str = PyUnicode_InternFromString("data_ptr");
+      if (data_ptr_str == NULL) {{
+        return NULL;
+      }}
+      const char* l0_launch = std::getenv("TRITON_XPU_L0_LAUNCH");
+      use_l0_launch = l0_launch != nullptr && std::string(l0_launch) == "1";
       PyObject *m = PyModule_Create(&ModuleDef);
       if(m == NULL) {{
         return NULL;
@@ -358,7 +978,13 @@ def make_launcher(constants, signature, ids):
     return src
 
 
+# Launcher modules by source, shared by all kernels with the same launcher signature
+_launcher_modules = {}
+
+
 class XPULauncher(object):
+    # set by `XPUDriver.launch_batch` while it launches a batch
+    batching = False
 
     def __init__(self, src, metadata):
         ids = {
@@ -367,33 +993,470 @@ class XPULauncher(object):
             "ids_of_const_exprs": src.fn.constexprs if hasattr(src, "fn") else tuple()
         }
         constants = src.constants if hasattr(src, "constants") else dict()
+        self.name = metadata.name
         enable_warp_specialization = False
-        src = make_launcher(constants, src.signature, ids)
-        mod = compile_module_from_src(src, "__triton_launcher")
+        src = make_launcher(constants, src.signature, ids, getattr(metadata, "global_scratch_size", 0),
+                            getattr(metadata, "global_scratch_align", 1), getattr(metadata, "host_memory", False),
+                            getattr(metadata, "packed_args", ()), getattr(metadata, "split_k", 1))
+        mod = _launcher_modules.get(src)
+        if mod is None:
+            mod = compile_module_from_src(src, "__triton_launcher")
+            if XPUKernelTracer.active is not None:
+                mod.set_tracing(True)
+            _launcher_modules[src] = mod
         self.launch = mod.launch
+        self.launch_direct = mod.launch_direct
+        self.launch_into = mod.launch_into
+        self.launch_timed = mod.launch_timed
+        self.evict = mod.evict
 
     def __call__(self, *args, **kwargs):
-        self.launch(*args, **kwargs)
+        graph = XPUGraph.capturing
+        profiler = XPUEventProfiler.active
+        if graph is not None:
+            # the kernel handle, which the graph keeps loaded
+            graph.retain(args[10])
+            self.launch_into(graph.cmd_list, *args, **kwargs)
+        elif XPUMetricProfiler.active is not None:
+            XPUMetricProfiler.active.launch(self, *args, **kwargs)
+        elif profiler is not None:
+            self.launch_timed(profiler.acquire_event(), *args, **kwargs)
+        elif XPULauncher.batching:
+            self.launch_direct(*args, **kwargs)
+        else:
+            self.launch(*args, **kwargs)
+
+
+class XPUHostBuffer(object):
+    """
+    An array in USM host memory, which kernels compiled with `host_memory=True`
+    read and write in place, without copies to and from device memory:
+
+        buf = XPUHostBuffer((n, ), numpy.float32)
+        buf.numpy()[:] = inputs
+        kernel[grid](buf, out, n, host_memory=True)
+
+    On integrated GPUs the device accesses the memory directly. On discrete
+    GPUs every access crosses the bus, which only pays for data read once.
+    The memory must not be accessed from the host while kernels using it run.
+    """
+
+    def __init__(self, shape, dtype, utils=None):
+        import numpy
+        if utils is None:
+            from triton.runtime.driver import driver
+            utils = driver.active.utils
+        self.utils = utils
+        self.shape = tuple(shape)
+        self.dtype = numpy.dtype(dtype)
+        self.nbytes = int(numpy.prod(self.shape)) * self.dtype.itemsize
+        # freed in the context of the queue it was allocated in
+        self.queue = utils.get_sycl_queue()
+        self.ptr = utils.malloc_host(self.queue, max(self.nbytes, 1))
+
+    def data_ptr(self):
+        return self.ptr
+
+    def numpy(self):
+        """Returns a NumPy array viewing the memory, without copying it; it must not outlive the buffer."""
+        import ctypes
+        import numpy
+        buffer = (ctypes.c_char * self.nbytes).from_address(self.ptr)
+        return numpy.frombuffer(buffer, dtype=self.dtype).reshape(self.shape)
+
+    def __del__(self):
+        if getattr(self, "ptr", None):
+            self.utils.free_host(self.queue, self.ptr)
+            self.ptr = None
+
+
+class XPUTileSplitter(object):
+    """
+    Splits launches along the first grid axis across several devices, e.g.
+    the tiles of a PVC card exposed as devices with
+    `ZE_FLAT_DEVICE_HIERARCHY=FLAT`. With the default COMPOSITE hierarchy the
+    tiles of a device (see its "num_tiles" property) share the work of each
+    kernel through implicit scaling, without control over which tile reads
+    which data. Split kernels take the index of their first program as a
+    `pid_offset` argument:
+
+        @triton.jit
+        def kernel(x_ptr, y_ptr, n, pid_offset, BLOCK: tl.constexpr):
+            pid = tl.program_id(0) + pid_offset
+            ...
+
+        splitter = XPUTileSplitter()
+        splitter.launch(kernel, (triton.cdiv(n, BLOCK), ), x, y, n, BLOCK=BLOCK)
+
+    Each device runs a contiguous range of the programs, on its current queue,
+    after the work submitted so far to the current queue of the caller, which
+    then waits for all of them. `place(index, first_program, num_programs)`,
+    when given, returns the arguments of the `index`-th device, so that each
+    one works on data placed in its own memory.
+    """
+
+    def __init__(self, devices=None, utils=None):
+        import torch
+        if utils is None:
+            from triton.runtime.driver import driver
+            utils = driver.active.utils
+        self.utils = utils
+        self.devices = list(range(torch.xpu.device_count())) if devices is None else list(devices)
+
+    def launch(self, kernel, grid, *args, place=None, **kwargs):
+        import torch
+        num_programs = grid[0]
+        rest = tuple(grid[1:])
+        chunk = (num_programs + len(self.devices) - 1) // len(self.devices)
+        queue = torch.xpu.current_stream().sycl_queue
+        queues = []
+        for index, device in enumerate(self.devices):
+            first = index * chunk
+            count = min(chunk, num_programs - first)
+            if count <= 0:
+                break
+            with torch.xpu.device(device):
+                tile_queue = torch.xpu.current_stream().sycl_queue
+                self.utils.wait_queues(tile_queue, (queue, ))
+                tile_args = args if place is None else place(index, first, count)
+                kernel[(count, ) + rest](*tile_args, pid_offset=first, **kwargs)
+            queues.append(tile_queue)
+        self.utils.wait_queues(queue, tuple(queues))
+
+
+class XPUEventProfiler(object):
+    """
+    Attaches a pooled kernel timestamp event to every Triton launch issued
+    within `record()`, and reports the device-side duration of each kernel
+    without synchronizing the whole device:
+
+        profiler = XPUEventProfiler()
+        with profiler.record():
+            kernel[grid](...)
+        times_ms = profiler.elapsed_times()
+    """
+    active = None
+
+    def __init__(self, utils=None):
+        if utils is None:
+            from triton.runtime.driver import driver
+            utils = driver.active.utils
+        self.utils = utils
+        self.queue = None
+        self.events = []
+
+    def acquire_event(self):
+        event = self.utils.acquire_timestamp_event(self.queue)
+        self.events.append(event)
+        return event
+
+    @contextlib.contextmanager
+    def record(self):
+        assert XPUEventProfiler.active is None, "nested profiling is not supported"
+        self.queue = self.utils.get_sycl_queue()
+        XPUEventProfiler.active = self
+        try:
+            yield self
+        finally:
+            XPUEventProfiler.active = None
+
+    def timestamps(self):
+        """Returns the (start, end) device ticks of each recorded kernel and recycles the events."""
+        ret = [self.utils.query_timestamp_event(event) for event in self.events]
+        for event in self.events:
+            self.utils.release_timestamp_event(event)
+        self.events = []
+        return ret
+
+    def elapsed_times(self):
+        """Returns the duration in milliseconds of each recorded kernel and recycles the events."""
+        props = self.utils.get_device_properties(self.utils.get_current_device())
+        mask = (1 << props["timestamp_valid_bits"]) - 1
+        resolution_ns = props["timer_resolution"]
+        return [((end - start) & mask) * resolution_ns * 1e-6 for start, end in self.timestamps()]
+
+
+class XPUMetricProfiler(object):
+    """
+    Samples the hardware counters of a Level Zero metric group around every
+    Triton launch issued within `record()`:
+
+        profiler = XPUMetricProfiler("ComputeBasic")
+        with profiler.record():
+            kernel[grid](...)
+        for name, metrics in profiler.metrics():
+            print(name, metrics["XVE_ACTIVE"], metrics["GPU_MEMORY_BYTE_READ"])
+
+    The groups a device supports are listed by `metric_groups()`. Sampling
+    requires `ZET_ENABLE_METRICS=1` to be set before the process first uses
+    the device. Each launch is also timed, under the "time_ms" metric.
+    """
+    active = None
+
+    def __init__(self, group="ComputeBasic", max_launches=1024, utils=None):
+        if utils is None:
+            from triton.runtime.driver import driver
+            utils = driver.active.utils
+        self.utils = utils
+        self.group = group
+        self.max_launches = max_launches
+        self.queue = None
+        self.pool = None
+        # (kernel name, query, kernel event, end event) of every launch
+        self.launches = []
+
+    def metric_groups(self):
+        return self.utils.get_metric_group_names(self.utils.get_sycl_queue())
+
+    @contextlib.contextmanager
+    def record(self):
+        assert XPUMetricProfiler.active is None, "nested profiling is not supported"
+        self.queue = self.utils.get_sycl_queue()
+        if self.pool is None:
+            self.pool = self.utils.create_metric_query_pool(self.queue, self.group, self.max_launches)
+        XPUMetricProfiler.active = self
+        try:
+            yield self
+        finally:
+            XPUMetricProfiler.active = None
+
+    def launch(self, launcher, *args, **kwargs):
+        if len(self.launches) == self.max_launches:
+            raise RuntimeError(f"more than {self.max_launches} launches to sample, collect the metrics more often")
+        query = self.utils.begin_metric_query(self.queue, self.pool, len(self.launches))
+        event = self.utils.acquire_timestamp_event(self.queue)
+        end_event = self.utils.acquire_timestamp_event(self.queue)
+        launcher.launch_timed(event, *args, **kwargs)
+        self.utils.end_metric_query(self.queue, query, end_event)
+        self.launches.append((launcher.name, query, event, end_event))
+
+    def metrics(self):
+        """Returns the kernel name and the metrics of each sampled launch, and recycles the queries."""
+        props = self.utils.get_device_properties(self.utils.get_current_device())
+        mask = (1 << props["timestamp_valid_bits"]) - 1
+        ret = []
+        for name, query, event, end_event in self.launches:
+            metrics = self.utils.query_metric_values(self.pool, query, end_event)
+            start, end = self.utils.query_timestamp_event(event)
+            metrics["time_ms"] = ((end - start) & mask) * props["timer_resolution"] * 1e-6
+            self.utils.release_timestamp_event(event)
+            self.utils.release_timestamp_event(end_event)
+            ret.append((name, metrics))
+        self.launches = []
+        return ret
+
+    def __del__(self):
+        if self.pool is not None:
+            self.utils.destroy_metric_query_pool(self.pool)
+            self.pool = None
+
+
+class XPUKernelTracer(object):
+    """
+    Records the kernel, grid, queue and host submission time of every Triton
+    launch within `record()` in the launchers themselves, without calling back
+    into Python on launch. A background thread collects the records every
+    `interval` seconds:
+
+        tracer = XPUKernelTracer()
+        with tracer.record():
+            kernel[grid](...)
+        tracer.export_chrome_trace("trace.json")
+
+    Timestamps are those of `time.monotonic_ns()`. Launches are lost, and
+    counted in `dropped`, if more than a few thousand happen between two
+    collections.
+    """
+    active = None
+    # names of the loaded kernels, by function handle
+    kernel_names = {}
+
+    def __init__(self, interval=0.1):
+        self.interval = interval
+        self.events = []
+        self.dropped = 0
+        self._stop = None
+        self._thread = None
+
+    def _set_tracing(self, enabled):
+        for mod in list(_launcher_modules.values()):
+            mod.set_tracing(enabled)
+
+    def drain(self):
+        """Collects the launches recorded so far."""
+        for mod in list(_launcher_modules.values()):
+            records, dropped = mod.drain_trace()
+            self.dropped += dropped
+            for kernel, stream, grid, start_ns, end_ns in records:
+                name = XPUKernelTracer.kernel_names.get(kernel, hex(kernel))
+                self.events.append((name, stream, grid, start_ns, end_ns))
+
+    def _run(self):
+        while not self._stop.wait(self.interval):
+            self.drain()
+
+    @contextlib.contextmanager
+    def record(self):
+        assert XPUKernelTracer.active is None, "nested tracing is not supported"
+        # launches from before the recording are not part of it
+        for mod in list(_launcher_modules.values()):
+            mod.drain_trace()
+        XPUKernelTracer.active = self
+        self._set_tracing(True)
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+        try:
+            yield self
+        finally:
+            self._set_tracing(False)
+            XPUKernelTracer.active = None
+            self._stop.set()
+            self._thread.join()
+            self.drain()
+
+    def export_chrome_trace(self, path):
+        """Writes the recorded launches in the Chrome trace event format, which Perfetto also reads."""
+        pid = os.getpid()
+        events = [{
+            "name": name,
+            "ph": "X",
+            "ts": start_ns / 1e3,
+            "dur": (end_ns - start_ns) / 1e3,
+            "pid": pid,
+            "tid": stream,
+            "args": {"grid": list(grid)},
+        } for name, stream, grid, start_ns, end_ns in self.events]
+        with open(path, "w") as f:
+            json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, f)
+
+
+class XPUGraph(object):
+    """
+    Records a sequence of Triton launches into a Level Zero command list
+    that can be replayed without going through the launcher again:
+
+        graph = XPUGraph()
+        with graph.capture():
+            kernel[grid](...)
+        graph.replay()
+
+    Replays are asynchronous and ordered with the other work of the queue
+    the graph was captured on. Kernel arguments are captured by value at
+    recording time, so tensors used during the capture must stay alive (and
+    at the same address) for as long as the graph is replayed.
+    """
+    capturing = None
+
+    def __init__(self, utils=None):
+        if utils is None:
+            from triton.runtime.driver import driver
+            utils = driver.active.utils
+        self.utils = utils
+        self.queue = None
+        self.cmd_list = None
+        self.functions = set()
+
+    def retain(self, function):
+        if function not in self.functions:
+            self.utils.retain_binary(function)
+            self.functions.add(function)
+
+    @contextlib.contextmanager
+    def capture(self):
+        assert XPUGraph.capturing is None, "nested graph captures are not supported"
+        assert self.cmd_list is None, "graph has already been captured"
+        self.queue = self.utils.get_sycl_queue()
+        self.cmd_list = self.utils.create_command_list(self.queue)[0]
+        XPUGraph.capturing = self
+        try:
+            yield self
+        finally:
+            XPUGraph.capturing = None
+            self.utils.close_command_list(self.cmd_list)
+
+    def replay(self):
+        assert self.cmd_list is not None, "graph has not been captured"
+        self.utils.execute_command_list(self.cmd_list, self.queue)
+
+    def __del__(self):
+        if self.cmd_list is not None:
+            self.utils.destroy_command_list(self.cmd_list)
+            self.cmd_list = None
+        for function in self.functions:
+            self.utils.release_binary(function)
+        self.functions = set()
 
 
 class XPUDriver(DriverBase):
 
     def __init__(self):
-        self.utils = XPUUtils()
+        # builds the `spirv_utils` extension and initializes Level Zero, so
+        # only done when first used
+        self.utils = LazyProxy(XPUUtils)
         self.binary_ext = "spv"
         self.launcher_cls = XPULauncher
         self.get_current_stream = self.get_current_stream
-        self.get_current_device = self.utils.get_current_device
+        self._metric_profilers = {}
+
+    def get_current_device(self):
+        return self.utils.get_current_device()
+
+    def set_current_device(self, device):
+        self.utils.set_current_device(device)
 
     def get_current_stream(self, device):
         import torch
-        return torch.xpu.current_stream().sycl_queue
+        return torch.xpu.current_stream(device).sycl_queue
 
     def get_current_target(self):
         device = self.get_current_device()
         device_arch = self.utils.get_device_properties(device)['device_arch']
         return ("xpu", device_arch)
 
+    def max_cooperative_programs(self, kernel):
+        md = kernel.metadata
+        return self.utils.get_max_cooperative_programs(kernel.function, md.num_warps, md.threads_per_warp)
+
+    def get_ipc_handle(self, ptr):
+        return self.utils.get_ipc_handle(self.utils.get_sycl_queue(), ptr)
+
+    def open_ipc_handle(self, handle):
+        data, offset, pid = handle
+        base = self.utils.open_ipc_handle(self.utils.get_sycl_queue(), data, pid)
+        return base, base + offset
+
+    def close_ipc_handle(self, base):
+        self.utils.close_ipc_handle(self.utils.get_sycl_queue(), base)
+
+    def launch_batch(self, launches):
+        # The kernels of the batch are appended straight to the immediate
+        # command list of the queue, bypassing the SYCL command groups.
+        # Recording them into a command list to replay it once would cost
+        # more than it saves, as the list could not be reused.
+        if XPUGraph.capturing is not None or XPULauncher.batching:
+            return super().launch_batch(launches)
+        XPULauncher.batching = True
+        try:
+            super().launch_batch(launches)
+        finally:
+            XPULauncher.batching = False
+
+    def collect_metrics(self, fn):
+        # the metric group is activated once, for as long as the driver lives
+        group = os.getenv("TRITON_XPU_METRIC_GROUP", "ComputeBasic")
+        profiler = self._metric_profilers.get(group)
+        if profiler is None:
+            profiler = self._metric_profilers[group] = XPUMetricProfiler(group, utils=self.utils)
+        with profiler.record():
+            fn()
+        return [metrics for _, metrics in profiler.metrics()]
+
+    def get_device_key(self):
+        device = self.get_current_device()
+        props = self.utils.get_device_properties(device)
+        return f"xpu-{props['device_arch']}-{props['device_id']}-{props['driver_version']}"
+
     @staticmethod
     def is_active():
         import torch
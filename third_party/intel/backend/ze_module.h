@@ -0,0 +1,47 @@
+//===- ze_module.h --------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Level Zero module creation shared by the driver (driver.c) and the kernels
+// compiled ahead of time (python/triton/tools/compile_xpu.c), which embed
+// this file. It must stay valid C.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TRITON_ZE_MODULE_H
+#define TRITON_ZE_MODULE_H
+
+#include <level_zero/ze_api.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Builds `desc` into a module, printing the build log of `name` to stderr on
+// failure.
+static inline ze_result_t createZeModule(ze_context_handle_t context,
+                                         ze_device_handle_t device,
+                                         const ze_module_desc_t *desc,
+                                         const char *name,
+                                         ze_module_handle_t *module) {
+  ze_module_build_log_handle_t build_log = NULL;
+  ze_result_t ret = zeModuleCreate(context, device, desc, module, &build_log);
+  if (ret != ZE_RESULT_SUCCESS && build_log != NULL) {
+    size_t size = 0;
+    zeModuleBuildLogGetString(build_log, &size, NULL);
+    char *log = (char *)malloc(size);
+    if (log != NULL) {
+      zeModuleBuildLogGetString(build_log, &size, log);
+      fprintf(stderr, "L0 build module %s failed. Log: %s\n", name, log);
+      free(log);
+    }
+  }
+  // the build log is allocated on success too
+  if (build_log != NULL)
+    zeModuleBuildLogDestroy(build_log);
+  return ret;
+}
+
+#endif // TRITON_ZE_MODULE_H
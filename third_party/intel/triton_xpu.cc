@@ -6,6 +6,8 @@
 #include "triton/Conversion/NVGPUToLLVM/Passes.h"
 #include "triton/Conversion/TritonGPUToLLVM/Passes.h"
 #include "triton/Dialect/NVGPU/IR/Dialect.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h"
 #include "llvm/IR/Constants.h"
@@ -20,14 +22,31 @@ PYBIND11_MAKE_OPAQUE(mlir::triton::gpu::TMAMetadataTy);
 
 void init_triton_intel_passes_ttgpuir(py::module &&m) {
   using namespace mlir::triton::gpu;
-  ADD_PASS_WRAPPER_1("add_rewrite_tensor_pointer",
-                     mlir::createTritonGPURewriteTensorPointerPass, int);
+  ADD_PASS_WRAPPER_2("add_coalesce", createCoalescePass, int, int);
+  ADD_PASS_WRAPPER_2("add_reorder_instructions", createReorderInstructionsPass,
+                     bool, int);
+  ADD_PASS_WRAPPER_2("add_rewrite_tensor_pointer",
+                     mlir::createTritonGPURewriteTensorPointerPass, int, bool);
+  ADD_PASS_WRAPPER_2("add_accelerate_matmul", createAccelerateMatmulPass, int,
+                     bool);
+  m.def("add_pipeline", [](mlir::PassManager &pm, int numStages, int numWarps,
+                           int numCTAs, int capability, bool usePrefetch,
+                           int sharedMemorySize) {
+    pm.addPass(createPipelinePass(numStages, numWarps, numCTAs, capability,
+                                  usePrefetch, sharedMemorySize));
+  });
   // TODO: it is weird to pass mlir::triton::NVVM here since the conversion is
   // nvidia-specificontext
-  m.def("add_to_llvmir", [](mlir::PassManager &pm, int32_t capability,
-                            mlir::triton::gpu::TMAMetadataTy *tmaMetadata) {
-    pm.addPass(createConvertTritonGPUToLLVMPass(capability, mlir::triton::GENX,
-                                                tmaMetadata));
+  m.def("add_to_llvmir",
+        [](mlir::PassManager &pm, int32_t capability,
+           mlir::triton::gpu::TMAMetadataTy *tmaMetadata, bool fastMath,
+           bool vectorTensors, bool aggregateAtomics) {
+          pm.addPass(createConvertTritonGPUToLLVMPass(
+              capability, mlir::triton::GENX, tmaMetadata, fastMath,
+              vectorTensors, aggregateAtomics));
+        });
+  m.def("add_pack_kernel_args", [](mlir::PassManager &pm, int32_t threshold) {
+    pm.addPass(mlir::triton::createPackKernelArgsPass({threshold}));
   });
 }
 
@@ -104,6 +123,36 @@ void init_triton_intel(py::module &&m){
                      &mlir::triton::gpu::TMAInfo::TMADescArgIdx);
   py::bind_vector<std::vector<mlir::triton::gpu::TMAInfo>>(m, "TMAInfos");
 
+  // Picks the sub-group size of a TTIR module. DPAS runs at its execution
+  // size, so kernels with a tt.dot use `dotThreadsPerWarp` when the target
+  // lowers dots to DPAS (it is 0 otherwise). Otherwise SIMD32 is kept unless
+  // the largest tensor would take more than a quarter of the per-lane share of
+  // the register file (128 x 64B GRFs per hardware thread), in which case
+  // SIMD16 halves the pressure and avoids spills.
+  m.def("select_threads_per_warp", [](mlir::ModuleOp &mod,
+                                      int dotThreadsPerWarp,
+                                      int numWarps) -> int {
+    constexpr int64_t grfBytes = 128 * 64;
+    bool hasDot = false;
+    int64_t maxTensorBytes = 0;
+    mod.walk([&](mlir::Operation *op) {
+      if (llvm::isa<mlir::triton::DotOp>(op))
+        hasDot = true;
+      for (mlir::Type ty : op->getResultTypes()) {
+        auto tensorTy = ty.dyn_cast<mlir::RankedTensorType>();
+        if (!tensorTy || !tensorTy.getElementType().isIntOrFloat())
+          continue;
+        int64_t bytes = tensorTy.getNumElements() *
+                        tensorTy.getElementTypeBitWidth() / 8;
+        maxTensorBytes = std::max(maxTensorBytes, bytes);
+      }
+    });
+    if (dotThreadsPerWarp > 0 && hasDot)
+      return dotThreadsPerWarp;
+    int64_t bytesPerLane = maxTensorBytes / (numWarps * 32);
+    return 4 * bytesPerLane > grfBytes / 32 ? 16 : 32;
+  });
+
   // load dialects
   m.def("load_dialects", [](mlir::MLIRContext &context) {
     mlir::DialectRegistry registry;
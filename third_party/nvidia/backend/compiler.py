@@ -1,4 +1,4 @@
-from triton.backends.compiler import BaseBackend
+from triton.backends.compiler import BaseBackend, get_compile_timer
 from triton._C.libtriton import ir, passes, llvm, nvidia
 from triton.backends.nvidia.driver import CudaUtils
 
@@ -263,8 +263,9 @@ class InfoFromBackendForTensorMap:
         else:
             return idx
 
-    def tensormap(self, args):
-        return InfoFromBackendForTensorMap.utils().cuTensorMapEncodeTiled(
+    # arguments of cuTensorMapEncodeTiled
+    def tensormap_args(self, args):
+        return (
             self.getTensorMapDataType(),
             self.getTensorRank(),
             self.getGlobalAddress(args),
@@ -278,6 +279,13 @@ class InfoFromBackendForTensorMap:
             self.getOobFill(),
         )
 
+    def tensormap(self, args):
+        return InfoFromBackendForTensorMap.utils().cuTensorMapEncodeTiled(*self.tensormap_args(args))
+
+    # device address of the tensor map, encoded once per distinct set of arguments
+    def tensormap_device(self, args):
+        return InfoFromBackendForTensorMap.utils().cuTensorMapEncodeTiledDevice(*self.tensormap_args(args))
+
     # make hashable to use as partial key in cache
     def __hash__(self):
         return hash((self.ids_of_folded_args, self.globalAddressArgIdx, tuple(self.globalDimsArgIdx),
@@ -338,6 +346,15 @@ def ptx_get_version(cuda_version) -> int:
     raise RuntimeError("Triton only support CUDA 10.0 or higher")
 
 
+def make_pass_manager(context):
+    pm = ir.pass_manager(context)
+    pm.enable_debug()
+    timer = get_compile_timer()
+    if timer is not None:
+        pm.enable_timing(timer.pass_report_path)
+    return pm
+
+
 @dataclass(frozen=True)
 class CUDAOptions:
     num_warps: int = 4
@@ -350,9 +367,22 @@ class CUDAOptions:
     optimize_epilogue: bool = False
     enable_fp_fusion: bool = True
     allow_fp8e4nv: bool = False
+    native_float_atomic_minmax: bool = False
     max_num_imprecise_acc_default: bool = None
     extern_libs: dict = None
     debug: bool = False
+    # the programs of the kernel synchronize with `tl.grid_sync`: launches
+    # check that they can all be resident on the device at once
+    cooperative: bool = False
+    # optimization level of LLVM and ptxas, 0 to 3; the autotuner screens
+    # configs at a lower one before timing the fastest of them at 3
+    opt_level: int = 3
+    # combine the updates of the threads of a warp to the same address before
+    # atomics whose result is unused
+    aggregate_atomics: bool = os.getenv("TRITON_AGGREGATE_ATOMICS", "0") == "1"
+    # pass the i32, i64, f32 and f64 arguments of kernels taking at least this
+    # many of them in one struct; 0 passes every argument on its own
+    arg_packing_threshold: int = int(os.getenv("TRITON_ARG_PACKING_THRESHOLD", "0"))
 
     def __post_init__(self):
         default_libdir = Path(__file__).parent / 'lib'
@@ -362,6 +392,7 @@ class CUDAOptions:
         object.__setattr__(self, 'extern_libs', tuple(extern_libs.items()))
         assert self.num_warps > 0 and (self.num_warps & (self.num_warps - 1)) == 0, \
                "num_warps must be a power of 2"
+        assert self.opt_level in (0, 1, 2, 3), f"unknown optimization level {self.opt_level}"
 
     def hash(self):
         key = '_'.join([f'{name}-{val}' for name, val in self.__dict__.items()])
@@ -390,12 +421,12 @@ class CUDABackend(BaseBackend):
 
     @staticmethod
     def make_ttir(mod, metadata, opt):
-        pm = ir.pass_manager(mod.context)
-        pm.enable_debug()
+        pm = make_pass_manager(mod.context)
         passes.common.add_inliner(pm)
         passes.ttir.add_combine(pm)
         passes.common.add_canonicalizer(pm)
         passes.ttir.add_reorder_broadcast(pm)
+        passes.ttir.add_hoist_invariant_loads(pm)
         passes.common.add_cse(pm)
         passes.common.add_licm(pm)
         passes.common.add_symbol_dce(pm)
@@ -410,8 +441,7 @@ class CUDABackend(BaseBackend):
             cluster_info.clusterDimY = opt.cluster_dims[1]
             cluster_info.clusterDimZ = opt.cluster_dims[2]
         # TTIR -> TTGIR
-        pm = ir.pass_manager(mod.context)
-        pm.enable_debug()
+        pm = make_pass_manager(mod.context)
         passes.ttir.add_convert_to_ttgpuir(pm, opt.num_warps, 32, opt.num_ctas, capability)
         # optimize TTGIR
         passes.ttgpuir.add_coalesce(pm)
@@ -430,15 +460,13 @@ class CUDABackend(BaseBackend):
         # `num_warps` does not mean the total number of warps of a CTA when
         # warp specialization is enabled.
         # it's the responsibility of the compiler to figure out the exact
-        # `num_warps` to use.
-        # TODO: support the case where `num_warps` from user is not 4.
+        # `num_warps` to use: each agent gets the user's `num_warps` warps.
         ws_enabled = False
-        if capability // 10 >= 9 and opt.enable_warp_specialization and opt.num_warps == 4:
+        if capability // 10 >= 9 and opt.enable_warp_specialization and opt.num_warps in (4, 8, 16):
             nvidia.passes.ttnvgpuir.add_wsfeasibility_checking(pm, capability)
             pm.run(mod)
             ws_enabled = nvidia.passes.ttnvgpuir.is_ws_supported(mod)
-            pm = ir.pass_manager(mod.context)
-            pm.enable_debug()
+            pm = make_pass_manager(mod.context)
         metadata["ws_enabled"] = ws_enabled
         if ws_enabled:
             nvidia.passes.ttnvgpuir.add_wsdecomposing(pm, capability)
@@ -476,34 +504,43 @@ class CUDABackend(BaseBackend):
         mod = src
         # TritonGPU -> LLVM-IR (MLIR)
         tma_infos = nvidia.TMAInfos()
-        pm = ir.pass_manager(mod.context)
-        pm.enable_debug()
+        pm = make_pass_manager(mod.context)
         nvidia.passes.ttnvgpuir.add_tma_descriptor_args(pm)
         passes.ttgpuir.add_decompose_unsupported_conversions(pm)
         passes.convert.add_scf_to_cf(pm)
         passes.convert.add_index_to_llvmir(pm)
         passes.ttgpuir.add_allocate_shared_memory(pm)
-        nvidia.passes.ttgpuir.add_to_llvmir(pm, capability, tma_infos)
+        nvidia.passes.ttgpuir.add_to_llvmir(pm, capability, tma_infos, options.aggregate_atomics)
         if metadata["ws_enabled"]:
             passes.common.add_licm(pm)
             passes.common.add_cse(pm)
         nvidia.passes.ttnvgpuir.add_nvgpu_to_llvm(pm)
         passes.convert.add_arith_to_llvmir(pm)
+        if options.arg_packing_threshold > 0:
+            nvidia.passes.ttgpuir.add_pack_kernel_args(pm, options.arg_packing_threshold)
         passes.common.add_canonicalizer(pm)
         passes.common.add_cse(pm)
         passes.common.add_symbol_dce(pm)
         if os.environ.get("TRITON_DISABLE_LINE_INFO", "0") == "0":
             passes.llvmir.add_di_scope(pm)
         pm.run(mod)
+        metadata["shared"] = src.get_int_attr("triton_gpu.shared")
+        # the `tl.global_scratch` buffers, which the launcher allocates
+        metadata["global_scratch_size"] = src.get_int_attr("triton_gpu.global_scratch_memory_size") or 0
+        metadata["global_scratch_align"] = src.get_int_attr("triton_gpu.global_scratch_memory_alignment") or 1
+        # the positions of the kernel arguments passed in one struct, in order
+        metadata["packed_args"] = src.get_int_array_attr("triton_gpu.packed_args") or []
         # LLVM-IR (MLIR) -> LLVM-IR (LLVM)
         llvm.init_targets()
         context = llvm.context()
         llvm_mod = llvm.to_module(mod, context)
+        # the MLIR module is not needed anymore while LLVM optimizes
+        src.clear()
         nvidia.set_nvvm_reflect_ftz(llvm_mod)
         if options.extern_libs:
             for name, path in options.extern_libs:
                 llvm.link_extern_lib(llvm_mod, path)
-        llvm.optimize_module(llvm_mod, llvm.OPTIMIZE_O3)
+        llvm.optimize_module(llvm_mod, getattr(llvm, f"OPTIMIZE_O{options.opt_level}"))
         # Set kernel attributes
         # kernels = [fn for fn in llvm_mod.get_functions() if fn.has_public_visibility() and not fn.is_declaration()]
         # assert len(kernels) == 1
@@ -516,7 +553,6 @@ class CUDABackend(BaseBackend):
             for i, _ in enumerate(metadata["tensormaps_info"]):
                 metadata["tensormaps_info"][i].ids_of_folded_args = metadata["ids_of_folded_args"]
         metadata["ids_of_tensormaps"] = get_ids_of_tensormaps(metadata.get("tensormaps_info", None))
-        metadata["shared"] = src.get_int_attr("triton_gpu.shared")
         ret = str(llvm_mod)
         del llvm_mod
         del context
@@ -553,8 +589,9 @@ class CUDABackend(BaseBackend):
 
             line_info = '' if os.environ.get('TRITON_DISABLE_LINE_INFO') else ' -lineinfo'
             fmad = '' if opt.enable_fp_fusion else ' --fmad=false'
+            opt_level = '' if opt.opt_level == 3 else f' -O{opt.opt_level}'
             suffix = 'a ' if capability == 90 else ' '
-            cmd = f'{ptxas}{line_info}{fmad} -v --gpu-name=sm_{capability}{suffix}{fsrc.name} -o {fbin} 2> {flog.name}'
+            cmd = f'{ptxas}{line_info}{fmad}{opt_level} -v --gpu-name=sm_{capability}{suffix}{fsrc.name} -o {fbin} 2> {flog.name}'
 
             try:
                 subprocess.run(cmd, shell=True, check=True)
@@ -1,6 +1,9 @@
 #include "cuda.h"
 #include <dlfcn.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
@@ -454,6 +457,169 @@ static PyObject *tensorMapEncodeTiled(PyObject *self, PyObject *args) {
   return PyLong_FromUnsignedLongLong((unsigned long long)tensorMap);
 }
 
+// Device copies of the tensor maps encoded so far, keyed on the encoding
+// parameters and the current context. A TMA kernel relaunched in a loop sees
+// the same base pointers and shapes every time, so each descriptor is encoded
+// and uploaded once instead of on every launch.
+#define TENSOR_MAP_MAX_RANK 5
+
+typedef struct {
+  CUcontext context;
+  CUtensorMapDataType tensorDataType;
+  cuuint32_t tensorRank;
+  void *globalAddress;
+  cuuint64_t globalDim[TENSOR_MAP_MAX_RANK];
+  cuuint64_t globalStrides[TENSOR_MAP_MAX_RANK - 1];
+  cuuint32_t boxDim[TENSOR_MAP_MAX_RANK];
+  cuuint32_t elementStrides[TENSOR_MAP_MAX_RANK];
+  CUtensorMapInterleave interleave;
+  CUtensorMapSwizzle swizzle;
+  CUtensorMapL2promotion l2Promotion;
+  CUtensorMapFloatOOBfill oobFill;
+} TensorMapKey;
+
+typedef struct {
+  TensorMapKey key;
+  CUdeviceptr tensorMap; // 0 for an empty slot
+} TensorMapCacheEntry;
+
+static TensorMapCacheEntry *tensorMapCache = NULL;
+static size_t tensorMapCacheCapacity = 0; // a power of two
+static size_t tensorMapCacheSize = 0;
+
+// Keys are zero-initialized before being filled in, so hashing and comparing
+// their bytes is well defined, padding included.
+static size_t hashTensorMapKey(const TensorMapKey *key) {
+  const unsigned char *bytes = (const unsigned char *)key;
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < sizeof(TensorMapKey); ++i)
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  return (size_t)hash;
+}
+
+static TensorMapCacheEntry *lookupTensorMap(const TensorMapKey *key) {
+  size_t mask = tensorMapCacheCapacity - 1;
+  for (size_t i = hashTensorMapKey(key) & mask;; i = (i + 1) & mask) {
+    TensorMapCacheEntry *entry = &tensorMapCache[i];
+    if (!entry->tensorMap ||
+        memcmp(&entry->key, key, sizeof(TensorMapKey)) == 0)
+      return entry;
+  }
+}
+
+// Keeps the table at most half full so that probing always ends.
+static bool reserveTensorMapCache() {
+  if (2 * (tensorMapCacheSize + 1) <= tensorMapCacheCapacity)
+    return true;
+  TensorMapCacheEntry *oldCache = tensorMapCache;
+  size_t oldCapacity = tensorMapCacheCapacity;
+  size_t capacity = oldCapacity ? 2 * oldCapacity : 64;
+  tensorMapCache =
+      (TensorMapCacheEntry *)calloc(capacity, sizeof(TensorMapCacheEntry));
+  if (!tensorMapCache) {
+    tensorMapCache = oldCache;
+    PyErr_NoMemory();
+    return false;
+  }
+  tensorMapCacheCapacity = capacity;
+  for (size_t i = 0; i < oldCapacity; ++i)
+    if (oldCache[i].tensorMap)
+      *lookupTensorMap(&oldCache[i].key) = oldCache[i];
+  free(oldCache);
+  return true;
+}
+
+static bool fillTensorMapDims(PyObject *listObj, Py_ssize_t len,
+                              cuuint64_t *array64, cuuint32_t *array32) {
+  if (PyList_Size(listObj) != len) {
+    PyErr_SetString(PyExc_ValueError,
+                    "Tensor map dimensions do not match the tensor rank");
+    return false;
+  }
+  for (Py_ssize_t i = 0; i < len; i++) {
+    PyObject *item = PyList_GetItem(listObj, i);
+    if (array64)
+      array64[i] = (cuuint64_t)PyLong_AsUnsignedLongLong(item);
+    else
+      array32[i] = (cuuint32_t)PyLong_AsUnsignedLong(item);
+  }
+  return !PyErr_Occurred();
+}
+
+// Same arguments as cuTensorMapEncodeTiled, but returns the device address
+// of a cached copy of the tensor map.
+static PyObject *tensorMapEncodeTiledDevice(PyObject *self, PyObject *args) {
+  TensorMapKey key;
+  memset(&key, 0, sizeof(TensorMapKey));
+  PyObject *globalDimObj, *globalStridesObj, *boxDimObj, *elementStridesObj;
+
+  if (!PyArg_ParseTuple(args, "iiKO!O!O!O!iiii", &key.tensorDataType,
+                        &key.tensorRank, &key.globalAddress, &PyList_Type,
+                        &globalDimObj, &PyList_Type, &globalStridesObj,
+                        &PyList_Type, &boxDimObj, &PyList_Type,
+                        &elementStridesObj, &key.interleave, &key.swizzle,
+                        &key.l2Promotion, &key.oobFill)) {
+    return NULL; // Error parsing arguments
+  }
+  if (key.tensorRank < 1 || key.tensorRank > TENSOR_MAP_MAX_RANK) {
+    PyErr_SetString(PyExc_ValueError, "Unsupported tensor map rank");
+    return NULL;
+  }
+  Py_ssize_t rank = key.tensorRank;
+  if (!fillTensorMapDims(globalDimObj, rank, key.globalDim, NULL) ||
+      !fillTensorMapDims(globalStridesObj, rank - 1, key.globalStrides,
+                         NULL) ||
+      !fillTensorMapDims(boxDimObj, rank, NULL, key.boxDim) ||
+      !fillTensorMapDims(elementStridesObj, rank, NULL, key.elementStrides))
+    return NULL;
+  CUDA_CHECK_AND_RETURN_NULL(cuCtxGetCurrent(&key.context));
+
+  if (!reserveTensorMapCache())
+    return NULL;
+  TensorMapCacheEntry *entry = lookupTensorMap(&key);
+  if (entry->tensorMap)
+    return PyLong_FromUnsignedLongLong((unsigned long long)entry->tensorMap);
+
+  static cuTensorMapEncodeTiled_t cuTensorMapEncodeTiledHandle = NULL;
+  if (cuTensorMapEncodeTiledHandle == NULL) {
+    cuTensorMapEncodeTiledHandle = getCuTensorMapEncodeTiledHandle();
+    if (cuTensorMapEncodeTiledHandle == NULL)
+      return NULL;
+  }
+  // The GIL is held throughout so that no other thread modifies the cache
+  // meanwhile; this only runs the first time a descriptor is seen.
+  CUtensorMap tensorMap;
+  CUDA_CHECK_AND_RETURN_NULL(cuTensorMapEncodeTiledHandle(
+      &tensorMap, key.tensorDataType, key.tensorRank, key.globalAddress,
+      key.globalDim, key.globalStrides, key.boxDim, key.elementStrides,
+      key.interleave, key.swizzle, key.l2Promotion, key.oobFill));
+  CUdeviceptr tensorMapDevice;
+  CUDA_CHECK_AND_RETURN_NULL(cuMemAlloc(&tensorMapDevice, sizeof(CUtensorMap)));
+  CUresult err =
+      cuMemcpyHtoD(tensorMapDevice, &tensorMap, sizeof(CUtensorMap));
+  if (err != CUDA_SUCCESS) {
+    cuMemFree(tensorMapDevice);
+    CUDA_CHECK_AND_RETURN_NULL(err);
+  }
+
+  entry->key = key;
+  entry->tensorMap = tensorMapDevice;
+  ++tensorMapCacheSize;
+  return PyLong_FromUnsignedLongLong((unsigned long long)tensorMapDevice);
+}
+
+// Frees the cached tensor maps, e.g. before their context is destroyed.
+static PyObject *tensorMapCacheClear(PyObject *self, PyObject *args) {
+  for (size_t i = 0; i < tensorMapCacheCapacity; ++i)
+    if (tensorMapCache[i].tensorMap)
+      cuMemFree(tensorMapCache[i].tensorMap);
+  free(tensorMapCache);
+  tensorMapCache = NULL;
+  tensorMapCacheCapacity = 0;
+  tensorMapCacheSize = 0;
+  Py_RETURN_NONE;
+}
+
 static PyObject *occupancyMaxActiveClusters(PyObject *self, PyObject *args) {
   int clusterDimX = -1, clusterDimY = -1, clusterDimZ = -1,
       maxActiveClusters = -1;
@@ -503,6 +669,64 @@ static PyObject *occupancyMaxActiveClusters(PyObject *self, PyObject *args) {
   return PyLong_FromLong(maxActiveClusters);
 }
 
+static PyObject *occupancyMaxActiveBlocks(PyObject *self, PyObject *args) {
+  int numWarps = 0, shared = 0, maxActiveBlocks = -1;
+  CUfunction func;
+
+  if (!PyArg_ParseTuple(args, "Kii", &func, &numWarps, &shared)) {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  CUDA_CHECK_AND_RETURN_NULL_ALLOW_THREADS(
+      cuOccupancyMaxActiveBlocksPerMultiprocessor(&maxActiveBlocks, func,
+                                                  numWarps * 32, shared));
+  Py_END_ALLOW_THREADS;
+  return PyLong_FromLong(maxActiveBlocks);
+}
+
+// Returns the IPC handle of the allocation holding `ptr`, as bytes, and the
+// offset of `ptr` in it.
+static PyObject *ipcGetMemHandle(PyObject *self, PyObject *args) {
+  CUdeviceptr dptr;
+  if (!PyArg_ParseTuple(args, "K", &dptr))
+    return NULL;
+  CUdeviceptr base;
+  size_t size;
+  CUDA_CHECK_AND_RETURN_NULL(cuMemGetAddressRange(&base, &size, dptr));
+  CUipcMemHandle handle;
+  CUDA_CHECK_AND_RETURN_NULL(cuIpcGetMemHandle(&handle, base));
+  return Py_BuildValue("(y#K)", handle.reserved, (Py_ssize_t)sizeof(handle),
+                       (uint64_t)(dptr - base));
+}
+
+// Maps the allocation of an IPC handle exported by another process, and
+// returns its base address in this one.
+static PyObject *ipcOpenMemHandle(PyObject *self, PyObject *args) {
+  const char *data;
+  Py_ssize_t size;
+  if (!PyArg_ParseTuple(args, "y#", &data, &size))
+    return NULL;
+  CUipcMemHandle handle;
+  if (size != sizeof(handle)) {
+    PyErr_SetString(PyExc_ValueError, "invalid IPC memory handle");
+    return NULL;
+  }
+  memcpy(handle.reserved, data, sizeof(handle));
+  CUdeviceptr dptr;
+  CUDA_CHECK_AND_RETURN_NULL(cuIpcOpenMemHandle(
+      &dptr, handle, CU_IPC_MEM_LAZY_ENABLE_PEER_ACCESS));
+  return PyLong_FromUnsignedLongLong((unsigned long long)dptr);
+}
+
+static PyObject *ipcCloseMemHandle(PyObject *self, PyObject *args) {
+  CUdeviceptr dptr;
+  if (!PyArg_ParseTuple(args, "K", &dptr))
+    return NULL;
+  CUDA_CHECK_AND_RETURN_NULL(cuIpcCloseMemHandle(dptr));
+  Py_RETURN_NONE;
+}
+
 static PyMethodDef ModuleMethods[] = {
     {"load_binary", loadBinary, METH_VARARGS,
      "Load provided cubin into CUDA driver"},
@@ -513,8 +737,24 @@ static PyMethodDef ModuleMethods[] = {
     {"cuMemFree", memFree, METH_VARARGS},
     {"cuTensorMapEncodeTiled", tensorMapEncodeTiled, METH_VARARGS,
      "Python interface for cuTensorMapEncodeTiled function"},
+    {"cuTensorMapEncodeTiledDevice", tensorMapEncodeTiledDevice, METH_VARARGS,
+     "Encode a tensor map, or reuse the cached one, and return its device "
+     "address"},
+    {"cuTensorMapCacheClear", tensorMapCacheClear, METH_VARARGS,
+     "Free the tensor maps cached by cuTensorMapEncodeTiledDevice"},
     {"cuOccupancyMaxActiveClusters", occupancyMaxActiveClusters, METH_VARARGS,
      "Python interface for cuOccupancyMaxActiveClusters function"},
+    {"cuOccupancyMaxActiveBlocksPerMultiprocessor", occupancyMaxActiveBlocks,
+     METH_VARARGS,
+     "Python interface for cuOccupancyMaxActiveBlocksPerMultiprocessor "
+     "function"},
+    {"cuIpcGetMemHandle", ipcGetMemHandle, METH_VARARGS,
+     "Get the IPC handle of the allocation holding a device pointer, and the "
+     "offset of the pointer in it"},
+    {"cuIpcOpenMemHandle", ipcOpenMemHandle, METH_VARARGS,
+     "Map the allocation of an IPC handle of another process"},
+    {"cuIpcCloseMemHandle", ipcCloseMemHandle, METH_VARARGS,
+     "Unmap an allocation mapped by cuIpcOpenMemHandle"},
     {NULL, NULL, 0, NULL} // sentinel
 };
 
@@ -53,10 +53,16 @@ class CudaUtils(object):
         self.CUtensorMapL2promotion = mod.CUtensorMapL2promotion
         self.CUtensorMapFloatOOBfill = mod.CUtensorMapFloatOOBfill
         self.cuTensorMapEncodeTiled = mod.cuTensorMapEncodeTiled
+        self.cuTensorMapEncodeTiledDevice = mod.cuTensorMapEncodeTiledDevice
+        self.cuTensorMapCacheClear = mod.cuTensorMapCacheClear
         self.cuMemAlloc = mod.cuMemAlloc
         self.cuMemcpyHtoD = mod.cuMemcpyHtoD
         self.cuMemFree = mod.cuMemFree
         self.cuOccupancyMaxActiveClusters = mod.cuOccupancyMaxActiveClusters
+        self.cuOccupancyMaxActiveBlocksPerMultiprocessor = mod.cuOccupancyMaxActiveBlocksPerMultiprocessor
+        self.cuIpcGetMemHandle = mod.cuIpcGetMemHandle
+        self.cuIpcOpenMemHandle = mod.cuIpcOpenMemHandle
+        self.cuIpcCloseMemHandle = mod.cuIpcCloseMemHandle
 
 
 # ------------------------
@@ -92,7 +98,7 @@ def generate_cu_signature(constants, signature, ids):
     return signature, num_regular_signatures
 
 
-def make_launcher(constants, signature, ids):
+def make_launcher(constants, signature, ids, global_scratch_size=0, packed_args=()):
     # Record the end of regular arguments;
     # subsequent arguments are architecture-specific descriptors, such as tensor descriptors for CUDA.
     signature, desc_start_idx = generate_cu_signature(constants, signature, ids)
@@ -134,9 +140,21 @@ def make_launcher(constants, signature, ids):
         i for i in signature.keys()
         if i >= desc_start_idx or (i not in constants and i not in folded_without_constexprs)
     ]
+    # `packed_args` numbers the arguments of the kernel that it takes in a
+    # struct passed as its first argument
+    packed = [params[k] for k in packed_args]
+    param_addrs = [f"&arg{i}" for i in params if i not in packed]
+    packed_decl = ""
+    packed_init = ""
+    if packed:
+        fields = ' '.join(f"{ty_to_cpp(signature[i])} arg{i};" for i in packed)
+        packed_decl = f"typedef struct _PackedArgs {{ {fields} }} PackedArgs;"
+        packed_init = f"PackedArgs packed_args = {{ {', '.join(f'arg{i}' for i in packed)} }};"
+        param_addrs = ["&packed_args"] + param_addrs
     src = f"""
 #include \"cuda.h\"
 #include <stdbool.h>
+#include <stdlib.h>
 #include <Python.h>
 #include <dlfcn.h>
 
@@ -180,8 +198,52 @@ static cuLaunchKernelEx_t getLaunchKernelExHandle() {{
   return cuLaunchKernelExHandle;
 }}
 
-static void _launch(int gridX, int gridY, int gridZ, int num_warps, int num_ctas, int clusterDimX, int clusterDimY, int clusterDimZ, int shared_memory, CUstream stream, CUfunction function{', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
-  void *params[] = {{ {', '.join(f"&arg{i}" for i in params)} }};
+// Global scratch memory of the kernels using `tl.global_scratch`, one buffer
+// per kernel and stream so that concurrent launches never share it. A buffer
+// is zeroed when allocated and keeps its contents between launches.
+typedef struct _GlobalScratch {{
+  CUfunction function;
+  CUstream stream;
+  CUdeviceptr ptr;
+}} GlobalScratch;
+static const size_t global_scratch_size = {global_scratch_size};
+static GlobalScratch* global_scratch_pool = NULL;
+static size_t global_scratch_count = 0;
+
+// Must be called with the GIL held. Returns false if the allocation failed,
+// which sets an error.
+static bool getGlobalScratch(CUfunction function, CUstream stream, CUdeviceptr* ptr) {{
+  *ptr = 0;
+  if (global_scratch_size == 0)
+    return true;
+  for (size_t i = 0; i < global_scratch_count; ++i) {{
+    if (global_scratch_pool[i].function == function && global_scratch_pool[i].stream == stream) {{
+      *ptr = global_scratch_pool[i].ptr;
+      return true;
+    }}
+  }}
+  GlobalScratch* pool = (GlobalScratch*)realloc(global_scratch_pool, (global_scratch_count + 1) * sizeof(GlobalScratch));
+  if (pool == NULL) {{
+    PyErr_NoMemory();
+    return false;
+  }}
+  global_scratch_pool = pool;
+  CUDA_CHECK(cuMemAlloc(ptr, global_scratch_size));
+  if (PyErr_Occurred())
+    return false;
+  // ordered before the first launch on the stream
+  CUDA_CHECK(cuMemsetD8Async(*ptr, 0, global_scratch_size, stream));
+  if (PyErr_Occurred())
+    return false;
+  GlobalScratch entry = {{function, stream, *ptr}};
+  global_scratch_pool[global_scratch_count++] = entry;
+  return true;
+}}
+
+{packed_decl}
+static void _launch(int gridX, int gridY, int gridZ, int num_warps, int num_ctas, int clusterDimX, int clusterDimY, int clusterDimZ, int shared_memory, CUstream stream, CUfunction function, CUdeviceptr global_scratch{', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
+  {packed_init}
+  void *params[] = {{ {', '.join(param_addrs + (["&global_scratch"] if global_scratch_size else []))} }};
   if (gridX*gridY*gridZ > 0) {{
     if (num_ctas == 1) {{
       CUDA_CHECK(cuLaunchKernel(function, gridX, gridY, gridZ, 32*num_warps, 1, 1, shared_memory, stream, params, 0));
@@ -285,8 +347,12 @@ static PyObject* launch(PyObject* self, PyObject* args) {{
 
   // raise exception asap
   {"; ".join([f"DevicePtrInfo ptr_info{i} = getPointer(_arg{i}, {i}); if (!ptr_info{i}.valid) return NULL;" if ty[0] == "*" else "" for i, ty in signature.items()])};
+  CUdeviceptr global_scratch;
+  if (!getGlobalScratch((CUfunction)_function, (CUstream)_stream, &global_scratch)) {{
+    return NULL;
+  }}
   Py_BEGIN_ALLOW_THREADS;
-  _launch(gridX, gridY, gridZ, num_warps, num_ctas, clusterDimX, clusterDimY, clusterDimZ, shared_memory, (CUstream)_stream, (CUfunction)_function{', ' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"_arg{i}"for i, ty in signature.items()) if len(signature) > 0 else ''});
+  _launch(gridX, gridY, gridZ, num_warps, num_ctas, clusterDimX, clusterDimY, clusterDimZ, shared_memory, (CUstream)_stream, (CUfunction)_function, global_scratch{', ' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"_arg{i}"for i, ty in signature.items()) if len(signature) > 0 else ''});
   Py_END_ALLOW_THREADS;
   if (PyErr_Occurred()) {{
     return NULL;
@@ -336,7 +402,8 @@ class CudaLauncher(object):
         }
         constants = src.constants if hasattr(src, "constants") else dict()
         enable_warp_specialization = False
-        src = make_launcher(constants, src.signature, ids)
+        src = make_launcher(constants, src.signature, ids, getattr(metadata, "global_scratch_size", 0),
+                            getattr(metadata, "packed_args", ()))
         mod = compile_module_from_src(src, "__triton_launcher")
         self.launch = mod.launch
 
@@ -350,26 +417,19 @@ class CudaLauncher(object):
 
 
 class TensorMapManager:
+    # The descriptors are cached natively, keyed on what they encode rather
+    # than on the whole argument list, so that relaunching a kernel with the
+    # same tensors neither re-encodes nor hashes the tensor map infos.
 
     def __init__(self, utils):
-        self.tensormaps_device = {}
         self.utils = utils
 
     def __getitem__(self, key: tuple):
-        if key in self.tensormaps_device:
-            return int(self.tensormaps_device[key])
-        else:
-            (e, args) = key
-            t_tensormap = e.tensormap(args)
-            TENSORMAP_SIZE_IN_BYTES = 128
-            t_tensormap_device = self.utils.cuMemAlloc(TENSORMAP_SIZE_IN_BYTES)
-            self.utils.cuMemcpyHtoD(t_tensormap_device, t_tensormap, TENSORMAP_SIZE_IN_BYTES)
-            self.tensormaps_device[key] = t_tensormap_device
-            return int(self.tensormaps_device[key])
+        (e, args) = key
+        return e.tensormap_device(args)
 
     def __del__(self):
-        for _, v in self.tensormaps_device.items():
-            self.utils.cuMemFree(v)
+        self.utils.cuTensorMapCacheClear()
 
 
 class CudaDriver(GPUDriver):
@@ -392,6 +452,24 @@ class CudaDriver(GPUDriver):
         import torch
         return torch.cuda.is_available() and (torch.version.hip is None)
 
+    def max_cooperative_programs(self, kernel):
+        # the occupancy of each SM for the shared memory and registers of the kernel
+        md = kernel.metadata
+        per_sm = self.utils.cuOccupancyMaxActiveBlocksPerMultiprocessor(kernel.function, md.num_warps * md.num_ctas,
+                                                                        md.shared)
+        return per_sm * self.utils.get_device_properties(self.get_current_device())["multiprocessor_count"]
+
+    def get_ipc_handle(self, ptr):
+        return self.utils.cuIpcGetMemHandle(ptr)
+
+    def open_ipc_handle(self, handle):
+        data, offset = handle
+        base = self.utils.cuIpcOpenMemHandle(data)
+        return base, base + offset
+
+    def close_ipc_handle(self, base):
+        self.utils.cuIpcCloseMemHandle(base)
+
     def assemble_tensormap_to_arg(self, tensormaps_info, args):
         args_with_tma = list(args)
         if tensormaps_info is not None:
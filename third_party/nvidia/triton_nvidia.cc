@@ -23,10 +23,16 @@ void init_triton_nvidia_passes_ttgpuir(py::module &&m) {
                      mlir::createTritonGPURewriteTensorPointerPass, int);
   // TODO: it is weird to pass mlir::triton::NVVM here since the conversion is
   // nvidia-specificontext
-  m.def("add_to_llvmir", [](mlir::PassManager &pm, int32_t capability,
-                            mlir::triton::gpu::TMAMetadataTy *tmaMetadata) {
-    pm.addPass(createConvertTritonGPUToLLVMPass(capability, mlir::triton::NVVM,
-                                                tmaMetadata));
+  m.def("add_to_llvmir",
+        [](mlir::PassManager &pm, int32_t capability,
+           mlir::triton::gpu::TMAMetadataTy *tmaMetadata,
+           bool aggregateAtomics) {
+          pm.addPass(createConvertTritonGPUToLLVMPass(
+              capability, mlir::triton::NVVM, tmaMetadata, /*fastMath=*/false,
+              /*vectorTensors=*/false, aggregateAtomics));
+        });
+  m.def("add_pack_kernel_args", [](mlir::PassManager &pm, int32_t threshold) {
+    pm.addPass(mlir::triton::createPackKernelArgsPass({threshold}));
   });
 }
 
@@ -56,3 +56,51 @@ INSTANTIATE_TEST_SUITE_P(TestDotOperands, SwizzleDotOperandTestFixture,
                                            ParamT{{32, 32}, 1, 16, {8, 2, 4}},
                                            ParamT{{16, 16}, 0, 16, {8, 4, 2}},
                                            ParamT{{16, 16}, 1, 16, {8, 4, 2}}));
+
+struct DpasParamT {
+  std::array<int64_t, 2> shape;
+  int opIdx;
+  int typeWidth;
+  unsigned repeatCount;
+  unsigned kWidth;
+  swizzleParams refSwizzle;
+};
+
+class SwizzleDpasOperandTestFixture
+    : public ::testing::TestWithParam<DpasParamT> {};
+
+TEST_P(SwizzleDpasOperandTestFixture, DpasOperands) {
+  auto params = GetParam();
+  // init context
+  MLIRContext ctx;
+  ctx.loadDialect<triton::gpu::TritonGPUDialect>();
+
+  auto CTALayout =
+      triton::gpu::CTALayoutAttr::get(&ctx, {1, 1}, {1, 1}, {0, 1});
+
+  // create encoding
+  auto parent = triton::gpu::DpasEncodingAttr::get(&ctx, params.repeatCount,
+                                                   {1, 1}, CTALayout);
+  auto encoding = triton::gpu::DotOperandEncodingAttr::get(
+      &ctx, params.opIdx, parent, params.kWidth);
+
+  // create element type
+  Type eltType = IntegerType::get(&ctx, params.typeWidth);
+  auto layout = SharedEncodingAttr::get(&ctx, encoding, params.shape, {1, 0},
+                                        CTALayout, eltType);
+
+  ASSERT_EQ(layout.getVec(), params.refSwizzle.vec);
+  ASSERT_EQ(layout.getPerPhase(), params.refSwizzle.perPhase);
+  ASSERT_EQ(layout.getMaxPhase(), params.refSwizzle.maxPhase);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TestDpasOperands, SwizzleDpasOperandTestFixture,
+    ::testing::Values(DpasParamT{{64, 64}, 0, 16, 8, 0, {16, 1, 2}},
+                      DpasParamT{{64, 32}, 0, 16, 8, 0, {16, 1, 2}},
+                      DpasParamT{{64, 16}, 0, 16, 8, 0, {1, 1, 1}},
+                      DpasParamT{{64, 32}, 0, 32, 8, 0, {8, 1, 2}},
+                      DpasParamT{{64, 64}, 0, 8, 8, 2, {16, 1, 4}},
+                      DpasParamT{{64, 64}, 0, 8, 2, 2, {1, 1, 1}},
+                      DpasParamT{{64, 64}, 1, 16, 8, 0, {1, 1, 1}}));
+